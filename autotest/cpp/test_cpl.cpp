@@ -28,13 +28,21 @@
 
 #include <cpl_error.h>
 #include <cpl_hash_set.h>
+#include <cpl_http.h>
 #include <cpl_list.h>
+#include <cpl_minixml.h>
 #include <cpl_sha256.h>
+#include <cpl_spawn.h>
 #include <cpl_string.h>
+#include <cpl_vsi.h>
+#include <cpl_vsi_virtual.h>
+#include <cpl_worker_thread_pool.h>
 #include "cpl_safemaths.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <string>
+#include <vector>
 
 static bool gbGotError = false;
 static void CPL_STDCALL myErrorHandler(CPLErr, CPLErrorNum, const char*)
@@ -1239,4 +1247,585 @@ namespace tut
         try { (CPLSM(1U) / CPLSM(0U)).v(); ensure(false); } catch (...) {}
     }
 
+    static size_t test_cpl_27_write( void *pBuffer, size_t nSize,
+                                     size_t nMemb, int iRequest,
+                                     void *pWriteArg )
+    {
+        std::string* paosContent = static_cast<std::string*>(pWriteArg);
+        paosContent[iRequest].append(static_cast<char*>(pBuffer),
+                                     nSize * nMemb);
+        return nSize * nMemb;
+    }
+
+    // Test CPLHTTPMultiFetch()
+    template<>
+    template<>
+    void object::test<27>()
+    {
+        CPLSetConfigOption("CPL_CURL_ENABLE_VSIMEM", "YES");
+        VSIFCloseL(VSIFileFromMemBuffer("/vsimem/test_cpl_27_a",
+                                        (GByte*)"foo", 3, FALSE));
+        VSIFCloseL(VSIFileFromMemBuffer("/vsimem/test_cpl_27_b",
+                                        (GByte*)"barbaz", 6, FALSE));
+        const char* const apszURL[] = { "/vsimem/test_cpl_27_a",
+                                        "/vsimem/test_cpl_27_missing",
+                                        "/vsimem/test_cpl_27_b" };
+
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        CPLHTTPResult** papsResults =
+            CPLHTTPMultiFetch(apszURL, 3, 2, NULL);
+        CPLPopErrorHandler();
+        ensure( papsResults != NULL );
+        ensure_equals( papsResults[0]->nDataLen, 3 );
+        ensure_equals( std::string(
+            reinterpret_cast<char*>(papsResults[0]->pabyData)), "foo" );
+        ensure( papsResults[1]->pszErrBuf != NULL );
+        ensure_equals( papsResults[2]->nDataLen, 6 );
+        CPLHTTPDestroyMultiResult(papsResults, 3);
+
+        std::string aosContent[3];
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        papsResults = CPLHTTPMultiFetchEx(apszURL, 3, 0, NULL,
+                                          test_cpl_27_write, aosContent);
+        CPLPopErrorHandler();
+        ensure( papsResults != NULL );
+        ensure_equals( aosContent[0], "foo" );
+        ensure_equals( aosContent[1], "" );
+        ensure_equals( aosContent[2], "barbaz" );
+        ensure( papsResults[2]->pabyData == NULL );
+        CPLHTTPDestroyMultiResult(papsResults, 3);
+
+        ensure( CPLHTTPMultiFetch(apszURL, 0, 1, NULL) == NULL );
+
+        VSIUnlink("/vsimem/test_cpl_27_a");
+        VSIUnlink("/vsimem/test_cpl_27_b");
+        CPLSetConfigOption("CPL_CURL_ENABLE_VSIMEM", NULL);
+    }
+
+    static int test_cpl_28_start( void *pUserData, const char *pszName,
+                                  const char * const *papszAttributes )
+    {
+        std::string* posTrace = static_cast<std::string*>(pUserData);
+        *posTrace += "<";
+        *posTrace += pszName;
+        for( ; *papszAttributes != NULL; papszAttributes += 2 )
+        {
+            *posTrace += " ";
+            *posTrace += papszAttributes[0];
+            *posTrace += "=";
+            *posTrace += papszAttributes[1];
+        }
+        *posTrace += ">";
+        return TRUE;
+    }
+
+    static int test_cpl_28_end( void *pUserData, const char *pszName )
+    {
+        std::string* posTrace = static_cast<std::string*>(pUserData);
+        *posTrace += "</";
+        *posTrace += pszName;
+        *posTrace += ">";
+        // Stop at the end of <stop>
+        return !EQUAL(pszName, "stop");
+    }
+
+    static int test_cpl_28_text( void *pUserData, CPLXMLNodeType eType,
+                                 const char *pszText )
+    {
+        std::string* posTrace = static_cast<std::string*>(pUserData);
+        *posTrace += eType == CXT_Comment ? "#" : "";
+        *posTrace += pszText;
+        return TRUE;
+    }
+
+    // Test CPLParseXMLStringInArena() and CPLParseXMLStringStreaming()
+    template<>
+    template<>
+    void object::test<28>()
+    {
+        const char* pszXML =
+            "<?xml version=\"1.0\"?>"
+            "<a x=\"1\" y='&lt;2'><!--c--><b/>t&amp;u<![CDATA[<v>]]></a>";
+
+        CPLXMLArena* psArena = CPLXMLArenaCreate();
+        CPLXMLNode* psArenaTree = CPLParseXMLStringInArena(pszXML, psArena);
+        CPLXMLNode* psTree = CPLParseXMLString(pszXML);
+        ensure( psArenaTree != NULL );
+        ensure( psTree != NULL );
+        char* pszArenaXML = CPLSerializeXMLTree(psArenaTree);
+        char* pszTreeXML = CPLSerializeXMLTree(psTree);
+        ensure_equals( std::string(pszArenaXML), std::string(pszTreeXML) );
+        CPLFree(pszArenaXML);
+        CPLFree(pszTreeXML);
+        ensure_equals( std::string(CPLGetXMLValue(psArenaTree->psNext,
+                                                  "y", "")), "<2" );
+
+        CPLXMLNode* psClone = CPLCloneXMLTree(psArenaTree->psNext);
+        CPLSetXMLValue(psClone, "b", "modified");
+        ensure_equals( std::string(CPLGetXMLValue(psClone, "b", "")),
+                       "modified" );
+        CPLDestroyXMLNode(psClone);
+        CPLDestroyXMLNode(psTree);
+
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure( CPLParseXMLStringInArena("<a>", psArena) == NULL );
+        CPLPopErrorHandler();
+        CPLXMLArenaDestroy(psArena);
+
+        std::string osTrace;
+        ensure( CPLParseXMLStringStreaming(pszXML,
+                                           test_cpl_28_start,
+                                           test_cpl_28_end,
+                                           test_cpl_28_text,
+                                           &osTrace) );
+        ensure_equals( osTrace,
+                       "<?xml version=1.0></?xml>"
+                       "<a x=1 y=<2>#c<b></b>t&u<v></a>" );
+
+        osTrace.clear();
+        ensure( !CPLParseXMLStringStreaming("<a><stop/><b/></a>",
+                                            test_cpl_28_start,
+                                            test_cpl_28_end,
+                                            NULL,
+                                            &osTrace) );
+        ensure_equals( osTrace, "<a><stop></stop>" );
+
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure( !CPLParseXMLStringStreaming("<a></b>", NULL, NULL, NULL,
+                                            NULL) );
+        ensure( !CPLParseXMLStringStreaming("<a>", NULL, NULL, NULL, NULL) );
+        CPLPopErrorHandler();
+    }
+
+    // Launch the autotest HTTP server (autotest/pymod/webserver.py), with a
+    // thread per connection, and return its port, or 0 if it cannot be
+    // started, e.g. because Python or the GDAL Python bindings are missing.
+    static int test_cpl_launch_webserver( CPLSpawnedProcess** phSP )
+    {
+        *phSP = NULL;
+        if( !CPLHTTPEnabled() )
+            return 0;
+
+        const char* const apszArgv[] = { "python", "../pymod/webserver.py",
+                                         "--threading", NULL };
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        CPLSpawnedProcess* hSP =
+            CPLSpawnAsync(NULL, apszArgv, FALSE, TRUE, TRUE, NULL);
+        CPLPopErrorHandler();
+        if( hSP == NULL )
+            return 0;
+
+        // The server prints port=XXXX on its standard output once ready.
+        std::string osLine;
+        char ch = '\0';
+        while( CPLPipeRead(CPLSpawnAsyncGetInputFileHandle(hSP), &ch, 1) &&
+               ch != '\n' )
+        {
+            osLine += ch;
+        }
+        const int nPort = STARTS_WITH(osLine.c_str(), "port=") ?
+                                            atoi(osLine.c_str() + 5) : 0;
+        if( nPort == 0 )
+        {
+            CPLSpawnAsyncFinish(hSP, TRUE, FALSE);
+            return 0;
+        }
+        *phSP = hSP;
+        return nPort;
+    }
+
+    static void test_cpl_stop_webserver( CPLSpawnedProcess* hSP, int nPort )
+    {
+        CPLHTTPDestroyResult(CPLHTTPFetch(
+            CPLSPrintf("http://127.0.0.1:%d/shutdown", nPort), NULL));
+        CPLSpawnAsyncFinish(hSP, TRUE, FALSE);
+    }
+
+    // Byte i of the files served by the webserver for tests 29 and 30.
+    static GByte test_cpl_webserver_data( int i )
+    {
+        return static_cast<GByte>((i * 7 + i / 16384) & 0xFF);
+    }
+
+    static bool test_cpl_check_webserver_data( const GByte* pabyData,
+                                               int nOffset, int nSize )
+    {
+        for( int i = 0; i < nSize; i++ )
+        {
+            if( pabyData[i] != test_cpl_webserver_data(nOffset + i) )
+                return false;
+        }
+        return true;
+    }
+
+    // Fetch and reset the statistics of the concurrent requests received by
+    // the webserver.
+    static void test_cpl_get_webserver_stats( const CPLString& osURL,
+                                              int* pnMaxInFlight,
+                                              int* pnConnections,
+                                              int* pnRequests )
+    {
+        *pnMaxInFlight = -1;
+        *pnConnections = -1;
+        *pnRequests = -1;
+        CPLHTTPResult* psResult = CPLHTTPFetch(osURL, NULL);
+        if( psResult->pabyData != NULL )
+        {
+            sscanf(reinterpret_cast<char*>(psResult->pabyData),
+                   "max_in_flight=%d connections=%d requests=%d",
+                   pnMaxInFlight, pnConnections, pnRequests);
+        }
+        CPLHTTPDestroyResult(psResult);
+    }
+
+    // Test CPLHTTPMultiFetch() with concurrent requests to a HTTP server
+    template<>
+    template<>
+    void object::test<29>()
+    {
+        CPLSpawnedProcess* hSP = NULL;
+        const int nPort = test_cpl_launch_webserver(&hSP);
+        if( nPort == 0 )
+            return; // Skip
+
+        // Each request takes 0.3 second to be answered by the server.
+        const CPLString osBaseURL(
+            CPLSPrintf("http://127.0.0.1:%d/cpl_http_multifetch/", nPort));
+        std::vector<CPLString> aosURL;
+        for( int i = 0; i < 6; i++ )
+        {
+            aosURL.push_back(osBaseURL + CPLSPrintf("data?range=%d-%d",
+                                                    i * 1000, i * 1000 + 999));
+        }
+        // Fails with a HTTP 503 error the first time.
+        aosURL.push_back(osBaseURL + "retry");
+        aosURL.push_back(osBaseURL + "missing");
+        std::vector<const char*> apszURL;
+        for( size_t i = 0; i < aosURL.size(); i++ )
+            apszURL.push_back(aosURL[i].c_str());
+
+        char** papszOptions = CSLSetNameValue(NULL, "MAX_RETRY", "1");
+        papszOptions = CSLSetNameValue(papszOptions, "RETRY_DELAY", "0.1");
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        CPLHTTPResult** papsResults =
+            CPLHTTPMultiFetch(&apszURL[0], 8, 3, papszOptions);
+        CPLPopErrorHandler();
+        CSLDestroy(papszOptions);
+        ensure( papsResults != NULL );
+        for( int i = 0; i < 6; i++ )
+        {
+            ensure( papsResults[i]->pszErrBuf == NULL );
+            ensure_equals( papsResults[i]->nDataLen, 1000 );
+            ensure( test_cpl_check_webserver_data(papsResults[i]->pabyData,
+                                                  i * 1000, 1000) );
+        }
+        ensure( papsResults[6]->pszErrBuf == NULL );
+        ensure_equals( std::string(
+            reinterpret_cast<char*>(papsResults[6]->pabyData)), "retried" );
+        ensure( papsResults[7]->pszErrBuf != NULL );
+        ensure_equals( std::string(papsResults[7]->pszErrBuf),
+                       "HTTP error code : 404" );
+        CPLHTTPDestroyMultiResult(papsResults, 8);
+
+        // 9 requests, including the retry, 3 at a time over 3 connections
+        // at most.
+        int nMaxInFlight = 0;
+        int nConnections = 0;
+        int nRequests = 0;
+        test_cpl_get_webserver_stats(osBaseURL + "stats", &nMaxInFlight,
+                                     &nConnections, &nRequests);
+        ensure_equals( nMaxInFlight, 3 );
+        ensure( nConnections >= 1 && nConnections <= 3 );
+        ensure_equals( nRequests, 9 );
+
+        // One request at a time over a single connection.
+        papsResults = CPLHTTPMultiFetch(&apszURL[0], 3, 1, NULL);
+        ensure( papsResults != NULL );
+        for( int i = 0; i < 3; i++ )
+        {
+            ensure_equals( papsResults[i]->nDataLen, 1000 );
+            ensure( test_cpl_check_webserver_data(papsResults[i]->pabyData,
+                                                  i * 1000, 1000) );
+        }
+        CPLHTTPDestroyMultiResult(papsResults, 3);
+        test_cpl_get_webserver_stats(osBaseURL + "stats", &nMaxInFlight,
+                                     &nConnections, &nRequests);
+        ensure_equals( nMaxInFlight, 1 );
+        ensure_equals( nConnections, 1 );
+        ensure_equals( nRequests, 3 );
+
+        test_cpl_stop_webserver(hSP, nPort);
+    }
+
+    // Test reading /vsicurl/ files with CPL_VSIL_CURL_PARALLEL_DOWNLOADS
+    template<>
+    template<>
+    void object::test<30>()
+    {
+        CPLSpawnedProcess* hSP = NULL;
+        const int nPort = test_cpl_launch_webserver(&hSP);
+        if( nPort == 0 )
+            return; // Skip
+
+        CPLSetConfigOption("GDAL_DISABLE_READDIR_ON_OPEN", "EMPTY_DIR");
+        CPLSetConfigOption("CPL_VSIL_CURL_PARALLEL_DOWNLOADS", "4");
+        CPLSetConfigOption("CPL_VSIL_CURL_PARALLEL_MIN_SIZE", "16384");
+        VSICurlClearCache();
+
+        const CPLString osBaseURL(
+            CPLSPrintf("http://127.0.0.1:%d/vsicurl_parallel/", nPort));
+        const CPLString osVSICurlBaseURL("/vsicurl/" + osBaseURL);
+        const int nFileSize = 262144;
+        std::vector<GByte> abyBuffer(nFileSize);
+        int nMaxInFlight = 0;
+        int nConnections = 0;
+        int nRequests = 0;
+
+        // Parallel downloads need the file size, which is not known yet
+        // when opening the file.
+        VSIStatBufL sStat;
+        ensure_equals( VSIStatL((osVSICurlBaseURL + "ordered.bin").c_str(),
+                                &sStat), 0 );
+        ensure_equals( static_cast<int>(sStat.st_size), nFileSize );
+
+        // The server answers the part requests in the reverse order.
+        VSILFILE* fp =
+            VSIFOpenL((osVSICurlBaseURL + "ordered.bin").c_str(), "rb");
+        ensure( fp != NULL );
+        ensure_equals( VSIFReadL(&abyBuffer[0], 1, nFileSize, fp),
+                       static_cast<size_t>(nFileSize) );
+        ensure( test_cpl_check_webserver_data(&abyBuffer[0], 0, nFileSize) );
+        test_cpl_get_webserver_stats(osBaseURL + "stats", &nMaxInFlight,
+                                     &nConnections, &nRequests);
+        ensure_equals( nMaxInFlight, 4 );
+        ensure_equals( nRequests, 4 );
+
+        // Non contiguous ranges are requested concurrently too.
+        void* apData[3] = { &abyBuffer[0], &abyBuffer[1000], &abyBuffer[3000] };
+        const vsi_l_offset anOffsets[3] = { 10, 100000, 250000 };
+        const size_t anSizes[3] = { 1000, 2000, 12144 };
+        ensure_equals( VSIFReadMultiRangeL(3, apData, anOffsets, anSizes, fp),
+                       0 );
+        for( int i = 0; i < 3; i++ )
+        {
+            ensure( test_cpl_check_webserver_data(
+                static_cast<GByte*>(apData[i]),
+                static_cast<int>(anOffsets[i]), static_cast<int>(anSizes[i])) );
+        }
+        test_cpl_get_webserver_stats(osBaseURL + "stats", &nMaxInFlight,
+                                     &nConnections, &nRequests);
+        ensure_equals( nMaxInFlight, 3 );
+        ensure_equals( nRequests, 3 );
+        VSIFCloseL(fp);
+
+        // Short read at end of file.
+        VSICurlClearCache();
+        ensure_equals( VSIStatL((osVSICurlBaseURL + "ordered.bin").c_str(),
+                                &sStat), 0 );
+        fp = VSIFOpenL((osVSICurlBaseURL + "ordered.bin").c_str(), "rb");
+        ensure( fp != NULL );
+        ensure_equals( VSIFSeekL(fp, 200000, SEEK_SET), 0 );
+        ensure_equals( VSIFReadL(&abyBuffer[0], 1, 100000, fp),
+                       static_cast<size_t>(nFileSize - 200000) );
+        ensure( VSIFEofL(fp) );
+        ensure( test_cpl_check_webserver_data(&abyBuffer[0], 200000,
+                                              nFileSize - 200000) );
+        VSIFCloseL(fp);
+        test_cpl_get_webserver_stats(osBaseURL + "stats", &nMaxInFlight,
+                                     &nConnections, &nRequests);
+
+        // One part is answered with fewer bytes than requested and the
+        // connection of another one is closed in the middle of the transfer.
+        // Both are downloaded again with a single request.
+        ensure_equals( VSIStatL((osVSICurlBaseURL + "flaky.bin").c_str(),
+                                &sStat), 0 );
+        fp = VSIFOpenL((osVSICurlBaseURL + "flaky.bin").c_str(), "rb");
+        ensure( fp != NULL );
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        const size_t nRead = VSIFReadL(&abyBuffer[0], 1, nFileSize, fp);
+        CPLPopErrorHandler();
+        ensure_equals( nRead, static_cast<size_t>(nFileSize) );
+        ensure( test_cpl_check_webserver_data(&abyBuffer[0], 0, nFileSize) );
+        VSIFCloseL(fp);
+        test_cpl_get_webserver_stats(osBaseURL + "stats", &nMaxInFlight,
+                                     &nConnections, &nRequests);
+        ensure_equals( nRequests, 4 + 2 );
+
+        // The transfer of one part always fails in the middle: the data
+        // before it is returned.
+        ensure_equals( VSIStatL((osVSICurlBaseURL + "broken.bin").c_str(),
+                                &sStat), 0 );
+        fp = VSIFOpenL((osVSICurlBaseURL + "broken.bin").c_str(), "rb");
+        ensure( fp != NULL );
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        const size_t nReadBroken = VSIFReadL(&abyBuffer[0], 1, nFileSize, fp);
+        CPLPopErrorHandler();
+        ensure( nReadBroken >= 163840 );
+        ensure( nReadBroken < static_cast<size_t>(nFileSize) );
+        ensure( test_cpl_check_webserver_data(&abyBuffer[0], 0,
+                                              static_cast<int>(nReadBroken)) );
+        VSIFCloseL(fp);
+
+        CPLSetConfigOption("GDAL_DISABLE_READDIR_ON_OPEN", NULL);
+        CPLSetConfigOption("CPL_VSIL_CURL_PARALLEL_DOWNLOADS", NULL);
+        CPLSetConfigOption("CPL_VSIL_CURL_PARALLEL_MIN_SIZE", NULL);
+        VSICurlClearCache();
+
+        test_cpl_stop_webserver(hSP, nPort);
+    }
+
+    // Test CPLGetNumThreads()
+    template<>
+    template<>
+    void object::test<31>()
+    {
+        ensure_equals( CPLGetNumThreads(NULL, "1"), 1 );
+        ensure_equals( CPLGetNumThreads(NULL, NULL), 1 );
+        ensure_equals( CPLGetNumThreads(NULL, "ALL_CPUS"),
+                       std::max(1, std::min(128, CPLGetNumCPUs())) );
+
+        // The option takes precedence over the configuration option
+        CPLSetConfigOption("GDAL_NUM_THREADS", "3");
+        ensure_equals( CPLGetNumThreads(NULL, "1"), 3 );
+        const char* const apszOptions[] = { "NUM_THREADS=5", NULL };
+        ensure_equals( CPLGetNumThreads(const_cast<char**>(apszOptions),
+                                        "1"), 5 );
+        CPLSetConfigOption("GDAL_NUM_THREADS", NULL);
+
+        const char* const apszClamped[][2] = { { "0", "1" },
+                                               { "1000", "128" },
+                                               { "all_cpus", NULL } };
+        for( size_t i = 0; i < CPL_ARRAYSIZE(apszClamped); i++ )
+        {
+            CPLErrorReset();
+            const int nThreads = CPLGetNumThreads(NULL, apszClamped[i][0]);
+            ensure_equals( CPLGetLastErrorType(), CE_None );
+            if( apszClamped[i][1] != NULL )
+                ensure_equals( nThreads, atoi(apszClamped[i][1]) );
+        }
+
+        const char* const apszInvalid[] = { "-2", "abc", "4x", "" };
+        for( size_t i = 0; i < CPL_ARRAYSIZE(apszInvalid); i++ )
+        {
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            CPLErrorReset();
+            ensure_equals( CPLGetNumThreads(NULL, apszInvalid[i]), 1 );
+            CPLPopErrorHandler();
+            ensure_equals( CPLGetLastErrorType(), CE_Warning );
+        }
+    }
+
+    // Replace the /vsizip/ handler by a new one, whose member lists are not
+    // cached yet, as in a new process
+    static void test_cpl_reinstall_zip_handler()
+    {
+        VSIFilesystemHandler* poOldHandler =
+            VSIFileManager::GetHandler("/vsizip/");
+        VSIInstallZipFileHandler();
+        delete poOldHandler;
+    }
+
+    // Test the index files of CPL_VSIL_ARCHIVE_INDEX_DIR
+    template<>
+    template<>
+    void object::test<32>()
+    {
+        const char* pszIndexDir = "/vsimem/test_cpl_32_index";
+        const char* pszZip = "/vsizip//vsimem/test_cpl_32.zip";
+        ensure_equals( VSIMkdir(pszIndexDir, 0755), 0 );
+        CPLSetConfigOption("CPL_VSIL_ARCHIVE_INDEX_DIR", pszIndexDir);
+
+        VSILFILE* fpZip = VSIFOpenL(pszZip, "wb");
+        ensure( fpZip != NULL );
+        const char* const apszMembers[] = { "subdir/a.txt", "b.txt" };
+        for( size_t i = 0; i < CPL_ARRAYSIZE(apszMembers); i++ )
+        {
+            VSILFILE* fp = VSIFOpenL(
+                CPLSPrintf("%s/%s", pszZip, apszMembers[i]), "wb");
+            ensure( fp != NULL );
+            ensure_equals( VSIFWriteL("foo", 1, 3, fp),
+                           static_cast<size_t>(3) );
+            VSIFCloseL(fp);
+        }
+        VSIFCloseL(fpZip);
+
+        // The first listing scans the archive and saves its index
+        char** papszList = VSIReadDir(pszZip);
+        ensure_equals( CSLCount(papszList), 2 );
+        ensure_equals( CSLFindString(papszList, "b.txt") >= 0, true );
+        CSLDestroy(papszList);
+        papszList = VSIReadDir(pszIndexDir);
+        ensure_equals( CSLCount(papszList), 1 );
+        const CPLString osIndexFile(
+            CPLFormFilename(pszIndexDir, papszList[0], NULL));
+        ensure_equals( CPLGetExtension(osIndexFile), CPLString("idx") );
+        CSLDestroy(papszList);
+
+        // Rename b.txt in the index, to check that a new handler reads the
+        // member list from it rather than from the archive
+        GByte* pabyIndex = NULL;
+        vsi_l_offset nIndexSize = 0;
+        ensure( VSIIngestFile(NULL, osIndexFile, &pabyIndex, &nIndexSize,
+                              -1) );
+        std::string osIndex(reinterpret_cast<char*>(pabyIndex),
+                            static_cast<size_t>(nIndexSize));
+        CPLFree(pabyIndex);
+        const size_t nPos = osIndex.find("b.txt");
+        ensure( nPos != std::string::npos );
+        osIndex[nPos] = 'c';
+        VSILFILE* fp = VSIFOpenL(osIndexFile, "wb");
+        ensure( fp != NULL );
+        VSIFWriteL(osIndex.data(), 1, osIndex.size(), fp);
+        VSIFCloseL(fp);
+
+        test_cpl_reinstall_zip_handler();
+        papszList = VSIReadDir(pszZip);
+        ensure_equals( CSLCount(papszList), 2 );
+        ensure_equals( CSLFindString(papszList, "c.txt") >= 0, true );
+        CSLDestroy(papszList);
+
+        // Members are located from the offsets saved in the index
+        VSIStatBufL sStat;
+        ensure_equals( VSIStatL(CPLSPrintf("%s/subdir/a.txt", pszZip),
+                                &sStat), 0 );
+        ensure_equals( sStat.st_size, 3 );
+        fp = VSIFOpenL(CPLSPrintf("%s/c.txt", pszZip), "rb");
+        ensure( fp != NULL );
+        char szBuffer[4] = { 0 };
+        ensure_equals( VSIFReadL(szBuffer, 1, 3, fp),
+                       static_cast<size_t>(3) );
+        VSIFCloseL(fp);
+        ensure_equals( std::string(szBuffer), std::string("foo") );
+
+        // A corrupted index is ignored, and replaced by a new one
+        fp = VSIFOpenL(osIndexFile, "wb");
+        ensure( fp != NULL );
+        VSIFWriteL(osIndex.data(), 1, osIndex.size() / 2, fp);
+        VSIFCloseL(fp);
+        test_cpl_reinstall_zip_handler();
+        papszList = VSIReadDir(pszZip);
+        ensure_equals( CSLFindString(papszList, "b.txt") >= 0, true );
+        CSLDestroy(papszList);
+        test_cpl_reinstall_zip_handler();
+        papszList = VSIReadDir(pszZip);
+        ensure_equals( CSLFindString(papszList, "b.txt") >= 0, true );
+        CSLDestroy(papszList);
+
+        // The index of a modified archive is ignored
+        VSIUnlink("/vsimem/test_cpl_32.zip");
+        fp = VSIFOpenL(CPLSPrintf("%s/d.txt", pszZip), "wb");
+        ensure( fp != NULL );
+        VSIFCloseL(fp);
+        test_cpl_reinstall_zip_handler();
+        papszList = VSIReadDir(pszZip);
+        ensure_equals( CSLCount(papszList), 1 );
+        ensure_equals( std::string(papszList[0]), std::string("d.txt") );
+        CSLDestroy(papszList);
+
+        CPLSetConfigOption("CPL_VSIL_ARCHIVE_INDEX_DIR", NULL);
+        VSIUnlink("/vsimem/test_cpl_32.zip");
+        VSIUnlink(osIndexFile);
+        VSIRmdir(pszIndexDir);
+    }
+
 } // namespace tut
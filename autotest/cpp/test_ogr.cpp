@@ -26,8 +26,13 @@
 #include "gdal_unit_test.h"
 
 #include <ogrsf_frmts.h>
+#include "ogr_p.h"
+#include "ogr_attrind.h"
+#include "gdal_utils.h"
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 namespace tut
 {
@@ -480,4 +485,2123 @@ namespace tut
       OGR_SM_Destroy(hSM);
     }
 
+    // Test OGRLayer::GetNextFeatureBatch()
+    template<>
+    template<>
+    void object::test<8>()
+    {
+        GDALDriver* poDrv = GetGDALDriverManager()->GetDriverByName("Memory");
+        ensure( poDrv != NULL );
+        GDALDataset* poDS = poDrv->Create("", 0, 0, 0, GDT_Unknown, NULL);
+        OGRLayer* poLayer = poDS->CreateLayer("test", NULL, wkbPoint, NULL);
+        OGRFieldDefn oFieldInt("int", OFTInteger);
+        poLayer->CreateField(&oFieldInt);
+        OGRFieldDefn oFieldStr("str", OFTString);
+        poLayer->CreateField(&oFieldStr);
+        for( int i = 0; i < 5; i++ )
+        {
+            OGRFeature* poFeature = new OGRFeature(poLayer->GetLayerDefn());
+            poFeature->SetField(0, i);
+            if( i != 2 )
+                poFeature->SetField(1, CPLSPrintf("%d%d", i, i));
+            poFeature->SetGeometryDirectly(new OGRPoint(i, -i));
+            ensure_equals( poLayer->CreateFeature(poFeature), OGRERR_NONE );
+            delete poFeature;
+        }
+
+        OGRFeatureBatch oBatch;
+        ensure_equals( poLayer->GetNextFeatureBatch(&oBatch, 3), 3 );
+        ensure_equals( oBatch.GetFIDs()[2], 2 );
+        ensure_equals( static_cast<const int*>(oBatch.GetFieldData(0))[1], 1 );
+        ensure( oBatch.IsFieldValid(1, 1) );
+        ensure( !oBatch.IsFieldValid(1, 2) );
+        const GIntBig* panOffsets = oBatch.GetFieldOffsets(1);
+        ensure_equals( panOffsets[0], 0 );
+        ensure_equals( panOffsets[1], 2 );
+        ensure_equals( panOffsets[3], 4 );
+        ensure( memcmp(oBatch.GetFieldData(1), "0011", 4) == 0 );
+
+        const GIntBig* panGeomOffsets = oBatch.GetGeomFieldOffsets(0);
+        OGRGeometry* poGeom = NULL;
+        OGRGeometryFactory::createFromWkb(
+            const_cast<GByte*>(oBatch.GetGeomFieldData(0)) + panGeomOffsets[1],
+            NULL, &poGeom,
+            static_cast<int>(panGeomOffsets[2] - panGeomOffsets[1]));
+        ensure( poGeom != NULL );
+        ensure_equals( static_cast<OGRPoint*>(poGeom)->getY(), -1.0 );
+        delete poGeom;
+
+        ensure_equals( poLayer->GetNextFeatureBatch(&oBatch, 3), 2 );
+        ensure_equals( oBatch.GetFIDs()[0], 3 );
+        ensure_equals( poLayer->GetNextFeatureBatch(&oBatch, 3), 0 );
+
+        poLayer->ResetReading();
+        poLayer->SetAttributeFilter("int >= 3");
+        ensure_equals( poLayer->GetNextFeatureBatch(&oBatch, 10), 2 );
+        ensure_equals( static_cast<const int*>(oBatch.GetFieldData(0))[1], 4 );
+
+        GDALClose(poDS);
+    }
+
+    // Test native point-in-polygon evaluation of Intersects() and the GEOS
+    // cache setting
+    template<>
+    template<>
+    void object::test<9>()
+    {
+        OGRGeometry* poPoly = NULL;
+        char* pszWKT = const_cast<char*>(
+            "MULTIPOLYGON(((0 0,0 10,10 10,10 0,0 0),(2 2,2 8,8 8,8 2,2 2)),"
+            "((20 0,20 10,30 10,30 0,20 0)))");
+        OGRGeometryFactory::createFromWkt(&pszWKT, NULL, &poPoly);
+        ensure( poPoly != NULL );
+        poPoly->setGEOSCacheEnabled(true);
+        ensure( poPoly->isGEOSCacheEnabled() );
+
+        OGRPoint oPoint(1, 1);
+        ensure( oPoint.Intersects(poPoly) );
+        ensure( poPoly->Intersects(&oPoint) );
+        // In a hole: the bounding boxes intersect, but not the geometries.
+        oPoint.setX(5);
+        oPoint.setY(5);
+        ensure( !oPoint.Intersects(poPoly) );
+        ensure( !poPoly->Intersects(&oPoint) );
+        oPoint.setX(25);
+        ensure( oPoint.Intersects(poPoly) );
+        // Between the two parts.
+        oPoint.setX(15);
+        ensure( !oPoint.Intersects(poPoly) );
+
+        OGRGeometry* poClone = poPoly->clone();
+        ensure( !poClone->isGEOSCacheEnabled() );
+        delete poClone;
+        delete poPoly;
+    }
+
+    // Test organizePolygons() with enough rings to use the indexed
+    // implementation
+    template<>
+    template<>
+    void object::test<10>()
+    {
+        // Squares of 10x10 with a 6x6 hole, and a 2x2 island in the hole.
+        // The edges of the outer rings are densified so that they are
+        // indexed.
+        const int nSide = 10;
+        std::vector<OGRGeometry*> apoRings;
+        for( int iY = 0; iY < nSide; iY++ )
+        {
+            for( int iX = 0; iX < nSide; iX++ )
+            {
+                const double dfX = iX * 20.0;
+                const double dfY = iY * 20.0;
+                const double adfSize[3] = { 10, 6, 2 };
+                for( int iRing = 0; iRing < 3; iRing++ )
+                {
+                    const double dfOff = (10 - adfSize[iRing]) / 2;
+                    const double dfX0 = dfX + dfOff;
+                    const double dfY0 = dfY + dfOff;
+                    const double dfS = adfSize[iRing];
+                    const int nSteps = iRing == 0 ? 50 : 1;
+                    OGRLinearRing* poLR = new OGRLinearRing();
+                    for( int k = 0; k < nSteps; k++ )
+                        poLR->addPoint(dfX0, dfY0 + dfS * k / nSteps);
+                    for( int k = 0; k < nSteps; k++ )
+                        poLR->addPoint(dfX0 + dfS * k / nSteps, dfY0 + dfS);
+                    for( int k = 0; k < nSteps; k++ )
+                        poLR->addPoint(dfX0 + dfS, dfY0 + dfS - dfS * k / nSteps);
+                    for( int k = 0; k < nSteps; k++ )
+                        poLR->addPoint(dfX0 + dfS - dfS * k / nSteps, dfY0);
+                    poLR->closeRings();
+                    OGRPolygon* poPoly = new OGRPolygon();
+                    poPoly->addRingDirectly(poLR);
+                    apoRings.push_back(poPoly);
+                }
+            }
+        }
+
+        int bIsValid = FALSE;
+        OGRGeometry* poGeom = OGRGeometryFactory::organizePolygons(
+            &apoRings[0], static_cast<int>(apoRings.size()), &bIsValid, NULL);
+        ensure( bIsValid );
+        ensure_equals( wkbFlatten(poGeom->getGeometryType()), wkbMultiPolygon );
+        OGRMultiPolygon* poMP = static_cast<OGRMultiPolygon*>(poGeom);
+        ensure_equals( poMP->getNumGeometries(), 2 * nSide * nSide );
+        int nWithHole = 0;
+        for( int i = 0; i < poMP->getNumGeometries(); i++ )
+        {
+            OGRPolygon* poPoly =
+                static_cast<OGRPolygon*>(poMP->getGeometryRef(i));
+            if( poPoly->getNumInteriorRings() == 1 )
+            {
+                nWithHole++;
+                ensure_distance( poPoly->get_Area(), 64.0, 1e-8 );
+            }
+            else
+            {
+                ensure_equals( poPoly->getNumInteriorRings(), 0 );
+                ensure_distance( poPoly->get_Area(), 4.0, 1e-8 );
+            }
+        }
+        ensure_equals( nWithHole, nSide * nSide );
+        delete poGeom;
+    }
+
+    // Test geometries set in WKB form and decoded on demand
+    template<>
+    template<>
+    void object::test<11>()
+    {
+        OGRFeatureDefn* poFDefn = new OGRFeatureDefn();
+        poFDefn->Reference();
+
+        OGRLineString oLS;
+        oLS.addPoint(1, 2);
+        oLS.addPoint(3, 4);
+        const int nWKBSize = oLS.WkbSize();
+        GByte* pabyWKB = static_cast<GByte*>(CPLMalloc(nWKBSize));
+        oLS.exportToWkb(wkbNDR, pabyWKB, wkbVariantIso);
+
+        OGRFeature* poFeature = new OGRFeature(poFDefn);
+        ensure_equals( poFeature->SetGeomFieldWKB(0, pabyWKB, nWKBSize),
+                       OGRERR_NONE );
+        size_t nSize = 0;
+        ensure( poFeature->GetGeomFieldWKBRef(0, &nSize) != NULL );
+        ensure_equals( nSize, static_cast<size_t>(nWKBSize) );
+
+        // Copies keep the geometry undecoded.
+        OGRFeature* poClone = poFeature->Clone();
+        ensure( poClone->GetGeomFieldWKBRef(0, NULL) != NULL );
+        OGRFeature* poCopy = new OGRFeature(poFDefn);
+        poCopy->SetFrom(poFeature);
+        ensure( poCopy->GetGeomFieldWKBRef(0, NULL) != NULL );
+
+        OGRGeometry* poGeom = poFeature->GetGeometryRef();
+        ensure( poGeom != NULL );
+        ensure( poGeom->Equals(&oLS) );
+        ensure( poFeature->GetGeomFieldWKBRef(0, NULL) == NULL );
+        ensure( poClone->Equal(poFeature) );
+        ensure( poCopy->Equal(poFeature) );
+
+        OGREnvelope3D sEnvelope;
+        bool bHasZ = true;
+        ensure( OGRWKBGetEnvelope(pabyWKB, nWKBSize, &sEnvelope, &bHasZ) );
+        ensure( !bHasZ );
+        ensure_equals( sEnvelope.MinX, 1.0 );
+        ensure_equals( sEnvelope.MaxY, 4.0 );
+        ensure( !OGRWKBGetEnvelope(pabyWKB, nWKBSize - 1, &sEnvelope,
+                                   NULL) );
+
+        // Setting a geometry discards the WKB.
+        poClone->SetGeometry(NULL);
+        ensure( poClone->GetGeomFieldWKBRef(0, NULL) == NULL );
+        ensure( poClone->GetGeometryRef() == NULL );
+
+        // Corrupted WKB.
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        poCopy->SetGeomFieldWKB(0, pabyWKB, nWKBSize - 1);
+        ensure( poCopy->GetGeometryRef() == NULL );
+        CPLPopErrorHandler();
+
+        CPLFree(pabyWKB);
+        delete poCopy;
+        delete poClone;
+        delete poFeature;
+        poFDefn->Release();
+    }
+
+    // Test the attribute indexes that OGRLayer builds on demand
+    template<>
+    template<>
+    void object::test<12>()
+    {
+        GDALDriver* poDrv = GetGDALDriverManager()->GetDriverByName("Memory");
+        ensure( poDrv != NULL );
+        GDALDataset* poDS = poDrv->Create("", 0, 0, 0, GDT_Unknown, NULL);
+        OGRLayer* poLayer = poDS->CreateLayer("test", NULL, wkbNone, NULL);
+        OGRFieldDefn oFieldInt("int", OFTInteger);
+        poLayer->CreateField(&oFieldInt);
+        OGRFieldDefn oFieldReal("real", OFTReal);
+        poLayer->CreateField(&oFieldReal);
+        OGRFieldDefn oFieldStr("str", OFTString);
+        poLayer->CreateField(&oFieldStr);
+        for( int i = 0; i < 1000; i++ )
+        {
+            OGRFeature* poFeature = new OGRFeature(poLayer->GetLayerDefn());
+            poFeature->SetField(0, i % 100);
+            poFeature->SetField(1, i / 10.0);
+            if( i != 500 )
+                poFeature->SetField(2, CPLSPrintf("Val%d", i % 7));
+            ensure_equals( poLayer->CreateFeature(poFeature), OGRERR_NONE );
+            delete poFeature;
+        }
+
+        const char* const apszFilters[] = {
+            "int = 42", "int IN (1, 42, 1000)", "int > 97", "int <= 1.5",
+            "int BETWEEN 10.5 AND 12", "real < 0.35", "real >= 99.85",
+            "str = 'VAL3'", "str > 'val5'", "int = 42 AND str = 'val0'",
+            "int = 1 OR real = 50.5", "int >= 98 AND str <> 'val1'" };
+        const int nFilters =
+            static_cast<int>(sizeof(apszFilters) / sizeof(apszFilters[0]));
+        std::vector<GIntBig> anExpected;
+
+        // Reference counts, with the indexing disabled.
+        CPLSetConfigOption("OGR_ATTR_INDEX_THRESHOLD", "NO");
+        for( int i = 0; i < nFilters; i++ )
+        {
+            for( int iPass = 0; iPass < 3; iPass++ )
+                poLayer->SetAttributeFilter(apszFilters[i]);
+            anExpected.push_back(poLayer->GetFeatureCount());
+        }
+        CPLSetConfigOption("OGR_ATTR_INDEX_THRESHOLD", NULL);
+        ensure( poLayer->GetAutoIndex() == NULL );
+        ensure_equals( anExpected[0], 10 );
+        ensure_equals( anExpected[7], 142 );
+
+        for( int iPass = 0; iPass < 3; iPass++ )
+        {
+            for( int i = 0; i < nFilters; i++ )
+            {
+                poLayer->SetAttributeFilter(apszFilters[i]);
+                ensure_equals( apszFilters[i], poLayer->GetFeatureCount(),
+                               anExpected[i] );
+            }
+        }
+        ensure( poLayer->GetAutoIndex() != NULL );
+        ensure( poLayer->GetAutoIndex()->GetFieldIndex(0) != NULL );
+        ensure( poLayer->GetAutoIndex()->GetFieldIndex(1) != NULL );
+        ensure( poLayer->GetAutoIndex()->GetFieldIndex(2) != NULL );
+
+        // New features are added to the index.
+        OGRFeature* poFeature = new OGRFeature(poLayer->GetLayerDefn());
+        poFeature->SetField(0, 42);
+        ensure_equals( poLayer->CreateFeature(poFeature), OGRERR_NONE );
+        delete poFeature;
+        ensure( poLayer->GetAutoIndex()->GetFieldIndex(0) != NULL );
+        poLayer->SetAttributeFilter("int = 42");
+        ensure_equals( poLayer->GetFeatureCount(), 11 );
+
+        // Deleted features are skipped.
+        ensure_equals( poLayer->DeleteFeature(42), OGRERR_NONE );
+        ensure_equals( poLayer->GetFeatureCount(), 10 );
+
+        // A re-created FID is only returned once.
+        poFeature = new OGRFeature(poLayer->GetLayerDefn());
+        poFeature->SetFID(42);
+        poFeature->SetField(0, 42);
+        ensure_equals( poLayer->CreateFeature(poFeature), OGRERR_NONE );
+        delete poFeature;
+        ensure_equals( poLayer->GetFeatureCount(), 11 );
+        poLayer->ResetReading();
+        poFeature = poLayer->GetNextFeature();
+        ensure_equals( poFeature->GetFID(), 42 );
+        delete poFeature;
+
+        // Updates drop the index.
+        poFeature = poLayer->GetFeature(43);
+        poFeature->SetField(0, 42);
+        ensure_equals( poLayer->SetFeature(poFeature), OGRERR_NONE );
+        delete poFeature;
+        ensure( poLayer->GetAutoIndex()->GetFieldIndex(0) == NULL );
+        poLayer->SetAttributeFilter("int = 42");
+        ensure_equals( poLayer->GetFeatureCount(), 12 );
+        poLayer->SetAttributeFilter("int = 42");
+        ensure( poLayer->GetAutoIndex()->GetFieldIndex(0) != NULL );
+        ensure_equals( poLayer->GetFeatureCount(), 12 );
+
+        // So do schema changes.
+        ensure_equals( poLayer->DeleteField(0), OGRERR_NONE );
+        ensure( poLayer->GetAutoIndex()->GetFieldIndex(0) == NULL );
+
+        GDALClose(poDS);
+
+        // CSV layers read only the records of the matching features.
+        VSILFILE* fp = VSIFOpenL("/vsimem/test_ogr_attr_index.csv", "wb");
+        VSIFPrintfL(fp, "id,name\n");
+        for( int i = 1; i <= 200; i++ )
+            VSIFPrintfL(fp, "%d,\"name %d\"\n", i, i % 10);
+        VSIFCloseL(fp);
+        const char* const apszOpenOptions[] = { "AUTODETECT_TYPE=YES", NULL };
+        poDS = static_cast<GDALDataset*>(
+            GDALOpenEx("/vsimem/test_ogr_attr_index.csv", GDAL_OF_VECTOR,
+                       NULL, apszOpenOptions, NULL));
+        ensure( poDS != NULL );
+        poLayer = poDS->GetLayer(0);
+        for( int iPass = 0; iPass < 3; iPass++ )
+        {
+            poLayer->SetAttributeFilter("name = 'NAME 3' AND id > 150");
+            int nCount = 0;
+            while( (poFeature = poLayer->GetNextFeature()) != NULL )
+            {
+                ensure_equals( poFeature->GetFieldAsInteger(0) % 10, 3 );
+                ensure_equals( poFeature->GetFID(),
+                               poFeature->GetFieldAsInteger(0) );
+                ensure( poFeature->GetFieldAsInteger(0) > 150 );
+                delete poFeature;
+                nCount++;
+            }
+            ensure_equals( nCount, 5 );
+        }
+        ensure( poLayer->GetAutoIndex() != NULL );
+        ensure( poLayer->GetAutoIndex()->GetFieldIndex(0) != NULL );
+        poLayer->SetAttributeFilter(NULL);
+        ensure_equals( poLayer->GetFeatureCount(), 200 );
+        poFeature = poLayer->GetFeature(7);
+        ensure_equals( poFeature->GetFieldAsInteger(0), 7 );
+        delete poFeature;
+        GDALClose(poDS);
+        VSIUnlink("/vsimem/test_ogr_attr_index.csv");
+    }
+
+    // Test that large GeoJSON FeatureCollection files are streamed
+    template<>
+    template<>
+    void object::test<13>()
+    {
+        const char* pszFilename = "/vsimem/test_ogr_streaming.geojson";
+        VSILFILE* fp = VSIFOpenL(pszFilename, "wb");
+        ensure( fp != NULL );
+        VSIFPrintfL(fp, "\xEF\xBB\xBF{ \"type\": \"FeatureCollection\", "
+                    "\"features\": [\n");
+        for( int i = 0; i < 1000; i++ )
+        {
+            VSIFPrintfL(fp, "%s{ \"type\": \"Feature\", \"id\": %d, "
+                        "\"properties\": { \"name\": \"f[%d]}\\\"\"%s }, "
+                        "\"geometry\": { \"type\": \"Point\", "
+                        "\"coordinates\": [ %d, %d ] } }\n",
+                        i == 0 ? "" : ",", 2 * i, i,
+                        i == 999 ? ", \"extra\": 1.5" : "", i, -i);
+        }
+        // Members after the features are taken into account too.
+        VSIFPrintfL(fp, "], \"name\": \"streamed\" }\n");
+        VSIFCloseL(fp);
+
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            CPLSetConfigOption("OGR_GEOJSON_STREAMING_THRESHOLD",
+                               iPass == 0 ? "0" : NULL);
+            GDALDataset* poDS = reinterpret_cast<GDALDataset*>(
+                GDALOpenEx(pszFilename, GDAL_OF_VECTOR, NULL, NULL, NULL));
+            CPLSetConfigOption("OGR_GEOJSON_STREAMING_THRESHOLD", NULL);
+            ensure( poDS != NULL );
+            OGRLayer* poLayer = poDS->GetLayer(0);
+            ensure( poLayer != NULL );
+            ensure( poLayer->TestCapability(OLCRandomRead) != 0 );
+            ensure_equals( std::string(poLayer->GetName()),
+                           std::string("streamed") );
+            ensure_equals( poLayer->GetGeomType(), wkbPoint );
+            ensure_equals( poLayer->GetLayerDefn()->GetFieldCount(), 2 );
+            ensure_equals( poLayer->GetLayerDefn()->GetFieldDefn(1)->GetType(),
+                           OFTReal );
+            ensure_equals( poLayer->GetFeatureCount(), 1000 );
+            OGREnvelope sEnvelope;
+            ensure_equals( poLayer->GetExtent(&sEnvelope), OGRERR_NONE );
+            ensure_equals( sEnvelope.MinX, 0.0 );
+            ensure_equals( sEnvelope.MaxX, 999.0 );
+            ensure_equals( sEnvelope.MinY, -999.0 );
+            ensure_equals( sEnvelope.MaxY, 0.0 );
+
+            for( int iRead = 0; iRead < 2; iRead++ )
+            {
+                poLayer->ResetReading();
+                int nCount = 0;
+                OGRFeature* poFeature = NULL;
+                while( (poFeature = poLayer->GetNextFeature()) != NULL )
+                {
+                    ensure_equals( poFeature->GetFID(), 2 * nCount );
+                    ensure_equals( std::string(poFeature->GetFieldAsString(0)),
+                                   std::string(CPLSPrintf("f[%d]}\"",
+                                                          nCount)) );
+                    OGRPoint* poPoint =
+                        dynamic_cast<OGRPoint*>(poFeature->GetGeometryRef());
+                    ensure( poPoint != NULL );
+                    ensure_equals( poPoint->getX(),
+                                   static_cast<double>(nCount) );
+                    delete poFeature;
+                    nCount++;
+                }
+                ensure_equals( nCount, 1000 );
+            }
+
+            poLayer->SetAttributeFilter("extra IS NOT NULL");
+            ensure_equals( poLayer->GetFeatureCount(), 1 );
+            poLayer->SetAttributeFilter(NULL);
+
+            OGRFeature* poFeature = poLayer->GetFeature(1000);
+            ensure( poFeature != NULL );
+            ensure_equals( std::string(poFeature->GetFieldAsString(0)),
+                           std::string("f[500]}\"") );
+            delete poFeature;
+
+            GDALClose(poDS);
+        }
+        VSIUnlink(pszFilename);
+    }
+
+    // Test bulk loading of the RTree of GeoPackage layers
+    template<>
+    template<>
+    void object::test<14>()
+    {
+        GDALDriver* poDriver = reinterpret_cast<GDALDriver*>(
+            GDALGetDriverByName("GPKG"));
+        if( poDriver == NULL )
+            return;
+
+        // Pass 0: bounding boxes collected while writing
+        // Pass 1: table scanned, as SetFeature() was used while writing
+        // Pass 2: not enough memory allowed, so progressive insertion
+        for( int iPass = 0; iPass < 3; iPass++ )
+        {
+            const char* pszFilename = "/vsimem/test_ogr_rtree.gpkg";
+            GDALDataset* poDS = poDriver->Create(pszFilename, 0, 0, 0,
+                                                 GDT_Unknown, NULL);
+            ensure( poDS != NULL );
+            OGRLayer* poLayer = poDS->CreateLayer("test", NULL, wkbPoint,
+                                                  NULL);
+            ensure( poLayer != NULL );
+            CPLSetConfigOption("OGR_GPKG_RTREE_MAX_MEMORY",
+                               iPass == 2 ? "0" : NULL);
+            for( int i = 0; i < 10000; i++ )
+            {
+                OGRFeature* poFeature =
+                    new OGRFeature(poLayer->GetLayerDefn());
+                // Leave a few features without geometry, or with an empty one
+                if( (i % 97) == 0 )
+                    poFeature->SetGeometryDirectly(new OGRPoint());
+                else if( (i % 89) != 0 )
+                    poFeature->SetGeometryDirectly(
+                        new OGRPoint((i * 37) % 1000, (i * 11) % 500));
+                ensure_equals( poLayer->CreateFeature(poFeature),
+                               OGRERR_NONE );
+                if( iPass == 1 && i == 5000 )
+                {
+                    ensure_equals( poLayer->SetFeature(poFeature),
+                                   OGRERR_NONE );
+                }
+                delete poFeature;
+            }
+            CPLSetConfigOption("OGR_GPKG_RTREE_MAX_MEMORY", NULL);
+            GDALClose(poDS);
+
+            poDS = reinterpret_cast<GDALDataset*>(
+                GDALOpenEx(pszFilename, GDAL_OF_VECTOR | GDAL_OF_UPDATE,
+                           NULL, NULL, NULL));
+            ensure( poDS != NULL );
+            poLayer = poDS->GetLayer(0);
+            ensure( poLayer != NULL );
+
+            // rtreecheck() is only available in recent SQLite versions
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            OGRLayer* poSQLLyr = poDS->ExecuteSQL(
+                "SELECT rtreecheck('rtree_test_geom')", NULL, NULL);
+            CPLPopErrorHandler();
+            if( poSQLLyr != NULL )
+            {
+                OGRFeature* poFeature = poSQLLyr->GetNextFeature();
+                ensure( poFeature != NULL );
+                ensure_equals( std::string(poFeature->GetFieldAsString(0)),
+                               std::string("ok") );
+                delete poFeature;
+                poDS->ReleaseResultSet(poSQLLyr);
+            }
+
+            poSQLLyr = poDS->ExecuteSQL(
+                "SELECT COUNT(*) FROM rtree_test_geom", NULL, NULL);
+            ensure( poSQLLyr != NULL );
+            OGRFeature* poCountFeature = poSQLLyr->GetNextFeature();
+            ensure( poCountFeature != NULL );
+            int nExpectedTotal = 0;
+            for( int i = 0; i < 10000; i++ )
+            {
+                if( (i % 97) != 0 && (i % 89) != 0 )
+                    nExpectedTotal++;
+            }
+            ensure_equals( poCountFeature->GetFieldAsInteger(0),
+                           nExpectedTotal );
+            delete poCountFeature;
+            poDS->ReleaseResultSet(poSQLLyr);
+
+            for( int iWindow = 0; iWindow < 5; iWindow++ )
+            {
+                const double dfMinX = iWindow * 150 + 0.5;
+                const double dfMaxX = dfMinX + 200;
+                const double dfMinY = iWindow * 70 + 0.5;
+                const double dfMaxY = dfMinY + 100;
+                int nExpected = 0;
+                for( int i = 0; i < 10000; i++ )
+                {
+                    if( (i % 97) == 0 || (i % 89) == 0 )
+                        continue;
+                    const double dfX = (i * 37) % 1000;
+                    const double dfY = (i * 11) % 500;
+                    if( dfX >= dfMinX && dfX <= dfMaxX &&
+                        dfY >= dfMinY && dfY <= dfMaxY )
+                    {
+                        nExpected++;
+                    }
+                }
+                poLayer->SetSpatialFilterRect(dfMinX, dfMinY, dfMaxX, dfMaxY);
+                int nCount = 0;
+                OGRFeature* poFeature = NULL;
+                while( (poFeature = poLayer->GetNextFeature()) != NULL )
+                {
+                    nCount++;
+                    delete poFeature;
+                }
+                ensure_equals( nCount, nExpected );
+            }
+            poLayer->SetSpatialFilter(NULL);
+
+            // The triggers still maintain the index after bulk loading
+            OGRFeature* poFeature = new OGRFeature(poLayer->GetLayerDefn());
+            poFeature->SetGeometryDirectly(new OGRPoint(2000, 2000));
+            ensure_equals( poLayer->CreateFeature(poFeature), OGRERR_NONE );
+            delete poFeature;
+            poLayer->SetSpatialFilterRect(1999, 1999, 2001, 2001);
+            ensure_equals( poLayer->GetFeatureCount(), 1 );
+            poLayer->SetSpatialFilter(NULL);
+
+            GDALClose(poDS);
+            VSIUnlink(pszFilename);
+        }
+    }
+
+    // Test use of .spx spatial indexes by the OpenFileGDB driver
+    template<>
+    template<>
+    void object::test<15>()
+    {
+        if( GDALGetDriverByName("OpenFileGDB") == NULL )
+            return;
+
+        const char* pszFilename =
+            "/vsizip/../ogr/data/testopenfilegdb.gdb.zip/testopenfilegdb.gdb";
+        CPLSetConfigOption("OPENFILEGDB_USE_SPATIAL_INDEX", "NO");
+        GDALDataset* poDSRef = reinterpret_cast<GDALDataset*>(
+            GDALOpenEx(pszFilename, GDAL_OF_VECTOR, NULL, NULL, NULL));
+        ensure( poDSRef != NULL );
+        for( int i = 0; i < poDSRef->GetLayerCount(); i++ )
+            poDSRef->GetLayer(i)->TestCapability(OLCFastSpatialFilter);
+        CPLSetConfigOption("OPENFILEGDB_USE_SPATIAL_INDEX", NULL);
+
+        GDALDataset* poDS = reinterpret_cast<GDALDataset*>(
+            GDALOpenEx(pszFilename, GDAL_OF_VECTOR, NULL, NULL, NULL));
+        ensure( poDS != NULL );
+        ensure_equals( poDS->GetLayerCount(), poDSRef->GetLayerCount() );
+
+        int nLayersWithSpatialIndex = 0;
+        for( int i = 0; i < poDS->GetLayerCount(); i++ )
+        {
+            OGRLayer* poLayerRef = poDSRef->GetLayer(i);
+            OGRLayer* poLayer = poDS->GetLayer(i);
+            if( poLayer->GetGeomType() == wkbNone )
+                continue;
+            if( poLayer->TestCapability(OLCFastSpatialFilter) )
+                nLayersWithSpatialIndex ++;
+            OGREnvelope sExtent;
+            if( poLayerRef->GetExtent(&sExtent) != OGRERR_NONE )
+                continue;
+            const double dfW = sExtent.MaxX - sExtent.MinX;
+            const double dfH = sExtent.MaxY - sExtent.MinY;
+            for( int iWin = 0; iWin < 5; iWin++ )
+            {
+                // Four quadrants of the extent, and a window outside of it
+                const double dfMinX = (iWin == 4) ? sExtent.MaxX + 1 :
+                                sExtent.MinX + (iWin % 2) * dfW / 2;
+                const double dfMinY = (iWin == 4) ? sExtent.MaxY + 1 :
+                                sExtent.MinY + (iWin / 2) * dfH / 2;
+                poLayerRef->SetSpatialFilterRect(dfMinX, dfMinY,
+                                                 dfMinX + dfW / 2,
+                                                 dfMinY + dfH / 2);
+                poLayer->SetSpatialFilterRect(dfMinX, dfMinY,
+                                              dfMinX + dfW / 2,
+                                              dfMinY + dfH / 2);
+                std::vector<GIntBig> anFIDsRef;
+                OGRFeature* poFeature;
+                while( (poFeature = poLayerRef->GetNextFeature()) != NULL )
+                {
+                    anFIDsRef.push_back(poFeature->GetFID());
+                    delete poFeature;
+                }
+                std::vector<GIntBig> anFIDs;
+                while( (poFeature = poLayer->GetNextFeature()) != NULL )
+                {
+                    anFIDs.push_back(poFeature->GetFID());
+                    delete poFeature;
+                }
+                ensure( anFIDs == anFIDsRef );
+                ensure_equals( poLayer->GetFeatureCount(),
+                               static_cast<GIntBig>(anFIDsRef.size()) );
+            }
+            poLayerRef->SetSpatialFilter(NULL);
+            poLayer->SetSpatialFilter(NULL);
+        }
+        ensure( nLayersWithSpatialIndex > 0 );
+
+        GDALClose(poDS);
+        GDALClose(poDSRef);
+    }
+
+    // Test that reading shapefiles from a memory mapping gives the same
+    // geometries as the regular read path
+    template<>
+    template<>
+    void object::test<16>()
+    {
+        if( GDALGetDriverByName("ESRI Shapefile") == NULL )
+            return;
+
+        char** papszFiles = VSIReadDir("../ogr/data");
+        for( char** papszIter = papszFiles;
+             papszIter && *papszIter; ++papszIter )
+        {
+            if( !EQUAL(CPLGetExtension(*papszIter), "shp") )
+                continue;
+            CPLString osFilename(CPLFormFilename("../ogr/data", *papszIter,
+                                                 NULL));
+
+            std::vector<CPLString> aosWKT[2];
+            for( int iPass = 0; iPass < 2; iPass++ )
+            {
+                CPLSetConfigOption("SHAPE_USE_MMAP", iPass == 0 ? "NO" : "YES");
+                CPLPushErrorHandler(CPLQuietErrorHandler);
+                GDALDataset* poDS = reinterpret_cast<GDALDataset*>(
+                    GDALOpenEx(osFilename, GDAL_OF_VECTOR, NULL, NULL, NULL));
+                if( poDS != NULL && poDS->GetLayerCount() == 1 )
+                {
+                    OGRLayer* poLayer = poDS->GetLayer(0);
+                    OGREnvelope sExtent;
+                    for( int iFilter = 0; iFilter < 2; iFilter++ )
+                    {
+                        if( iFilter == 1 )
+                        {
+                            if( poLayer->GetExtent(&sExtent) != OGRERR_NONE )
+                                break;
+                            poLayer->SetSpatialFilterRect(
+                                sExtent.MinX,
+                                sExtent.MinY,
+                                (sExtent.MinX + sExtent.MaxX) / 2,
+                                (sExtent.MinY + sExtent.MaxY) / 2);
+                        }
+                        poLayer->ResetReading();
+                        OGRFeature* poFeature;
+                        while( (poFeature = poLayer->GetNextFeature()) != NULL )
+                        {
+                            CPLString osWKT;
+                            osWKT.Printf(CPL_FRMT_GIB " ", poFeature->GetFID());
+                            OGRGeometry* poGeom = poFeature->GetGeometryRef();
+                            if( poGeom )
+                            {
+                                char* pszWKT = NULL;
+                                poGeom->exportToWkt(&pszWKT, wkbVariantIso);
+                                osWKT += pszWKT;
+                                CPLFree(pszWKT);
+                            }
+                            aosWKT[iPass].push_back(osWKT);
+                            delete poFeature;
+                        }
+                    }
+                    OGRFeature* poFeature = poLayer->GetFeature(0);
+                    aosWKT[iPass].push_back(poFeature != NULL &&
+                        poFeature->GetGeometryRef() != NULL ?
+                        poFeature->GetGeometryRef()->getGeometryName() : "");
+                    delete poFeature;
+                }
+                GDALClose(poDS);
+                CPLPopErrorHandler();
+            }
+            CPLSetConfigOption("SHAPE_USE_MMAP", NULL);
+
+            ensure_equals( osFilename.c_str(),
+                           aosWKT[1].size(), aosWKT[0].size() );
+            for( size_t i = 0; i < aosWKT[0].size(); i++ )
+            {
+                ensure_equals( osFilename.c_str(),
+                               aosWKT[1][i], aosWKT[0][i] );
+            }
+        }
+        CSLDestroy(papszFiles);
+    }
+
+    // Test that spatial filtering through a .hrt Hilbert R-tree gives the
+    // same results as a full scan
+    template<>
+    template<>
+    void object::test<17>()
+    {
+        GDALDriver* poDriver = reinterpret_cast<GDALDriver*>(
+            GDALGetDriverByName("ESRI Shapefile"));
+        if( poDriver == NULL )
+            return;
+
+        CPLString osFilename(CPLFormFilename(tut::common::tmp_basedir.c_str(),
+                                             "test_hrt.shp", NULL));
+        CPLString osHRTFilename(CPLResetExtension(osFilename, "hrt"));
+        GDALDataset* poDS = poDriver->Create(osFilename, 0, 0, 0,
+                                             GDT_Unknown, NULL);
+        ensure( poDS != NULL );
+        OGRLayer* poLayer = poDS->CreateLayer("test_hrt", NULL, wkbPolygon,
+                                              NULL);
+        ensure( poLayer != NULL );
+        for( int i = 0; i < 10000; i++ )
+        {
+            OGRFeature oFeature(poLayer->GetLayerDefn());
+            if( (i % 97) != 0 )
+            {
+                const double dfX = (i * 7919) % 1000;
+                const double dfY = (i * 104729) % 1000;
+                const double dfSize = 1 + (i % 13);
+                OGRLinearRing* poRing = new OGRLinearRing();
+                poRing->addPoint(dfX, dfY);
+                poRing->addPoint(dfX, dfY + dfSize);
+                poRing->addPoint(dfX + dfSize, dfY + dfSize);
+                poRing->addPoint(dfX + dfSize, dfY);
+                poRing->addPoint(dfX, dfY);
+                OGRPolygon* poPoly = new OGRPolygon();
+                poPoly->addRingDirectly(poRing);
+                oFeature.SetGeometryDirectly(poPoly);
+            }
+            ensure_equals( poLayer->CreateFeature(&oFeature), OGRERR_NONE );
+        }
+        GDALClose(poDS);
+
+        const double adfWindows[][4] = {
+            { 0, 0, 1000, 1000 },
+            { 100, 200, 150, 260 },
+            { 500.5, 500.5, 500.6, 500.6 },
+            { -10, -10, 5, 5 },
+            { 990, 0, 2000, 1000 },
+            { 2000, 2000, 3000, 3000 } };
+        const int nWindows =
+            static_cast<int>(sizeof(adfWindows) / sizeof(adfWindows[0]));
+
+        // Pass 0: no index, 1: default node size, 2: small node size,
+        // 3: index created on first spatial query.
+        std::vector<GIntBig> anFIDs[4];
+        for( int iPass = 0; iPass < 4; iPass++ )
+        {
+            CPLStringList aosOpenOptions;
+            if( iPass == 3 )
+                aosOpenOptions.SetNameValue("AUTO_SPATIAL_INDEX", "YES");
+            poDS = reinterpret_cast<GDALDataset*>(
+                GDALOpenEx(osFilename, GDAL_OF_VECTOR, NULL,
+                           aosOpenOptions.List(), NULL));
+            ensure( poDS != NULL );
+            if( iPass == 1 )
+                poDS->ExecuteSQL("CREATE SPATIAL INDEX ON test_hrt USING HRT",
+                                 NULL, NULL);
+            else if( iPass == 2 )
+                poDS->ExecuteSQL("CREATE SPATIAL INDEX ON test_hrt USING HRT "
+                                 "NODE_SIZE 3", NULL, NULL);
+            poLayer = poDS->GetLayer(0);
+
+            VSIStatBufL sStat;
+            ensure_equals( VSIStatL(osHRTFilename, &sStat) == 0,
+                           iPass == 1 || iPass == 2 );
+            ensure_equals( poLayer->TestCapability(OLCFastSpatialFilter) != 0,
+                           iPass == 1 || iPass == 2 );
+
+            for( int iWindow = 0; iWindow < nWindows; iWindow++ )
+            {
+                poLayer->SetSpatialFilterRect(adfWindows[iWindow][0],
+                                              adfWindows[iWindow][1],
+                                              adfWindows[iWindow][2],
+                                              adfWindows[iWindow][3]);
+                poLayer->ResetReading();
+                OGRFeature* poFeature;
+                while( (poFeature = poLayer->GetNextFeature()) != NULL )
+                {
+                    // Like with .qix indexes, null shapes are only returned
+                    // by full scans.
+                    if( poFeature->GetGeometryRef() != NULL )
+                        anFIDs[iPass].push_back(poFeature->GetFID());
+                    delete poFeature;
+                }
+                anFIDs[iPass].push_back(-1);
+            }
+
+            if( iPass == 3 )
+            {
+                ensure( VSIStatL(osHRTFilename, &sStat) == 0 );
+                ensure( poLayer->TestCapability(OLCFastSpatialFilter) != 0 );
+            }
+            else if( iPass == 2 )
+            {
+                poDS->ExecuteSQL("DROP SPATIAL INDEX ON test_hrt", NULL, NULL);
+                ensure( VSIStatL(osHRTFilename, &sStat) != 0 );
+            }
+            GDALClose(poDS);
+        }
+
+        ensure( anFIDs[0].size() > 2 * static_cast<size_t>(nWindows) );
+        for( int iPass = 1; iPass < 4; iPass++ )
+        {
+            ensure_equals( anFIDs[iPass].size(), anFIDs[0].size() );
+            for( size_t i = 0; i < anFIDs[0].size(); i++ )
+                ensure_equals( anFIDs[iPass][i], anFIDs[0][i] );
+        }
+
+        // Creating a .hrt keeps a .qix for other software, and the .hrt
+        // takes precedence
+        CPLString osQIXFilename(CPLResetExtension(osFilename, "qix"));
+        poDS = reinterpret_cast<GDALDataset*>(
+            GDALOpenEx(osFilename, GDAL_OF_VECTOR | GDAL_OF_UPDATE, NULL,
+                       NULL, NULL));
+        ensure( poDS != NULL );
+        poDS->ExecuteSQL("CREATE SPATIAL INDEX ON test_hrt", NULL, NULL);
+        poDS->ExecuteSQL("CREATE SPATIAL INDEX ON test_hrt USING HRT",
+                         NULL, NULL);
+        VSIStatBufL sStat;
+        ensure( VSIStatL(osQIXFilename, &sStat) == 0 );
+        ensure( VSIStatL(osHRTFilename, &sStat) == 0 );
+        GDALClose(poDS);
+
+        poDriver->Delete(osFilename);
+        ensure( VSIStatL(osHRTFilename, &sStat) != 0 );
+        ensure( VSIStatL(osQIXFilename, &sStat) != 0 );
+    }
+
+    // Test that parsing CSV files with several threads gives the same
+    // features, FIDs and detected field types as with a single thread
+    template<>
+    template<>
+    void object::test<18>()
+    {
+        if( GDALGetDriverByName("CSV") == NULL )
+            return;
+
+        CPLString osFilename(CPLFormFilename(tut::common::tmp_basedir.c_str(),
+                                             "test_parallel.csv", NULL));
+        VSILFILE* fp = VSIFOpenL(osFilename, "wb");
+        ensure( fp != NULL );
+        VSIFPrintfL(fp, "\xEF\xBB\xBFid,name,value,when,WKT\r\n");
+        for( int i = 0; i < 3000; i++ )
+        {
+            if( i % 101 == 0 )
+                VSIFPrintfL(fp, "\r\n");
+            if( i % 7 == 0 )
+                VSIFPrintfL(fp, "%d,\"multi\r\nline \"\"%d\"\"\",%d.5,"
+                            "2018/01/%02d,\"POINT (%d %d)\"\r\n",
+                            i, i, i, 1 + i % 28, i, -i);
+            else
+                VSIFPrintfL(fp, "%d,name %d,%d,2018/02/%02d,\r\n",
+                            i, i, i, 1 + i % 28);
+        }
+        // Last record without line ending
+        VSIFPrintfL(fp, "3000,\"last\",1,2018/03/01,POINT (1 2)");
+        VSIFCloseL(fp);
+
+        CPLSetConfigOption("OGR_CSV_PARALLEL_CHUNK_SIZE", "1024");
+        std::vector<CPLString> aosResults[2];
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            const char* const apszOptions[] = {
+                "AUTODETECT_TYPE=YES", "AUTODETECT_SIZE_LIMIT=0",
+                iPass == 0 ? "NUM_THREADS=1" : "NUM_THREADS=4", NULL };
+            GDALDataset* poDS = reinterpret_cast<GDALDataset*>(
+                GDALOpenEx(osFilename, GDAL_OF_VECTOR, NULL,
+                           apszOptions, NULL));
+            ensure( poDS != NULL );
+            OGRLayer* poLayer = poDS->GetLayer(0);
+            OGRFeatureDefn* poDefn = poLayer->GetLayerDefn();
+            for( int i = 0; i < poDefn->GetFieldCount(); i++ )
+            {
+                aosResults[iPass].push_back(CPLString(
+                    poDefn->GetFieldDefn(i)->GetNameRef()) + " " +
+                    OGRFieldDefn::GetFieldTypeName(
+                        poDefn->GetFieldDefn(i)->GetType()));
+            }
+            aosResults[iPass].push_back(
+                CPLSPrintf(CPL_FRMT_GIB, poLayer->GetFeatureCount()));
+
+            // Read part of the layer, then jump to a feature and restart.
+            for( int iRead = 0; iRead < 2; iRead++ )
+            {
+                poLayer->ResetReading();
+                OGRFeature* poFeature;
+                int nRead = 0;
+                while( (poFeature = poLayer->GetNextFeature()) != NULL )
+                {
+                    CPLString osLine;
+                    osLine.Printf(CPL_FRMT_GIB " ", poFeature->GetFID());
+                    for( int i = 0; i < poDefn->GetFieldCount(); i++ )
+                    {
+                        osLine += poFeature->GetFieldAsString(i);
+                        osLine += "|";
+                    }
+                    OGRGeometry* poGeom = poFeature->GetGeometryRef();
+                    if( poGeom )
+                    {
+                        char* pszWKT = NULL;
+                        poGeom->exportToWkt(&pszWKT);
+                        osLine += pszWKT;
+                        CPLFree(pszWKT);
+                    }
+                    aosResults[iPass].push_back(osLine);
+                    delete poFeature;
+                    if( iRead == 0 && ++nRead == 1000 )
+                        break;
+                }
+                poFeature = poLayer->GetFeature(2500);
+                ensure( poFeature != NULL );
+                aosResults[iPass].push_back(poFeature->GetFieldAsString(1));
+                delete poFeature;
+                poFeature = poLayer->GetNextFeature();
+                ensure( poFeature != NULL );
+                aosResults[iPass].push_back(
+                    CPLSPrintf(CPL_FRMT_GIB, poFeature->GetFID()));
+                delete poFeature;
+            }
+            GDALClose(poDS);
+        }
+        CPLSetConfigOption("OGR_CSV_PARALLEL_CHUNK_SIZE", NULL);
+        VSIUnlink(osFilename);
+
+        ensure_equals( aosResults[1].size(), aosResults[0].size() );
+        for( size_t i = 0; i < aosResults[0].size(); i++ )
+            ensure_equals( aosResults[1][i], aosResults[0][i] );
+    }
+
+    // Test that translating GML features with several threads gives the
+    // same schema, extent and features as with a single thread
+    template<>
+    template<>
+    void object::test<19>()
+    {
+        GDALDriver* poDriver = GetGDALDriverManager()->GetDriverByName("GML");
+        if( poDriver == NULL )
+            return;
+
+        CPLString osFilename(CPLFormFilename(tut::common::tmp_basedir.c_str(),
+                                             "test_threaded.gml", NULL));
+        CPLString osGFS(CPLResetExtension(osFilename, "gfs"));
+        {
+            const char* const apszOptions[] = { "XSISCHEMA=OFF", NULL };
+            GDALDataset* poDS = poDriver->Create(
+                osFilename, 0, 0, 0, GDT_Unknown,
+                const_cast<char**>(apszOptions));
+            ensure( poDS != NULL );
+            OGRLayer* poLayer = poDS->CreateLayer("test", NULL, wkbUnknown);
+            OGRFieldDefn oFieldStr("str", OFTString);
+            poLayer->CreateField(&oFieldStr);
+            OGRFieldDefn oFieldReal("val", OFTReal);
+            poLayer->CreateField(&oFieldReal);
+            for( int i = 0; i < 1000; i++ )
+            {
+                OGRFeature* poFeature =
+                    new OGRFeature(poLayer->GetLayerDefn());
+                poFeature->SetField(0, CPLSPrintf("feature %d", i));
+                poFeature->SetField(1, i * 0.5);
+                if( i % 13 != 0 )
+                {
+                    OGRGeometry* poGeom = NULL;
+                    CPLString osWKT;
+                    if( i % 2 == 0 )
+                        osWKT.Printf("POLYGON ((%d 0,%d 1,%d 1,%d 0,%d 0))",
+                                     i, i, i + 1, i + 1, i);
+                    else
+                        osWKT.Printf("LINESTRING (%d %d,%d %d)",
+                                     i, -i, i + 2, i);
+                    char* pszWKT = const_cast<char*>(osWKT.c_str());
+                    OGRGeometryFactory::createFromWkt(&pszWKT, NULL, &poGeom);
+                    poFeature->SetGeometryDirectly(poGeom);
+                }
+                ensure_equals( poLayer->CreateFeature(poFeature),
+                               OGRERR_NONE );
+                delete poFeature;
+            }
+            GDALClose(poDS);
+        }
+
+        CPLSetConfigOption("GML_THREADED_BATCH_SIZE", "7");
+        std::vector<CPLString> aosResults[2];
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            // Make sure the schema is established by a prescan.
+            VSIUnlink(osGFS);
+            const char* const apszOptions[] = {
+                iPass == 0 ? "NUM_THREADS=1" : "NUM_THREADS=4", NULL };
+            GDALDataset* poDS = reinterpret_cast<GDALDataset*>(
+                GDALOpenEx(osFilename, GDAL_OF_VECTOR, NULL,
+                           apszOptions, NULL));
+            ensure( poDS != NULL );
+            OGRLayer* poLayer = poDS->GetLayer(0);
+            OGREnvelope sExtent;
+            ensure_equals( poLayer->GetExtent(&sExtent, FALSE), OGRERR_NONE );
+            aosResults[iPass].push_back(CPLSPrintf("%s %.1f %.1f %.1f %.1f",
+                OGRGeometryTypeToName(poLayer->GetGeomType()),
+                sExtent.MinX, sExtent.MinY,
+                sExtent.MaxX, sExtent.MaxY));
+            aosResults[iPass].push_back(
+                CPLSPrintf(CPL_FRMT_GIB, poLayer->GetFeatureCount(FALSE)));
+
+            for( int iFilter = 0; iFilter < 2; iFilter++ )
+            {
+                if( iFilter == 1 )
+                    poLayer->SetSpatialFilterRect(100, -50, 300, 50);
+                poLayer->ResetReading();
+                OGRFeature* poFeature;
+                while( (poFeature = poLayer->GetNextFeature()) != NULL )
+                {
+                    CPLString osLine;
+                    osLine.Printf(CPL_FRMT_GIB " ", poFeature->GetFID());
+                    osLine += poFeature->GetFieldAsString("str");
+                    osLine += " ";
+                    osLine += poFeature->GetFieldAsString("val");
+                    osLine += " ";
+                    OGRGeometry* poGeom = poFeature->GetGeometryRef();
+                    if( poGeom )
+                    {
+                        char* pszWKT = NULL;
+                        poGeom->exportToWkt(&pszWKT);
+                        osLine += pszWKT;
+                        CPLFree(pszWKT);
+                    }
+                    aosResults[iPass].push_back(osLine);
+                    delete poFeature;
+                }
+            }
+            GDALClose(poDS);
+        }
+        CPLSetConfigOption("GML_THREADED_BATCH_SIZE", NULL);
+        VSIUnlink(osFilename);
+        VSIUnlink(osGFS);
+
+        ensure( aosResults[0].size() > 1000 );
+        ensure_equals( aosResults[1].size(), aosResults[0].size() );
+        for( size_t i = 0; i < aosResults[0].size(); i++ )
+            ensure_equals( aosResults[1][i], aosResults[0][i] );
+    }
+
+    // Test that the OSM driver gives the same features when resolving ways
+    // and building multipolygons in several threads
+    template<>
+    template<>
+    void object::test<20>()
+    {
+        if( GDALGetDriverByName("OSM") == NULL )
+            return;
+
+        CPLString osFilename(CPLFormFilename(tut::common::tmp_basedir.c_str(),
+                                             "test_threaded.osm", NULL));
+        VSILFILE* fp = VSIFOpenL(osFilename, "wb");
+        ensure( fp != NULL );
+        VSIFPrintfL(fp, "<?xml version='1.0' encoding='UTF-8'?>\n"
+                        "<osm version='0.6' generator='test'>\n");
+        // Grid of 150x150 nodes, with a hole every 37 nodes.
+        const int nSize = 150;
+        for( int i = 0; i < nSize * nSize; i++ )
+        {
+            if( i % 37 == 36 )
+                continue;
+            VSIFPrintfL(fp, "<node id='%d' lat='%.7f' lon='%.7f'/>\n",
+                        i + 1, 0.001 * (i / nSize), 0.001 * (i % nSize));
+        }
+        // Lines along the rows.
+        int nWayId = 1;
+        for( int iRow = 0; iRow < nSize; iRow++ )
+        {
+            for( int iCol = 0; iCol + 10 <= nSize; iCol += 10 )
+            {
+                VSIFPrintfL(fp, "<way id='%d'>", nWayId++);
+                for( int k = 0; k < 10; k++ )
+                    VSIFPrintfL(fp, "<nd ref='%d'/>",
+                                iRow * nSize + iCol + k + 1);
+                VSIFPrintfL(fp, "<tag k='highway' v='residential'/>"
+                                "<tag k='name' v='row %d'/></way>\n", iRow);
+            }
+        }
+        // Closed ways: buildings, and untagged rings used by relations.
+        const int nFirstRingId = nWayId;
+        for( int iRow = 0; iRow + 3 < nSize; iRow += 4 )
+        {
+            for( int iCol = 0; iCol + 3 < nSize; iCol += 4 )
+            {
+                const int n0 = iRow * nSize + iCol + 1;
+                VSIFPrintfL(fp, "<way id='%d'><nd ref='%d'/><nd ref='%d'/>"
+                                "<nd ref='%d'/><nd ref='%d'/><nd ref='%d'/>",
+                            nWayId, n0, n0 + 3, n0 + 3 * nSize + 3,
+                            n0 + 3 * nSize, n0);
+                if( nWayId % 3 == 0 )
+                    VSIFPrintfL(fp, "<tag k='building' v='yes'/>");
+                VSIFPrintfL(fp, "</way>\n");
+                nWayId++;
+            }
+        }
+        const int nLastRingId = nWayId - 1;
+        // Relations: outer ring with an inner ring, and outer rings made
+        // of two open ways.
+        int nRelId = 1;
+        for( int iRing = nFirstRingId; iRing + 1 <= nLastRingId; iRing += 2 )
+        {
+            VSIFPrintfL(fp, "<relation id='%d'>"
+                            "<member type='way' ref='%d' role='outer'/>",
+                        nRelId, iRing);
+            if( nRelId % 2 == 0 )
+                VSIFPrintfL(fp, "<member type='way' ref='%d' role='outer'/>",
+                            iRing + 1);
+            else if( nRelId % 5 == 0 )
+                VSIFPrintfL(fp, "<member type='way' ref='%d' role='outer'/>",
+                            nWayId + 1000);
+            VSIFPrintfL(fp, "<tag k='type' v='multipolygon'/>");
+            if( nRelId % 4 != 0 )
+                VSIFPrintfL(fp, "<tag k='landuse' v='grass'/>");
+            VSIFPrintfL(fp, "</relation>\n");
+            nRelId++;
+        }
+        for( int iRow = 0; iRow + 10 < nSize; iRow += 10 )
+        {
+            const int n0 = iRow * nSize + 1;
+            VSIFPrintfL(fp, "<way id='%d'><nd ref='%d'/><nd ref='%d'/>"
+                            "<nd ref='%d'/></way>\n",
+                        nWayId, n0, n0 + 5, n0 + 5 + 5 * nSize);
+            VSIFPrintfL(fp, "<way id='%d'><nd ref='%d'/><nd ref='%d'/>"
+                            "<nd ref='%d'/></way>\n",
+                        nWayId + 1, n0 + 5 + 5 * nSize, n0 + 5 * nSize, n0);
+            VSIFPrintfL(fp, "<relation id='%d'>"
+                            "<member type='way' ref='%d' role='outer'/>"
+                            "<member type='way' ref='%d' role='outer'/>"
+                            "<tag k='type' v='multipolygon'/>"
+                            "<tag k='natural' v='water'/></relation>\n",
+                        nRelId++, nWayId, nWayId + 1);
+            nWayId += 2;
+        }
+        VSIFPrintfL(fp, "</osm>\n");
+        VSIFCloseL(fp);
+
+        // Use the configuration file of the source tree if GDAL_DATA is
+        // not set.
+        CPLString osConfigFile("CONFIG_FILE=");
+        const char* pszConfigFile = CPLFindFile("gdal", "osmconf.ini");
+        osConfigFile += pszConfigFile ? pszConfigFile :
+                                        "../../gdal/data/osmconf.ini";
+
+        std::vector<CPLString> aosResults[4];
+        for( int iPass = 0; iPass < 4; iPass++ )
+        {
+            CPLSetConfigOption("GDAL_NUM_THREADS", (iPass % 2) ? "4" : "1");
+            const char* const apszOptions[] = {
+                (iPass / 2) ? "COMPRESS_NODES=YES" : "COMPRESS_NODES=NO",
+                osConfigFile.c_str(), NULL };
+            GDALDataset* poDS = reinterpret_cast<GDALDataset*>(
+                GDALOpenEx(osFilename, GDAL_OF_VECTOR, NULL,
+                           apszOptions, NULL));
+            CPLSetConfigOption("GDAL_NUM_THREADS", NULL);
+            ensure( poDS != NULL );
+
+            OGRLayer* poLayer = NULL;
+            OGRFeature* poFeature;
+            while( (poFeature = poDS->GetNextFeature(&poLayer, NULL,
+                                                     NULL, NULL)) != NULL )
+            {
+                CPLString osLine(poLayer->GetName());
+                for( int i = 0; i < poFeature->GetFieldCount(); i++ )
+                {
+                    osLine += " ";
+                    osLine += poFeature->GetFieldAsString(i);
+                }
+                OGRGeometry* poGeom = poFeature->GetGeometryRef();
+                if( poGeom )
+                {
+                    char* pszWKT = NULL;
+                    poGeom->exportToWkt(&pszWKT);
+                    osLine += " ";
+                    osLine += pszWKT;
+                    CPLFree(pszWKT);
+                }
+                aosResults[iPass].push_back(osLine);
+                delete poFeature;
+            }
+            GDALClose(poDS);
+        }
+        VSIUnlink(osFilename);
+
+        ensure( aosResults[0].size() > 3000 );
+        for( int iPass = 1; iPass < 4; iPass++ )
+        {
+            ensure_equals( aosResults[iPass].size(), aosResults[0].size() );
+            for( size_t i = 0; i < aosResults[0].size(); i++ )
+                ensure_equals( aosResults[iPass][i], aosResults[0][i] );
+        }
+    }
+
+    // Test that constraints, column subsets and spatial predicates pushed
+    // down by the SQLite dialect to OGR layers give the same results as
+    // when SQLite evaluates them
+    template<>
+    template<>
+    void object::test<21>()
+    {
+        GDALDriver* poDriver = reinterpret_cast<GDALDriver*>(
+                                            GDALGetDriverByName("Memory"));
+        GDALDriver* poCSVDriver = reinterpret_cast<GDALDriver*>(
+                                            GDALGetDriverByName("CSV"));
+        if( poDriver == NULL || poCSVDriver == NULL ||
+            GDALGetDriverByName("SQLite") == NULL )
+            return;
+
+        GDALDataset* poMemDS =
+            poDriver->Create("", 0, 0, 0, GDT_Unknown, NULL);
+        ensure( poMemDS != NULL );
+        OGRLayer* poLayer = poMemDS->CreateLayer("test", NULL, wkbPoint, NULL);
+        ensure( poLayer != NULL );
+        OGRFieldDefn oFieldId("id", OFTInteger);
+        ensure_equals( poLayer->CreateField(&oFieldId), OGRERR_NONE );
+        OGRFieldDefn oFieldName("name", OFTString);
+        ensure_equals( poLayer->CreateField(&oFieldName), OGRERR_NONE );
+        OGRFieldDefn oFieldVal("val", OFTReal);
+        ensure_equals( poLayer->CreateField(&oFieldVal), OGRERR_NONE );
+        // Mix values that only differ by case, which OGR SQL considers
+        // as equal but SQLite does not
+        const char* const apszNames[] = { "abc", "ABC", "Zed", "zed" };
+        for( int i = 0; i < 400; i++ )
+        {
+            OGRFeature oFeature(poLayer->GetLayerDefn());
+            oFeature.SetField(0, i);
+            if( (i % 7) == 0 )
+                /* null name */;
+            else if( (i % 3) == 0 )
+                oFeature.SetField(1, apszNames[(i / 3) % 4]);
+            else
+                oFeature.SetField(1, CPLSPrintf((i % 2) ? "Name_%d" :
+                                                          "name_%d", i));
+            oFeature.SetField(2, i * 0.5);
+            oFeature.SetGeometryDirectly(new OGRPoint(i % 20, i / 20));
+            ensure_equals( poLayer->CreateFeature(&oFeature), OGRERR_NONE );
+        }
+
+        // Same layer, without geometry, in a CSV file
+        CPLString osCSVDir(CPLFormFilename(tut::common::tmp_basedir.c_str(),
+                                           "test_ogr_21", NULL));
+        VSIUnlink(CPLFormFilename(osCSVDir, "test", "csv"));
+        VSIUnlink(CPLFormFilename(osCSVDir, "test", "csvt"));
+        VSIRmdir(osCSVDir);
+        const char* const apszCSVOptions[] = { "CREATE_CSVT=YES", NULL };
+        GDALDataset* poCSVDS = poCSVDriver->Create(osCSVDir, 0, 0, 0,
+                                                   GDT_Unknown, NULL);
+        ensure( poCSVDS != NULL );
+        ensure( poCSVDS->CopyLayer(poLayer, "test",
+                                   const_cast<char**>(apszCSVOptions)) != NULL );
+        GDALClose(poCSVDS);
+        const char* const apszCSVOpenOptions[] = {
+            "EMPTY_STRING_AS_NULL=YES", NULL };
+        poCSVDS = reinterpret_cast<GDALDataset*>(
+            GDALOpenEx(osCSVDir, GDAL_OF_VECTOR, NULL,
+                       apszCSVOpenOptions, NULL));
+        ensure( poCSVDS != NULL );
+
+        // Each statement is followed by an equivalent one whose
+        // constraints cannot be passed to the layer
+        const char* const apszSQL[] = {
+            "SELECT id, name FROM test WHERE id IN (3, 5, 7, 1000)",
+            "SELECT id, name FROM test WHERE id + 0 IN (3, 5, 7, 1000)",
+            "SELECT id FROM test WHERE val >= 10.5 AND val < 20",
+            "SELECT id FROM test WHERE val + 0 >= 10.5 AND val + 0 < 20",
+            "SELECT id, val FROM test WHERE name LIKE 'name_1%'",
+            "SELECT id, val FROM test WHERE name || '' LIKE 'name_1%'",
+            "SELECT id FROM test WHERE name LIKE 'A%'",
+            "SELECT id FROM test WHERE name || '' LIKE 'A%'",
+            "SELECT id FROM test WHERE name LIKE 'zE%'",
+            "SELECT id FROM test WHERE name || '' LIKE 'zE%'",
+            "SELECT id, name FROM test WHERE name LIKE 'Name\\_2%' "
+                "ESCAPE '\\'",
+            "SELECT id, name FROM test WHERE name || '' LIKE 'Name\\_2%' "
+                "ESCAPE '\\'",
+            "SELECT id FROM test WHERE name IS NULL",
+            "SELECT id FROM test WHERE name || '' IS NULL",
+            "SELECT COUNT(*), SUM(val) FROM test WHERE name IS NOT NULL",
+            "SELECT COUNT(*), SUM(val) FROM test WHERE name || '' IS NOT NULL",
+            "SELECT id, name FROM test WHERE id <> 5 AND id < 10",
+            "SELECT id, name FROM test WHERE id + 0 <> 5 AND id + 0 < 10",
+            "SELECT id FROM test WHERE name = 'abc'",
+            "SELECT id FROM test WHERE name || '' = 'abc'",
+            "SELECT id FROM test WHERE name <> 'abc'",
+            "SELECT id FROM test WHERE name || '' <> 'abc'",
+            "SELECT id FROM test WHERE name IN ('abc', 'Zed', 'nothing')",
+            "SELECT id FROM test WHERE name || '' IN ('abc', 'Zed', 'nothing')",
+            "SELECT id, name FROM test WHERE id IN (3, 6, 9) AND "
+                "name IN ('ABC', 'zed')",
+            "SELECT id, name FROM test WHERE id + 0 IN (3, 6, 9) AND "
+                "name || '' IN ('ABC', 'zed')",
+            "SELECT name, AsText(geometry) FROM test WHERE "
+                "ST_Intersects(geometry, "
+                "ST_GeomFromText('POLYGON((2 3,2 6,5 6,5 3,2 3))'))",
+            "SELECT name, AsText(geometry) FROM test WHERE "
+                "ST_Intersects(ST_GeomFromText(AsText(geometry)), "
+                "ST_GeomFromText('POLYGON((2 3,2 6,5 6,5 3,2 3))'))",
+        };
+        // The last pair uses the geometry, which is not in the CSV file
+        const size_t nSQLCount = CPL_ARRAYSIZE(apszSQL);
+
+        for( int iDS = 0; iDS < 2; iDS++ )
+        {
+            GDALDataset* poDS = (iDS == 0) ? poMemDS : poCSVDS;
+            std::vector<CPLString> aosResults[2];
+            for( size_t iSQL = 0;
+                 iSQL < ((iDS == 0) ? nSQLCount : nSQLCount - 2); iSQL++ )
+            {
+                std::vector<CPLString>& aosResult = aosResults[iSQL % 2];
+                aosResult.clear();
+                OGRLayer* poSQLLyr = poDS->ExecuteSQL(apszSQL[iSQL], NULL,
+                                                      "SQLITE");
+                ensure( apszSQL[iSQL], poSQLLyr != NULL );
+                OGRFeature* poFeature;
+                while( (poFeature = poSQLLyr->GetNextFeature()) != NULL )
+                {
+                    CPLString osLine;
+                    for( int i = 0; i < poFeature->GetFieldCount(); i++ )
+                    {
+                        osLine += poFeature->GetFieldAsString(i);
+                        osLine += "|";
+                    }
+                    aosResult.push_back(osLine);
+                    delete poFeature;
+                }
+                poDS->ReleaseResultSet(poSQLLyr);
+
+                if( (iSQL % 2) == 1 )
+                {
+                    ensure( apszSQL[iSQL], !aosResults[0].empty() );
+                    std::sort(aosResults[0].begin(), aosResults[0].end());
+                    std::sort(aosResults[1].begin(), aosResults[1].end());
+                    ensure_equals( apszSQL[iSQL],
+                                   aosResults[0].size(), aosResults[1].size() );
+                    for( size_t i = 0; i < aosResults[0].size(); i++ )
+                        ensure_equals( apszSQL[iSQL],
+                                       aosResults[0][i], aosResults[1][i] );
+                }
+            }
+            if( iDS == 0 )
+                ensure_equals( aosResults[0].size(), 16U );
+
+            // The layer must be left as it was
+            OGRLayer* poSrcLayer = poDS->GetLayerByName("test");
+            ensure( poSrcLayer != NULL );
+            ensure( poSrcLayer->GetSpatialFilter() == NULL );
+            ensure( !poSrcLayer->GetLayerDefn()->GetFieldDefn(1)->IsIgnored() );
+        }
+        ensure( !poLayer->GetLayerDefn()->GetGeomFieldDefn(0)->IsIgnored() );
+
+        GDALClose(poCSVDS);
+        GDALClose(poMemDS);
+        VSIUnlink(CPLFormFilename(osCSVDir, "test", "csv"));
+        VSIUnlink(CPLFormFilename(osCSVDir, "test", "csvt"));
+        VSIRmdir(osCSVDir);
+    }
+
+    static int gnGenSQLMergedRuns = 0;
+
+    static void CPL_STDCALL GenSQLRunsErrorHandler( CPLErr eErr,
+                                                    CPLErrorNum,
+                                                    const char* pszMsg )
+    {
+        int nRuns = 0;
+        if( eErr == CE_Debug &&
+            sscanf(pszMsg, "GenSQL: ORDER BY: merging %d sorted runs",
+                   &nRuns) == 1 )
+        {
+            gnGenSQLMergedRuns = nRuns;
+        }
+    }
+
+    static std::string GetGenSQLSortString( int i )
+    {
+        return std::string(5000 + (i % 4) * 100,
+                           static_cast<char>('A' + i % 3));
+    }
+
+    // Compares test<22> features as ORDER BY key, str DESC, with ties
+    // broken by reading order.
+    static bool GenSQLSortLess( int i, int j )
+    {
+        const int nKeyI = (i * 37) % 20;
+        const int nKeyJ = (j * 37) % 20;
+        if( nKeyI != nKeyJ )
+            return nKeyI < nKeyJ;
+        const std::string osI(GetGenSQLSortString(i));
+        const std::string osJ(GetGenSQLSortString(j));
+        if( osI != osJ )
+            return osI > osJ;
+        return i < j;
+    }
+
+    // Test ORDER BY through the external merge of sorted runs spilled to
+    // disk, with two keys, ties spread over several runs, records larger
+    // than the read buffer of the runs and an OFFSET
+    template<>
+    template<>
+    void object::test<22>()
+    {
+        GDALDriver* poDriver = reinterpret_cast<GDALDriver*>(
+                                            GDALGetDriverByName("Memory"));
+        if( poDriver == NULL )
+            return;
+
+        GDALDataset* poDS = poDriver->Create("", 0, 0, 0, GDT_Unknown, NULL);
+        ensure( poDS != NULL );
+        OGRLayer* poLayer = poDS->CreateLayer("test", NULL, wkbNone, NULL);
+        ensure( poLayer != NULL );
+        OGRFieldDefn oFieldKey("key", OFTInteger);
+        ensure_equals( poLayer->CreateField(&oFieldKey), OGRERR_NONE );
+        OGRFieldDefn oFieldStr("str", OFTString);
+        ensure_equals( poLayer->CreateField(&oFieldStr), OGRERR_NONE );
+        const int nFeatures = 200;
+        std::vector<int> anExpected;
+        for( int i = 0; i < nFeatures; i++ )
+        {
+            OGRFeature oFeature(poLayer->GetLayerDefn());
+            oFeature.SetField(0, (i * 37) % 20);
+            oFeature.SetField(1, GetGenSQLSortString(i).c_str());
+            ensure_equals( poLayer->CreateFeature(&oFeature), OGRERR_NONE );
+            ensure_equals( oFeature.GetFID(), i );
+            anExpected.push_back(i);
+        }
+        std::sort(anExpected.begin(), anExpected.end(), GenSQLSortLess);
+
+        const int anOffsets[] = { 0, 150 };
+        for( size_t iOffset = 0; iOffset < CPL_ARRAYSIZE(anOffsets);
+             iOffset++ )
+        {
+            const int nOffset = anOffsets[iOffset];
+
+            // The features are sorted when first read, in runs of about
+            // 4 features
+            gnGenSQLMergedRuns = 0;
+            CPLSetConfigOption("OGR_GENSQL_SORT_MAX_MEMORY", "20000");
+            CPLSetConfigOption("CPL_DEBUG", "ON");
+            CPLPushErrorHandler(GenSQLRunsErrorHandler);
+            OGRLayer* poSQLLyr = poDS->ExecuteSQL(
+                CPLSPrintf("SELECT * FROM test ORDER BY key, str DESC "
+                           "OFFSET %d", nOffset), NULL, NULL);
+            ensure( poSQLLyr != NULL );
+            for( int iPass = 0; iPass < 2; iPass++ )
+            {
+                CPLErrorReset();
+                poSQLLyr->ResetReading();
+                int nCount = 0;
+                OGRFeature* poFeature;
+                while( (poFeature = poSQLLyr->GetNextFeature()) != NULL )
+                {
+                    const int i = anExpected[nOffset + nCount];
+                    ensure_equals( poFeature->GetFID(), i );
+                    ensure_equals( poFeature->GetFieldAsInteger(0),
+                                   (i * 37) % 20 );
+                    ensure( GetGenSQLSortString(i) ==
+                            poFeature->GetFieldAsString(1) );
+                    delete poFeature;
+                    nCount++;
+                }
+                ensure_equals( nCount, nFeatures - nOffset );
+                ensure_equals( CPLGetLastErrorType(), CE_None );
+            }
+            CPLPopErrorHandler();
+            CPLSetConfigOption("CPL_DEBUG", NULL);
+            CPLSetConfigOption("OGR_GENSQL_SORT_MAX_MEMORY", NULL);
+            poDS->ReleaseResultSet(poSQLLyr);
+
+            ensure( gnGenSQLMergedRuns > 10 );
+        }
+
+        GDALClose(poDS);
+    }
+
+    // Build a polygon from a closed outline translated by (dfX, dfY), with
+    // nSteps points per edge.
+    static OGRGeometry* BuildDensifiedPolygon( const double* padfXY,
+                                               int nVertices, int nSteps,
+                                               double dfX, double dfY )
+    {
+        OGRLinearRing* poLR = new OGRLinearRing();
+        for( int i = 0; i < nVertices; i++ )
+        {
+            const double dfX1 = padfXY[2 * i];
+            const double dfY1 = padfXY[2 * i + 1];
+            const double dfX2 = padfXY[2 * ((i + 1) % nVertices)];
+            const double dfY2 = padfXY[2 * ((i + 1) % nVertices) + 1];
+            for( int k = 0; k < nSteps; k++ )
+            {
+                poLR->addPoint(dfX + dfX1 + (dfX2 - dfX1) * k / nSteps,
+                               dfY + dfY1 + (dfY2 - dfY1) * k / nSteps);
+            }
+        }
+        poLR->closeRings();
+        OGRPolygon* poPoly = new OGRPolygon();
+        poPoly->addRingDirectly(poLR);
+        return poPoly;
+    }
+
+    // Rings of one cell of test<23>
+    static void BuildTouchingRings( int iCell, double dfX, double dfY,
+                                    std::vector<OGRGeometry*>& apoRings )
+    {
+        if( (iCell % 2) == 0 )
+        {
+            // L-shape, and a triangle touching it whose first point is on
+            // the extension of one of its edges.
+            const double adfL[] = { 0, 0, 10, 0, 10, 5, 5, 5, 5, 10, 0, 10 };
+            const double adfTri[] = { 10, 6, 1, 0, 10, 7 };
+            apoRings.push_back(BuildDensifiedPolygon(adfL, 6, 12, dfX, dfY));
+            apoRings.push_back(BuildDensifiedPolygon(adfTri, 3, 1, dfX, dfY));
+        }
+        else
+        {
+            // Square, a hole sharing part of its edge and an island sharing
+            // part of the edge of the hole.
+            const double adfOuter[] = { 0, 0, 10, 0, 10, 10, 0, 10 };
+            const double adfHole[] = { 0, 2, 4, 2, 4, 6, 0, 6 };
+            const double adfIsland[] = { 1, 2, 3, 2, 3, 4, 1, 4 };
+            apoRings.push_back(
+                BuildDensifiedPolygon(adfOuter, 4, 20, dfX, dfY));
+            apoRings.push_back(
+                BuildDensifiedPolygon(adfHole, 4, 1, dfX, dfY));
+            apoRings.push_back(
+                BuildDensifiedPolygon(adfIsland, 4, 1, dfX, dfY));
+        }
+    }
+
+    static void CollectPolygonsAsWkt( OGRGeometry* poGeom,
+                                      std::vector<std::string>& aosWkt )
+    {
+        if( wkbFlatten(poGeom->getGeometryType()) == wkbMultiPolygon )
+        {
+            OGRMultiPolygon* poMP = static_cast<OGRMultiPolygon*>(poGeom);
+            for( int i = 0; i < poMP->getNumGeometries(); i++ )
+                CollectPolygonsAsWkt(poMP->getGeometryRef(i), aosWkt);
+            return;
+        }
+        char* pszWkt = NULL;
+        poGeom->exportToWkt(&pszWkt);
+        aosWkt.push_back(pszWkt);
+        CPLFree(pszWkt);
+    }
+
+    // Test that organizePolygons() gives the same result with more than 32
+    // rings, where envelopes and edges are indexed, than ring by ring
+    // groups, including for touching rings
+    template<>
+    template<>
+    void object::test<23>()
+    {
+        const int nSide = 6;
+        std::vector<OGRGeometry*> apoAllRings;
+        std::vector<std::string> aosExpected;
+        for( int iCell = 0; iCell < nSide * nSide; iCell++ )
+        {
+            const double dfX = (iCell % nSide) * 20.0;
+            const double dfY = (iCell / nSide) * 20.0;
+            BuildTouchingRings(iCell, dfX, dfY, apoAllRings);
+
+            std::vector<OGRGeometry*> apoRings;
+            BuildTouchingRings(iCell, dfX, dfY, apoRings);
+            OGRGeometry* poGeom = OGRGeometryFactory::organizePolygons(
+                &apoRings[0], static_cast<int>(apoRings.size()), NULL, NULL);
+            CollectPolygonsAsWkt(poGeom, aosExpected);
+            delete poGeom;
+        }
+        ensure( apoAllRings.size() > 32 );
+
+        OGRGeometry* poGeom = OGRGeometryFactory::organizePolygons(
+            &apoAllRings[0], static_cast<int>(apoAllRings.size()), NULL, NULL);
+        std::vector<std::string> aosGot;
+        CollectPolygonsAsWkt(poGeom, aosGot);
+        delete poGeom;
+
+        std::sort(aosExpected.begin(), aosExpected.end());
+        std::sort(aosGot.begin(), aosGot.end());
+        ensure_equals( aosGot.size(), aosExpected.size() );
+        for( size_t i = 0; i < aosGot.size(); i++ )
+            ensure( aosGot[i] == aosExpected[i] );
+    }
+
+    static int gnGeoJSONFailures = 0;
+
+    static void CPL_STDCALL GeoJSONCountingErrorHandler( CPLErr eErr,
+                                                         CPLErrorNum,
+                                                         const char* )
+    {
+        if( eErr == CE_Failure )
+            gnGeoJSONFailures++;
+    }
+
+    // Test that streamed GeoJSON files get the same FIDs, in the same
+    // order, as files loaded in memory, with missing, duplicated and
+    // decreasing ids, and that geometry errors are reported once
+    template<>
+    template<>
+    void object::test<24>()
+    {
+        const char* pszFilename = "/vsimem/test_ogr_streaming_fid.geojson";
+        VSILFILE* fp = VSIFOpenL(pszFilename, "wb");
+        ensure( fp != NULL );
+        VSIFPrintfL(fp, "{ \"type\": \"FeatureCollection\", \"features\": [\n");
+        const int nFeatures = 200;
+        for( int i = 0; i < nFeatures; i++ )
+        {
+            CPLString osId;
+            if( i % 10 == 7 )
+                osId = "\"id\": 5, ";
+            else if( i % 10 != 3 )
+                osId.Printf("\"id\": %d, ", 10000 - 7 * i);
+            VSIFPrintfL(fp, "%s{ \"type\": \"Feature\", %s"
+                        "\"properties\": { \"name\": \"f%d\" }, "
+                        "\"geometry\": { \"type\": \"Point\", "
+                        "\"coordinates\": [ %s, %d ] } }\n",
+                        i == 0 ? "" : ",", osId.c_str(), i,
+                        i == 50 ? "\"a\"" : CPLSPrintf("%d", i), i);
+        }
+        VSIFPrintfL(fp, "] }\n");
+        VSIFCloseL(fp);
+
+        std::vector<std::pair<GIntBig, std::string> > aoFeatures[2];
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            gnGeoJSONFailures = 0;
+            CPLPushErrorHandler(GeoJSONCountingErrorHandler);
+            CPLSetConfigOption("OGR_GEOJSON_STREAMING_THRESHOLD",
+                               iPass == 0 ? "0" : NULL);
+            GDALDataset* poDS = reinterpret_cast<GDALDataset*>(
+                GDALOpenEx(pszFilename, GDAL_OF_VECTOR, NULL, NULL, NULL));
+            CPLSetConfigOption("OGR_GEOJSON_STREAMING_THRESHOLD", NULL);
+            ensure( poDS != NULL );
+            OGRLayer* poLayer = poDS->GetLayer(0);
+            for( int iRead = 0; iRead < 2; iRead++ )
+            {
+                std::vector<std::pair<GIntBig, std::string> > aoRead;
+                poLayer->ResetReading();
+                OGRFeature* poFeature = NULL;
+                while( (poFeature = poLayer->GetNextFeature()) != NULL )
+                {
+                    aoRead.push_back(std::pair<GIntBig, std::string>(
+                        poFeature->GetFID(), poFeature->GetFieldAsString(0)));
+                    delete poFeature;
+                }
+                ensure_equals( aoRead.size(),
+                               static_cast<size_t>(nFeatures) );
+                if( iRead == 0 )
+                    aoFeatures[iPass] = aoRead;
+                else
+                    ensure( aoRead == aoFeatures[iPass] );
+            }
+            CPLPopErrorHandler();
+            ensure_equals( gnGeoJSONFailures, 1 );
+
+            for( int i = 0; i < nFeatures; i++ )
+            {
+                const GIntBig nFID = aoFeatures[iPass][i].first;
+                if( i > 0 )
+                    ensure( nFID > aoFeatures[iPass][i - 1].first );
+                OGRFeature* poFeature = poLayer->GetFeature(nFID);
+                ensure( poFeature != NULL );
+                ensure_equals( poFeature->GetFID(), nFID );
+                ensure_equals( std::string(poFeature->GetFieldAsString(0)),
+                               aoFeatures[iPass][i].second );
+                delete poFeature;
+            }
+            ensure( poLayer->GetFeature(4) == NULL );
+
+            if( iPass == 0 )
+            {
+                ensure_equals( poLayer->SetNextByIndex(10), OGRERR_NONE );
+                OGRFeature* poFeature = poLayer->GetNextFeature();
+                ensure( poFeature != NULL );
+                ensure_equals( poFeature->GetFID(),
+                               aoFeatures[iPass][10].first );
+                delete poFeature;
+            }
+
+            GDALClose(poDS);
+        }
+        ensure( aoFeatures[0] == aoFeatures[1] );
+        VSIUnlink(pszFilename);
+    }
+
+    // Compare the iRef-th feature of oRef with the i-th feature of oBatch
+    static void CompareBatchFeatures( OGRFeatureBatch& oRef, int iRef,
+                                      OGRFeatureBatch& oBatch, int i )
+    {
+        ensure_equals( oBatch.GetFIDs()[i], oRef.GetFIDs()[iRef] );
+        OGRFeatureDefn* poDefn = oRef.GetDefnRef();
+        for( int iField = 0; iField < poDefn->GetFieldCount(); iField++ )
+        {
+            ensure_equals( oBatch.IsFieldValid(iField, i),
+                           oRef.IsFieldValid(iField, iRef) );
+            if( !oRef.IsFieldValid(iField, iRef) )
+                continue;
+            const GByte* pabyRef =
+                static_cast<const GByte*>(oRef.GetFieldData(iField));
+            const GByte* pabyBatch =
+                static_cast<const GByte*>(oBatch.GetFieldData(iField));
+            const OGRFieldType eType = poDefn->GetFieldDefn(iField)->GetType();
+            if( eType == OFTInteger )
+            {
+                ensure_equals(
+                    reinterpret_cast<const int*>(pabyBatch)[i],
+                    reinterpret_cast<const int*>(pabyRef)[iRef] );
+            }
+            else if( eType == OFTInteger64 )
+            {
+                ensure_equals(
+                    reinterpret_cast<const GIntBig*>(pabyBatch)[i],
+                    reinterpret_cast<const GIntBig*>(pabyRef)[iRef] );
+            }
+            else if( eType == OFTReal )
+            {
+                ensure_equals(
+                    reinterpret_cast<const double*>(pabyBatch)[i],
+                    reinterpret_cast<const double*>(pabyRef)[iRef] );
+            }
+            else if( eType == OFTDate || eType == OFTTime ||
+                     eType == OFTDateTime )
+            {
+                const OGRField* psRef =
+                    reinterpret_cast<const OGRField*>(pabyRef) + iRef;
+                const OGRField* psBatch =
+                    reinterpret_cast<const OGRField*>(pabyBatch) + i;
+                ensure_equals( psBatch->Date.Year, psRef->Date.Year );
+                ensure_equals( psBatch->Date.Month, psRef->Date.Month );
+                ensure_equals( psBatch->Date.Day, psRef->Date.Day );
+                ensure_equals( psBatch->Date.Hour, psRef->Date.Hour );
+                ensure_equals( psBatch->Date.Minute, psRef->Date.Minute );
+                ensure_equals( psBatch->Date.Second, psRef->Date.Second );
+                ensure_equals( psBatch->Date.TZFlag, psRef->Date.TZFlag );
+            }
+            else
+            {
+                const GIntBig* panRefOffsets = oRef.GetFieldOffsets(iField);
+                const GIntBig* panOffsets = oBatch.GetFieldOffsets(iField);
+                const GIntBig nSize = panRefOffsets[iRef + 1] -
+                                      panRefOffsets[iRef];
+                ensure_equals( panOffsets[i + 1] - panOffsets[i], nSize );
+                ensure( memcmp(pabyBatch + panOffsets[i],
+                               pabyRef + panRefOffsets[iRef],
+                               static_cast<size_t>(nSize)) == 0 );
+            }
+        }
+        for( int iGeomField = 0; iGeomField < poDefn->GetGeomFieldCount();
+             iGeomField++ )
+        {
+            ensure_equals( oBatch.IsGeomFieldValid(iGeomField, i),
+                           oRef.IsGeomFieldValid(iGeomField, iRef) );
+            if( !oRef.IsGeomFieldValid(iGeomField, iRef) )
+                continue;
+            const GIntBig* panRefOffsets = oRef.GetGeomFieldOffsets(iGeomField);
+            const GIntBig* panOffsets = oBatch.GetGeomFieldOffsets(iGeomField);
+            const GIntBig nSize = panRefOffsets[iRef + 1] - panRefOffsets[iRef];
+            ensure_equals( panOffsets[i + 1] - panOffsets[i], nSize );
+            ensure( memcmp(oBatch.GetGeomFieldData(iGeomField) + panOffsets[i],
+                           oRef.GetGeomFieldData(iGeomField) +
+                                                    panRefOffsets[iRef],
+                           static_cast<size_t>(nSize)) == 0 );
+        }
+    }
+
+    // Check that GetNextFeatureBatch() returns the same features as
+    // GetNextFeature() with the current filters of the layer, including
+    // after ResetReading()
+    static void CheckFeatureBatches( OGRLayer* poLayer, int nMinFeatures )
+    {
+        OGRFeatureBatch oRef;
+        oRef.Reset(poLayer->GetLayerDefn());
+        poLayer->ResetReading();
+        OGRFeature* poFeature = NULL;
+        while( (poFeature = poLayer->GetNextFeature()) != NULL )
+        {
+            oRef.AddFeatureFrom(poFeature);
+            delete poFeature;
+        }
+        ensure( oRef.GetFeatureCount() >= nMinFeatures );
+
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            OGRFeatureBatch oBatch;
+            poLayer->ResetReading();
+            if( iPass == 1 )
+            {
+                // Interrupted batch read, and then a mix of both methods.
+                poLayer->GetNextFeatureBatch(&oBatch, 2);
+                poLayer->ResetReading();
+                poFeature = poLayer->GetNextFeature();
+                if( poFeature != NULL )
+                {
+                    ensure_equals( poFeature->GetFID(), oRef.GetFIDs()[0] );
+                    delete poFeature;
+                }
+            }
+            int nRead = iPass == 1 && oRef.GetFeatureCount() > 0 ? 1 : 0;
+            int nBatchCount = 0;
+            while( (nBatchCount =
+                        poLayer->GetNextFeatureBatch(&oBatch, 3)) > 0 )
+            {
+                ensure_equals( oBatch.GetFeatureCount(), nBatchCount );
+                ensure( nRead + nBatchCount <= oRef.GetFeatureCount() );
+                for( int i = 0; i < nBatchCount; i++ )
+                    CompareBatchFeatures(oRef, nRead + i, oBatch, i);
+                nRead += nBatchCount;
+            }
+            ensure_equals( nRead, oRef.GetFeatureCount() );
+        }
+    }
+
+    // Check GetNextFeatureBatch() without filter, and with an attribute
+    // and spatial filter
+    static void CheckFeatureBatchesWithFilters( OGRLayer* poLayer,
+                                                const char* pszAttrFilter )
+    {
+        CheckFeatureBatches(poLayer, 1);
+
+        ensure_equals( poLayer->SetAttributeFilter(pszAttrFilter),
+                       OGRERR_NONE );
+        CheckFeatureBatches(poLayer, 1);
+        poLayer->SetAttributeFilter(NULL);
+
+        OGREnvelope sEnvelope;
+        if( poLayer->GetGeomType() != wkbNone &&
+            poLayer->GetExtent(&sEnvelope) == OGRERR_NONE )
+        {
+            const double dfWidth = sEnvelope.MaxX - sEnvelope.MinX;
+            const double dfHeight = sEnvelope.MaxY - sEnvelope.MinY;
+            poLayer->SetSpatialFilterRect(sEnvelope.MinX + dfWidth / 4,
+                                          sEnvelope.MinY + dfHeight / 4,
+                                          sEnvelope.MaxX - dfWidth / 4,
+                                          sEnvelope.MaxY - dfHeight / 4);
+            CheckFeatureBatches(poLayer, 0);
+
+            ensure_equals( poLayer->SetAttributeFilter(pszAttrFilter),
+                           OGRERR_NONE );
+            CheckFeatureBatches(poLayer, 0);
+            poLayer->SetAttributeFilter(NULL);
+            poLayer->SetSpatialFilter(NULL);
+        }
+    }
+
+    // Test the native GetNextFeatureBatch() implementations of the
+    // Shapefile, GeoPackage, CSV and OpenFileGDB drivers, and the ones of
+    // layers deriving from the memory layer, against GetNextFeature()
+    template<>
+    template<>
+    void object::test<25>()
+    {
+        // Shapefile
+        GDALDataset* poSrcDS = reinterpret_cast<GDALDataset*>(
+            GDALOpenEx("../ogr/data/poly.shp", GDAL_OF_VECTOR, NULL, NULL,
+                       NULL));
+        ensure( poSrcDS != NULL );
+        OGRLayer* poSrcLayer = poSrcDS->GetLayer(0);
+        CheckFeatureBatchesWithFilters(poSrcLayer, "EAS_ID < 170");
+
+        // GeoPackage
+        GDALDriver* poGPKGDriver = reinterpret_cast<GDALDriver*>(
+            GDALGetDriverByName("GPKG"));
+        if( poGPKGDriver != NULL )
+        {
+            CPLString osFilename(CPLFormFilename(
+                tut::common::tmp_basedir.c_str(), "test_ogr_25", "gpkg"));
+            VSIUnlink(osFilename);
+            GDALDataset* poDS = poGPKGDriver->Create(osFilename, 0, 0, 0,
+                                                     GDT_Unknown, NULL);
+            ensure( poDS != NULL );
+            ensure( poDS->CopyLayer(poSrcLayer, "poly") != NULL );
+            GDALClose(poDS);
+            poDS = reinterpret_cast<GDALDataset*>(
+                GDALOpenEx(osFilename, GDAL_OF_VECTOR, NULL, NULL, NULL));
+            ensure( poDS != NULL );
+            CheckFeatureBatchesWithFilters(poDS->GetLayer(0),
+                                           "EAS_ID < 170");
+            GDALClose(poDS);
+            VSIUnlink(osFilename);
+        }
+        GDALClose(poSrcDS);
+
+        // CSV, attribute only
+        const char* pszCSVFilename = "/vsimem/test_ogr_25.csv";
+        VSILFILE* fp = VSIFOpenL(pszCSVFilename, "wb");
+        ensure( fp != NULL );
+        VSIFPrintfL(fp, "int,int64,real,str,date,datetime\n");
+        for( int i = 0; i < 20; i++ )
+        {
+            if( i % 5 == 2 )
+            {
+                VSIFPrintfL(fp, ",,,,,\n");
+                continue;
+            }
+            VSIFPrintfL(fp, "%d," CPL_FRMT_GIB ",%.3f,\"s,%d\",2017/%02d/%02d,"
+                        "2017/01/02 03:04:%02d.5\n",
+                        i, static_cast<GIntBig>(i) << 40, i * 1.25, i,
+                        1 + i % 12, 1 + i, i);
+        }
+        VSIFCloseL(fp);
+        fp = VSIFOpenL("/vsimem/test_ogr_25.csvt", "wb");
+        ensure( fp != NULL );
+        VSIFPrintfL(fp, "Integer,Integer64,Real,String,Date,DateTime\n");
+        VSIFCloseL(fp);
+        GDALDataset* poDS = reinterpret_cast<GDALDataset*>(
+            GDALOpenEx(pszCSVFilename, GDAL_OF_VECTOR, NULL, NULL, NULL));
+        ensure( poDS != NULL );
+        CheckFeatureBatchesWithFilters(poDS->GetLayer(0), "int >= 10");
+        GDALClose(poDS);
+        VSIUnlink(pszCSVFilename);
+        VSIUnlink("/vsimem/test_ogr_25.csvt");
+
+        // OpenFileGDB
+        if( GDALGetDriverByName("OpenFileGDB") != NULL )
+        {
+            poDS = reinterpret_cast<GDALDataset*>(GDALOpenEx(
+                "/vsizip/../ogr/data/testopenfilegdb.gdb.zip/"
+                "testopenfilegdb.gdb", GDAL_OF_VECTOR, NULL, NULL, NULL));
+            ensure( poDS != NULL );
+            for( int i = 0; i < poDS->GetLayerCount(); i++ )
+            {
+                OGRLayer* poLayer = poDS->GetLayer(i);
+                if( poLayer->GetFeatureCount() > 1 )
+                    CheckFeatureBatchesWithFilters(poLayer, "FID > 1");
+            }
+            GDALClose(poDS);
+        }
+
+        // ODS and XLSX layers shift the FIDs of the memory layer, and ODS
+        // ones have their own attribute filter
+        const char* const apszSpreadsheets[] = { "../ogr/data/test.ods",
+                                                 "../ogr/data/test.xlsx" };
+        for( size_t i = 0; i < CPL_ARRAYSIZE(apszSpreadsheets); i++ )
+        {
+            poDS = reinterpret_cast<GDALDataset*>(GDALOpenEx(
+                apszSpreadsheets[i], GDAL_OF_VECTOR, NULL, NULL, NULL));
+            if( poDS == NULL )
+                continue;
+            OGRLayer* poLayer = poDS->GetLayerByName("Feuille1");
+            ensure( poLayer != NULL );
+            CheckFeatureBatchesWithFilters(poLayer, "Field2 = 4");
+
+            OGRFeatureBatch oBatch;
+            poLayer->SetAttributeFilter("Field2 = 4");
+            ensure_equals( poLayer->GetNextFeatureBatch(&oBatch, 10), 1 );
+            ensure_equals( oBatch.GetFIDs()[0], 2 );
+            GDALClose(poDS);
+        }
+
+        // GeoJSON in streaming mode does not fill its memory layer, and
+        // returns its features in FID order
+        const char* pszGeoJSONFilename = "/vsimem/test_ogr_25.geojson";
+        fp = VSIFOpenL(pszGeoJSONFilename, "wb");
+        ensure( fp != NULL );
+        VSIFPrintfL(fp, "{\"type\":\"FeatureCollection\",\"features\":[");
+        for( int i = 0; i < 50; i++ )
+        {
+            VSIFPrintfL(fp, "%s{\"type\":\"Feature\",\"id\":%d,"
+                        "\"properties\":{\"val\":%d},\"geometry\":"
+                        "{\"type\":\"Point\",\"coordinates\":[%d,%d]}}",
+                        i == 0 ? "" : ",", 100 + (i * 7) % 50, i, i, -i);
+        }
+        VSIFPrintfL(fp, "]}");
+        VSIFCloseL(fp);
+        CPLSetConfigOption("OGR_GEOJSON_STREAMING_THRESHOLD", "0");
+        poDS = reinterpret_cast<GDALDataset*>(GDALOpenEx(
+            pszGeoJSONFilename, GDAL_OF_VECTOR, NULL, NULL, NULL));
+        CPLSetConfigOption("OGR_GEOJSON_STREAMING_THRESHOLD", NULL);
+        ensure( poDS != NULL );
+        OGRLayer* poLayer = poDS->GetLayer(0);
+        CheckFeatureBatchesWithFilters(poLayer, "val >= 25");
+
+        OGRFeatureBatch oBatch;
+        poLayer->SetAttributeFilter(NULL);
+        poLayer->ResetReading();
+        ensure_equals( poLayer->GetNextFeatureBatch(&oBatch, 100), 50 );
+        for( int i = 0; i < 50; i++ )
+            ensure_equals( oBatch.GetFIDs()[i], 100 + i );
+        GDALClose(poDS);
+        VSIUnlink(pszGeoJSONFilename);
+    }
+
+    // Test that ogr2ogr -a_srs does not pass the source WKB, and its SRS,
+    // through to GeoPackage and memory layers
+    template<>
+    template<>
+    void object::test<26>()
+    {
+        GDALDriver* poGPKGDriver = reinterpret_cast<GDALDriver*>(
+            GDALGetDriverByName("GPKG"));
+        if( poGPKGDriver == NULL ||
+            GDALGetDriverByName("Memory") == NULL )
+            return;
+
+        CPLString osSrcFilename(CPLFormFilename(
+            tut::common::tmp_basedir.c_str(), "test_ogr_26_src", "gpkg"));
+        CPLString osDstFilename(CPLFormFilename(
+            tut::common::tmp_basedir.c_str(), "test_ogr_26_dst", "gpkg"));
+        VSIUnlink(osSrcFilename);
+        VSIUnlink(osDstFilename);
+
+        // poly.shp is in EPSG:27700
+        GDALDataset* poShpDS = reinterpret_cast<GDALDataset*>(
+            GDALOpenEx("../ogr/data/poly.shp", GDAL_OF_VECTOR, NULL, NULL,
+                       NULL));
+        ensure( poShpDS != NULL );
+        GDALDataset* poSrcDS = poGPKGDriver->Create(osSrcFilename, 0, 0, 0,
+                                                    GDT_Unknown, NULL);
+        ensure( poSrcDS != NULL );
+        ensure( poSrcDS->CopyLayer(poShpDS->GetLayer(0), "poly") != NULL );
+        GDALClose(poSrcDS);
+        GDALClose(poShpDS);
+
+        OGRSpatialReference oSRS(SRS_WKT_WGS84);
+        const char* const apszFormats[] = { "GPKG", "Memory" };
+        for( size_t i = 0; i < CPL_ARRAYSIZE(apszFormats); i++ )
+        {
+            poSrcDS = reinterpret_cast<GDALDataset*>(
+                GDALOpenEx(osSrcFilename, GDAL_OF_VECTOR, NULL, NULL, NULL));
+            ensure( poSrcDS != NULL );
+            const char* apszArgs[] = { "-f", apszFormats[i],
+                                       "-a_srs", SRS_WKT_WGS84, NULL };
+            GDALVectorTranslateOptions* psOptions =
+                GDALVectorTranslateOptionsNew(
+                    const_cast<char**>(apszArgs), NULL);
+            ensure( psOptions != NULL );
+            GDALDatasetH hSrcDS = static_cast<GDALDatasetH>(poSrcDS);
+            GDALDataset* poDstDS = reinterpret_cast<GDALDataset*>(
+                GDALVectorTranslate(i == 0 ? osDstFilename.c_str() : "",
+                                    NULL, 1, &hSrcDS, psOptions, NULL));
+            GDALVectorTranslateOptionsFree(psOptions);
+            GDALClose(poSrcDS);
+            ensure( poDstDS != NULL );
+
+            if( i == 0 )
+            {
+                GDALClose(poDstDS);
+                poDstDS = reinterpret_cast<GDALDataset*>(
+                    GDALOpenEx(osDstFilename, GDAL_OF_VECTOR, NULL, NULL,
+                               NULL));
+                ensure( poDstDS != NULL );
+                OGRLayer* poSQLLyr = poDstDS->ExecuteSQL(
+                    "SELECT COUNT(*) FROM poly WHERE ST_SRID(geom) <> "
+                    "(SELECT srs_id FROM gpkg_geometry_columns "
+                    "WHERE table_name = 'poly')", NULL, NULL);
+                ensure( poSQLLyr != NULL );
+                OGRFeature* poFeature = poSQLLyr->GetNextFeature();
+                ensure( poFeature != NULL );
+                ensure_equals( poFeature->GetFieldAsInteger(0), 0 );
+                delete poFeature;
+                poDstDS->ReleaseResultSet(poSQLLyr);
+            }
+
+            OGRLayer* poLayer = poDstDS->GetLayer(0);
+            ensure( poLayer->GetSpatialRef() != NULL );
+            ensure( poLayer->GetSpatialRef()->IsSame(&oSRS) );
+            ensure_equals( poLayer->GetFeatureCount(), 10 );
+            OGRFeature* poFeature;
+            while( (poFeature = poLayer->GetNextFeature()) != NULL )
+            {
+                OGRGeometry* poGeom = poFeature->GetGeometryRef();
+                ensure( poGeom != NULL );
+                ensure( poGeom->getSpatialReference() != NULL );
+                ensure( poGeom->getSpatialReference()->IsSame(&oSRS) );
+                delete poFeature;
+            }
+            GDALClose(poDstDS);
+        }
+
+        VSIUnlink(osSrcFilename);
+        VSIUnlink(osDstFilename);
+    }
+
 } // namespace tut
@@ -0,0 +1,157 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  CPL - Common Portability Library
+ * Purpose:  Benchmark /vsimem/ create/write/read/unlink under multi-threading
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_multiproc.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "gdal.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+static int nLoops = 10000;
+static int nFileSize = 16384;
+static volatile int bError = FALSE;
+
+static void ThreadFunc(void* pData)
+{
+    const int nThread = *static_cast<int*>(pData);
+    std::vector<GByte> abyIn(nFileSize, static_cast<GByte>(nThread));
+    std::vector<GByte> abyOut(nFileSize);
+
+    for( int i = 0; i < nLoops; i++ )
+    {
+        CPLString osFilename;
+        osFilename.Printf("/vsimem/testperfvsimem/%d_%d.bin", nThread, i);
+
+        VSILFILE* fp = VSIFOpenL(osFilename, "wb");
+        if( fp == NULL ||
+            VSIFWriteL(&abyIn[0], 1, abyIn.size(), fp) != abyIn.size() )
+        {
+            bError = TRUE;
+        }
+        if( fp )
+            VSIFCloseL(fp);
+
+        VSIStatBufL sStat;
+        if( VSIStatL(osFilename, &sStat) != 0 ||
+            sStat.st_size != static_cast<vsi_l_offset>(nFileSize) )
+        {
+            bError = TRUE;
+        }
+
+        fp = VSIFOpenL(osFilename, "rb");
+        if( fp == NULL ||
+            VSIFReadL(&abyOut[0], 1, abyOut.size(), fp) != abyOut.size() ||
+            memcmp(&abyIn[0], &abyOut[0], abyIn.size()) != 0 )
+        {
+            bError = TRUE;
+        }
+        if( fp )
+            VSIFCloseL(fp);
+
+        if( VSIUnlink(osFilename) != 0 )
+            bError = TRUE;
+    }
+}
+
+static void Usage()
+{
+    printf("Usage: testperfvsimem [-threads X] [-loops X] [-size X]\n");
+    exit(1);
+}
+
+int main(int argc, char* argv[])
+{
+    int nThreads = CPLGetNumCPUs();
+
+    argc = GDALGeneralCmdLineProcessor( argc, &argv, 0 );
+    for( int i = 1; i < argc; i++ )
+    {
+        if( EQUAL(argv[i], "-threads") && i + 1 < argc )
+        {
+            i++;
+            nThreads = atoi(argv[i]);
+        }
+        else if( EQUAL(argv[i], "-loops") && i + 1 < argc )
+        {
+            i++;
+            nLoops = atoi(argv[i]);
+        }
+        else if( EQUAL(argv[i], "-size") && i + 1 < argc )
+        {
+            i++;
+            nFileSize = atoi(argv[i]);
+        }
+        else
+        {
+            Usage();
+        }
+    }
+    if( nThreads <= 0 || nLoops <= 0 || nFileSize <= 0 )
+        Usage();
+
+    VSIMkdir("/vsimem/testperfvsimem", 0755);
+
+    std::vector<int> anThreadIds(nThreads);
+    std::vector<CPLJoinableThread*> apsThreads(nThreads);
+    const clock_t start = clock();
+    const time_t nStartTime = time(NULL);
+    for( int i = 0; i < nThreads; i++ )
+    {
+        anThreadIds[i] = i;
+        apsThreads[i] = CPLCreateJoinableThread(ThreadFunc, &anThreadIds[i]);
+    }
+    for( int i = 0; i < nThreads; i++ )
+        CPLJoinThread(apsThreads[i]);
+    const clock_t end = clock();
+
+    printf("%d threads x %d loops of %d bytes: %.2f s CPU, %d s elapsed\n",
+           nThreads, nLoops, nFileSize,
+           (end - start) * 1.0 / CLOCKS_PER_SEC,
+           static_cast<int>(time(NULL) - nStartTime));
+
+    char** papszList = VSIReadDir("/vsimem/testperfvsimem");
+    if( CSLCount(papszList) != 0 )
+        bError = TRUE;
+    CSLDestroy(papszList);
+    VSIRmdir("/vsimem/testperfvsimem");
+
+    CSLDestroy(argv);
+
+    if( bError )
+    {
+        fprintf(stderr, "Errors occurred!\n");
+        return 1;
+    }
+    return 0;
+}
@@ -549,6 +549,66 @@ def ogr_join_23():
 
     return 'success'
 
+###############################################################################
+# Test that the join lookup table gives the same results as attribute filtering
+
+def ogr_join_24():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('first')
+    lyr.CreateField(ogr.FieldDefn('s', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('i', ogr.OFTInteger))
+    for (s, i) in [ ('a', 1), ('B', 2), (None, 3), ('c', None), ('d', 4) ]:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if s is not None:
+            f['s'] = s
+        if i is not None:
+            f['i'] = i
+        lyr.CreateFeature(f)
+
+    lyr = ds.CreateLayer('second')
+    lyr.CreateField(ogr.FieldDefn('s', ogr.OFTString))
+    lyr.CreateField(ogr.FieldDefn('r', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('val', ogr.OFTString))
+    for (s, r, val) in [ ('A', 1.0, 'x'), ('b', 2.5, 'y'), ('a', 1.0, 'z'),
+                         (None, None, 'w'), ('c', 4.0, 'v') ]:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        if s is not None:
+            f['s'] = s
+        if r is not None:
+            f['r'] = r
+        f['val'] = val
+        lyr.CreateFeature(f)
+
+    sqls = [ 'SELECT second.val FROM first LEFT JOIN second ON first.s = second.s',
+             'SELECT second.val FROM first LEFT JOIN second ON second.r = first.i' ]
+    for sql in sqls:
+        results = []
+        for (hash_join, max_mem) in [ ('NO', None), ('YES', None),
+                                      ('YES', '300'), ('YES', '1') ]:
+            gdal.SetConfigOption('OGR_GENSQL_HASH_JOIN', hash_join)
+            gdal.SetConfigOption('OGR_GENSQL_JOIN_MAX_MEMORY', max_mem)
+            sql_lyr = ds.ExecuteSQL(sql)
+            results.append([ f['val'] for f in sql_lyr ])
+            ds.ReleaseResultSet(sql_lyr)
+            gdal.SetConfigOption('OGR_GENSQL_HASH_JOIN', None)
+            gdal.SetConfigOption('OGR_GENSQL_JOIN_MAX_MEMORY', None)
+        for res in results[1:]:
+            if res != results[0]:
+                gdaltest.post_reason('fail')
+                print(sql)
+                print(results)
+                return 'fail'
+
+    if results[0] != [ 'x', None, None, None, 'v' ]:
+        gdaltest.post_reason('fail')
+        print(results)
+        return 'fail'
+
+    ds = None
+
+    return 'success'
+
 ###############################################################################
 
 def ogr_join_cleanup():
@@ -581,6 +641,7 @@ gdaltest_list = [
     ogr_join_21,
     ogr_join_22,
     ogr_join_23,
+    ogr_join_24,
     ogr_join_cleanup ]
 
 if __name__ == '__main__':
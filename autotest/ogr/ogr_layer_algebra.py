@@ -677,6 +677,66 @@ def algebra_erase():
 
     return 'success'
 
+###############################################################################
+# Check that USE_SPATIAL_INDEX=YES and NUM_THREADS give the same results as
+# the default mode, in the same order.
+
+def algebra_spatial_index():
+    if not ogrtest.have_geos():
+        return 'skip'
+
+    mem_ds = ogr.GetDriverByName('Memory').CreateDataSource( 'wrk_idx' )
+
+    lyr_input = mem_ds.CreateLayer( 'input' )
+    lyr_input.CreateField( ogr.FieldDefn("in_id", ogr.OFTInteger) )
+    lyr_method = mem_ds.CreateLayer( 'method' )
+    lyr_method.CreateField( ogr.FieldDefn("method_id", ogr.OFTInteger) )
+
+    for i in range(200):
+        x = (i % 20) * 1.5
+        y = int(i / 20) * 1.5
+        feat = ogr.Feature( lyr_input.GetLayerDefn() )
+        feat.SetField('in_id', i)
+        feat.SetGeometryDirectly( ogr.CreateGeometryFromWkt(
+            'POLYGON((%f %f,%f %f,%f %f,%f %f,%f %f))' %
+            (x, y, x, y+2, x+2, y+2, x+2, y, x, y)) )
+        lyr_input.CreateFeature( feat )
+
+        feat = ogr.Feature( lyr_method.GetLayerDefn() )
+        feat.SetField('method_id', i)
+        if i != 17:
+            feat.SetGeometryDirectly( ogr.CreateGeometryFromWkt(
+                'POINT(%f %f)' % (y + 0.7, x + 0.3) ).Buffer(1.1, 2) )
+        lyr_method.CreateFeature( feat )
+
+    lyr_method.SetSpatialFilterRect(3, 3, 25, 12)
+
+    for method in [ 'Intersection', 'Union', 'SymDifference', 'Identity',
+                    'Update', 'Clip', 'Erase' ]:
+        ref_lyr = None
+        for options in [ [], ['USE_SPATIAL_INDEX=YES'],
+                         ['USE_SPATIAL_INDEX=YES', 'NUM_THREADS=4'] ]:
+            res_lyr = mem_ds.CreateLayer( 'result_%d' % mem_ds.GetLayerCount() )
+            err = getattr(lyr_input, method)( lyr_method, res_lyr, options = options )
+            if err != 0:
+                gdaltest.post_reason( 'got non-zero result code %d from Layer.%s with %s' % (err, method, str(options)) )
+                return 'fail'
+            if lyr_method.GetSpatialFilter() is None:
+                gdaltest.post_reason( 'spatial filter of method layer not restored' )
+                return 'fail'
+            if ref_lyr is None:
+                ref_lyr = res_lyr
+                if ref_lyr.GetFeatureCount() == 0:
+                    gdaltest.post_reason( 'Layer.%s returned no feature' % method )
+                    return 'fail'
+            elif not is_same(ref_lyr, res_lyr):
+                gdaltest.post_reason( 'Layer.%s with %s differs from default mode' % (method, str(options)) )
+                return 'fail'
+
+    mem_ds = None
+
+    return 'success'
+
 def algebra_cleanup():
     if not ogrtest.have_geos():
         return 'skip'
@@ -705,6 +765,7 @@ gdaltest_list = [
     algebra_update,
     algebra_clip,
     algebra_erase,
+    algebra_spatial_index,
     algebra_cleanup,
     ]
 
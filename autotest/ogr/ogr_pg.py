@@ -5448,6 +5448,180 @@ def ogr_pg_86():
 
     return 'success'
 
+###############################################################################
+# Test that every column type with a binary COPY encoder or a binary cursor
+# decoder round-trips identically to the text paths
+
+ogr_pg_87_columns = [
+    ( 'c_bool', 'boolean', [ 1, 0 ] ),
+    ( 'c_int2', 'smallint', [ 32767, -32768 ] ),
+    ( 'c_int4', 'integer', [ 2147483647, -2147483648 ] ),
+    ( 'c_int8', 'bigint', [ 1234567890123, -1234567890123 ] ),
+    ( 'c_float4', 'real', [ 1.5, -0.25 ] ),
+    ( 'c_float8', 'double precision', [ 1.25e100, -3.5e-10 ] ),
+    ( 'c_numeric', 'numeric(12,3)', [ 12345.678, -0.001 ] ),
+    ( 'c_char', '"char"', [ 'a', 'Z' ] ),
+    ( 'c_name', 'name', [ 'foo', 'bar' ] ),
+    ( 'c_bpchar', 'char(4)', [ 'ab', 'abcd' ] ),
+    ( 'c_varchar', 'varchar(10)', [ 'x y z', '' ] ),
+    ( 'c_text', 'text', [ 'back\\slash', 'tab\there' ] ),
+    ( 'c_bool_array', 'boolean[]', [ [ 1, 0 ], [ 1 ] ] ),
+    ( 'c_int2_array', 'smallint[]', [ [ 1, -2 ], [ 32767 ] ] ),
+    ( 'c_int4_array', 'integer[]', [ [ 1, -2, 3 ], [ -2147483648 ] ] ),
+    ( 'c_int8_array', 'bigint[]', [ [ 1234567890123, -1 ], [ 0 ] ] ),
+    ( 'c_float4_array', 'real[]', [ [ 1.5, -2.25 ], [ 0.5 ] ] ),
+    ( 'c_float8_array', 'double precision[]', [ [ 1.25, -3.5e-10 ], [ 0 ] ] ),
+    ( 'c_text_array', 'text[]', [ [ 'a', 'b c' ], [ 'd' ] ] ),
+    ( 'c_varchar_array', 'varchar(10)[]', [ [ 'a', 'b' ], [ 'x,y' ] ] ),
+    ( 'c_bpchar_array', 'char(2)[]', [ [ 'ab', 'c' ], [ 'de' ] ] ),
+    ( 'c_date', 'date', [ '2017/05/03', '1899/12/31' ] ),
+    ( 'c_time', 'time', [ '12:34:56.789', '00:00:00' ] ),
+    ( 'c_timestamp', 'timestamp', [ '2017/05/03 12:34:56.789', '1970/01/01 00:00:00.5' ] ),
+    ( 'c_timestamptz', 'timestamp with time zone', [ '2017/05/03 12:34:56+02', '1999/12/31 23:59:59.25+00' ] ),
+    ( 'c_bytea', 'bytea', [ '0001FF', '7F' ] ) ]
+
+# timestamptz has a binary COPY encoder but no binary cursor decoder
+ogr_pg_87_decodable_columns = [ name for (name, pg_type, values) in ogr_pg_87_columns if name != 'c_timestamptz' ]
+
+def ogr_pg_87_set_field(f, name, value):
+
+    idx = f.GetFieldIndex(name)
+    field_type = f.GetFieldDefnRef(idx).GetType()
+    if field_type == ogr.OFTIntegerList:
+        f.SetFieldIntegerList(idx, value)
+    elif field_type == ogr.OFTInteger64List:
+        f.SetFieldInteger64List(idx, value)
+    elif field_type == ogr.OFTRealList:
+        f.SetFieldDoubleList(idx, value)
+    elif field_type == ogr.OFTStringList:
+        f.SetFieldStringList(idx, value)
+    elif field_type == ogr.OFTInteger64:
+        f.SetFieldInteger64(idx, value)
+    elif field_type == ogr.OFTBinary:
+        f.SetFieldBinaryFromHexString(idx, value)
+    else:
+        f.SetField(idx, value)
+
+def ogr_pg_87_read(lyr):
+
+    ret = []
+    lyr.ResetReading()
+    for f in lyr:
+        values = [ f.GetField(i) for i in range(f.GetFieldCount()) ]
+        for i in range(f.GetGeomFieldCount()):
+            g = f.GetGeomFieldRef(i)
+            if g is None:
+                values.append(None)
+            else:
+                values.append(g.ExportToWkt())
+        ret.append(values)
+    return ret
+
+def ogr_pg_87_write_and_read(copy_binary, binary_cursor):
+
+    gdal.SetConfigOption('PG_USE_COPY', 'YES')
+    gdal.SetConfigOption('PG_USE_COPY_BINARY', copy_binary)
+    gdal.SetConfigOption('PG_USE_BINARY_CURSOR', binary_cursor)
+
+    ds = ogr.Open( 'PG:' + gdaltest.pg_connection_string, update = 1 )
+    ds.ExecuteSQL( 'set timezone to "UTC"' )
+    gdal.PushErrorHandler( 'CPLQuietErrorHandler' )
+    ds.ExecuteSQL( 'DELLAYER:ogr_pg_87' )
+    gdal.PopErrorHandler()
+    sql = 'CREATE TABLE ogr_pg_87 (ogc_fid SERIAL PRIMARY KEY'
+    for (name, pg_type, values) in ogr_pg_87_columns:
+        sql += ', %s %s' % (name, pg_type)
+    sql += ')'
+    ds.ExecuteSQL(sql)
+    if gdaltest.pg_has_postgis:
+        ds.ReleaseResultSet(ds.ExecuteSQL("SELECT AddGeometryColumn('public','ogr_pg_87','geom',4326,'POINT',2)"))
+        ds.ExecuteSQL('ALTER TABLE ogr_pg_87 ADD COLUMN geog geography(POINT,4326)')
+    ds = None
+
+    # Reopen so that the layer definition is read back from the table
+    ds = ogr.Open( 'PG:' + gdaltest.pg_connection_string, update = 1 )
+    ds.ExecuteSQL( 'set timezone to "UTC"' )
+    lyr = ds.GetLayerByName('ogr_pg_87')
+    for i in range(2):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        for (name, pg_type, values) in ogr_pg_87_columns:
+            ogr_pg_87_set_field(f, name, values[i])
+        if gdaltest.pg_has_postgis:
+            f.SetGeomField(0, ogr.CreateGeometryFromWkt('POINT (%d 49.5)' % (i + 2)))
+            f.SetGeomField(1, ogr.CreateGeometryFromWkt('POINT (-%d.25 -1)' % i))
+        if lyr.CreateFeature(f) != 0:
+            return None
+    # Row of NULL values
+    f = ogr.Feature(lyr.GetLayerDefn())
+    if lyr.CreateFeature(f) != 0:
+        return None
+    ds = None
+
+    ds = ogr.Open( 'PG:' + gdaltest.pg_connection_string )
+    ds.ExecuteSQL( 'set timezone to "UTC"' )
+    lyr = ds.GetLayerByName('ogr_pg_87')
+    ret = [ ogr_pg_87_read(lyr) ]
+
+    # Result layer whose columns can all be decoded from binary
+    sql = 'SELECT ' + ', '.join(ogr_pg_87_decodable_columns)
+    if gdaltest.pg_has_postgis:
+        sql += ', geom, geog'
+    sql += ' FROM ogr_pg_87 ORDER BY ogc_fid'
+    sql_lyr = ds.ExecuteSQL(sql)
+    ret.append(ogr_pg_87_read(sql_lyr))
+    ds.ReleaseResultSet(sql_lyr)
+
+    # Result layer with a column that forces the text cursor fallback
+    sql_lyr = ds.ExecuteSQL('SELECT * FROM ogr_pg_87 ORDER BY ogc_fid')
+    ret.append(ogr_pg_87_read(sql_lyr))
+    ds.ReleaseResultSet(sql_lyr)
+    ds = None
+
+    return ret
+
+def ogr_pg_87():
+
+    if gdaltest.pg_ds is None or gdaltest.ogr_pg_second_run :
+        return 'skip'
+
+    old_use_copy = gdal.GetConfigOption('PG_USE_COPY')
+    old_copy_binary = gdal.GetConfigOption('PG_USE_COPY_BINARY')
+    old_binary_cursor = gdal.GetConfigOption('PG_USE_BINARY_CURSOR')
+
+    ret = 'success'
+    ref = None
+    for (copy_binary, binary_cursor) in [ ('NO', 'NO'), ('YES', 'NO'), ('NO', 'YES'), ('YES', 'YES') ]:
+        got = ogr_pg_87_write_and_read(copy_binary, binary_cursor)
+        if got is None:
+            gdaltest.post_reason('fail')
+            print(copy_binary, binary_cursor)
+            ret = 'fail'
+            break
+        if ref is None:
+            ref = got
+            # Sanity check the text paths against the input values
+            row = ref[0][0]
+            if row[0:4] != [ 1, 32767, 2147483647, 1234567890123 ] or \
+               row[len(ogr_pg_87_columns) - 1] != '0001FF' or \
+               ref[0][2][0] is not None:
+                gdaltest.post_reason('fail')
+                print(ref[0])
+                ret = 'fail'
+                break
+        elif got != ref:
+            gdaltest.post_reason('fail')
+            print(copy_binary, binary_cursor)
+            print(got)
+            print(ref)
+            ret = 'fail'
+            break
+
+    gdal.SetConfigOption('PG_USE_COPY', old_use_copy)
+    gdal.SetConfigOption('PG_USE_COPY_BINARY', old_copy_binary)
+    gdal.SetConfigOption('PG_USE_BINARY_CURSOR', old_binary_cursor)
+
+    return ret
+
 ###############################################################################
 #
 
@@ -5515,6 +5689,7 @@ def ogr_pg_table_cleanup():
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_85_1' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_85_2' )
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_86' )
+    gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:ogr_pg_87' )
 
     # Drop second 'tpoly' from schema 'AutoTest-schema' (do NOT quote names here)
     gdaltest.pg_ds.ExecuteSQL( 'DELLAYER:AutoTest-schema.tpoly' )
@@ -5635,6 +5810,7 @@ gdaltest_list_internal = [
     ogr_pg_84,
     ogr_pg_85,
     ogr_pg_86,
+    ogr_pg_87,
     ogr_pg_cleanup
 ]
 
@@ -1565,6 +1565,62 @@ def ogr_rfc28_48():
 
     return 'success'
 
+###############################################################################
+# Test that the compiled evaluation of attribute filters gives the same
+# results as the generic evaluation
+
+def ogr_rfc28_49():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('lyr', geom_type = ogr.wkbNone)
+    lyr.CreateField(ogr.FieldDefn('i', ogr.OFTInteger))
+    lyr.CreateField(ogr.FieldDefn('i64', ogr.OFTInteger64))
+    lyr.CreateField(ogr.FieldDefn('r', ogr.OFTReal))
+    lyr.CreateField(ogr.FieldDefn('s', ogr.OFTString))
+    fld_defn = ogr.FieldDefn('b', ogr.OFTInteger)
+    fld_defn.SetSubType(ogr.OFSTBoolean)
+    lyr.CreateField(fld_defn)
+    values = [ [ 1, 1234567890123, 1.5, 'foo', 1 ],
+               [ 2, -1, 2.0, 'Bar', 0 ],
+               [ None, 5, None, 'baz', None ],
+               [ 4, None, -3.25, None, 1 ],
+               [ 5, 0, 5.0, '2017/02/17 11:06:34+00', 0 ],
+               [ 2, 2, 2.5, 'a_b%c', None ] ]
+    for vals in values:
+        f = ogr.Feature(lyr.GetLayerDefn())
+        for i in range(len(vals)):
+            if vals[i] is not None:
+                f.SetField(i, vals[i])
+        lyr.CreateFeature(f)
+
+    filters = [ 'i = 2', 'i <> 2', '2 < i', 'i >= 2.5', 'i64 > 1000',
+                'i64 IN (-1, 5)', 'r BETWEEN 1.5 AND 2.5', 'r < 2',
+                'r IN (2, 2.5)', "s = 'FOO'", "s > 'b'", "'bar' <= s",
+                "s IN ('baz', 'foo')", "s BETWEEN 'a' AND 'bb'",
+                "s LIKE 'ba%'", "s LIKE 'ax_b%' ESCAPE 'x'",
+                "s = '2017/02/17 11:06:34'", 'b', 'NOT b', 'b = 1',
+                'i IS NULL', 'i IS NOT NULL', 'NOT (i = 2)',
+                'i = 2 AND r > 2', 'i = 2 OR s IS NULL',
+                'i IN (1, 2) OR NOT r < 0', 'b OR i = 5', 'NOT b OR i = 5',
+                'FID < 3', 'i + 1 = 3', 'i = i64 OR i > 4' ]
+    for filter in filters:
+        result = {}
+        for compile_filter in [ 'NO', 'YES' ]:
+            gdal.SetConfigOption('OGR_SQL_COMPILE_FILTER', compile_filter)
+            ret = lyr.SetAttributeFilter(filter)
+            gdal.SetConfigOption('OGR_SQL_COMPILE_FILTER', None)
+            if ret != 0:
+                gdaltest.post_reason('fail')
+                print(filter)
+                return 'fail'
+            result[compile_filter] = [ f.GetFID() for f in lyr ]
+        if result['NO'] != result['YES']:
+            gdaltest.post_reason('fail')
+            print(filter, result)
+            return 'fail'
+
+    return 'success'
+
 ###############################################################################
 def ogr_rfc28_cleanup():
     gdaltest.lyr = None
@@ -1626,6 +1682,7 @@ gdaltest_list = [
     ogr_rfc28_46,
     ogr_rfc28_47,
     ogr_rfc28_48,
+    ogr_rfc28_49,
     ogr_rfc28_cleanup ]
 
 if __name__ == '__main__':
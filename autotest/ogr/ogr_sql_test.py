@@ -1543,6 +1543,90 @@ def ogr_sql_48():
     return 'success'
 
 
+###############################################################################
+# Test sorting with spilling to temporary files and with LIMIT / OFFSET
+
+def ogr_sql_49():
+
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test')
+    lyr.CreateField( ogr.FieldDefn( 'int_field', ogr.OFTInteger) )
+    lyr.CreateField( ogr.FieldDefn( 'str_field', ogr.OFTString) )
+    lyr.CreateField( ogr.FieldDefn( 'strlist_field', ogr.OFTStringList) )
+    for i in range(1000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetField(0, (i * 7) % 100)
+        f.SetField(1, 'val%d' % i)
+        f.SetFieldStringList(2, ['a%d' % i, 'b'])
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d 2)' % i))
+        lyr.CreateFeature(f)
+
+    # Features with equal keys must be returned in their original order
+    expected = sorted([ ((i * 7) % 100, i) for i in range(1000) ])
+
+    for max_mem in [ None, '10000', '1' ]:
+        # The features are sorted when first read
+        gdal.SetConfigOption('OGR_GENSQL_SORT_MAX_MEMORY', max_mem)
+        sql_lyr = ds.ExecuteSQL('SELECT * FROM test ORDER BY int_field')
+        for it in range(2):
+            got = []
+            for f in sql_lyr:
+                i = f.GetFID()
+                if f['str_field'] != 'val%d' % i or \
+                   f['strlist_field'] != [ 'a%d' % i, 'b' ] or \
+                   f.GetGeometryRef().ExportToWkt() != 'POINT (%d 2)' % i:
+                    gdaltest.post_reason('fail')
+                    f.DumpReadable()
+                    return 'fail'
+                got.append((f['int_field'], i))
+            if got != expected:
+                gdal.SetConfigOption('OGR_GENSQL_SORT_MAX_MEMORY', None)
+                gdaltest.post_reason('fail')
+                print(max_mem)
+                return 'fail'
+        gdal.SetConfigOption('OGR_GENSQL_SORT_MAX_MEMORY', None)
+        ds.ReleaseResultSet(sql_lyr)
+
+    sql_lyr = ds.ExecuteSQL('SELECT * FROM test ORDER BY int_field DESC LIMIT 5 OFFSET 8')
+    got = [ (f['int_field'], f.GetFID()) for f in sql_lyr ]
+    ds.ReleaseResultSet(sql_lyr)
+    expected = sorted([ ((i * 7) % 100, i) for i in range(1000) ],
+                      key = lambda x: -x[0])[8:13]
+    if got != expected:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    # Records larger than the read buffer of the spilled runs
+    ds = ogr.GetDriverByName('Memory').CreateDataSource('')
+    lyr = ds.CreateLayer('test', geom_type = ogr.wkbNone)
+    lyr.CreateField( ogr.FieldDefn( 'int_field', ogr.OFTInteger) )
+    lyr.CreateField( ogr.FieldDefn( 'str_field', ogr.OFTString) )
+    for i in range(50):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetField(0, (i * 37) % 50)
+        f.SetField(1, chr(65 + i % 26) * (6000 + i * 100))
+        lyr.CreateFeature(f)
+
+    gdal.SetConfigOption('OGR_GENSQL_SORT_MAX_MEMORY', '20000')
+    sql_lyr = ds.ExecuteSQL('SELECT * FROM test ORDER BY int_field')
+    gdal.ErrorReset()
+    got = []
+    for f in sql_lyr:
+        i = f.GetFID()
+        if f['str_field'] != chr(65 + i % 26) * (6000 + i * 100):
+            got = None
+            break
+        got.append(f['int_field'])
+    gdal.SetConfigOption('OGR_GENSQL_SORT_MAX_MEMORY', None)
+    ds.ReleaseResultSet(sql_lyr)
+    if got != list(range(50)) or gdal.GetLastErrorMsg() != '':
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    return 'success'
+
 def ogr_sql_cleanup():
     gdaltest.lyr = None
     gdaltest.ds = None
@@ -1600,6 +1684,7 @@ gdaltest_list = [
     ogr_sql_46,
     ogr_sql_47,
     ogr_sql_48,
+    ogr_sql_49,
     ogr_sql_cleanup ]
 
 if __name__ == '__main__':
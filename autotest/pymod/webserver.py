@@ -33,7 +33,11 @@ try:
     from BaseHTTPServer import BaseHTTPRequestHandler, HTTPServer
 except:
     from http.server import BaseHTTPRequestHandler, HTTPServer
-from threading import Thread
+try:
+    from SocketServer import ThreadingMixIn
+except:
+    from socketserver import ThreadingMixIn
+from threading import Lock, Thread
 
 import time
 import sys
@@ -47,6 +51,164 @@ test_retry_attempt = 0
 
 TIME_SKEW = 30 * 60
 
+###############################################################################
+# Requests issued concurrently by the C++ tests of CPLHTTPMultiFetch() and of
+# CPL_VSIL_CURL_PARALLEL_DOWNLOADS, when the server runs with --threading.
+
+class ConcurrentRequestStats:
+
+    def __init__(self):
+        self.lock = Lock()
+        self.reset()
+
+    def reset(self):
+        self.in_flight = 0
+        self.max_in_flight = 0
+        self.requests = 0
+        self.connections = set()
+        self.attempts = {}
+
+    def begin(self, handler):
+        self.lock.acquire()
+        self.in_flight += 1
+        self.max_in_flight = max(self.max_in_flight, self.in_flight)
+        self.requests += 1
+        self.connections.add(handler.client_address)
+        self.lock.release()
+
+    def end(self):
+        self.lock.acquire()
+        self.in_flight -= 1
+        self.lock.release()
+
+    # Returns 1 the first time key is passed, 2 the second time, etc.
+    def attempt(self, key):
+        self.lock.acquire()
+        self.attempts[key] = self.attempts.get(key, 0) + 1
+        ret = self.attempts[key]
+        self.lock.release()
+        return ret
+
+    # Returns the statistics as a string, and resets them.
+    def pop(self):
+        self.lock.acquire()
+        ret = 'max_in_flight=%d connections=%d requests=%d' % \
+            (self.max_in_flight, len(self.connections), self.requests)
+        self.reset()
+        self.lock.release()
+        return ret
+
+concurrent_stats = ConcurrentRequestStats()
+
+concurrent_data = {}
+
+# Content of the test files: byte i is (i * 7 + i / 16384) & 0xFF.
+def get_concurrent_data(size):
+    if size not in concurrent_data:
+        concurrent_data[size] = bytes(bytearray(
+            [(i * 7 + i // 16384) & 0xFF for i in range(size)]))
+    return concurrent_data[size]
+
+VSICURL_PARALLEL_SIZE = 262144
+
+# Keeps the connection open after the response, so that clients can reuse it.
+def send_keep_alive_response(handler, code, content, headers = []):
+    handler.protocol_version = 'HTTP/1.1'
+    handler.send_response(code)
+    for (key, value) in headers:
+        handler.send_header(key, value)
+    handler.send_header('Content-Length', len(content))
+    handler.end_headers()
+    handler.wfile.write(content)
+    handler.close_connection = False
+
+def handle_cpl_http_multifetch(handler):
+    if handler.path == '/cpl_http_multifetch/stats':
+        send_keep_alive_response(handler, 200,
+                                 concurrent_stats.pop().encode('ascii'))
+        return
+
+    concurrent_stats.begin(handler)
+    try:
+        # Leave time for the other requests to start.
+        time.sleep(0.3)
+        if handler.path.startswith('/cpl_http_multifetch/data?range='):
+            (start, end) = handler.path[len('/cpl_http_multifetch/data?range='):].split('-')
+            content = get_concurrent_data(100000)[int(start):int(end) + 1]
+            send_keep_alive_response(handler, 200, content)
+        elif handler.path == '/cpl_http_multifetch/retry':
+            if concurrent_stats.attempt(handler.path) == 1:
+                send_keep_alive_response(handler, 503, b'Service Unavailable')
+            else:
+                send_keep_alive_response(handler, 200, b'retried')
+        else:
+            send_keep_alive_response(handler, 404, b'Not Found')
+    finally:
+        concurrent_stats.end()
+
+# /vsicurl_parallel/ordered.bin: ranges starting first are answered last.
+# /vsicurl_parallel/flaky.bin: the first range containing offset 70000 is
+# answered with fewer bytes than requested, and the connection of the first
+# range containing offset 200000 is closed in the middle of the transfer.
+# /vsicurl_parallel/broken.bin: same as flaky.bin, but ranges containing
+# offset 200000 always fail.
+def handle_vsicurl_parallel(handler):
+    if handler.path == '/vsicurl_parallel/stats':
+        send_keep_alive_response(handler, 200,
+                                 concurrent_stats.pop().encode('ascii'))
+        return
+
+    name = handler.path[len('/vsicurl_parallel/'):]
+    if name not in ('ordered.bin', 'flaky.bin', 'broken.bin'):
+        send_keep_alive_response(handler, 404, b'Not Found')
+        return
+
+    size = VSICURL_PARALLEL_SIZE
+    if handler.command == 'HEAD':
+        handler.protocol_version = 'HTTP/1.1'
+        handler.send_response(200)
+        handler.send_header('Content-Length', size)
+        handler.end_headers()
+        handler.close_connection = False
+        return
+
+    if 'Range' not in handler.headers or \
+       not handler.headers['Range'].startswith('bytes='):
+        send_keep_alive_response(handler, 400, b'Range expected')
+        return
+
+    (start, end) = handler.headers['Range'][len('bytes='):].split('-')
+    start = int(start)
+    end = min(int(end), size - 1)
+
+    concurrent_stats.begin(handler)
+    try:
+        time.sleep(0.05 + 0.3 * (size - start) / size)
+        content = get_concurrent_data(size)[start:end + 1]
+        headers = [('Content-Range', 'bytes %d-%d/%d' % (start, end, size))]
+
+        if name != 'ordered.bin' and start <= 70000 and 70000 <= end and \
+           concurrent_stats.attempt((name, 70000)) == 1:
+            send_keep_alive_response(handler, 206,
+                                     content[0:len(content) // 2], headers)
+            return
+
+        if name != 'ordered.bin' and start <= 200000 and 200000 <= end and \
+           (concurrent_stats.attempt((name, 200000)) == 1 or \
+            name == 'broken.bin'):
+            handler.protocol_version = 'HTTP/1.1'
+            handler.send_response(206)
+            handler.send_header('Content-Range', headers[0][1])
+            handler.send_header('Content-Length', len(content))
+            handler.end_headers()
+            handler.wfile.write(content[0:len(content) // 2])
+            handler.close_connection = True
+            return
+
+        send_keep_alive_response(handler, 206, content, headers)
+    finally:
+        concurrent_stats.end()
+
 class GDAL_Handler(BaseHTTPRequestHandler):
 
     def log_request(self, code='-', size='-'):
@@ -58,6 +220,10 @@ class GDAL_Handler(BaseHTTPRequestHandler):
             f.write('HEAD %s\n' % self.path)
             f.close()
 
+        if self.path.startswith('/vsicurl_parallel/'):
+            handle_vsicurl_parallel(self)
+            return
+
         if self.path == '/s3_fake_bucket/resource2.bin':
             self.send_response(200)
             self.send_header('Content-type', 'text/plain')
@@ -345,6 +511,14 @@ class GDAL_Handler(BaseHTTPRequestHandler):
                 self.server.stop_requested = True
                 return
 
+            if self.path.startswith('/cpl_http_multifetch/'):
+                handle_cpl_http_multifetch(self)
+                return
+
+            if self.path.startswith('/vsicurl_parallel/'):
+                handle_vsicurl_parallel(self)
+                return
+
             if self.path.startswith('/vsimem/'):
                 from osgeo import gdal
                 f = gdal.VSIFOpenL(self.path, "rb")
@@ -1264,9 +1438,15 @@ class GDAL_HttpServer(HTTPServer):
         self.running = False
         self.stop_requested = False
 
+# Handles each connection in its own thread, so that concurrent requests
+# are served concurrently.
+class GDAL_ThreadingHttpServer(ThreadingMixIn, GDAL_HttpServer):
+
+    daemon_threads = True
+
 class GDAL_ThreadedHttpServer(Thread):
 
-    def __init__ (self, handlerClass = None):
+    def __init__ (self, handlerClass = None, serverClass = GDAL_HttpServer):
         Thread.__init__(self)
         ok = False
         self.server = 0
@@ -1274,7 +1454,7 @@ class GDAL_ThreadedHttpServer(Thread):
             handlerClass = GDAL_Handler
         for port in range(8080,8100):
             try:
-                self.server = GDAL_HttpServer(('', port), handlerClass)
+                self.server = serverClass(('', port), handlerClass)
                 self.server.port = port
                 ok = True
                 break
@@ -1355,8 +1535,11 @@ def server_stop(process, port):
     gdaltest.wait_process(process)
 
 def main():
+    serverClass = GDAL_HttpServer
+    if len(sys.argv) > 1 and sys.argv[1] == '--threading':
+        serverClass = GDAL_ThreadingHttpServer
     try:
-        server = GDAL_ThreadedHttpServer(GDAL_Handler)
+        server = GDAL_ThreadedHttpServer(GDAL_Handler, serverClass)
         server.start_and_wait_ready()
         print('port=%d' % server.getPort())
         sys.stdout.flush()
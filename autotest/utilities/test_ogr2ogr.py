@@ -2728,6 +2728,40 @@ def test_ogr2ogr_67():
     ret = check_identity_transformation(x, y, 4326)
     return ret
 
+###############################################################################
+# Test -multi: output must be identical and in the same order as without it
+
+def test_ogr2ogr_68():
+    if test_cli_utilities.get_ogr2ogr_path() is None:
+        return 'skip'
+
+    for filename in ['tmp/test_ogr2ogr_68_ref.csv', 'tmp/test_ogr2ogr_68.csv']:
+        try:
+            os.unlink(filename)
+        except:
+            pass
+
+    opts = ' -explodecollections -t_srs EPSG:4326 -lco GEOMETRY=AS_WKT ../ogr/data/poly.shp'
+    gdaltest.runexternal(test_cli_utilities.get_ogr2ogr_path() + ' -f CSV tmp/test_ogr2ogr_68_ref.csv' + opts)
+    (ret, err) = gdaltest.runexternal_out_and_err(test_cli_utilities.get_ogr2ogr_path() + ' --config GDAL_NUM_THREADS 4 -multi -gt 3 -f CSV tmp/test_ogr2ogr_68.csv' + opts)
+    if not (err is None or err == '') :
+        gdaltest.post_reason('got error/warning')
+        print(err)
+        return 'fail'
+
+    ref = open('tmp/test_ogr2ogr_68_ref.csv').read()
+    got = open('tmp/test_ogr2ogr_68.csv').read()
+
+    os.unlink('tmp/test_ogr2ogr_68_ref.csv')
+    os.unlink('tmp/test_ogr2ogr_68.csv')
+
+    if got != ref or got.count('\n') != 11:
+        gdaltest.post_reason('fail')
+        print(got)
+        return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     test_ogr2ogr_1,
     test_ogr2ogr_2,
@@ -2796,7 +2830,8 @@ gdaltest_list = [
     test_ogr2ogr_64,
     test_ogr2ogr_65,
     test_ogr2ogr_66,
-    test_ogr2ogr_67
+    test_ogr2ogr_67,
+    test_ogr2ogr_68
     ]
 
 # gdaltest_list = [ test_ogr2ogr_66 ]
@@ -346,7 +346,7 @@ static void Usage(const char* pszAdditionalMsg, int bShort)
             "               [-dim XY|XYZ|XYM|XYZM|layer_dim] [layer [layer ...]]\n"
             "\n"
             "Advanced options :\n"
-            "               [-gt n] [-ds_transaction]\n"
+            "               [-gt n] [-ds_transaction] [-multi]\n"
             "               [[-oo NAME=VALUE] ...] [[-doo NAME=VALUE] ...]\n"
             "               [-clipsrc [xmin ymin xmax ymax]|WKT|datasource|spat_extent]\n"
             "               [-clipsrcsql sql_statement] [-clipsrclayer layer]\n"
@@ -407,6 +407,7 @@ static void Usage(const char* pszAdditionalMsg, int bShort)
             " -dialect value: select a dialect, usually OGRSQL to avoid native sql.\n"
             " -skipfailures: skip features or layers that fail to convert\n"
             " -gt n: group n features per transaction (default 20000). n can be set to unlimited\n"
+            " -multi: read, translate and write features in separate threads\n"
             " -spat xmin ymin xmax ymax: spatial query extents\n"
             " -simplify tolerance: distance tolerance for simplification.\n"
             " -segmentize max_dist: maximum distance between 2 nodes.\n"
@@ -37,6 +37,7 @@
 #include <cstdlib>
 #include <cstring>
 
+#include <deque>
 #include <map>
 #include <string>
 #include <utility>
@@ -45,9 +46,11 @@
 #include "commonutils.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_multiproc.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_alg.h"
 #include "gdal_priv.h"
@@ -339,6 +342,11 @@ struct GDALVectorTranslateOptions
 
     /*! Maximum number of features, or -1 if no limit. */
     GIntBig nLimit;
+
+    /*! Whether features are read, translated and written by separate
+        threads. The number of translating threads is controlled by the
+        GDAL_NUM_THREADS configuration option. */
+    bool bMultiThread;
 };
 
 typedef struct
@@ -422,6 +430,15 @@ public:
     bool                          m_bExplodeCollections;
     bool                          m_bNativeData;
     GIntBig                       m_nLimit;
+    int                           m_nThreads;
+
+    /* Result of the translation of one part of a source feature */
+    typedef struct
+    {
+        OGRFeature  *poDstFeature; /* NULL if nothing must be written */
+        bool         bSetFromFailed;
+        int          nReprojectFailures;
+    } TranslatedPart;
 
     int                 Translate(OGRFeature* poFeatureIn,
                                   TargetLayerInfo* psInfo,
@@ -431,6 +448,40 @@ public:
                                   GDALProgressFunc pfnProgress,
                                   void *pProgressArg,
                                   GDALVectorTranslateOptions *psOptions);
+
+    int                 GetPartCount(OGRFeature* poFeature,
+                                     TargetLayerInfo* psInfo,
+                                     int& nParts) const;
+    void                TranslatePart(OGRFeature* poFeature,
+                                      TargetLayerInfo* psInfo,
+                                      int iPart, int nParts,
+                                      OGRCoordinateTransformation** papoCT,
+                                      OGRSpatialReference* poOutputSRS,
+                                      GDALVectorTranslateOptions *psOptions,
+                                      TranslatedPart& sPart) const;
+    bool                StepTransaction(TargetLayerInfo* psInfo,
+                                        int& nFeaturesInTransaction,
+                                        GIntBig& nTotalEventsDone,
+                                        GDALVectorTranslateOptions *psOptions);
+    bool                WritePart(OGRFeature* poFeature,
+                                  TargetLayerInfo* psInfo,
+                                  TranslatedPart& sPart,
+                                  GIntBig& nFeaturesWritten,
+                                  GDALVectorTranslateOptions *psOptions);
+    bool                TranslateMultiThreaded(OGRFeature* poFirstFeature,
+                                               TargetLayerInfo* psInfo,
+                                               OGRSpatialReference* poOutputSRS,
+                                               GIntBig nCountLayerFeatures,
+                                               GIntBig* pnReadFeatureCount,
+                                               GIntBig& nCount,
+                                               int& nFeaturesInTransaction,
+                                               GIntBig& nTotalEventsDone,
+                                               GIntBig& nFeaturesWritten,
+                                               GDALProgressFunc pfnProgress,
+                                               void *pProgressArg,
+                                               GDALVectorTranslateOptions *psOptions,
+                                               bool& bStarted,
+                                               bool& bGoOn);
 };
 
 static OGRLayer* GetLayerAndOverwriteIfNecessary(GDALDataset *poDstDS,
@@ -2405,6 +2456,9 @@ GDALDatasetH GDALVectorTranslate( const char *pszDest, GDALDatasetH hDstDS, int
     oTranslator.m_bExplodeCollections = psOptions->bExplodeCollections;
     oTranslator.m_bNativeData = psOptions->bNativeData;
     oTranslator.m_nLimit = psOptions->nLimit;
+    oTranslator.m_nThreads = 1;
+    if( psOptions->bMultiThread && poODS != poDS )
+        oTranslator.m_nThreads = CPLGetNumThreads(NULL, "ALL_CPUS");
 
     if( psOptions->nGroupTransactions )
     {
@@ -4194,25 +4248,60 @@ static bool SetupCT( TargetLayerInfo* psInfo,
 }
 
 /************************************************************************/
-/*                     LayerTranslator::Translate()                     */
+/*                   LayerTranslator::GetPartCount()                    */
 /************************************************************************/
 
-int LayerTranslator::Translate( OGRFeature* poFeatureIn,
-                                TargetLayerInfo* psInfo,
-                                GIntBig nCountLayerFeatures,
-                                GIntBig* pnReadFeatureCount,
-                                GIntBig& nTotalEventsDone,
-                                GDALProgressFunc pfnProgress,
-                                void *pProgressArg,
-                                GDALVectorTranslateOptions *psOptions )
+/* Returns the number of features to write for a source feature, and set */
+/* nParts to the number of parts to extract with -explodecollections. */
+int LayerTranslator::GetPartCount( OGRFeature* poFeature,
+                                   TargetLayerInfo* psInfo,
+                                   int& nParts ) const
 {
-    OGRLayer    *poSrcLayer;
-    OGRLayer    *poDstLayer;
-    const int         eGType = m_eGType;
-    OGRSpatialReference* poOutputSRS = m_poOutputSRS;
+    const int nDstGeomFieldCount =
+        psInfo->poDstLayer->GetLayerDefn()->GetGeomFieldCount();
+    const bool bExplodeCollections = m_bExplodeCollections && nDstGeomFieldCount <= 1;
 
-    poSrcLayer = psInfo->poSrcLayer;
-    poDstLayer = psInfo->poDstLayer;
+    nParts = 0;
+    int nIters = 1;
+    if (bExplodeCollections)
+    {
+        OGRGeometry* poSrcGeometry;
+        if( psInfo->iRequestedSrcGeomField >= 0 )
+            poSrcGeometry = poFeature->GetGeomFieldRef(
+                                    psInfo->iRequestedSrcGeomField);
+        else
+            poSrcGeometry = poFeature->GetGeometryRef();
+        if (poSrcGeometry &&
+            OGR_GT_IsSubClassOf(poSrcGeometry->getGeometryType(), wkbGeometryCollection) )
+        {
+            nParts = ((OGRGeometryCollection*)poSrcGeometry)->getNumGeometries();
+            nIters = nParts;
+            if (nIters == 0)
+                nIters = 1;
+        }
+    }
+    return nIters;
+}
+
+/************************************************************************/
+/*                   LayerTranslator::TranslatePart()                   */
+/************************************************************************/
+
+/* Build the target feature for the iPart(th) part of a source feature. */
+/* This does not touch the target layer and does not emit errors, so that */
+/* it can be run by worker threads: failures are recorded in sPart and */
+/* reported by WritePart(). */
+void LayerTranslator::TranslatePart( OGRFeature* poFeature,
+                                     TargetLayerInfo* psInfo,
+                                     int iPart, int nParts,
+                                     OGRCoordinateTransformation** papoCT,
+                                     OGRSpatialReference* poOutputSRS,
+                                     GDALVectorTranslateOptions *psOptions,
+                                     TranslatedPart& sPart ) const
+{
+    OGRLayer    *poSrcLayer = psInfo->poSrcLayer;
+    OGRLayer    *poDstLayer = psInfo->poDstLayer;
+    const int         eGType = m_eGType;
     int* const panMap = psInfo->panMap;
     const int iSrcZField = psInfo->iSrcZField;
     const bool bPreserveFID = psInfo->bPreserveFID;
@@ -4220,382 +4309,853 @@ int LayerTranslator::Translate( OGRFeature* poFeatureIn,
     const int nDstGeomFieldCount = poDstLayer->GetLayerDefn()->GetGeomFieldCount();
     const bool bExplodeCollections = m_bExplodeCollections && nDstGeomFieldCount <= 1;
 
-    if( poOutputSRS == NULL && !m_bNullifyOutputSRS )
+    sPart.poDstFeature = NULL;
+    sPart.bSetFromFailed = false;
+    sPart.nReprojectFailures = 0;
+
+    OGRFeature *poDstFeature = OGRFeature::CreateFeature( poDstLayer->GetLayerDefn() );
+
+    /* A source geometry still in WKB form, that needs no processing, is */
+    /* passed as it is to the target feature, so that drivers that can */
+    /* write WKB do not have to decode and re-encode it. WKB carries no */
+    /* SRS, so not with -a_srs. */
+    const GByte* pabyPassThroughWKB = NULL;
+    size_t nPassThroughWKBSize = 0;
+    const int iSingleSrcGeomField =
+        ( psInfo->iRequestedSrcGeomField >= 0 ) ?
+            psInfo->iRequestedSrcGeomField :
+        ( nSrcGeomFieldCount == 1 && nDstGeomFieldCount == 1 ) ? 0 : -1;
+    if( iSingleSrcGeomField >= 0 && nDstGeomFieldCount == 1 &&
+        nParts == 0 && !bExplodeCollections &&
+        iSrcZField == -1 && m_nCoordDim == COORD_DIM_UNCHANGED &&
+        m_eGeomOp == GEOMOP_NONE && m_poClipSrc == NULL &&
+        m_poClipDst == NULL && eGType == GEOMTYPE_UNCHANGED &&
+        m_eGeomTypeConversion == GTC_DEFAULT &&
+        (m_bTransform ? papoCT[0] : m_poGCPCoordTrans) == NULL &&
+        psInfo->papapszTransformOptions[0] == NULL && poOutputSRS == NULL )
     {
-        if( nSrcGeomFieldCount == 1 )
-        {
-            poOutputSRS = poSrcLayer->GetSpatialRef();
-        }
-        else if( psInfo->iRequestedSrcGeomField > 0 )
-        {
-            poOutputSRS = poSrcLayer->GetLayerDefn()->GetGeomFieldDefn(
-                psInfo->iRequestedSrcGeomField)->GetSpatialRef();
-        }
+        pabyPassThroughWKB =
+            poFeature->GetGeomFieldWKBRef(iSingleSrcGeomField,
+                                          &nPassThroughWKBSize);
     }
 
-/* -------------------------------------------------------------------- */
-/*      Transfer features.                                              */
-/* -------------------------------------------------------------------- */
-    OGRFeature  *poFeature;
-    int         nFeaturesInTransaction = 0;
-    GIntBig      nCount = 0; /* written + failed */
-    GIntBig      nFeaturesWritten = 0;
+    /* Optimization to avoid duplicating the source geometry in the */
+    /* target feature : we steal it from the source feature for now... */
+    OGRGeometry* poStolenGeometry = NULL;
+    if( pabyPassThroughWKB == NULL && !bExplodeCollections &&
+        nSrcGeomFieldCount == 1 && nDstGeomFieldCount == 1 )
+    {
+        poStolenGeometry = poFeature->StealGeometry();
+    }
+    else if( pabyPassThroughWKB == NULL && !bExplodeCollections &&
+             psInfo->iRequestedSrcGeomField >= 0 )
+    {
+        poStolenGeometry = poFeature->StealGeometry(
+            psInfo->iRequestedSrcGeomField);
+    }
 
-    if( psOptions->nGroupTransactions )
+    if( poDstFeature->SetFrom( poFeature, panMap, TRUE ) != OGRERR_NONE )
     {
-        if( psOptions->nLayerTransaction )
+        OGRFeature::DestroyFeature( poDstFeature );
+        OGRGeometryFactory::destroyGeometry( poStolenGeometry );
+        sPart.bSetFromFailed = true;
+        return;
+    }
+
+    /* ... and now we can attach the stolen geometry */
+    if( poStolenGeometry )
+    {
+        poDstFeature->SetGeometryDirectly(poStolenGeometry);
+    }
+
+    if( bPreserveFID )
+        poDstFeature->SetFID( poFeature->GetFID() );
+    else if( psInfo->iSrcFIDField >= 0 &&
+             poFeature->IsFieldSetAndNotNull(psInfo->iSrcFIDField))
+        poDstFeature->SetFID( poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField) );
+
+    /* Erase native data if asked explicitly */
+    if( !m_bNativeData )
+    {
+        poDstFeature->SetNativeData(NULL);
+        poDstFeature->SetNativeMediaType(NULL);
+    }
+
+    if( pabyPassThroughWKB != NULL )
+    {
+        /* SetFrom() has already copied it if the field names match */
+        if( poDstFeature->GetGeomFieldWKBRef(0, NULL) == NULL )
         {
-            if( poDstLayer->StartTransaction() == OGRERR_FAILURE )
-                return false;
+            poDstFeature->SetGeomFieldWKB(0, pabyPassThroughWKB,
+                                          nPassThroughWKBSize);
         }
+        sPart.poDstFeature = poDstFeature;
+        return;
     }
 
-    bool bRet = true;
-    while( true )
+    for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom ++ )
     {
-        if( m_nLimit >= 0 && psInfo->nFeaturesRead >= m_nLimit )
+        OGRGeometry* poDstGeometry = poDstFeature->StealGeometry(iGeom);
+        if (poDstGeometry == NULL)
+            continue;
+
+        if (nParts > 0)
         {
-            break;
+            /* For -explodecollections, extract the iPart(th) of the geometry */
+            OGRGeometry* poPart = ((OGRGeometryCollection*)poDstGeometry)->getGeometryRef(iPart);
+            ((OGRGeometryCollection*)poDstGeometry)->removeGeometry(iPart, FALSE);
+            delete poDstGeometry;
+            poDstGeometry = poPart;
         }
 
-        OGRFeature      *poDstFeature = NULL;
+        if (iSrcZField != -1)
+        {
+            SetZ(poDstGeometry, poFeature->GetFieldAsDouble(iSrcZField));
+            /* This will correct the coordinate dimension to 3 */
+            OGRGeometry* poDupGeometry = poDstGeometry->clone();
+            delete poDstGeometry;
+            poDstGeometry = poDupGeometry;
+        }
 
-        if( poFeatureIn != NULL )
-            poFeature = poFeatureIn;
-        else if( psOptions->nFIDToFetch != OGRNullFID )
-            poFeature = poSrcLayer->GetFeature(psOptions->nFIDToFetch);
-        else
-            poFeature = poSrcLayer->GetNextFeature();
+        if (m_nCoordDim == 2 || m_nCoordDim == 3)
+            poDstGeometry->setCoordinateDimension( m_nCoordDim );
+        else if (m_nCoordDim == 4)
+        {
+            poDstGeometry->set3D( TRUE );
+            poDstGeometry->setMeasured( TRUE );
+        }
+        else if (m_nCoordDim == COORD_DIM_XYM)
+        {
+            poDstGeometry->set3D( FALSE );
+            poDstGeometry->setMeasured( TRUE );
+        }
+        else if ( m_nCoordDim == COORD_DIM_LAYER_DIM )
+        {
+            const OGRwkbGeometryType eDstLayerGeomType =
+              poDstLayer->GetLayerDefn()->GetGeomFieldDefn(iGeom)->GetType();
+            poDstGeometry->set3D( wkbHasZ(eDstLayerGeomType) );
+            poDstGeometry->setMeasured( wkbHasM(eDstLayerGeomType) );
+        }
 
-        if( poFeature == NULL )
-            break;
+        if (m_eGeomOp == GEOMOP_SEGMENTIZE)
+        {
+            if (m_dfGeomOpParam > 0)
+                poDstGeometry->segmentize(m_dfGeomOpParam);
+        }
+        else if (m_eGeomOp == GEOMOP_SIMPLIFY_PRESERVE_TOPOLOGY)
+        {
+            if (m_dfGeomOpParam > 0)
+            {
+                OGRGeometry* poNewGeom = poDstGeometry->SimplifyPreserveTopology(m_dfGeomOpParam);
+                if (poNewGeom)
+                {
+                    delete poDstGeometry;
+                    poDstGeometry = poNewGeom;
+                }
+            }
+        }
 
-        if( psInfo->nFeaturesRead == 0 || psInfo->bPerFeatureCT )
+        if (m_poClipSrc)
         {
-            if( !SetupCT( psInfo, poSrcLayer, m_bTransform, m_bWrapDateline,
-                          m_osDateLineOffset, m_poUserSourceSRS,
-                          poFeature, poOutputSRS, m_poGCPCoordTrans) )
+            OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipSrc);
+            delete poDstGeometry;
+            if (poClipped == NULL || poClipped->IsEmpty())
             {
-                OGRFeature::DestroyFeature( poFeature );
-                return false;
+                delete poClipped;
+                OGRFeature::DestroyFeature( poDstFeature );
+                return;
             }
+            poDstGeometry = poClipped;
         }
 
-        psInfo->nFeaturesRead ++;
+        OGRCoordinateTransformation* poCT = papoCT[iGeom];
+        if( !m_bTransform )
+            poCT = m_poGCPCoordTrans;
+        char** papszTransformOptions = psInfo->papapszTransformOptions[iGeom];
 
-        int nParts = 0;
-        int nIters = 1;
-        if (bExplodeCollections)
+        if( poCT != NULL || papszTransformOptions != NULL)
         {
-            OGRGeometry* poSrcGeometry;
-            if( psInfo->iRequestedSrcGeomField >= 0 )
-                poSrcGeometry = poFeature->GetGeomFieldRef(
-                                        psInfo->iRequestedSrcGeomField);
-            else
-                poSrcGeometry = poFeature->GetGeometryRef();
-            if (poSrcGeometry &&
-                OGR_GT_IsSubClassOf(poSrcGeometry->getGeometryType(), wkbGeometryCollection) )
+            OGRGeometry* poReprojectedGeom =
+                OGRGeometryFactory::transformWithOptions(poDstGeometry, poCT, papszTransformOptions);
+            if( poReprojectedGeom == NULL )
             {
-                nParts = ((OGRGeometryCollection*)poSrcGeometry)->getNumGeometries();
-                nIters = nParts;
-                if (nIters == 0)
-                    nIters = 1;
+                sPart.nReprojectFailures ++;
+                if( !psOptions->bSkipFailures )
+                {
+                    OGRFeature::DestroyFeature( poDstFeature );
+                    delete poDstGeometry;
+                    return;
+                }
             }
+
+            delete poDstGeometry;
+            poDstGeometry = poReprojectedGeom;
+        }
+        else if (poOutputSRS != NULL)
+        {
+            poDstGeometry->assignSpatialReference(poOutputSRS);
         }
 
-        for(int iPart = 0; iPart < nIters; iPart++)
+        if (m_poClipDst)
         {
-            if( psOptions->nLayerTransaction &&
-                ++nFeaturesInTransaction == psOptions->nGroupTransactions )
+            if( poDstGeometry == NULL )
             {
-                if( poDstLayer->CommitTransaction() == OGRERR_FAILURE ||
-                    poDstLayer->StartTransaction() == OGRERR_FAILURE )
-                {
-                    OGRFeature::DestroyFeature( poFeature );
+                OGRFeature::DestroyFeature( poDstFeature );
+                return;
+            }
+
+            OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipDst);
+            delete poDstGeometry;
+            if (poClipped == NULL || poClipped->IsEmpty())
+            {
+                delete poClipped;
+                OGRFeature::DestroyFeature( poDstFeature );
+                return;
+            }
+
+            poDstGeometry = poClipped;
+        }
+
+        if( eGType != GEOMTYPE_UNCHANGED )
+        {
+            poDstGeometry = OGRGeometryFactory::forceTo(
+                    poDstGeometry, (OGRwkbGeometryType)eGType);
+        }
+        else if( m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI ||
+                 m_eGeomTypeConversion == GTC_CONVERT_TO_LINEAR ||
+                 m_eGeomTypeConversion == GTC_CONVERT_TO_CURVE )
+        {
+            if( poDstGeometry != NULL )
+            {
+                OGRwkbGeometryType eTargetType = poDstGeometry->getGeometryType();
+                eTargetType = ConvertType(m_eGeomTypeConversion, eTargetType);
+                poDstGeometry = OGRGeometryFactory::forceTo(poDstGeometry, eTargetType);
+            }
+        }
+
+        poDstFeature->SetGeomFieldDirectly(iGeom, poDstGeometry);
+    }
+
+    sPart.poDstFeature = poDstFeature;
+}
+
+/************************************************************************/
+/*                  LayerTranslator::StepTransaction()                  */
+/************************************************************************/
+
+/* Account for one more feature to write, and commit the current */
+/* transaction and start a new one when -gt features have been written. */
+bool LayerTranslator::StepTransaction( TargetLayerInfo* psInfo,
+                                       int& nFeaturesInTransaction,
+                                       GIntBig& nTotalEventsDone,
+                                       GDALVectorTranslateOptions *psOptions )
+{
+    OGRLayer    *poDstLayer = psInfo->poDstLayer;
+
+    if( psOptions->nLayerTransaction &&
+        ++nFeaturesInTransaction == psOptions->nGroupTransactions )
+    {
+        if( poDstLayer->CommitTransaction() == OGRERR_FAILURE ||
+            poDstLayer->StartTransaction() == OGRERR_FAILURE )
+        {
+            return false;
+        }
+        nFeaturesInTransaction = 0;
+    }
+    else if( !psOptions->nLayerTransaction &&
+             psOptions->nGroupTransactions >= 0 &&
+             ++nTotalEventsDone >= psOptions->nGroupTransactions )
+    {
+        if( m_poODS->CommitTransaction() == OGRERR_FAILURE ||
+                m_poODS->StartTransaction(psOptions->bForceTransaction) == OGRERR_FAILURE )
+        {
+            return false;
+        }
+        nTotalEventsDone = 0;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                     LayerTranslator::WritePart()                     */
+/************************************************************************/
+
+/* Report the failures recorded by TranslatePart() and write the target */
+/* feature, whose ownership is taken. Returns false if the translation */
+/* must be stopped. */
+bool LayerTranslator::WritePart( OGRFeature* poFeature,
+                                 TargetLayerInfo* psInfo,
+                                 TranslatedPart& sPart,
+                                 GIntBig& nFeaturesWritten,
+                                 GDALVectorTranslateOptions *psOptions )
+{
+    OGRLayer    *poSrcLayer = psInfo->poSrcLayer;
+    OGRLayer    *poDstLayer = psInfo->poDstLayer;
+    const bool bPreserveFID = psInfo->bPreserveFID;
+    OGRFeature  *poDstFeature = sPart.poDstFeature;
+    sPart.poDstFeature = NULL;
+
+    if( sPart.bSetFromFailed )
+    {
+        if( psOptions->nGroupTransactions )
+        {
+            if( psOptions->nLayerTransaction )
+            {
+                if( poDstLayer->CommitTransaction() != OGRERR_NONE )
                     return false;
-                }
-                nFeaturesInTransaction = 0;
             }
-            else if( !psOptions->nLayerTransaction &&
-                     psOptions->nGroupTransactions >= 0 &&
-                     ++nTotalEventsDone >= psOptions->nGroupTransactions )
+        }
+
+        CPLError( CE_Failure, CPLE_AppDefined,
+                "Unable to translate feature " CPL_FRMT_GIB " from layer %s.",
+                poFeature->GetFID(), poSrcLayer->GetName() );
+        return false;
+    }
+
+    for( int i = 0; i < sPart.nReprojectFailures; i++ )
+    {
+        if( psOptions->nGroupTransactions )
+        {
+            if( psOptions->nLayerTransaction )
             {
-                if( m_poODS->CommitTransaction() == OGRERR_FAILURE ||
-                        m_poODS->StartTransaction(psOptions->bForceTransaction) == OGRERR_FAILURE )
+                if( poDstLayer->CommitTransaction() != OGRERR_NONE &&
+                    !psOptions->bSkipFailures )
                 {
-                    OGRFeature::DestroyFeature( poFeature );
+                    OGRFeature::DestroyFeature( poDstFeature );
                     return false;
                 }
-                nTotalEventsDone = 0;
             }
+        }
 
-            CPLErrorReset();
-            poDstFeature = OGRFeature::CreateFeature( poDstLayer->GetLayerDefn() );
+        CPLError( CE_Failure, CPLE_AppDefined, "Failed to reproject feature " CPL_FRMT_GIB " (geometry probably out of source or destination SRS).",
+                  poFeature->GetFID() );
+        if( !psOptions->bSkipFailures )
+        {
+            OGRFeature::DestroyFeature( poDstFeature );
+            return false;
+        }
+    }
+
+    if( poDstFeature == NULL )
+        return true;
+
+    CPLErrorReset();
+    if( poDstLayer->CreateFeature( poDstFeature ) == OGRERR_NONE )
+    {
+        nFeaturesWritten ++;
+        if( (bPreserveFID && poDstFeature->GetFID() != poFeature->GetFID()) ||
+            (!bPreserveFID && psInfo->iSrcFIDField >= 0 && poFeature->IsFieldSetAndNotNull(psInfo->iSrcFIDField) &&
+             poDstFeature->GetFID() != poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField)) )
+        {
+            CPLError( CE_Warning, CPLE_AppDefined,
+                      "Feature id not preserved");
+        }
+    }
+    else if( !psOptions->bSkipFailures )
+    {
+        if( psOptions->nGroupTransactions )
+        {
+            if( psOptions->nLayerTransaction )
+                poDstLayer->RollbackTransaction();
+        }
+
+        CPLError( CE_Failure, CPLE_AppDefined,
+                "Unable to write feature " CPL_FRMT_GIB " from layer %s.",
+                poFeature->GetFID(), poSrcLayer->GetName() );
 
-            /* Optimization to avoid duplicating the source geometry in the */
-            /* target feature : we steal it from the source feature for now... */
-            OGRGeometry* poStolenGeometry = NULL;
-            if( !bExplodeCollections && nSrcGeomFieldCount == 1 &&
-                nDstGeomFieldCount == 1 )
+        OGRFeature::DestroyFeature( poDstFeature );
+        return false;
+    }
+    else
+    {
+        CPLDebug( "GDALVectorTranslate", "Unable to write feature " CPL_FRMT_GIB " into layer %s.",
+                   poFeature->GetFID(), poSrcLayer->GetName() );
+        if( psOptions->nGroupTransactions )
+        {
+            if( psOptions->nLayerTransaction )
             {
-                poStolenGeometry = poFeature->StealGeometry();
+                poDstLayer->RollbackTransaction();
+                CPL_IGNORE_RET_VAL(poDstLayer->StartTransaction());
             }
-            else if( !bExplodeCollections &&
-                     psInfo->iRequestedSrcGeomField >= 0 )
+            else
             {
-                poStolenGeometry = poFeature->StealGeometry(
-                    psInfo->iRequestedSrcGeomField);
+                m_poODS->RollbackTransaction();
+                m_poODS->StartTransaction(psOptions->bForceTransaction);
             }
+        }
+    }
+
+    OGRFeature::DestroyFeature( poDstFeature );
+    return true;
+}
+
+/************************************************************************/
+/*                    Multi-threaded layer translation                  */
+/*                                                                      */
+/*      With -multi, a reader thread reads batches of source features  */
+/*      that are translated by a pool of worker threads, while the     */
+/*      calling thread writes the translated batches in reading order. */
+/*      The number of batches in flight is bounded, so that memory     */
+/*      usage does not depend on the relative speed of the stages.     */
+/************************************************************************/
+
+typedef struct
+{
+    OGRFeature                                  *poSrcFeature;
+    std::vector<LayerTranslator::TranslatedPart> asParts;
+} TranslatedFeature;
+
+struct TranslationPipeline;
+
+typedef struct
+{
+    TranslationPipeline            *poPipeline;
+    std::vector<TranslatedFeature>  asFeatures;
+    bool                            bTranslated;
+} TranslationBatch;
+
+struct TranslationPipeline
+{
+    const LayerTranslator        *poTranslator;
+    TargetLayerInfo              *psInfo;
+    OGRSpatialReference          *poOutputSRS;
+    GDALVectorTranslateOptions   *psOptions;
+    OGRFeature                   *poFirstFeature;
+    size_t                        nBatchSize;
+    size_t                        nMaxBatches;
+
+    CPLWorkerThreadPool           oPool;
+    CPLMutex                     *hMutex;
+    CPLCond                      *hCond;
+    std::deque<TranslationBatch*> apoBatches; /* in reading order */
+    bool                          bReaderDone;
+    bool                          bStop;
+
+    /* Coordinate transformations are not thread-safe: each worker uses */
+    /* its own copy of psInfo->papoCT, taken from this free-list. */
+    std::vector<OGRCoordinateTransformation**> apapoCT;
+    std::vector<OGRCoordinateTransformation**> apapoFreeCT;
+};
 
-            if( poDstFeature->SetFrom( poFeature, panMap, TRUE ) != OGRERR_NONE )
+static void FreeTranslationBatch( TranslationBatch* psBatch )
+{
+    for( size_t i = 0; i < psBatch->asFeatures.size(); i++ )
+    {
+        TranslatedFeature& sFeature = psBatch->asFeatures[i];
+        for( size_t j = 0; j < sFeature.asParts.size(); j++ )
+            OGRFeature::DestroyFeature( sFeature.asParts[j].poDstFeature );
+        OGRFeature::DestroyFeature( sFeature.poSrcFeature );
+    }
+    delete psBatch;
+}
+
+/************************************************************************/
+/*                       TranslationWorkerFunc()                        */
+/************************************************************************/
+
+static void TranslationWorkerFunc( void* pData )
+{
+    TranslationBatch* psBatch = static_cast<TranslationBatch*>(pData);
+    TranslationPipeline* psPipeline = psBatch->poPipeline;
+
+    OGRCoordinateTransformation** papoCT = NULL;
+    bool bStop;
+    {
+        CPLMutexHolderD(&psPipeline->hMutex);
+        bStop = psPipeline->bStop;
+        papoCT = psPipeline->apapoFreeCT.back();
+        psPipeline->apapoFreeCT.pop_back();
+    }
+
+    for( size_t i = 0; !bStop && i < psBatch->asFeatures.size(); i++ )
+    {
+        TranslatedFeature& sFeature = psBatch->asFeatures[i];
+        int nParts = 0;
+        const int nIters = psPipeline->poTranslator->GetPartCount(
+            sFeature.poSrcFeature, psPipeline->psInfo, nParts);
+        sFeature.asParts.resize(nIters);
+        for( int iPart = 0; iPart < nIters; iPart++ )
+        {
+            psPipeline->poTranslator->TranslatePart(
+                sFeature.poSrcFeature, psPipeline->psInfo, iPart, nParts,
+                papoCT, psPipeline->poOutputSRS, psPipeline->psOptions,
+                sFeature.asParts[iPart]);
+        }
+    }
+
+    CPLMutexHolderD(&psPipeline->hMutex);
+    psPipeline->apapoFreeCT.push_back(papoCT);
+    psBatch->bTranslated = true;
+    CPLCondBroadcast(psPipeline->hCond);
+}
+
+/************************************************************************/
+/*                       TranslationReaderFunc()                        */
+/************************************************************************/
+
+static void TranslationReaderFunc( void* pData )
+{
+    TranslationPipeline* psPipeline = static_cast<TranslationPipeline*>(pData);
+    TargetLayerInfo* psInfo = psPipeline->psInfo;
+    const GIntBig nLimit = psPipeline->poTranslator->m_nLimit;
+    OGRFeature* poFeature = psPipeline->poFirstFeature;
+
+    bool bEOF = false;
+    while( !bEOF )
+    {
+        TranslationBatch* psBatch = new TranslationBatch;
+        psBatch->poPipeline = psPipeline;
+        psBatch->bTranslated = false;
+        psBatch->asFeatures.reserve(psPipeline->nBatchSize);
+        while( psBatch->asFeatures.size() < psPipeline->nBatchSize )
+        {
+            if( poFeature == NULL )
             {
-                if( psOptions->nGroupTransactions )
+                if( nLimit >= 0 && psInfo->nFeaturesRead >= nLimit )
+                    poFeature = NULL;
+                else
+                    poFeature = psInfo->poSrcLayer->GetNextFeature();
+                if( poFeature == NULL )
                 {
-                    if( psOptions->nLayerTransaction )
-                    {
-                        if( poDstLayer->CommitTransaction() != OGRERR_NONE )
-                        {
-                            OGRFeature::DestroyFeature( poFeature );
-                            OGRFeature::DestroyFeature( poDstFeature );
-                            OGRGeometryFactory::destroyGeometry( poStolenGeometry );
-                            return false;
-                        }
-                    }
+                    bEOF = true;
+                    break;
                 }
+                psInfo->nFeaturesRead ++;
+            }
+            TranslatedFeature sFeature;
+            sFeature.poSrcFeature = poFeature;
+            psBatch->asFeatures.push_back(sFeature);
+            poFeature = NULL;
+        }
 
-                CPLError( CE_Failure, CPLE_AppDefined,
-                        "Unable to translate feature " CPL_FRMT_GIB " from layer %s.",
-                        poFeature->GetFID(), poSrcLayer->GetName() );
+        if( psBatch->asFeatures.empty() )
+        {
+            delete psBatch;
+            break;
+        }
 
-                OGRFeature::DestroyFeature( poFeature );
-                OGRFeature::DestroyFeature( poDstFeature );
-                OGRGeometryFactory::destroyGeometry( poStolenGeometry );
-                return false;
+        {
+            CPLMutexHolderD(&psPipeline->hMutex);
+            while( !psPipeline->bStop &&
+                   psPipeline->apoBatches.size() >= psPipeline->nMaxBatches )
+            {
+                CPLCondWait(psPipeline->hCond, psPipeline->hMutex);
             }
-
-            /* ... and now we can attach the stolen geometry */
-            if( poStolenGeometry )
+            if( psPipeline->bStop )
             {
-                poDstFeature->SetGeometryDirectly(poStolenGeometry);
+                FreeTranslationBatch(psBatch);
+                break;
             }
+            psPipeline->apoBatches.push_back(psBatch);
+            CPLCondBroadcast(psPipeline->hCond);
+        }
+        psPipeline->oPool.SubmitJob(TranslationWorkerFunc, psBatch);
+    }
 
-            if( bPreserveFID )
-                poDstFeature->SetFID( poFeature->GetFID() );
-            else if( psInfo->iSrcFIDField >= 0 &&
-                     poFeature->IsFieldSetAndNotNull(psInfo->iSrcFIDField))
-                poDstFeature->SetFID( poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField) );
+    CPLMutexHolderD(&psPipeline->hMutex);
+    psPipeline->bReaderDone = true;
+    CPLCondBroadcast(psPipeline->hCond);
+}
 
-            /* Erase native data if asked explicitly */
-            if( !m_bNativeData )
-            {
-                poDstFeature->SetNativeData(NULL);
-                poDstFeature->SetNativeMediaType(NULL);
-            }
+/************************************************************************/
+/*              LayerTranslator::TranslateMultiThreaded()               */
+/************************************************************************/
 
-            for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom ++ )
-            {
-                OGRGeometry* poDstGeometry = poDstFeature->StealGeometry(iGeom);
-                if (poDstGeometry == NULL)
-                    continue;
+/* Translate the remaining features of the source layer, starting with */
+/* poFirstFeature. bStarted is set to false, and poFirstFeature is not */
+/* taken, if the threads could not be set up. */
+bool LayerTranslator::TranslateMultiThreaded( OGRFeature* poFirstFeature,
+                                              TargetLayerInfo* psInfo,
+                                              OGRSpatialReference* poOutputSRS,
+                                              GIntBig nCountLayerFeatures,
+                                              GIntBig* pnReadFeatureCount,
+                                              GIntBig& nCount,
+                                              int& nFeaturesInTransaction,
+                                              GIntBig& nTotalEventsDone,
+                                              GIntBig& nFeaturesWritten,
+                                              GDALProgressFunc pfnProgress,
+                                              void *pProgressArg,
+                                              GDALVectorTranslateOptions *psOptions,
+                                              bool& bStarted,
+                                              bool& bGoOn )
+{
+    bStarted = false;
+    bGoOn = true;
+
+    TranslationPipeline sPipeline;
+    sPipeline.poTranslator = this;
+    sPipeline.psInfo = psInfo;
+    sPipeline.poOutputSRS = poOutputSRS;
+    sPipeline.psOptions = psOptions;
+    sPipeline.poFirstFeature = poFirstFeature;
+    sPipeline.nBatchSize = 256;
+    sPipeline.nMaxBatches = 2 * m_nThreads + 2;
+    sPipeline.hMutex = NULL;
+    sPipeline.hCond = NULL;
+    sPipeline.bReaderDone = false;
+    sPipeline.bStop = false;
+
+    const int nDstGeomFieldCount =
+        psInfo->poDstLayer->GetLayerDefn()->GetGeomFieldCount();
+    bool bOK = true;
+    for( int iThread = 0; bOK && iThread < m_nThreads; iThread++ )
+    {
+        OGRCoordinateTransformation** papoCT =
+            static_cast<OGRCoordinateTransformation**>(
+                CPLCalloc(sizeof(OGRCoordinateTransformation*),
+                          nDstGeomFieldCount));
+        sPipeline.apapoCT.push_back(papoCT);
+        for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom++ )
+        {
+            OGRCoordinateTransformation* poCT = psInfo->papoCT[iGeom];
+            if( poCT == NULL )
+                continue;
+            papoCT[iGeom] = OGRCreateCoordinateTransformation(
+                poCT->GetSourceCS(), poCT->GetTargetCS());
+            if( papoCT[iGeom] == NULL )
+                bOK = false;
+        }
+    }
+    sPipeline.apapoFreeCT = sPipeline.apapoCT;
 
-                if (nParts > 0)
-                {
-                    /* For -explodecollections, extract the iPart(th) of the geometry */
-                    OGRGeometry* poPart = ((OGRGeometryCollection*)poDstGeometry)->getGeometryRef(iPart);
-                    ((OGRGeometryCollection*)poDstGeometry)->removeGeometry(iPart, FALSE);
-                    delete poDstGeometry;
-                    poDstGeometry = poPart;
-                }
+    CPLJoinableThread* hReaderThread = NULL;
+    if( bOK )
+        bOK = sPipeline.oPool.Setup(m_nThreads, NULL, NULL);
+    if( bOK )
+    {
+        sPipeline.hCond = CPLCreateCond();
+        sPipeline.hMutex = CPLCreateMutex();
+        if( sPipeline.hMutex != NULL )
+            CPLReleaseMutex(sPipeline.hMutex);
+        bOK = sPipeline.hCond != NULL && sPipeline.hMutex != NULL;
+    }
+    if( bOK )
+    {
+        hReaderThread = CPLCreateJoinableThread(TranslationReaderFunc,
+                                                &sPipeline);
+        bOK = hReaderThread != NULL;
+    }
 
-                if (iSrcZField != -1)
-                {
-                    SetZ(poDstGeometry, poFeature->GetFieldAsDouble(iSrcZField));
-                    /* This will correct the coordinate dimension to 3 */
-                    OGRGeometry* poDupGeometry = poDstGeometry->clone();
-                    delete poDstGeometry;
-                    poDstGeometry = poDupGeometry;
-                }
+    bool bRet = true;
+    if( bOK )
+    {
+        bStarted = true;
+        CPLDebug("GDALVectorTranslate",
+                 "Using %d threads to translate layer %s",
+                 m_nThreads, psInfo->poDstLayer->GetName());
 
-                if (m_nCoordDim == 2 || m_nCoordDim == 3)
-                    poDstGeometry->setCoordinateDimension( m_nCoordDim );
-                else if (m_nCoordDim == 4)
-                {
-                    poDstGeometry->set3D( TRUE );
-                    poDstGeometry->setMeasured( TRUE );
-                }
-                else if (m_nCoordDim == COORD_DIM_XYM)
+        while( bRet && bGoOn )
+        {
+            TranslationBatch* psBatch = NULL;
+            {
+                CPLMutexHolderD(&sPipeline.hMutex);
+                while( !(sPipeline.apoBatches.empty() && sPipeline.bReaderDone) &&
+                       !(!sPipeline.apoBatches.empty() &&
+                         sPipeline.apoBatches.front()->bTranslated) )
                 {
-                    poDstGeometry->set3D( FALSE );
-                    poDstGeometry->setMeasured( TRUE );
+                    CPLCondWait(sPipeline.hCond, sPipeline.hMutex);
                 }
-                else if ( m_nCoordDim == COORD_DIM_LAYER_DIM )
+                if( !sPipeline.apoBatches.empty() )
                 {
-                    const OGRwkbGeometryType eDstLayerGeomType =
-                      poDstLayer->GetLayerDefn()->GetGeomFieldDefn(iGeom)->GetType();
-                    poDstGeometry->set3D( wkbHasZ(eDstLayerGeomType) );
-                    poDstGeometry->setMeasured( wkbHasM(eDstLayerGeomType) );
+                    psBatch = sPipeline.apoBatches.front();
+                    sPipeline.apoBatches.pop_front();
+                    CPLCondBroadcast(sPipeline.hCond);
                 }
+            }
+            if( psBatch == NULL )
+                break;
 
-                if (m_eGeomOp == GEOMOP_SEGMENTIZE)
-                {
-                    if (m_dfGeomOpParam > 0)
-                        poDstGeometry->segmentize(m_dfGeomOpParam);
-                }
-                else if (m_eGeomOp == GEOMOP_SIMPLIFY_PRESERVE_TOPOLOGY)
+            for( size_t i = 0; bRet && bGoOn && i < psBatch->asFeatures.size(); i++ )
+            {
+                TranslatedFeature& sFeature = psBatch->asFeatures[i];
+                for( size_t iPart = 0; iPart < sFeature.asParts.size(); iPart++ )
                 {
-                    if (m_dfGeomOpParam > 0)
+                    if( !StepTransaction( psInfo, nFeaturesInTransaction,
+                                          nTotalEventsDone, psOptions ) ||
+                        !WritePart( sFeature.poSrcFeature, psInfo,
+                                    sFeature.asParts[iPart],
+                                    nFeaturesWritten, psOptions ) )
                     {
-                        OGRGeometry* poNewGeom = poDstGeometry->SimplifyPreserveTopology(m_dfGeomOpParam);
-                        if (poNewGeom)
-                        {
-                            delete poDstGeometry;
-                            poDstGeometry = poNewGeom;
-                        }
+                        bRet = false;
+                        break;
                     }
                 }
+                if( !bRet )
+                    break;
+
+                OGRFeature::DestroyFeature( sFeature.poSrcFeature );
+                sFeature.poSrcFeature = NULL;
 
-                if (m_poClipSrc)
+                /* Report progress */
+                nCount ++;
+                if (pfnProgress)
                 {
-                    OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipSrc);
-                    delete poDstGeometry;
-                    if (poClipped == NULL || poClipped->IsEmpty())
-                    {
-                        delete poClipped;
-                        goto end_loop;
-                    }
-                    poDstGeometry = poClipped;
+                    bGoOn = pfnProgress(nCountLayerFeatures ? nCount * 1.0 / nCountLayerFeatures: 1.0, "", pProgressArg) != FALSE;
                 }
+                if( bGoOn && pnReadFeatureCount )
+                    *pnReadFeatureCount = nCount;
+            }
 
-                OGRCoordinateTransformation* poCT = psInfo->papoCT[iGeom];
-                if( !m_bTransform )
-                    poCT = m_poGCPCoordTrans;
-                char** papszTransformOptions = psInfo->papapszTransformOptions[iGeom];
+            FreeTranslationBatch(psBatch);
+        }
 
-                if( poCT != NULL || papszTransformOptions != NULL)
-                {
-                    OGRGeometry* poReprojectedGeom =
-                        OGRGeometryFactory::transformWithOptions(poDstGeometry, poCT, papszTransformOptions);
-                    if( poReprojectedGeom == NULL )
-                    {
-                        if( psOptions->nGroupTransactions )
-                        {
-                            if( psOptions->nLayerTransaction )
-                            {
-                                if( poDstLayer->CommitTransaction() != OGRERR_NONE &&
-                                    !psOptions->bSkipFailures )
-                                {
-                                    OGRFeature::DestroyFeature( poFeature );
-                                    OGRFeature::DestroyFeature( poDstFeature );
-                                    delete poDstGeometry;
-                                    return false;
-                                }
-                            }
-                        }
+        {
+            CPLMutexHolderD(&sPipeline.hMutex);
+            sPipeline.bStop = true;
+            CPLCondBroadcast(sPipeline.hCond);
+        }
+        CPLJoinThread(hReaderThread);
+        sPipeline.oPool.WaitCompletion();
+        for( size_t i = 0; i < sPipeline.apoBatches.size(); i++ )
+            FreeTranslationBatch(sPipeline.apoBatches[i]);
+    }
 
-                        CPLError( CE_Failure, CPLE_AppDefined, "Failed to reproject feature " CPL_FRMT_GIB " (geometry probably out of source or destination SRS).",
-                                  poFeature->GetFID() );
-                        if( !psOptions->bSkipFailures )
-                        {
-                            OGRFeature::DestroyFeature( poFeature );
-                            OGRFeature::DestroyFeature( poDstFeature );
-                            delete poDstGeometry;
-                            return false;
-                        }
-                    }
+    for( size_t i = 0; i < sPipeline.apapoCT.size(); i++ )
+    {
+        for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom++ )
+            delete sPipeline.apapoCT[i][iGeom];
+        CPLFree(sPipeline.apapoCT[i]);
+    }
+    if( sPipeline.hCond != NULL )
+        CPLDestroyCond(sPipeline.hCond);
+    if( sPipeline.hMutex != NULL )
+        CPLDestroyMutex(sPipeline.hMutex);
 
-                    delete poDstGeometry;
-                    poDstGeometry = poReprojectedGeom;
-                }
-                else if (poOutputSRS != NULL)
-                {
-                    poDstGeometry->assignSpatialReference(poOutputSRS);
-                }
+    return bRet;
+}
 
-                if (m_poClipDst)
-                {
-                    if( poDstGeometry == NULL )
-                        goto end_loop;
+/************************************************************************/
+/*                     LayerTranslator::Translate()                     */
+/************************************************************************/
 
-                    OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipDst);
-                    delete poDstGeometry;
-                    if (poClipped == NULL || poClipped->IsEmpty())
-                    {
-                        delete poClipped;
-                        goto end_loop;
-                    }
+int LayerTranslator::Translate( OGRFeature* poFeatureIn,
+                                TargetLayerInfo* psInfo,
+                                GIntBig nCountLayerFeatures,
+                                GIntBig* pnReadFeatureCount,
+                                GIntBig& nTotalEventsDone,
+                                GDALProgressFunc pfnProgress,
+                                void *pProgressArg,
+                                GDALVectorTranslateOptions *psOptions )
+{
+    OGRLayer    *poSrcLayer;
+    OGRLayer    *poDstLayer;
+    OGRSpatialReference* poOutputSRS = m_poOutputSRS;
 
-                    poDstGeometry = poClipped;
-                }
+    poSrcLayer = psInfo->poSrcLayer;
+    poDstLayer = psInfo->poDstLayer;
+    const int nSrcGeomFieldCount = poSrcLayer->GetLayerDefn()->GetGeomFieldCount();
 
-                if( eGType != GEOMTYPE_UNCHANGED )
-                {
-                    poDstGeometry = OGRGeometryFactory::forceTo(
-                            poDstGeometry, (OGRwkbGeometryType)eGType);
-                }
-                else if( m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI ||
-                         m_eGeomTypeConversion == GTC_CONVERT_TO_LINEAR ||
-                         m_eGeomTypeConversion == GTC_CONVERT_TO_CURVE )
-                {
-                    if( poDstGeometry != NULL )
-                    {
-                        OGRwkbGeometryType eTargetType = poDstGeometry->getGeometryType();
-                        eTargetType = ConvertType(m_eGeomTypeConversion, eTargetType);
-                        poDstGeometry = OGRGeometryFactory::forceTo(poDstGeometry, eTargetType);
-                    }
-                }
+    if( poOutputSRS == NULL && !m_bNullifyOutputSRS )
+    {
+        if( nSrcGeomFieldCount == 1 )
+        {
+            poOutputSRS = poSrcLayer->GetSpatialRef();
+        }
+        else if( psInfo->iRequestedSrcGeomField > 0 )
+        {
+            poOutputSRS = poSrcLayer->GetLayerDefn()->GetGeomFieldDefn(
+                psInfo->iRequestedSrcGeomField)->GetSpatialRef();
+        }
+    }
+
+    /* Features are translated by several threads only if each of them */
+    /* can use its own copy of the coordinate transformations. */
+    const bool bMultiThread =
+        m_nThreads > 1 && poFeatureIn == NULL &&
+        psOptions->nFIDToFetch == OGRNullFID &&
+        m_poGCPCoordTrans == NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Transfer features.                                              */
+/* -------------------------------------------------------------------- */
+    OGRFeature  *poFeature;
+    int         nFeaturesInTransaction = 0;
+    GIntBig      nCount = 0; /* written + failed */
+    GIntBig      nFeaturesWritten = 0;
+
+    if( psOptions->nGroupTransactions )
+    {
+        if( psOptions->nLayerTransaction )
+        {
+            if( poDstLayer->StartTransaction() == OGRERR_FAILURE )
+                return false;
+        }
+    }
 
-                poDstFeature->SetGeomFieldDirectly(iGeom, poDstGeometry);
+    bool bRet = true;
+    while( true )
+    {
+        if( m_nLimit >= 0 && psInfo->nFeaturesRead >= m_nLimit )
+        {
+            break;
+        }
+
+        if( poFeatureIn != NULL )
+            poFeature = poFeatureIn;
+        else if( psOptions->nFIDToFetch != OGRNullFID )
+            poFeature = poSrcLayer->GetFeature(psOptions->nFIDToFetch);
+        else
+            poFeature = poSrcLayer->GetNextFeature();
+
+        if( poFeature == NULL )
+            break;
+
+        if( psInfo->nFeaturesRead == 0 || psInfo->bPerFeatureCT )
+        {
+            if( !SetupCT( psInfo, poSrcLayer, m_bTransform, m_bWrapDateline,
+                          m_osDateLineOffset, m_poUserSourceSRS,
+                          poFeature, poOutputSRS, m_poGCPCoordTrans) )
+            {
+                OGRFeature::DestroyFeature( poFeature );
+                return false;
             }
+        }
 
-            CPLErrorReset();
-            if( poDstLayer->CreateFeature( poDstFeature ) == OGRERR_NONE )
+        psInfo->nFeaturesRead ++;
+
+        if( bMultiThread && nCount == 0 && !psInfo->bPerFeatureCT )
+        {
+            bool bStarted = false;
+            bool bGoOn = true;
+            if( !TranslateMultiThreaded( poFeature, psInfo, poOutputSRS,
+                                         nCountLayerFeatures,
+                                         pnReadFeatureCount, nCount,
+                                         nFeaturesInTransaction,
+                                         nTotalEventsDone, nFeaturesWritten,
+                                         pfnProgress, pProgressArg,
+                                         psOptions, bStarted, bGoOn ) )
             {
-                nFeaturesWritten ++;
-                if( (bPreserveFID && poDstFeature->GetFID() != poFeature->GetFID()) ||
-                    (!bPreserveFID && psInfo->iSrcFIDField >= 0 && poFeature->IsFieldSetAndNotNull(psInfo->iSrcFIDField) &&
-                     poDstFeature->GetFID() != poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField)) )
-                {
-                    CPLError( CE_Warning, CPLE_AppDefined,
-                              "Feature id not preserved");
-                }
+                return false;
             }
-            else if( !psOptions->bSkipFailures )
+            if( bStarted )
             {
-                if( psOptions->nGroupTransactions )
-                {
-                    if( psOptions->nLayerTransaction )
-                        poDstLayer->RollbackTransaction();
-                }
+                bRet = bGoOn;
+                break;
+            }
+        }
 
-                CPLError( CE_Failure, CPLE_AppDefined,
-                        "Unable to write feature " CPL_FRMT_GIB " from layer %s.",
-                        poFeature->GetFID(), poSrcLayer->GetName() );
+        int nParts = 0;
+        const int nIters = GetPartCount(poFeature, psInfo, nParts);
 
+        for(int iPart = 0; iPart < nIters; iPart++)
+        {
+            if( !StepTransaction( psInfo, nFeaturesInTransaction,
+                                  nTotalEventsDone, psOptions ) )
+            {
                 OGRFeature::DestroyFeature( poFeature );
-                OGRFeature::DestroyFeature( poDstFeature );
                 return false;
             }
-            else
+
+            CPLErrorReset();
+            TranslatedPart sPart;
+            TranslatePart( poFeature, psInfo, iPart, nParts, psInfo->papoCT,
+                           poOutputSRS, psOptions, sPart );
+            if( !WritePart( poFeature, psInfo, sPart, nFeaturesWritten,
+                            psOptions ) )
             {
-                CPLDebug( "GDALVectorTranslate", "Unable to write feature " CPL_FRMT_GIB " into layer %s.",
-                           poFeature->GetFID(), poSrcLayer->GetName() );
-                if( psOptions->nGroupTransactions )
-                {
-                    if( psOptions->nLayerTransaction )
-                    {
-                        poDstLayer->RollbackTransaction();
-                        CPL_IGNORE_RET_VAL(poDstLayer->StartTransaction());
-                    }
-                    else
-                    {
-                        m_poODS->RollbackTransaction();
-                        m_poODS->StartTransaction(psOptions->bForceTransaction);
-                    }
-                }
+                OGRFeature::DestroyFeature( poFeature );
+                return false;
             }
-
-end_loop:
-            OGRFeature::DestroyFeature( poDstFeature );
         }
 
         OGRFeature::DestroyFeature( poFeature );
@@ -4739,6 +5299,7 @@ GDALVectorTranslateOptions *GDALVectorTranslateOptionsNew(char** papszArgv,
     psOptions->hSpatialFilter = NULL;
     psOptions->bNativeData = true;
     psOptions->nLimit = -1;
+    psOptions->bMultiThread = false;
 
     int nArgc = CSLCount(papszArgv);
     for( int i = 0; papszArgv != NULL && i < nArgc; i++ )
@@ -4919,6 +5480,10 @@ GDALVectorTranslateOptions *GDALVectorTranslateOptionsNew(char** papszArgv,
                     psOptions->nGroupTransactions = atoi(papszArgv[i]);
             }
         }
+        else if ( EQUAL(papszArgv[i],"-multi") )
+        {
+            psOptions->bMultiThread = true;
+        }
         else if ( EQUAL(papszArgv[i],"-ds_transaction") )
         {
             psOptions->nLayerTransaction = FALSE;
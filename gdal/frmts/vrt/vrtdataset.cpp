@@ -859,6 +859,18 @@ GDALDataset *VRTDataset::Open( GDALOpenInfo * poOpenInfo )
     return poDS;
 }
 
+/************************************************************************/
+/*                         DestroyParsedTree()                          */
+/************************************************************************/
+
+static void DestroyParsedTree( CPLXMLNode *psTree, CPLXMLArena *psArena )
+{
+    if( psArena != NULL )
+        CPLXMLArenaDestroy( psArena );
+    else
+        CPLDestroyXMLNode( psTree );
+}
+
 /************************************************************************/
 /*                              OpenXML()                               */
 /*                                                                      */
@@ -871,18 +883,27 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
 
 {
  /* -------------------------------------------------------------------- */
- /*      Parse the XML.                                                  */
+ /*      Parse the XML.  The tree is only read by XMLInit(), except      */
+ /*      for warped VRTs that rewrite their SourceDataset in place, so   */
+ /*      it can be held in an arena in the other cases.                  */
  /* -------------------------------------------------------------------- */
-    CPLXMLNode *psTree = CPLParseXMLString( pszXML );
+    const bool bIsWarped = strstr(pszXML, "VRTWarpedDataset") != NULL;
+    CPLXMLArena *psArena = bIsWarped ? NULL : CPLXMLArenaCreate();
+    CPLXMLNode *psTree = psArena != NULL ?
+        CPLParseXMLStringInArena( pszXML, psArena ) :
+        CPLParseXMLString( pszXML );
     if( psTree == NULL )
+    {
+        CPLXMLArenaDestroy( psArena );
         return NULL;
+    }
 
     CPLXMLNode *psRoot = CPLGetXMLNode( psTree, "=VRTDataset" );
     if( psRoot == NULL )
     {
         CPLError( CE_Failure, CPLE_AppDefined,
                   "Missing VRTDataset element." );
-        CPLDestroyXMLNode( psTree );
+        DestroyParsedTree( psTree, psArena );
         return NULL;
     }
 
@@ -897,7 +918,7 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
         CPLError( CE_Failure, CPLE_AppDefined,
                   "Missing one of rasterXSize, rasterYSize or bands on"
                   " VRTDataset." );
-        CPLDestroyXMLNode( psTree );
+        DestroyParsedTree( psTree, psArena );
         return NULL;
     }
 
@@ -910,12 +931,12 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
     if( !bIsPansharpened &&
         !GDALCheckDatasetDimensions( nXSize, nYSize ) )
     {
-        CPLDestroyXMLNode( psTree );
+        DestroyParsedTree( psTree, psArena );
         return NULL;
     }
 
     VRTDataset *poDS = NULL;
-    if( strstr(pszXML,"VRTWarpedDataset") != NULL )
+    if( bIsWarped )
         poDS = new VRTWarpedDataset( nXSize, nYSize );
     else if( bIsPansharpened )
         poDS = new VRTPansharpenedDataset( nXSize, nYSize );
@@ -934,7 +955,7 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
 /* -------------------------------------------------------------------- */
 /*      Try to return a regular handle on the file.                     */
 /* -------------------------------------------------------------------- */
-    CPLDestroyXMLNode( psTree );
+    DestroyParsedTree( psTree, psArena );
 
     return poDS;
 }
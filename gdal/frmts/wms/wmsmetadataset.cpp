@@ -123,19 +123,23 @@ GDALDataset *GDALWMSMetaDataset::DownloadGetCapabilities(GDALOpenInfo *poOpenInf
         return NULL;
     }
 
-    CPLXMLNode* psXML = CPLParseXMLString( (const char*) psResult->pabyData );
+    // The response is only inspected, so parse it in an arena.
+    CPLXMLArena* psArena = CPLXMLArenaCreate();
+    CPLXMLNode* psXML = CPLParseXMLStringInArena(
+                            (const char*) psResult->pabyData, psArena );
     if (psXML == NULL)
     {
         CPLError(CE_Failure, CPLE_AppDefined, "Invalid XML content : %s",
                 psResult->pabyData);
         CPLHTTPDestroyResult(psResult);
+        CPLXMLArenaDestroy(psArena);
         return NULL;
     }
 
     GDALDataset* poRet = AnalyzeGetCapabilities(psXML, osFormat, osTransparent, osPreferredSRS);
 
     CPLHTTPDestroyResult(psResult);
-    CPLDestroyXMLNode( psXML );
+    CPLXMLArenaDestroy(psArena);
 
     return poRet;
 }
@@ -187,19 +191,23 @@ GDALDataset *GDALWMSMetaDataset::DownloadGetTileService(GDALOpenInfo *poOpenInfo
         return NULL;
     }
 
-    CPLXMLNode* psXML = CPLParseXMLString( (const char*) psResult->pabyData );
+    // The response is only inspected, so parse it in an arena.
+    CPLXMLArena* psArena = CPLXMLArenaCreate();
+    CPLXMLNode* psXML = CPLParseXMLStringInArena(
+                            (const char*) psResult->pabyData, psArena );
     if (psXML == NULL)
     {
         CPLError(CE_Failure, CPLE_AppDefined, "Invalid XML content : %s",
                 psResult->pabyData);
         CPLHTTPDestroyResult(psResult);
+        CPLXMLArenaDestroy(psArena);
         return NULL;
     }
 
     GDALDataset* poRet = AnalyzeGetTileService(psXML);
 
     CPLHTTPDestroyResult(psResult);
-    CPLDestroyXMLNode( psXML );
+    CPLXMLArenaDestroy(psArena);
 
     return poRet;
 }
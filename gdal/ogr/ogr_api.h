@@ -294,6 +294,8 @@ typedef void *OGRStyleTableH;
 #endif
 /** Opaque type for a geometry field definition (OGRGeomFieldDefn) */
 typedef struct OGRGeomFieldDefnHS *OGRGeomFieldDefnH;
+/** Opaque type for a feature batch (OGRFeatureBatch) */
+typedef struct OGRFeatureBatchHS *OGRFeatureBatchH;
 
 /* OGRFieldDefn */
 
@@ -484,6 +486,19 @@ void   CPL_DLL OGR_F_FillUnsetWithDefault( OGRFeatureH hFeat,
                                            char** papszOptions );
 int    CPL_DLL OGR_F_Validate( OGRFeatureH, int nValidateFlags, int bEmitError );
 
+/* OGRFeatureBatch */
+
+OGRFeatureBatchH CPL_DLL OGR_FB_Create( void ) CPL_WARN_UNUSED_RESULT;
+void   CPL_DLL OGR_FB_Destroy( OGRFeatureBatchH );
+int    CPL_DLL OGR_FB_GetFeatureCount( OGRFeatureBatchH );
+const GIntBig CPL_DLL *OGR_FB_GetFIDs( OGRFeatureBatchH );
+const GByte CPL_DLL *OGR_FB_GetFieldValidity( OGRFeatureBatchH, int );
+const void CPL_DLL *OGR_FB_GetFieldData( OGRFeatureBatchH, int );
+const GIntBig CPL_DLL *OGR_FB_GetFieldOffsets( OGRFeatureBatchH, int );
+const GByte CPL_DLL *OGR_FB_GetGeomFieldValidity( OGRFeatureBatchH, int );
+const GByte CPL_DLL *OGR_FB_GetGeomFieldData( OGRFeatureBatchH, int );
+const GIntBig CPL_DLL *OGR_FB_GetGeomFieldOffsets( OGRFeatureBatchH, int );
+
 /* -------------------------------------------------------------------- */
 /*      ogrsf_frmts.h                                                   */
 /* -------------------------------------------------------------------- */
@@ -517,6 +532,8 @@ void     CPL_DLL OGR_L_SetSpatialFilterRectEx( OGRLayerH, int iGeomField,
 OGRErr CPL_DLL OGR_L_SetAttributeFilter( OGRLayerH, const char * );
 void   CPL_DLL OGR_L_ResetReading( OGRLayerH );
 OGRFeatureH CPL_DLL OGR_L_GetNextFeature( OGRLayerH ) CPL_WARN_UNUSED_RESULT;
+int    CPL_DLL OGR_L_GetNextFeatureBatch( OGRLayerH, OGRFeatureBatchH,
+                                          int nMaxFeatures );
 OGRErr CPL_DLL OGR_L_SetNextByIndex( OGRLayerH, GIntBig );
 OGRFeatureH CPL_DLL OGR_L_GetFeature( OGRLayerH, GIntBig )  CPL_WARN_UNUSED_RESULT;
 OGRErr CPL_DLL OGR_L_SetFeature( OGRLayerH, OGRFeatureH ) CPL_WARN_UNUSED_RESULT;
@@ -35,6 +35,8 @@
 #include "ogr_featurestyle.h"
 #include "ogr_geometry.h"
 
+#include <vector>
+
 /**
  * \file ogr_feature.h
  *
@@ -287,7 +289,20 @@ class CPL_DLL OGRFeature
     char                *m_pszNativeData;
     char                *m_pszNativeMediaType;
 
+    // Encoded geometries not decoded yet, see SetGeomFieldWKBDirectly().
+    typedef struct
+    {
+        GByte               *pabyData;
+        size_t               nSize;
+        OGRSpatialReference *poSRS;  // if NULL, the one of the field defn
+    } GeomFieldWKB;
+    GeomFieldWKB        *m_pasGeomWKB;
+
     bool                SetFieldInternal( int i, OGRField * puValue );
+    void                DecodeGeomField( int iField );
+    void                ClearGeomFieldWKB( int iField );
+    void                CopyGeomField( int iField, OGRFeature* poSrcFeature,
+                                       int iSrcField );
 
   protected:
 //! @cond Doxygen_Suppress
@@ -320,6 +335,13 @@ class CPL_DLL OGRFeature
     OGRErr              SetGeomFieldDirectly( int iField, OGRGeometry * );
     OGRErr              SetGeomField( int iField, const OGRGeometry * );
 
+    OGRErr              SetGeomFieldWKBDirectly( int iField, GByte* pabyWKB,
+                                                 size_t nWKBSize );
+    OGRErr              SetGeomFieldWKB( int iField, const GByte* pabyWKB,
+                                         size_t nWKBSize );
+    const GByte        *GetGeomFieldWKBRef( int iField,
+                                            size_t* pnWKBSize ) const;
+
     OGRFeature         *Clone() CPL_WARN_UNUSED_RESULT;
     virtual OGRBoolean  Equal( OGRFeature * poFeature );
 
@@ -477,6 +499,114 @@ class CPL_DLL OGRFeature
     CPL_DISALLOW_COPY_ASSIGN(OGRFeature)
 };
 
+/************************************************************************/
+/*                           OGRFeatureBatch                            */
+/************************************************************************/
+
+/**
+ * A batch of features of a layer, stored by columns.
+ *
+ * Instead of one OGRFeature per feature, the values of each field for all
+ * the features of the batch are stored contiguously:
+ * <ul>
+ * <li>OFTInteger: array of int</li>
+ * <li>OFTInteger64: array of GIntBig</li>
+ * <li>OFTReal: array of double</li>
+ * <li>OFTDate, OFTTime, OFTDateTime: array of OGRField, whose Date member
+ *     is set</li>
+ * <li>OFTString, OFTBinary: the values concatenated without terminating nul
+ *     character. The value of the i-th feature spans from the byte offset
+ *     GetFieldOffsets()[i] to GetFieldOffsets()[i+1].</li>
+ * <li>OFTIntegerList, OFTInteger64List, OFTRealList: the elements of the lists
+ *     concatenated, with byte offsets as above.</li>
+ * <li>OFTStringList: the elements of the lists as nul terminated strings
+ *     concatenated, with byte offsets as above.</li>
+ * </ul>
+ * Geometries are stored as concatenated ISO WKB in little endian byte order,
+ * with byte offsets as above.
+ *
+ * A validity bitmap, with the bit i (least significant bit first) of byte i/8
+ * set when the value of the i-th feature is set and not null, is associated
+ * to each field and geometry field. The value of a feature whose bit is not set
+ * is 0 for fixed size types, and empty for other types. Ignored fields
+ * are never set.
+ *
+ * A batch is filled with OGRLayer::GetNextFeatureBatch(). Its buffers are
+ * kept from one call to the next one, so that reading a layer with the same
+ * batch does not cause allocations once the buffers are large enough.
+ *
+ * @since GDAL 2.3
+ */
+
+class CPL_DLL OGRFeatureBatch
+{
+  private:
+    class Column
+    {
+      public:
+        std::vector<GByte>   abyValidity;
+        std::vector<GByte>   abyData;
+        std::vector<GIntBig> anOffsets;
+        size_t               nValueSize;  // 0 for variable size values.
+    };
+
+    OGRFeatureDefn      *poDefn;
+    int                  nFeatureCount;
+    std::vector<GIntBig> anFIDs;
+    std::vector<Column>  aoFields;
+    std::vector<Column>  aoGeomFields;
+
+    static void         InitColumn( Column& oColumn, size_t nValueSize );
+    void                AddToColumn( Column& oColumn );
+    void                SetValid( Column& oColumn );
+    GByte              *AllocVariableValue( Column& oColumn, size_t nSize );
+    void               *GetFixedValue( int iField, OGRFieldType eType );
+
+  public:
+                        OGRFeatureBatch();
+                       ~OGRFeatureBatch();
+
+    void                Reset( OGRFeatureDefn *poDefnIn );
+
+    /** Return the definition of the features of the batch.
+     * @return the definition, or NULL if the batch was never filled. */
+    OGRFeatureDefn     *GetDefnRef() { return poDefn; }
+    /** Return the number of features in the batch.
+     * @return the number of features. */
+    int                 GetFeatureCount() const { return nFeatureCount; }
+
+    const GIntBig      *GetFIDs() const;
+    const GByte        *GetFieldValidity( int iField ) const;
+    int                 IsFieldValid( int iField, int iFeature ) const;
+    const void         *GetFieldData( int iField ) const;
+    const GIntBig      *GetFieldOffsets( int iField ) const;
+    const GByte        *GetGeomFieldValidity( int iGeomField ) const;
+    int                 IsGeomFieldValid( int iGeomField, int iFeature ) const;
+    const GByte        *GetGeomFieldData( int iGeomField ) const;
+    const GIntBig      *GetGeomFieldOffsets( int iGeomField ) const;
+
+//! @cond Doxygen_Suppress
+    /* Methods used by drivers to fill the batch. The Set methods apply to */
+    /* the last feature added, and should be called at most once per field. */
+    int                 AddFeature( GIntBig nFID );
+    void                SetFieldInteger( int iField, int nValue );
+    void                SetFieldInteger64( int iField, GIntBig nValue );
+    void                SetFieldDouble( int iField, double dfValue );
+    void                SetFieldString( int iField, const char *pszValue,
+                                        size_t nLen );
+    void                SetFieldString( int iField, const char *pszValue );
+    void                SetFieldRaw( int iField, const OGRField *psField );
+    void                SetGeomFieldWKB( int iGeomField, const GByte *pabyWKB,
+                                         size_t nWKBSize );
+    OGRErr              SetGeomField( int iGeomField,
+                                      const OGRGeometry *poGeom );
+    int                 AddFeatureFrom( OGRFeature *poFeature );
+//! @endcond
+
+  private:
+    CPL_DISALLOW_COPY_ASSIGN(OGRFeatureBatch)
+};
+
 /************************************************************************/
 /*                           OGRFeatureQuery                            */
 /************************************************************************/
@@ -491,6 +621,7 @@ class CPL_DLL OGRFeatureQuery
   private:
     OGRFeatureDefn *poTargetDefn;
     void           *pSWQExpr;
+    void           *pCompiledExpr;
 
     char      **FieldCollector( void *, char ** );
 
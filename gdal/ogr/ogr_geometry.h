@@ -120,12 +120,25 @@ class CPL_DLL OGRGeometry
   private:
     OGRSpatialReference * poSRS;                // may be NULL
 
+    // Cached result of exportToGEOS(), only used if bGEOSCacheEnabled.
+    mutable GEOSGeom hGEOSCache;
+    bool        bGEOSCacheEnabled;
+
+    GEOSGeom    getGEOSGeom( GEOSContextHandle_t hGEOSCtxt ) const;
+    void        releaseGEOSGeom( GEOSContextHandle_t hGEOSCtxt,
+                                 GEOSGeom hGeosGeom ) const;
+    void        freeGEOSCache();
+
   protected:
 //! @cond Doxygen_Suppress
     friend class OGRCurveCollection;
 
     unsigned int flags;
 
+    /** Must be called by every method that modifies the geometry. */
+    void        invalidateGEOSCache()
+                    { if( hGEOSCache != NULL ) freeGEOSCache(); }
+
     OGRErr       importPreambuleFromWkt( char ** ppszInput,
                                          int* pbHasZ, int* pbHasM,
                                          bool* pbIsEmpty );
@@ -220,6 +233,9 @@ class CPL_DLL OGRGeometry
     static void freeGEOSContext( GEOSContextHandle_t hGEOSCtxt );
     virtual GEOSGeom exportToGEOS( GEOSContextHandle_t hGEOSCtxt )
         const CPL_WARN_UNUSED_RESULT;
+    void        setGEOSCacheEnabled( bool bEnabled );
+    /*! Returns whether the GEOS representation of the geometry is cached. */
+    bool        isGEOSCacheEnabled() const { return bGEOSCacheEnabled; }
     virtual OGRBoolean hasCurveGeometry(int bLookForNonLinear = FALSE) const;
     virtual OGRGeometry* getCurveGeometry(
         const char* const* papszOptions = NULL ) const CPL_WARN_UNUSED_RESULT;
@@ -378,21 +394,25 @@ class CPL_DLL OGRPoint : public OGRGeometry
     /** Set x
      * @param xIn x
      */
-    void        setX( double xIn ) { x = xIn; flags |= OGR_G_NOT_EMPTY_POINT; }
+    void        setX( double xIn )
+        { x = xIn; flags |= OGR_G_NOT_EMPTY_POINT; invalidateGEOSCache(); }
     /** Set y
      * @param yIn y
      */
-    void        setY( double yIn ) { y = yIn; flags |= OGR_G_NOT_EMPTY_POINT; }
+    void        setY( double yIn )
+        { y = yIn; flags |= OGR_G_NOT_EMPTY_POINT; invalidateGEOSCache(); }
     /** Set z
      * @param zIn z
      */
     void        setZ( double zIn )
-        { z = zIn; flags |= (OGR_G_NOT_EMPTY_POINT | OGR_G_3D); }
+        { z = zIn; flags |= (OGR_G_NOT_EMPTY_POINT | OGR_G_3D);
+          invalidateGEOSCache(); }
     /** Set m
      * @param mIn m
      */
     void        setM( double mIn )
-        { m = mIn; flags |= (OGR_G_NOT_EMPTY_POINT | OGR_G_MEASURED); }
+        { m = mIn; flags |= (OGR_G_NOT_EMPTY_POINT | OGR_G_MEASURED);
+          invalidateGEOSCache(); }
 
     // ISpatialRelation
     virtual OGRBoolean  Equals( OGRGeometry * ) const CPL_OVERRIDE;
@@ -171,6 +171,9 @@ OGRErr OGRReadWKBGeometryType( const unsigned char * pabyData,
                                OGRwkbVariant wkbVariant,
                                OGRwkbGeometryType *eGeometryType );
 
+bool CPL_DLL OGRWKBGetEnvelope( const GByte* pabyWKB, size_t nWKBSize,
+                                OGREnvelope3D* psEnvelope, bool* pbHasZ );
+
 /************************************************************************/
 /*                            Other                                     */
 /************************************************************************/
@@ -143,6 +143,7 @@ OGRErr OGRCircularString::importFromWkb( const unsigned char * pabyData,
                                          int& nBytesConsumedOut )
 
 {
+    invalidateGEOSCache();
     OGRErr eErr = OGRSimpleCurve::importFromWkb(pabyData, nSize,
                                                 eWkbVariant,
                                                 nBytesConsumedOut);
@@ -189,6 +190,7 @@ OGRErr OGRCircularString::exportToWkb( OGRwkbByteOrder eByteOrder,
 OGRErr OGRCircularString::importFromWkt( char ** ppszInput )
 
 {
+    invalidateGEOSCache();
     const OGRErr eErr = OGRSimpleCurve::importFromWkt(ppszInput);
     if( eErr == OGRERR_NONE )
     {
@@ -347,6 +349,7 @@ void OGRCircularString::getEnvelope( OGREnvelope3D * psEnvelope ) const
 
 void OGRCircularString::segmentize( double dfMaxLength )
 {
+    invalidateGEOSCache();
     if( !IsValidFast() || nPointCount == 0 )
         return;
 
@@ -153,6 +153,7 @@ OGRErr OGRCompoundCurve::importFromWkb( const unsigned char * pabyData,
                                         OGRwkbVariant eWkbVariant,
                                        int& nBytesConsumedOut )
 {
+    invalidateGEOSCache();
     OGRwkbByteOrder eByteOrder = wkbNDR;
     int nDataOffset = 0;
     // coverity[tainted_data]
@@ -200,6 +201,7 @@ OGRErr OGRCompoundCurve::addCurveDirectlyFromWkt( OGRGeometry* poSelf,
 
 OGRErr OGRCompoundCurve::importFromWkt( char ** ppszInput )
 {
+    invalidateGEOSCache();
     return importCurveCollectionFromWkt( ppszInput,
                                          FALSE, // bAllowEmptyComponent
                                          TRUE, // bAllowLineString
@@ -242,6 +244,7 @@ OGRGeometry *OGRCompoundCurve::clone() const
 
 void OGRCompoundCurve::empty()
 {
+    invalidateGEOSCache();
     oCC.empty(this);
 }
 
@@ -397,16 +400,19 @@ OGRBoolean OGRCompoundCurve::Equals( OGRGeometry *poOther ) const
 
 void OGRCompoundCurve::setCoordinateDimension( int nNewDimension )
 {
+    invalidateGEOSCache();
     oCC.setCoordinateDimension( this, nNewDimension );
 }
 
 void OGRCompoundCurve::set3D( OGRBoolean bIs3D )
 {
+    invalidateGEOSCache();
     oCC.set3D(this, bIs3D);
 }
 
 void OGRCompoundCurve::setMeasured( OGRBoolean bIsMeasured )
 {
+    invalidateGEOSCache();
     oCC.setMeasured(this, bIsMeasured);
 }
 
@@ -450,6 +456,7 @@ int OGRCompoundCurve::getNumCurves() const
 
 OGRCurve *OGRCompoundCurve::getCurve( int iRing )
 {
+    invalidateGEOSCache();
     return oCC.getCurve(iRing);
 }
 
@@ -491,6 +498,7 @@ const OGRCurve *OGRCompoundCurve::getCurve( int iCurve ) const
 
 OGRCurve* OGRCompoundCurve::stealCurve( int iCurve )
 {
+    invalidateGEOSCache();
     return oCC.stealCurve(iCurve);
 }
 
@@ -518,6 +526,7 @@ OGRCurve* OGRCompoundCurve::stealCurve( int iCurve )
 
 OGRErr OGRCompoundCurve::addCurve( OGRCurve* poCurve, double dfToleranceEps )
 {
+    invalidateGEOSCache();
     OGRCurve* poClonedCurve = (OGRCurve*)poCurve->clone();
     const OGRErr eErr = addCurveDirectly( poClonedCurve, dfToleranceEps );
     if( eErr != OGRERR_NONE )
@@ -550,6 +559,7 @@ OGRErr OGRCompoundCurve::addCurve( OGRCurve* poCurve, double dfToleranceEps )
 OGRErr OGRCompoundCurve::addCurveDirectly( OGRCurve* poCurve,
                                            double dfToleranceEps )
 {
+    invalidateGEOSCache();
     return addCurveDirectlyInternal(poCurve, dfToleranceEps, TRUE );
 }
 
@@ -620,6 +630,7 @@ OGRErr OGRCompoundCurve::addCurveDirectlyInternal( OGRCurve* poCurve,
 
 OGRErr OGRCompoundCurve::transform( OGRCoordinateTransformation *poCT )
 {
+    invalidateGEOSCache();
     return oCC.transform(this, poCT);
 }
 
@@ -629,6 +640,7 @@ OGRErr OGRCompoundCurve::transform( OGRCoordinateTransformation *poCT )
 
 void OGRCompoundCurve::flattenTo2D()
 {
+    invalidateGEOSCache();
     oCC.flattenTo2D(this);
 }
 
@@ -638,6 +650,7 @@ void OGRCompoundCurve::flattenTo2D()
 
 void OGRCompoundCurve::segmentize( double dfMaxLength )
 {
+    invalidateGEOSCache();
     oCC.segmentize(dfMaxLength);
 }
 
@@ -647,6 +660,7 @@ void OGRCompoundCurve::segmentize( double dfMaxLength )
 
 void OGRCompoundCurve::swapXY()
 {
+    invalidateGEOSCache();
     oCC.swapXY();
 }
 
@@ -132,6 +132,7 @@ OGRGeometry *OGRCurvePolygon::clone() const
 void OGRCurvePolygon::empty()
 
 {
+    invalidateGEOSCache();
     oCC.empty(this);
 }
 
@@ -169,6 +170,7 @@ int OGRCurvePolygon::getDimension() const
 void OGRCurvePolygon::flattenTo2D()
 
 {
+    invalidateGEOSCache();
     oCC.flattenTo2D(this);
 }
 
@@ -205,6 +207,7 @@ const char * OGRCurvePolygon::getGeometryName() const
 OGRCurve *OGRCurvePolygon::getExteriorRingCurve()
 
 {
+    invalidateGEOSCache();
     return oCC.getCurve(0);
 }
 
@@ -270,6 +273,7 @@ int OGRCurvePolygon::getNumInteriorRings() const
 OGRCurve *OGRCurvePolygon::getInteriorRingCurve( int iRing )
 
 {
+    invalidateGEOSCache();
     return oCC.getCurve(iRing + 1);
 }
 
@@ -310,6 +314,7 @@ const OGRCurve *OGRCurvePolygon::getInteriorRingCurve( int iRing ) const
 
 OGRCurve *OGRCurvePolygon::stealExteriorRingCurve()
 {
+    invalidateGEOSCache();
     if( oCC.nCurveCount == 0 )
         return NULL;
     OGRCurve *poRet = oCC.papoCurves[0];
@@ -338,6 +343,7 @@ OGRCurve *OGRCurvePolygon::stealExteriorRingCurve()
 OGRErr OGRCurvePolygon::addRing( OGRCurve * poNewRing )
 
 {
+    invalidateGEOSCache();
     OGRCurve* poNewRingCloned = dynamic_cast<OGRCurve *>(poNewRing->clone());
     if( poNewRingCloned == NULL )
         return OGRERR_FAILURE;
@@ -396,6 +402,7 @@ int OGRCurvePolygon::checkRing( OGRCurve * poNewRing ) const
 
 OGRErr OGRCurvePolygon::addRingDirectly( OGRCurve * poNewRing )
 {
+    invalidateGEOSCache();
     return addRingDirectlyInternal( poNewRing, TRUE );
 }
 
@@ -451,6 +458,7 @@ OGRErr OGRCurvePolygon::importFromWkb( const unsigned char * pabyData,
                                        int& nBytesConsumedOut )
 
 {
+    invalidateGEOSCache();
     nBytesConsumedOut = -1;
     OGRwkbByteOrder eByteOrder;
     int nDataOffset = 0;
@@ -513,6 +521,7 @@ OGRErr OGRCurvePolygon::addCurveDirectlyFromWkt( OGRGeometry* poSelf,
 OGRErr OGRCurvePolygon::importFromWkt( char ** ppszInput )
 
 {
+    invalidateGEOSCache();
     return importCurveCollectionFromWkt( ppszInput,
                                          FALSE,  // bAllowEmptyComponent
                                          TRUE,  // bAllowLineString
@@ -659,6 +668,7 @@ OGRBoolean OGRCurvePolygon::Equals( OGRGeometry * poOther ) const
 OGRErr OGRCurvePolygon::transform( OGRCoordinateTransformation *poCT )
 
 {
+    invalidateGEOSCache();
     return oCC.transform(this, poCT);
 }
 
@@ -689,16 +699,19 @@ double OGRCurvePolygon::get_Area() const
 void OGRCurvePolygon::setCoordinateDimension( int nNewDimension )
 
 {
+    invalidateGEOSCache();
     oCC.setCoordinateDimension(this, nNewDimension);
 }
 
 void OGRCurvePolygon::set3D( OGRBoolean bIs3D )
 {
+    invalidateGEOSCache();
     oCC.set3D( this, bIs3D );
 }
 
 void OGRCurvePolygon::setMeasured( OGRBoolean bIsMeasured )
 {
+    invalidateGEOSCache();
     oCC.setMeasured( this, bIsMeasured );
 }
 
@@ -717,6 +730,7 @@ OGRBoolean OGRCurvePolygon::IsEmpty() const
 
 void OGRCurvePolygon::segmentize( double dfMaxLength )
 {
+    invalidateGEOSCache();
     if (EQUAL(getGeometryName(), "TRIANGLE"))
     {
         CPLError(CE_Failure, CPLE_NotSupported, "segmentize() is not valid for Triangle");
@@ -731,6 +745,7 @@ void OGRCurvePolygon::segmentize( double dfMaxLength )
 
 void OGRCurvePolygon::swapXY()
 {
+    invalidateGEOSCache();
     oCC.swapXY();
 }
 
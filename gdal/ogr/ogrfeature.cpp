@@ -81,6 +81,7 @@ OGRFeature::OGRFeature( OGRFeatureDefn * poDefnIn ) :
     pauFields(NULL),
     m_pszNativeData(NULL),
     m_pszNativeMediaType(NULL),
+    m_pasGeomWKB(NULL),
     m_pszStyleString(NULL),
     m_poStyleTable(NULL),
     m_pszTmpFieldValue(NULL)
@@ -188,6 +189,17 @@ OGRFeature::~OGRFeature()
         }
     }
 
+    if( m_pasGeomWKB != NULL )
+    {
+        const int nGeomFieldCount = poDefn->GetGeomFieldCount();
+
+        for( int i = 0; i < nGeomFieldCount; i++ )
+        {
+            ClearGeomFieldWKB(i);
+        }
+        CPLFree(m_pasGeomWKB);
+    }
+
     poDefn->Release();
 
     CPLFree(pauFields);
@@ -487,6 +499,7 @@ OGRGeometry *OGRFeature::StealGeometry()
 {
     if( GetGeomFieldCount() > 0 )
     {
+        DecodeGeomField(0);
         OGRGeometry *poReturn = papoGeometries[0];
         papoGeometries[0] = NULL;
         return poReturn;
@@ -515,6 +528,7 @@ OGRGeometry *OGRFeature::StealGeometry( int iGeomField )
 {
     if( iGeomField >= 0 && iGeomField < GetGeomFieldCount() )
     {
+        DecodeGeomField(iGeomField);
         OGRGeometry *poReturn = papoGeometries[iGeomField];
         papoGeometries[iGeomField] = NULL;
         return poReturn;
@@ -632,8 +646,9 @@ OGRGeometry *OGRFeature::GetGeomFieldRef( int iField )
 {
     if( iField < 0 || iField >= GetGeomFieldCount() )
         return NULL;
-    else
-        return papoGeometries[iField];
+
+    DecodeGeomField(iField);
+    return papoGeometries[iField];
 }
 
 /************************************************************************/
@@ -657,6 +672,7 @@ OGRGeometry *OGRFeature::GetGeomFieldRef( const char* pszFName )
     if( iField < 0 )
         return NULL;
 
+    DecodeGeomField(iField);
     return papoGeometries[iField];
 }
 
@@ -733,6 +749,7 @@ OGRErr OGRFeature::SetGeomFieldDirectly( int iField, OGRGeometry * poGeomIn )
         return OGRERR_FAILURE;
     }
 
+    ClearGeomFieldWKB(iField);
     if( papoGeometries[iField] != poGeomIn )
     {
         delete papoGeometries[iField];
@@ -808,6 +825,7 @@ OGRErr OGRFeature::SetGeomField( int iField, const OGRGeometry * poGeomIn )
     if( iField < 0 || iField >= GetGeomFieldCount() )
         return OGRERR_FAILURE;
 
+    ClearGeomFieldWKB(iField);
     if( papoGeometries[iField] != poGeomIn )
     {
         delete papoGeometries[iField];
@@ -854,6 +872,241 @@ OGRErr OGR_F_SetGeomField( OGRFeatureH hFeat, int iField, OGRGeometryH hGeom )
         SetGeomField(iField, reinterpret_cast<OGRGeometry *>(hGeom));
 }
 
+/************************************************************************/
+/*                      SetGeomFieldWKBDirectly()                       */
+/************************************************************************/
+
+/**
+ * \brief Set feature geometry of a specified geometry field from its WKB
+ * encoding, without decoding it.
+ *
+ * The WKB blob is stored as it is, and will only be turned into an
+ * OGRGeometry when it is requested with GetGeomFieldRef() or
+ * StealGeometry(). This lets drivers defer the cost of geometry decoding to
+ * the point where the geometry is actually needed, and lets writers that
+ * can consume WKB, such as GeoPackage, skip a decoding/encoding round trip.
+ * The decoded geometry gets the spatial reference system of the geometry
+ * field definition.
+ *
+ * Ownership of the passed buffer, which must have been allocated with
+ * CPLMalloc(), is transferred to the feature.
+ *
+ * @param iField geometry field to set.
+ * @param pabyWKB WKB blob (ISO or extended OGC variants accepted).
+ * @param nWKBSize size in bytes of pabyWKB.
+ *
+ * @return OGRERR_NONE if successful, or OGRERR_FAILURE if the index is
+ * invalid.
+ *
+ * @since GDAL 2.3
+ */
+
+OGRErr OGRFeature::SetGeomFieldWKBDirectly( int iField, GByte* pabyWKB,
+                                            size_t nWKBSize )
+
+{
+    if( iField < 0 || iField >= GetGeomFieldCount() )
+    {
+        CPLFree(pabyWKB);
+        return OGRERR_FAILURE;
+    }
+
+    delete papoGeometries[iField];
+    papoGeometries[iField] = NULL;
+
+    if( m_pasGeomWKB == NULL )
+    {
+        m_pasGeomWKB = static_cast<GeomFieldWKB *>(
+            VSI_CALLOC_VERBOSE(GetGeomFieldCount(), sizeof(GeomFieldWKB)));
+        if( m_pasGeomWKB == NULL )
+        {
+            CPLFree(pabyWKB);
+            return OGRERR_NOT_ENOUGH_MEMORY;
+        }
+    }
+    else
+    {
+        ClearGeomFieldWKB(iField);
+    }
+
+    m_pasGeomWKB[iField].pabyData = pabyWKB;
+    m_pasGeomWKB[iField].nSize = nWKBSize;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          SetGeomFieldWKB()                           */
+/************************************************************************/
+
+/**
+ * \brief Set feature geometry of a specified geometry field from its WKB
+ * encoding, without decoding it.
+ *
+ * Same as SetGeomFieldWKBDirectly(), except that the passed buffer is
+ * copied.
+ *
+ * @param iField geometry field to set.
+ * @param pabyWKB WKB blob (ISO or extended OGC variants accepted).
+ * @param nWKBSize size in bytes of pabyWKB.
+ *
+ * @return OGRERR_NONE if successful, or OGRERR_FAILURE if the index is
+ * invalid.
+ *
+ * @since GDAL 2.3
+ */
+
+OGRErr OGRFeature::SetGeomFieldWKB( int iField, const GByte* pabyWKB,
+                                    size_t nWKBSize )
+
+{
+    if( iField < 0 || iField >= GetGeomFieldCount() )
+        return OGRERR_FAILURE;
+
+    GByte* pabyCopy = static_cast<GByte *>(
+        VSI_MALLOC_VERBOSE(nWKBSize > 0 ? nWKBSize : 1));
+    if( pabyCopy == NULL )
+        return OGRERR_NOT_ENOUGH_MEMORY;
+    if( nWKBSize > 0 )
+        memcpy(pabyCopy, pabyWKB, nWKBSize);
+
+    return SetGeomFieldWKBDirectly(iField, pabyCopy, nWKBSize);
+}
+
+/************************************************************************/
+/*                         GetGeomFieldWKBRef()                         */
+/************************************************************************/
+
+/**
+ * \brief Fetch the WKB blob of a geometry field that has not been decoded
+ * yet.
+ *
+ * This returns a non-NULL pointer only if the geometry field was set with
+ * SetGeomFieldWKBDirectly() or SetGeomFieldWKB(), and that no method
+ * requiring the decoded geometry, such as GetGeomFieldRef(), has been called
+ * since. Callers that get NULL should use GetGeomFieldRef().
+ *
+ * @param iField geometry field to get.
+ * @param pnWKBSize pointer to a variable receiving the size of the blob, or
+ * NULL.
+ *
+ * @return an internal pointer to the WKB blob, that must not be modified or
+ * freed, or NULL.
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte* OGRFeature::GetGeomFieldWKBRef( int iField,
+                                             size_t* pnWKBSize ) const
+
+{
+    if( m_pasGeomWKB == NULL || iField < 0 || iField >= GetGeomFieldCount() ||
+        m_pasGeomWKB[iField].pabyData == NULL )
+    {
+        if( pnWKBSize )
+            *pnWKBSize = 0;
+        return NULL;
+    }
+    if( pnWKBSize )
+        *pnWKBSize = m_pasGeomWKB[iField].nSize;
+    return m_pasGeomWKB[iField].pabyData;
+}
+
+/************************************************************************/
+/*                          DecodeGeomField()                           */
+/************************************************************************/
+
+void OGRFeature::DecodeGeomField( int iField )
+
+{
+    if( m_pasGeomWKB == NULL || m_pasGeomWKB[iField].pabyData == NULL )
+        return;
+
+    OGRSpatialReference* poSRS = m_pasGeomWKB[iField].poSRS;
+    if( poSRS == NULL )
+        poSRS = poDefn->GetGeomFieldDefn(iField)->GetSpatialRef();
+
+    OGRGeometry* poGeom = NULL;
+    const OGRErr eErr =
+        OGRGeometryFactory::createFromWkb( m_pasGeomWKB[iField].pabyData,
+                                           poSRS, &poGeom,
+                                           static_cast<int>(
+                                               m_pasGeomWKB[iField].nSize) );
+    if( eErr != OGRERR_NONE )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Cannot decode WKB geometry of field %s of feature "
+                 CPL_FRMT_GIB,
+                 poDefn->GetGeomFieldDefn(iField)->GetNameRef(), GetFID());
+        delete poGeom;
+        poGeom = NULL;
+    }
+
+    ClearGeomFieldWKB(iField);
+    papoGeometries[iField] = poGeom;
+}
+
+/************************************************************************/
+/*                         ClearGeomFieldWKB()                          */
+/************************************************************************/
+
+void OGRFeature::ClearGeomFieldWKB( int iField )
+
+{
+    if( m_pasGeomWKB == NULL )
+        return;
+
+    CPLFree(m_pasGeomWKB[iField].pabyData);
+    m_pasGeomWKB[iField].pabyData = NULL;
+    m_pasGeomWKB[iField].nSize = 0;
+    if( m_pasGeomWKB[iField].poSRS != NULL )
+        m_pasGeomWKB[iField].poSRS->Release();
+    m_pasGeomWKB[iField].poSRS = NULL;
+}
+
+/************************************************************************/
+/*                           CopyGeomField()                            */
+/*                                                                      */
+/*      Same as SetGeomField(iField, poSrcFeature->GetGeomFieldRef()),  */
+/*      but keeps a pending WKB blob undecoded.                         */
+/************************************************************************/
+
+void OGRFeature::CopyGeomField( int iField, OGRFeature* poSrcFeature,
+                                int iSrcField )
+
+{
+    size_t nWKBSize = 0;
+    const GByte* pabyWKB = poSrcFeature->GetGeomFieldWKBRef(iSrcField,
+                                                            &nWKBSize);
+    if( pabyWKB == NULL )
+    {
+        SetGeomField( iField, poSrcFeature->GetGeomFieldRef(iSrcField) );
+        return;
+    }
+
+    // The geometry would get the SRS of the source field once decoded.
+    OGRSpatialReference* poSrcSRS =
+        poSrcFeature->m_pasGeomWKB[iSrcField].poSRS;
+    if( poSrcSRS == NULL )
+        poSrcSRS = poSrcFeature->poDefn->GetGeomFieldDefn(iSrcField)->
+                                                            GetSpatialRef();
+    OGRSpatialReference* poDstSRS =
+        poDefn->GetGeomFieldDefn(iField)->GetSpatialRef();
+    if( poSrcSRS == NULL && poDstSRS != NULL )
+    {
+        // Cannot express "no SRS" in a pending blob.
+        SetGeomField( iField, poSrcFeature->GetGeomFieldRef(iSrcField) );
+        return;
+    }
+
+    if( SetGeomFieldWKB( iField, pabyWKB, nWKBSize ) == OGRERR_NONE &&
+        poSrcSRS != poDstSRS )
+    {
+        poSrcSRS->Reference();
+        m_pasGeomWKB[iField].poSRS = poSrcSRS;
+    }
+}
+
 /************************************************************************/
 /*                               Clone()                                */
 /************************************************************************/
@@ -887,7 +1140,11 @@ OGRFeature *OGRFeature::Clone()
     }
     for( int i = 0; i < poDefn->GetGeomFieldCount(); i++ )
     {
-        if( papoGeometries[i] != NULL )
+        if( m_pasGeomWKB != NULL && m_pasGeomWKB[i].pabyData != NULL )
+        {
+            poNew->CopyGeomField(i, this, i);
+        }
+        else if( papoGeometries[i] != NULL )
         {
             poNew->papoGeometries[i] = papoGeometries[i]->clone();
             if( poNew->papoGeometries[i] == NULL )
@@ -1256,13 +1513,13 @@ int OGRFeature::IsFieldSet( int iField )
 
           case SPF_OGR_GEOM_WKT:
           case SPF_OGR_GEOMETRY:
-            return GetGeomFieldCount() > 0 && papoGeometries[0] != NULL;
+            return GetGeomFieldRef(0) != NULL;
 
           case SPF_OGR_STYLE:
             return GetStyleString() != NULL;
 
           case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == NULL )
+            if( GetGeomFieldRef(0) == NULL )
                 return FALSE;
 
             return OGR_G_Area(
@@ -1683,7 +1940,7 @@ int OGRFeature::GetFieldAsInteger( int iField )
         }
 
         case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == NULL )
+            if( GetGeomFieldRef(0) == NULL )
                 return 0;
             return static_cast<int>(
                 OGR_G_Area(reinterpret_cast<OGRGeometryH>(papoGeometries[0])));
@@ -1810,7 +2067,7 @@ GIntBig OGRFeature::GetFieldAsInteger64( int iField )
             return nFID;
 
         case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == NULL )
+            if( GetGeomFieldRef(0) == NULL )
                 return 0;
             return static_cast<int>(
                 OGR_G_Area(reinterpret_cast<OGRGeometryH>(papoGeometries[0])));
@@ -1928,7 +2185,7 @@ double OGRFeature::GetFieldAsDouble( int iField )
             return static_cast<double>(GetFID());
 
         case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == NULL )
+            if( GetGeomFieldRef(0) == NULL )
                 return 0.0;
             return
                 OGR_G_Area(reinterpret_cast<OGRGeometryH>(papoGeometries[0]));
@@ -2109,7 +2366,7 @@ const char *OGRFeature::GetFieldAsString( int iField )
             return m_pszTmpFieldValue;
 
           case SPF_OGR_GEOMETRY:
-            if( GetGeomFieldCount() > 0 && papoGeometries[0] != NULL )
+            if( GetGeomFieldRef(0) != NULL )
                 return papoGeometries[0]->getGeometryName();
             else
                 return "";
@@ -2122,7 +2379,7 @@ const char *OGRFeature::GetFieldAsString( int iField )
 
           case SPF_OGR_GEOM_WKT:
           {
-              if( GetGeomFieldCount() == 0 || papoGeometries[0] == NULL )
+              if( GetGeomFieldRef(0) == NULL )
                   return "";
 
               if( papoGeometries[0]->exportToWkt( &m_pszTmpFieldValue ) ==
@@ -2133,7 +2390,7 @@ const char *OGRFeature::GetFieldAsString( int iField )
           }
 
           case SPF_OGR_GEOM_AREA:
-            if( GetGeomFieldCount() == 0 || papoGeometries[0] == NULL )
+            if( GetGeomFieldRef(0) == NULL )
                 return "";
 
             CPLsnprintf(
@@ -5118,7 +5375,7 @@ void OGRFeature::DumpReadable( FILE * fpOut, char** papszOptions )
             {
                 OGRGeomFieldDefn *poFDefn = poDefn->GetGeomFieldDefn(iField);
 
-                if( papoGeometries[iField] != NULL )
+                if( GetGeomFieldRef(iField) != NULL )
                 {
                     fprintf( fpOut, "  " );
                     if( strlen(poFDefn->GetNameRef()) > 0 &&
@@ -5637,11 +5894,11 @@ OGRErr OGRFeature::SetFrom( OGRFeature * poSrcFeature, int *panMap ,
         int iSrc = poSrcFeature->GetGeomFieldIndex(
                                     poGFieldDefn->GetNameRef());
         if( iSrc >= 0 )
-            SetGeomField( 0, poSrcFeature->GetGeomFieldRef(iSrc) );
+            CopyGeomField( 0, poSrcFeature, iSrc );
         else
             // Whatever the geometry field names are.  For backward
             // compatibility.
-            SetGeomField( 0, poSrcFeature->GetGeomFieldRef(0) );
+            CopyGeomField( 0, poSrcFeature, 0 );
     }
     else
     {
@@ -5652,7 +5909,7 @@ OGRErr OGRFeature::SetFrom( OGRFeature * poSrcFeature, int *panMap ,
             const int iSrc =
                 poSrcFeature->GetGeomFieldIndex(poGFieldDefn->GetNameRef());
             if( iSrc >= 0 )
-                SetGeomField( i, poSrcFeature->GetGeomFieldRef(iSrc) );
+                CopyGeomField( i, poSrcFeature, iSrc );
             else
                 SetGeomField( i, NULL );
         }
@@ -6134,6 +6391,11 @@ OGRErr OGRFeature::RemapGeomFields( OGRFeatureDefn *poNewDefn,
     if( poNewDefn == NULL )
         poNewDefn = poDefn;
 
+    for( int i = 0; m_pasGeomWKB != NULL && i < poDefn->GetGeomFieldCount(); i++ )
+        DecodeGeomField(i);
+    CPLFree(m_pasGeomWKB);
+    m_pasGeomWKB = NULL;
+
     OGRGeometry** papoNewGeomFields = static_cast<OGRGeometry **>(
         CPLCalloc( poNewDefn->GetGeomFieldCount(), sizeof(OGRGeometry*) ) );
 
@@ -0,0 +1,950 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  The OGRFeatureBatch class implementation.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "ogr_api.h"
+#include "ogr_feature.h"
+
+#include <cstring>
+
+#include <vector>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "ogr_core.h"
+#include "ogr_geometry.h"
+
+CPL_CVSID("$Id$")
+
+/************************************************************************/
+/*                          OGRFeatureBatch()                           */
+/************************************************************************/
+
+/**
+ * \brief Constructor.
+ *
+ * The batch is empty until it is filled with
+ * OGRLayer::GetNextFeatureBatch().
+ *
+ * @since GDAL 2.3
+ */
+
+OGRFeatureBatch::OGRFeatureBatch() :
+    poDefn(NULL),
+    nFeatureCount(0)
+{}
+
+/************************************************************************/
+/*                          ~OGRFeatureBatch()                          */
+/************************************************************************/
+
+OGRFeatureBatch::~OGRFeatureBatch()
+
+{
+    if( poDefn != NULL )
+        poDefn->Release();
+}
+
+/************************************************************************/
+/*                         GetFixedValueSize()                          */
+/************************************************************************/
+
+/* Return the size of the values of a field type stored in a fixed size */
+/* array, or 0 for the types stored with offsets. */
+
+static size_t GetFixedValueSize( OGRFieldType eType )
+{
+    switch( eType )
+    {
+        case OFTInteger:
+            return sizeof(int);
+        case OFTInteger64:
+            return sizeof(GIntBig);
+        case OFTReal:
+            return sizeof(double);
+        case OFTDate:
+        case OFTTime:
+        case OFTDateTime:
+            return sizeof(OGRField);
+        default:
+            return 0;
+    }
+}
+
+/************************************************************************/
+/*                             InitColumn()                             */
+/************************************************************************/
+
+void OGRFeatureBatch::InitColumn( Column& oColumn, size_t nValueSize )
+{
+    // clear() keeps the capacity of the vectors.
+    oColumn.abyValidity.clear();
+    oColumn.abyData.clear();
+    oColumn.anOffsets.clear();
+    oColumn.nValueSize = nValueSize;
+    if( nValueSize == 0 )
+        oColumn.anOffsets.push_back(0);
+}
+
+/************************************************************************/
+/*                               Reset()                                */
+/************************************************************************/
+
+/**
+ * \brief Remove all the features of the batch.
+ *
+ * The memory allocated for the features is kept for the next use of the
+ * batch.
+ *
+ * @param poDefnIn the definition of the features that will be added to the
+ * batch. Its reference count is incremented.
+ */
+
+void OGRFeatureBatch::Reset( OGRFeatureDefn *poDefnIn )
+
+{
+    if( poDefnIn != poDefn )
+    {
+        if( poDefnIn != NULL )
+            poDefnIn->Reference();
+        if( poDefn != NULL )
+            poDefn->Release();
+        poDefn = poDefnIn;
+    }
+
+    nFeatureCount = 0;
+    anFIDs.clear();
+
+    const int nFieldCount = poDefn != NULL ? poDefn->GetFieldCount() : 0;
+    aoFields.resize(nFieldCount);
+    for( int i = 0; i < nFieldCount; i++ )
+    {
+        InitColumn(aoFields[i],
+                   GetFixedValueSize(poDefn->GetFieldDefn(i)->GetType()));
+    }
+
+    const int nGeomFieldCount =
+        poDefn != NULL ? poDefn->GetGeomFieldCount() : 0;
+    aoGeomFields.resize(nGeomFieldCount);
+    for( int i = 0; i < nGeomFieldCount; i++ )
+        InitColumn(aoGeomFields[i], 0);
+}
+
+/************************************************************************/
+/*                              GetFIDs()                               */
+/************************************************************************/
+
+/**
+ * \brief Return the array of the feature identifiers of the batch.
+ *
+ * This method is the same as the C function OGR_FB_GetFIDs().
+ *
+ * @return an array of GetFeatureCount() values, or NULL if the batch is empty.
+ */
+
+const GIntBig *OGRFeatureBatch::GetFIDs() const
+
+{
+    return anFIDs.empty() ? NULL : &anFIDs[0];
+}
+
+/************************************************************************/
+/*                          GetFieldValidity()                          */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of a field.
+ *
+ * This method is the same as the C function OGR_FB_GetFieldValidity().
+ *
+ * @param iField the field index.
+ * @return a bitmap of (GetFeatureCount() + 7) / 8 bytes, or NULL if the batch
+ * is empty or the index invalid.
+ */
+
+const GByte *OGRFeatureBatch::GetFieldValidity( int iField ) const
+
+{
+    if( iField < 0 || iField >= static_cast<int>(aoFields.size()) ||
+        nFeatureCount == 0 )
+        return NULL;
+    return &aoFields[iField].abyValidity[0];
+}
+
+/************************************************************************/
+/*                            IsFieldValid()                            */
+/************************************************************************/
+
+/**
+ * \brief Test if the value of a field of a feature is set and not null.
+ *
+ * @param iField the field index.
+ * @param iFeature the feature index in the batch.
+ * @return TRUE if the value is set and not null.
+ */
+
+int OGRFeatureBatch::IsFieldValid( int iField, int iFeature ) const
+
+{
+    if( iField < 0 || iField >= static_cast<int>(aoFields.size()) ||
+        iFeature < 0 || iFeature >= nFeatureCount )
+        return FALSE;
+    return (aoFields[iField].abyValidity[iFeature / 8] >> (iFeature % 8)) & 1;
+}
+
+/************************************************************************/
+/*                            GetFieldData()                            */
+/************************************************************************/
+
+/**
+ * \brief Return the values of a field.
+ *
+ * See the class documentation for the layout of the values for each field
+ * type.
+ *
+ * This method is the same as the C function OGR_FB_GetFieldData().
+ *
+ * @param iField the field index.
+ * @return the values, or NULL if there are none.
+ */
+
+const void *OGRFeatureBatch::GetFieldData( int iField ) const
+
+{
+    if( iField < 0 || iField >= static_cast<int>(aoFields.size()) ||
+        aoFields[iField].abyData.empty() )
+        return NULL;
+    return &aoFields[iField].abyData[0];
+}
+
+/************************************************************************/
+/*                          GetFieldOffsets()                           */
+/************************************************************************/
+
+/**
+ * \brief Return the byte offsets of the values of a variable size field.
+ *
+ * This method is the same as the C function OGR_FB_GetFieldOffsets().
+ *
+ * @param iField the field index.
+ * @return an array of GetFeatureCount() + 1 offsets, or NULL if the field
+ * type has fixed size values.
+ */
+
+const GIntBig *OGRFeatureBatch::GetFieldOffsets( int iField ) const
+
+{
+    if( iField < 0 || iField >= static_cast<int>(aoFields.size()) ||
+        aoFields[iField].nValueSize != 0 )
+        return NULL;
+    return &aoFields[iField].anOffsets[0];
+}
+
+/************************************************************************/
+/*                        GetGeomFieldValidity()                        */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of a geometry field.
+ *
+ * This method is the same as the C function OGR_FB_GetGeomFieldValidity().
+ *
+ * @param iGeomField the geometry field index.
+ * @return a bitmap of (GetFeatureCount() + 7) / 8 bytes, or NULL if the batch
+ * is empty or the index invalid.
+ */
+
+const GByte *OGRFeatureBatch::GetGeomFieldValidity( int iGeomField ) const
+
+{
+    if( iGeomField < 0 ||
+        iGeomField >= static_cast<int>(aoGeomFields.size()) ||
+        nFeatureCount == 0 )
+        return NULL;
+    return &aoGeomFields[iGeomField].abyValidity[0];
+}
+
+/************************************************************************/
+/*                          IsGeomFieldValid()                          */
+/************************************************************************/
+
+/**
+ * \brief Test if a feature has a geometry for a geometry field.
+ *
+ * @param iGeomField the geometry field index.
+ * @param iFeature the feature index in the batch.
+ * @return TRUE if the feature has a geometry.
+ */
+
+int OGRFeatureBatch::IsGeomFieldValid( int iGeomField, int iFeature ) const
+
+{
+    if( iGeomField < 0 ||
+        iGeomField >= static_cast<int>(aoGeomFields.size()) ||
+        iFeature < 0 || iFeature >= nFeatureCount )
+        return FALSE;
+    return (aoGeomFields[iGeomField].abyValidity[iFeature / 8] >>
+                                                        (iFeature % 8)) & 1;
+}
+
+/************************************************************************/
+/*                          GetGeomFieldData()                          */
+/************************************************************************/
+
+/**
+ * \brief Return the concatenated WKB geometries of a geometry field.
+ *
+ * This method is the same as the C function OGR_FB_GetGeomFieldData().
+ *
+ * @param iGeomField the geometry field index.
+ * @return the WKB geometries, or NULL if there are none.
+ */
+
+const GByte *OGRFeatureBatch::GetGeomFieldData( int iGeomField ) const
+
+{
+    if( iGeomField < 0 ||
+        iGeomField >= static_cast<int>(aoGeomFields.size()) ||
+        aoGeomFields[iGeomField].abyData.empty() )
+        return NULL;
+    return &aoGeomFields[iGeomField].abyData[0];
+}
+
+/************************************************************************/
+/*                        GetGeomFieldOffsets()                         */
+/************************************************************************/
+
+/**
+ * \brief Return the byte offsets of the WKB geometries of a geometry field.
+ *
+ * This method is the same as the C function OGR_FB_GetGeomFieldOffsets().
+ *
+ * @param iGeomField the geometry field index.
+ * @return an array of GetFeatureCount() + 1 offsets, or NULL if the index is
+ * invalid.
+ */
+
+const GIntBig *OGRFeatureBatch::GetGeomFieldOffsets( int iGeomField ) const
+
+{
+    if( iGeomField < 0 ||
+        iGeomField >= static_cast<int>(aoGeomFields.size()) )
+        return NULL;
+    return &aoGeomFields[iGeomField].anOffsets[0];
+}
+
+//! @cond Doxygen_Suppress
+
+/************************************************************************/
+/*                            AddToColumn()                             */
+/************************************************************************/
+
+/* Add a null value for a new feature to a column. */
+
+void OGRFeatureBatch::AddToColumn( Column& oColumn )
+{
+    if( (nFeatureCount % 8) == 0 )
+        oColumn.abyValidity.push_back(0);
+    if( oColumn.nValueSize != 0 )
+        oColumn.abyData.resize(oColumn.abyData.size() + oColumn.nValueSize);
+    else
+        oColumn.anOffsets.push_back(oColumn.anOffsets.back());
+}
+
+/************************************************************************/
+/*                             AddFeature()                             */
+/************************************************************************/
+
+/* Add a feature whose fields are all null, and return its index. */
+
+int OGRFeatureBatch::AddFeature( GIntBig nFID )
+{
+    anFIDs.push_back(nFID);
+    for( size_t i = 0; i < aoFields.size(); i++ )
+        AddToColumn(aoFields[i]);
+    for( size_t i = 0; i < aoGeomFields.size(); i++ )
+        AddToColumn(aoGeomFields[i]);
+    return nFeatureCount++;
+}
+
+/************************************************************************/
+/*                              SetValid()                              */
+/************************************************************************/
+
+void OGRFeatureBatch::SetValid( Column& oColumn )
+{
+    CPLAssert( nFeatureCount > 0 );
+    oColumn.abyValidity.back() |=
+        static_cast<GByte>(1 << ((nFeatureCount - 1) % 8));
+}
+
+/************************************************************************/
+/*                           GetFixedValue()                            */
+/*                                                                      */
+/*      Return the storage of the value of the last feature for a       */
+/*      field, and mark it as valid, or NULL if the field is not of     */
+/*      the expected type.                                              */
+/************************************************************************/
+
+void *OGRFeatureBatch::GetFixedValue( int iField, OGRFieldType eType )
+{
+    if( iField < 0 || iField >= static_cast<int>(aoFields.size()) ||
+        poDefn->GetFieldDefn(iField)->GetType() != eType )
+    {
+        CPLAssert( false );
+        return NULL;
+    }
+    Column& oColumn = aoFields[iField];
+    SetValid(oColumn);
+    return &oColumn.abyData[(nFeatureCount - 1) * oColumn.nValueSize];
+}
+
+/************************************************************************/
+/*                         AllocVariableValue()                         */
+/*                                                                      */
+/*      Allocate the storage of the value of the last feature for a     */
+/*      variable size column, and mark it as valid.                     */
+/************************************************************************/
+
+GByte *OGRFeatureBatch::AllocVariableValue( Column& oColumn, size_t nSize )
+{
+    CPLAssert( oColumn.nValueSize == 0 );
+    const size_t nOldSize = oColumn.abyData.size();
+    oColumn.abyData.resize(nOldSize + nSize);
+    oColumn.anOffsets.back() = static_cast<GIntBig>(nOldSize + nSize);
+    SetValid(oColumn);
+    return oColumn.abyData.empty() ? NULL : &oColumn.abyData[0] + nOldSize;
+}
+
+/************************************************************************/
+/*                          SetFieldInteger()                           */
+/************************************************************************/
+
+void OGRFeatureBatch::SetFieldInteger( int iField, int nValue )
+{
+    const OGRFieldType eType = poDefn->GetFieldDefn(iField)->GetType();
+    if( eType == OFTInteger64 )
+    {
+        SetFieldInteger64(iField, nValue);
+        return;
+    }
+    if( eType == OFTReal )
+    {
+        SetFieldDouble(iField, nValue);
+        return;
+    }
+    void *pValue = GetFixedValue(iField, OFTInteger);
+    if( pValue != NULL )
+        memcpy(pValue, &nValue, sizeof(int));
+}
+
+/************************************************************************/
+/*                         SetFieldInteger64()                          */
+/************************************************************************/
+
+void OGRFeatureBatch::SetFieldInteger64( int iField, GIntBig nValue )
+{
+    const OGRFieldType eType = poDefn->GetFieldDefn(iField)->GetType();
+    if( eType == OFTInteger )
+    {
+        SetFieldInteger(iField, static_cast<int>(nValue));
+        return;
+    }
+    if( eType == OFTReal )
+    {
+        SetFieldDouble(iField, static_cast<double>(nValue));
+        return;
+    }
+    void *pValue = GetFixedValue(iField, OFTInteger64);
+    if( pValue != NULL )
+        memcpy(pValue, &nValue, sizeof(GIntBig));
+}
+
+/************************************************************************/
+/*                           SetFieldDouble()                           */
+/************************************************************************/
+
+void OGRFeatureBatch::SetFieldDouble( int iField, double dfValue )
+{
+    const OGRFieldType eType = poDefn->GetFieldDefn(iField)->GetType();
+    if( eType == OFTInteger )
+    {
+        SetFieldInteger(iField, static_cast<int>(dfValue));
+        return;
+    }
+    if( eType == OFTInteger64 )
+    {
+        SetFieldInteger64(iField, static_cast<GIntBig>(dfValue));
+        return;
+    }
+    void *pValue = GetFixedValue(iField, OFTReal);
+    if( pValue != NULL )
+        memcpy(pValue, &dfValue, sizeof(double));
+}
+
+/************************************************************************/
+/*                           SetFieldString()                           */
+/************************************************************************/
+
+/* Set the value of a OFTString or OFTBinary field. */
+
+void OGRFeatureBatch::SetFieldString( int iField, const char *pszValue,
+                                      size_t nLen )
+{
+    if( iField < 0 || iField >= static_cast<int>(aoFields.size()) ||
+        aoFields[iField].nValueSize != 0 )
+    {
+        CPLAssert( false );
+        return;
+    }
+    GByte *pabyDst = AllocVariableValue(aoFields[iField], nLen);
+    if( nLen > 0 )
+        memcpy(pabyDst, pszValue, nLen);
+}
+
+void OGRFeatureBatch::SetFieldString( int iField, const char *pszValue )
+{
+    SetFieldString(iField, pszValue, strlen(pszValue));
+}
+
+/************************************************************************/
+/*                            SetFieldRaw()                             */
+/************************************************************************/
+
+/* Set the value of a field from its OGRFeature representation. */
+
+void OGRFeatureBatch::SetFieldRaw( int iField, const OGRField *psField )
+{
+    if( OGR_RawField_IsUnset(psField) || OGR_RawField_IsNull(psField) )
+        return;
+
+    switch( poDefn->GetFieldDefn(iField)->GetType() )
+    {
+        case OFTInteger:
+            SetFieldInteger(iField, psField->Integer);
+            break;
+
+        case OFTInteger64:
+            SetFieldInteger64(iField, psField->Integer64);
+            break;
+
+        case OFTReal:
+            SetFieldDouble(iField, psField->Real);
+            break;
+
+        case OFTString:
+            SetFieldString(iField, psField->String);
+            break;
+
+        case OFTBinary:
+            SetFieldString(iField,
+                           reinterpret_cast<const char*>(psField->Binary.paData),
+                           psField->Binary.nCount);
+            break;
+
+        case OFTDate:
+        case OFTTime:
+        case OFTDateTime:
+        {
+            void *pValue = GetFixedValue(
+                iField, poDefn->GetFieldDefn(iField)->GetType());
+            if( pValue != NULL )
+                memcpy(pValue, psField, sizeof(OGRField));
+            break;
+        }
+
+        case OFTIntegerList:
+        {
+            const size_t nSize = psField->IntegerList.nCount * sizeof(int);
+            GByte *pabyDst = AllocVariableValue(aoFields[iField], nSize);
+            if( nSize > 0 )
+                memcpy(pabyDst, psField->IntegerList.paList, nSize);
+            break;
+        }
+
+        case OFTInteger64List:
+        {
+            const size_t nSize =
+                psField->Integer64List.nCount * sizeof(GIntBig);
+            GByte *pabyDst = AllocVariableValue(aoFields[iField], nSize);
+            if( nSize > 0 )
+                memcpy(pabyDst, psField->Integer64List.paList, nSize);
+            break;
+        }
+
+        case OFTRealList:
+        {
+            const size_t nSize = psField->RealList.nCount * sizeof(double);
+            GByte *pabyDst = AllocVariableValue(aoFields[iField], nSize);
+            if( nSize > 0 )
+                memcpy(pabyDst, psField->RealList.paList, nSize);
+            break;
+        }
+
+        case OFTStringList:
+        {
+            size_t nSize = 0;
+            for( int i = 0; i < psField->StringList.nCount; i++ )
+                nSize += strlen(psField->StringList.paList[i]) + 1;
+            GByte *pabyDst = AllocVariableValue(aoFields[iField], nSize);
+            for( int i = 0; i < psField->StringList.nCount; i++ )
+            {
+                const size_t nLen = strlen(psField->StringList.paList[i]) + 1;
+                memcpy(pabyDst, psField->StringList.paList[i], nLen);
+                pabyDst += nLen;
+            }
+            break;
+        }
+
+        default:
+            // Deprecated OFTWideString and OFTWideStringList.
+            break;
+    }
+}
+
+/************************************************************************/
+/*                          SetGeomFieldWKB()                           */
+/************************************************************************/
+
+/* Set the geometry of a geometry field from ISO WKB in little endian order. */
+
+void OGRFeatureBatch::SetGeomFieldWKB( int iGeomField, const GByte *pabyWKB,
+                                       size_t nWKBSize )
+{
+    GByte *pabyDst = AllocVariableValue(aoGeomFields[iGeomField], nWKBSize);
+    if( nWKBSize > 0 )
+        memcpy(pabyDst, pabyWKB, nWKBSize);
+}
+
+/************************************************************************/
+/*                            SetGeomField()                            */
+/************************************************************************/
+
+OGRErr OGRFeatureBatch::SetGeomField( int iGeomField,
+                                      const OGRGeometry *poGeom )
+{
+    if( poGeom == NULL )
+        return OGRERR_NONE;
+
+    Column& oColumn = aoGeomFields[iGeomField];
+    const size_t nOldSize = oColumn.abyData.size();
+    GByte *pabyDst = AllocVariableValue(oColumn, poGeom->WkbSize());
+    const OGRErr eErr = poGeom->exportToWkb(wkbNDR, pabyDst, wkbVariantIso);
+    if( eErr != OGRERR_NONE )
+    {
+        // Leave the geometry null.
+        oColumn.abyData.resize(nOldSize);
+        oColumn.anOffsets.back() = static_cast<GIntBig>(nOldSize);
+        oColumn.abyValidity.back() &=
+            static_cast<GByte>(~(1 << ((nFeatureCount - 1) % 8)));
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                           AddFeatureFrom()                           */
+/************************************************************************/
+
+/* Add a feature with the content of an OGRFeature of the same definition */
+/* as the batch, except the ignored fields, and return its index. */
+
+int OGRFeatureBatch::AddFeatureFrom( OGRFeature *poFeature )
+{
+    const int iFeature = AddFeature(poFeature->GetFID());
+
+    for( size_t i = 0; i < aoFields.size(); i++ )
+    {
+        const int iField = static_cast<int>(i);
+        if( !poDefn->GetFieldDefn(iField)->IsIgnored() &&
+            poFeature->IsFieldSetAndNotNull(iField) )
+        {
+            SetFieldRaw(iField, poFeature->GetRawFieldRef(iField));
+        }
+    }
+
+    for( size_t i = 0; i < aoGeomFields.size(); i++ )
+    {
+        const int iGeomField = static_cast<int>(i);
+        if( !poDefn->GetGeomFieldDefn(iGeomField)->IsIgnored() )
+        {
+            CPL_IGNORE_RET_VAL(
+                SetGeomField(iGeomField,
+                             poFeature->GetGeomFieldRef(iGeomField)));
+        }
+    }
+
+    return iFeature;
+}
+
+//! @endcond
+
+/************************************************************************/
+/*                           OGR_FB_Create()                            */
+/************************************************************************/
+
+/**
+ * \brief Create an empty feature batch.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::OGRFeatureBatch().
+ *
+ * @return an handle to the new feature batch, to be destroyed with
+ * OGR_FB_Destroy().
+ *
+ * @since GDAL 2.3
+ */
+
+OGRFeatureBatchH OGR_FB_Create()
+
+{
+    return reinterpret_cast<OGRFeatureBatchH>(new OGRFeatureBatch());
+}
+
+/************************************************************************/
+/*                           OGR_FB_Destroy()                           */
+/************************************************************************/
+
+/**
+ * \brief Destroy a feature batch.
+ *
+ * @param hBatch handle to the feature batch to destroy.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGR_FB_Destroy( OGRFeatureBatchH hBatch )
+
+{
+    delete reinterpret_cast<OGRFeatureBatch *>(hBatch);
+}
+
+/************************************************************************/
+/*                       OGR_FB_GetFeatureCount()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the number of features in a batch.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFeatureCount().
+ *
+ * @param hBatch handle to the feature batch.
+ * @return the number of features.
+ *
+ * @since GDAL 2.3
+ */
+
+int OGR_FB_GetFeatureCount( OGRFeatureBatchH hBatch )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFeatureCount", 0 );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->GetFeatureCount();
+}
+
+/************************************************************************/
+/*                           OGR_FB_GetFIDs()                           */
+/************************************************************************/
+
+/**
+ * \brief Return the array of the feature identifiers of a batch.
+ *
+ * This function is the same as the C++ method OGRFeatureBatch::GetFIDs().
+ *
+ * @param hBatch handle to the feature batch.
+ * @return an array of OGR_FB_GetFeatureCount() values, or NULL if the batch
+ * is empty.
+ *
+ * @since GDAL 2.3
+ */
+
+const GIntBig *OGR_FB_GetFIDs( OGRFeatureBatchH hBatch )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFIDs", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->GetFIDs();
+}
+
+/************************************************************************/
+/*                      OGR_FB_GetFieldValidity()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of a field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldValidity().
+ *
+ * @param hBatch handle to the feature batch.
+ * @param iField the field index.
+ * @return a bitmap of (OGR_FB_GetFeatureCount() + 7) / 8 bytes, or NULL.
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte *OGR_FB_GetFieldValidity( OGRFeatureBatchH hBatch, int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldValidity", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                                    GetFieldValidity(iField);
+}
+
+/************************************************************************/
+/*                        OGR_FB_GetFieldData()                         */
+/************************************************************************/
+
+/**
+ * \brief Return the values of a field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldData().
+ *
+ * @param hBatch handle to the feature batch.
+ * @param iField the field index.
+ * @return the values, or NULL if there are none.
+ *
+ * @since GDAL 2.3
+ */
+
+const void *OGR_FB_GetFieldData( OGRFeatureBatchH hBatch, int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldData", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->GetFieldData(iField);
+}
+
+/************************************************************************/
+/*                       OGR_FB_GetFieldOffsets()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the byte offsets of the values of a variable size field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetFieldOffsets().
+ *
+ * @param hBatch handle to the feature batch.
+ * @param iField the field index.
+ * @return an array of OGR_FB_GetFeatureCount() + 1 offsets, or NULL if the
+ * field type has fixed size values.
+ *
+ * @since GDAL 2.3
+ */
+
+const GIntBig *OGR_FB_GetFieldOffsets( OGRFeatureBatchH hBatch, int iField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetFieldOffsets", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                                    GetFieldOffsets(iField);
+}
+
+/************************************************************************/
+/*                    OGR_FB_GetGeomFieldValidity()                     */
+/************************************************************************/
+
+/**
+ * \brief Return the validity bitmap of a geometry field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetGeomFieldValidity().
+ *
+ * @param hBatch handle to the feature batch.
+ * @param iGeomField the geometry field index.
+ * @return a bitmap of (OGR_FB_GetFeatureCount() + 7) / 8 bytes, or NULL.
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte *OGR_FB_GetGeomFieldValidity( OGRFeatureBatchH hBatch,
+                                          int iGeomField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetGeomFieldValidity", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                            GetGeomFieldValidity(iGeomField);
+}
+
+/************************************************************************/
+/*                      OGR_FB_GetGeomFieldData()                       */
+/************************************************************************/
+
+/**
+ * \brief Return the concatenated WKB geometries of a geometry field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetGeomFieldData().
+ *
+ * @param hBatch handle to the feature batch.
+ * @param iGeomField the geometry field index.
+ * @return the WKB geometries, or NULL if there are none.
+ *
+ * @since GDAL 2.3
+ */
+
+const GByte *OGR_FB_GetGeomFieldData( OGRFeatureBatchH hBatch,
+                                      int iGeomField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetGeomFieldData", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                                GetGeomFieldData(iGeomField);
+}
+
+/************************************************************************/
+/*                     OGR_FB_GetGeomFieldOffsets()                     */
+/************************************************************************/
+
+/**
+ * \brief Return the byte offsets of the WKB geometries of a geometry field.
+ *
+ * This function is the same as the C++ method
+ * OGRFeatureBatch::GetGeomFieldOffsets().
+ *
+ * @param hBatch handle to the feature batch.
+ * @param iGeomField the geometry field index.
+ * @return an array of OGR_FB_GetFeatureCount() + 1 offsets, or NULL.
+ *
+ * @since GDAL 2.3
+ */
+
+const GIntBig *OGR_FB_GetGeomFieldOffsets( OGRFeatureBatchH hBatch,
+                                           int iGeomField )
+
+{
+    VALIDATE_POINTER1( hBatch, "OGR_FB_GetGeomFieldOffsets", NULL );
+
+    return reinterpret_cast<OGRFeatureBatch *>(hBatch)->
+                                            GetGeomFieldOffsets(iGeomField);
+}
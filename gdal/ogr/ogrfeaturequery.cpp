@@ -32,9 +32,12 @@
 #include "ogr_feature.h"
 #include "swq.h"
 
+#include <cmath>
 #include <cstddef>
 #include <cstdlib>
+#include <cstring>
 #include <algorithm>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -57,13 +60,579 @@ const char *const SpecialFieldNames[SPECIAL_FIELD_COUNT] = {
 const swq_field_type SpecialFieldTypes[SPECIAL_FIELD_COUNT] = {
     SWQ_INTEGER, SWQ_STRING, SWQ_STRING, SWQ_STRING, SWQ_FLOAT};
 
+/************************************************************************/
+/*                         OGRFeatureFetcher()                          */
+/************************************************************************/
+
+static swq_expr_node *OGRFeatureFetcher( swq_expr_node *op, void *pFeatureIn )
+
+{
+    OGRFeature *poFeature = static_cast<OGRFeature *>(pFeatureIn);
+
+    if( op->field_type == SWQ_GEOMETRY )
+    {
+        const int iField =
+            op->field_index -
+            (poFeature->GetFieldCount() + SPECIAL_FIELD_COUNT);
+        swq_expr_node *poRetNode =
+            new swq_expr_node(poFeature->GetGeomFieldRef(iField));
+        return poRetNode;
+    }
+
+    swq_expr_node *poRetNode = NULL;
+    switch( op->field_type )
+    {
+      case SWQ_INTEGER:
+      case SWQ_BOOLEAN:
+        poRetNode = new swq_expr_node(
+            poFeature->GetFieldAsInteger(op->field_index) );
+        break;
+
+      case SWQ_INTEGER64:
+        poRetNode = new swq_expr_node(
+            poFeature->GetFieldAsInteger64(op->field_index) );
+        break;
+
+      case SWQ_FLOAT:
+        poRetNode = new swq_expr_node(
+            poFeature->GetFieldAsDouble(op->field_index) );
+        break;
+
+      case SWQ_TIMESTAMP:
+        poRetNode = new swq_expr_node(
+            poFeature->GetFieldAsString(op->field_index) );
+        poRetNode->MarkAsTimestamp();
+        break;
+
+      default:
+        poRetNode = new swq_expr_node(
+            poFeature->GetFieldAsString(op->field_index) );
+        break;
+    }
+
+    poRetNode->is_null = !(poFeature->IsFieldSetAndNotNull(op->field_index));
+
+    return poRetNode;
+}
+
+/************************************************************************/
+/*                        OGRFeatureQueryProgram                        */
+/*                                                                      */
+/*      Flattened form of an attribute filter, built once at compile    */
+/*      time.  The usual building blocks of filters (AND, OR, NOT,      */
+/*      comparisons, IN, BETWEEN, LIKE and IS NULL between a field and  */
+/*      constants) are evaluated directly on the feature fields,        */
+/*      without allocating intermediate swq_expr_node results.  Any     */
+/*      other sub-expression is evaluated with the generic              */
+/*      swq_expr_node::Evaluate().                                      */
+/*                                                                      */
+/*      Results follow the semantics of SWQGeneralEvaluator(): a        */
+/*      comparison involving a NULL value is false, and a NULL operand  */
+/*      of a logical operator makes it false.                           */
+/************************************************************************/
+
+typedef enum
+{
+    QOP_GENERIC,
+    QOP_AND,
+    QOP_OR,
+    QOP_NOT,
+    QOP_ISNULL,
+    QOP_COMPARE,
+    QOP_IN,
+    QOP_BETWEEN,
+    QOP_LIKE
+} OGRFeatureQueryOpcode;
+
+// How swq would compare the values: see the branches of
+// SWQGeneralEvaluator().
+typedef enum
+{
+    QVT_INTEGER,
+    QVT_REAL,
+    QVT_STRING
+} OGRFeatureQueryValueType;
+
+// Evaluation result of an instruction. NULL and ERROR are only produced by
+// generic sub-expressions. Like with swq_expr_node::Evaluate(), an error
+// anywhere makes the whole expression false.
+static const int QRES_FALSE = 0;
+static const int QRES_TRUE = 1;
+static const int QRES_NULL = -1;
+static const int QRES_ERROR = -2;
+
+struct OGRFeatureQueryInstr
+{
+    OGRFeatureQueryOpcode    eOpcode;
+    int                      nOperation;
+    int                      iField;
+    swq_field_type           eFieldType;
+    OGRFeatureQueryValueType eValueType;
+    int                      iChild1;
+    int                      iChild2;
+    int                      iFirstConst;
+    int                      nConstCount;
+    char                     chEscape;
+    bool                     bNeverNull;
+    bool                     bMayFail;
+    swq_expr_node           *poExpr;
+};
+
+class OGRFeatureQueryProgram
+{
+        std::vector<OGRFeatureQueryInstr> m_asInstr;
+        std::vector<GIntBig>              m_anConsts;
+        std::vector<double>               m_adfConsts;
+        std::vector<CPLString>            m_aosConsts;
+        int                               m_nFieldCount;
+
+        int         Emit( swq_expr_node* poExpr );
+        int         EmitGeneric( swq_expr_node* poExpr );
+        bool        EmitConstants( swq_expr_node** papoConsts, int nCount,
+                                   OGRFeatureQueryValueType eValueType,
+                                   OGRFeatureQueryInstr& sInstr );
+        bool        IsSupportedColumn( swq_expr_node* poExpr ) const;
+        int         Run( int iInstr, OGRFeature* poFeature ) const;
+
+    public:
+        explicit    OGRFeatureQueryProgram( swq_expr_node* poExpr,
+                                            OGRFeatureDefn* poDefn );
+
+        bool        IsGenericOnly() const
+                        { return m_asInstr.back().eOpcode == QOP_GENERIC; }
+        int         Evaluate( OGRFeature* poFeature ) const
+            { return Run(static_cast<int>(m_asInstr.size()) - 1,
+                         poFeature) == QRES_TRUE; }
+};
+
+OGRFeatureQueryProgram::OGRFeatureQueryProgram( swq_expr_node* poExpr,
+                                                OGRFeatureDefn* poDefn ) :
+    m_nFieldCount(poDefn->GetFieldCount())
+{
+    // Children are emitted before their parent, so the root is last.
+    Emit(poExpr);
+}
+
+/************************************************************************/
+/*                          IsSupportedColumn()                         */
+/*                                                                      */
+/*      Regular attribute field, or FID, whose value can be read        */
+/*      without going through a string representation.                  */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::IsSupportedColumn( swq_expr_node* poExpr ) const
+{
+    if( poExpr->eNodeType != SNT_COLUMN || poExpr->table_index != 0 )
+        return false;
+    if( poExpr->field_index == m_nFieldCount + SPF_FID )
+        return poExpr->field_type == SWQ_INTEGER64;
+    if( poExpr->field_index < 0 || poExpr->field_index >= m_nFieldCount )
+        return false;
+    return poExpr->field_type == SWQ_INTEGER ||
+           poExpr->field_type == SWQ_INTEGER64 ||
+           poExpr->field_type == SWQ_BOOLEAN ||
+           poExpr->field_type == SWQ_FLOAT ||
+           poExpr->field_type == SWQ_STRING;
+}
+
+/************************************************************************/
+/*                            EmitGeneric()                             */
+/************************************************************************/
+
+int OGRFeatureQueryProgram::EmitGeneric( swq_expr_node* poExpr )
+{
+    OGRFeatureQueryInstr sInstr;
+    memset(&sInstr, 0, sizeof(sInstr));
+    sInstr.eOpcode = QOP_GENERIC;
+    sInstr.bMayFail = true;
+    sInstr.poExpr = poExpr;
+    m_asInstr.push_back(sInstr);
+    return static_cast<int>(m_asInstr.size()) - 1;
+}
+
+/************************************************************************/
+/*                           EmitConstants()                            */
+/*                                                                      */
+/*      Store the constant operands compared to the field, provided     */
+/*      they are not NULL and their type matches eValueType.            */
+/************************************************************************/
+
+bool OGRFeatureQueryProgram::EmitConstants(
+    swq_expr_node** papoConsts, int nCount,
+    OGRFeatureQueryValueType eValueType, OGRFeatureQueryInstr& sInstr )
+{
+    for( int i = 0; i < nCount; i++ )
+    {
+        swq_expr_node* poConst = papoConsts[i];
+        if( poConst->eNodeType != SNT_CONSTANT || poConst->is_null )
+            return false;
+        const swq_field_type eType = poConst->field_type;
+        if( eValueType == QVT_STRING && eType != SWQ_STRING )
+            return false;
+        if( eValueType == QVT_INTEGER &&
+            !(SWQ_IS_INTEGER(eType) || eType == SWQ_BOOLEAN) )
+            return false;
+        // swq only promotes the first two operands of an operation from
+        // integer to float, that is the field and the first constant.
+        if( eValueType == QVT_REAL &&
+            !(eType == SWQ_FLOAT || (i == 0 && SWQ_IS_INTEGER(eType))) )
+            return false;
+    }
+
+    if( eValueType == QVT_INTEGER )
+        sInstr.iFirstConst = static_cast<int>(m_anConsts.size());
+    else if( eValueType == QVT_REAL )
+        sInstr.iFirstConst = static_cast<int>(m_adfConsts.size());
+    else
+        sInstr.iFirstConst = static_cast<int>(m_aosConsts.size());
+    sInstr.nConstCount = nCount;
+
+    for( int i = 0; i < nCount; i++ )
+    {
+        swq_expr_node* poConst = papoConsts[i];
+        if( eValueType == QVT_INTEGER )
+            m_anConsts.push_back(poConst->int_value);
+        else if( eValueType == QVT_REAL )
+            m_adfConsts.push_back(poConst->field_type == SWQ_FLOAT ?
+                                  poConst->float_value :
+                                  static_cast<double>(poConst->int_value));
+        else
+            m_aosConsts.push_back(poConst->string_value);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                                Emit()                                */
+/*                                                                      */
+/*      Compile the expression and return the index of its instruction. */
+/************************************************************************/
+
+int OGRFeatureQueryProgram::Emit( swq_expr_node* poExpr )
+{
+    if( poExpr->eNodeType != SNT_OPERATION )
+        return EmitGeneric(poExpr);
+
+    OGRFeatureQueryInstr sInstr;
+    memset(&sInstr, 0, sizeof(sInstr));
+    sInstr.nOperation = poExpr->nOperation;
+    sInstr.bNeverNull = true;
+
+    const int nSubExprCount = poExpr->nSubExprCount;
+    swq_expr_node** papoSubExpr = poExpr->papoSubExpr;
+
+/* -------------------------------------------------------------------- */
+/*      Logical operators over boolean sub-expressions.                 */
+/* -------------------------------------------------------------------- */
+    if( (poExpr->nOperation == SWQ_AND && nSubExprCount == 2) ||
+        (poExpr->nOperation == SWQ_OR && nSubExprCount == 2) ||
+        (poExpr->nOperation == SWQ_NOT && nSubExprCount == 1) )
+    {
+        for( int i = 0; i < nSubExprCount; i++ )
+        {
+            const swq_field_type eType = papoSubExpr[i]->field_type;
+            if( !(SWQ_IS_INTEGER(eType) || eType == SWQ_BOOLEAN) )
+                return EmitGeneric(poExpr);
+        }
+        sInstr.eOpcode = poExpr->nOperation == SWQ_AND ? QOP_AND :
+                         poExpr->nOperation == SWQ_OR ? QOP_OR : QOP_NOT;
+        sInstr.iChild1 = Emit(papoSubExpr[0]);
+        sInstr.bMayFail = m_asInstr[sInstr.iChild1].bMayFail;
+        if( nSubExprCount == 2 )
+        {
+            sInstr.iChild2 = Emit(papoSubExpr[1]);
+            sInstr.bMayFail |= m_asInstr[sInstr.iChild2].bMayFail;
+        }
+        m_asInstr.push_back(sInstr);
+        return static_cast<int>(m_asInstr.size()) - 1;
+    }
+
+    if( poExpr->nOperation == SWQ_ISNULL && nSubExprCount == 1 &&
+        IsSupportedColumn(papoSubExpr[0]) )
+    {
+        sInstr.eOpcode = QOP_ISNULL;
+        sInstr.iField = papoSubExpr[0]->field_index;
+        m_asInstr.push_back(sInstr);
+        return static_cast<int>(m_asInstr.size()) - 1;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Comparisons between a field and constants.  For binary          */
+/*      comparisons, the constant may come first.                       */
+/* -------------------------------------------------------------------- */
+    bool bSwap = false;
+    switch( poExpr->nOperation )
+    {
+        case SWQ_EQ:
+        case SWQ_NE:
+        case SWQ_LT:
+        case SWQ_LE:
+        case SWQ_GT:
+        case SWQ_GE:
+            if( nSubExprCount != 2 )
+                return EmitGeneric(poExpr);
+            sInstr.eOpcode = QOP_COMPARE;
+            bSwap = !IsSupportedColumn(papoSubExpr[0]) &&
+                    IsSupportedColumn(papoSubExpr[1]);
+            break;
+        case SWQ_IN:
+            if( nSubExprCount < 2 )
+                return EmitGeneric(poExpr);
+            sInstr.eOpcode = QOP_IN;
+            break;
+        case SWQ_BETWEEN:
+            if( nSubExprCount != 3 )
+                return EmitGeneric(poExpr);
+            sInstr.eOpcode = QOP_BETWEEN;
+            break;
+        case SWQ_LIKE:
+            if( nSubExprCount != 2 && nSubExprCount != 3 )
+                return EmitGeneric(poExpr);
+            sInstr.eOpcode = QOP_LIKE;
+            break;
+        default:
+            return EmitGeneric(poExpr);
+    }
+
+    swq_expr_node* poColumn = papoSubExpr[bSwap ? 1 : 0];
+    swq_expr_node* poFirstConst = papoSubExpr[bSwap ? 0 : 1];
+    if( !IsSupportedColumn(poColumn) )
+        return EmitGeneric(poExpr);
+    sInstr.iField = poColumn->field_index;
+    sInstr.eFieldType = poColumn->field_type;
+
+    if( poColumn->field_type == SWQ_FLOAT ||
+        poFirstConst->field_type == SWQ_FLOAT )
+        sInstr.eValueType = QVT_REAL;
+    else if( SWQ_IS_INTEGER(poColumn->field_type) ||
+             poColumn->field_type == SWQ_BOOLEAN )
+        sInstr.eValueType = QVT_INTEGER;
+    else
+        sInstr.eValueType = QVT_STRING;
+
+    if( sInstr.eOpcode == QOP_LIKE )
+    {
+        if( sInstr.eValueType != QVT_STRING ||
+            !EmitConstants(papoSubExpr + 1, 1, QVT_STRING, sInstr) )
+            return EmitGeneric(poExpr);
+        if( nSubExprCount == 3 )
+        {
+            swq_expr_node* poEscape = papoSubExpr[2];
+            if( poEscape->eNodeType != SNT_CONSTANT ||
+                poEscape->field_type != SWQ_STRING || poEscape->is_null )
+            {
+                m_aosConsts.pop_back();
+                return EmitGeneric(poExpr);
+            }
+            sInstr.chEscape = poEscape->string_value[0];
+        }
+        m_asInstr.push_back(sInstr);
+        return static_cast<int>(m_asInstr.size()) - 1;
+    }
+
+    // String equality has special rules for timestamps with a +00
+    // timezone, which depend on the field value.
+    if( sInstr.eValueType == QVT_STRING && sInstr.nOperation == SWQ_EQ &&
+        poFirstConst->eNodeType == SNT_CONSTANT &&
+        poFirstConst->field_type == SWQ_STRING && !poFirstConst->is_null )
+    {
+        const char* pszConst = poFirstConst->string_value;
+        const size_t nLen = strlen(pszConst);
+        if( nLen > 3 && (pszConst[nLen - 3] == ':' ||
+                         strcmp(pszConst + nLen - 3, "+00") == 0) )
+            return EmitGeneric(poExpr);
+    }
+
+    if( bSwap )
+    {
+        // Compare the field to the constant with the mirrored operator.
+        if( !EmitConstants(papoSubExpr, 1, sInstr.eValueType, sInstr) )
+            return EmitGeneric(poExpr);
+        switch( poExpr->nOperation )
+        {
+            case SWQ_LT: sInstr.nOperation = SWQ_GT; break;
+            case SWQ_LE: sInstr.nOperation = SWQ_GE; break;
+            case SWQ_GT: sInstr.nOperation = SWQ_LT; break;
+            case SWQ_GE: sInstr.nOperation = SWQ_LE; break;
+            default: break;
+        }
+    }
+    else if( !EmitConstants(papoSubExpr + 1, nSubExprCount - 1,
+                            sInstr.eValueType, sInstr) )
+    {
+        return EmitGeneric(poExpr);
+    }
+
+    m_asInstr.push_back(sInstr);
+    return static_cast<int>(m_asInstr.size()) - 1;
+}
+
+/************************************************************************/
+/*                                Run()                                 */
+/************************************************************************/
+
+template<class T> static bool OGRFeatureQueryCompare( int nOperation,
+                                                      const T& a, const T& b )
+{
+    switch( nOperation )
+    {
+        case SWQ_EQ: return a == b;
+        case SWQ_NE: return a != b;
+        case SWQ_LT: return a < b;
+        case SWQ_LE: return a <= b;
+        case SWQ_GT: return a > b;
+        case SWQ_GE: return a >= b;
+        default: return false;
+    }
+}
+
+int OGRFeatureQueryProgram::Run( int iInstr, OGRFeature* poFeature ) const
+{
+    const OGRFeatureQueryInstr& sInstr = m_asInstr[iInstr];
+
+    switch( sInstr.eOpcode )
+    {
+        case QOP_GENERIC:
+        {
+            swq_expr_node *poResult =
+                sInstr.poExpr->Evaluate(OGRFeatureFetcher, poFeature);
+            if( poResult == NULL )
+                return QRES_ERROR;
+            int nRet = QRES_FALSE;
+            if( poResult->is_null )
+                nRet = QRES_NULL;
+            else if( SWQ_IS_INTEGER(poResult->field_type) ||
+                     poResult->field_type == SWQ_BOOLEAN )
+                nRet = poResult->int_value != 0 ? QRES_TRUE : QRES_FALSE;
+            delete poResult;
+            return nRet;
+        }
+
+        // Short-circuit evaluation is only done when skipping the second
+        // operand cannot hide an error or a NULL.
+        case QOP_AND:
+        {
+            const OGRFeatureQueryInstr& sChild2 = m_asInstr[sInstr.iChild2];
+            const int nRes1 = Run(sInstr.iChild1, poFeature);
+            if( nRes1 == QRES_ERROR ||
+                (nRes1 != QRES_TRUE && !sChild2.bMayFail) )
+                return nRes1 == QRES_ERROR ? QRES_ERROR : QRES_FALSE;
+            const int nRes2 = Run(sInstr.iChild2, poFeature);
+            if( nRes2 == QRES_ERROR )
+                return QRES_ERROR;
+            return nRes1 == QRES_TRUE && nRes2 == QRES_TRUE ?
+                                                    QRES_TRUE : QRES_FALSE;
+        }
+
+        case QOP_OR:
+        {
+            const OGRFeatureQueryInstr& sChild2 = m_asInstr[sInstr.iChild2];
+            const int nRes1 = Run(sInstr.iChild1, poFeature);
+            if( nRes1 == QRES_ERROR )
+                return QRES_ERROR;
+            if( !sChild2.bMayFail )
+            {
+                if( nRes1 == QRES_NULL )
+                    return QRES_FALSE;
+                if( nRes1 == QRES_TRUE && sChild2.bNeverNull )
+                    return QRES_TRUE;
+            }
+            const int nRes2 = Run(sInstr.iChild2, poFeature);
+            if( nRes2 == QRES_ERROR )
+                return QRES_ERROR;
+            if( nRes1 == QRES_NULL || nRes2 == QRES_NULL )
+                return QRES_FALSE;
+            return nRes1 == QRES_TRUE || nRes2 == QRES_TRUE ?
+                                                    QRES_TRUE : QRES_FALSE;
+        }
+
+        case QOP_NOT:
+        {
+            const int nRes = Run(sInstr.iChild1, poFeature);
+            if( nRes == QRES_ERROR )
+                return QRES_ERROR;
+            return nRes == QRES_FALSE ? QRES_TRUE : QRES_FALSE;
+        }
+
+        case QOP_ISNULL:
+            return poFeature->IsFieldSetAndNotNull(sInstr.iField) ?
+                                                    QRES_FALSE : QRES_TRUE;
+
+        default:
+            break;
+    }
+
+    if( !poFeature->IsFieldSetAndNotNull(sInstr.iField) )
+        return QRES_FALSE;
+
+    bool bRes = false;
+    if( sInstr.eValueType == QVT_INTEGER )
+    {
+        const GIntBig nVal =
+            sInstr.eFieldType == SWQ_INTEGER64 ?
+                poFeature->GetFieldAsInteger64(sInstr.iField) :
+                static_cast<GIntBig>(
+                    poFeature->GetFieldAsInteger(sInstr.iField));
+        const GIntBig* panConsts = &m_anConsts[sInstr.iFirstConst];
+        if( sInstr.eOpcode == QOP_COMPARE )
+            bRes = OGRFeatureQueryCompare(sInstr.nOperation,
+                                          nVal, panConsts[0]);
+        else if( sInstr.eOpcode == QOP_BETWEEN )
+            bRes = nVal >= panConsts[0] && nVal <= panConsts[1];
+        else
+            bRes = std::find(panConsts, panConsts + sInstr.nConstCount,
+                             nVal) != panConsts + sInstr.nConstCount;
+    }
+    else if( sInstr.eValueType == QVT_REAL )
+    {
+        const double dfVal =
+            sInstr.eFieldType == SWQ_FLOAT ?
+                poFeature->GetFieldAsDouble(sInstr.iField) :
+            sInstr.eFieldType == SWQ_INTEGER64 ?
+                static_cast<double>(
+                    poFeature->GetFieldAsInteger64(sInstr.iField)) :
+                static_cast<double>(
+                    poFeature->GetFieldAsInteger(sInstr.iField));
+        const double* padfConsts = &m_adfConsts[sInstr.iFirstConst];
+        if( sInstr.eOpcode == QOP_COMPARE )
+            bRes = OGRFeatureQueryCompare(sInstr.nOperation,
+                                          dfVal, padfConsts[0]);
+        else if( sInstr.eOpcode == QOP_BETWEEN )
+            bRes = dfVal >= padfConsts[0] && dfVal <= padfConsts[1];
+        else
+            bRes = std::find(padfConsts, padfConsts + sInstr.nConstCount,
+                             dfVal) != padfConsts + sInstr.nConstCount;
+    }
+    else
+    {
+        const char* pszVal = poFeature->GetFieldAsString(sInstr.iField);
+        const CPLString* posConsts = &m_aosConsts[sInstr.iFirstConst];
+        if( sInstr.eOpcode == QOP_COMPARE )
+            bRes = OGRFeatureQueryCompare(sInstr.nOperation,
+                                          strcasecmp(pszVal, posConsts[0]), 0);
+        else if( sInstr.eOpcode == QOP_BETWEEN )
+            bRes = strcasecmp(pszVal, posConsts[0]) >= 0 &&
+                   strcasecmp(pszVal, posConsts[1]) <= 0;
+        else if( sInstr.eOpcode == QOP_LIKE )
+            bRes = CPL_TO_BOOL(swq_test_like(pszVal, posConsts[0],
+                                             sInstr.chEscape));
+        else
+        {
+            for( int i = 0; !bRes && i < sInstr.nConstCount; i++ )
+                bRes = strcasecmp(pszVal, posConsts[i]) == 0;
+        }
+    }
+    return bRes ? QRES_TRUE : QRES_FALSE;
+}
+
 /************************************************************************/
 /*                          OGRFeatureQuery()                           */
 /************************************************************************/
 
 OGRFeatureQuery::OGRFeatureQuery() :
     poTargetDefn(NULL),
-    pSWQExpr(NULL)
+    pSWQExpr(NULL),
+    pCompiledExpr(NULL)
 {}
 
 /************************************************************************/
@@ -73,6 +642,7 @@ OGRFeatureQuery::OGRFeatureQuery() :
 OGRFeatureQuery::~OGRFeatureQuery()
 
 {
+    delete static_cast<OGRFeatureQueryProgram *>(pCompiledExpr);
     delete static_cast<swq_expr_node *>(pSWQExpr);
 }
 
@@ -88,6 +658,8 @@ OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
 
 {
     // Clear any existing expression.
+    delete static_cast<OGRFeatureQueryProgram *>(pCompiledExpr);
+    pCompiledExpr = NULL;
     if( pSWQExpr != NULL )
     {
         delete static_cast<swq_expr_node *>(pSWQExpr);
@@ -188,6 +760,17 @@ OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
         eErr = OGRERR_CORRUPT_DATA;
         pSWQExpr = NULL;
     }
+    // The compiled form relies on the field types resolved by the checker.
+    else if( bCheck &&
+             CPLTestBool(CPLGetConfigOption("OGR_SQL_COMPILE_FILTER", "YES")) )
+    {
+        OGRFeatureQueryProgram* poProgram = new OGRFeatureQueryProgram(
+            static_cast<swq_expr_node *>(pSWQExpr), poDefn);
+        if( poProgram->IsGenericOnly() )
+            delete poProgram;
+        else
+            pCompiledExpr = poProgram;
+    }
 
     CPLFree(papszFieldNames);
     CPLFree(paeFieldTypes);
@@ -195,61 +778,6 @@ OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
     return eErr;
 }
 
-/************************************************************************/
-/*                         OGRFeatureFetcher()                          */
-/************************************************************************/
-
-static swq_expr_node *OGRFeatureFetcher( swq_expr_node *op, void *pFeatureIn )
-
-{
-    OGRFeature *poFeature = static_cast<OGRFeature *>(pFeatureIn);
-
-    if( op->field_type == SWQ_GEOMETRY )
-    {
-        const int iField =
-            op->field_index -
-            (poFeature->GetFieldCount() + SPECIAL_FIELD_COUNT);
-        swq_expr_node *poRetNode =
-            new swq_expr_node(poFeature->GetGeomFieldRef(iField));
-        return poRetNode;
-    }
-
-    swq_expr_node *poRetNode = NULL;
-    switch( op->field_type )
-    {
-      case SWQ_INTEGER:
-      case SWQ_BOOLEAN:
-        poRetNode = new swq_expr_node(
-            poFeature->GetFieldAsInteger(op->field_index) );
-        break;
-
-      case SWQ_INTEGER64:
-        poRetNode = new swq_expr_node(
-            poFeature->GetFieldAsInteger64(op->field_index) );
-        break;
-
-      case SWQ_FLOAT:
-        poRetNode = new swq_expr_node(
-            poFeature->GetFieldAsDouble(op->field_index) );
-        break;
-
-      case SWQ_TIMESTAMP:
-        poRetNode = new swq_expr_node(
-            poFeature->GetFieldAsString(op->field_index) );
-        poRetNode->MarkAsTimestamp();
-        break;
-
-      default:
-        poRetNode = new swq_expr_node(
-            poFeature->GetFieldAsString(op->field_index) );
-        break;
-    }
-
-    poRetNode->is_null = !(poFeature->IsFieldSetAndNotNull(op->field_index));
-
-    return poRetNode;
-}
-
 /************************************************************************/
 /*                              Evaluate()                              */
 /************************************************************************/
@@ -260,6 +788,10 @@ int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
     if( pSWQExpr == NULL )
         return FALSE;
 
+    if( pCompiledExpr != NULL )
+        return static_cast<OGRFeatureQueryProgram *>(pCompiledExpr)->
+            Evaluate(poFeature);
+
     swq_expr_node *poResult =
         static_cast<swq_expr_node *>(pSWQExpr)->
             Evaluate(OGRFeatureFetcher, poFeature);
@@ -278,6 +810,23 @@ int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
     return bLogicalResult;
 }
 
+/************************************************************************/
+/*                         OGRGetFieldAttrIndex()                       */
+/*                                                                      */
+/*      Return the index of a field, either a persistent one or one     */
+/*      built on demand by OGRLayer.                                    */
+/************************************************************************/
+
+static OGRAttrIndex *OGRGetFieldAttrIndex( OGRLayer *poLayer, int iField )
+{
+    OGRAttrIndex *poIndex = NULL;
+    if( poLayer->GetIndex() != NULL )
+        poIndex = poLayer->GetIndex()->GetFieldIndex(iField);
+    if( poIndex == NULL && poLayer->GetAutoIndex() != NULL )
+        poIndex = poLayer->GetAutoIndex()->GetFieldIndex(iField);
+    return poIndex;
+}
+
 /************************************************************************/
 /*                            CanUseIndex()                             */
 /************************************************************************/
@@ -287,7 +836,7 @@ int OGRFeatureQuery::CanUseIndex( OGRLayer *poLayer )
     swq_expr_node *psExpr = static_cast<swq_expr_node *>(pSWQExpr);
 
     // Do we have an index on the targeted layer?
-    if( poLayer->GetIndex() == NULL )
+    if( poLayer->GetIndex() == NULL && poLayer->GetAutoIndex() == NULL )
         return FALSE;
 
     return CanUseIndex(psExpr, poLayer);
@@ -319,7 +868,7 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
         return FALSE;
 
     OGRAttrIndex *poIndex =
-        poLayer->GetIndex()->GetFieldIndex(poColumn->field_index);
+        OGRGetFieldAttrIndex(poLayer, poColumn->field_index);
     if( poIndex == NULL )
         return FALSE;
 
@@ -336,23 +885,11 @@ int OGRFeatureQuery::CanUseIndex( swq_expr_node *psExpr,
 /*      available indices, or an "OGRNullFID" terminated list of        */
 /*      FIDs if it can.                                                 */
 /*                                                                      */
-/*      For now we only support equality tests on a single indexed      */
-/*      attribute field.  Eventually we should make this support        */
-/*      multi-part queries with ranges.                                 */
+/*      Equality, IN and range tests on indexed attribute fields are    */
+/*      supported, combined with AND and OR.  Range tests need an       */
+/*      index that implements GetRangeMatches().                        */
 /************************************************************************/
 
-static int CompareGIntBig( const void *pa, const void *pb )
-{
-    const GIntBig a = *(reinterpret_cast<const GIntBig *>(pa));
-    const GIntBig b = *(reinterpret_cast<const GIntBig *>(pb));
-    if( a < b )
-        return -1;
-    else if( a > b )
-        return 1;
-    else
-        return 0;
-}
-
 GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( OGRLayer *poLayer,
                                                   OGRErr *peErr )
 
@@ -363,7 +900,7 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( OGRLayer *poLayer,
         *peErr = OGRERR_NONE;
 
     // Do we have an index on the targeted layer?
-    if( poLayer->GetIndex() == NULL )
+    if( poLayer->GetIndex() == NULL && poLayer->GetAutoIndex() == NULL )
         return NULL;
 
     GIntBig nFIDCount = 0;
@@ -495,6 +1032,136 @@ GIntBig* OGRANDGIntBigArray( GIntBig panFIDList1[], GIntBig nFIDCount1,
     return panFIDList;
 }
 
+/************************************************************************/
+/*                      OGRGetRangeBoundFromNode()                      */
+/*                                                                      */
+/*      Convert a constant node into a bound of an index range          */
+/*      query on a field of the given type.  Non integral bounds on     */
+/*      integer fields are rounded inwards, which turns them into       */
+/*      inclusive bounds.                                               */
+/************************************************************************/
+
+static bool OGRGetRangeBoundFromNode( swq_expr_node *poValue,
+                                      OGRFieldType eType, bool bLowerBound,
+                                      OGRField *psBound, bool *pbIncluded )
+{
+    if( poValue->eNodeType != SNT_CONSTANT || poValue->is_null )
+        return false;
+
+    if( eType == OFTString )
+    {
+        if( poValue->field_type != SWQ_STRING )
+            return false;
+        psBound->String = poValue->string_value;
+        return true;
+    }
+
+    if( !SWQ_IS_INTEGER(poValue->field_type) &&
+        poValue->field_type != SWQ_FLOAT )
+        return false;
+
+    if( eType == OFTReal )
+    {
+        psBound->Real = poValue->field_type == SWQ_FLOAT ?
+            poValue->float_value : static_cast<double>(poValue->int_value);
+        return !CPLIsNan(psBound->Real);
+    }
+
+    if( poValue->field_type != SWQ_FLOAT )
+    {
+        psBound->Integer64 = poValue->int_value;
+        return true;
+    }
+
+    double dfValue = poValue->float_value;
+    if( !(dfValue > -9.0e18 && dfValue < 9.0e18) )
+        return false;
+    if( dfValue != floor(dfValue) )
+    {
+        dfValue = bLowerBound ? ceil(dfValue) : floor(dfValue);
+        *pbIncluded = true;
+    }
+    psBound->Integer64 = static_cast<GIntBig>(dfValue);
+    return true;
+}
+
+/************************************************************************/
+/*                     OGREvaluateRangeAgainstIndex()                   */
+/************************************************************************/
+
+static GIntBig *OGREvaluateRangeAgainstIndex( swq_expr_node *psExpr,
+                                              OGRAttrIndex *poIndex,
+                                              OGRFieldType eType,
+                                              GIntBig& nFIDCount )
+{
+    OGRField sMin;
+    OGRField sMax;
+    OGRField *psMin = NULL;
+    OGRField *psMax = NULL;
+    bool bMinIncluded = false;
+    bool bMaxIncluded = false;
+
+    switch( psExpr->nOperation )
+    {
+      case SWQ_GT:
+      case SWQ_GE:
+        bMinIncluded = psExpr->nOperation == SWQ_GE;
+        if( !OGRGetRangeBoundFromNode(psExpr->papoSubExpr[1], eType, true,
+                                      &sMin, &bMinIncluded) )
+            return NULL;
+        psMin = &sMin;
+        break;
+
+      case SWQ_LT:
+      case SWQ_LE:
+        bMaxIncluded = psExpr->nOperation == SWQ_LE;
+        if( !OGRGetRangeBoundFromNode(psExpr->papoSubExpr[1], eType, false,
+                                      &sMax, &bMaxIncluded) )
+            return NULL;
+        psMax = &sMax;
+        break;
+
+      case SWQ_BETWEEN:
+        bMinIncluded = true;
+        bMaxIncluded = true;
+        if( !OGRGetRangeBoundFromNode(psExpr->papoSubExpr[1], eType, true,
+                                      &sMin, &bMinIncluded) ||
+            !OGRGetRangeBoundFromNode(psExpr->papoSubExpr[2], eType, false,
+                                      &sMax, &bMaxIncluded) )
+            return NULL;
+        psMin = &sMin;
+        psMax = &sMax;
+        break;
+
+      default:
+        return NULL;
+    }
+
+    int nFIDCount32 = 0;
+    GIntBig *panFIDs = poIndex->GetRangeMatches( psMin, bMinIncluded,
+                                                 psMax, bMaxIncluded,
+                                                 &nFIDCount32 );
+    nFIDCount = nFIDCount32;
+    return panFIDs;
+}
+
+/************************************************************************/
+/*                          OGRUniqueFIDList()                          */
+/*                                                                      */
+/*      Sort a FID list, and remove duplicates, as can happen with      */
+/*      IN lists or indexes with stale entries.                         */
+/************************************************************************/
+
+static void OGRUniqueFIDList( GIntBig *panFIDs, GIntBig& nFIDCount )
+{
+    if( nFIDCount <= 1 )
+        return;
+
+    std::sort( panFIDs, panFIDs + nFIDCount );
+    nFIDCount = std::unique( panFIDs, panFIDs + nFIDCount ) - panFIDs;
+    panFIDs[nFIDCount] = OGRNullFID;
+}
+
 GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
                                                   OGRLayer *poLayer,
                                                   GIntBig& nFIDCount )
@@ -529,7 +1196,14 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
         return panFIDList;
     }
 
-    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN)
+    const bool bRange =
+        ((psExpr->nOperation == SWQ_GT || psExpr->nOperation == SWQ_GE ||
+          psExpr->nOperation == SWQ_LT || psExpr->nOperation == SWQ_LE) &&
+         psExpr->nSubExprCount == 2) ||
+        (psExpr->nOperation == SWQ_BETWEEN && psExpr->nSubExprCount == 3);
+
+    if( !(psExpr->nOperation == SWQ_EQ || psExpr->nOperation == SWQ_IN ||
+          bRange)
         || psExpr->nSubExprCount < 2 )
         return NULL;
 
@@ -541,7 +1215,7 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
         return NULL;
 
     OGRAttrIndex *poIndex =
-        poLayer->GetIndex()->GetFieldIndex(poColumn->field_index);
+        OGRGetFieldAttrIndex(poLayer, poColumn->field_index);
     if( poIndex == NULL )
         return NULL;
 
@@ -550,6 +1224,34 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
     OGRFieldDefn *poFieldDefn =
         poLayer->GetLayerDefn()->GetFieldDefn(poColumn->field_index);
 
+    if( bRange )
+        return OGREvaluateRangeAgainstIndex(psExpr, poIndex,
+                                            poFieldDefn->GetType(), nFIDCount);
+
+    // The values must be of the type of the field, and not be one of the
+    // timestamp strings the evaluator compares with a looser rule.
+    for( int iValue = 1; iValue < psExpr->nSubExprCount; iValue++ )
+    {
+        swq_expr_node *poSubExpr = psExpr->papoSubExpr[iValue];
+        if( poSubExpr->eNodeType != SNT_CONSTANT || poSubExpr->is_null )
+            return NULL;
+        if( poFieldDefn->GetType() == OFTString )
+        {
+            if( poSubExpr->field_type != SWQ_STRING )
+                return NULL;
+            const size_t nLen = strlen(poSubExpr->string_value);
+            if( nLen > 3 &&
+                (strcmp(poSubExpr->string_value + nLen - 3, "+00") == 0 ||
+                 poSubExpr->string_value[nLen - 3] == ':') )
+                return NULL;
+        }
+        else if( !SWQ_IS_INTEGER(poSubExpr->field_type) &&
+                 poSubExpr->field_type != SWQ_FLOAT )
+        {
+            return NULL;
+        }
+    }
+
     // Handle the case of an IN operation.
     if( psExpr->nOperation == SWQ_IN )
     {
@@ -597,12 +1299,9 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
             nFIDCount = nFIDCount32;
         }
 
-        if( nFIDCount > 1 )
-        {
-            // The returned FIDs are expected to be in sorted order.
-            qsort(panFIDs, static_cast<size_t>(nFIDCount),
-                  sizeof(GIntBig), CompareGIntBig);
-        }
+        // The returned FIDs are expected to be in sorted order.
+        if( panFIDs != NULL )
+            OGRUniqueFIDList(panFIDs, nFIDCount);
         return panFIDs;
     }
 
@@ -641,13 +1340,9 @@ GIntBig *OGRFeatureQuery::EvaluateAgainstIndices( swq_expr_node *psExpr,
     GIntBig* panFIDs =
         poIndex->GetAllMatches(&sValue, NULL, &nFIDCount32, &nLength);
     nFIDCount = nFIDCount32;
-    if( nFIDCount > 1 )
-    {
-        // The returned FIDs are expected to be sorted.
-        // TODO(schwehr): Use std::sort.
-        qsort(panFIDs, static_cast<size_t>(nFIDCount),
-              sizeof(GIntBig), CompareGIntBig);
-    }
+    // The returned FIDs are expected to be sorted.
+    if( panFIDs != NULL )
+        OGRUniqueFIDList(panFIDs, nFIDCount);
     return panFIDs;
 }
 
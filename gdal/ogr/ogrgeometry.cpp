@@ -31,6 +31,7 @@
 #include "ogr_geometry.h"
 
 #include <climits>
+#include <cmath>
 #include <cstdarg>
 #include <cstddef>
 #include <cstdio>
@@ -80,6 +81,38 @@ static void OGRGEOSWarningHandler(const char *fmt, ...)
     CPLErrorV( CE_Warning, CPLE_AppDefined, fmt, args );
     va_end(args);
 }
+
+static void OGRFreeThreadLocalGEOSContext( void* pData )
+{
+    finishGEOS_r( static_cast<GEOSContextHandle_t>(pData) );
+}
+
+// Returns a GEOS context owned by the calling thread, so that the spatial
+// predicates and operations do not have to initialize and destroy a new
+// context at each call. It is released when the thread terminates and must
+// not be passed to freeGEOSContext().
+static GEOSContextHandle_t OGRGetThreadLocalGEOSContext()
+{
+    int bMemoryError = FALSE;
+    GEOSContextHandle_t hGEOSCtxt = static_cast<GEOSContextHandle_t>(
+        CPLGetTLSEx( CTLS_GEOSCONTEXT, &bMemoryError ) );
+    if( bMemoryError )
+        return NULL;
+    if( hGEOSCtxt == NULL )
+    {
+        hGEOSCtxt = initGEOS_r( OGRGEOSWarningHandler, OGRGEOSErrorHandler );
+        if( hGEOSCtxt != NULL )
+            CPLSetTLSWithFreeFuncEx( CTLS_GEOSCONTEXT, hGEOSCtxt,
+                                     OGRFreeThreadLocalGEOSContext,
+                                     &bMemoryError );
+        if( bMemoryError )
+        {
+            finishGEOS_r( hGEOSCtxt );
+            return NULL;
+        }
+    }
+    return hGEOSCtxt;
+}
 #endif
 
 /************************************************************************/
@@ -90,6 +123,8 @@ OGRGeometry::OGRGeometry()
 
 {
     poSRS = NULL;
+    hGEOSCache = NULL;
+    bGEOSCacheEnabled = false;
     flags = 0;
 }
 
@@ -108,6 +143,8 @@ OGRGeometry::OGRGeometry()
 
 OGRGeometry::OGRGeometry( const OGRGeometry& other ) :
     poSRS(other.poSRS),
+    hGEOSCache(NULL),
+    bGEOSCacheEnabled(false),
     flags(other.flags)
 {
     if( poSRS != NULL )
@@ -123,6 +160,7 @@ OGRGeometry::~OGRGeometry()
 {
     if( poSRS != NULL )
         poSRS->Release();
+    invalidateGEOSCache();
 }
 
 /************************************************************************/
@@ -144,6 +182,7 @@ OGRGeometry& OGRGeometry::operator=( const OGRGeometry& other )
     {
         assignSpatialReference( other.getSpatialReference() );
         flags = other.flags;
+        invalidateGEOSCache();
     }
     return *this;
 }
@@ -490,6 +529,133 @@ void OGR_G_AssignSpatialReference( OGRGeometryH hGeom,
         assignSpatialReference(reinterpret_cast<OGRSpatialReference *>(hSRS));
 }
 
+/************************************************************************/
+/*                        OGRLocatePointInRing()                        */
+/************************************************************************/
+
+// Returns 1 if the point is inside the closed ring, 0 if it is outside, and
+// -1 if it is on, or so close to, one of its edges that the answer could
+// differ from the one of GEOS, or if the ring is degenerate.
+static int OGRLocatePointInRing( const OGRSimpleCurve* poRing,
+                                 double dfX, double dfY )
+{
+    const int nPoints = poRing->getNumPoints();
+    if( nPoints < 4 ||
+        poRing->getX(0) != poRing->getX(nPoints - 1) ||
+        poRing->getY(0) != poRing->getY(nPoints - 1) )
+        return -1;
+
+    // Crossing number test, on coordinates relative to the point.
+    bool bInside = false;
+    double dfX1 = poRing->getX(0) - dfX;
+    double dfY1 = poRing->getY(0) - dfY;
+    for( int i = 1; i < nPoints; i++ )
+    {
+        const double dfX2 = poRing->getX(i) - dfX;
+        const double dfY2 = poRing->getY(i) - dfY;
+        const double dfCross = dfX1 * dfY2 - dfX2 * dfY1;
+        const bool bStraddles = (dfY1 > 0) != (dfY2 > 0);
+        // Far above the rounding error of dfCross.
+        if( fabs(dfCross) <= 1e-10 * (fabs(dfX1 * dfY2) + fabs(dfX2 * dfY1)) )
+        {
+            // Point (almost) aligned with the edge: only undecidable if it
+            // is (almost) on it.
+            if( bStraddles || dfX1 * dfX2 + dfY1 * dfY2 <= 0 )
+                return -1;
+        }
+        else if( bStraddles && (dfCross > 0) == (dfY2 > dfY1) )
+        {
+            bInside = !bInside;
+        }
+        dfX1 = dfX2;
+        dfY1 = dfY2;
+    }
+    return bInside ? 1 : 0;
+}
+
+/************************************************************************/
+/*                        OGRLocatePointInArea()                        */
+/************************************************************************/
+
+// Native replacement for the GEOS evaluation of the location of a point
+// with respect to a polygon or multipolygon. Returns 1 if poPointGeom is a
+// point located in the interior of poAreaGeom, 0 if it is in its exterior,
+// and -1 if the geometries are not of these types or if the point is on,
+// or too close to, the boundary of the area.
+static int OGRLocatePointInArea( const OGRGeometry* poAreaGeom,
+                                 const OGRGeometry* poPointGeom )
+{
+    if( wkbFlatten(poPointGeom->getGeometryType()) != wkbPoint ||
+        poPointGeom->IsEmpty() )
+        return -1;
+    const OGRPoint* poPoint = static_cast<const OGRPoint*>(poPointGeom);
+    const double dfX = poPoint->getX();
+    const double dfY = poPoint->getY();
+
+    const OGRwkbGeometryType eAreaType =
+        wkbFlatten(poAreaGeom->getGeometryType());
+    int nPolygons = 0;
+    if( eAreaType == wkbPolygon )
+        nPolygons = 1;
+    else if( eAreaType == wkbMultiPolygon )
+        nPolygons =
+            static_cast<const OGRMultiPolygon*>(poAreaGeom)->getNumGeometries();
+    else
+        return -1;
+
+    int nInside = 0;
+    for( int iPoly = 0; iPoly < nPolygons; iPoly++ )
+    {
+        const OGRPolygon* poPoly = eAreaType == wkbPolygon ?
+            static_cast<const OGRPolygon*>(poAreaGeom) :
+            static_cast<const OGRPolygon*>(
+                static_cast<const OGRMultiPolygon*>(poAreaGeom)->
+                                                    getGeometryRef(iPoly));
+        const OGRLinearRing* poExtRing = poPoly->getExteriorRing();
+        if( poExtRing == NULL )
+            continue;
+        int nRet = OGRLocatePointInRing(poExtRing, dfX, dfY);
+        for( int iRing = 0;
+             nRet == 1 && iRing < poPoly->getNumInteriorRings(); iRing++ )
+        {
+            const int nRetHole =
+                OGRLocatePointInRing(poPoly->getInteriorRing(iRing), dfX, dfY);
+            if( nRetHole != 0 )
+                nRet = nRetHole == 1 ? 0 : -1;
+        }
+        if( nRet < 0 )
+            return -1;
+        nInside += nRet;
+    }
+    // Being inside several parts is only possible for an invalid
+    // multipolygon, leave it to GEOS.
+    return nInside <= 1 ? nInside : -1;
+}
+
+#ifdef HAVE_GEOS
+/************************************************************************/
+/*                        OGRGetBBoxRelation()                          */
+/************************************************************************/
+
+// Compares the envelopes of two geometries, which is enough to answer the
+// spatial predicates when they do not intersect or when one is not included
+// in the other.
+static void OGRGetBBoxRelation( const OGRGeometry* poGeom1,
+                                const OGRGeometry* poGeom2,
+                                bool& bIntersects,
+                                bool& b1Contains2,
+                                bool& b2Contains1 )
+{
+    OGREnvelope oEnv1;
+    poGeom1->getEnvelope( &oEnv1 );
+    OGREnvelope oEnv2;
+    poGeom2->getEnvelope( &oEnv2 );
+    bIntersects = CPL_TO_BOOL(oEnv1.Intersects(oEnv2));
+    b1Contains2 = CPL_TO_BOOL(oEnv1.Contains(oEnv2));
+    b2Contains1 = CPL_TO_BOOL(oEnv2.Contains(oEnv1));
+}
+#endif
+
 /************************************************************************/
 /*                             Intersects()                             */
 /************************************************************************/
@@ -499,7 +665,9 @@ void OGR_G_AssignSpatialReference( OGRGeometryH hGeom,
  *
  * Determines whether two geometries intersect.  If GEOS is enabled, then
  * this is done in rigorous fashion otherwise TRUE is returned if the
- * envelopes (bounding boxes) of the two geometries overlap.
+ * envelopes (bounding boxes) of the two geometries overlap.  In both cases,
+ * the test of a point against a polygon or a multipolygon is done natively,
+ * unless the point lies on, or very close to, the boundary of the polygon.
  *
  * The poOtherGeom argument may be safely NULL, but in this case the method
  * will always return TRUE.   That is, a NULL geometry is treated as being
@@ -530,16 +698,21 @@ OGRBoolean OGRGeometry::Intersects( const OGRGeometry *poOtherGeom ) const
         || oEnv2.MaxY < oEnv1.MinY )
         return FALSE;
 
+    // Point versus polygon tests can generally be answered without GEOS.
+    int nPointLocation = OGRLocatePointInArea(this, poOtherGeom);
+    if( nPointLocation < 0 )
+        nPointLocation = OGRLocatePointInArea(poOtherGeom, this);
+    if( nPointLocation >= 0 )
+        return nPointLocation == 1;
+
 #ifndef HAVE_GEOS
     // Without GEOS we assume that envelope overlap is equivalent to
     // actual intersection.
     return TRUE;
 #else
-
-
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    GEOSGeom hThisGeosGeom  = exportToGEOS(hGEOSCtxt);
-    GEOSGeom hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+    GEOSGeom hThisGeosGeom  = getGEOSGeom(hGEOSCtxt);
+    GEOSGeom hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
 
     OGRBoolean bResult = FALSE;
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
@@ -548,9 +721,8 @@ OGRBoolean OGRGeometry::Intersects( const OGRGeometry *poOtherGeom ) const
             GEOSIntersects_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom ) != 0;
     }
 
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+    poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 #endif  // HAVE_GEOS
@@ -574,7 +746,9 @@ OGRBoolean OGRGeometry::Intersect( OGRGeometry *poOtherGeom ) const
  *
  * Determines whether two geometries intersect.  If GEOS is enabled, then
  * this is done in rigorous fashion otherwise TRUE is returned if the
- * envelopes (bounding boxes) of the two geometries overlap.
+ * envelopes (bounding boxes) of the two geometries overlap.  In both cases,
+ * the test of a point against a polygon or a multipolygon is done natively,
+ * unless the point lies on, or very close to, the boundary of the polygon.
  *
  * This function is the same as the CPP method OGRGeometry::Intersects.
  *
@@ -1027,6 +1201,7 @@ void OGRGeometry::setCoordinateDimension( int nNewDimension )
     else
         flags |= OGR_G_3D;
     setMeasured( FALSE );
+    invalidateGEOSCache();
 }
 
 /**
@@ -1049,6 +1224,7 @@ void OGRGeometry::set3D( OGRBoolean bIs3D )
         flags |= OGR_G_3D;
     else
         flags &= ~OGR_G_3D;
+    invalidateGEOSCache();
 }
 
 /**
@@ -1072,6 +1248,7 @@ void OGRGeometry::setMeasured( OGRBoolean bIsMeasured )
         flags |= OGR_G_MEASURED;
     else
         flags &= ~OGR_G_MEASURED;
+    invalidateGEOSCache();
 }
 
 /************************************************************************/
@@ -3053,6 +3230,84 @@ GEOSGeom OGRGeometry::exportToGEOS(
 #endif  // HAVE_GEOS
 }
 
+/************************************************************************/
+/*                        setGEOSCacheEnabled()                         */
+/************************************************************************/
+
+/**
+ * \brief Enable or disable caching of the GEOS representation of the geometry.
+ *
+ * When enabled, the GEOS geometry built by the spatial predicates and
+ * operations of this object (Intersects(), Contains(), Intersection(), ...) is
+ * kept and reused by the following calls, which saves the conversion cost
+ * when the same geometry is tested against many others.  The cache is
+ * invalidated by the methods that modify the geometry.  Sub-geometries
+ * obtained with a non-const accessor before the cache was built must not be
+ * modified afterwards.
+ *
+ * Caching is disabled by default.  As the cache is built lazily from const
+ * methods, a geometry with caching enabled must not be used concurrently by
+ * several threads.  The setting is not propagated by clone() nor by the copy
+ * constructor.
+ *
+ * @param bEnabled true to enable the cache, false to disable it and release
+ * the cached GEOS geometry.
+ *
+ * @since GDAL 2.3
+ */
+
+void OGRGeometry::setGEOSCacheEnabled( bool bEnabled )
+{
+    bGEOSCacheEnabled = bEnabled;
+    if( !bEnabled )
+        invalidateGEOSCache();
+}
+
+/************************************************************************/
+/*                            getGEOSGeom()                             */
+/************************************************************************/
+
+// Returns the GEOS geometry to use for this object in a spatial operation:
+// the cached one if caching is enabled, otherwise a new one. It must be
+// given back with releaseGEOSGeom().
+GEOSGeom OGRGeometry::getGEOSGeom( GEOSContextHandle_t hGEOSCtxt ) const
+{
+    if( !bGEOSCacheEnabled )
+        return exportToGEOS(hGEOSCtxt);
+    if( hGEOSCache == NULL )
+        hGEOSCache = exportToGEOS(hGEOSCtxt);
+    return hGEOSCache;
+}
+
+/************************************************************************/
+/*                          releaseGEOSGeom()                           */
+/************************************************************************/
+
+void OGRGeometry::releaseGEOSGeom( UNUSED_IF_NO_GEOS GEOSContextHandle_t hGEOSCtxt,
+                                   UNUSED_IF_NO_GEOS GEOSGeom hGeosGeom ) const
+{
+#ifdef HAVE_GEOS
+    if( hGeosGeom != NULL && hGeosGeom != hGEOSCache )
+        GEOSGeom_destroy_r( hGEOSCtxt, hGeosGeom );
+#endif
+}
+
+/************************************************************************/
+/*                           freeGEOSCache()                            */
+/************************************************************************/
+
+void OGRGeometry::freeGEOSCache()
+{
+#ifdef HAVE_GEOS
+    // GEOS geometries are not bound to the context that created them, so
+    // the one of the current thread can be used to destroy it.
+    GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+    if( hGEOSCtxt != NULL )
+        GEOSGeom_destroy_r( hGEOSCtxt, hGEOSCache );
+#endif
+    hGEOSCache = NULL;
+}
+
 /************************************************************************/
 /*                         hasCurveGeometry()                           */
 /************************************************************************/
@@ -3230,10 +3485,10 @@ double OGRGeometry::Distance( const OGRGeometry *poOtherGeom ) const
 
     #else
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
+        GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
         // GEOSGeom is a pointer
-        GEOSGeom hOther = poOtherGeom->exportToGEOS(hGEOSCtxt);
-        GEOSGeom hThis = exportToGEOS(hGEOSCtxt);
+        GEOSGeom hOther = poOtherGeom->getGEOSGeom(hGEOSCtxt);
+        GEOSGeom hThis = getGEOSGeom(hGEOSCtxt);
 
         int bIsErr = 0;
         double dfDistance = 0.0;
@@ -3243,9 +3498,8 @@ double OGRGeometry::Distance( const OGRGeometry *poOtherGeom ) const
             bIsErr = GEOSDistance_r( hGEOSCtxt, hThis, hOther, &dfDistance );
         }
 
-        GEOSGeom_destroy_r( hGEOSCtxt, hThis );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOther );
-        freeGEOSContext( hGEOSCtxt );
+        releaseGEOSGeom( hGEOSCtxt, hThis );
+        poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOther );
 
         if ( bIsErr > 0 )
         {
@@ -3711,13 +3965,13 @@ OGRGeometry *OGRGeometry::Buffer( UNUSED_IF_NO_GEOS double dfDist,
     GEOSGeom hGeosGeom = NULL;
     OGRGeometry *poOGRProduct = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hGeosGeom = exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+    hGeosGeom = getGEOSGeom(hGEOSCtxt);
     if( hGeosGeom != NULL )
     {
         GEOSGeom hGeosProduct =
             GEOSBuffer_r( hGEOSCtxt, hGeosGeom, dfDist, nQuadSegs );
-        GEOSGeom_destroy_r( hGEOSCtxt, hGeosGeom );
+        releaseGEOSGeom( hGEOSCtxt, hGeosGeom );
 
         if( hGeosProduct != NULL )
         {
@@ -3729,7 +3983,6 @@ OGRGeometry *OGRGeometry::Buffer( UNUSED_IF_NO_GEOS double dfDist,
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
         }
     }
-    freeGEOSContext(hGEOSCtxt);
 
     return poOGRProduct;
 
@@ -3857,9 +4110,9 @@ OGRGeometry *OGRGeometry::Intersection(
         GEOSGeom hGeosProduct = NULL;
         OGRGeometry *poOGRProduct = NULL;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-        hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+        hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+        hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
         if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
         {
             hGeosProduct = GEOSIntersection_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
@@ -3877,9 +4130,8 @@ OGRGeometry *OGRGeometry::Intersection(
                 GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
             }
         }
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-        freeGEOSContext( hGEOSCtxt );
+        releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+        poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
         return poOGRProduct;
 
@@ -4001,9 +4253,9 @@ OGRGeometry *OGRGeometry::Union(
         GEOSGeom hGeosProduct = NULL;
         OGRGeometry *poOGRProduct = NULL;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-        hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+        hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+        hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
         if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
         {
             hGeosProduct = GEOSUnion_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
@@ -4021,9 +4273,8 @@ OGRGeometry *OGRGeometry::Union(
                 GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
             }
         }
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-        freeGEOSContext( hGEOSCtxt );
+        releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+        poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
         return poOGRProduct;
 
@@ -4226,9 +4477,9 @@ OGRGeometry *OGRGeometry::Difference(
         GEOSGeom hGeosProduct = NULL;
         OGRGeometry *poOGRProduct = NULL;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-        hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+        hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+        hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
         if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
         {
             hGeosProduct = GEOSDifference_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
@@ -4246,9 +4497,8 @@ OGRGeometry *OGRGeometry::Difference(
                 GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
             }
         }
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-        freeGEOSContext( hGEOSCtxt );
+        releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+        poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
         return poOGRProduct;
 
@@ -4356,9 +4606,9 @@ OGRGeometry::SymDifference(
     GEOSGeom hOtherGeosGeom = NULL;
     OGRGeometry *poOGRProduct = NULL;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+    hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+    hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         GEOSGeom hGeosProduct =
@@ -4380,9 +4630,8 @@ OGRGeometry::SymDifference(
             GEOSGeom_destroy_r( hGEOSCtxt, hGeosProduct );
         }
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+    poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
     return poOGRProduct;
 
@@ -4493,20 +4742,32 @@ OGRGeometry::Disjoint( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
 
 #else
 
+    bool bBBoxIntersects = false;
+    bool bBBoxContains = false;
+    bool bBBoxWithin = false;
+    OGRGetBBoxRelation(this, poOtherGeom,
+                       bBBoxIntersects, bBBoxContains, bBBoxWithin);
+    if( !bBBoxIntersects )
+        return TRUE;
+    int nPointLocation = OGRLocatePointInArea(this, poOtherGeom);
+    if( nPointLocation < 0 )
+        nPointLocation = OGRLocatePointInArea(poOtherGeom, this);
+    if( nPointLocation >= 0 )
+        return nPointLocation == 0;
+
     GEOSGeom hThisGeosGeom = NULL;
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+    hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+    hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSDisjoint_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+    poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
@@ -4576,21 +4837,32 @@ OGRGeometry::Touches( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
 
 #else
 
+    bool bBBoxIntersects = false;
+    bool bBBoxContains = false;
+    bool bBBoxWithin = false;
+    OGRGetBBoxRelation(this, poOtherGeom,
+                       bBBoxIntersects, bBBoxContains, bBBoxWithin);
+    if( !bBBoxIntersects )
+        return FALSE;
+    // A point strictly inside or outside a polygon does not touch it.
+    if( OGRLocatePointInArea(this, poOtherGeom) >= 0 ||
+        OGRLocatePointInArea(poOtherGeom, this) >= 0 )
+        return FALSE;
+
     GEOSGeom hThisGeosGeom = NULL;
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+    hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+    hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
 
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSTouches_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+    poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
@@ -4690,21 +4962,28 @@ OGRGeometry::Crosses( UNUSED_PARAMETER const OGRGeometry *poOtherGeom ) const
 
     #else
 
+        bool bBBoxIntersects = false;
+        bool bBBoxContains = false;
+        bool bBBoxWithin = false;
+        OGRGetBBoxRelation(this, poOtherGeom,
+                           bBBoxIntersects, bBBoxContains, bBBoxWithin);
+        if( !bBBoxIntersects )
+            return FALSE;
+
         GEOSGeom hThisGeosGeom = NULL;
         GEOSGeom hOtherGeosGeom = NULL;
         OGRBoolean bResult = FALSE;
 
-        GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-        hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-        hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+        GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+        hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+        hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
 
         if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
         {
             bResult = GEOSCrosses_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
         }
-        GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-        GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-        freeGEOSContext( hGEOSCtxt );
+        releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+        poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
         return bResult;
 
@@ -4775,20 +5054,30 @@ OGRGeometry::Within( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
 
 #else
 
+    bool bBBoxIntersects = false;
+    bool bBBoxContains = false;
+    bool bBBoxWithin = false;
+    OGRGetBBoxRelation(this, poOtherGeom,
+                       bBBoxIntersects, bBBoxContains, bBBoxWithin);
+    if( !bBBoxWithin )
+        return FALSE;
+    const int nPointLocation = OGRLocatePointInArea(poOtherGeom, this);
+    if( nPointLocation >= 0 )
+        return nPointLocation == 1;
+
     GEOSGeom hThisGeosGeom = NULL;
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+    hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+    hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSWithin_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+    poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
@@ -4858,20 +5147,30 @@ OGRGeometry::Contains( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
 
 #else
 
+    bool bBBoxIntersects = false;
+    bool bBBoxContains = false;
+    bool bBBoxWithin = false;
+    OGRGetBBoxRelation(this, poOtherGeom,
+                       bBBoxIntersects, bBBoxContains, bBBoxWithin);
+    if( !bBBoxContains )
+        return FALSE;
+    const int nPointLocation = OGRLocatePointInArea(this, poOtherGeom);
+    if( nPointLocation >= 0 )
+        return nPointLocation == 1;
+
     GEOSGeom hThisGeosGeom = NULL;
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+    hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+    hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSContains_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+    poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
@@ -4942,20 +5241,27 @@ OGRGeometry::Overlaps( UNUSED_IF_NO_GEOS const OGRGeometry *poOtherGeom ) const
 
 #else
 
+    bool bBBoxIntersects = false;
+    bool bBBoxContains = false;
+    bool bBBoxWithin = false;
+    OGRGetBBoxRelation(this, poOtherGeom,
+                       bBBoxIntersects, bBBoxContains, bBBoxWithin);
+    if( !bBBoxIntersects )
+        return FALSE;
+
     GEOSGeom hThisGeosGeom = NULL;
     GEOSGeom hOtherGeosGeom = NULL;
     OGRBoolean bResult = FALSE;
 
-    GEOSContextHandle_t hGEOSCtxt = createGEOSContext();
-    hThisGeosGeom = exportToGEOS(hGEOSCtxt);
-    hOtherGeosGeom = poOtherGeom->exportToGEOS(hGEOSCtxt);
+    GEOSContextHandle_t hGEOSCtxt = OGRGetThreadLocalGEOSContext();
+    hThisGeosGeom = getGEOSGeom(hGEOSCtxt);
+    hOtherGeosGeom = poOtherGeom->getGEOSGeom(hGEOSCtxt);
     if( hThisGeosGeom != NULL && hOtherGeosGeom != NULL )
     {
         bResult = GEOSOverlaps_r( hGEOSCtxt, hThisGeosGeom, hOtherGeosGeom );
     }
-    GEOSGeom_destroy_r( hGEOSCtxt, hThisGeosGeom );
-    GEOSGeom_destroy_r( hGEOSCtxt, hOtherGeosGeom );
-    freeGEOSContext( hGEOSCtxt );
+    releaseGEOSGeom( hGEOSCtxt, hThisGeosGeom );
+    poOtherGeom->releaseGEOSGeom( hGEOSCtxt, hOtherGeosGeom );
 
     return bResult;
 
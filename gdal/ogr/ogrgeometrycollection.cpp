@@ -131,6 +131,7 @@ OGRGeometryCollection& OGRGeometryCollection::operator=(
 void OGRGeometryCollection::empty()
 
 {
+    invalidateGEOSCache();
     if( papoGeoms != NULL )
     {
         for( int i = 0; i < nGeomCount; i++ )
@@ -217,6 +218,7 @@ int OGRGeometryCollection::getDimension() const
 void OGRGeometryCollection::flattenTo2D()
 
 {
+    invalidateGEOSCache();
     for( int i = 0; i < nGeomCount; i++ )
         papoGeoms[i]->flattenTo2D();
 
@@ -275,6 +277,7 @@ int OGRGeometryCollection::getNumGeometries() const
 OGRGeometry * OGRGeometryCollection::getGeometryRef( int i )
 
 {
+    invalidateGEOSCache();
     if( i < 0 || i >= nGeomCount )
         return NULL;
 
@@ -333,6 +336,7 @@ const OGRGeometry * OGRGeometryCollection::getGeometryRef( int i ) const
 OGRErr OGRGeometryCollection::addGeometry( const OGRGeometry * poNewGeom )
 
 {
+    invalidateGEOSCache();
     OGRGeometry *poClone = poNewGeom->clone();
     if( poClone == NULL )
         return OGRERR_FAILURE;
@@ -373,6 +377,7 @@ OGRErr OGRGeometryCollection::addGeometry( const OGRGeometry * poNewGeom )
 OGRErr OGRGeometryCollection::addGeometryDirectly( OGRGeometry * poNewGeom )
 
 {
+    invalidateGEOSCache();
     if( !isCompatibleSubType(poNewGeom->getGeometryType()) )
         return OGRERR_UNSUPPORTED_GEOMETRY_TYPE;
 
@@ -429,6 +434,7 @@ OGRErr OGRGeometryCollection::addGeometryDirectly( OGRGeometry * poNewGeom )
 OGRErr OGRGeometryCollection::removeGeometry( int iGeom, int bDelete )
 
 {
+    invalidateGEOSCache();
     if( iGeom < -1 || iGeom >= nGeomCount )
         return OGRERR_FAILURE;
 
@@ -481,6 +487,7 @@ OGRErr OGRGeometryCollection::importFromWkbInternal( const unsigned char * pabyD
                                                      int& nBytesConsumedOut )
 
 {
+    invalidateGEOSCache();
     nBytesConsumedOut = -1;
     // Arbitrary value, but certainly large enough for reasonable use cases.
     if( nRecLevel == 32 )
@@ -707,6 +714,7 @@ OGRErr OGRGeometryCollection::importFromWktInternal( char ** ppszInput,
                                                      int nRecLevel )
 
 {
+    invalidateGEOSCache();
     // Arbitrary value, but certainly large enough for reasonable usages.
     if( nRecLevel == 32 )
     {
@@ -1063,6 +1071,7 @@ OGRBoolean OGRGeometryCollection::Equals( OGRGeometry * poOther ) const
 OGRErr OGRGeometryCollection::transform( OGRCoordinateTransformation *poCT )
 
 {
+    invalidateGEOSCache();
     for( int iGeom = 0; iGeom < nGeomCount; iGeom++ )
     {
         const OGRErr eErr = papoGeoms[iGeom]->transform( poCT );
@@ -1094,6 +1103,7 @@ OGRErr OGRGeometryCollection::transform( OGRCoordinateTransformation *poCT )
 void OGRGeometryCollection::closeRings()
 
 {
+    invalidateGEOSCache();
     for( int iGeom = 0; iGeom < nGeomCount; iGeom++ )
     {
         if( wkbFlatten(papoGeoms[iGeom]->getGeometryType()) == wkbPolygon )
@@ -1271,6 +1281,7 @@ OGRBoolean OGRGeometryCollection::IsEmpty() const
 
 void OGRGeometryCollection::segmentize( double dfMaxLength )
 {
+    invalidateGEOSCache();
     for( int iGeom = 0; iGeom < nGeomCount; iGeom++ )
         papoGeoms[iGeom]->segmentize(dfMaxLength);
 }
@@ -1281,6 +1292,7 @@ void OGRGeometryCollection::segmentize( double dfMaxLength )
 
 void OGRGeometryCollection::swapXY()
 {
+    invalidateGEOSCache();
     for( int iGeom = 0; iGeom < nGeomCount; iGeom++ )
         papoGeoms[iGeom]->swapXY();
 }
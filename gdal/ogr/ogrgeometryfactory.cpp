@@ -32,6 +32,7 @@
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_quad_tree.h"
 #include "cpl_string.h"
 #include "ogr_geometry.h"
 #include "ogr_api.h"
@@ -52,6 +53,7 @@
 #include <cstddef>
 
 #include <algorithm>
+#include <functional>
 #include <new>
 #include <utility>
 #include <vector>
@@ -1338,6 +1340,157 @@ static int OGRGeometryFactoryCompareByIndex(const void* p1, const void* p2)
 
 static const int N_CRITICAL_PART_NUMBER = 100;
 
+// Above that number of parts, candidate enclosing polygons are looked up
+// in a quad tree of the envelopes instead of being scanned linearly.
+static const int N_INDEXED_PART_NUMBER = 32;
+
+// Minimum number of points of a ring for building an edge index on it.
+static const int N_INDEXED_RING_POINTS = 64;
+
+/************************************************************************/
+/*                          OGRRingBandIndex                            */
+/************************************************************************/
+
+/* Index of the edges of a linear ring by horizontal bands, so that the */
+/* point-in-ring tests done by organizePolygons() against rings with many */
+/* vertices only look at the edges that may cross the horizontal line */
+/* going through the tested point.  Point-on-boundary tests are not */
+/* indexed: OGRLinearRing::isPointOnRingBoundary() accepts points aligned */
+/* with any edge, which may be far from the band of the point. */
+
+class OGRRingBandIndex
+{
+    const OGRLinearRing *poRing;
+    double               dfMinY;
+    double               dfMaxY;
+    double               dfInvBandHeight;
+    int                  nBands;
+    std::vector<int>     anBandStart;
+    std::vector<int>     anEdges; /* edge i goes from point i-1 to point i */
+
+    int getBand( double dfY ) const
+    {
+        const double dfBand = (dfY - dfMinY) * dfInvBandHeight;
+        if( !(dfBand > 0) )
+            return 0;
+        if( dfBand >= nBands )
+            return nBands - 1;
+        return static_cast<int>(dfBand);
+    }
+
+  public:
+    explicit OGRRingBandIndex( const OGRLinearRing* poRingIn );
+
+    bool isPointInRing( const OGRPoint* poPoint ) const;
+};
+
+OGRRingBandIndex::OGRRingBandIndex( const OGRLinearRing* poRingIn ) :
+    poRing(poRingIn),
+    dfMinY(0.0),
+    dfMaxY(0.0),
+    dfInvBandHeight(0.0),
+    nBands(std::max(1, poRingIn->getNumPoints() / 4))
+{
+    OGREnvelope sEnvelope;
+    poRing->getEnvelope(&sEnvelope);
+    dfMinY = sEnvelope.MinY;
+    dfMaxY = sEnvelope.MaxY;
+
+    // An edge is registered in all the bands it spans: reduce the number
+    // of bands until the size of the index is proportional to the ring.
+    const int nPoints = poRing->getNumPoints();
+    while( true )
+    {
+        dfInvBandHeight = dfMaxY > dfMinY ? nBands / (dfMaxY - dfMinY) : 0.0;
+        GIntBig nEntries = 0;
+        for( int i = 1; i < nPoints; i++ )
+        {
+            const double dfY1 = poRing->getY(i - 1);
+            const double dfY2 = poRing->getY(i);
+            nEntries += getBand(std::max(dfY1, dfY2)) -
+                        getBand(std::min(dfY1, dfY2)) + 1;
+        }
+        if( nBands == 1 || nEntries <= 8 * static_cast<GIntBig>(nPoints) )
+            break;
+        nBands /= 2;
+    }
+
+    anBandStart.resize(nBands + 1, 0);
+    for( int i = 1; i < nPoints; i++ )
+    {
+        const double dfY1 = poRing->getY(i - 1);
+        const double dfY2 = poRing->getY(i);
+        const int nLastBand = getBand(std::max(dfY1, dfY2));
+        for( int iBand = getBand(std::min(dfY1, dfY2));
+             iBand <= nLastBand; iBand++ )
+        {
+            anBandStart[iBand + 1]++;
+        }
+    }
+    for( int iBand = 0; iBand < nBands; iBand++ )
+        anBandStart[iBand + 1] += anBandStart[iBand];
+
+    anEdges.resize(anBandStart[nBands]);
+    std::vector<int> anPos(anBandStart.begin(), anBandStart.end() - 1);
+    for( int i = 1; i < nPoints; i++ )
+    {
+        const double dfY1 = poRing->getY(i - 1);
+        const double dfY2 = poRing->getY(i);
+        const int nLastBand = getBand(std::max(dfY1, dfY2));
+        for( int iBand = getBand(std::min(dfY1, dfY2));
+             iBand <= nLastBand; iBand++ )
+        {
+            anEdges[anPos[iBand]++] = i;
+        }
+    }
+}
+
+/* Same result as OGRLinearRing::isPointInRing(poPoint, FALSE). */
+bool OGRRingBandIndex::isPointInRing( const OGRPoint* poPoint ) const
+{
+    const double dfTestX = poPoint->getX();
+    const double dfTestY = poPoint->getY();
+    if( !(dfTestY >= dfMinY && dfTestY <= dfMaxY) )
+        return false;
+
+    const int iBand = getBand(dfTestY);
+    int iNumCrossings = 0;
+    for( int k = anBandStart[iBand]; k < anBandStart[iBand + 1]; k++ )
+    {
+        const int iPoint = anEdges[k];
+        const double x1 = poRing->getX(iPoint) - dfTestX;
+        const double y1 = poRing->getY(iPoint) - dfTestY;
+        const double x2 = poRing->getX(iPoint - 1) - dfTestX;
+        const double y2 = poRing->getY(iPoint - 1) - dfTestY;
+
+        if( ( ( y1 > 0 ) && ( y2 <= 0 ) ) || ( ( y2 > 0 ) && ( y1 <= 0 ) ) )
+        {
+            const double dfIntersection = ( x1 * y2 - x2 * y1 ) / (y2 - y1);
+            if( 0.0 < dfIntersection )
+                iNumCrossings++;
+        }
+    }
+    return (iNumCrossings % 2) != 0;
+}
+
+static bool OGRIsPointInRing( const OGRLinearRing* poRing,
+                              const OGRRingBandIndex* poIndex,
+                              const OGRPoint* poPoint )
+{
+    if( poIndex != NULL )
+        return poIndex->isPointInRing(poPoint);
+    return CPL_TO_BOOL(poRing->isPointInRing(poPoint, FALSE));
+}
+
+static void OGRPolyExtendedGetBounds( const void* hFeature, CPLRectObj* pBounds )
+{
+    const sPolyExtended* psPoly = static_cast<const sPolyExtended*>(hFeature);
+    pBounds->minx = psPoly->sEnvelope.MinX;
+    pBounds->miny = psPoly->sEnvelope.MinY;
+    pBounds->maxx = psPoly->sEnvelope.MaxX;
+    pBounds->maxy = psPoly->sEnvelope.MaxY;
+}
+
 typedef enum
 {
    METHOD_NORMAL,
@@ -1366,8 +1519,14 @@ typedef enum
  * In that case, a slower algorithm that tests exact topological relationships
  * is used if GEOS is available.)
  *
+ * When more than a few dozens of polygons are passed, the candidate enclosing
+ * polygons are found with a spatial index of their envelopes, and the
+ * point-in-ring tests against rings with many vertices use an index of their
+ * edges, so that the processing time grows roughly linearly with the number
+ * of rings and vertices (starting with GDAL 2.3).
+ *
  * In cases where a big number of polygons is passed to this function, the default processing
- * may be really slow. You can skip the processing by adding METHOD=SKIP
+ * may still be slow. You can skip the processing by adding METHOD=SKIP
  * to the option list (the result of the function will be a multi-polygon with all polygons
  * as toplevel polygons) or only make it analyze counterclockwise polygons by adding
  * METHOD=ONLY_CCW to the option list if you can assume that the outline
@@ -1639,7 +1798,7 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
     // Emits a warning if the number of parts is sufficiently big to anticipate
     // for very long computation time, and the user didn't specify an explicit
     // method.
-    if( nPolygonCount > N_CRITICAL_PART_NUMBER &&
+    if( nPolygonCount > N_CRITICAL_PART_NUMBER && !bUseFastVersion &&
         method == METHOD_NORMAL && pszMethodValue == NULL )
     {
         static int firstTime = 1;
@@ -1682,7 +1841,10 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
           outer ring
        5) Add the top-level polygons to the multipolygon
 
-       Complexity : O(nPolygonCount^2)
+       Complexity : O(nPolygonCount^2), or roughly O(nPolygonCount log
+       nPolygonCount) when the candidates of step 2 are found with a quad tree
+       of the envelopes (polygons whose envelopes do not intersect cannot
+       affect each other, so the result is the same).
     */
 
     /* Compute how each polygon relate to the other ones
@@ -1720,11 +1882,40 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
 
     int nCountTopLevel = 1;
 
+    CPLQuadTree* hTree = NULL;
+    std::vector<OGRRingBandIndex*> apoRingIndex;
+    if( !bMixedUpGeometries && nPolygonCount > N_INDEXED_PART_NUMBER )
+    {
+        CPLRectObj sGlobalBounds;
+        sGlobalBounds.minx = asPolyEx[0].sEnvelope.MinX;
+        sGlobalBounds.miny = asPolyEx[0].sEnvelope.MinY;
+        sGlobalBounds.maxx = asPolyEx[0].sEnvelope.MaxX;
+        sGlobalBounds.maxy = asPolyEx[0].sEnvelope.MaxY;
+        for( int i = 1; i < nPolygonCount; i++ )
+        {
+            sGlobalBounds.minx = std::min(sGlobalBounds.minx,
+                                          asPolyEx[i].sEnvelope.MinX);
+            sGlobalBounds.miny = std::min(sGlobalBounds.miny,
+                                          asPolyEx[i].sEnvelope.MinY);
+            sGlobalBounds.maxx = std::max(sGlobalBounds.maxx,
+                                          asPolyEx[i].sEnvelope.MaxX);
+            sGlobalBounds.maxy = std::max(sGlobalBounds.maxy,
+                                          asPolyEx[i].sEnvelope.MaxY);
+        }
+        hTree = CPLQuadTreeCreate(&sGlobalBounds, OGRPolyExtendedGetBounds);
+        CPLQuadTreeInsert(hTree, &asPolyEx[0]);
+        apoRingIndex.resize(nPolygonCount, NULL);
+    }
+    std::vector<int> anCandidates;
+
     // STEP 2.
     for( int i = 1;
          !bMixedUpGeometries && bValidTopology && i<nPolygonCount;
          i++ )
     {
+        if( hTree != NULL )
+            CPLQuadTreeInsert(hTree, &asPolyEx[i]);
+
         if( method == METHOD_ONLY_CCW && asPolyEx[i].bIsCW )
         {
             nCountTopLevel++;
@@ -1733,9 +1924,35 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
             continue;
         }
 
-        int j = i - 1;  // Used after for.
-        for( ; bValidTopology && j >= 0; j-- )
+        // Candidate enclosing polygons, by decreasing index (that is
+        // increasing area): all the previous ones, or with the quad tree
+        // only the ones whose envelope intersects ours.
+        int nCandidates = i;
+        if( hTree != NULL )
         {
+            CPLRectObj sAoi;
+            OGRPolyExtendedGetBounds(&asPolyEx[i], &sAoi);
+            int nFound = 0;
+            void** pahFound = CPLQuadTreeSearch(hTree, &sAoi, &nFound);
+            anCandidates.clear();
+            for( int k = 0; k < nFound; k++ )
+            {
+                const int j = static_cast<int>(
+                    static_cast<sPolyExtended*>(pahFound[k]) - asPolyEx);
+                if( j < i )
+                    anCandidates.push_back(j);
+            }
+            CPLFree(pahFound);
+            std::sort(anCandidates.begin(), anCandidates.end(),
+                      std::greater<int>());
+            nCandidates = static_cast<int>(anCandidates.size());
+        }
+
+        int iCandidate = 0;  // Used after for.
+        for( ; bValidTopology && iCandidate < nCandidates; iCandidate++ )
+        {
+            const int j = hTree != NULL ? anCandidates[iCandidate]
+                                        : i - 1 - iCandidate;
             bool b_i_inside_j = false;
 
             if( method == METHOD_ONLY_CCW && asPolyEx[j].bIsCW == FALSE )
@@ -1747,6 +1964,21 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
 
             if( asPolyEx[j].sEnvelope.Contains(asPolyEx[i].sEnvelope) )
             {
+                // Rings with many vertices get an edge index, reused by the
+                // next tests against them.
+                OGRRingBandIndex* poRingIndex_j = NULL;
+                if( hTree != NULL && bUseFastVersion &&
+                    asPolyEx[j].bIsPolygon &&
+                    asPolyEx[j].poExteriorRing->getNumPoints() >=
+                                                    N_INDEXED_RING_POINTS )
+                {
+                    if( apoRingIndex[j] == NULL )
+                        apoRingIndex[j] = new OGRRingBandIndex(
+                            reinterpret_cast<OGRLinearRing*>(
+                                asPolyEx[j].poExteriorRing));
+                    poRingIndex_j = apoRingIndex[j];
+                }
+
                 if( bUseFastVersion )
                 {
                     if( method == METHOD_ONLY_CCW && j == 0 )
@@ -1782,7 +2014,8 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
                             {
                                 // If it is on the boundary of j, iterate again.
                             }
-                            else if( poLR_j->isPointInRing(&point, FALSE) )
+                            else if( OGRIsPointInRing(poLR_j, poRingIndex_j,
+                                                      &point) )
                             {
                                 // If then point is strictly included in j, then
                                 // i is considered inside j.
@@ -1817,8 +2050,9 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
                                     // If it is on the boundary of j, iterate
                                     // again.
                                 }
-                                else if( poLR_j->isPointInRing(&pointMiddle,
-                                                               FALSE) )
+                                else if( OGRIsPointInRing(poLR_j,
+                                                          poRingIndex_j,
+                                                          &pointMiddle) )
                                 {
                                     // If then point is strictly included in j,
                                     // then i is considered inside j.
@@ -1838,10 +2072,10 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
                     // ring.
                     else if( asPolyEx[i].bIsPolygon &&
                              asPolyEx[j].bIsPolygon &&
-                             reinterpret_cast<OGRLinearRing*>(
-                                 asPolyEx[j].poExteriorRing)->
-                                     isPointInRing(&asPolyEx[i].poAPoint,
-                                                   FALSE) )
+                             OGRIsPointInRing(
+                                 reinterpret_cast<OGRLinearRing*>(
+                                     asPolyEx[j].poExteriorRing),
+                                 poRingIndex_j, &asPolyEx[i].poAPoint) )
                     {
                         b_i_inside_j = true;
                     }
@@ -1902,7 +2136,7 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
             }
         }
 
-        if( j < 0 )
+        if( iCandidate == nCandidates )
         {
             // We come here because we are not included in anything.
             // We are toplevel.
@@ -1912,6 +2146,11 @@ OGRGeometry* OGRGeometryFactory::organizePolygons( OGRGeometry **papoPolygons,
         }
     }
 
+    if( hTree != NULL )
+        CPLQuadTreeDestroy(hTree);
+    for( size_t i = 0; i < apoRingIndex.size(); i++ )
+        delete apoRingIndex[i];
+
     if( pbIsValidGeometry )
         *pbIsValidGeometry = bValidTopology && !bMixedUpGeometries;
 
@@ -157,6 +157,7 @@ OGRErr OGRLinearRing::importFromWkb( const unsigned char * /*pabyData*/,
                                      int& /* nBytesConsumedOut */ )
 
 {
+    invalidateGEOSCache();
     return OGRERR_UNSUPPORTED_OPERATION;
 }
 
@@ -188,6 +189,7 @@ OGRErr OGRLinearRing::_importFromWkb( OGRwkbByteOrder eByteOrder, int _flags,
                                       int& nBytesConsumedOut )
 
 {
+    invalidateGEOSCache();
     nBytesConsumedOut = -1;
     if( nBytesAvailable < 4 && nBytesAvailable != -1 )
         return OGRERR_NOT_ENOUGH_DATA;
@@ -548,6 +550,7 @@ int OGRLinearRing::isClockwise() const
 void OGRLinearRing::reverseWindingOrder()
 
 {
+    invalidateGEOSCache();
     OGRPoint pointA;
     OGRPoint pointB;
 
@@ -568,6 +571,7 @@ void OGRLinearRing::reverseWindingOrder()
 void OGRLinearRing::closeRings()
 
 {
+    invalidateGEOSCache();
     if( nPointCount < 2 )
         return;
 
@@ -740,6 +744,7 @@ OGRBoolean OGRLinearRing::isPointOnRingBoundary( const OGRPoint* poPoint,
 OGRErr OGRLinearRing::transform( OGRCoordinateTransformation *poCT )
 
 {
+    invalidateGEOSCache();
     const bool bIsClosed = getNumPoints() > 2 && CPL_TO_BOOL(get_IsClosed());
     OGRErr eErr = OGRLineString::transform(poCT);
     if( bIsClosed && eErr == OGRERR_NONE && !get_IsClosed() )
@@ -115,6 +115,7 @@ OGRSimpleCurve& OGRSimpleCurve::operator=( const OGRSimpleCurve& other )
 void OGRSimpleCurve::flattenTo2D()
 
 {
+    invalidateGEOSCache();
     Make2D();
     setMeasured(FALSE);
 }
@@ -150,6 +151,7 @@ OGRGeometry *OGRSimpleCurve::clone() const
 void OGRSimpleCurve::empty()
 
 {
+    invalidateGEOSCache();
     setNumPoints( 0 );
 }
 
@@ -160,6 +162,7 @@ void OGRSimpleCurve::empty()
 void OGRSimpleCurve::setCoordinateDimension( int nNewDimension )
 
 {
+    invalidateGEOSCache();
     if( nNewDimension == 2 )
         Make2D();
     else if( nNewDimension == 3 )
@@ -170,6 +173,7 @@ void OGRSimpleCurve::setCoordinateDimension( int nNewDimension )
 void OGRSimpleCurve::set3D( OGRBoolean bIs3D )
 
 {
+    invalidateGEOSCache();
     if( bIs3D )
         Make3D();
     else
@@ -179,6 +183,7 @@ void OGRSimpleCurve::set3D( OGRBoolean bIs3D )
 void OGRSimpleCurve::setMeasured( OGRBoolean bIsMeasured )
 
 {
+    invalidateGEOSCache();
     if( bIsMeasured )
         AddM();
     else
@@ -207,6 +212,7 @@ int OGRSimpleCurve::WkbSize() const
 void OGRSimpleCurve::Make2D()
 
 {
+    invalidateGEOSCache();
     if( padfZ != NULL )
     {
         CPLFree( padfZ );
@@ -222,6 +228,7 @@ void OGRSimpleCurve::Make2D()
 void OGRSimpleCurve::Make3D()
 
 {
+    invalidateGEOSCache();
     if( padfZ == NULL )
     {
         if( nPointCount == 0 )
@@ -248,6 +255,7 @@ void OGRSimpleCurve::Make3D()
 void OGRSimpleCurve::RemoveM()
 
 {
+    invalidateGEOSCache();
     if( padfM != NULL )
     {
         CPLFree( padfM );
@@ -263,6 +271,7 @@ void OGRSimpleCurve::RemoveM()
 void OGRSimpleCurve::AddM()
 
 {
+    invalidateGEOSCache();
     if( padfM == NULL )
     {
         if( nPointCount == 0 )
@@ -422,6 +431,7 @@ double OGRSimpleCurve::getM( int iVertex ) const
 void OGRSimpleCurve::setNumPoints( int nNewPointCount, int bZeroizeNewContent )
 
 {
+    invalidateGEOSCache();
     CPLAssert( nNewPointCount >= 0 );
 
     if( nNewPointCount == 0 )
@@ -514,6 +524,7 @@ void OGRSimpleCurve::setNumPoints( int nNewPointCount, int bZeroizeNewContent )
 void OGRSimpleCurve::setPoint( int iPoint, OGRPoint * poPoint )
 
 {
+    invalidateGEOSCache();
     if( (flags & OGR_G_3D) && (flags & OGR_G_MEASURED) )
         setPoint( iPoint, poPoint->getX(), poPoint->getY(), poPoint->getM() );
     else if( flags & OGR_G_MEASURED )
@@ -546,6 +557,7 @@ void OGRSimpleCurve::setPoint( int iPoint, OGRPoint * poPoint )
 void OGRSimpleCurve::setPoint( int iPoint, double xIn, double yIn, double zIn )
 
 {
+    invalidateGEOSCache();
     if( !(flags & OGR_G_3D) )
         Make3D();
 
@@ -587,6 +599,7 @@ void OGRSimpleCurve::setPoint( int iPoint, double xIn, double yIn, double zIn )
 void OGRSimpleCurve::setPointM( int iPoint, double xIn, double yIn, double mIn )
 
 {
+    invalidateGEOSCache();
     if( !(flags & OGR_G_MEASURED) )
         AddM();
 
@@ -630,6 +643,7 @@ void OGRSimpleCurve::setPoint( int iPoint, double xIn, double yIn,
                                double zIn, double mIn )
 
 {
+    invalidateGEOSCache();
     if( !(flags & OGR_G_3D) )
         Make3D();
     if( !(flags & OGR_G_MEASURED) )
@@ -676,6 +690,7 @@ void OGRSimpleCurve::setPoint( int iPoint, double xIn, double yIn,
 void OGRSimpleCurve::setPoint( int iPoint, double xIn, double yIn )
 
 {
+    invalidateGEOSCache();
     if( iPoint >= nPointCount )
     {
         setNumPoints( iPoint+1 );
@@ -706,6 +721,7 @@ void OGRSimpleCurve::setPoint( int iPoint, double xIn, double yIn )
 
 void OGRSimpleCurve::setZ( int iPoint, double zIn )
 {
+    invalidateGEOSCache();
     if( getCoordinateDimension() == 2 )
         Make3D();
 
@@ -739,6 +755,7 @@ void OGRSimpleCurve::setZ( int iPoint, double zIn )
 
 void OGRSimpleCurve::setM( int iPoint, double mIn )
 {
+    invalidateGEOSCache();
     if( !(flags & OGR_G_MEASURED) )
         AddM();
 
@@ -771,6 +788,7 @@ void OGRSimpleCurve::setM( int iPoint, double mIn )
 void OGRSimpleCurve::addPoint( const OGRPoint * poPoint )
 
 {
+    invalidateGEOSCache();
     if( poPoint->getCoordinateDimension() < 3 )
         setPoint( nPointCount, poPoint->getX(), poPoint->getY() );
     else
@@ -798,6 +816,7 @@ void OGRSimpleCurve::addPoint( const OGRPoint * poPoint )
 void OGRSimpleCurve::addPoint( double x, double y, double z, double m )
 
 {
+    invalidateGEOSCache();
     setPoint( nPointCount, x, y, z, m );
 }
 
@@ -817,6 +836,7 @@ void OGRSimpleCurve::addPoint( double x, double y, double z, double m )
 void OGRSimpleCurve::addPoint( double x, double y, double z )
 
 {
+    invalidateGEOSCache();
     setPoint( nPointCount, x, y, z );
 }
 
@@ -835,6 +855,7 @@ void OGRSimpleCurve::addPoint( double x, double y, double z )
 void OGRSimpleCurve::addPoint( double x, double y )
 
 {
+    invalidateGEOSCache();
     setPoint( nPointCount, x, y );
 }
 
@@ -854,6 +875,7 @@ void OGRSimpleCurve::addPoint( double x, double y )
 void OGRSimpleCurve::addPointM( double x, double y, double m )
 
 {
+    invalidateGEOSCache();
     setPointM( nPointCount, x, y, m );
 }
 
@@ -879,6 +901,7 @@ void OGRSimpleCurve::setPointsM( int nPointsIn, OGRRawPoint * paoPointsIn,
                                  double * padfMIn )
 
 {
+    invalidateGEOSCache();
     setNumPoints( nPointsIn, FALSE );
     if( nPointCount < nPointsIn
 #ifdef DEBUG
@@ -928,6 +951,7 @@ void OGRSimpleCurve::setPoints( int nPointsIn, OGRRawPoint * paoPointsIn,
                                 double * padfZIn, double * padfMIn )
 
 {
+    invalidateGEOSCache();
     setNumPoints( nPointsIn, FALSE );
     if( nPointCount < nPointsIn
 #ifdef DEBUG
@@ -990,6 +1014,7 @@ void OGRSimpleCurve::setPoints( int nPointsIn, OGRRawPoint * paoPointsIn,
                                double * padfZIn )
 
 {
+    invalidateGEOSCache();
     setNumPoints( nPointsIn, FALSE );
     if( nPointCount < nPointsIn
 #ifdef DEBUG
@@ -1039,6 +1064,7 @@ void OGRSimpleCurve::setPoints( int nPointsIn, double * padfX, double * padfY,
                                 double * padfZIn )
 
 {
+    invalidateGEOSCache();
 /* -------------------------------------------------------------------- */
 /*      Check 2D/3D.                                                    */
 /* -------------------------------------------------------------------- */
@@ -1090,6 +1116,7 @@ void OGRSimpleCurve::setPointsM( int nPointsIn, double * padfX, double * padfY,
                                  double * padfMIn )
 
 {
+    invalidateGEOSCache();
 /* -------------------------------------------------------------------- */
 /*      Check 2D/3D.                                                    */
 /* -------------------------------------------------------------------- */
@@ -1142,6 +1169,7 @@ void OGRSimpleCurve::setPoints( int nPointsIn, double * padfX, double * padfY,
                                 double * padfZIn, double * padfMIn )
 
 {
+    invalidateGEOSCache();
 /* -------------------------------------------------------------------- */
 /*      Check 2D/3D.                                                    */
 /* -------------------------------------------------------------------- */
@@ -1351,6 +1379,7 @@ void OGRSimpleCurve::getPoints( void* pabyX, int nXStride,
 void OGRSimpleCurve::reversePoints()
 
 {
+    invalidateGEOSCache();
     for( int i = 0; i < nPointCount/2; i++ )
     {
         const OGRRawPoint sPointTemp = paoPoints[i];
@@ -1390,6 +1419,7 @@ void OGRSimpleCurve::addSubLineString( const OGRLineString *poOtherLine,
                                       int nStartVertex, int nEndVertex )
 
 {
+    invalidateGEOSCache();
     int nOtherLineNumPoints = poOtherLine->getNumPoints();
     if( nOtherLineNumPoints == 0 )
         return;
@@ -1481,6 +1511,7 @@ OGRErr OGRSimpleCurve::importFromWkb( const unsigned char *pabyData,
                                       int& nBytesConsumedOut )
 
 {
+    invalidateGEOSCache();
     OGRwkbByteOrder     eByteOrder;
     int                 nDataOffset = 0;
     int                 nNewNumPoints = 0;
@@ -1688,6 +1719,7 @@ OGRErr OGRSimpleCurve::exportToWkb( OGRwkbByteOrder eByteOrder,
 OGRErr OGRSimpleCurve::importFromWkt( char ** ppszInput )
 
 {
+    invalidateGEOSCache();
     int bHasZ = FALSE;
     int bHasM = FALSE;
     bool bIsEmpty = false;
@@ -1749,6 +1781,7 @@ OGRErr OGRSimpleCurve::importFromWKTListOnly( char ** ppszInput,
                                               double*& padfZIn )
 
 {
+    invalidateGEOSCache();
     const char *pszInput = *ppszInput;
 
 /* -------------------------------------------------------------------- */
@@ -2354,6 +2387,7 @@ OGRBoolean OGRSimpleCurve::Equals( OGRGeometry * poOther ) const
 OGRErr OGRSimpleCurve::transform( OGRCoordinateTransformation *poCT )
 
 {
+    invalidateGEOSCache();
 /* -------------------------------------------------------------------- */
 /*   Make a copy of the points to operate on, so as to be able to       */
 /*   keep only valid reprojected points if partial reprojection enabled */
@@ -2474,6 +2508,7 @@ OGRBoolean OGRSimpleCurve::IsEmpty() const
 
 void OGRSimpleCurve::segmentize( double dfMaxLength )
 {
+    invalidateGEOSCache();
     if( dfMaxLength <= 0 )
     {
         CPLError(CE_Failure, CPLE_AppDefined,
@@ -2573,6 +2608,7 @@ void OGRSimpleCurve::segmentize( double dfMaxLength )
 
 void OGRSimpleCurve::swapXY()
 {
+    invalidateGEOSCache();
     for( int i = 0; i < nPointCount; i++ )
     {
         std::swap(paoPoints[i].x, paoPoints[i].y);
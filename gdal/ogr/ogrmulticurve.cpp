@@ -166,6 +166,7 @@ OGRErr OGRMultiCurve::addCurveDirectlyFromWkt( OGRGeometry* poSelf,
 OGRErr OGRMultiCurve::importFromWkt( char ** ppszInput )
 
 {
+    invalidateGEOSCache();
     const bool bIsMultiCurve = wkbFlatten(getGeometryType()) == wkbMultiCurve;
     return importCurveCollectionFromWkt( ppszInput,
                                          TRUE,  // bAllowEmptyComponent.
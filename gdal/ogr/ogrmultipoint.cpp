@@ -256,6 +256,7 @@ OGRErr OGRMultiPoint::exportToWkt( char ** ppszDstText,
 OGRErr OGRMultiPoint::importFromWkt( char ** ppszInput )
 
 {
+    invalidateGEOSCache();
     const char *pszInputBefore = *ppszInput;
     int bHasZ = FALSE;
     int bHasM = FALSE;
@@ -377,6 +378,7 @@ OGRErr OGRMultiPoint::importFromWkt_Bracketed( char ** ppszInput,
                                                int bHasM, int bHasZ )
 
 {
+    invalidateGEOSCache();
 /* -------------------------------------------------------------------- */
 /*      Skip MULTIPOINT keyword.                                        */
 /* -------------------------------------------------------------------- */
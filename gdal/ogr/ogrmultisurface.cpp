@@ -150,6 +150,7 @@ OGRMultiSurface::isCompatibleSubType( OGRwkbGeometryType eGeomType ) const
 OGRErr OGRMultiSurface::importFromWkt( char ** ppszInput )
 
 {
+    invalidateGEOSCache();
     int bHasZ = FALSE;
     int bHasM = FALSE;
     bool bIsEmpty = false;
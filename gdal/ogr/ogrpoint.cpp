@@ -198,6 +198,7 @@ OGRGeometry *OGRPoint::clone() const
 void OGRPoint::empty()
 
 {
+    invalidateGEOSCache();
     x = 0.0;
     y = 0.0;
     z = 0.0;
@@ -249,6 +250,7 @@ const char * OGRPoint::getGeometryName() const
 void OGRPoint::flattenTo2D()
 
 {
+    invalidateGEOSCache();
     z = 0.0;
     m = 0.0;
     flags &= ~OGR_G_3D;
@@ -262,6 +264,7 @@ void OGRPoint::flattenTo2D()
 void OGRPoint::setCoordinateDimension( int nNewDimension )
 
 {
+    invalidateGEOSCache();
     if( nNewDimension == 2 )
         flattenTo2D();
     else if( nNewDimension == 3 )
@@ -301,6 +304,7 @@ OGRErr OGRPoint::importFromWkb( const unsigned char *pabyData,
                                 int& nBytesConsumedOut )
 
 {
+    invalidateGEOSCache();
     nBytesConsumedOut = -1;
     OGRwkbByteOrder eByteOrder = wkbNDR;
 
@@ -482,6 +486,7 @@ OGRErr OGRPoint::exportToWkb( OGRwkbByteOrder eByteOrder,
 OGRErr OGRPoint::importFromWkt( char ** ppszInput )
 
 {
+    invalidateGEOSCache();
     int bHasZ = FALSE;
     int bHasM = FALSE;
     bool bIsEmpty = false;
@@ -749,6 +754,7 @@ OGRBoolean OGRPoint::Equals( OGRGeometry * poOther ) const
 OGRErr OGRPoint::transform( OGRCoordinateTransformation *poCT )
 
 {
+    invalidateGEOSCache();
     if( poCT->Transform( 1, &x, &y, &z ) )
     {
         assignSpatialReference( poCT->GetTargetCS() );
@@ -764,6 +770,7 @@ OGRErr OGRPoint::transform( OGRCoordinateTransformation *poCT )
 
 void OGRPoint::swapXY()
 {
+    invalidateGEOSCache();
     std::swap(x, y);
 }
 
@@ -147,6 +147,7 @@ const char * OGRPolygon::getGeometryName() const
 OGRLinearRing *OGRPolygon::getExteriorRing()
 
 {
+    invalidateGEOSCache();
     if( oCC.nCurveCount > 0 )
         return (OGRLinearRing*) oCC.papoCurves[0];
 
@@ -191,6 +192,7 @@ const OGRLinearRing *OGRPolygon::getExteriorRing() const
 
 OGRLinearRing *OGRPolygon::stealExteriorRing()
 {
+    invalidateGEOSCache();
     return (OGRLinearRing*)stealExteriorRingCurve();
 }
 
@@ -217,6 +219,7 @@ OGRLinearRing *OGRPolygon::stealExteriorRing()
 OGRLinearRing *OGRPolygon::getInteriorRing( int iRing )
 
 {
+    invalidateGEOSCache();
     if( iRing < 0 || iRing >= oCC.nCurveCount-1 )
         return NULL;
 
@@ -264,6 +267,7 @@ const OGRLinearRing *OGRPolygon::getInteriorRing( int iRing ) const
 
 OGRLinearRing *OGRPolygon::stealInteriorRing( int iRing )
 {
+    invalidateGEOSCache();
     if( iRing < 0 || iRing >= oCC.nCurveCount-1 )
         return NULL;
     OGRLinearRing *poRet = (OGRLinearRing*) oCC.papoCurves[iRing+1];
@@ -322,6 +326,7 @@ OGRErr OGRPolygon::importFromWkb( const unsigned char * pabyData,
                                   int& nBytesConsumedOut )
 
 {
+    invalidateGEOSCache();
     nBytesConsumedOut = -1;
     OGRwkbByteOrder eByteOrder = wkbNDR;
     int nDataOffset = 0;
@@ -447,6 +452,7 @@ OGRErr OGRPolygon::exportToWkb( OGRwkbByteOrder eByteOrder,
 OGRErr OGRPolygon::importFromWkt( char ** ppszInput )
 
 {
+    invalidateGEOSCache();
     int bHasZ = FALSE;
     int bHasM = FALSE;
     bool bIsEmpty = false;
@@ -486,6 +492,7 @@ OGRErr OGRPolygon::importFromWKTListOnly( char ** ppszInput,
                                           double*& padfZ )
 
 {
+    invalidateGEOSCache();
     char szToken[OGR_WKT_TOKEN_MAX] = {};
     const char *pszInput = *ppszInput;
 
@@ -800,6 +807,7 @@ OGRBoolean OGRPolygon::IsPointOnSurface( const OGRPoint * pt ) const
 void OGRPolygon::closeRings()
 
 {
+    invalidateGEOSCache();
     for( int iRing = 0; iRing < oCC.nCurveCount; iRing++ )
         oCC.papoCurves[iRing]->closeRings();
 }
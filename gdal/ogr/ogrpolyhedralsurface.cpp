@@ -152,6 +152,7 @@ int OGRPolyhedralSurface::getDimension() const
 
 void OGRPolyhedralSurface::empty()
 {
+    invalidateGEOSCache();
     if( oMP.papoGeoms != NULL )
     {
         for( int i = 0; i < oMP.nGeomCount; i++ )
@@ -218,6 +219,7 @@ OGRErr OGRPolyhedralSurface::importFromWkb ( const unsigned char * pabyData,
                                              OGRwkbVariant eWkbVariant,
                                              int& nBytesConsumedOut )
 {
+    invalidateGEOSCache();
     nBytesConsumedOut = -1;
     oMP.nGeomCount = 0;
     OGRwkbByteOrder eByteOrder = wkbXDR;
@@ -357,6 +359,7 @@ OGRErr  OGRPolyhedralSurface::exportToWkb ( OGRwkbByteOrder eByteOrder,
 
 OGRErr OGRPolyhedralSurface::importFromWkt( char ** ppszInput )
 {
+    invalidateGEOSCache();
     int bHasZ = FALSE, bHasM = FALSE;
     bool bIsEmpty = false;
     OGRErr      eErr = importPreambuleFromWkt(
@@ -634,6 +637,7 @@ error:
 
 void OGRPolyhedralSurface::flattenTo2D()
 {
+    invalidateGEOSCache();
     oMP.flattenTo2D();
 
     flags &= ~OGR_G_3D;
@@ -646,6 +650,7 @@ void OGRPolyhedralSurface::flattenTo2D()
 
 OGRErr OGRPolyhedralSurface::transform( OGRCoordinateTransformation *poCT )
 {
+    invalidateGEOSCache();
     return oMP.transform(poCT);
 }
 
@@ -859,6 +864,7 @@ OGRMultiPolygon* OGRPolyhedralSurface::CastToMultiPolygon(
 
 OGRErr OGRPolyhedralSurface::addGeometry (const OGRGeometry *poNewGeom)
 {
+    invalidateGEOSCache();
     if (!isCompatibleSubType(poNewGeom->getGeometryType()))
         return OGRERR_UNSUPPORTED_GEOMETRY_TYPE;
 
@@ -895,6 +901,7 @@ OGRErr OGRPolyhedralSurface::addGeometry (const OGRGeometry *poNewGeom)
 
 OGRErr OGRPolyhedralSurface::addGeometryDirectly (OGRGeometry *poNewGeom)
 {
+    invalidateGEOSCache();
     if (!isCompatibleSubType(poNewGeom->getGeometryType()))
     {
         return OGRERR_UNSUPPORTED_GEOMETRY_TYPE;
@@ -959,6 +966,7 @@ int OGRPolyhedralSurface::getNumGeometries() const
 
 OGRGeometry* OGRPolyhedralSurface::getGeometryRef(int i)
 {
+    invalidateGEOSCache();
     return oMP.papoGeoms[i];
 }
 
@@ -1060,6 +1068,7 @@ void OGRPolyhedralSurface::setCoordinateDimension (int nNewDimension)
 
 void OGRPolyhedralSurface::swapXY()
 {
+    invalidateGEOSCache();
     oMP.swapXY();
 }
 
@@ -1096,5 +1105,6 @@ OGRBoolean OGRPolyhedralSurface::hasCurveGeometry(int) const
 
 OGRErr OGRPolyhedralSurface::removeGeometry(int iGeom, int bDelete)
 {
+    invalidateGEOSCache();
     return oMP.removeGeometry(iGeom,bDelete);
 }
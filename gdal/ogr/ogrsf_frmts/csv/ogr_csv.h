@@ -33,6 +33,8 @@
 
 #include "ogrsf_frmts.h"
 
+#include <vector>
+
 #if defined(_MSC_VER) && _MSC_VER <= 1600 // MSVC <= 2010
 # define GDAL_OVERRIDE
 #else
@@ -66,6 +68,8 @@ typedef enum
 
 void OGRCSVDriverRemoveFromMap(const char *pszName, GDALDataset *poDS);
 
+class OGRCSVParallelReader;
+
 /************************************************************************/
 /*                             OGRCSVLayer                              */
 /************************************************************************/
@@ -81,6 +85,8 @@ class OGRCSVLayer : public OGRLayer
     bool                bHasFieldNames;
 
     OGRFeature         *GetNextUnfilteredFeature();
+    OGRFeature         *TranslateTokens( char **papszTokens, int nTokenCount,
+                                         int nFID, CPLString *posWarning );
 
     bool                bNew;
     bool                bInWriteMode;
@@ -128,6 +134,24 @@ class OGRCSVLayer : public OGRLayer
     bool                bEmptyStringNull;
 
     char              **GetNextLineTokens();
+    void                Rewind();
+
+    // Start offset of the record of each FID read so far.
+    std::vector<vsi_l_offset> anFeatureOffsets;
+
+    // FIDs of the features matching the attribute filter, when it can be
+    // resolved with attribute indexes.
+    GIntBig            *panMatchingFIDs;
+    int                 iMatchingFID;
+    bool                bMatchingFIDsScanned;
+
+    // Reading with worker threads.
+    int                 nNumThreads;
+    OGRCSVParallelReader *poParallelReader;
+    bool                bParallelReadSuspended;
+    void                StopParallelRead();
+
+    friend class OGRCSVParallelReader;
 
     static bool         Matches( const char *pszFieldName,
                                  char **papszPossibleNames );
@@ -156,6 +180,8 @@ class OGRCSVLayer : public OGRLayer
 
     void                ResetReading() override;
     OGRFeature         *GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                         int nMaxFeatures ) override;
     virtual OGRFeature *GetFeature( GIntBig nFID ) override;
 
     OGRFeatureDefn     *GetLayerDefn() override { return poFeatureDefn; }
@@ -40,6 +40,7 @@
 #  include <fcntl.h>
 #endif
 #include <algorithm>
+#include <deque>
 #include <limits>
 #include <string>
 #include <vector>
@@ -47,8 +48,10 @@
 #include "cpl_conv.h"
 #include "cpl_csv.h"
 #include "cpl_error.h"
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_api.h"
 #include "ogr_core.h"
 #include "ogr_feature.h"
@@ -62,29 +65,29 @@
 CPL_CVSID("$Id$")
 
 /************************************************************************/
-/*                            CSVSplitLine()                            */
+/*                        CSVSplitLineToBuffer()                        */
 /*                                                                      */
-/*      Tokenize a CSV line into fields in the form of a string         */
-/*      list.  This is used instead of the CPLTokenizeString()          */
-/*      because it provides correct CSV escaping and quoting            */
-/*      semantics.                                                      */
+/*      Tokenize a CSV line into fields, appended as nul terminated     */
+/*      strings to abyTokens, whose start offsets are appended to       */
+/*      anTokenOffsets.  This provides correct CSV escaping and         */
+/*      quoting semantics, unlike CPLTokenizeString().                  */
 /************************************************************************/
 
-static char **CSVSplitLine( const char *pszString, char chDelimiter,
-                            bool bKeepLeadingAndClosingQuotes,
-                            bool bMergeDelimiter )
+static void CSVSplitLineToBuffer( const char *pszString, char chDelimiter,
+                                  bool bKeepLeadingAndClosingQuotes,
+                                  bool bMergeDelimiter,
+                                  std::vector<char> &abyTokens,
+                                  std::vector<size_t> &anTokenOffsets )
 
 {
-    char **papszRetList = NULL;
-
-    char *pszToken = static_cast<char *>(CPLCalloc(10, 1));
-    int nTokenMax = 10;
+    abyTokens.clear();
+    anTokenOffsets.clear();
 
     while( pszString != NULL && *pszString != '\0' )
     {
         bool bInString = false;
 
-        int nTokenLen = 0;
+        anTokenOffsets.push_back(abyTokens.size());
 
         // Try to find the next delimiter, marking end of token.
         for( ; *pszString != '\0'; pszString++ )
@@ -115,31 +118,42 @@ static char **CSVSplitLine( const char *pszString, char chDelimiter,
                 }
             }
 
-            if( nTokenLen >= nTokenMax - 2 )
-            {
-                nTokenMax = nTokenMax * 2 + 10;
-                pszToken = static_cast<char *>(CPLRealloc(pszToken, nTokenMax));
-            }
-
-            pszToken[nTokenLen] = *pszString;
-            nTokenLen++;
+            abyTokens.push_back(*pszString);
         }
 
-        pszToken[nTokenLen] = '\0';
-        papszRetList = CSLAddString(papszRetList, pszToken);
+        abyTokens.push_back('\0');
 
         // If the last token is an empty token, then we have to catch
         // it now, otherwise we won't reenter the loop and it will be lost.
         if( *pszString == '\0' && *(pszString - 1) == chDelimiter )
         {
-            papszRetList = CSLAddString(papszRetList, "");
+            anTokenOffsets.push_back(abyTokens.size());
+            abyTokens.push_back('\0');
         }
     }
+}
 
-    if( papszRetList == NULL )
-        papszRetList = static_cast<char **>(CPLCalloc(sizeof(char *), 1));
+/************************************************************************/
+/*                            CSVSplitLine()                            */
+/*                                                                      */
+/*      Same as CSVSplitLineToBuffer(), but returning the fields in     */
+/*      the form of a string list.                                      */
+/************************************************************************/
+
+static char **CSVSplitLine( const char *pszString, char chDelimiter,
+                            bool bKeepLeadingAndClosingQuotes,
+                            bool bMergeDelimiter )
+
+{
+    std::vector<char> abyTokens;
+    std::vector<size_t> anTokenOffsets;
+    CSVSplitLineToBuffer(pszString, chDelimiter, bKeepLeadingAndClosingQuotes,
+                         bMergeDelimiter, abyTokens, anTokenOffsets);
 
-    CPLFree(pszToken);
+    char **papszRetList = static_cast<char **>(
+        CPLCalloc(sizeof(char *), anTokenOffsets.size() + 1));
+    for( size_t i = 0; i < anTokenOffsets.size(); i++ )
+        papszRetList[i] = CPLStrdup(&abyTokens[anTokenOffsets[i]]);
 
     return papszRetList;
 }
@@ -225,6 +239,132 @@ char **OGRCSVReadParseLineL( VSILFILE *fp, char chDelimiter,
     return papszReturn;
 }
 
+/************************************************************************/
+/*                         OGRCSVParallelReader                         */
+/*                                                                      */
+/*      Reads a CSV file with worker threads.  The calling thread cuts  */
+/*      the file into chunks of complete records, following the same    */
+/*      line ending and quoting rules as OGRCSVReadParseLineL().  The   */
+/*      workers tokenize the records of a chunk and translate them to   */
+/*      features, or guess the type of their values for                 */
+/*      AutodetectFieldTypes().  Chunks are returned in file order,     */
+/*      then recycled with their buffers.                               */
+/************************************************************************/
+
+class OGRCSVParallelReader;
+
+struct OGRCSVChunk
+{
+    OGRCSVParallelReader *poReader;
+    bool                  bDone;
+
+    // Bytes of complete records, starting at file offset nOffset.
+    std::vector<char>     abyData;
+    vsi_l_offset          nOffset;
+    // Position of the non-empty records in abyData, line ending excluded.
+    std::vector<size_t>   anRecordStart;
+    std::vector<size_t>   anRecordEnd;
+    int                   nFirstFID;
+
+    // Buffers of the worker.
+    std::vector<char>     abyLine;
+    std::vector<char>     abyTokens;
+    std::vector<size_t>   anTokenOffsets;
+    std::vector<char *>   apszTokens;
+
+    // FEATURES mode results.
+    std::vector<OGRFeature *> apoFeatures;
+    size_t                iNextFeature;
+    CPLString             osWarning;
+    int                   iWarningFeature;
+
+    // FIELD_TYPES mode results: the guess for each of the first
+    // anCellCount[i] values of each record.
+    std::vector<int>      anCellCount;
+    std::vector<GByte>    abyCellType;
+    std::vector<int>      anCellWidth;
+    std::vector<int>      anCellPrecision;
+
+    OGRCSVChunk() : poReader(NULL), bDone(false), nOffset(0), nFirstFID(0),
+                    iNextFeature(0), iWarningFeature(-1) {}
+};
+
+class OGRCSVParallelReader
+{
+  public:
+    typedef enum
+    {
+        FEATURES,
+        FIELD_TYPES,
+        RECORD_COUNT
+    } Mode;
+
+  private:
+    OGRCSVLayer          *m_poLayer;
+    Mode                  m_eMode;
+    int                   m_nThreads;
+    bool                  m_bHonourStrings;
+    vsi_l_offset          m_nMaxOffset;
+
+    // FIELD_TYPES mode settings.
+    int                   m_nFieldCount;
+    bool                  m_bKeepQuotes;
+    bool                  m_bAutodetectWidth;
+    bool                  m_bAutodetectWidthForIntOrReal;
+
+    // State of the record splitting.
+    std::vector<char>     m_abyBuffer;
+    vsi_l_offset          m_nBufferOffset;
+    size_t                m_nScanPos;
+    size_t                m_nRecordStart;
+    size_t                m_nLastEOLStart;
+    size_t                m_nLastEOLEnd;
+    bool                  m_bInString;
+    bool                  m_bEOF;
+    bool                  m_bLimitReached;
+    bool                  m_bSplitDone;
+    int                   m_nNextFID;
+    size_t                m_nChunkSize;
+
+    CPLWorkerThreadPool   m_oPool;
+    CPLMutex             *m_hMutex;
+    CPLCond              *m_hCond;
+    std::deque<OGRCSVChunk *> m_apoPending;
+    std::vector<OGRCSVChunk *> m_apoFree;
+    OGRCSVChunk          *m_poCurrent;
+
+    bool                  ReadMore();
+    void                  AddRecord( OGRCSVChunk *psChunk,
+                                     size_t nStart, size_t nEnd );
+    bool                  SplitChunk( OGRCSVChunk *psChunk );
+    static void           ProcessChunkFunc( void *pData );
+    void                  ProcessChunk( OGRCSVChunk *psChunk );
+    static void           ClearResults( OGRCSVChunk *psChunk );
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRCSVParallelReader)
+
+  public:
+                          OGRCSVParallelReader( OGRCSVLayer *poLayer,
+                                                Mode eMode, int nThreads,
+                                                vsi_l_offset nMaxOffset = 0 );
+                         ~OGRCSVParallelReader();
+
+    void                  SetFieldTypesOptions(
+                              int nFieldCount, bool bKeepQuotes,
+                              bool bAutodetectWidth,
+                              bool bAutodetectWidthForIntOrReal );
+    bool                  Init();
+
+    OGRCSVChunk          *GetNextChunk();
+    void                  ReleaseChunk( OGRCSVChunk *psChunk );
+    OGRFeature           *GetNextFeature();
+    GIntBig               CountRecords();
+
+    // File offset of the first byte not yet assigned to a chunk.
+    vsi_l_offset          GetSplitOffset() const
+        { return m_nBufferOffset + m_nRecordStart; }
+};
+
 /************************************************************************/
 /*                            OGRCSVLayer()                             */
 /*                                                                      */
@@ -266,8 +406,16 @@ OGRCSVLayer::OGRCSVLayer( const char *pszLayerNameIn,
     bKeepSourceColumns(false),
     bKeepGeomColumns(true),
     bMergeDelimiter(false),
-    bEmptyStringNull(false)
+    bEmptyStringNull(false),
+    panMatchingFIDs(NULL),
+    iMatchingFID(0),
+    bMatchingFIDsScanned(false),
+    nNumThreads(1),
+    poParallelReader(NULL),
+    bParallelReadSuspended(false)
 {
+    m_bAutoAttrIndex = true;
+
     poFeatureDefn = new OGRFeatureDefn(pszLayerNameIn);
     SetDescription(poFeatureDefn->GetName());
     poFeatureDefn->Reference();
@@ -340,6 +488,10 @@ void OGRCSVLayer::BuildFeatureDefn( const char *pszNfdcGeomField,
     bEmptyStringNull =
         CPLFetchBool(papszOpenOptions, "EMPTY_STRING_AS_NULL", false);
 
+    // Number of threads used to parse the records when reading.
+    if( !bInWriteMode )
+        nNumThreads = CPLGetNumThreads(papszOpenOptions, "1");
+
     // If this is not a new file, read ahead to establish if it is
     // already in CRLF (DOS) mode, or just a normal unix CR mode.
     if( !bNew && bInWriteMode )
@@ -996,6 +1148,179 @@ static bool OGRCSVIsFalse(const char *pszStr)
            EQUAL(pszStr, "no") || EQUAL(pszStr, "off");
 }
 
+/************************************************************************/
+/*                        OGRCSVGuessValueType()                        */
+/*                                                                      */
+/*      Guess the type of a single value for AutodetectFieldTypes().    */
+/*      The returned code is an OGRFieldType, ORed with                 */
+/*      OGR_CSV_GUESS_BOOLEAN for true/false strings, or                */
+/*      OGR_CSV_GUESS_EMPTY.  Date parsing is skipped when              */
+/*      bKnownString is set, as the field will stay a String anyway.    */
+/************************************************************************/
+
+static const GByte OGR_CSV_GUESS_BOOLEAN = 0x40;
+static const GByte OGR_CSV_GUESS_EMPTY = 0xFF;
+
+static GByte OGRCSVGuessValueType( char *pszToken, char chDelimiter,
+                                   bool bKnownString, bool bAutodetectWidth,
+                                   bool bAutodetectWidthForIntOrReal,
+                                   int *pnFieldWidth, int *pnFieldPrecision )
+{
+    *pnFieldWidth = 0;
+    *pnFieldPrecision = 0;
+
+    if( pszToken[0] == 0 )
+        return OGR_CSV_GUESS_EMPTY;
+    if( chDelimiter == ';' )
+    {
+        char *chComma = strchr(pszToken, ',');
+        if( chComma )
+            *chComma = '.';
+    }
+    const CPLValueType eType = CPLGetValueType(pszToken);
+
+    if( bAutodetectWidth )
+    {
+        *pnFieldWidth = static_cast<int>(strlen(pszToken));
+        if( pszToken[0] == '"' && pszToken[*pnFieldWidth - 1] == '"' )
+        {
+            *pnFieldWidth -= 2;
+        }
+        if( eType == CPL_VALUE_REAL && bAutodetectWidthForIntOrReal )
+        {
+            const char *pszDot = strchr(pszToken, '.');
+            if( pszDot != NULL )
+                *pnFieldPrecision = static_cast<int>(strlen(pszDot + 1));
+        }
+    }
+
+    if( eType == CPL_VALUE_INTEGER )
+    {
+        GIntBig nVal = CPLAtoGIntBig(pszToken);
+        if( !CPL_INT64_FITS_ON_INT32(nVal) )
+            return static_cast<GByte>(OFTInteger64);
+        return static_cast<GByte>(OFTInteger);
+    }
+    if( eType == CPL_VALUE_REAL )
+        return static_cast<GByte>(OFTReal);
+
+    const GByte nBoolean =
+        OGRCSVIsTrue(pszToken) || OGRCSVIsFalse(pszToken) ?
+        OGR_CSV_GUESS_BOOLEAN : 0;
+    if( bKnownString )
+        return static_cast<GByte>(OFTString) | nBoolean;
+
+    OGRField sWrkField;
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    const bool bSuccess = CPL_TO_BOOL(OGRParseDate(pszToken, &sWrkField, 0));
+    CPLPopErrorHandler();
+    CPLErrorReset();
+    if( bSuccess )
+    {
+        const bool bHasDate =
+            strchr(pszToken, '/') != NULL || strchr(pszToken, '-') != NULL;
+        const bool bHasTime = strchr(pszToken, ':') != NULL;
+        if( bHasDate && bHasTime )
+            return static_cast<GByte>(OFTDateTime);
+        else if( bHasDate )
+            return static_cast<GByte>(OFTDate);
+        return static_cast<GByte>(OFTTime);
+    }
+    return static_cast<GByte>(OFTString) | nBoolean;
+}
+
+/************************************************************************/
+/*                       OGRCSVMergeValueType()                         */
+/*                                                                      */
+/*      Update the guessed type of a field with the guess for one more  */
+/*      of its values.                                                  */
+/************************************************************************/
+
+static void OGRCSVMergeValueType( GByte nGuess, OGRFieldType &eFieldType,
+                                  int &bFieldSet, int &bFieldBoolean,
+                                  int &nStringFieldCount )
+{
+    const OGRFieldType eOGRFieldType =
+        static_cast<OGRFieldType>(nGuess & ~OGR_CSV_GUESS_BOOLEAN);
+    const bool bIsBoolean = (nGuess & OGR_CSV_GUESS_BOOLEAN) != 0;
+
+    if( bFieldSet && eFieldType == OFTString &&
+        eOGRFieldType != OFTInteger && eOGRFieldType != OFTInteger64 &&
+        eOGRFieldType != OFTReal )
+    {
+        if( bFieldBoolean )
+            bFieldBoolean = bIsBoolean;
+        return;
+    }
+
+    if( !bFieldSet )
+    {
+        eFieldType = eOGRFieldType;
+        bFieldSet = TRUE;
+        bFieldBoolean = bIsBoolean;
+        if( eOGRFieldType == OFTString && !bIsBoolean )
+            nStringFieldCount++;
+    }
+    else if( eFieldType != eOGRFieldType )
+    {
+        // Promotion rules.
+        if( eFieldType == OFTInteger )
+        {
+            if( eOGRFieldType == OFTInteger64 ||
+                eOGRFieldType == OFTReal )
+                eFieldType = eOGRFieldType;
+            else
+            {
+                eFieldType = OFTString;
+                nStringFieldCount++;
+            }
+        }
+        else if( eFieldType == OFTInteger64 )
+        {
+            if( eOGRFieldType == OFTReal )
+                eFieldType = eOGRFieldType;
+            else if( eOGRFieldType != OFTInteger )
+            {
+                eFieldType = OFTString;
+                nStringFieldCount++;
+            }
+        }
+        else if( eFieldType == OFTReal )
+        {
+            if( eOGRFieldType != OFTInteger &&
+                eOGRFieldType != OFTReal )
+            {
+                eFieldType = OFTString;
+                nStringFieldCount++;
+            }
+        }
+        else if( eFieldType == OFTDate )
+        {
+            if( eOGRFieldType == OFTDateTime )
+                eFieldType = OFTDateTime;
+            else
+            {
+                eFieldType = OFTString;
+                nStringFieldCount++;
+            }
+        }
+        else if( eFieldType == OFTDateTime )
+        {
+            if( eOGRFieldType != OFTDate &&
+                eOGRFieldType != OFTDateTime )
+            {
+                eFieldType = OFTString;
+                nStringFieldCount++;
+            }
+        }
+        else if( eFieldType == OFTTime )
+        {
+            eFieldType = OFTString;
+            nStringFieldCount++;
+        }
+    }
+}
+
 /************************************************************************/
 /*                        AutodetectFieldTypes()                        */
 /************************************************************************/
@@ -1007,6 +1332,7 @@ char **OGRCSVLayer::AutodetectFieldTypes(char **papszOpenOptions,
     // caching.
     int nBytes = atoi(CSLFetchNameValueDef(papszOpenOptions,
                                            "AUTODETECT_SIZE_LIMIT", "1000000"));
+    const bool bWholeFile = nBytes == 0;
     if( nBytes == 0 )
     {
         const vsi_l_offset nCurPos = VSIFTellL(fpCSV);
@@ -1035,10 +1361,74 @@ char **OGRCSVLayer::AutodetectFieldTypes(char **papszOpenOptions,
     // This will be returned as the result.
     char **papszFieldTypes = NULL;
 
-    char *pszData = static_cast<char *>(VSI_MALLOC_VERBOSE(nBytes));
+    std::vector<OGRFieldType> aeFieldType(nFieldCount);
+    std::vector<int> abFieldBoolean(nFieldCount);
+    std::vector<int> abFieldSet(nFieldCount);
+    std::vector<int> anFieldWidth(nFieldCount);
+    std::vector<int> anFieldPrecision(nFieldCount);
+    int nStringFieldCount = 0;
+    bool bDetected = false;
+
+    if( nNumThreads > 1 &&
+        (bWholeFile || static_cast<vsi_l_offset>(nBytes) > VSIFTellL(fpCSV)) )
+    {
+        // Guess the value types with worker threads, and merge the guesses
+        // in file order.  Without size limit, the whole file is scanned.
+        OGRCSVParallelReader oReader(
+            this, OGRCSVParallelReader::FIELD_TYPES, nNumThreads,
+            bWholeFile ? 0 : static_cast<vsi_l_offset>(nBytes) - 1);
+        oReader.SetFieldTypesOptions(nFieldCount, bQuotedFieldAsString,
+                                     bAutodetectWidth,
+                                     bAutodetectWidthForIntOrReal);
+        if( oReader.Init() )
+        {
+            bDetected = true;
+            bool bStop = false;
+            OGRCSVChunk *psChunk = NULL;
+            while( !bStop && (psChunk = oReader.GetNextChunk()) != NULL )
+            {
+                size_t iCell = 0;
+                for( size_t iRecord = 0;
+                     !bStop && iRecord < psChunk->anCellCount.size();
+                     iRecord++ )
+                {
+                    const int nCellCount = psChunk->anCellCount[iRecord];
+                    for( int iField = 0; iField < nCellCount;
+                         iField++, iCell++ )
+                    {
+                        const GByte nGuess = psChunk->abyCellType[iCell];
+                        if( nGuess == OGR_CSV_GUESS_EMPTY )
+                            continue;
+                        OGRCSVMergeValueType(nGuess, aeFieldType[iField],
+                                             abFieldSet[iField],
+                                             abFieldBoolean[iField],
+                                             nStringFieldCount);
+                        if( bAutodetectWidth )
+                        {
+                            anFieldWidth[iField] =
+                                std::max(anFieldWidth[iField],
+                                         psChunk->anCellWidth[iCell]);
+                            anFieldPrecision[iField] =
+                                std::max(anFieldPrecision[iField],
+                                         psChunk->anCellPrecision[iCell]);
+                        }
+                    }
+
+                    // Same early stop as below.
+                    if( nStringFieldCount == nFieldCount && bAutodetectWidth )
+                        bStop = true;
+                }
+                oReader.ReleaseChunk(psChunk);
+            }
+        }
+    }
+
+    char *pszData = bDetected ? NULL :
+        static_cast<char *>(VSI_MALLOC_VERBOSE(nBytes));
     if( pszData != NULL &&
         static_cast<vsi_l_offset>(nBytes) > VSIFTellL(fpCSV) )
     {
+        bDetected = true;
         const int nRequested = nBytes - 1 - static_cast<int>(VSIFTellL(fpCSV));
         const int nRead =
             static_cast<int>(VSIFReadL(pszData, 1, nRequested, fpCSV));
@@ -1048,13 +1438,6 @@ char **OGRCSVLayer::AutodetectFieldTypes(char **papszOpenOptions,
         VSILFILE *fpMem = VSIFileFromMemBuffer(
             osTmpMemFile, reinterpret_cast<GByte *>(pszData), nRead, FALSE);
 
-        std::vector<OGRFieldType> aeFieldType(nFieldCount);
-        std::vector<int> abFieldBoolean(nFieldCount);
-        std::vector<int> abFieldSet(nFieldCount);
-        std::vector<int> anFieldWidth(nFieldCount);
-        std::vector<int> anFieldPrecision(nFieldCount);
-        int nStringFieldCount = 0;
-
         while( !VSIFEofL(fpMem) )
         {
             char **papszTokens =
@@ -1075,158 +1458,20 @@ char **OGRCSVLayer::AutodetectFieldTypes(char **papszOpenOptions,
             for( int iField = 0;
                  iField < nFieldCount && papszTokens[iField] != NULL; iField++ )
             {
-                if( papszTokens[iField][0] == 0 )
-                    continue;
-                if( chDelimiter == ';' )
-                {
-                    char *chComma = strchr(papszTokens[iField], ',');
-                    if( chComma )
-                        *chComma = '.';
-                }
-                CPLValueType eType = CPLGetValueType(papszTokens[iField]);
-
                 int nFieldWidth = 0;
                 int nFieldPrecision = 0;
+                const GByte nGuess = OGRCSVGuessValueType(
+                    papszTokens[iField], chDelimiter,
+                    abFieldSet[iField] && aeFieldType[iField] == OFTString,
+                    bAutodetectWidth, bAutodetectWidthForIntOrReal,
+                    &nFieldWidth, &nFieldPrecision);
+                if( nGuess == OGR_CSV_GUESS_EMPTY )
+                    continue;
 
-                if( bAutodetectWidth )
-                {
-                    nFieldWidth = static_cast<int>(strlen(papszTokens[iField]));
-                    if( papszTokens[iField][0] == '"' &&
-                        papszTokens[iField][nFieldWidth - 1] == '"' )
-                    {
-                        nFieldWidth -= 2;
-                    }
-                    if( eType == CPL_VALUE_REAL &&
-                        bAutodetectWidthForIntOrReal )
-                    {
-                        const char *pszDot = strchr(papszTokens[iField], '.');
-                        if( pszDot != NULL )
-                            nFieldPrecision =
-                                static_cast<int>(strlen(pszDot + 1));
-                    }
-                }
-
-                OGRFieldType eOGRFieldType;
-                bool bIsBoolean = false;
-                if( eType == CPL_VALUE_INTEGER )
-                {
-                    GIntBig nVal = CPLAtoGIntBig(papszTokens[iField]);
-                    if( !CPL_INT64_FITS_ON_INT32(nVal) )
-                        eOGRFieldType = OFTInteger64;
-                    else
-                        eOGRFieldType = OFTInteger;
-                }
-                else if( eType == CPL_VALUE_REAL )
-                {
-                    eOGRFieldType = OFTReal;
-                }
-                else if( abFieldSet[iField] &&
-                         aeFieldType[iField] == OFTString )
-                {
-                    eOGRFieldType = OFTString;
-                    if( abFieldBoolean[iField] )
-                    {
-                        abFieldBoolean[iField] =
-                            OGRCSVIsTrue(papszTokens[iField]) ||
-                            OGRCSVIsFalse(papszTokens[iField]);
-                    }
-                }
-                else
-                {
-                    OGRField sWrkField;
-                    CPLPushErrorHandler(CPLQuietErrorHandler);
-                    const bool bSuccess = CPL_TO_BOOL(
-                        OGRParseDate(papszTokens[iField], &sWrkField, 0));
-                    CPLPopErrorHandler();
-                    CPLErrorReset();
-                    if( bSuccess )
-                    {
-                        const bool bHasDate =
-                            strchr(papszTokens[iField], '/') != NULL ||
-                            strchr(papszTokens[iField], '-') != NULL;
-                        const bool bHasTime =
-                            strchr(papszTokens[iField], ':') != NULL;
-                        if( bHasDate && bHasTime )
-                            eOGRFieldType = OFTDateTime;
-                        else if( bHasDate )
-                            eOGRFieldType = OFTDate;
-                        else
-                            eOGRFieldType = OFTTime;
-                    }
-                    else
-                    {
-                        eOGRFieldType = OFTString;
-                        bIsBoolean = OGRCSVIsTrue(papszTokens[iField]) ||
-                                     OGRCSVIsFalse(papszTokens[iField]);
-                    }
-                }
-
-                if( !abFieldSet[iField] )
-                {
-                    aeFieldType[iField] = eOGRFieldType;
-                    abFieldSet[iField] = TRUE;
-                    abFieldBoolean[iField] = bIsBoolean;
-                    if( eOGRFieldType == OFTString && !bIsBoolean )
-                        nStringFieldCount++;
-                }
-                else if( aeFieldType[iField] != eOGRFieldType )
-                {
-                    // Promotion rules.
-                    if( aeFieldType[iField] == OFTInteger )
-                    {
-                        if( eOGRFieldType == OFTInteger64 ||
-                            eOGRFieldType == OFTReal )
-                            aeFieldType[iField] = eOGRFieldType;
-                        else
-                        {
-                            aeFieldType[iField] = OFTString;
-                            nStringFieldCount++;
-                        }
-                    }
-                    else if( aeFieldType[iField] == OFTInteger64 )
-                    {
-                        if( eOGRFieldType == OFTReal )
-                            aeFieldType[iField] = eOGRFieldType;
-                        else if( eOGRFieldType != OFTInteger )
-                        {
-                            aeFieldType[iField] = OFTString;
-                            nStringFieldCount++;
-                        }
-                    }
-                    else if( aeFieldType[iField] == OFTReal )
-                    {
-                        if( eOGRFieldType != OFTInteger &&
-                            eOGRFieldType != OFTReal )
-                        {
-                            aeFieldType[iField] = OFTString;
-                            nStringFieldCount++;
-                        }
-                    }
-                    else if( aeFieldType[iField] == OFTDate )
-                    {
-                        if( eOGRFieldType == OFTDateTime )
-                            aeFieldType[iField] = OFTDateTime;
-                        else
-                        {
-                            aeFieldType[iField] = OFTString;
-                            nStringFieldCount++;
-                        }
-                    }
-                    else if( aeFieldType[iField] == OFTDateTime )
-                    {
-                        if( eOGRFieldType != OFTDate &&
-                            eOGRFieldType != OFTDateTime )
-                        {
-                            aeFieldType[iField] = OFTString;
-                            nStringFieldCount++;
-                        }
-                    }
-                    else if( aeFieldType[iField] == OFTTime )
-                    {
-                        aeFieldType[iField] = OFTString;
-                        nStringFieldCount++;
-                    }
-                }
+                OGRCSVMergeValueType(nGuess, aeFieldType[iField],
+                                     abFieldSet[iField],
+                                     abFieldBoolean[iField],
+                                     nStringFieldCount);
 
                 if( nFieldWidth > anFieldWidth[iField] )
                     anFieldWidth[iField] = nFieldWidth;
@@ -1242,6 +1487,13 @@ char **OGRCSVLayer::AutodetectFieldTypes(char **papszOpenOptions,
                 break;
         }
 
+        VSIFCloseL(fpMem);
+        VSIUnlink(osTmpMemFile);
+    }
+    VSIFree(pszData);
+
+    if( bDetected )
+    {
         papszFieldTypes =
             static_cast<char **>(CPLCalloc(nFieldCount + 1, sizeof(char *)));
         for( int iField = 0; iField < nFieldCount; iField++ )
@@ -1272,38 +1524,582 @@ char **OGRCSVLayer::AutodetectFieldTypes(char **papszOpenOptions,
             else if( abFieldBoolean[iField] )
                 osFieldType = "Integer(Boolean)";
             else
-                osFieldType = "String";
+                osFieldType = "String";
+
+            if( !abFieldBoolean[iField] )
+            {
+                if( anFieldWidth[iField] > 0 &&
+                    (aeFieldType[iField] == OFTString ||
+                    (bAutodetectWidthForIntOrReal &&
+                     (aeFieldType[iField] == OFTInteger ||
+                      aeFieldType[iField] == OFTInteger64))) )
+                {
+                    osFieldType += CPLSPrintf(" (%d)", anFieldWidth[iField]);
+                }
+                else if( anFieldWidth[iField] > 0 &&
+                         bAutodetectWidthForIntOrReal &&
+                         aeFieldType[iField] == OFTReal )
+                {
+                    osFieldType += CPLSPrintf(" (%d.%d)", anFieldWidth[iField],
+                                              anFieldPrecision[iField]);
+                }
+            }
+
+            papszFieldTypes[iField] = CPLStrdup(osFieldType);
+        }
+    }
+
+    ResetReading();
+
+    return papszFieldTypes;
+}
+
+/************************************************************************/
+/*                        OGRCSVParallelReader()                        */
+/************************************************************************/
+
+OGRCSVParallelReader::OGRCSVParallelReader( OGRCSVLayer *poLayer,
+                                            Mode eMode, int nThreads,
+                                            vsi_l_offset nMaxOffset ) :
+    m_poLayer(poLayer),
+    m_eMode(eMode),
+    m_nThreads(nThreads),
+    m_bHonourStrings(eMode == FIELD_TYPES ||
+                     !(poLayer->chDelimiter == '\t' &&
+                       poLayer->bDontHonourStrings)),
+    m_nMaxOffset(nMaxOffset),
+    m_nFieldCount(0),
+    m_bKeepQuotes(false),
+    m_bAutodetectWidth(false),
+    m_bAutodetectWidthForIntOrReal(false),
+    m_nBufferOffset(VSIFTellL(poLayer->fpCSV)),
+    m_nScanPos(0),
+    m_nRecordStart(0),
+    m_nLastEOLStart(0),
+    m_nLastEOLEnd(0),
+    m_bInString(false),
+    m_bEOF(false),
+    m_bLimitReached(false),
+    m_bSplitDone(false),
+    m_nNextFID(poLayer->nNextFID),
+    m_nChunkSize(static_cast<size_t>(std::max(1024, atoi(
+        CPLGetConfigOption("OGR_CSV_PARALLEL_CHUNK_SIZE", "1048576"))))),
+    m_hMutex(NULL),
+    m_hCond(NULL),
+    m_poCurrent(NULL)
+{
+    if( m_nMaxOffset != 0 && m_nMaxOffset <= m_nBufferOffset )
+    {
+        m_bEOF = true;
+        m_bLimitReached = true;
+    }
+}
+
+/************************************************************************/
+/*                       ~OGRCSVParallelReader()                        */
+/************************************************************************/
+
+OGRCSVParallelReader::~OGRCSVParallelReader()
+
+{
+    // Wait for the chunks still being processed.
+    m_oPool.WaitCompletion();
+
+    if( m_poCurrent != NULL )
+        m_apoFree.push_back(m_poCurrent);
+    for( size_t i = 0; i < m_apoPending.size(); i++ )
+        m_apoFree.push_back(m_apoPending[i]);
+    for( size_t i = 0; i < m_apoFree.size(); i++ )
+    {
+        ClearResults(m_apoFree[i]);
+        delete m_apoFree[i];
+    }
+
+    if( m_hCond != NULL )
+        CPLDestroyCond(m_hCond);
+    if( m_hMutex != NULL )
+        CPLDestroyMutex(m_hMutex);
+}
+
+/************************************************************************/
+/*                        SetFieldTypesOptions()                        */
+/************************************************************************/
+
+void OGRCSVParallelReader::SetFieldTypesOptions(
+    int nFieldCount, bool bKeepQuotes, bool bAutodetectWidth,
+    bool bAutodetectWidthForIntOrReal )
+{
+    m_nFieldCount = nFieldCount;
+    m_bKeepQuotes = bKeepQuotes;
+    m_bAutodetectWidth = bAutodetectWidth;
+    m_bAutodetectWidthForIntOrReal = bAutodetectWidthForIntOrReal;
+}
+
+/************************************************************************/
+/*                                Init()                                */
+/************************************************************************/
+
+bool OGRCSVParallelReader::Init()
+
+{
+    if( m_eMode == RECORD_COUNT )
+        return true;
+
+    if( !m_oPool.Setup(m_nThreads, NULL, NULL) )
+        return false;
+    m_hCond = CPLCreateCond();
+    m_hMutex = CPLCreateMutex();
+    if( m_hMutex != NULL )
+        CPLReleaseMutex(m_hMutex);
+    return m_hCond != NULL && m_hMutex != NULL;
+}
+
+/************************************************************************/
+/*                              ReadMore()                              */
+/*                                                                      */
+/*      Append the next bytes of the file to the split buffer.          */
+/************************************************************************/
+
+bool OGRCSVParallelReader::ReadMore()
+
+{
+    size_t nToRead = m_nChunkSize;
+    const vsi_l_offset nFileOffset = m_nBufferOffset + m_abyBuffer.size();
+    if( m_nMaxOffset != 0 &&
+        m_nMaxOffset - nFileOffset < static_cast<vsi_l_offset>(nToRead) )
+    {
+        nToRead = static_cast<size_t>(m_nMaxOffset - nFileOffset);
+    }
+
+    const size_t nOldSize = m_abyBuffer.size();
+    try
+    {
+        m_abyBuffer.resize(nOldSize + nToRead);
+    }
+    catch( const std::exception & )
+    {
+        CPLError(CE_Failure, CPLE_OutOfMemory,
+                 "Cannot allocate %u bytes", static_cast<unsigned>(nToRead));
+        return false;
+    }
+    const size_t nRead =
+        nToRead == 0 ? 0 :
+        VSIFReadL(&m_abyBuffer[nOldSize], 1, nToRead, m_poLayer->fpCSV);
+    m_abyBuffer.resize(nOldSize + nRead);
+
+    if( nRead < m_nChunkSize )
+    {
+        m_bEOF = true;
+        // As in the single threaded detection, a last record that is not
+        // terminated before the limit is ignored.
+        m_bLimitReached = m_nMaxOffset != 0 && nRead == nToRead;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                             AddRecord()                              */
+/************************************************************************/
+
+void OGRCSVParallelReader::AddRecord( OGRCSVChunk *psChunk,
+                                      size_t nStart, size_t nEnd )
+{
+    // Empty lines, with just a BOM or nothing, are skipped without
+    // consuming a FID, like in GetNextLineTokens().
+    const GByte *pabyStart =
+        reinterpret_cast<const GByte *>(&m_abyBuffer[0]) + nStart;
+    if( nEnd == nStart ||
+        (nEnd - nStart == 3 && pabyStart[0] == 0xEF &&
+         pabyStart[1] == 0xBB && pabyStart[2] == 0xBF) )
+    {
+        return;
+    }
+
+    psChunk->anRecordStart.push_back(nStart);
+    psChunk->anRecordEnd.push_back(nEnd);
+
+    std::vector<vsi_l_offset> &anFeatureOffsets = m_poLayer->anFeatureOffsets;
+    if( m_eMode != FIELD_TYPES && m_nNextFID >= 1 &&
+        static_cast<size_t>(m_nNextFID) == anFeatureOffsets.size() + 1 )
+    {
+        anFeatureOffsets.push_back(m_nBufferOffset + nStart);
+    }
+    m_nNextFID++;
+}
+
+/************************************************************************/
+/*                             SplitChunk()                             */
+/*                                                                      */
+/*      Move the next complete records, about m_nChunkSize bytes, to    */
+/*      psChunk.  Records end at line endings outside quoted strings,   */
+/*      a line ending being CR, LF, CRLF or LFCR as in CPLReadLineL().  */
+/************************************************************************/
+
+bool OGRCSVParallelReader::SplitChunk( OGRCSVChunk *psChunk )
+
+{
+    psChunk->anRecordStart.clear();
+    psChunk->anRecordEnd.clear();
+    psChunk->nFirstFID = m_nNextFID;
+
+    while( true )
+    {
+        const size_t nSize = m_abyBuffer.size();
+        while( m_nScanPos < nSize )
+        {
+            const char ch = m_abyBuffer[m_nScanPos];
+            if( ch == '"' && m_bHonourStrings )
+            {
+                m_bInString = !m_bInString;
+                m_nScanPos++;
+                continue;
+            }
+            if( ch != '\n' && ch != '\r' )
+            {
+                m_nScanPos++;
+                continue;
+            }
+
+            size_t nEOLSize = 1;
+            if( m_nScanPos + 1 < nSize )
+            {
+                const char chNext = m_abyBuffer[m_nScanPos + 1];
+                if( (ch == '\r' && chNext == '\n') ||
+                    (ch == '\n' && chNext == '\r') )
+                    nEOLSize = 2;
+            }
+            else if( !m_bEOF )
+            {
+                // The next byte is needed to know the line ending.
+                break;
+            }
+
+            if( !m_bInString )
+            {
+                AddRecord(psChunk, m_nRecordStart, m_nScanPos);
+                m_nRecordStart = m_nScanPos + nEOLSize;
+            }
+            m_nLastEOLStart = m_nScanPos;
+            m_nScanPos += nEOLSize;
+            m_nLastEOLEnd = m_nScanPos;
+        }
+
+        if( m_nRecordStart >= m_nChunkSize || m_bEOF )
+            break;
+        if( !ReadMore() )
+            return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      At end of file, the remaining bytes are a last record without   */
+/*      line ending, or whose quoted string is not closed.              */
+/* -------------------------------------------------------------------- */
+    const size_t nSize = m_abyBuffer.size();
+    if( m_bEOF && m_nRecordStart < nSize )
+    {
+        const bool bEndsWithEOL =
+            m_nLastEOLEnd == nSize && m_nLastEOLStart >= m_nRecordStart;
+        if( !m_bLimitReached || bEndsWithEOL )
+        {
+            AddRecord(psChunk, m_nRecordStart,
+                      bEndsWithEOL ? m_nLastEOLStart : nSize);
+        }
+        m_nRecordStart = nSize;
+    }
+
+    if( m_nRecordStart == 0 )
+        return false;
+
+    psChunk->nOffset = m_nBufferOffset;
+    psChunk->abyData.assign(m_abyBuffer.begin(),
+                            m_abyBuffer.begin() + m_nRecordStart);
+    m_abyBuffer.erase(m_abyBuffer.begin(),
+                      m_abyBuffer.begin() + m_nRecordStart);
+    m_nBufferOffset += m_nRecordStart;
+    m_nScanPos -= m_nRecordStart;
+    m_nLastEOLStart -= std::min(m_nLastEOLStart, m_nRecordStart);
+    m_nLastEOLEnd -= std::min(m_nLastEOLEnd, m_nRecordStart);
+    m_nRecordStart = 0;
+
+    return true;
+}
+
+/************************************************************************/
+/*                            ClearResults()                            */
+/************************************************************************/
+
+void OGRCSVParallelReader::ClearResults( OGRCSVChunk *psChunk )
+
+{
+    for( size_t i = psChunk->iNextFeature; i < psChunk->apoFeatures.size();
+         i++ )
+    {
+        delete psChunk->apoFeatures[i];
+    }
+    psChunk->apoFeatures.clear();
+    psChunk->iNextFeature = 0;
+    psChunk->osWarning.clear();
+    psChunk->iWarningFeature = -1;
+    psChunk->anCellCount.clear();
+    psChunk->abyCellType.clear();
+    psChunk->anCellWidth.clear();
+    psChunk->anCellPrecision.clear();
+}
+
+/************************************************************************/
+/*                          ProcessChunkFunc()                          */
+/************************************************************************/
+
+void OGRCSVParallelReader::ProcessChunkFunc( void *pData )
+
+{
+    OGRCSVChunk *psChunk = static_cast<OGRCSVChunk *>(pData);
+    OGRCSVParallelReader *poThis = psChunk->poReader;
+
+    poThis->ProcessChunk(psChunk);
+
+    CPLMutexHolderD(&poThis->m_hMutex);
+    psChunk->bDone = true;
+    CPLCondBroadcast(poThis->m_hCond);
+}
+
+/************************************************************************/
+/*                            ProcessChunk()                            */
+/*                                                                      */
+/*      Run in a worker thread: only reads the settings of the layer.   */
+/************************************************************************/
+
+void OGRCSVParallelReader::ProcessChunk( OGRCSVChunk *psChunk )
+
+{
+    const char chDelimiter = m_poLayer->chDelimiter;
+    const bool bTabTokenize = !m_bHonourStrings;
+
+    for( size_t iRecord = 0; iRecord < psChunk->anRecordStart.size();
+         iRecord++ )
+    {
+/* -------------------------------------------------------------------- */
+/*      Rebuild the line as returned by OGRCSVReadParseLineL(): line    */
+/*      endings within quoted strings become LF, and a leading BOM is   */
+/*      skipped.                                                        */
+/* -------------------------------------------------------------------- */
+        const char *pszStart = &psChunk->abyData[0] +
+                               psChunk->anRecordStart[iRecord];
+        const char *pszEnd = &psChunk->abyData[0] +
+                             psChunk->anRecordEnd[iRecord];
+        const GByte *pabyStart = reinterpret_cast<const GByte *>(pszStart);
+        if( pszEnd - pszStart >= 3 && pabyStart[0] == 0xEF &&
+            pabyStart[1] == 0xBB && pabyStart[2] == 0xBF )
+        {
+            pszStart += 3;
+        }
+
+        std::vector<char> &abyLine = psChunk->abyLine;
+        abyLine.clear();
+        for( const char *pszIter = pszStart; pszIter < pszEnd; ++pszIter )
+        {
+            const char ch = *pszIter;
+            if( ch == '\r' || ch == '\n' )
+            {
+                if( pszIter + 1 < pszEnd &&
+                    pszIter[1] == (ch == '\r' ? '\n' : '\r') )
+                    ++pszIter;
+                abyLine.push_back('\n');
+            }
+            else
+            {
+                abyLine.push_back(ch);
+            }
+        }
+        abyLine.push_back('\0');
 
-            if( !abFieldBoolean[iField] )
+/* -------------------------------------------------------------------- */
+/*      Tokenize it.                                                    */
+/* -------------------------------------------------------------------- */
+        if( bTabTokenize )
+        {
+            char **papszTokens =
+                CSLTokenizeStringComplex(&abyLine[0], "\t", FALSE, TRUE);
+            psChunk->abyTokens.clear();
+            psChunk->anTokenOffsets.clear();
+            for( char **papszIter = papszTokens; papszIter && *papszIter;
+                 ++papszIter )
             {
-                if( anFieldWidth[iField] > 0 &&
-                    (aeFieldType[iField] == OFTString ||
-                    (bAutodetectWidthForIntOrReal &&
-                     (aeFieldType[iField] == OFTInteger ||
-                      aeFieldType[iField] == OFTInteger64))) )
-                {
-                    osFieldType += CPLSPrintf(" (%d)", anFieldWidth[iField]);
-                }
-                else if( anFieldWidth[iField] > 0 &&
-                         bAutodetectWidthForIntOrReal &&
-                         aeFieldType[iField] == OFTReal )
+                psChunk->anTokenOffsets.push_back(psChunk->abyTokens.size());
+                psChunk->abyTokens.insert(psChunk->abyTokens.end(),
+                                          *papszIter,
+                                          *papszIter + strlen(*papszIter) + 1);
+            }
+            CSLDestroy(papszTokens);
+        }
+        else
+        {
+            CSVSplitLineToBuffer(&abyLine[0], chDelimiter,
+                                 m_eMode == FIELD_TYPES && m_bKeepQuotes,
+                                 m_poLayer->bMergeDelimiter,
+                                 psChunk->abyTokens, psChunk->anTokenOffsets);
+        }
+
+        const int nTokenCount =
+            static_cast<int>(psChunk->anTokenOffsets.size());
+        std::vector<char *> &apszTokens = psChunk->apszTokens;
+        apszTokens.resize(nTokenCount + 1);
+        for( int i = 0; i < nTokenCount; i++ )
+            apszTokens[i] = &psChunk->abyTokens[psChunk->anTokenOffsets[i]];
+        apszTokens[nTokenCount] = NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Translate it.                                                   */
+/* -------------------------------------------------------------------- */
+        if( m_eMode == FEATURES )
+        {
+            const int nFID = psChunk->nFirstFID + static_cast<int>(iRecord);
+            const bool bHadWarning = !psChunk->osWarning.empty();
+            OGRFeature *poFeature = m_poLayer->TranslateTokens(
+                &apszTokens[0], nTokenCount, nFID, &psChunk->osWarning);
+            poFeature->SetFID(nFID);
+            if( !bHadWarning && !psChunk->osWarning.empty() )
+                psChunk->iWarningFeature = static_cast<int>(iRecord);
+            psChunk->apoFeatures.push_back(poFeature);
+        }
+        else
+        {
+            const int nCellCount = std::min(nTokenCount, m_nFieldCount);
+            psChunk->anCellCount.push_back(nCellCount);
+            for( int iField = 0; iField < nCellCount; iField++ )
+            {
+                int nFieldWidth = 0;
+                int nFieldPrecision = 0;
+                psChunk->abyCellType.push_back(OGRCSVGuessValueType(
+                    apszTokens[iField], chDelimiter, false,
+                    m_bAutodetectWidth, m_bAutodetectWidthForIntOrReal,
+                    &nFieldWidth, &nFieldPrecision));
+                if( m_bAutodetectWidth )
                 {
-                    osFieldType += CPLSPrintf(" (%d.%d)", anFieldWidth[iField],
-                                              anFieldPrecision[iField]);
+                    psChunk->anCellWidth.push_back(nFieldWidth);
+                    psChunk->anCellPrecision.push_back(nFieldPrecision);
                 }
             }
+        }
+    }
+}
 
-            papszFieldTypes[iField] = CPLStrdup(osFieldType);
+/************************************************************************/
+/*                            GetNextChunk()                            */
+/************************************************************************/
+
+OGRCSVChunk *OGRCSVParallelReader::GetNextChunk()
+
+{
+    // Keep up to two chunks per thread queued, so that workers do not
+    // starve while the caller consumes the results.
+    const size_t nMaxPending = static_cast<size_t>(2 * m_nThreads);
+    while( !m_bSplitDone && m_apoPending.size() < nMaxPending )
+    {
+        OGRCSVChunk *psChunk = NULL;
+        if( m_apoFree.empty() )
+        {
+            psChunk = new OGRCSVChunk();
+            psChunk->poReader = this;
+        }
+        else
+        {
+            psChunk = m_apoFree.back();
+            m_apoFree.pop_back();
         }
 
-        VSIFCloseL(fpMem);
-        VSIUnlink(osTmpMemFile);
+        if( !SplitChunk(psChunk) )
+        {
+            m_apoFree.push_back(psChunk);
+            m_bSplitDone = true;
+            break;
+        }
+
+        m_apoPending.push_back(psChunk);
+        if( m_eMode == RECORD_COUNT )
+        {
+            psChunk->bDone = true;
+        }
+        else
+        {
+            psChunk->bDone = false;
+            m_oPool.SubmitJob(ProcessChunkFunc, psChunk);
+        }
     }
-    VSIFree(pszData);
 
-    ResetReading();
+    if( m_apoPending.empty() )
+        return NULL;
 
-    return papszFieldTypes;
+    OGRCSVChunk *psChunk = m_apoPending.front();
+    m_apoPending.pop_front();
+    if( m_eMode != RECORD_COUNT )
+    {
+        CPLMutexHolderD(&m_hMutex);
+        while( !psChunk->bDone )
+            CPLCondWait(m_hCond, m_hMutex);
+    }
+    return psChunk;
+}
+
+/************************************************************************/
+/*                            ReleaseChunk()                            */
+/************************************************************************/
+
+void OGRCSVParallelReader::ReleaseChunk( OGRCSVChunk *psChunk )
+
+{
+    ClearResults(psChunk);
+    m_apoFree.push_back(psChunk);
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature *OGRCSVParallelReader::GetNextFeature()
+
+{
+    while( true )
+    {
+        if( m_poCurrent != NULL &&
+            m_poCurrent->iNextFeature < m_poCurrent->apoFeatures.size() )
+        {
+            const size_t i = m_poCurrent->iNextFeature++;
+            if( static_cast<int>(i) == m_poCurrent->iWarningFeature &&
+                !m_poLayer->bWarningBadTypeOrWidth )
+            {
+                m_poLayer->bWarningBadTypeOrWidth = true;
+                CPLError(CE_Warning, CPLE_AppDefined, "%s",
+                         m_poCurrent->osWarning.c_str());
+            }
+            OGRFeature *poFeature = m_poCurrent->apoFeatures[i];
+            m_poCurrent->apoFeatures[i] = NULL;
+            return poFeature;
+        }
+
+        if( m_poCurrent != NULL )
+            ReleaseChunk(m_poCurrent);
+        m_poCurrent = GetNextChunk();
+        if( m_poCurrent == NULL )
+            return NULL;
+    }
+}
+
+/************************************************************************/
+/*                           CountRecords()                             */
+/************************************************************************/
+
+GIntBig OGRCSVParallelReader::CountRecords()
+
+{
+    GIntBig nCount = 0;
+    OGRCSVChunk *psChunk = NULL;
+    while( (psChunk = GetNextChunk()) != NULL )
+    {
+        nCount += static_cast<GIntBig>(psChunk->anRecordStart.size());
+        ReleaseChunk(psChunk);
+    }
+    return nCount;
 }
 
 /************************************************************************/
@@ -1324,7 +2120,10 @@ OGRCSVLayer::~OGRCSVLayer()
     if( bNew && bInWriteMode )
         WriteHeader();
 
+    StopParallelRead();
+
     CPLFree(panGeomFieldIndex);
+    CPLFree(panMatchingFIDs);
 
     poFeatureDefn->Release();
     CPLFree(pszFilename);
@@ -1340,6 +2139,26 @@ OGRCSVLayer::~OGRCSVLayer()
 void OGRCSVLayer::ResetReading()
 
 {
+    Rewind();
+
+    CPLFree(panMatchingFIDs);
+    panMatchingFIDs = NULL;
+    iMatchingFID = 0;
+    bMatchingFIDsScanned = false;
+}
+
+/************************************************************************/
+/*                               Rewind()                               */
+/*                                                                      */
+/*      Move the file position to the first record.                     */
+/************************************************************************/
+
+void OGRCSVLayer::Rewind()
+
+{
+    StopParallelRead();
+    bParallelReadSuspended = false;
+
     if( fpCSV )
         VSIRewindL(fpCSV);
 
@@ -1352,12 +2171,48 @@ void OGRCSVLayer::ResetReading()
     nNextFID = 1;
 }
 
+/************************************************************************/
+/*                          StopParallelRead()                          */
+/*                                                                      */
+/*      Stop the parallel reader, leaving the file positioned on the    */
+/*      record of nNextFID so that serial reading can go on.            */
+/************************************************************************/
+
+void OGRCSVLayer::StopParallelRead()
+
+{
+    if( poParallelReader == NULL )
+        return;
+
+    if( nNextFID >= 1 &&
+        static_cast<size_t>(nNextFID) <= anFeatureOffsets.size() )
+    {
+        VSIFSeekL(fpCSV, anFeatureOffsets[static_cast<size_t>(nNextFID - 1)],
+                  SEEK_SET);
+    }
+    else
+    {
+        VSIFSeekL(fpCSV, poParallelReader->GetSplitOffset(), SEEK_SET);
+    }
+
+    delete poParallelReader;
+    poParallelReader = NULL;
+}
+
 /************************************************************************/
 /*                        GetNextLineTokens()                           */
 /************************************************************************/
 
 char **OGRCSVLayer::GetNextLineTokens()
 {
+    // Remember where each record starts, so that GetFeature() can seek
+    // straight to it later.
+    const bool bRecordOffset =
+        nNextFID >= 1 &&
+        static_cast<size_t>(nNextFID) == anFeatureOffsets.size() + 1;
+    if( bRecordOffset )
+        anFeatureOffsets.push_back(VSIFTellL(fpCSV));
+
     while( true )
     {
         // Read the CSV record.
@@ -1365,7 +2220,11 @@ char **OGRCSVLayer::GetNextLineTokens()
             fpCSV, chDelimiter, bDontHonourStrings, false, bMergeDelimiter);
 
         if( papszTokens == NULL )
+        {
+            if( bRecordOffset )
+                anFeatureOffsets.pop_back();
             return NULL;
+        }
 
         if( papszTokens[0] != NULL )
             return papszTokens;
@@ -1382,8 +2241,22 @@ OGRFeature *OGRCSVLayer::GetFeature(GIntBig nFID)
 {
     if( nFID < 1 || fpCSV == NULL )
         return NULL;
+
+    // Random access goes on serially until the next rewind.
+    StopParallelRead();
+    bParallelReadSuspended = true;
+    if( nFID <= static_cast<GIntBig>(anFeatureOffsets.size()) &&
+        (nFID != nNextFID || bNeedRewindBeforeRead) )
+    {
+        if( VSIFSeekL(fpCSV, anFeatureOffsets[static_cast<size_t>(nFID - 1)],
+                      SEEK_SET) != 0 )
+            return NULL;
+        bNeedRewindBeforeRead = false;
+        nNextFID = static_cast<int>(nFID);
+        return GetNextUnfilteredFeature();
+    }
     if( nFID < nNextFID || bNeedRewindBeforeRead )
-        ResetReading();
+        Rewind();
     while( nNextFID < nFID )
     {
         char **papszTokens = GetNextLineTokens();
@@ -1396,19 +2269,33 @@ OGRFeature *OGRCSVLayer::GetFeature(GIntBig nFID)
 }
 
 /************************************************************************/
-/*                      GetNextUnfilteredFeature()                      */
+/*                          TranslateTokens()                           */
+/*                                                                      */
+/*      Build the feature of a record from its fields.  When            */
+/*      posWarning is not NULL, as in worker threads, the first         */
+/*      warning about an invalid value is stored there instead of       */
+/*      being emitted, and the layer is left untouched.                 */
 /************************************************************************/
 
-OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
+OGRFeature *OGRCSVLayer::TranslateTokens( char **papszTokens, int nTokenCount,
+                                          int nFID, CPLString *posWarning )
 
 {
-    if( fpCSV == NULL )
-        return NULL;
-
-    // Read the CSV record.
-    char **papszTokens = GetNextLineTokens();
-    if( papszTokens == NULL )
-        return NULL;
+    bool bWarned = posWarning != NULL ? !posWarning->empty()
+                                      : bWarningBadTypeOrWidth;
+    const auto Warn = [&](const char *pszMsg)
+    {
+        bWarned = true;
+        if( posWarning != NULL )
+        {
+            *posWarning = pszMsg;
+        }
+        else
+        {
+            bWarningBadTypeOrWidth = true;
+            CPLError(CE_Warning, CPLE_AppDefined, "%s", pszMsg);
+        }
+    };
 
     // Create the OGR feature.
     OGRFeature *poFeature = new OGRFeature(poFeatureDefn);
@@ -1416,7 +2303,7 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
     // Set attributes for any indicated attribute records.
     int iOGRField = 0;
     const int nAttrCount = std::min(
-        CSLCount(papszTokens), nCSVFieldCount + (bHiddenWKTColumn ? 1 : 0));
+        nTokenCount, nCSVFieldCount + (bHiddenWKTColumn ? 1 : 0));
     CPLValueType eType;
 
     for( int iAttr = 0; !bIsEurostatTSV && iAttr < nAttrCount; iAttr++ )
@@ -1494,14 +2381,12 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
                 {
                     poFeature->SetField(iOGRField, 0);
                 }
-                else if( !bWarningBadTypeOrWidth )
+                else if( !bWarned )
                 {
-                    bWarningBadTypeOrWidth = true;
-                    CPLError(
-                        CE_Warning, CPLE_AppDefined,
+                    Warn(CPLSPrintf(
                         "Invalid value type found in record %d for field %s. "
                         "This warning will no longer be emitted",
-                        nNextFID, poFieldDefn->GetNameRef());
+                        nFID, poFieldDefn->GetNameRef()));
                 }
             }
         }
@@ -1520,31 +2405,29 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
                 if( eType == CPL_VALUE_INTEGER || eType == CPL_VALUE_REAL )
                 {
                     poFeature->SetField(iOGRField, papszTokens[iAttr]);
-                    if( !bWarningBadTypeOrWidth &&
+                    if( !bWarned &&
                         (eFieldType == OFTInteger ||
                          eFieldType == OFTInteger64) &&
                         eType == CPL_VALUE_REAL )
                     {
-                        bWarningBadTypeOrWidth = true;
-                        CPLError(CE_Warning, CPLE_AppDefined,
-                                 "Invalid value type found in record %d for "
-                                 "field %s. "
-                                 "This warning will no longer be emitted",
-                                 nNextFID, poFieldDefn->GetNameRef());
+                        Warn(CPLSPrintf(
+                            "Invalid value type found in record %d for "
+                            "field %s. "
+                            "This warning will no longer be emitted",
+                            nFID, poFieldDefn->GetNameRef()));
                     }
-                    else if( !bWarningBadTypeOrWidth &&
+                    else if( !bWarned &&
                              poFieldDefn->GetWidth() > 0 &&
                              static_cast<int>(strlen(papszTokens[iAttr])) >
                                  poFieldDefn->GetWidth() )
                     {
-                        bWarningBadTypeOrWidth = true;
-                        CPLError(CE_Warning, CPLE_AppDefined,
-                                 "Value with a width greater than field width "
-                                 "found in record %d for field %s. "
-                                 "This warning will no longer be emitted",
-                                 nNextFID, poFieldDefn->GetNameRef());
+                        Warn(CPLSPrintf(
+                            "Value with a width greater than field width "
+                            "found in record %d for field %s. "
+                            "This warning will no longer be emitted",
+                            nFID, poFieldDefn->GetNameRef()));
                     }
-                    else if( !bWarningBadTypeOrWidth &&
+                    else if( !bWarned &&
                              eType == CPL_VALUE_REAL &&
                              poFieldDefn->GetWidth() > 0)
                     {
@@ -1555,26 +2438,23 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
                                 : 0;
                         if( nPrecision > poFieldDefn->GetPrecision() )
                         {
-                            bWarningBadTypeOrWidth = true;
-                            CPLError(CE_Warning, CPLE_AppDefined,
-                                     "Value with a precision greater than "
-                                     "field precision found in record %d for "
-                                     "field %s. "
-                                     "This warning will no longer be emitted",
-                                     nNextFID, poFieldDefn->GetNameRef());
+                            Warn(CPLSPrintf(
+                                "Value with a precision greater than "
+                                "field precision found in record %d for "
+                                "field %s. "
+                                "This warning will no longer be emitted",
+                                nFID, poFieldDefn->GetNameRef()));
                         }
                     }
                 }
                 else
                 {
-                    if( !bWarningBadTypeOrWidth )
+                    if( !bWarned )
                     {
-                        bWarningBadTypeOrWidth = true;
-                        CPLError(
-                            CE_Warning, CPLE_AppDefined,
+                        Warn(CPLSPrintf(
                             "Invalid value type found in record %d for field "
                             "%s. This warning will no longer be emitted.",
-                            nNextFID, poFieldDefn->GetNameRef());
+                            nFID, poFieldDefn->GetNameRef()));
                     }
                 }
             }
@@ -1584,15 +2464,13 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
             if( papszTokens[iAttr][0] != '\0' && !poFieldDefn->IsIgnored() )
             {
                 poFeature->SetField(iOGRField, papszTokens[iAttr]);
-                if( !bWarningBadTypeOrWidth &&
+                if( !bWarned &&
                     !poFeature->IsFieldSetAndNotNull(iOGRField) )
                 {
-                    bWarningBadTypeOrWidth = true;
-                    CPLError(
-                        CE_Warning, CPLE_AppDefined,
+                    Warn(CPLSPrintf(
                         "Invalid value type found in record %d for field %s. "
                         "This warning will no longer be emitted",
-                        nNextFID, poFieldDefn->GetNameRef());
+                        nFID, poFieldDefn->GetNameRef()));
                 }
             }
         }
@@ -1605,16 +2483,15 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
             else
             {
                 poFeature->SetField(iOGRField, papszTokens[iAttr]);
-                if( !bWarningBadTypeOrWidth && poFieldDefn->GetWidth() > 0 &&
+                if( !bWarned && poFieldDefn->GetWidth() > 0 &&
                     static_cast<int>(strlen(papszTokens[iAttr])) >
                         poFieldDefn->GetWidth() )
                 {
-                    bWarningBadTypeOrWidth = true;
-                    CPLError(CE_Warning, CPLE_AppDefined,
-                             "Value with a width greater than field width "
-                             "found in record %d for field %s. "
-                             "This warning will no longer be emitted",
-                             nNextFID, poFieldDefn->GetNameRef());
+                    Warn(CPLSPrintf(
+                        "Value with a width greater than field width "
+                        "found in record %d for field %s. "
+                        "This warning will no longer be emitted",
+                        nFID, poFieldDefn->GetNameRef()));
                 }
             }
         }
@@ -1723,6 +2600,49 @@ OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
         }
     }
 
+    return poFeature;
+}
+
+/************************************************************************/
+/*                      GetNextUnfilteredFeature()                      */
+/************************************************************************/
+
+OGRFeature *OGRCSVLayer::GetNextUnfilteredFeature()
+
+{
+    if( fpCSV == NULL )
+        return NULL;
+
+    if( nNumThreads > 1 && !bInWriteMode && !bParallelReadSuspended )
+    {
+        if( poParallelReader == NULL )
+        {
+            poParallelReader = new OGRCSVParallelReader(
+                this, OGRCSVParallelReader::FEATURES, nNumThreads);
+            if( !poParallelReader->Init() )
+            {
+                StopParallelRead();
+                bParallelReadSuspended = true;
+                return GetNextUnfilteredFeature();
+            }
+        }
+        OGRFeature *poFeature = poParallelReader->GetNextFeature();
+        if( poFeature != NULL )
+        {
+            nNextFID = static_cast<int>(poFeature->GetFID()) + 1;
+            m_nFeaturesRead++;
+        }
+        return poFeature;
+    }
+
+    // Read the CSV record.
+    char **papszTokens = GetNextLineTokens();
+    if( papszTokens == NULL )
+        return NULL;
+
+    OGRFeature *poFeature =
+        TranslateTokens(papszTokens, CSLCount(papszTokens), nNextFID, NULL);
+
     CSLDestroy(papszTokens);
 
     // Translate the record id.
@@ -1743,13 +2663,34 @@ OGRFeature *OGRCSVLayer::GetNextFeature()
     if( bNeedRewindBeforeRead )
         ResetReading();
 
+    // On the first request of a pass, try to resolve the attribute
+    // filter with indexes, to only read the matching records.
+    if( m_poAttrQuery != NULL && !bMatchingFIDsScanned )
+    {
+        bMatchingFIDsScanned = true;
+        iMatchingFID = 0;
+        panMatchingFIDs = m_poAttrQuery->EvaluateAgainstIndices(this, NULL);
+    }
+
     // Read features till we find one that satisfies our current
     // spatial criteria.
     while( true )
     {
-        OGRFeature *poFeature = GetNextUnfilteredFeature();
-        if( poFeature == NULL )
-            return NULL;
+        OGRFeature *poFeature = NULL;
+        if( panMatchingFIDs != NULL )
+        {
+            if( panMatchingFIDs[iMatchingFID] == OGRNullFID )
+                return NULL;
+            poFeature = GetFeature(panMatchingFIDs[iMatchingFID++]);
+            if( poFeature == NULL )
+                continue;
+        }
+        else
+        {
+            poFeature = GetNextUnfilteredFeature();
+            if( poFeature == NULL )
+                return NULL;
+        }
 
         if( (m_poFilterGeom == NULL ||
              FilterGeometry(poFeature->GetGeomFieldRef(m_iGeomFieldFilter))) &&
@@ -1760,6 +2701,149 @@ OGRFeature *OGRCSVLayer::GetNextFeature()
     }
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/*                                                                      */
+/*      For plain attribute-only CSV files, fill the batch straight     */
+/*      from the line tokens.  Files with geometry, Eurostat TSV or     */
+/*      other special layouts go through the generic implementation.    */
+/************************************************************************/
+
+int OGRCSVLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                      int nMaxFeatures )
+
+{
+    bool bNative =
+        nNumThreads <= 1 &&
+        m_poAttrQuery == NULL && m_poFilterGeom == NULL &&
+        !bIsEurostatTSV && !bKeepSourceColumns && !bHiddenWKTColumn &&
+        poFeatureDefn->GetGeomFieldCount() == 0 &&
+        poFeatureDefn->GetFieldCount() == nCSVFieldCount;
+    for( int iField = 0;
+         bNative && iField < poFeatureDefn->GetFieldCount(); iField++ )
+    {
+        switch( poFeatureDefn->GetFieldDefn(iField)->GetType() )
+        {
+            case OFTInteger:
+            case OFTInteger64:
+            case OFTReal:
+            case OFTString:
+            case OFTDate:
+            case OFTTime:
+            case OFTDateTime:
+                break;
+            default:
+                bNative = false;
+                break;
+        }
+    }
+    if( !bNative )
+        return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+
+    poBatch->Reset(poFeatureDefn);
+
+    if( bNeedRewindBeforeRead )
+        ResetReading();
+
+    while( fpCSV != NULL && poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        char **papszTokens = GetNextLineTokens();
+        if( papszTokens == NULL )
+            break;
+
+        poBatch->AddFeature(nNextFID);
+
+        const int nAttrCount = std::min(CSLCount(papszTokens), nCSVFieldCount);
+        for( int iField = 0; iField < nAttrCount; iField++ )
+        {
+            OGRFieldDefn *poFieldDefn = poFeatureDefn->GetFieldDefn(iField);
+            if( poFieldDefn->IsIgnored() )
+                continue;
+            char *pszToken = papszTokens[iField];
+            const OGRFieldType eFieldType = poFieldDefn->GetType();
+
+            if( eFieldType == OFTString )
+            {
+                if( !(bEmptyStringNull && pszToken[0] == '\0') )
+                    poBatch->SetFieldString(iField, pszToken);
+                continue;
+            }
+            if( pszToken[0] == '\0' )
+                continue;
+
+            bool bValid = true;
+            if( eFieldType == OFTInteger &&
+                poFieldDefn->GetSubType() == OFSTBoolean )
+            {
+                if( OGRCSVIsTrue(pszToken) || strcmp(pszToken, "1") == 0 )
+                    poBatch->SetFieldInteger(iField, 1);
+                else if( OGRCSVIsFalse(pszToken) || strcmp(pszToken, "0") == 0 )
+                    poBatch->SetFieldInteger(iField, 0);
+                else
+                    bValid = false;
+            }
+            else if( eFieldType == OFTInteger || eFieldType == OFTInteger64 ||
+                     eFieldType == OFTReal )
+            {
+                if( chDelimiter == ';' && eFieldType == OFTReal )
+                {
+                    char *chComma = strchr(pszToken, ',');
+                    if( chComma )
+                        *chComma = '.';
+                }
+                const CPLValueType eType = CPLGetValueType(pszToken);
+                if( eType == CPL_VALUE_INTEGER || eType == CPL_VALUE_REAL )
+                {
+                    if( eFieldType == OFTReal )
+                    {
+                        poBatch->SetFieldDouble(iField, CPLAtof(pszToken));
+                    }
+                    else
+                    {
+                        const GIntBig nVal = CPLAtoGIntBig(pszToken);
+                        if( eFieldType == OFTInteger64 )
+                            poBatch->SetFieldInteger64(iField, nVal);
+                        else
+                            poBatch->SetFieldInteger(iField,
+                                nVal < INT_MIN ? INT_MIN :
+                                nVal > INT_MAX ? INT_MAX :
+                                static_cast<int>(nVal));
+                        bValid = eType == CPL_VALUE_INTEGER;
+                    }
+                }
+                else
+                {
+                    bValid = false;
+                }
+            }
+            else
+            {
+                OGRField sField;
+                if( OGRParseDate(pszToken, &sField, 0) )
+                    poBatch->SetFieldRaw(iField, &sField);
+                else
+                    bValid = false;
+            }
+
+            if( !bValid && !bWarningBadTypeOrWidth )
+            {
+                bWarningBadTypeOrWidth = true;
+                CPLError(
+                    CE_Warning, CPLE_AppDefined,
+                    "Invalid value type found in record %d for field %s. "
+                    "This warning will no longer be emitted",
+                    nNextFID, poFieldDefn->GetNameRef());
+            }
+        }
+
+        CSLDestroy(papszTokens);
+        nNextFID++;
+        m_nFeaturesRead++;
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                           TestCapability()                           */
 /************************************************************************/
@@ -2456,7 +3540,8 @@ GIntBig OGRCSVLayer::GetFeatureCount( int bForce )
     if( m_poFilterGeom != NULL || m_poAttrQuery != NULL )
     {
         GIntBig nRet = OGRLayer::GetFeatureCount(bForce);
-        if( nRet >= 0 )
+        // Only a full sequential read leaves nNextFID after the last record.
+        if( nRet >= 0 && panMatchingFIDs == NULL )
         {
             nTotalFeatures = nNextFID - 1;
         }
@@ -2502,6 +3587,13 @@ GIntBig OGRCSVLayer::GetFeatureCount( int bForce )
                 break;
         }
     }
+    else if( nNumThreads > 1 )
+    {
+        // Only the record boundaries are needed: no worker thread.
+        OGRCSVParallelReader oReader(this, OGRCSVParallelReader::RECORD_COUNT,
+                                     nNumThreads);
+        nTotalFeatures = oReader.Init() ? oReader.CountRecords() : 0;
+    }
     else
     {
         nTotalFeatures = 0;
@@ -77,4 +77,24 @@ OGRAttrIndex::OGRAttrIndex() {}
 
 OGRAttrIndex::~OGRAttrIndex() {}
 
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/*                                                                      */
+/*      Return the sorted "OGRNullFID" terminated list of the FIDs      */
+/*      whose key is between the given bounds, a NULL bound meaning     */
+/*      unbounded.  Indexes that cannot answer range queries return     */
+/*      NULL.                                                           */
+/************************************************************************/
+
+GIntBig *OGRAttrIndex::GetRangeMatches( OGRField * /* psMin */,
+                                        bool /* bMinIncluded */,
+                                        OGRField * /* psMax */,
+                                        bool /* bMaxIncluded */,
+                                        int *pnFIDCount )
+
+{
+    *pnFIDCount = 0;
+    return NULL;
+}
+
 //! @endcond
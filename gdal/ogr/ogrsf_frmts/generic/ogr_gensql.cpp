@@ -34,6 +34,8 @@
 #include "ogr_api.h"
 #include "cpl_time.h"
 #include <algorithm>
+#include <map>
+#include <utility>
 #include <vector>
 
 //! @cond Doxygen_Suppress
@@ -53,6 +55,244 @@ class OGRGenSQLGeomFieldDefn: public OGRGeomFieldDefn
         int bForceGeomType;
 };
 
+/************************************************************************/
+/*                    OGRGenSQLEstimateFeatureSize()                    */
+/*                                                                      */
+/*      Rough estimate of the memory used by a feature, used to bound   */
+/*      the memory of join lookup tables and ORDER BY sorting.          */
+/************************************************************************/
+
+static GIntBig OGRGenSQLEstimateFeatureSize( OGRFeature* poFeature )
+{
+    GIntBig nSize = static_cast<GIntBig>(sizeof(OGRFeature)) +
+        poFeature->GetFieldCount() * static_cast<GIntBig>(sizeof(OGRField));
+    for( int i = 0; i < poFeature->GetFieldCount(); i++ )
+    {
+        if( poFeature->GetFieldDefnRef(i)->GetType() == OFTString &&
+            poFeature->IsFieldSetAndNotNull(i) )
+        {
+            nSize += strlen(poFeature->GetFieldAsString(i)) + 1;
+        }
+    }
+    for( int i = 0; i < poFeature->GetGeomFieldCount(); i++ )
+    {
+        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(i);
+        if( poGeom != NULL )
+            nSize += poGeom->WkbSize();
+    }
+    return nSize;
+}
+
+/************************************************************************/
+/*                        OGRGenSQLJoinHashTable                        */
+/*                                                                      */
+/*      Lookup table of the features of a secondary layer, keyed by     */
+/*      the value of the field used in an equality join.  It is built   */
+/*      with a single scan of the layer, instead of installing an       */
+/*      attribute filter and rescanning the layer for each primary      */
+/*      feature.  When the features do not fit within                   */
+/*      OGR_GENSQL_JOIN_MAX_MEMORY bytes, only their FIDs are kept and  */
+/*      the features are fetched back with GetFeature(), provided the   */
+/*      layer supports random reading.                                  */
+/************************************************************************/
+
+typedef enum
+{
+    JOIN_KEY_INTEGER,
+    JOIN_KEY_REAL,
+    JOIN_KEY_STRING
+} OGRGenSQLJoinKeyType;
+
+class OGRGenSQLJoinHashTable
+{
+        typedef std::map<CPLString, std::pair<GIntBig, OGRFeature*> > KeyMap;
+
+        OGRLayer            *m_poLayer;
+        int                  m_iPrimaryField;
+        int                  m_iSecondaryField;
+        OGRGenSQLJoinKeyType m_eKeyType;
+        bool                 m_bFIDOnly;
+        KeyMap               m_oMap;
+
+        void                 Clear();
+
+        CPL_DISALLOW_COPY_ASSIGN(OGRGenSQLJoinHashTable)
+
+    public:
+                             OGRGenSQLJoinHashTable( OGRLayer* poLayer,
+                                                     int iPrimaryField,
+                                                     int iSecondaryField,
+                                                     OGRGenSQLJoinKeyType eKeyType );
+                            ~OGRGenSQLJoinHashTable();
+
+        bool                 Build();
+        OGRFeature          *Lookup( OGRFeature* poSrcFeat );
+
+        static bool          GetKey( OGRFeature* poFeature, int iField,
+                                     OGRGenSQLJoinKeyType eKeyType,
+                                     CPLString& osKey );
+};
+
+OGRGenSQLJoinHashTable::OGRGenSQLJoinHashTable( OGRLayer* poLayer,
+                                                int iPrimaryField,
+                                                int iSecondaryField,
+                                                OGRGenSQLJoinKeyType eKeyType ) :
+    m_poLayer(poLayer),
+    m_iPrimaryField(iPrimaryField),
+    m_iSecondaryField(iSecondaryField),
+    m_eKeyType(eKeyType),
+    m_bFIDOnly(false)
+{}
+
+OGRGenSQLJoinHashTable::~OGRGenSQLJoinHashTable()
+{
+    Clear();
+}
+
+void OGRGenSQLJoinHashTable::Clear()
+{
+    for( KeyMap::iterator oIter = m_oMap.begin();
+         oIter != m_oMap.end(); ++oIter )
+    {
+        delete oIter->second.second;
+    }
+    m_oMap.clear();
+}
+
+/************************************************************************/
+/*                               GetKey()                               */
+/*                                                                      */
+/*      Strings are compared case insensitively by OGR SQL, so they     */
+/*      are upper-cased.                                                */
+/************************************************************************/
+
+bool OGRGenSQLJoinHashTable::GetKey( OGRFeature* poFeature, int iField,
+                                     OGRGenSQLJoinKeyType eKeyType,
+                                     CPLString& osKey )
+{
+    if( !poFeature->IsFieldSetAndNotNull(iField) )
+        return false;
+
+    switch( eKeyType )
+    {
+        case JOIN_KEY_INTEGER:
+            osKey.Printf(CPL_FRMT_GIB, poFeature->GetFieldAsInteger64(iField));
+            break;
+
+        case JOIN_KEY_REAL:
+            osKey.Printf("%.17g", poFeature->GetFieldAsDouble(iField));
+            break;
+
+        case JOIN_KEY_STRING:
+            osKey = poFeature->GetFieldAsString(iField);
+            osKey.toupper();
+            break;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/*                                                                      */
+/*      Returns false if the table could not be built within the        */
+/*      memory limit, in which case the caller should fall back to      */
+/*      attribute filtering.                                            */
+/************************************************************************/
+
+bool OGRGenSQLJoinHashTable::Build()
+{
+    const GIntBig nMaxMemory = CPLAtoGIntBig(
+        CPLGetConfigOption("OGR_GENSQL_JOIN_MAX_MEMORY", "104857600"));
+    const bool bCanFetchByFID =
+        CPL_TO_BOOL(m_poLayer->TestCapability(OLCRandomRead));
+    // Per-entry overhead of the std::map node.
+    const GIntBig nEntryOverhead = 64;
+
+    m_poLayer->SetAttributeFilter( NULL );
+    m_poLayer->ResetReading();
+
+    GIntBig nMemory = 0;
+    OGRFeature* poFeature = NULL;
+    while( (poFeature = m_poLayer->GetNextFeature()) != NULL )
+    {
+        CPLString osKey;
+        // As with attribute filtering, the first matching feature wins.
+        if( !GetKey(poFeature, m_iSecondaryField, m_eKeyType, osKey) ||
+            m_oMap.find(osKey) != m_oMap.end() )
+        {
+            delete poFeature;
+            continue;
+        }
+
+        nMemory += nEntryOverhead + osKey.size();
+        if( !m_bFIDOnly )
+            nMemory += OGRGenSQLEstimateFeatureSize(poFeature);
+
+        if( nMemory > nMaxMemory )
+        {
+            if( m_bFIDOnly || !bCanFetchByFID ||
+                poFeature->GetFID() == OGRNullFID )
+            {
+                CPLDebug("GenSQL",
+                         "Lookup table for join on layer %s exceeds "
+                         "OGR_GENSQL_JOIN_MAX_MEMORY",
+                         m_poLayer->GetName());
+                delete poFeature;
+                Clear();
+                m_poLayer->ResetReading();
+                return false;
+            }
+
+            CPLDebug("GenSQL",
+                     "Lookup table for join on layer %s exceeds "
+                     "OGR_GENSQL_JOIN_MAX_MEMORY. Keeping only FIDs",
+                     m_poLayer->GetName());
+            m_bFIDOnly = true;
+            nMemory = 0;
+            for( KeyMap::iterator oIter = m_oMap.begin();
+                 oIter != m_oMap.end(); ++oIter )
+            {
+                delete oIter->second.second;
+                oIter->second.second = NULL;
+                nMemory += nEntryOverhead + oIter->first.size();
+            }
+            nMemory += nEntryOverhead + osKey.size();
+        }
+
+        const GIntBig nFID = poFeature->GetFID();
+        if( m_bFIDOnly )
+        {
+            delete poFeature;
+            poFeature = NULL;
+        }
+        m_oMap[osKey] = std::pair<GIntBig, OGRFeature*>(nFID, poFeature);
+    }
+
+    m_poLayer->ResetReading();
+    return true;
+}
+
+/************************************************************************/
+/*                               Lookup()                               */
+/*                                                                      */
+/*      Returns a new feature, owned by the caller, or NULL.            */
+/************************************************************************/
+
+OGRFeature* OGRGenSQLJoinHashTable::Lookup( OGRFeature* poSrcFeat )
+{
+    CPLString osKey;
+    if( !GetKey(poSrcFeat, m_iPrimaryField, m_eKeyType, osKey) )
+        return NULL;
+
+    KeyMap::iterator oIter = m_oMap.find(osKey);
+    if( oIter == m_oMap.end() )
+        return NULL;
+
+    if( m_bFIDOnly )
+        return m_poLayer->GetFeature(oIter->second.first);
+    return oIter->second.second->Clone();
+}
+
 /************************************************************************/
 /*               OGRGenSQLResultsLayerHasSpecialField()                 */
 /************************************************************************/
@@ -81,6 +321,762 @@ int OGRGenSQLResultsLayerHasSpecialField(swq_expr_node* expr,
     return FALSE;
 }
 
+/************************************************************************/
+/*                     Feature (de)serialization                        */
+/*                                                                      */
+/*      Compact binary encoding of a feature, in native byte order,     */
+/*      used to spill sorted runs to a temporary file.  Geometries are  */
+/*      stored as ISO WKB.                                              */
+/************************************************************************/
+
+template<class T> static void OGRGenSQLWrite( std::vector<GByte>& abyBuffer,
+                                              const T& nVal )
+{
+    const GByte* pabyVal = reinterpret_cast<const GByte*>(&nVal);
+    abyBuffer.insert(abyBuffer.end(), pabyVal, pabyVal + sizeof(T));
+}
+
+static void OGRGenSQLWriteBytes( std::vector<GByte>& abyBuffer,
+                                 const void* pData, int nBytes )
+{
+    OGRGenSQLWrite(abyBuffer, nBytes);
+    if( nBytes > 0 )
+    {
+        const GByte* pabyData = static_cast<const GByte*>(pData);
+        abyBuffer.insert(abyBuffer.end(), pabyData, pabyData + nBytes);
+    }
+}
+
+static void OGRGenSQLWriteString( std::vector<GByte>& abyBuffer,
+                                  const char* pszStr )
+{
+    if( pszStr == NULL )
+        OGRGenSQLWrite(abyBuffer, -1);
+    else
+        OGRGenSQLWriteBytes(abyBuffer, pszStr,
+                            static_cast<int>(strlen(pszStr)));
+}
+
+static void OGRGenSQLSerializeFeature( OGRFeature* poFeature,
+                                       std::vector<GByte>& abyBuffer )
+{
+    OGRGenSQLWrite(abyBuffer, poFeature->GetFID());
+
+    for( int iField = 0; iField < poFeature->GetFieldCount(); iField++ )
+    {
+        const OGRField* psField = poFeature->GetRawFieldRef(iField);
+        if( !poFeature->IsFieldSet(iField) )
+        {
+            abyBuffer.push_back(0);
+            continue;
+        }
+        if( poFeature->IsFieldNull(iField) )
+        {
+            abyBuffer.push_back(1);
+            continue;
+        }
+        abyBuffer.push_back(2);
+
+        switch( poFeature->GetFieldDefnRef(iField)->GetType() )
+        {
+            case OFTInteger:
+                OGRGenSQLWrite(abyBuffer, psField->Integer);
+                break;
+            case OFTInteger64:
+                OGRGenSQLWrite(abyBuffer, psField->Integer64);
+                break;
+            case OFTReal:
+                OGRGenSQLWrite(abyBuffer, psField->Real);
+                break;
+            case OFTDate:
+            case OFTTime:
+            case OFTDateTime:
+                OGRGenSQLWrite(abyBuffer, psField->Date);
+                break;
+            case OFTBinary:
+                OGRGenSQLWriteBytes(abyBuffer, psField->Binary.paData,
+                                    psField->Binary.nCount);
+                break;
+            case OFTIntegerList:
+                OGRGenSQLWriteBytes(abyBuffer, psField->IntegerList.paList,
+                    psField->IntegerList.nCount *
+                                        static_cast<int>(sizeof(int)));
+                break;
+            case OFTInteger64List:
+                OGRGenSQLWriteBytes(abyBuffer, psField->Integer64List.paList,
+                    psField->Integer64List.nCount *
+                                        static_cast<int>(sizeof(GIntBig)));
+                break;
+            case OFTRealList:
+                OGRGenSQLWriteBytes(abyBuffer, psField->RealList.paList,
+                    psField->RealList.nCount *
+                                        static_cast<int>(sizeof(double)));
+                break;
+            case OFTStringList:
+                OGRGenSQLWrite(abyBuffer, psField->StringList.nCount);
+                for( int i = 0; i < psField->StringList.nCount; i++ )
+                    OGRGenSQLWriteString(abyBuffer,
+                                         psField->StringList.paList[i]);
+                break;
+            default:
+                OGRGenSQLWriteString(abyBuffer, psField->String);
+                break;
+        }
+    }
+
+    for( int iGeom = 0; iGeom < poFeature->GetGeomFieldCount(); iGeom++ )
+    {
+        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(iGeom);
+        if( poGeom == NULL )
+        {
+            OGRGenSQLWrite(abyBuffer, 0);
+            continue;
+        }
+        const int nWkbSize = poGeom->WkbSize();
+        OGRGenSQLWrite(abyBuffer, nWkbSize);
+        const size_t nOffset = abyBuffer.size();
+        abyBuffer.resize(nOffset + nWkbSize);
+        poGeom->exportToWkb(wkbNDR, &abyBuffer[nOffset], wkbVariantIso);
+    }
+
+    OGRGenSQLWriteString(abyBuffer, poFeature->GetStyleString());
+    OGRGenSQLWriteString(abyBuffer, poFeature->GetNativeData());
+    OGRGenSQLWriteString(abyBuffer, poFeature->GetNativeMediaType());
+}
+
+/* Cursor over a serialized feature. Reads fail once past the end. */
+class OGRGenSQLReader
+{
+        const GByte *m_pabyCur;
+        const GByte *m_pabyEnd;
+
+    public:
+        OGRGenSQLReader( const GByte* pabyData, size_t nSize ) :
+            m_pabyCur(pabyData), m_pabyEnd(pabyData + nSize) {}
+
+        template<class T> bool Read( T& nVal )
+        {
+            if( static_cast<size_t>(m_pabyEnd - m_pabyCur) < sizeof(T) )
+                return false;
+            memcpy(&nVal, m_pabyCur, sizeof(T));
+            m_pabyCur += sizeof(T);
+            return true;
+        }
+
+        const GByte* ReadBytes( int nBytes )
+        {
+            if( nBytes < 0 || m_pabyEnd - m_pabyCur < nBytes )
+                return NULL;
+            const GByte* pabyRet = m_pabyCur;
+            m_pabyCur += nBytes;
+            return pabyRet;
+        }
+
+        bool ReadString( CPLString& osStr, bool& bIsNull )
+        {
+            int nLen = 0;
+            if( !Read(nLen) )
+                return false;
+            bIsNull = nLen < 0;
+            if( bIsNull )
+                return true;
+            const GByte* pabyStr = ReadBytes(nLen);
+            if( pabyStr == NULL )
+                return false;
+            osStr.assign(reinterpret_cast<const char*>(pabyStr), nLen);
+            return true;
+        }
+};
+
+static OGRFeature* OGRGenSQLDeserializeFeature( const GByte* pabyData,
+                                                size_t nSize,
+                                                OGRFeatureDefn* poDefn )
+{
+    OGRGenSQLReader oReader(pabyData, nSize);
+    OGRFeature* poFeature = new OGRFeature(poDefn);
+
+    GIntBig nFID = 0;
+    bool bOK = oReader.Read(nFID);
+    poFeature->SetFID(nFID);
+
+    CPLString osStr;
+    bool bIsNull = false;
+    for( int iField = 0; bOK && iField < poDefn->GetFieldCount(); iField++ )
+    {
+        GByte byState = 0;
+        bOK = oReader.Read(byState);
+        if( !bOK || byState == 0 )
+            continue;
+        if( byState == 1 )
+        {
+            poFeature->SetFieldNull(iField);
+            continue;
+        }
+
+        int nCount = 0;
+        const GByte* pabyVal = NULL;
+        switch( poDefn->GetFieldDefn(iField)->GetType() )
+        {
+            case OFTInteger:
+            {
+                int nVal = 0;
+                bOK = oReader.Read(nVal);
+                poFeature->SetField(iField, nVal);
+                break;
+            }
+            case OFTInteger64:
+            {
+                GIntBig nVal = 0;
+                bOK = oReader.Read(nVal);
+                poFeature->SetField(iField, nVal);
+                break;
+            }
+            case OFTReal:
+            {
+                double dfVal = 0.0;
+                bOK = oReader.Read(dfVal);
+                poFeature->SetField(iField, dfVal);
+                break;
+            }
+            case OFTDate:
+            case OFTTime:
+            case OFTDateTime:
+            {
+                OGRField sField;
+                memset(&sField, 0, sizeof(sField));
+                bOK = oReader.Read(sField.Date);
+                poFeature->SetField(iField, &sField);
+                break;
+            }
+            case OFTBinary:
+                bOK = oReader.Read(nCount) &&
+                      (pabyVal = oReader.ReadBytes(nCount)) != NULL;
+                if( bOK )
+                    poFeature->SetField(iField, nCount,
+                                        const_cast<GByte*>(pabyVal));
+                break;
+            case OFTIntegerList:
+            case OFTInteger64List:
+            case OFTRealList:
+            {
+                const OGRFieldType eType =
+                    poDefn->GetFieldDefn(iField)->GetType();
+                const int nEltSize =
+                    eType == OFTIntegerList ? static_cast<int>(sizeof(int)) :
+                    static_cast<int>(sizeof(double));
+                bOK = oReader.Read(nCount) &&
+                      (pabyVal = oReader.ReadBytes(nCount)) != NULL;
+                if( !bOK )
+                    break;
+                // Copy to ensure alignment.
+                std::vector<GByte> abyList(pabyVal, pabyVal + nCount);
+                abyList.resize(abyList.size() + 1);
+                if( eType == OFTIntegerList )
+                    poFeature->SetField(iField, nCount / nEltSize,
+                        reinterpret_cast<int*>(&abyList[0]));
+                else if( eType == OFTInteger64List )
+                    poFeature->SetField(iField, nCount / nEltSize,
+                        reinterpret_cast<GIntBig*>(&abyList[0]));
+                else
+                    poFeature->SetField(iField, nCount / nEltSize,
+                        reinterpret_cast<double*>(&abyList[0]));
+                break;
+            }
+            case OFTStringList:
+            {
+                bOK = oReader.Read(nCount) && nCount >= 0;
+                CPLStringList aosList;
+                for( int i = 0; bOK && i < nCount; i++ )
+                {
+                    bOK = oReader.ReadString(osStr, bIsNull);
+                    aosList.AddString(osStr);
+                }
+                if( bOK )
+                    poFeature->SetField(iField, aosList.List());
+                break;
+            }
+            default:
+                bOK = oReader.ReadString(osStr, bIsNull);
+                if( bOK && !bIsNull )
+                    poFeature->SetField(iField, osStr.c_str());
+                break;
+        }
+    }
+
+    for( int iGeom = 0; bOK && iGeom < poDefn->GetGeomFieldCount(); iGeom++ )
+    {
+        int nWkbSize = 0;
+        const GByte* pabyWkb = NULL;
+        bOK = oReader.Read(nWkbSize) &&
+              (pabyWkb = oReader.ReadBytes(nWkbSize)) != NULL;
+        if( !bOK || nWkbSize == 0 )
+            continue;
+        OGRGeometry* poGeom = NULL;
+        if( OGRGeometryFactory::createFromWkb(
+                const_cast<GByte*>(pabyWkb),
+                poDefn->GetGeomFieldDefn(iGeom)->GetSpatialRef(),
+                &poGeom, nWkbSize, wkbVariantIso) == OGRERR_NONE )
+        {
+            poFeature->SetGeomFieldDirectly(iGeom, poGeom);
+        }
+    }
+
+    if( bOK && (bOK = oReader.ReadString(osStr, bIsNull)) && !bIsNull )
+        poFeature->SetStyleString(osStr);
+    if( bOK && (bOK = oReader.ReadString(osStr, bIsNull)) && !bIsNull )
+        poFeature->SetNativeData(osStr);
+    if( bOK && (bOK = oReader.ReadString(osStr, bIsNull)) && !bIsNull )
+        poFeature->SetNativeMediaType(osStr);
+
+    if( !bOK )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Corrupted feature in ORDER BY temporary file");
+        delete poFeature;
+        return NULL;
+    }
+    return poFeature;
+}
+
+/************************************************************************/
+/*                           OGRGenSQLSorter                            */
+/*                                                                      */
+/*      Sorts the source features of an ORDER BY request, keeping the   */
+/*      features themselves so that they can be streamed back in order  */
+/*      without random reads on the source layer.                       */
+/*                                                                      */
+/*      - With a LIMIT, only the first OFFSET+LIMIT features are kept   */
+/*        in a bounded heap.                                            */
+/*      - Otherwise, features are accumulated in memory up to           */
+/*        OGR_GENSQL_SORT_MAX_MEMORY bytes, then sorted and written as  */
+/*        a run to a temporary file.  When runs have been spilled, the  */
+/*        result is produced by a k-way merge of the runs.              */
+/*                                                                      */
+/*      Ties are broken by reading order, so the sort is stable.        */
+/************************************************************************/
+
+class OGRGenSQLSorter
+{
+        struct Record
+        {
+            OGRField   *pasKeys;
+            GIntBig     nSeq;
+            OGRFeature *poFeature;
+        };
+
+        struct Run
+        {
+            vsi_l_offset        nStart;
+            vsi_l_offset        nEnd;
+            vsi_l_offset        nCur;
+            std::vector<GByte>  abyBuffer;
+            size_t              nBufferPos;
+            size_t              nBufferSize;
+            Record              sRecord;
+        };
+
+        class RecordLess
+        {
+                OGRGenSQLSorter *m_poSorter;
+            public:
+                explicit RecordLess( OGRGenSQLSorter* poSorter ) :
+                    m_poSorter(poSorter) {}
+                bool operator()( const Record& a, const Record& b ) const
+                    { return m_poSorter->IsLess(a, b); }
+        };
+
+        // Orders run indices so that std::push_heap() / std::pop_heap()
+        // give the run with the smallest current record first.
+        class RunGreater
+        {
+                OGRGenSQLSorter *m_poSorter;
+            public:
+                explicit RunGreater( OGRGenSQLSorter* poSorter ) :
+                    m_poSorter(poSorter) {}
+                bool operator()( size_t a, size_t b ) const
+                    { return m_poSorter->IsLess(m_poSorter->m_apoRuns[b]->sRecord,
+                                                m_poSorter->m_apoRuns[a]->sRecord); }
+        };
+
+        OGRGenSQLResultsLayer *m_poLayer;
+        OGRFeatureDefn        *m_poSrcDefn;
+        int                    m_nOrderItems;
+        size_t                 m_nTopN;
+
+        std::vector<Record>    m_asRecords;
+        size_t                 m_nNextRecord;
+
+        CPLString              m_osTmpFilename;
+        VSILFILE              *m_fpTmp;
+        std::vector<Run*>      m_apoRuns;
+        std::vector<size_t>    m_anRunHeap;
+        std::vector<GByte>     m_abyBuffer;
+        size_t                 m_nRunBufferSize;
+
+        bool                   IsLess( const Record& a, const Record& b );
+        void                   FreeRecord( Record& sRecord );
+        bool                   SpillRun();
+        bool                   ReadRunRecord( Run* poRun );
+
+        CPL_DISALLOW_COPY_ASSIGN(OGRGenSQLSorter)
+
+    public:
+                               OGRGenSQLSorter( OGRGenSQLResultsLayer* poLayer,
+                                                OGRFeatureDefn* poSrcDefn,
+                                                size_t nTopN );
+                              ~OGRGenSQLSorter();
+
+        bool                   Build( OGRLayer* poSrcLayer );
+        void                   Rewind();
+        void                   Skip( GIntBig nCount );
+        OGRFeature            *GetNextFeature();
+};
+
+OGRGenSQLSorter::OGRGenSQLSorter( OGRGenSQLResultsLayer* poLayer,
+                                  OGRFeatureDefn* poSrcDefn,
+                                  size_t nTopN ) :
+    m_poLayer(poLayer),
+    m_poSrcDefn(poSrcDefn),
+    m_nOrderItems(
+        static_cast<swq_select*>(poLayer->pSelectInfo)->order_specs),
+    m_nTopN(nTopN),
+    m_nNextRecord(0),
+    m_fpTmp(NULL),
+    m_nRunBufferSize(0)
+{}
+
+OGRGenSQLSorter::~OGRGenSQLSorter()
+{
+    for( size_t i = 0; i < m_asRecords.size(); i++ )
+        FreeRecord(m_asRecords[i]);
+    for( size_t i = 0; i < m_apoRuns.size(); i++ )
+    {
+        FreeRecord(m_apoRuns[i]->sRecord);
+        delete m_apoRuns[i];
+    }
+    if( m_fpTmp != NULL )
+    {
+        VSIFCloseL(m_fpTmp);
+        VSIUnlink(m_osTmpFilename);
+    }
+}
+
+/************************************************************************/
+/*                               IsLess()                               */
+/************************************************************************/
+
+bool OGRGenSQLSorter::IsLess( const Record& a, const Record& b )
+{
+    const int nRes = m_poLayer->Compare(a.pasKeys, b.pasKeys);
+    return nRes < 0 || (nRes == 0 && a.nSeq < b.nSeq);
+}
+
+/************************************************************************/
+/*                             FreeRecord()                             */
+/************************************************************************/
+
+void OGRGenSQLSorter::FreeRecord( Record& sRecord )
+{
+    if( sRecord.pasKeys != NULL )
+        m_poLayer->FreeIndexFields(sRecord.pasKeys, 1);
+    delete sRecord.poFeature;
+    sRecord.pasKeys = NULL;
+    sRecord.poFeature = NULL;
+}
+
+/************************************************************************/
+/*                              SpillRun()                              */
+/*                                                                      */
+/*      Sort the in-memory records and append them as a new run to the  */
+/*      temporary file.                                                 */
+/************************************************************************/
+
+bool OGRGenSQLSorter::SpillRun()
+{
+    if( m_fpTmp == NULL )
+    {
+        m_osTmpFilename = CPLGenerateTempFilename("ogr_gensql_sort");
+        m_fpTmp = VSIFOpenL(m_osTmpFilename, "wb+");
+        if( m_fpTmp == NULL )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Cannot create temporary file %s",
+                     m_osTmpFilename.c_str());
+            return false;
+        }
+    }
+
+    std::sort(m_asRecords.begin(), m_asRecords.end(), RecordLess(this));
+
+    Run* poRun = new Run();
+    VSIFSeekL(m_fpTmp, 0, SEEK_END);
+    poRun->nStart = VSIFTellL(m_fpTmp);
+    poRun->sRecord.pasKeys = NULL;
+    poRun->sRecord.poFeature = NULL;
+    m_apoRuns.push_back(poRun);
+
+    bool bOK = true;
+    for( size_t i = 0; i < m_asRecords.size(); i++ )
+    {
+        m_abyBuffer.clear();
+        OGRGenSQLWrite(m_abyBuffer, static_cast<GUInt32>(0));
+        OGRGenSQLWrite(m_abyBuffer, m_asRecords[i].nSeq);
+        OGRGenSQLSerializeFeature(m_asRecords[i].poFeature, m_abyBuffer);
+        FreeRecord(m_asRecords[i]);
+
+        const GUInt32 nSize = static_cast<GUInt32>(m_abyBuffer.size());
+        memcpy(&m_abyBuffer[0], &nSize, sizeof(nSize));
+        if( bOK &&
+            VSIFWriteL(&m_abyBuffer[0], 1, m_abyBuffer.size(), m_fpTmp) !=
+                                                        m_abyBuffer.size() )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Cannot write to temporary file %s",
+                     m_osTmpFilename.c_str());
+            bOK = false;
+        }
+    }
+    m_asRecords.clear();
+    poRun->nEnd = VSIFTellL(m_fpTmp);
+    return bOK;
+}
+
+/************************************************************************/
+/*                           ReadRunRecord()                            */
+/*                                                                      */
+/*      Load the next record of a run. Returns false at end of run.     */
+/************************************************************************/
+
+bool OGRGenSQLSorter::ReadRunRecord( Run* poRun )
+{
+    FreeRecord(poRun->sRecord);
+
+    // Make sure the buffer holds the full record, refilling it from the
+    // run as needed. Records larger than the run buffer make it grow to
+    // the size given in their header.
+    const size_t nHeaderSize = sizeof(GUInt32) + sizeof(GIntBig);
+    GUInt32 nSize = 0;
+    while( true )
+    {
+        const size_t nAvailable = poRun->nBufferSize - poRun->nBufferPos;
+        nSize = 0;
+        if( nAvailable >= sizeof(nSize) )
+        {
+            memcpy(&nSize, &poRun->abyBuffer[poRun->nBufferPos],
+                   sizeof(nSize));
+            if( nSize < nHeaderSize )
+                break;
+            if( nAvailable >= nSize )
+                break;
+        }
+        else if( nAvailable == 0 && poRun->nCur == poRun->nEnd )
+        {
+            return false;
+        }
+        if( poRun->nCur == poRun->nEnd )
+        {
+            // Truncated record
+            nSize = 0;
+            break;
+        }
+
+        memmove(&poRun->abyBuffer[0],
+                &poRun->abyBuffer[0] + poRun->nBufferPos, nAvailable);
+        poRun->nBufferPos = 0;
+        poRun->nBufferSize = nAvailable;
+        const size_t nWanted = std::max(static_cast<size_t>(nSize),
+                                        m_nRunBufferSize);
+        if( poRun->abyBuffer.size() < nWanted )
+            poRun->abyBuffer.resize(nWanted);
+        const size_t nToRead = std::min(
+            static_cast<size_t>(poRun->nEnd - poRun->nCur),
+            poRun->abyBuffer.size() - nAvailable);
+        if( VSIFSeekL(m_fpTmp, poRun->nCur, SEEK_SET) != 0 ||
+            VSIFReadL(&poRun->abyBuffer[nAvailable], 1, nToRead, m_fpTmp)
+                                                            != nToRead )
+        {
+            CPLError(CE_Failure, CPLE_FileIO,
+                     "Cannot read temporary file %s",
+                     m_osTmpFilename.c_str());
+            return false;
+        }
+        poRun->nCur += nToRead;
+        poRun->nBufferSize += nToRead;
+    }
+    if( nSize < nHeaderSize )
+    {
+        CPLError(CE_Failure, CPLE_AppDefined,
+                 "Corrupted ORDER BY temporary file");
+        return false;
+    }
+
+    const GByte* pabyRecord = &poRun->abyBuffer[poRun->nBufferPos];
+    memcpy(&poRun->sRecord.nSeq, pabyRecord + sizeof(nSize), sizeof(GIntBig));
+    poRun->sRecord.poFeature = OGRGenSQLDeserializeFeature(
+        pabyRecord + nHeaderSize, nSize - nHeaderSize, m_poSrcDefn);
+    poRun->nBufferPos += nSize;
+    if( poRun->sRecord.poFeature == NULL )
+        return false;
+
+    poRun->sRecord.pasKeys = static_cast<OGRField*>(
+        CPLCalloc(sizeof(OGRField), m_nOrderItems));
+    m_poLayer->ReadIndexFields(poRun->sRecord.poFeature, m_nOrderItems,
+                               poRun->sRecord.pasKeys);
+    return true;
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+bool OGRGenSQLSorter::Build( OGRLayer* poSrcLayer )
+{
+    const GIntBig nMaxMemory = CPLAtoGIntBig(
+        CPLGetConfigOption("OGR_GENSQL_SORT_MAX_MEMORY", "104857600"));
+    GIntBig nMemory = 0;
+    GIntBig nSeq = 0;
+
+    OGRFeature* poSrcFeat = NULL;
+    while( (poSrcFeat = poSrcLayer->GetNextFeature()) != NULL )
+    {
+        Record sRecord;
+        sRecord.pasKeys = static_cast<OGRField*>(
+            CPLCalloc(sizeof(OGRField), m_nOrderItems));
+        m_poLayer->ReadIndexFields(poSrcFeat, m_nOrderItems, sRecord.pasKeys);
+        sRecord.nSeq = nSeq++;
+        sRecord.poFeature = poSrcFeat;
+
+        if( m_nTopN > 0 )
+        {
+            // Max-heap of the best m_nTopN records seen so far.
+            m_asRecords.push_back(sRecord);
+            std::push_heap(m_asRecords.begin(), m_asRecords.end(),
+                           RecordLess(this));
+            if( m_asRecords.size() > m_nTopN )
+            {
+                std::pop_heap(m_asRecords.begin(), m_asRecords.end(),
+                              RecordLess(this));
+                FreeRecord(m_asRecords.back());
+                m_asRecords.pop_back();
+            }
+            continue;
+        }
+
+        m_asRecords.push_back(sRecord);
+        nMemory += OGRGenSQLEstimateFeatureSize(poSrcFeat) +
+                   m_nOrderItems * static_cast<GIntBig>(sizeof(OGRField));
+        if( nMemory > nMaxMemory )
+        {
+            if( !SpillRun() )
+                return false;
+            nMemory = 0;
+        }
+    }
+
+    if( m_nTopN > 0 )
+    {
+        std::sort_heap(m_asRecords.begin(), m_asRecords.end(),
+                       RecordLess(this));
+    }
+    else if( !m_apoRuns.empty() )
+    {
+        if( !m_asRecords.empty() && !SpillRun() )
+            return false;
+        // Read buffers of the runs share the memory budget.
+        m_nRunBufferSize = static_cast<size_t>(std::max(
+            static_cast<GIntBig>(4096),
+            std::min(static_cast<GIntBig>(256 * 1024),
+                     nMaxMemory / static_cast<GIntBig>(m_apoRuns.size()))));
+        CPLDebug("GenSQL", "ORDER BY: merging %d sorted runs",
+                 static_cast<int>(m_apoRuns.size()));
+    }
+    else
+    {
+        std::sort(m_asRecords.begin(), m_asRecords.end(), RecordLess(this));
+    }
+
+    Rewind();
+    return true;
+}
+
+/************************************************************************/
+/*                               Rewind()                               */
+/************************************************************************/
+
+void OGRGenSQLSorter::Rewind()
+{
+    m_nNextRecord = 0;
+
+    m_anRunHeap.clear();
+    for( size_t i = 0; i < m_apoRuns.size(); i++ )
+    {
+        Run* poRun = m_apoRuns[i];
+        poRun->nCur = poRun->nStart;
+        poRun->nBufferPos = 0;
+        poRun->nBufferSize = 0;
+        if( ReadRunRecord(poRun) )
+        {
+            m_anRunHeap.push_back(i);
+            std::push_heap(m_anRunHeap.begin(), m_anRunHeap.end(),
+                           RunGreater(this));
+        }
+    }
+}
+
+/************************************************************************/
+/*                                Skip()                                */
+/************************************************************************/
+
+void OGRGenSQLSorter::Skip( GIntBig nCount )
+{
+    if( m_apoRuns.empty() )
+    {
+        m_nNextRecord = static_cast<size_t>(std::min(
+            static_cast<GIntBig>(m_asRecords.size()),
+            static_cast<GIntBig>(m_nNextRecord) + nCount));
+        return;
+    }
+
+    for( GIntBig i = 0; i < nCount; i++ )
+    {
+        OGRFeature* poFeature = GetNextFeature();
+        if( poFeature == NULL )
+            break;
+        delete poFeature;
+    }
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/*                                                                      */
+/*      Returns the next source feature in sorted order, owned by the   */
+/*      caller.                                                         */
+/************************************************************************/
+
+OGRFeature* OGRGenSQLSorter::GetNextFeature()
+{
+    if( m_apoRuns.empty() )
+    {
+        if( m_nNextRecord == m_asRecords.size() )
+            return NULL;
+        return m_asRecords[m_nNextRecord++].poFeature->Clone();
+    }
+
+    if( m_anRunHeap.empty() )
+        return NULL;
+
+    std::pop_heap(m_anRunHeap.begin(), m_anRunHeap.end(), RunGreater(this));
+    Run* poRun = m_apoRuns[m_anRunHeap.back()];
+    OGRFeature* poFeature = poRun->sRecord.poFeature;
+    poRun->sRecord.poFeature = NULL;
+    if( ReadRunRecord(poRun) )
+        std::push_heap(m_anRunHeap.begin(), m_anRunHeap.end(),
+                       RunGreater(this));
+    else
+        m_anRunHeap.pop_back();
+    return poFeature;
+}
+
 /************************************************************************/
 /*                       OGRGenSQLResultsLayer()                        */
 /************************************************************************/
@@ -100,6 +1096,7 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDSIn,
     nIndexSize(0),
     panFIDIndex(NULL),
     bOrderByValid(FALSE),
+    m_poSorter(NULL),
     nNextIndexFID(0),
     poSummaryFeature(NULL),
     iFIDFieldIndex(),
@@ -510,11 +1507,15 @@ OGRGenSQLResultsLayer::~OGRGenSQLResultsLayer()
 /* -------------------------------------------------------------------- */
 /*      Free various datastructures.                                    */
 /* -------------------------------------------------------------------- */
+    for( size_t i = 0; i < m_apoJoinHashTables.size(); i++ )
+        delete m_apoJoinHashTables[i];
+
     CPLFree( papoTableLayers );
     papoTableLayers = NULL;
 
     CPLFree( panFIDIndex );
     CPLFree( panGeomFieldToSrcGeomField );
+    delete m_poSorter;
 
     delete poSummaryFeature;
     delete (swq_select *) pSelectInfo;
@@ -636,6 +1637,9 @@ void OGRGenSQLResultsLayer::ResetReading()
 
     nNextIndexFID = psSelectInfo->offset;
     nIteratedFeatures = -1;
+
+    if( m_poSorter != NULL )
+        m_poSorter->Rewind();
 }
 
 /************************************************************************/
@@ -715,8 +1719,6 @@ GIntBig OGRGenSQLResultsLayer::GetFeatureCount( int bForce )
 {
     swq_select *psSelectInfo = (swq_select *) pSelectInfo;
 
-    CreateOrderByIndex();
-
     GIntBig nRet = 0;
     if( psSelectInfo->query_mode == SWQM_DISTINCT_LIST )
     {
@@ -1267,6 +2269,97 @@ static CPLString GetFilterForJoin(swq_expr_node* poExpr, OGRFeature* poSrcFeat,
     return "";
 }
 
+/************************************************************************/
+/*                          GetJoinHashTable()                          */
+/*                                                                      */
+/*      Returns the lookup table of a join, building it on first use,   */
+/*      or NULL if the join condition is not a simple equality between */
+/*      a field of the primary table and a field of the secondary one.  */
+/*      Can be disabled with OGR_GENSQL_HASH_JOIN=NO.                   */
+/************************************************************************/
+
+OGRGenSQLJoinHashTable *OGRGenSQLResultsLayer::GetJoinHashTable( int iJoin )
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+
+    if( m_abJoinHashTableTried.empty() )
+    {
+        m_abJoinHashTableTried.resize(psSelectInfo->join_count, false);
+        m_apoJoinHashTables.resize(psSelectInfo->join_count, NULL);
+    }
+    if( m_abJoinHashTableTried[iJoin] )
+        return m_apoJoinHashTables[iJoin];
+    m_abJoinHashTableTried[iJoin] = true;
+
+    if( !CPLTestBool(CPLGetConfigOption("OGR_GENSQL_HASH_JOIN", "YES")) )
+        return NULL;
+
+    swq_join_def *psJoinInfo = psSelectInfo->join_defs + iJoin;
+    OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
+    swq_expr_node* poExpr = psJoinInfo->poExpr;
+
+    // A self join would disturb the reading of the primary layer.
+    if( poJoinLayer == poSrcLayer ||
+        poExpr->eNodeType != SNT_OPERATION ||
+        poExpr->nOperation != SWQ_EQ ||
+        poExpr->nSubExprCount != 2 ||
+        poExpr->papoSubExpr[0]->eNodeType != SNT_COLUMN ||
+        poExpr->papoSubExpr[1]->eNodeType != SNT_COLUMN )
+    {
+        return NULL;
+    }
+
+    swq_expr_node* poPrimary = poExpr->papoSubExpr[0];
+    swq_expr_node* poSecondary = poExpr->papoSubExpr[1];
+    if( poPrimary->table_index != 0 )
+        std::swap(poPrimary, poSecondary);
+    if( poPrimary->table_index != 0 ||
+        poSecondary->table_index != psJoinInfo->secondary_table )
+        return NULL;
+
+    OGRFeatureDefn* poPrimaryDefn = poSrcLayer->GetLayerDefn();
+    OGRFeatureDefn* poSecondaryDefn = poJoinLayer->GetLayerDefn();
+    if( poPrimary->field_index < 0 ||
+        poPrimary->field_index >= poPrimaryDefn->GetFieldCount() ||
+        poSecondary->field_index < 0 ||
+        poSecondary->field_index >= poSecondaryDefn->GetFieldCount() )
+        return NULL;
+
+    const OGRFieldType ePrimaryType =
+        poPrimaryDefn->GetFieldDefn(poPrimary->field_index)->GetType();
+    const OGRFieldType eSecondaryType =
+        poSecondaryDefn->GetFieldDefn(poSecondary->field_index)->GetType();
+    const bool bPrimaryInt =
+        ePrimaryType == OFTInteger || ePrimaryType == OFTInteger64;
+    const bool bSecondaryInt =
+        eSecondaryType == OFTInteger || eSecondaryType == OFTInteger64;
+
+    OGRGenSQLJoinKeyType eKeyType;
+    if( bPrimaryInt && bSecondaryInt )
+        eKeyType = JOIN_KEY_INTEGER;
+    else if( (bPrimaryInt || ePrimaryType == OFTReal) &&
+             (bSecondaryInt || eSecondaryType == OFTReal) )
+        eKeyType = JOIN_KEY_REAL;
+    else if( ePrimaryType == OFTString && eSecondaryType == OFTString )
+        eKeyType = JOIN_KEY_STRING;
+    else
+        return NULL;
+
+    OGRGenSQLJoinHashTable* poHashTable =
+        new OGRGenSQLJoinHashTable(poJoinLayer, poPrimary->field_index,
+                                   poSecondary->field_index, eKeyType);
+    if( !poHashTable->Build() )
+    {
+        delete poHashTable;
+        return NULL;
+    }
+    CPLDebug("GenSQL", "Using lookup table for join on layer %s",
+             poJoinLayer->GetName());
+    m_apoJoinHashTables[iJoin] = poHashTable;
+    return poHashTable;
+}
+
 /************************************************************************/
 /*                          TranslateFeature()                          */
 /************************************************************************/
@@ -1300,6 +2393,13 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 
         OGRLayer *poJoinLayer = papoTableLayers[psJoinInfo->secondary_table];
 
+        OGRGenSQLJoinHashTable* poHashTable = GetJoinHashTable(iJoin);
+        if( poHashTable != NULL )
+        {
+            apoFeatures.push_back( poHashTable->Lookup(poSrcFeat) );
+            continue;
+        }
+
         osFilter = GetFilterForJoin(psJoinInfo->poExpr, poSrcFeat, poJoinLayer,
                                     psJoinInfo->secondary_table);
         //CPLDebug("OGR", "Filter = %s\n", osFilter.c_str());
@@ -1559,12 +2659,20 @@ OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
         (nIteratedFeatures < 0 ? 0 : nIteratedFeatures) >= psSelectInfo->limit )
         return NULL;
 
-    CreateOrderByIndex();
-    if( panFIDIndex == NULL &&
-        nIteratedFeatures < 0 && psSelectInfo->offset > 0 &&
+    if( psSelectInfo->query_mode == SWQM_RECORDSET &&
+        psSelectInfo->order_specs > 0 &&
+        !bOrderByValid && m_poSorter == NULL &&
+        !SortSourceFeatures() )
+    {
+        CreateOrderByIndex();
+    }
+    if( nIteratedFeatures < 0 && psSelectInfo->offset > 0 &&
         psSelectInfo->query_mode == SWQM_RECORDSET )
     {
-        poSrcLayer->SetNextByIndex(psSelectInfo->offset);
+        if( m_poSorter != NULL )
+            m_poSorter->Skip(psSelectInfo->offset);
+        else if( panFIDIndex == NULL )
+            poSrcLayer->SetNextByIndex(psSelectInfo->offset);
     }
     if( nIteratedFeatures < 0 )
         nIteratedFeatures = 0;
@@ -1592,7 +2700,8 @@ OGRFeature *OGRGenSQLResultsLayer::GetNextFeature()
             poFeature = GetFeature( nNextIndexFID++ );
         else
         {
-            OGRFeature *poSrcFeat = poSrcLayer->GetNextFeature();
+            OGRFeature *poSrcFeat = m_poSorter != NULL ?
+                m_poSorter->GetNextFeature() : poSrcLayer->GetNextFeature();
 
             if( poSrcFeat == NULL )
                 return NULL;
@@ -1930,6 +3039,10 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
 
     bOrderByValid = TRUE;
 
+    // The FID index supersedes the sorted features of sequential reading.
+    delete m_poSorter;
+    m_poSorter = NULL;
+
     ResetReading();
 
 /* -------------------------------------------------------------------- */
@@ -2124,6 +3237,48 @@ void OGRGenSQLResultsLayer::CreateOrderByIndex()
     ResetReading();
 }
 
+/************************************************************************/
+/*                         SortSourceFeatures()                         */
+/*                                                                      */
+/*      Used instead of CreateOrderByIndex() for sequential reading of  */
+/*      ORDER BY results.  The source features are sorted themselves,   */
+/*      spilling to disk if needed, so that they can be returned in     */
+/*      order without one random read per feature on the source layer.  */
+/************************************************************************/
+
+bool OGRGenSQLResultsLayer::SortSourceFeatures()
+
+{
+    swq_select *psSelectInfo = (swq_select *) pSelectInfo;
+
+    if( m_poSorter != NULL )
+        return true;
+
+/* -------------------------------------------------------------------- */
+/*      When the LIMIT applies directly to the sorted source features,  */
+/*      only the first OFFSET+LIMIT of them need to be retained.        */
+/* -------------------------------------------------------------------- */
+    size_t nTopN = 0;
+    if( psSelectInfo->limit > 0 &&
+        psSelectInfo->offset + psSelectInfo->limit <= 100000 &&
+        m_poAttrQuery == NULL && !MustEvaluateSpatialFilterOnGenSQL() )
+    {
+        nTopN = static_cast<size_t>(psSelectInfo->offset +
+                                    psSelectInfo->limit);
+    }
+
+    ResetReading();
+
+    m_poSorter = new OGRGenSQLSorter(this, poSrcLayer->GetLayerDefn(), nTopN);
+    if( !m_poSorter->Build(poSrcLayer) )
+    {
+        delete m_poSorter;
+        m_poSorter = NULL;
+        return false;
+    }
+    return true;
+}
+
 /************************************************************************/
 /*                          SortIndexSection()                          */
 /*                                                                      */
@@ -2405,6 +3560,9 @@ void OGRGenSQLResultsLayer::InvalidateOrderByIndex()
     CPLFree( panFIDIndex );
     panFIDIndex = NULL;
 
+    delete m_poSorter;
+    m_poSorter = NULL;
+
     nIndexSize = 0;
     bOrderByValid = FALSE;
 }
@@ -54,8 +54,13 @@
 /*                        OGRGenSQLResultsLayer                         */
 /************************************************************************/
 
+class OGRGenSQLJoinHashTable;
+class OGRGenSQLSorter;
+
 class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
 {
+    friend class OGRGenSQLSorter;
+
   private:
     GDALDataset *poSrcDS;
     OGRLayer    *poSrcLayer;
@@ -72,6 +77,7 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     size_t      nIndexSize;
     GIntBig    *panFIDIndex;
     int         bOrderByValid;
+    OGRGenSQLSorter *m_poSorter;
 
     GIntBig      nNextIndexFID;
     OGRFeature  *poSummaryFeature;
@@ -84,10 +90,15 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     GIntBig     nIteratedFeatures;
     std::vector<CPLString> m_oDistinctList;
 
+    std::vector<OGRGenSQLJoinHashTable*> m_apoJoinHashTables;
+    std::vector<bool> m_abJoinHashTableTried;
+
     int         PrepareSummary();
 
     OGRFeature *TranslateFeature( OGRFeature * );
+    OGRGenSQLJoinHashTable *GetJoinHashTable( int iJoin );
     void        CreateOrderByIndex();
+    bool        SortSourceFeatures();
     void        ReadIndexFields( OGRFeature* poSrcFeat,
                                  int nOrderItems,
                                  OGRField *pasIndexFields );
@@ -0,0 +1,777 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Implementation of in-memory attribute indexes built on demand.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_attrind.h"
+#include "cpl_conv.h"
+
+#include <algorithm>
+
+CPL_CVSID("$Id$")
+
+//! @cond Doxygen_Suppress
+
+/************************************************************************/
+/*                        OGRMemAttrIndexKeyLess                        */
+/*                                                                      */
+/*      Compare an entry and a bare key, for the binary searches.       */
+/************************************************************************/
+
+namespace {
+template<class T> struct OGRMemAttrIndexKeyLess
+{
+    bool operator()( const std::pair<T, GIntBig>& oEntry,
+                     const T& oKey ) const
+        { return oEntry.first < oKey; }
+    bool operator()( const T& oKey,
+                     const std::pair<T, GIntBig>& oEntry ) const
+        { return oKey < oEntry.first; }
+};
+} // namespace
+
+/************************************************************************/
+/*                       OGRMemAttrIndexAppend()                        */
+/*                                                                      */
+/*      Append the FIDs of a range of entries to a growing FID list.    */
+/************************************************************************/
+
+template<class T>
+static GIntBig *OGRMemAttrIndexAppend(
+    typename std::vector< std::pair<T, GIntBig> >::const_iterator oBegin,
+    typename std::vector< std::pair<T, GIntBig> >::const_iterator oEnd,
+    GIntBig *panFIDList, int *pnFIDCount, int *pnLength )
+{
+    const size_t nNewCount = static_cast<size_t>(oEnd - oBegin);
+    if( static_cast<size_t>(*pnFIDCount) + nNewCount >=
+                                        static_cast<size_t>(INT_MAX - 1) )
+    {
+        CPLError( CE_Failure, CPLE_OutOfMemory,
+                  "Too many matching features in attribute index." );
+        CPLFree( panFIDList );
+        *pnFIDCount = 0;
+        *pnLength = 0;
+        return NULL;
+    }
+
+    if( *pnFIDCount + static_cast<int>(nNewCount) >= *pnLength )
+    {
+        *pnLength = *pnFIDCount + static_cast<int>(nNewCount) + 1;
+        panFIDList = static_cast<GIntBig *>(
+            CPLRealloc( panFIDList, sizeof(GIntBig) * (*pnLength) ) );
+    }
+
+    for( ; oBegin != oEnd; ++oBegin )
+        panFIDList[(*pnFIDCount)++] = oBegin->second;
+    panFIDList[*pnFIDCount] = OGRNullFID;
+
+    return panFIDList;
+}
+
+/************************************************************************/
+/*                       OGRMemAttrIndexRange()                         */
+/*                                                                      */
+/*      Return the sorted, duplicate free list of the FIDs of the       */
+/*      entries whose key is within the requested bounds.               */
+/************************************************************************/
+
+template<class T>
+static GIntBig *OGRMemAttrIndexRange(
+    const std::vector< std::pair<T, GIntBig> >& aoEntries,
+    const T* poMin, bool bMinIncluded,
+    const T* poMax, bool bMaxIncluded,
+    int *pnFIDCount )
+{
+    typedef typename std::vector< std::pair<T, GIntBig> >::const_iterator
+        Iterator;
+    const OGRMemAttrIndexKeyLess<T> oLess;
+
+    Iterator oBegin = aoEntries.begin();
+    Iterator oEnd = aoEntries.end();
+    if( poMin != NULL )
+        oBegin = bMinIncluded ?
+            std::lower_bound(aoEntries.begin(), aoEntries.end(), *poMin, oLess):
+            std::upper_bound(aoEntries.begin(), aoEntries.end(), *poMin, oLess);
+    if( poMax != NULL )
+        oEnd = bMaxIncluded ?
+            std::upper_bound(oBegin, aoEntries.end(), *poMax, oLess) :
+            std::lower_bound(oBegin, aoEntries.end(), *poMax, oLess);
+    if( oEnd < oBegin )
+        oEnd = oBegin;
+
+    int nLength = 0;
+    *pnFIDCount = 0;
+    GIntBig *panFIDList = OGRMemAttrIndexAppend<T>( oBegin, oEnd, NULL,
+                                                    pnFIDCount, &nLength );
+    if( panFIDList == NULL )
+        return NULL;
+
+    std::sort( panFIDList, panFIDList + *pnFIDCount );
+    *pnFIDCount = static_cast<int>(
+        std::unique( panFIDList, panFIDList + *pnFIDCount ) - panFIDList );
+    panFIDList[*pnFIDCount] = OGRNullFID;
+
+    return panFIDList;
+}
+
+/************************************************************************/
+/*                       OGRMemAttrIndexRemove()                        */
+/************************************************************************/
+
+template<class T>
+static OGRErr OGRMemAttrIndexRemove( std::vector< std::pair<T, GIntBig> >&
+                                                                    aoEntries,
+                                     const std::pair<T, GIntBig>& oEntry )
+{
+    typename std::vector< std::pair<T, GIntBig> >::iterator oIter =
+        std::lower_bound( aoEntries.begin(), aoEntries.end(), oEntry );
+    if( oIter == aoEntries.end() || *oIter != oEntry )
+        return OGRERR_FAILURE;
+    aoEntries.erase( oIter );
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                            OGRMemAttrIndex                           */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                          OGRMemAttrIndex()                           */
+/************************************************************************/
+
+OGRMemAttrIndex::OGRMemAttrIndex( OGRFieldDefn *poFieldDefn ) :
+    osFieldName(poFieldDefn->GetNameRef()),
+    eType(poFieldDefn->GetType()),
+    bSorted(true),
+    nStringBytes(0)
+{}
+
+/************************************************************************/
+/*                          ~OGRMemAttrIndex()                          */
+/************************************************************************/
+
+OGRMemAttrIndex::~OGRMemAttrIndex() {}
+
+/************************************************************************/
+/*                          IsSupportedType()                           */
+/************************************************************************/
+
+bool OGRMemAttrIndex::IsSupportedType( OGRFieldType eFieldType )
+
+{
+    return eFieldType == OFTInteger || eFieldType == OFTInteger64 ||
+           eFieldType == OFTReal || eFieldType == OFTString;
+}
+
+/************************************************************************/
+/*                               Sort()                                 */
+/*                                                                      */
+/*      Entries are appended as they are added, and only sorted         */
+/*      when the index is queried.                                      */
+/************************************************************************/
+
+void OGRMemAttrIndex::Sort()
+
+{
+    if( bSorted )
+        return;
+
+    std::sort( aoIntegerEntries.begin(), aoIntegerEntries.end() );
+    std::sort( aoRealEntries.begin(), aoRealEntries.end() );
+    std::sort( aoStringEntries.begin(), aoStringEntries.end() );
+
+    bSorted = true;
+}
+
+/************************************************************************/
+/*                           GetStringKey()                             */
+/*                                                                      */
+/*      String comparisons of the OGR SQL dialect are case              */
+/*      insensitive, so the keys are folded to lower case.              */
+/************************************************************************/
+
+CPLString OGRMemAttrIndex::GetStringKey( const char *pszValue )
+
+{
+    return CPLString(pszValue).tolower();
+}
+
+/************************************************************************/
+/*                           GetMemoryUsage()                           */
+/************************************************************************/
+
+GIntBig OGRMemAttrIndex::GetMemoryUsage() const
+
+{
+    return static_cast<GIntBig>(
+        aoIntegerEntries.capacity() * sizeof(aoIntegerEntries[0]) +
+        aoRealEntries.capacity() * sizeof(aoRealEntries[0]) +
+        aoStringEntries.capacity() * sizeof(aoStringEntries[0])) +
+        nStringBytes;
+}
+
+/************************************************************************/
+/*                              AddEntry()                              */
+/************************************************************************/
+
+OGRErr OGRMemAttrIndex::AddEntry( OGRField *psKey, GIntBig nFID )
+
+{
+    if( psKey == NULL || OGR_RawField_IsUnset(psKey) ||
+        OGR_RawField_IsNull(psKey) )
+        return OGRERR_NONE;
+
+    switch( eType )
+    {
+      case OFTInteger:
+        aoIntegerEntries.push_back(
+            std::pair<GIntBig, GIntBig>(psKey->Integer, nFID) );
+        break;
+
+      case OFTInteger64:
+        aoIntegerEntries.push_back(
+            std::pair<GIntBig, GIntBig>(psKey->Integer64, nFID) );
+        break;
+
+      case OFTReal:
+        // NaN never compares equal, nor in any range.
+        if( CPLIsNan(psKey->Real) )
+            return OGRERR_NONE;
+        aoRealEntries.push_back(
+            std::pair<double, GIntBig>(psKey->Real, nFID) );
+        break;
+
+      case OFTString:
+        aoStringEntries.push_back(
+            std::pair<CPLString, GIntBig>(GetStringKey(psKey->String), nFID));
+        nStringBytes += aoStringEntries.back().first.capacity() + 1;
+        break;
+
+      default:
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+
+    bSorted = false;
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                            RemoveEntry()                             */
+/************************************************************************/
+
+OGRErr OGRMemAttrIndex::RemoveEntry( OGRField *psKey, GIntBig nFID )
+
+{
+    if( psKey == NULL || OGR_RawField_IsUnset(psKey) ||
+        OGR_RawField_IsNull(psKey) )
+        return OGRERR_NONE;
+
+    Sort();
+
+    switch( eType )
+    {
+      case OFTInteger:
+        return OGRMemAttrIndexRemove( aoIntegerEntries,
+            std::pair<GIntBig, GIntBig>(psKey->Integer, nFID) );
+
+      case OFTInteger64:
+        return OGRMemAttrIndexRemove( aoIntegerEntries,
+            std::pair<GIntBig, GIntBig>(psKey->Integer64, nFID) );
+
+      case OFTReal:
+        if( CPLIsNan(psKey->Real) )
+            return OGRERR_NONE;
+        return OGRMemAttrIndexRemove( aoRealEntries,
+            std::pair<double, GIntBig>(psKey->Real, nFID) );
+
+      case OFTString:
+        return OGRMemAttrIndexRemove( aoStringEntries,
+            std::pair<CPLString, GIntBig>(GetStringKey(psKey->String), nFID) );
+
+      default:
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+}
+
+/************************************************************************/
+/*                           GetAllMatches()                            */
+/************************************************************************/
+
+GIntBig *OGRMemAttrIndex::GetAllMatches( OGRField *psKey,
+                                         GIntBig* panFIDList,
+                                         int* nFIDCount, int* nLength )
+
+{
+    if( panFIDList == NULL )
+    {
+        panFIDList = static_cast<GIntBig *>(CPLMalloc(sizeof(GIntBig) * 2));
+        *nFIDCount = 0;
+        *nLength = 2;
+    }
+    panFIDList[*nFIDCount] = OGRNullFID;
+
+    Sort();
+
+    switch( eType )
+    {
+      case OFTInteger:
+      case OFTInteger64:
+      {
+          const GIntBig nKey =
+              eType == OFTInteger ? psKey->Integer : psKey->Integer64;
+          return OGRMemAttrIndexAppend<GIntBig>(
+              std::lower_bound( aoIntegerEntries.begin(),
+                                aoIntegerEntries.end(), nKey,
+                                OGRMemAttrIndexKeyLess<GIntBig>() ),
+              std::upper_bound( aoIntegerEntries.begin(),
+                                aoIntegerEntries.end(), nKey,
+                                OGRMemAttrIndexKeyLess<GIntBig>() ),
+              panFIDList, nFIDCount, nLength );
+      }
+
+      case OFTReal:
+          return OGRMemAttrIndexAppend<double>(
+              std::lower_bound( aoRealEntries.begin(),
+                                aoRealEntries.end(), psKey->Real,
+                                OGRMemAttrIndexKeyLess<double>() ),
+              std::upper_bound( aoRealEntries.begin(),
+                                aoRealEntries.end(), psKey->Real,
+                                OGRMemAttrIndexKeyLess<double>() ),
+              panFIDList, nFIDCount, nLength );
+
+      case OFTString:
+      {
+          const CPLString osKey(GetStringKey(psKey->String));
+          return OGRMemAttrIndexAppend<CPLString>(
+              std::lower_bound( aoStringEntries.begin(),
+                                aoStringEntries.end(), osKey,
+                                OGRMemAttrIndexKeyLess<CPLString>() ),
+              std::upper_bound( aoStringEntries.begin(),
+                                aoStringEntries.end(), osKey,
+                                OGRMemAttrIndexKeyLess<CPLString>() ),
+              panFIDList, nFIDCount, nLength );
+      }
+
+      default:
+        break;
+    }
+
+    return panFIDList;
+}
+
+GIntBig *OGRMemAttrIndex::GetAllMatches( OGRField *psKey )
+
+{
+    int nFIDCount = 0;
+    int nLength = 0;
+    return GetAllMatches( psKey, NULL, &nFIDCount, &nLength );
+}
+
+/************************************************************************/
+/*                           GetFirstMatch()                            */
+/************************************************************************/
+
+GIntBig OGRMemAttrIndex::GetFirstMatch( OGRField *psKey )
+
+{
+    GIntBig *panFIDList = GetAllMatches( psKey );
+    if( panFIDList == NULL )
+        return OGRNullFID;
+
+    const GIntBig nFID = panFIDList[0];
+    CPLFree( panFIDList );
+    return nFID;
+}
+
+/************************************************************************/
+/*                          GetRangeMatches()                           */
+/************************************************************************/
+
+GIntBig *OGRMemAttrIndex::GetRangeMatches( OGRField *psMin,
+                                           bool bMinIncluded,
+                                           OGRField *psMax,
+                                           bool bMaxIncluded,
+                                           int *pnFIDCount )
+
+{
+    *pnFIDCount = 0;
+
+    Sort();
+
+    switch( eType )
+    {
+      case OFTInteger:
+      case OFTInteger64:
+        return OGRMemAttrIndexRange<GIntBig>(
+            aoIntegerEntries,
+            psMin ? &(psMin->Integer64) : NULL, bMinIncluded,
+            psMax ? &(psMax->Integer64) : NULL, bMaxIncluded,
+            pnFIDCount );
+
+      case OFTReal:
+        return OGRMemAttrIndexRange<double>(
+            aoRealEntries,
+            psMin ? &(psMin->Real) : NULL, bMinIncluded,
+            psMax ? &(psMax->Real) : NULL, bMaxIncluded,
+            pnFIDCount );
+
+      case OFTString:
+      {
+          const CPLString osMin(psMin ? GetStringKey(psMin->String) : "");
+          const CPLString osMax(psMax ? GetStringKey(psMax->String) : "");
+          return OGRMemAttrIndexRange<CPLString>(
+              aoStringEntries,
+              psMin ? &osMin : NULL, bMinIncluded,
+              psMax ? &osMax : NULL, bMaxIncluded,
+              pnFIDCount );
+      }
+
+      default:
+        break;
+    }
+
+    return NULL;
+}
+
+/************************************************************************/
+/*                               Clear()                                */
+/************************************************************************/
+
+OGRErr OGRMemAttrIndex::Clear()
+
+{
+    std::vector< std::pair<GIntBig, GIntBig> >().swap(aoIntegerEntries);
+    std::vector< std::pair<double, GIntBig> >().swap(aoRealEntries);
+    std::vector< std::pair<CPLString, GIntBig> >().swap(aoStringEntries);
+    nStringBytes = 0;
+    bSorted = true;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                         OGRMemLayerAttrIndex                         */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                        OGRMemLayerAttrIndex()                        */
+/************************************************************************/
+
+OGRMemLayerAttrIndex::OGRMemLayerAttrIndex() :
+    nMaxMemoryUsage(0)
+{}
+
+/************************************************************************/
+/*                       ~OGRMemLayerAttrIndex()                        */
+/************************************************************************/
+
+OGRMemLayerAttrIndex::~OGRMemLayerAttrIndex()
+
+{
+    for( std::map<int, OGRMemAttrIndex*>::iterator oIter = oMapIndex.begin();
+         oIter != oMapIndex.end(); ++oIter )
+    {
+        delete oIter->second;
+    }
+}
+
+/************************************************************************/
+/*                             Initialize()                             */
+/*                                                                      */
+/*      The index lives in memory only, so there is no file to open.    */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::Initialize( const char * /* pszIndexPathIn */,
+                                         OGRLayer *poLayerIn )
+
+{
+    poLayer = poLayerIn;
+
+    const char *pszMaxMemory =
+        CPLGetConfigOption( "OGR_ATTR_INDEX_MAX_MEMORY", NULL );
+    if( pszMaxMemory != NULL )
+        nMaxMemoryUsage = CPLAtoGIntBig(pszMaxMemory) * 1024 * 1024;
+    else
+        nMaxMemoryUsage = CPLGetUsablePhysicalRAM() / 10;
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                            CreateIndex()                             */
+/*                                                                      */
+/*      Create an index corresponding to the indicated field, but do    */
+/*      not populate it.  Use IndexAllFeatures() for that.              */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::CreateIndex( int iField )
+
+{
+    OGRFeatureDefn *poFDefn = poLayer->GetLayerDefn();
+    if( iField < 0 || iField >= poFDefn->GetFieldCount() )
+        return OGRERR_FAILURE;
+
+    if( GetFieldIndex(iField) != NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "It seems we already have an index for field %d/%s\n"
+                  "of layer %s.",
+                  iField, poFDefn->GetFieldDefn(iField)->GetNameRef(),
+                  poFDefn->GetName() );
+        return OGRERR_FAILURE;
+    }
+
+    OGRFieldDefn *poFldDefn = poFDefn->GetFieldDefn(iField);
+    if( !OGRMemAttrIndex::IsSupportedType(poFldDefn->GetType()) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Indexing not support for the field type of field %s.",
+                  poFldDefn->GetNameRef() );
+        return OGRERR_FAILURE;
+    }
+
+    oMapIndex[iField] = new OGRMemAttrIndex( poFldDefn );
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                             DropIndex()                              */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::DropIndex( int iField )
+
+{
+    std::map<int, OGRMemAttrIndex*>::iterator oIter = oMapIndex.find(iField);
+    if( oIter == oMapIndex.end() )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "DROP INDEX on field (%d) that doesn't have an index.",
+                  iField );
+        return OGRERR_FAILURE;
+    }
+
+    delete oIter->second;
+    oMapIndex.erase( oIter );
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          IndexAllFeatures()                          */
+/*                                                                      */
+/*      Populate the index(es) from a full read of the layer.  If the   */
+/*      indexes grow beyond the configured memory limit, they are       */
+/*      dropped again.                                                  */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::IndexAllFeatures( int iField )
+
+{
+    poLayer->ResetReading();
+
+    OGRErr eErr = OGRERR_NONE;
+    GIntBig nFeatures = 0;
+    OGRFeature *poFeature = NULL;
+    while( (poFeature = poLayer->GetNextFeature()) != NULL )
+    {
+        eErr = AddToIndex( poFeature, iField );
+
+        delete poFeature;
+
+        // Checking the size is not free, so only do it from time to time.
+        if( eErr == OGRERR_NONE && (++nFeatures % 10000) == 0 &&
+            GetMemoryUsage() > nMaxMemoryUsage )
+        {
+            CPLDebug( "OGR",
+                      "Attribute index of layer %s exceeds "
+                      "OGR_ATTR_INDEX_MAX_MEMORY.  Dropping it.",
+                      poLayer->GetName() );
+            eErr = OGRERR_NOT_ENOUGH_MEMORY;
+        }
+
+        if( eErr != OGRERR_NONE )
+            break;
+    }
+
+    if( eErr != OGRERR_NONE )
+    {
+        for( std::map<int, OGRMemAttrIndex*>::iterator oIter =
+                 oMapIndex.begin(); oIter != oMapIndex.end(); ++oIter )
+        {
+            if( iField == -1 || oIter->first == iField )
+                oIter->second->Clear();
+        }
+        if( iField != -1 && oMapIndex.find(iField) != oMapIndex.end() )
+            DropIndex( iField );
+    }
+
+    poLayer->ResetReading();
+
+    return eErr;
+}
+
+/************************************************************************/
+/*                             AddToIndex()                             */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::AddToIndex( OGRFeature *poFeature,
+                                         int iTargetField )
+
+{
+    if( poFeature->GetFID() == OGRNullFID )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Attempt to index feature with no FID." );
+        return OGRERR_FAILURE;
+    }
+
+    for( std::map<int, OGRMemAttrIndex*>::iterator oIter = oMapIndex.begin();
+         oIter != oMapIndex.end(); ++oIter )
+    {
+        const int iField = oIter->first;
+        if( iTargetField != -1 && iTargetField != iField )
+            continue;
+
+        const OGRErr eErr =
+            oIter->second->AddEntry( poFeature->GetRawFieldRef(iField),
+                                     poFeature->GetFID() );
+        if( eErr != OGRERR_NONE )
+            return eErr;
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                          RemoveFromIndex()                           */
+/************************************************************************/
+
+OGRErr OGRMemLayerAttrIndex::RemoveFromIndex( OGRFeature *poFeature )
+
+{
+    if( poFeature->GetFID() == OGRNullFID )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Attempt to unindex feature with no FID." );
+        return OGRERR_FAILURE;
+    }
+
+    for( std::map<int, OGRMemAttrIndex*>::iterator oIter = oMapIndex.begin();
+         oIter != oMapIndex.end(); ++oIter )
+    {
+        oIter->second->RemoveEntry( poFeature->GetRawFieldRef(oIter->first),
+                                    poFeature->GetFID() );
+    }
+
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                           GetFieldIndex()                            */
+/*                                                                      */
+/*      An index whose field has been renamed, retyped or moved since   */
+/*      it was built is stale, and is dropped.                          */
+/************************************************************************/
+
+OGRAttrIndex *OGRMemLayerAttrIndex::GetFieldIndex( int iField )
+
+{
+    std::map<int, OGRMemAttrIndex*>::iterator oIter = oMapIndex.find(iField);
+    if( oIter == oMapIndex.end() )
+        return NULL;
+
+    OGRFeatureDefn *poFDefn = poLayer->GetLayerDefn();
+    if( iField >= poFDefn->GetFieldCount() ||
+        poFDefn->GetFieldDefn(iField)->GetType() !=
+                                        oIter->second->GetFieldType() ||
+        strcmp(poFDefn->GetFieldDefn(iField)->GetNameRef(),
+               oIter->second->GetFieldName()) != 0 )
+    {
+        delete oIter->second;
+        oMapIndex.erase( oIter );
+        return NULL;
+    }
+
+    return oIter->second;
+}
+
+/************************************************************************/
+/*                           GetMemoryUsage()                           */
+/************************************************************************/
+
+GIntBig OGRMemLayerAttrIndex::GetMemoryUsage() const
+
+{
+    GIntBig nUsage = 0;
+    for( std::map<int, OGRMemAttrIndex*>::const_iterator oIter =
+             oMapIndex.begin(); oIter != oMapIndex.end(); ++oIter )
+    {
+        nUsage += oIter->second->GetMemoryUsage();
+    }
+    return nUsage;
+}
+
+/************************************************************************/
+/*                            IncrementUse()                            */
+/*                                                                      */
+/*      Record that an attribute filter could have used an index on     */
+/*      this field, and return how many filters did so far.             */
+/************************************************************************/
+
+int OGRMemLayerAttrIndex::IncrementUse( int iField )
+
+{
+    OGRFeatureDefn *poFDefn = poLayer->GetLayerDefn();
+    if( iField < 0 || iField >= poFDefn->GetFieldCount() )
+        return 0;
+
+    return ++oMapUseCount[poFDefn->GetFieldDefn(iField)->GetNameRef()];
+}
+
+/************************************************************************/
+/*                             Invalidate()                             */
+/*                                                                      */
+/*      Drop all indexes, for instance after the layer content          */
+/*      changed in a way that cannot be applied to them.                */
+/************************************************************************/
+
+void OGRMemLayerAttrIndex::Invalidate()
+
+{
+    for( std::map<int, OGRMemAttrIndex*>::iterator oIter = oMapIndex.begin();
+         oIter != oMapIndex.end(); ++oIter )
+    {
+        delete oIter->second;
+    }
+    oMapIndex.clear();
+    oMapUseCount.clear();
+}
+
+//! @endcond
@@ -33,6 +33,11 @@
 #include "ogr_attrind.h"
 #include "swq.h"
 #include "ograpispy.h"
+#include "cpl_quad_tree.h"
+#include "cpl_worker_thread_pool.h"
+
+#include <algorithm>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
@@ -49,6 +54,8 @@ OGRLayer::OGRLayer() :
     m_poAttrQuery(NULL),
     m_pszAttrQueryString(NULL),
     m_poAttrIndex(NULL),
+    m_bAutoAttrIndex(false),
+    m_poAutoAttrIndex(NULL),
     m_nRefCount(0),
     m_nFeaturesRead(0)
 {}
@@ -72,6 +79,9 @@ OGRLayer::~OGRLayer()
         m_poAttrIndex = NULL;
     }
 
+    delete m_poAutoAttrIndex;
+    m_poAutoAttrIndex = NULL;
+
     if( m_poAttrQuery != NULL )
     {
         delete m_poAttrQuery;
@@ -368,12 +378,160 @@ OGRErr OGRLayer::SetAttributeFilter( const char *pszQuery )
         delete m_poAttrQuery;
         m_poAttrQuery = NULL;
     }
+    else if( m_bAutoAttrIndex )
+    {
+        BuildAutoAttrIndex();
+    }
 
     ResetReading();
 
     return eErr;
 }
 
+/************************************************************************/
+/*                      OGRCollectIndexableFields()                     */
+/*                                                                      */
+/*      Collect the fields of the comparisons of an expression that     */
+/*      OGRFeatureQuery::EvaluateAgainstIndices() could resolve with    */
+/*      indexes.  Returns false if the expression cannot be resolved    */
+/*      that way as a whole.                                            */
+/************************************************************************/
+
+static bool OGRCollectIndexableFields( swq_expr_node *psExpr,
+                                       OGRFeatureDefn *poDefn,
+                                       std::vector<int>& anFields )
+{
+    if( psExpr == NULL || psExpr->eNodeType != SNT_OPERATION )
+        return false;
+
+    if( (psExpr->nOperation == SWQ_OR || psExpr->nOperation == SWQ_AND) &&
+         psExpr->nSubExprCount == 2 )
+    {
+        return OGRCollectIndexableFields(psExpr->papoSubExpr[0], poDefn,
+                                         anFields) &&
+               OGRCollectIndexableFields(psExpr->papoSubExpr[1], poDefn,
+                                         anFields);
+    }
+
+    switch( psExpr->nOperation )
+    {
+      case SWQ_EQ:
+      case SWQ_IN:
+      case SWQ_GT:
+      case SWQ_GE:
+      case SWQ_LT:
+      case SWQ_LE:
+      case SWQ_BETWEEN:
+        break;
+      default:
+        return false;
+    }
+
+    if( psExpr->nSubExprCount < 2 )
+        return false;
+    swq_expr_node *poColumn = psExpr->papoSubExpr[0];
+    if( poColumn->eNodeType != SNT_COLUMN || poColumn->table_index != 0 ||
+        poColumn->field_index < 0 ||
+        poColumn->field_index >= poDefn->GetFieldCount() )
+        return false;
+    for( int i = 1; i < psExpr->nSubExprCount; i++ )
+    {
+        if( psExpr->papoSubExpr[i]->eNodeType != SNT_CONSTANT )
+            return false;
+    }
+
+    OGRFieldDefn *poFieldDefn = poDefn->GetFieldDefn(poColumn->field_index);
+    if( !OGRMemAttrIndex::IsSupportedType(poFieldDefn->GetType()) ||
+        poFieldDefn->IsIgnored() )
+        return false;
+
+    if( std::find(anFields.begin(), anFields.end(), poColumn->field_index) ==
+                                                                anFields.end() )
+        anFields.push_back(poColumn->field_index);
+    return true;
+}
+
+/************************************************************************/
+/*                         BuildAutoAttrIndex()                         */
+/*                                                                      */
+/*      Once a field has been used by OGR_ATTR_INDEX_THRESHOLD          */
+/*      attribute filters (2 by default, NO to disable), index it in    */
+/*      memory, so that the following filters on it, for instance the   */
+/*      per feature filters of the OGR SQL join fallback, do not need   */
+/*      a full scan of the layer.  The index is dropped by writes.      */
+/************************************************************************/
+
+void OGRLayer::BuildAutoAttrIndex()
+
+{
+    const char *pszThreshold =
+        CPLGetConfigOption("OGR_ATTR_INDEX_THRESHOLD", "2");
+    if( !CPLTestBool(pszThreshold) )
+        return;
+    const int nThreshold = std::max(1, atoi(pszThreshold));
+
+    OGRFeatureDefn *poDefn = GetLayerDefn();
+    std::vector<int> anFields;
+    if( !OGRCollectIndexableFields(
+            static_cast<swq_expr_node *>(m_poAttrQuery->GetSWQExpr()),
+            poDefn, anFields) )
+        return;
+
+    if( m_poAutoAttrIndex == NULL )
+    {
+        m_poAutoAttrIndex = new OGRMemLayerAttrIndex();
+        CPL_IGNORE_RET_VAL(m_poAutoAttrIndex->Initialize(NULL, this));
+    }
+    OGRMemLayerAttrIndex *poAutoIndex =
+        static_cast<OGRMemLayerAttrIndex *>(m_poAutoAttrIndex);
+
+    for( size_t i = 0; i < anFields.size(); i++ )
+    {
+        const int iField = anFields[i];
+        if( poAutoIndex->IncrementUse(iField) != nThreshold ||
+            poAutoIndex->GetFieldIndex(iField) != NULL )
+            continue;
+
+        // Scan the whole layer, with the filters temporarily removed, and
+        // without reading geometries for the drivers that can skip them.
+        OGRFeatureQuery *poAttrQuery = m_poAttrQuery;
+        OGRGeometry *poFilterGeom = m_poFilterGeom;
+        const GIntBig nFeaturesRead = m_nFeaturesRead;
+        const int bGeometryIgnored = poDefn->IsGeometryIgnored();
+        m_poAttrQuery = NULL;
+        m_poFilterGeom = NULL;
+        poDefn->SetGeometryIgnored(TRUE);
+        ResetReading();
+
+        if( poAutoIndex->CreateIndex(iField) == OGRERR_NONE &&
+            poAutoIndex->IndexAllFeatures(iField) == OGRERR_NONE )
+        {
+            CPLDebug("OGR", "Built attribute index on %s.%s",
+                     GetName(), poDefn->GetFieldDefn(iField)->GetNameRef());
+        }
+
+        m_poAttrQuery = poAttrQuery;
+        m_poFilterGeom = poFilterGeom;
+        m_nFeaturesRead = nFeaturesRead;
+        poDefn->SetGeometryIgnored(bGeometryIgnored);
+    }
+}
+
+/************************************************************************/
+/*                       InvalidateAutoAttrIndex()                      */
+/*                                                                      */
+/*      Drivers must call this when they change the features of the     */
+/*      layer other than through SetFeature(), CreateFeature() and      */
+/*      DeleteFeature(), for instance when renumbering them.            */
+/************************************************************************/
+
+void OGRLayer::InvalidateAutoAttrIndex()
+
+{
+    if( m_poAutoAttrIndex != NULL )
+        static_cast<OGRMemLayerAttrIndex *>(m_poAutoAttrIndex)->Invalidate();
+}
+
 /************************************************************************/
 /*                        ContainGeomSpecialField()                     */
 /************************************************************************/
@@ -549,6 +707,80 @@ OGRFeatureH OGR_L_GetNextFeature( OGRLayerH hLayer )
     return (OGRFeatureH) ((OGRLayer *)hLayer)->GetNextFeature();
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+/**
+ \brief Fetch the next available features from this layer, in columnar form.
+
+ The batch is reset, and then filled with at most nMaxFeatures features,
+ read as with GetNextFeature(): the current attribute and spatial filters are
+ honoured, and reading continues from the current position in the layer.
+ The values of ignored fields (see SetIgnoredFields()) are not fetched.
+ Reading can be mixed with calls to GetNextFeature().
+
+ Passing the same batch to successive calls allows its memory to be reused,
+ so that after the first calls reading a layer does not involve per-feature
+ allocations in the drivers that implement this method natively. The default
+ implementation calls GetNextFeature() and copies the features into the batch.
+
+ This method is the same as the C function OGR_L_GetNextFeatureBatch().
+
+ @param poBatch the batch to fill.
+ @param nMaxFeatures the maximum number of features to fetch.
+
+ @return the number of features in the batch, 0 when no more features are
+ available.
+
+ @since GDAL 2.3
+*/
+
+int OGRLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch, int nMaxFeatures )
+
+{
+    poBatch->Reset(GetLayerDefn());
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        OGRFeature *poFeature = GetNextFeature();
+        if( poFeature == NULL )
+            break;
+        poBatch->AddFeatureFrom(poFeature);
+        delete poFeature;
+    }
+    return poBatch->GetFeatureCount();
+}
+
+/************************************************************************/
+/*                     OGR_L_GetNextFeatureBatch()                      */
+/************************************************************************/
+
+/**
+ \brief Fetch the next available features from this layer, in columnar form.
+
+ This function is the same as the C++ method OGRLayer::GetNextFeatureBatch().
+
+ @param hLayer handle to the layer from which features are read.
+ @param hBatch handle to the batch to fill, created with OGR_FB_Create().
+ @param nMaxFeatures the maximum number of features to fetch.
+
+ @return the number of features in the batch, 0 when no more features are
+ available.
+
+ @since GDAL 2.3
+*/
+
+int OGR_L_GetNextFeatureBatch( OGRLayerH hLayer, OGRFeatureBatchH hBatch,
+                               int nMaxFeatures )
+
+{
+    VALIDATE_POINTER1( hLayer, "OGR_L_GetNextFeatureBatch", 0 );
+    VALIDATE_POINTER1( hBatch, "OGR_L_GetNextFeatureBatch", 0 );
+
+    return reinterpret_cast<OGRLayer *>(hLayer)->GetNextFeatureBatch(
+        reinterpret_cast<OGRFeatureBatch *>(hBatch), nMaxFeatures);
+}
+
 /************************************************************************/
 /*                       ConvertGeomsIfNecessary()                      */
 /************************************************************************/
@@ -562,6 +794,20 @@ void OGRLayer::ConvertGeomsIfNecessary( OGRFeature *poFeature )
         int nGeomFieldCount = GetLayerDefn()->GetGeomFieldCount();
         for(int i=0;i<nGeomFieldCount;i++)
         {
+            // Do not decode a pending WKB geometry if it has to be
+            // written as it is.
+            size_t nWKBSize = 0;
+            const GByte* pabyWKB = poFeature->GetGeomFieldWKBRef(i, &nWKBSize);
+            OGRwkbGeometryType eWKBType = wkbUnknown;
+            if( pabyWKB != NULL && nWKBSize >= 5 &&
+                OGRReadWKBGeometryType(pabyWKB, wkbVariantOldOgc,
+                                       &eWKBType) == OGRERR_NONE &&
+                (bSupportsM || !OGR_GT_HasM(eWKBType)) &&
+                (bSupportsCurve || !OGR_GT_IsNonLinear(eWKBType)) )
+            {
+                continue;
+            }
+
             OGRGeometry* poGeom = poFeature->GetGeomFieldRef(i);
             if( poGeom != NULL && (!bSupportsM && OGR_GT_HasM(poGeom->getGeometryType())) )
             {
@@ -585,6 +831,7 @@ OGRErr OGRLayer::SetFeature( OGRFeature *poFeature )
 
 {
     ConvertGeomsIfNecessary(poFeature);
+    InvalidateAutoAttrIndex();
     return ISetFeature(poFeature);
 }
 
@@ -624,7 +871,17 @@ OGRErr OGRLayer::CreateFeature( OGRFeature *poFeature )
 
 {
     ConvertGeomsIfNecessary(poFeature);
-    return ICreateFeature(poFeature);
+    const OGRErr eErr = ICreateFeature(poFeature);
+
+    // New features can simply be appended to the in-memory indexes.
+    if( m_poAutoAttrIndex != NULL )
+    {
+        if( eErr != OGRERR_NONE || poFeature->GetFID() == OGRNullFID ||
+            m_poAutoAttrIndex->AddToIndex(poFeature) != OGRERR_NONE )
+            InvalidateAutoAttrIndex();
+    }
+
+    return eErr;
 }
 
 /************************************************************************/
@@ -1973,151 +2230,576 @@ static OGRGeometry* promote_to_multi(OGRGeometry* poGeom)
 }
 
 /************************************************************************/
-/*                          Intersection()                              */
+/*                           OGROverlayIndex                            */
+/*                                                                      */
+/*      In-memory copy of the features of a layer, with a quad tree     */
+/*      on their envelopes. Used by the overlay methods when            */
+/*      USE_SPATIAL_INDEX=YES instead of querying the source layer      */
+/*      with a spatial filter for each feature. It is not modified      */
+/*      once built, so it can be read concurrently by several           */
+/*      OGROverlayIndexLayer.                                           */
 /************************************************************************/
-/**
- * \brief Intersection of two layers.
- *
- * The result layer contains features whose geometries represent areas
- * that are common between features in the input layer and in the
- * method layer. The features in the result layer have attributes from
- * both input and method layers. The schema of the result layer can be
- * set by the user or, if it is empty, is initialized to contain all
- * fields in the input and method layers.
- *
- * \note If the schema of the result is set by user and contains
- * fields that have the same name as a field in input and in method
- * layer, then the attribute in the result feature will get the value
- * from the feature of the method layer.
- *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
- *
- * \note This method relies on GEOS support. Do not use unless the
- * GEOS support is compiled in.
- *
- * The recognized list of options is:
- * <ul>
- * <li>SKIP_FAILURES=YES/NO. Set to YES to go on, even when a
- *     feature could not be inserted or a GEOS call failed.
- * <li>PROMOTE_TO_MULTI=YES/NO. Set to YES to convert Polygons
- *     into MultiPolygons, or LineStrings to MultiLineStrings.
- * <li>INPUT_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the input layer.
- * <li>METHOD_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the method layer.
- * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
- *     geometries to pretest intersection of features of method layer
- *     with features of this layer.
- * <li>PRETEST_CONTAINMENT=YES/NO. Set to YES to pretest the
- *     containment of features of method layer within the features of
- *     this layer. This will speed up the method significantly in some
- *     cases. Requires that the prepared geometries are in effect.
- * <li>KEEP_LOWER_DIMENSION_GEOMETRIES=YES/NO. Set to NO to skip
- *     result features with lower dimension geometry that would
- *     otherwise be added to the result layer. The default is to add
- *     but only if the result layer has an unknown geometry type.
- * </ul>
- *
- * This method is the same as the C function OGR_L_Intersection().
- *
- * @param pLayerMethod the method layer. Should not be NULL.
- *
- * @param pLayerResult the layer where the features resulting from the
- * operation are inserted. Should not be NULL. See above the note
- * about the schema.
- *
- * @param papszOptions NULL terminated list of options (may be NULL).
- *
- * @param pfnProgress a GDALProgressFunc() compatible callback function for
- * reporting progress or NULL.
- *
- * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
- *
- * @return an error code if there was an error or the execution was
- * interrupted, OGRERR_NONE otherwise.
- *
- * @note The first geometry field is always used.
- *
- * @since OGR 1.10
- */
 
-OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
-                               OGRLayer *pLayerResult,
-                               char** papszOptions,
-                               GDALProgressFunc pfnProgress,
-                               void * pProgressArg )
+class OGROverlayIndex
 {
-    OGRErr ret = OGRERR_NONE;
-    OGRFeatureDefn *poDefnInput = GetLayerDefn();
-    OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
-    OGRGeometry *pGeometryMethodFilter = NULL;
-    int *mapInput = NULL;
-    int *mapMethod = NULL;
-    OGREnvelope sEnvelopeMethod;
-    GBool bEnvelopeSet;
-    double progress_max = (double) GetFeatureCount(0);
-    double progress_counter = 0;
-    double progress_ticker = 0;
-    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
-    int bUsePreparedGeometries = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES"));
-    if (bUsePreparedGeometries) bUsePreparedGeometries = OGRHasPreparedGeometrySupport();
-    int bPretestContainment = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PRETEST_CONTAINMENT", "NO"));
-    int bKeepLowerDimGeom = CPLTestBool(CSLFetchNameValueDef(papszOptions, "KEEP_LOWER_DIMENSION_GEOMETRIES", "YES"));
+    OGRFeatureDefn           *m_poDefn;
+    std::vector<OGRFeature*>  m_apoFeatures;
+    std::vector<int>          m_anNoGeomFeatures;
+    CPLQuadTree              *m_hQuadTree;
+    OGREnvelope               m_sExtent;
 
-    // check for GEOS
-    if (!OGRGeometryFactory::haveGEOS()) {
-        return OGRERR_UNSUPPORTED_OPERATION;
-    }
+    CPL_DISALLOW_COPY_ASSIGN(OGROverlayIndex)
 
-    // get resources
-    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
-    if (ret != OGRERR_NONE) goto done;
-    ret = create_field_map(poDefnInput, &mapInput);
-    if (ret != OGRERR_NONE) goto done;
-    ret = create_field_map(poDefnMethod, &mapMethod);
-    if (ret != OGRERR_NONE) goto done;
-    ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
-    if (ret != OGRERR_NONE) goto done;
-    poDefnResult = pLayerResult->GetLayerDefn();
-    bEnvelopeSet = pLayerMethod->GetExtent(&sEnvelopeMethod, 1) == OGRERR_NONE;
-    if (bKeepLowerDimGeom) {
-        // require that the result layer is of geom type unknown
-        if (pLayerResult->GetGeomType() != wkbUnknown) {
-            CPLDebug("OGR", "Resetting KEEP_LOWER_DIMENSION_GEOMETRIES to NO since the result layer does not allow it.");
-            bKeepLowerDimGeom = FALSE;
+  public:
+    OGROverlayIndex() : m_poDefn(NULL), m_hQuadTree(NULL) {}
+    ~OGROverlayIndex();
+
+    OGRErr          Build( OGRLayer *poLayer );
+
+    OGRFeatureDefn *GetLayerDefn() const { return m_poDefn; }
+    const OGREnvelope &GetExtent() const { return m_sExtent; }
+    int             GetFeatureCount() const
+                        { return static_cast<int>(m_apoFeatures.size()); }
+    OGRFeature     *GetFeature( int i ) const { return m_apoFeatures[i]; }
+
+    void            Search( const OGREnvelope *psEnvelope,
+                            std::vector<int> &anIndices ) const;
+};
+
+OGROverlayIndex::~OGROverlayIndex()
+{
+    if( m_hQuadTree )
+        CPLQuadTreeDestroy(m_hQuadTree);
+    for( size_t i = 0; i < m_apoFeatures.size(); i++ )
+        delete m_apoFeatures[i];
+    if( m_poDefn )
+        m_poDefn->Release();
+}
+
+/************************************************************************/
+/*                       OGROverlayIndex::Build()                       */
+/*                                                                      */
+/*      Read all the features of poLayer that pass its current          */
+/*      filters.                                                        */
+/************************************************************************/
+
+OGRErr OGROverlayIndex::Build( OGRLayer *poLayer )
+{
+    m_poDefn = poLayer->GetLayerDefn();
+    m_poDefn->Reference();
+
+    std::vector<OGREnvelope> asEnvelopes;
+    OGREnvelope sTreeBounds;
+    poLayer->ResetReading();
+    while( OGRFeature *poFeature = poLayer->GetNextFeature() )
+    {
+        OGRGeometry *poGeom = poFeature->GetGeometryRef();
+        OGREnvelope sEnvelope;
+        if( poGeom )
+        {
+            poGeom->getEnvelope(&sEnvelope);
+            sTreeBounds.Merge(sEnvelope);
+            // Same as OGRLayer::GetExtent(), which skips empty geometries
+            if( !poGeom->IsEmpty() )
+                m_sExtent.Merge(sEnvelope);
+        }
+        else
+        {
+            m_anNoGeomFeatures.push_back(
+                static_cast<int>(m_apoFeatures.size()));
         }
+        m_apoFeatures.push_back(poFeature);
+        asEnvelopes.push_back(sEnvelope);
+    }
+    poLayer->ResetReading();
+    if( !sTreeBounds.IsInit() )
+        return CPLGetLastErrorType() == CE_Failure ? OGRERR_FAILURE : OGRERR_NONE;
+
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = sTreeBounds.MinX;
+    sGlobalBounds.miny = sTreeBounds.MinY;
+    sGlobalBounds.maxx = sTreeBounds.MaxX;
+    sGlobalBounds.maxy = sTreeBounds.MaxY;
+    m_hQuadTree = CPLQuadTreeCreate(&sGlobalBounds, NULL);
+    CPLQuadTreeSetMaxDepth(m_hQuadTree,
+        CPLQuadTreeGetAdvisedMaxDepth(GetFeatureCount()));
+    for( size_t i = 0; i < m_apoFeatures.size(); i++ )
+    {
+        if( m_apoFeatures[i]->GetGeometryRef() == NULL )
+            continue;
+        CPLRectObj sBounds;
+        sBounds.minx = asEnvelopes[i].MinX;
+        sBounds.miny = asEnvelopes[i].MinY;
+        sBounds.maxx = asEnvelopes[i].MaxX;
+        sBounds.maxy = asEnvelopes[i].MaxY;
+        CPLQuadTreeInsertWithBounds(m_hQuadTree,
+                                    reinterpret_cast<void*>(i),
+                                    &sBounds);
     }
 
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
+    return CPLGetLastErrorType() == CE_Failure ? OGRERR_FAILURE : OGRERR_NONE;
+}
 
-        if (pfnProgress) {
-            double p = progress_counter/progress_max;
-            if (p > progress_ticker) {
-                if (!pfnProgress(p, "", pProgressArg)) {
-                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
-                    ret = OGRERR_FAILURE;
-                    delete x;
-                    goto done;
-                }
-            }
-            progress_counter += 1.0;
-        }
+/************************************************************************/
+/*                       OGROverlayIndex::Search()                      */
+/*                                                                      */
+/*      Return, in reading order, the indices of the features whose     */
+/*      envelope intersects psEnvelope (all features if NULL), plus     */
+/*      the features without geometry, like OGRLayer::FilterGeometry()  */
+/*      would.                                                          */
+/************************************************************************/
 
-        // is it worth to proceed?
-        if (bEnvelopeSet) {
-            OGRGeometry *x_geom = x->GetGeometryRef();
-            if (x_geom) {
-                OGREnvelope x_env;
-                x_geom->getEnvelope(&x_env);
-                if (x_env.MaxX < sEnvelopeMethod.MinX
-                    || x_env.MaxY < sEnvelopeMethod.MinY
-                    || sEnvelopeMethod.MaxX < x_env.MinX
-                    || sEnvelopeMethod.MaxY < x_env.MinY) {
-                    delete x;
+void OGROverlayIndex::Search( const OGREnvelope *psEnvelope,
+                              std::vector<int> &anIndices ) const
+{
+    anIndices.clear();
+    if( psEnvelope == NULL )
+    {
+        anIndices.resize(m_apoFeatures.size());
+        for( size_t i = 0; i < m_apoFeatures.size(); i++ )
+            anIndices[i] = static_cast<int>(i);
+        return;
+    }
+
+    CPLRectObj sAoi;
+    sAoi.minx = psEnvelope->MinX;
+    sAoi.miny = psEnvelope->MinY;
+    sAoi.maxx = psEnvelope->MaxX;
+    sAoi.maxy = psEnvelope->MaxY;
+    int nCount = 0;
+    void **pahFeatures = m_hQuadTree ?
+        CPLQuadTreeSearch(m_hQuadTree, &sAoi, &nCount) : NULL;
+    anIndices.reserve(nCount + m_anNoGeomFeatures.size());
+    for( int i = 0; i < nCount; i++ )
+        anIndices.push_back(
+            static_cast<int>(reinterpret_cast<size_t>(pahFeatures[i])));
+    CPLFree(pahFeatures);
+    anIndices.insert(anIndices.end(), m_anNoGeomFeatures.begin(),
+                     m_anNoGeomFeatures.end());
+    std::sort(anIndices.begin(), anIndices.end());
+}
+
+/************************************************************************/
+/*                        OGROverlayIndexLayer                          */
+/*                                                                      */
+/*      Read-only layer over an OGROverlayIndex that honours spatial     */
+/*      filters like OGRLayer::FilterGeometry(), but with the prepared  */
+/*      geometries of the indexed features cached from one filter to    */
+/*      the next. Each thread must use its own instance.                */
+/************************************************************************/
+
+class OGROverlayIndexLayer : public OGRLayer
+{
+    const OGROverlayIndex              *m_poIndex;
+    std::vector<int>                    m_anCandidates;
+    bool                                m_bCandidatesValid;
+    size_t                              m_iNextCandidate;
+    std::vector<OGRPreparedGeometry*>   m_apoPreparedGeoms;
+
+    CPL_DISALLOW_COPY_ASSIGN(OGROverlayIndexLayer)
+
+    bool                MatchFilter( int iFeature );
+
+  public:
+    explicit OGROverlayIndexLayer( const OGROverlayIndex *poIndex );
+    virtual ~OGROverlayIndexLayer();
+
+    virtual void        ResetReading() override;
+    virtual OGRFeature *GetNextFeature() override;
+    virtual OGRFeatureDefn *GetLayerDefn() override
+                            { return m_poIndex->GetLayerDefn(); }
+    virtual OGRErr      GetExtent( OGREnvelope *psExtent,
+                                   int bForce = TRUE ) override;
+    virtual OGRErr      GetExtent( int iGeomField, OGREnvelope *psExtent,
+                                   int bForce ) override
+                { return OGRLayer::GetExtent(iGeomField, psExtent, bForce); }
+    virtual int         TestCapability( const char * ) override
+                            { return FALSE; }
+};
+
+OGROverlayIndexLayer::OGROverlayIndexLayer( const OGROverlayIndex *poIndex ) :
+    m_poIndex(poIndex),
+    m_bCandidatesValid(false),
+    m_iNextCandidate(0),
+    m_apoPreparedGeoms(poIndex->GetFeatureCount(),
+                       static_cast<OGRPreparedGeometry*>(NULL))
+{
+}
+
+OGROverlayIndexLayer::~OGROverlayIndexLayer()
+{
+    for( size_t i = 0; i < m_apoPreparedGeoms.size(); i++ )
+        OGRDestroyPreparedGeometry(m_apoPreparedGeoms[i]);
+}
+
+void OGROverlayIndexLayer::ResetReading()
+{
+    m_bCandidatesValid = false;
+    m_iNextCandidate = 0;
+}
+
+OGRErr OGROverlayIndexLayer::GetExtent( OGREnvelope *psExtent, int )
+{
+    if( !m_poIndex->GetExtent().IsInit() )
+        return OGRERR_FAILURE;
+    *psExtent = m_poIndex->GetExtent();
+    return OGRERR_NONE;
+}
+
+bool OGROverlayIndexLayer::MatchFilter( int iFeature )
+{
+    OGRGeometry *poGeom = m_poIndex->GetFeature(iFeature)->GetGeometryRef();
+    if( m_poFilterGeom == NULL || poGeom == NULL || m_bFilterIsEnvelope ||
+        !OGRHasPreparedGeometrySupport() )
+    {
+        return CPL_TO_BOOL(FilterGeometry(poGeom));
+    }
+
+    // Cheap envelope rejection first, as in FilterGeometry(), then the
+    // exact test with the cached prepared geometry of the indexed feature.
+    OGREnvelope sEnvelope;
+    poGeom->getEnvelope(&sEnvelope);
+    if( !sEnvelope.Intersects(m_sFilterEnvelope) )
+        return false;
+    if( m_apoPreparedGeoms[iFeature] == NULL )
+    {
+        m_apoPreparedGeoms[iFeature] = OGRCreatePreparedGeometry(poGeom);
+        if( m_apoPreparedGeoms[iFeature] == NULL )
+            return CPL_TO_BOOL(FilterGeometry(poGeom));
+    }
+    return CPL_TO_BOOL(OGRPreparedGeometryIntersects(
+                            m_apoPreparedGeoms[iFeature], m_poFilterGeom));
+}
+
+OGRFeature *OGROverlayIndexLayer::GetNextFeature()
+{
+    if( !m_bCandidatesValid )
+    {
+        m_poIndex->Search(m_poFilterGeom ? &m_sFilterEnvelope : NULL,
+                          m_anCandidates);
+        m_bCandidatesValid = true;
+        m_iNextCandidate = 0;
+    }
+
+    while( m_iNextCandidate < m_anCandidates.size() )
+    {
+        const int iFeature = m_anCandidates[m_iNextCandidate++];
+        if( MatchFilter(iFeature) )
+            return m_poIndex->GetFeature(iFeature)->Clone();
+    }
+    return NULL;
+}
+
+/************************************************************************/
+/*                         OGROverlayFeatureList                        */
+/*                                                                      */
+/*      Trivial layer over a list of features, used by the threaded     */
+/*      overlay mode both to feed a chunk of the input layer to a       */
+/*      worker, and to collect its results.                             */
+/************************************************************************/
+
+class OGROverlayFeatureList : public OGRLayer
+{
+    OGRFeatureDefn            *m_poDefn;
+    size_t                     m_iNextFeature;
+
+    CPL_DISALLOW_COPY_ASSIGN(OGROverlayFeatureList)
+
+  public:
+    std::vector<OGRFeature*>   m_apoFeatures;
+
+    explicit OGROverlayFeatureList( OGRFeatureDefn *poDefn ) :
+        m_poDefn(poDefn), m_iNextFeature(0) {}
+    virtual ~OGROverlayFeatureList() { Clear(); }
+
+    void                Clear();
+
+    virtual void        ResetReading() override { m_iNextFeature = 0; }
+    virtual OGRFeature *GetNextFeature() override;
+    virtual GIntBig     GetFeatureCount( int ) override
+                    { return static_cast<GIntBig>(m_apoFeatures.size()); }
+    virtual OGRFeatureDefn *GetLayerDefn() override { return m_poDefn; }
+    virtual OGRErr      ICreateFeature( OGRFeature *poFeature ) override
+                    { m_apoFeatures.push_back(poFeature->Clone());
+                      return OGRERR_NONE; }
+    virtual int         TestCapability( const char *pszCap ) override
+                    { return EQUAL(pszCap, OLCCurveGeometries) ||
+                             EQUAL(pszCap, OLCMeasuredGeometries); }
+};
+
+void OGROverlayFeatureList::Clear()
+{
+    for( size_t i = 0; i < m_apoFeatures.size(); i++ )
+        delete m_apoFeatures[i];
+    m_apoFeatures.clear();
+    m_iNextFeature = 0;
+}
+
+// Features are handed over to the caller, as a regular layer would do.
+OGRFeature *OGROverlayFeatureList::GetNextFeature()
+{
+    while( m_iNextFeature < m_apoFeatures.size() )
+    {
+        OGRFeature *poFeature = m_apoFeatures[m_iNextFeature];
+        m_apoFeatures[m_iNextFeature++] = NULL;
+        if( poFeature )
+            return poFeature;
+    }
+    return NULL;
+}
+
+/************************************************************************/
+/*                          OGROverlayParams                            */
+/************************************************************************/
+
+/* Settings of an overlay method that are shared by the loop over the   */
+/* features of the input layer, possibly from several threads. */
+
+typedef struct
+{
+    OGRFeatureDefn *poDefnResult;
+    int            *mapInput;
+    int            *mapMethod;
+    OGRGeometry    *pGeometryMethodFilter;
+    int             bSkipFailures;
+    int             bPromoteToMulti;
+    int             bUsePreparedGeometries;
+    int             bPretestContainment;
+    int             bKeepLowerDimGeom;
+} OGROverlayParams;
+
+typedef OGRErr (*OGROverlayLoopFunc)( OGRLayer *pLayerInput,
+                                      OGRLayer *pLayerMethod,
+                                      OGRLayer *pLayerResult,
+                                      const OGROverlayParams *psParams,
+                                      GDALProgressFunc pfnProgress,
+                                      void *pProgressArg );
+
+static
+OGRErr create_overlay_index(OGRLayer *pLayer, OGROverlayIndex **ppIndex)
+{
+    *ppIndex = new OGROverlayIndex();
+    CPLErrorReset();
+    OGRErr ret = (*ppIndex)->Build(pLayer);
+    CPLDebug("OGR", "Overlay index built on %d features of layer %s",
+             (*ppIndex)->GetFeatureCount(), pLayer->GetName());
+    return ret;
+}
+
+/************************************************************************/
+/*                        run_overlay_loop()                            */
+/*                                                                      */
+/*      Run pfnLoop on the features of pLayerInput. Without             */
+/*      poMethodIndex this is a plain call on the method layer.         */
+/*      Otherwise the method layer is replaced by views on the index    */
+/*      and, with more than one thread, chunks of input features are    */
+/*      processed concurrently, each worker collecting its results      */
+/*      in memory. Results are written in the order of the input        */
+/*      features, so that the output does not depend on the number     */
+/*      of threads.                                                     */
+/************************************************************************/
+
+typedef struct
+{
+    OGROverlayLoopFunc        pfnLoop;
+    const OGROverlayParams   *psParams;
+    OGROverlayFeatureList    *poInput;
+    OGROverlayFeatureList    *poResult;
+    std::vector<OGROverlayIndexLayer*> *papoFreeViews;
+    CPLMutex                **phMutex;
+    OGRErr                    eErr;
+} OGROverlayJob;
+
+static void overlay_job_func(void* pData)
+{
+    OGROverlayJob *psJob = static_cast<OGROverlayJob*>(pData);
+
+    OGROverlayIndexLayer *poView = NULL;
+    {
+        CPLMutexHolderD(psJob->phMutex);
+        poView = psJob->papoFreeViews->back();
+        psJob->papoFreeViews->pop_back();
+    }
+
+    CPLErrorReset();
+    psJob->eErr = psJob->pfnLoop(psJob->poInput, poView, psJob->poResult,
+                                 psJob->psParams, NULL, NULL);
+    poView->SetSpatialFilter(NULL);
+    psJob->poInput->Clear();
+
+    CPLMutexHolderD(psJob->phMutex);
+    psJob->papoFreeViews->push_back(poView);
+}
+
+static
+OGRErr run_overlay_loop(OGROverlayLoopFunc pfnLoop,
+                        OGRLayer *pLayerInput,
+                        OGRLayer *pLayerMethod,
+                        OGRLayer *pLayerResult,
+                        const OGROverlayParams *psParams,
+                        OGROverlayIndex *poMethodIndex,
+                        int nThreads,
+                        GDALProgressFunc pfnProgress,
+                        void *pProgressArg)
+{
+    if (poMethodIndex == NULL)
+        return pfnLoop(pLayerInput, pLayerMethod, pLayerResult, psParams,
+                       pfnProgress, pProgressArg);
+
+    CPLWorkerThreadPool oPool;
+    if (nThreads <= 1 || !oPool.Setup(nThreads, NULL, NULL)) {
+        OGROverlayIndexLayer oView(poMethodIndex);
+        return pfnLoop(pLayerInput, &oView, pLayerResult, psParams,
+                       pfnProgress, pProgressArg);
+    }
+    CPLDebug("OGR", "Using %d threads for overlay", nThreads);
+
+    OGRErr ret = OGRERR_NONE;
+    double progress_max = (double) pLayerInput->GetFeatureCount(0);
+    double progress_counter = 0;
+    const int nChunkSize = 64;
+    const int nJobs = 4 * nThreads;
+
+    CPLMutex *hMutex = NULL;
+    std::vector<OGROverlayIndexLayer*> apoViews;
+    for (int i = 0; i < nThreads; i++)
+        apoViews.push_back(new OGROverlayIndexLayer(poMethodIndex));
+    std::vector<OGROverlayIndexLayer*> apoFreeViews(apoViews);
+
+    std::vector<OGROverlayJob> asJobs(nJobs);
+    for (int i = 0; i < nJobs; i++) {
+        asJobs[i].pfnLoop = pfnLoop;
+        asJobs[i].psParams = psParams;
+        asJobs[i].poInput = new OGROverlayFeatureList(pLayerInput->GetLayerDefn());
+        asJobs[i].poResult = new OGROverlayFeatureList(psParams->poDefnResult);
+        asJobs[i].papoFreeViews = &apoFreeViews;
+        asJobs[i].phMutex = &hMutex;
+        asJobs[i].eErr = OGRERR_NONE;
+    }
+
+    // Read the input layer by batches of nJobs chunks, and wait for a
+    // batch to be processed before writing its results.
+    pLayerInput->ResetReading();
+    bool bEOF = false;
+    while (!bEOF && ret == OGRERR_NONE) {
+        std::vector<void*> apData;
+        for (int i = 0; i < nJobs && !bEOF; i++) {
+            OGROverlayJob *psJob = &asJobs[i];
+            while ((int)psJob->poInput->m_apoFeatures.size() < nChunkSize) {
+                OGRFeature *x = pLayerInput->GetNextFeature();
+                if (x == NULL) {
+                    bEOF = true;
+                    break;
+                }
+                psJob->poInput->m_apoFeatures.push_back(x);
+            }
+            if (!psJob->poInput->m_apoFeatures.empty()) {
+                progress_counter += (double) psJob->poInput->m_apoFeatures.size();
+                apData.push_back(psJob);
+            }
+        }
+        if (apData.empty())
+            break;
+
+        oPool.SubmitJobs(overlay_job_func, apData);
+        oPool.WaitCompletion();
+
+        for (size_t i = 0; i < apData.size(); i++) {
+            OGROverlayJob *psJob = static_cast<OGROverlayJob*>(apData[i]);
+            std::vector<OGRFeature*> &apoResults = psJob->poResult->m_apoFeatures;
+            for (size_t j = 0; j < apoResults.size(); j++) {
+                if (ret == OGRERR_NONE) {
+                    ret = pLayerResult->CreateFeature(apoResults[j]);
+                    if (ret != OGRERR_NONE && psParams->bSkipFailures) {
+                        CPLErrorReset();
+                        ret = OGRERR_NONE;
+                    }
+                }
+            }
+            psJob->poResult->Clear();
+            if (ret == OGRERR_NONE && psJob->eErr != OGRERR_NONE)
+                ret = psJob->eErr;
+        }
+
+        if (ret == OGRERR_NONE && pfnProgress &&
+            !pfnProgress(progress_max > 0 ? std::min(1.0, progress_counter/progress_max) : 0.0,
+                         "", pProgressArg)) {
+            CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+            ret = OGRERR_FAILURE;
+        }
+    }
+
+    for (int i = 0; i < nJobs; i++) {
+        delete asJobs[i].poInput;
+        delete asJobs[i].poResult;
+    }
+    for (size_t i = 0; i < apoViews.size(); i++)
+        delete apoViews[i];
+    if (hMutex)
+        CPLDestroyMutex(hMutex);
+
+    if (ret == OGRERR_NONE && pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
+        CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+        ret = OGRERR_FAILURE;
+    }
+    return ret;
+}
+
+/************************************************************************/
+/*                          intersection_loop()                           */
+/************************************************************************/
+
+static
+OGRErr intersection_loop(OGRLayer *pLayerInput,
+                         OGRLayer *pLayerMethod,
+                         OGRLayer *pLayerResult,
+                         const OGROverlayParams *psParams,
+                         GDALProgressFunc pfnProgress,
+                         void * pProgressArg)
+{
+    OGRErr ret = OGRERR_NONE;
+    OGRFeatureDefn *poDefnResult = psParams->poDefnResult;
+    OGRGeometry *pGeometryMethodFilter = psParams->pGeometryMethodFilter;
+    int *mapInput = psParams->mapInput;
+    int *mapMethod = psParams->mapMethod;
+    OGREnvelope sEnvelopeMethod;
+    GBool bEnvelopeSet = pLayerMethod->GetExtent(&sEnvelopeMethod, 1) == OGRERR_NONE;
+    double progress_max = (double) pLayerInput->GetFeatureCount(0);
+    double progress_counter = 0;
+    double progress_ticker = 0;
+    const int bSkipFailures = psParams->bSkipFailures;
+    const int bPromoteToMulti = psParams->bPromoteToMulti;
+    const int bUsePreparedGeometries = psParams->bUsePreparedGeometries;
+    const int bPretestContainment = psParams->bPretestContainment;
+    const int bKeepLowerDimGeom = psParams->bKeepLowerDimGeom;
+
+    pLayerInput->ResetReading();
+    while (OGRFeature *x = pLayerInput->GetNextFeature()) {
+
+        if (pfnProgress) {
+            double p = progress_counter/progress_max;
+            if (p > progress_ticker) {
+                if (!pfnProgress(p, "", pProgressArg)) {
+                    CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+                    ret = OGRERR_FAILURE;
+                    delete x;
+                    return ret;
+                }
+            }
+            progress_counter += 1.0;
+        }
+
+        // is it worth to proceed?
+        if (bEnvelopeSet) {
+            OGRGeometry *x_geom = x->GetGeometryRef();
+            if (x_geom) {
+                OGREnvelope x_env;
+                x_geom->getEnvelope(&x_env);
+                if (x_env.MaxX < sEnvelopeMethod.MinX
+                    || x_env.MaxY < sEnvelopeMethod.MinY
+                    || sEnvelopeMethod.MaxX < x_env.MinX
+                    || sEnvelopeMethod.MaxY < x_env.MinY) {
+                    delete x;
                     continue;
                 }
             } else {
@@ -2133,7 +2815,7 @@ OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
             if (!bSkipFailures) {
                 ret = OGRERR_FAILURE;
                 delete x;
-                goto done;
+                return ret;
             } else {
                 CPLErrorReset();
                 ret = OGRERR_NONE;
@@ -2149,7 +2831,7 @@ OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
             x_prepared_geom = OGRCreatePreparedGeometry(x_geom);
             if (!x_prepared_geom) {
                 delete x;
-                goto done;
+                return ret;
             }
         }
 
@@ -2180,7 +2862,7 @@ OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
                         ret = OGRERR_FAILURE;
                         OGRDestroyPreparedGeometry(x_prepared_geom);
                         delete x;
-                        goto done;
+                        return ret;
                     } else {
                         CPLErrorReset();
                         ret = OGRERR_NONE;
@@ -2198,7 +2880,7 @@ OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
                         ret = OGRERR_FAILURE;
                         OGRDestroyPreparedGeometry(x_prepared_geom);
                         delete x;
-                        goto done;
+                        return ret;
                     } else {
                         CPLErrorReset();
                         ret = OGRERR_NONE;
@@ -2228,7 +2910,7 @@ OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
                 if (!bSkipFailures) {
                     OGRDestroyPreparedGeometry(x_prepared_geom);
                     delete x;
-                    goto done;
+                    return ret;
                 } else {
                     CPLErrorReset();
                     ret = OGRERR_NONE;
@@ -2242,10 +2924,157 @@ OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
-      goto done;
+      return ret;
     }
+    return ret;
+}
+
+/************************************************************************/
+/*                          Intersection()                              */
+/************************************************************************/
+/**
+ * \brief Intersection of two layers.
+ *
+ * The result layer contains features whose geometries represent areas
+ * that are common between features in the input layer and in the
+ * method layer. The features in the result layer have attributes from
+ * both input and method layers. The schema of the result layer can be
+ * set by the user or, if it is empty, is initialized to contain all
+ * fields in the input and method layers.
+ *
+ * \note If the schema of the result is set by user and contains
+ * fields that have the same name as a field in input and in method
+ * layer, then the attribute in the result feature will get the value
+ * from the feature of the method layer.
+ *
+ * \note For best performance use the minimum amount of features in
+ * the method layer and copy it into a memory layer.
+ *
+ * \note This method relies on GEOS support. Do not use unless the
+ * GEOS support is compiled in.
+ *
+ * The recognized list of options is:
+ * <ul>
+ * <li>SKIP_FAILURES=YES/NO. Set to YES to go on, even when a
+ *     feature could not be inserted or a GEOS call failed.
+ * <li>PROMOTE_TO_MULTI=YES/NO. Set to YES to convert Polygons
+ *     into MultiPolygons, or LineStrings to MultiLineStrings.
+ * <li>INPUT_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the input layer.
+ * <li>METHOD_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer.
+ * <li>PRETEST_CONTAINMENT=YES/NO. Set to YES to pretest the
+ *     containment of features of method layer within the features of
+ *     this layer. This will speed up the method significantly in some
+ *     cases. Requires that the prepared geometries are in effect.
+ * <li>KEEP_LOWER_DIMENSION_GEOMETRIES=YES/NO. Set to NO to skip
+ *     result features with lower dimension geometry that would
+ *     otherwise be added to the result layer. The default is to add
+ *     but only if the result layer has an unknown geometry type.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to process
+ *     the features of this layer when USE_SPATIAL_INDEX=YES. The result
+ *     features are written in the same order as with a single thread.
+ *     Defaults to the value of the GDAL_NUM_THREADS configuration
+ *     option, or 1. (GDAL >= 2.3)
+ * </ul>
+ *
+ * This method is the same as the C function OGR_L_Intersection().
+ *
+ * @param pLayerMethod the method layer. Should not be NULL.
+ *
+ * @param pLayerResult the layer where the features resulting from the
+ * operation are inserted. Should not be NULL. See above the note
+ * about the schema.
+ *
+ * @param papszOptions NULL terminated list of options (may be NULL).
+ *
+ * @param pfnProgress a GDALProgressFunc() compatible callback function for
+ * reporting progress or NULL.
+ *
+ * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
+ *
+ * @return an error code if there was an error or the execution was
+ * interrupted, OGRERR_NONE otherwise.
+ *
+ * @note The first geometry field is always used.
+ *
+ * @since OGR 1.10
+ */
+
+OGRErr OGRLayer::Intersection( OGRLayer *pLayerMethod,
+                               OGRLayer *pLayerResult,
+                               char** papszOptions,
+                               GDALProgressFunc pfnProgress,
+                               void * pProgressArg )
+{
+    OGRErr ret = OGRERR_NONE;
+    OGRFeatureDefn *poDefnInput = GetLayerDefn();
+    OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
+    OGRFeatureDefn *poDefnResult = NULL;
+    OGRGeometry *pGeometryMethodFilter = NULL;
+    int *mapInput = NULL;
+    int *mapMethod = NULL;
+    OGROverlayIndex *poMethodIndex = NULL;
+    OGROverlayParams sParams;
+    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
+    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    int bUsePreparedGeometries = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES"));
+    if (bUsePreparedGeometries) bUsePreparedGeometries = OGRHasPreparedGeometrySupport();
+    int bPretestContainment = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PRETEST_CONTAINMENT", "NO"));
+    int bKeepLowerDimGeom = CPLTestBool(CSLFetchNameValueDef(papszOptions, "KEEP_LOWER_DIMENSION_GEOMETRIES", "YES"));
+    int bUseSpatialIndex = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_SPATIAL_INDEX", "NO"));
+    int nThreads = bUseSpatialIndex ? CPLGetNumThreads(papszOptions, "1") : 1;
+
+    // check for GEOS
+    if (!OGRGeometryFactory::haveGEOS()) {
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+
+    // get resources
+    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
+    if (ret != OGRERR_NONE) goto done;
+    ret = create_field_map(poDefnInput, &mapInput);
+    if (ret != OGRERR_NONE) goto done;
+    ret = create_field_map(poDefnMethod, &mapMethod);
+    if (ret != OGRERR_NONE) goto done;
+    ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
+    if (ret != OGRERR_NONE) goto done;
+    poDefnResult = pLayerResult->GetLayerDefn();
+    if (bKeepLowerDimGeom) {
+        // require that the result layer is of geom type unknown
+        if (pLayerResult->GetGeomType() != wkbUnknown) {
+            CPLDebug("OGR", "Resetting KEEP_LOWER_DIMENSION_GEOMETRIES to NO since the result layer does not allow it.");
+            bKeepLowerDimGeom = FALSE;
+        }
+    }
+    if (bUseSpatialIndex) {
+        ret = create_overlay_index(pLayerMethod, &poMethodIndex);
+        if (ret != OGRERR_NONE) goto done;
+    }
+
+    sParams.poDefnResult = poDefnResult;
+    sParams.mapInput = mapInput;
+    sParams.mapMethod = mapMethod;
+    sParams.pGeometryMethodFilter = pGeometryMethodFilter;
+    sParams.bSkipFailures = bSkipFailures;
+    sParams.bPromoteToMulti = bPromoteToMulti;
+    sParams.bUsePreparedGeometries = bUsePreparedGeometries;
+    sParams.bPretestContainment = bPretestContainment;
+    sParams.bKeepLowerDimGeom = bKeepLowerDimGeom;
+    ret = run_overlay_loop(intersection_loop, this, pLayerMethod, pLayerResult, &sParams,
+                           poMethodIndex, nThreads, pfnProgress, pProgressArg);
+
 done:
     // release resources
+    delete poMethodIndex;
     pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (mapInput) VSIFree(mapInput);
@@ -2298,6 +3127,16 @@ done:
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to process
+ *     the features of this layer when USE_SPATIAL_INDEX=YES. The result
+ *     features are written in the same order as with a single thread.
+ *     Defaults to the value of the GDAL_NUM_THREADS configuration
+ *     option, or 1. (GDAL >= 2.3)
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Intersection().
@@ -2384,6 +3223,13 @@ OGRErr OGR_L_Intersection( OGRLayerH pLayerInput,
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. The features
+ *     of this layer are also loaded in memory to process the areas
+ *     only covered by the method layer. Useful when the layers have no
+ *     efficient spatial filtering, at the cost of keeping them in
+ *     memory. (GDAL >= 2.3)
  * </ul>
  *
  * This method is the same as the C function OGR_L_Union().
@@ -2423,6 +3269,11 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
     OGRGeometry *pGeometryInputFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGRLayer *pLayerInput = this;
+    OGROverlayIndex *poMethodIndex = NULL;
+    OGROverlayIndex *poInputIndex = NULL;
+    OGROverlayIndexLayer *poMethodView = NULL;
+    OGROverlayIndexLayer *poInputView = NULL;
     double progress_max = (double) GetFeatureCount(0) + (double) pLayerMethod->GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
@@ -2431,6 +3282,7 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
     int bUsePreparedGeometries = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES"));
     if (bUsePreparedGeometries) bUsePreparedGeometries = OGRHasPreparedGeometrySupport();
     int bKeepLowerDimGeom = CPLTestBool(CSLFetchNameValueDef(papszOptions, "KEEP_LOWER_DIMENSION_GEOMETRIES", "YES"));
+    int bUseSpatialIndex = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_SPATIAL_INDEX", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -2456,6 +3308,13 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
             bKeepLowerDimGeom = FALSE;
         }
     }
+    if (bUseSpatialIndex) {
+        // read the method layer from memory from now on
+        ret = create_overlay_index(pLayerMethod, &poMethodIndex);
+        if (ret != OGRERR_NONE) goto done;
+        poMethodView = new OGROverlayIndexLayer(poMethodIndex);
+        pLayerMethod = poMethodView;
+    }
 
     // add features based on input layer
     ResetReading();
@@ -2629,6 +3488,12 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
     }
 
     // restore filter on method layer and add features based on it
+    if (bUseSpatialIndex) {
+        ret = create_overlay_index(this, &poInputIndex);
+        if (ret != OGRERR_NONE) goto done;
+        poInputView = new OGROverlayIndexLayer(poInputIndex);
+        pLayerInput = poInputView;
+    }
     pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     pLayerMethod->ResetReading();
     while (OGRFeature *x = pLayerMethod->GetNextFeature()) {
@@ -2648,7 +3513,7 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
 
         // set up the filter on input layer
         CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(this, pGeometryInputFilter, x);
+        OGRGeometry *x_geom = set_filter_from(pLayerInput, pGeometryInputFilter, x);
         if (CPLGetLastErrorType() != CE_None) {
             if (!bSkipFailures) {
                 ret = OGRERR_FAILURE;
@@ -2665,8 +3530,8 @@ OGRErr OGRLayer::Union( OGRLayer *pLayerMethod,
         }
 
         OGRGeometry *x_geom_diff = x_geom->clone(); // this will be the geometry of the result feature
-        ResetReading();
-        while (OGRFeature *y = GetNextFeature()) {
+        pLayerInput->ResetReading();
+        while (OGRFeature *y = pLayerInput->GetNextFeature()) {
             OGRGeometry *y_geom = y->GetGeometryRef();
             if (!y_geom) {delete y; continue;}
 
@@ -2731,6 +3596,10 @@ done:
     if (pGeometryInputFilter) delete pGeometryInputFilter;
     if (mapInput) VSIFree(mapInput);
     if (mapMethod) VSIFree(mapMethod);
+    delete poInputView;
+    delete poMethodView;
+    delete poInputIndex;
+    delete poMethodIndex;
     return ret;
 }
 
@@ -2778,6 +3647,13 @@ done:
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. The features
+ *     of this layer are also loaded in memory to process the areas
+ *     only covered by the method layer. Useful when the layers have no
+ *     efficient spatial filtering, at the cost of keeping them in
+ *     memory. (GDAL >= 2.3)
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Union().
@@ -2857,6 +3733,13 @@ OGRErr OGR_L_Union( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. The features
+ *     of this layer are also loaded in memory to process the areas
+ *     only covered by the method layer. Useful when the layers have no
+ *     efficient spatial filtering, at the cost of keeping them in
+ *     memory. (GDAL >= 2.3)
  * </ul>
  *
  * This method is the same as the C function OGR_L_SymDifference().
@@ -2896,11 +3779,17 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
     OGRGeometry *pGeometryInputFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGRLayer *pLayerInput = this;
+    OGROverlayIndex *poMethodIndex = NULL;
+    OGROverlayIndex *poInputIndex = NULL;
+    OGROverlayIndexLayer *poMethodView = NULL;
+    OGROverlayIndexLayer *poInputView = NULL;
     double progress_max = (double) GetFeatureCount(0) + (double) pLayerMethod->GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
     int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
     int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    int bUseSpatialIndex = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_SPATIAL_INDEX", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -2919,6 +3808,13 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
     ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
     if (ret != OGRERR_NONE) goto done;
     poDefnResult = pLayerResult->GetLayerDefn();
+    if (bUseSpatialIndex) {
+        // read the method layer from memory from now on
+        ret = create_overlay_index(pLayerMethod, &poMethodIndex);
+        if (ret != OGRERR_NONE) goto done;
+        poMethodView = new OGROverlayIndexLayer(poMethodIndex);
+        pLayerMethod = poMethodView;
+    }
 
     // add features based on input layer
     ResetReading();
@@ -3010,6 +3906,12 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
     }
 
     // restore filter on method layer and add features based on it
+    if (bUseSpatialIndex) {
+        ret = create_overlay_index(this, &poInputIndex);
+        if (ret != OGRERR_NONE) goto done;
+        poInputView = new OGROverlayIndexLayer(poInputIndex);
+        pLayerInput = poInputView;
+    }
     pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     pLayerMethod->ResetReading();
     while (OGRFeature *x = pLayerMethod->GetNextFeature()) {
@@ -3029,7 +3931,7 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
 
         // set up the filter on input layer
         CPLErrorReset();
-        OGRGeometry *x_geom = set_filter_from(this, pGeometryInputFilter, x);
+        OGRGeometry *x_geom = set_filter_from(pLayerInput, pGeometryInputFilter, x);
         if (CPLGetLastErrorType() != CE_None) {
             if (!bSkipFailures) {
                 ret = OGRERR_FAILURE;
@@ -3046,8 +3948,8 @@ OGRErr OGRLayer::SymDifference( OGRLayer *pLayerMethod,
         }
 
         OGRGeometry *geom = x_geom->clone(); // this will be the geometry of the result feature
-        ResetReading();
-        while (OGRFeature *y = GetNextFeature()) {
+        pLayerInput->ResetReading();
+        while (OGRFeature *y = pLayerInput->GetNextFeature()) {
             OGRGeometry *y_geom = y->GetGeometryRef();
             if (!y_geom) {delete y; continue;}
             if (geom) {
@@ -3111,6 +4013,10 @@ done:
     if (pGeometryInputFilter) delete pGeometryInputFilter;
     if (mapInput) VSIFree(mapInput);
     if (mapMethod) VSIFree(mapMethod);
+    delete poInputView;
+    delete poMethodView;
+    delete poInputIndex;
+    delete poMethodIndex;
     return ret;
 }
 
@@ -3145,99 +4051,24 @@ done:
  * <ul>
  * <li>SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a
  *     feature could not be inserted or a GEOS call failed.
- * <li>PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons
- *     into MultiPolygons, or LineStrings to MultiLineStrings.
- * <li>INPUT_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the input layer.
- * <li>METHOD_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the method layer.
- * </ul>
- *
- * This function is the same as the C++ method OGRLayer::SymDifference().
- *
- * @param pLayerInput the input layer. Should not be NULL.
- *
- * @param pLayerMethod the method layer. Should not be NULL.
- *
- * @param pLayerResult the layer where the features resulting from the
- * operation are inserted. Should not be NULL. See above the note
- * about the schema.
- *
- * @param papszOptions NULL terminated list of options (may be NULL).
- *
- * @param pfnProgress a GDALProgressFunc() compatible callback function for
- * reporting progress or NULL.
- *
- * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
- *
- * @return an error code if there was an error or the execution was
- * interrupted, OGRERR_NONE otherwise.
- *
- * @note The first geometry field is always used.
- *
- * @since OGR 1.10
- */
-
-OGRErr OGR_L_SymDifference( OGRLayerH pLayerInput,
-                            OGRLayerH pLayerMethod,
-                            OGRLayerH pLayerResult,
-                            char** papszOptions,
-                            GDALProgressFunc pfnProgress,
-                            void * pProgressArg )
-
-{
-    VALIDATE_POINTER1( pLayerInput, "OGR_L_SymDifference", OGRERR_INVALID_HANDLE );
-    VALIDATE_POINTER1( pLayerMethod, "OGR_L_SymDifference", OGRERR_INVALID_HANDLE );
-    VALIDATE_POINTER1( pLayerResult, "OGR_L_SymDifference", OGRERR_INVALID_HANDLE );
-
-    return ((OGRLayer *)pLayerInput)->SymDifference( (OGRLayer *)pLayerMethod, (OGRLayer *)pLayerResult, papszOptions, pfnProgress, pProgressArg );
-}
-
-/************************************************************************/
-/*                            Identity()                                */
-/************************************************************************/
-
-/**
- * \brief Identify the features of this layer with the ones from the
- * identity layer.
- *
- * The result layer contains features whose geometries represent areas
- * that are in the input layer. The features in the result layer have
- * attributes from both input and method layers. The schema of the
- * result layer can be set by the user or, if it is empty, is
- * initialized to contain all fields in input and method layers.
- *
- * \note If the schema of the result is set by user and contains
- * fields that have the same name as a field in input and in method
- * layer, then the attribute in the result feature will get the value
- * from the feature of the method layer (even if it is undefined).
- *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
- *
- * \note This method relies on GEOS support. Do not use unless the
- * GEOS support is compiled in.
- *
- * The recognized list of options is :
- * <ul>
- * <li>SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a
- *     feature could not be inserted or a GEOS call failed.
- * <li>PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons
- *     into MultiPolygons, or LineStrings to MultiLineStrings.
- * <li>INPUT_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the input layer.
- * <li>METHOD_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the method layer.
- * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
- *     geometries to pretest intersection of features of method layer
- *     with features of this layer.
- * <li>KEEP_LOWER_DIMENSION_GEOMETRIES=YES/NO. Set to NO to skip
- *     result features with lower dimension geometry that would
- *     otherwise be added to the result layer. The default is to add
- *     but only if the result layer has an unknown geometry type.
+ * <li>PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons
+ *     into MultiPolygons, or LineStrings to MultiLineStrings.
+ * <li>INPUT_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the input layer.
+ * <li>METHOD_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the method layer.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. The features
+ *     of this layer are also loaded in memory to process the areas
+ *     only covered by the method layer. Useful when the layers have no
+ *     efficient spatial filtering, at the cost of keeping them in
+ *     memory. (GDAL >= 2.3)
  * </ul>
  *
- * This method is the same as the C function OGR_L_Identity().
+ * This function is the same as the C++ method OGRLayer::SymDifference().
+ *
+ * @param pLayerInput the input layer. Should not be NULL.
  *
  * @param pLayerMethod the method layer. Should not be NULL.
  *
@@ -3260,54 +4091,48 @@ OGRErr OGR_L_SymDifference( OGRLayerH pLayerInput,
  * @since OGR 1.10
  */
 
-OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
-                           OGRLayer *pLayerResult,
-                           char** papszOptions,
-                           GDALProgressFunc pfnProgress,
-                           void * pProgressArg )
+OGRErr OGR_L_SymDifference( OGRLayerH pLayerInput,
+                            OGRLayerH pLayerMethod,
+                            OGRLayerH pLayerResult,
+                            char** papszOptions,
+                            GDALProgressFunc pfnProgress,
+                            void * pProgressArg )
+
+{
+    VALIDATE_POINTER1( pLayerInput, "OGR_L_SymDifference", OGRERR_INVALID_HANDLE );
+    VALIDATE_POINTER1( pLayerMethod, "OGR_L_SymDifference", OGRERR_INVALID_HANDLE );
+    VALIDATE_POINTER1( pLayerResult, "OGR_L_SymDifference", OGRERR_INVALID_HANDLE );
+
+    return ((OGRLayer *)pLayerInput)->SymDifference( (OGRLayer *)pLayerMethod, (OGRLayer *)pLayerResult, papszOptions, pfnProgress, pProgressArg );
+}
+
+/************************************************************************/
+/*                            identity_loop()                             */
+/************************************************************************/
+
+static
+OGRErr identity_loop(OGRLayer *pLayerInput,
+                     OGRLayer *pLayerMethod,
+                     OGRLayer *pLayerResult,
+                     const OGROverlayParams *psParams,
+                     GDALProgressFunc pfnProgress,
+                     void * pProgressArg)
 {
     OGRErr ret = OGRERR_NONE;
-    OGRFeatureDefn *poDefnInput = GetLayerDefn();
-    OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
-    OGRGeometry *pGeometryMethodFilter = NULL;
-    int *mapInput = NULL;
-    int *mapMethod = NULL;
-    double progress_max = (double) GetFeatureCount(0);
+    OGRFeatureDefn *poDefnResult = psParams->poDefnResult;
+    OGRGeometry *pGeometryMethodFilter = psParams->pGeometryMethodFilter;
+    int *mapInput = psParams->mapInput;
+    int *mapMethod = psParams->mapMethod;
+    double progress_max = (double) pLayerInput->GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
-    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
-    int bUsePreparedGeometries = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES"));
-    if (bUsePreparedGeometries) bUsePreparedGeometries = OGRHasPreparedGeometrySupport();
-    int bKeepLowerDimGeom = CPLTestBool(CSLFetchNameValueDef(papszOptions, "KEEP_LOWER_DIMENSION_GEOMETRIES", "YES"));
-
-    // check for GEOS
-    if (!OGRGeometryFactory::haveGEOS()) {
-        return OGRERR_UNSUPPORTED_OPERATION;
-    }
-    if (bKeepLowerDimGeom) {
-        // require that the result layer is of geom type unknown
-        if (pLayerResult->GetGeomType() != wkbUnknown) {
-            CPLDebug("OGR", "Resetting KEEP_LOWER_DIMENSION_GEOMETRIES to NO since the result layer does not allow it.");
-            bKeepLowerDimGeom = FALSE;
-        }
-    }
-
-    // get resources
-    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
-    if (ret != OGRERR_NONE) goto done;
-    ret = create_field_map(poDefnInput, &mapInput);
-    if (ret != OGRERR_NONE) goto done;
-    ret = create_field_map(poDefnMethod, &mapMethod);
-    if (ret != OGRERR_NONE) goto done;
-    ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
-    if (ret != OGRERR_NONE) goto done;
-    poDefnResult = pLayerResult->GetLayerDefn();
+    const int bSkipFailures = psParams->bSkipFailures;
+    const int bPromoteToMulti = psParams->bPromoteToMulti;
+    const int bUsePreparedGeometries = psParams->bUsePreparedGeometries;
+    const int bKeepLowerDimGeom = psParams->bKeepLowerDimGeom;
 
-    // split the features in input layer to the result layer
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
+    pLayerInput->ResetReading();
+    while (OGRFeature *x = pLayerInput->GetNextFeature()) {
 
         if (pfnProgress) {
             double p = progress_counter/progress_max;
@@ -3316,7 +4141,7 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
                     CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
                     ret = OGRERR_FAILURE;
                     delete x;
-                    goto done;
+                    return ret;
                 }
             }
             progress_counter += 1.0;
@@ -3329,7 +4154,7 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
             if (!bSkipFailures) {
                 ret = OGRERR_FAILURE;
                 delete x;
-                goto done;
+                return ret;
             } else {
                 CPLErrorReset();
                 ret = OGRERR_NONE;
@@ -3345,7 +4170,7 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
             x_prepared_geom = OGRCreatePreparedGeometry(x_geom);
             if (!x_prepared_geom) {
                 delete x;
-                goto done;
+                return ret;
             }
         }
 
@@ -3368,7 +4193,7 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
                     delete x;
                     delete x_geom_diff;
                     OGRDestroyPreparedGeometry(x_prepared_geom);
-                    goto done;
+                    return ret;
                 } else {
                     CPLErrorReset();
                     ret = OGRERR_NONE;
@@ -3385,7 +4210,7 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
                     delete x;
                     delete x_geom_diff;
                     OGRDestroyPreparedGeometry(x_prepared_geom);
-                    goto done;
+                    return ret;
                 } else {
                     CPLErrorReset();
                     ret = OGRERR_NONE;
@@ -3418,7 +4243,7 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
                             delete x;
                             delete x_geom_diff;
                             OGRDestroyPreparedGeometry(x_prepared_geom);
-                            goto done;
+                            return ret;
                         } else {
                             CPLErrorReset();
                         }
@@ -3435,7 +4260,7 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
                         delete x;
                         delete x_geom_diff;
                         OGRDestroyPreparedGeometry(x_prepared_geom);
-                        goto done;
+                        return ret;
                     } else {
                         CPLErrorReset();
                         ret = OGRERR_NONE;
@@ -3463,7 +4288,7 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
             delete z;
             if (ret != OGRERR_NONE) {
                 if (!bSkipFailures) {
-                    goto done;
+                    return ret;
                 } else {
                     CPLErrorReset();
                     ret = OGRERR_NONE;
@@ -3474,10 +4299,154 @@ OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
-      goto done;
+      return ret;
+    }
+    return ret;
+}
+
+/************************************************************************/
+/*                            Identity()                                */
+/************************************************************************/
+
+/**
+ * \brief Identify the features of this layer with the ones from the
+ * identity layer.
+ *
+ * The result layer contains features whose geometries represent areas
+ * that are in the input layer. The features in the result layer have
+ * attributes from both input and method layers. The schema of the
+ * result layer can be set by the user or, if it is empty, is
+ * initialized to contain all fields in input and method layers.
+ *
+ * \note If the schema of the result is set by user and contains
+ * fields that have the same name as a field in input and in method
+ * layer, then the attribute in the result feature will get the value
+ * from the feature of the method layer (even if it is undefined).
+ *
+ * \note For best performance use the minimum amount of features in
+ * the method layer and copy it into a memory layer.
+ *
+ * \note This method relies on GEOS support. Do not use unless the
+ * GEOS support is compiled in.
+ *
+ * The recognized list of options is :
+ * <ul>
+ * <li>SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a
+ *     feature could not be inserted or a GEOS call failed.
+ * <li>PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons
+ *     into MultiPolygons, or LineStrings to MultiLineStrings.
+ * <li>INPUT_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the input layer.
+ * <li>METHOD_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the method layer.
+ * <li>USE_PREPARED_GEOMETRIES=YES/NO. Set to NO to not use prepared
+ *     geometries to pretest intersection of features of method layer
+ *     with features of this layer.
+ * <li>KEEP_LOWER_DIMENSION_GEOMETRIES=YES/NO. Set to NO to skip
+ *     result features with lower dimension geometry that would
+ *     otherwise be added to the result layer. The default is to add
+ *     but only if the result layer has an unknown geometry type.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to process
+ *     the features of this layer when USE_SPATIAL_INDEX=YES. The result
+ *     features are written in the same order as with a single thread.
+ *     Defaults to the value of the GDAL_NUM_THREADS configuration
+ *     option, or 1. (GDAL >= 2.3)
+ * </ul>
+ *
+ * This method is the same as the C function OGR_L_Identity().
+ *
+ * @param pLayerMethod the method layer. Should not be NULL.
+ *
+ * @param pLayerResult the layer where the features resulting from the
+ * operation are inserted. Should not be NULL. See above the note
+ * about the schema.
+ *
+ * @param papszOptions NULL terminated list of options (may be NULL).
+ *
+ * @param pfnProgress a GDALProgressFunc() compatible callback function for
+ * reporting progress or NULL.
+ *
+ * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
+ *
+ * @return an error code if there was an error or the execution was
+ * interrupted, OGRERR_NONE otherwise.
+ *
+ * @note The first geometry field is always used.
+ *
+ * @since OGR 1.10
+ */
+
+OGRErr OGRLayer::Identity( OGRLayer *pLayerMethod,
+                           OGRLayer *pLayerResult,
+                           char** papszOptions,
+                           GDALProgressFunc pfnProgress,
+                           void * pProgressArg )
+{
+    OGRErr ret = OGRERR_NONE;
+    OGRFeatureDefn *poDefnInput = GetLayerDefn();
+    OGRFeatureDefn *poDefnMethod = pLayerMethod->GetLayerDefn();
+    OGRFeatureDefn *poDefnResult = NULL;
+    OGRGeometry *pGeometryMethodFilter = NULL;
+    int *mapInput = NULL;
+    int *mapMethod = NULL;
+    OGROverlayIndex *poMethodIndex = NULL;
+    OGROverlayParams sParams;
+    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
+    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    int bUsePreparedGeometries = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_PREPARED_GEOMETRIES", "YES"));
+    if (bUsePreparedGeometries) bUsePreparedGeometries = OGRHasPreparedGeometrySupport();
+    int bKeepLowerDimGeom = CPLTestBool(CSLFetchNameValueDef(papszOptions, "KEEP_LOWER_DIMENSION_GEOMETRIES", "YES"));
+    int bUseSpatialIndex = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_SPATIAL_INDEX", "NO"));
+    int nThreads = bUseSpatialIndex ? CPLGetNumThreads(papszOptions, "1") : 1;
+
+    // check for GEOS
+    if (!OGRGeometryFactory::haveGEOS()) {
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+    if (bKeepLowerDimGeom) {
+        // require that the result layer is of geom type unknown
+        if (pLayerResult->GetGeomType() != wkbUnknown) {
+            CPLDebug("OGR", "Resetting KEEP_LOWER_DIMENSION_GEOMETRIES to NO since the result layer does not allow it.");
+            bKeepLowerDimGeom = FALSE;
+        }
+    }
+
+    // get resources
+    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
+    if (ret != OGRERR_NONE) goto done;
+    ret = create_field_map(poDefnInput, &mapInput);
+    if (ret != OGRERR_NONE) goto done;
+    ret = create_field_map(poDefnMethod, &mapMethod);
+    if (ret != OGRERR_NONE) goto done;
+    ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 1, papszOptions);
+    if (ret != OGRERR_NONE) goto done;
+    poDefnResult = pLayerResult->GetLayerDefn();
+    if (bUseSpatialIndex) {
+        ret = create_overlay_index(pLayerMethod, &poMethodIndex);
+        if (ret != OGRERR_NONE) goto done;
     }
+
+    // split the features in input layer to the result layer
+    sParams.poDefnResult = poDefnResult;
+    sParams.mapInput = mapInput;
+    sParams.mapMethod = mapMethod;
+    sParams.pGeometryMethodFilter = pGeometryMethodFilter;
+    sParams.bSkipFailures = bSkipFailures;
+    sParams.bPromoteToMulti = bPromoteToMulti;
+    sParams.bUsePreparedGeometries = bUsePreparedGeometries;
+    sParams.bPretestContainment = FALSE;
+    sParams.bKeepLowerDimGeom = bKeepLowerDimGeom;
+    ret = run_overlay_loop(identity_loop, this, pLayerMethod, pLayerResult, &sParams,
+                           poMethodIndex, nThreads, pfnProgress, pProgressArg);
+
 done:
     // release resources
+    delete poMethodIndex;
     pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (mapInput) VSIFree(mapInput);
@@ -3527,6 +4496,16 @@ done:
  *     result features with lower dimension geometry that would
  *     otherwise be added to the result layer. The default is to add
  *     but only if the result layer has an unknown geometry type.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to process
+ *     the features of this layer when USE_SPATIAL_INDEX=YES. The result
+ *     features are written in the same order as with a single thread.
+ *     Defaults to the value of the GDAL_NUM_THREADS configuration
+ *     option, or 1. (GDAL >= 2.3)
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Identity().
@@ -3606,6 +4585,11 @@ OGRErr OGR_L_Identity( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
  * </ul>
  *
  * This method is the same as the C function OGR_L_Update().
@@ -3644,11 +4628,14 @@ OGRErr OGRLayer::Update( OGRLayer *pLayerMethod,
     OGRGeometry *pGeometryMethodFilter = NULL;
     int *mapInput = NULL;
     int *mapMethod = NULL;
+    OGROverlayIndex *poMethodIndex = NULL;
+    OGROverlayIndexLayer *poMethodView = NULL;
     double progress_max = (double) GetFeatureCount(0) + (double) pLayerMethod->GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
     int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
     int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    int bUseSpatialIndex = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_SPATIAL_INDEX", "NO"));
 
     // check for GEOS
     if (!OGRGeometryFactory::haveGEOS()) {
@@ -3665,6 +4652,13 @@ OGRErr OGRLayer::Update( OGRLayer *pLayerMethod,
     ret = set_result_schema(pLayerResult, poDefnInput, poDefnMethod, mapInput, mapMethod, 0, papszOptions);
     if (ret != OGRERR_NONE) goto done;
     poDefnResult = pLayerResult->GetLayerDefn();
+    if (bUseSpatialIndex) {
+        // read the method layer from memory from now on
+        ret = create_overlay_index(pLayerMethod, &poMethodIndex);
+        if (ret != OGRERR_NONE) goto done;
+        poMethodView = new OGROverlayIndexLayer(poMethodIndex);
+        pLayerMethod = poMethodView;
+    }
 
     // add clipped features from the input layer
     ResetReading();
@@ -3801,6 +4795,8 @@ done:
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (mapInput) VSIFree(mapInput);
     if (mapMethod) VSIFree(mapMethod);
+    delete poMethodView;
+    delete poMethodIndex;
     return ret;
 }
 
@@ -3841,6 +4837,11 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Update().
@@ -3883,93 +4884,30 @@ OGRErr OGR_L_Update( OGRLayerH pLayerInput,
     return ((OGRLayer *)pLayerInput)->Update( (OGRLayer *)pLayerMethod, (OGRLayer *)pLayerResult, papszOptions, pfnProgress, pProgressArg );
 }
 
-/************************************************************************/
-/*                              Clip()                                  */
-/************************************************************************/
-
-/**
- * \brief Clip off areas that are not covered by the method layer.
- *
- * The result layer contains features whose geometries represent areas
- * that are in the input layer and in the method layer. The features
- * in the result layer have the (possibly clipped) areas of features
- * in the input layer and the attributes from the same features. The
- * schema of the result layer can be set by the user or, if it is
- * empty, is initialized to contain all fields in the input layer.
- *
- * \note For best performance use the minimum amount of features in
- * the method layer and copy it into a memory layer.
- *
- * \note This method relies on GEOS support. Do not use unless the
- * GEOS support is compiled in.
- *
- * The recognized list of options is :
- * <ul>
- * <li>SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a
- *     feature could not be inserted or a GEOS call failed.
- * <li>PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons
- *     into MultiPolygons, or LineStrings to MultiLineStrings.
- * <li>INPUT_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the input layer.
- * <li>METHOD_PREFIX=string. Set a prefix for the field names that
- *     will be created from the fields of the method layer.
- * </ul>
- *
- * This method is the same as the C function OGR_L_Clip().
- *
- * @param pLayerMethod the method layer. Should not be NULL.
- *
- * @param pLayerResult the layer where the features resulting from the
- * operation are inserted. Should not be NULL. See above the note
- * about the schema.
- *
- * @param papszOptions NULL terminated list of options (may be NULL).
- *
- * @param pfnProgress a GDALProgressFunc() compatible callback function for
- * reporting progress or NULL.
- *
- * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
- *
- * @return an error code if there was an error or the execution was
- * interrupted, OGRERR_NONE otherwise.
- *
- * @note The first geometry field is always used.
- *
- * @since OGR 1.10
- */
-
-OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
-                       OGRLayer *pLayerResult,
-                       char** papszOptions,
-                       GDALProgressFunc pfnProgress,
-                       void * pProgressArg )
+/************************************************************************/
+/*                              clip_loop()                               */
+/************************************************************************/
+
+static
+OGRErr clip_loop(OGRLayer *pLayerInput,
+                 OGRLayer *pLayerMethod,
+                 OGRLayer *pLayerResult,
+                 const OGROverlayParams *psParams,
+                 GDALProgressFunc pfnProgress,
+                 void * pProgressArg)
 {
     OGRErr ret = OGRERR_NONE;
-    OGRFeatureDefn *poDefnInput = GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
-    OGRGeometry *pGeometryMethodFilter = NULL;
-    int *mapInput = NULL;
-    double progress_max = (double) GetFeatureCount(0);
+    OGRFeatureDefn *poDefnResult = psParams->poDefnResult;
+    OGRGeometry *pGeometryMethodFilter = psParams->pGeometryMethodFilter;
+    int *mapInput = psParams->mapInput;
+    double progress_max = (double) pLayerInput->GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
-    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
-
-    // check for GEOS
-    if (!OGRGeometryFactory::haveGEOS()) {
-        return OGRERR_UNSUPPORTED_OPERATION;
-    }
-
-    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
-    if (ret != OGRERR_NONE) goto done;
-    ret = create_field_map(poDefnInput, &mapInput);
-    if (ret != OGRERR_NONE) goto done;
-    ret = set_result_schema(pLayerResult, poDefnInput, NULL, mapInput, NULL, 0, papszOptions);
-    if (ret != OGRERR_NONE) goto done;
+    const int bSkipFailures = psParams->bSkipFailures;
+    const int bPromoteToMulti = psParams->bPromoteToMulti;
 
-    poDefnResult = pLayerResult->GetLayerDefn();
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
+    pLayerInput->ResetReading();
+    while (OGRFeature *x = pLayerInput->GetNextFeature()) {
 
         if (pfnProgress) {
             double p = progress_counter/progress_max;
@@ -3978,7 +4916,7 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
                     CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
                     ret = OGRERR_FAILURE;
                     delete x;
-                    goto done;
+                    return ret;
                 }
             }
             progress_counter += 1.0;
@@ -3991,7 +4929,7 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
             if (!bSkipFailures) {
                 ret = OGRERR_FAILURE;
                 delete x;
-                goto done;
+                return ret;
             } else {
                 CPLErrorReset();
                 ret = OGRERR_NONE;
@@ -4020,7 +4958,7 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
                         delete y;
                         delete x;
                         delete geom;
-                        goto done;
+                        return ret;
                     } else {
                         CPLErrorReset();
                         ret = OGRERR_NONE;
@@ -4043,7 +4981,7 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
                     ret = OGRERR_FAILURE;
                     delete geom;
                     delete x;
-                    goto done;
+                    return ret;
                 } else {
                     CPLErrorReset();
                     ret = OGRERR_NONE;
@@ -4060,7 +4998,7 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
                 delete z;
                 if (ret != OGRERR_NONE) {
                     if (!bSkipFailures) {
-                        goto done;
+                        return ret;
                     } else {
                         CPLErrorReset();
                         ret = OGRERR_NONE;
@@ -4076,18 +5014,13 @@ OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
-      goto done;
+      return ret;
     }
-done:
-    // release resources
-    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
-    if (pGeometryMethodFilter) delete pGeometryMethodFilter;
-    if (mapInput) VSIFree(mapInput);
     return ret;
 }
 
 /************************************************************************/
-/*                           OGR_L_Clip()                               */
+/*                              Clip()                                  */
 /************************************************************************/
 
 /**
@@ -4116,11 +5049,19 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to process
+ *     the features of this layer when USE_SPATIAL_INDEX=YES. The result
+ *     features are written in the same order as with a single thread.
+ *     Defaults to the value of the GDAL_NUM_THREADS configuration
+ *     option, or 1. (GDAL >= 2.3)
  * </ul>
  *
- * This function is the same as the C++ method OGRLayer::Clip().
- *
- * @param pLayerInput the input layer. Should not be NULL.
+ * This method is the same as the C function OGR_L_Clip().
  *
  * @param pLayerMethod the method layer. Should not be NULL.
  *
@@ -4143,34 +5084,77 @@ done:
  * @since OGR 1.10
  */
 
-OGRErr OGR_L_Clip( OGRLayerH pLayerInput,
-                   OGRLayerH pLayerMethod,
-                   OGRLayerH pLayerResult,
-                   char** papszOptions,
-                   GDALProgressFunc pfnProgress,
-                   void * pProgressArg )
-
+OGRErr OGRLayer::Clip( OGRLayer *pLayerMethod,
+                       OGRLayer *pLayerResult,
+                       char** papszOptions,
+                       GDALProgressFunc pfnProgress,
+                       void * pProgressArg )
 {
-    VALIDATE_POINTER1( pLayerInput, "OGR_L_Clip", OGRERR_INVALID_HANDLE );
-    VALIDATE_POINTER1( pLayerMethod, "OGR_L_Clip", OGRERR_INVALID_HANDLE );
-    VALIDATE_POINTER1( pLayerResult, "OGR_L_Clip", OGRERR_INVALID_HANDLE );
+    OGRErr ret = OGRERR_NONE;
+    OGRFeatureDefn *poDefnInput = GetLayerDefn();
+    OGRFeatureDefn *poDefnResult = NULL;
+    OGRGeometry *pGeometryMethodFilter = NULL;
+    int *mapInput = NULL;
+    OGROverlayIndex *poMethodIndex = NULL;
+    OGROverlayParams sParams;
+    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
+    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    int bUseSpatialIndex = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_SPATIAL_INDEX", "NO"));
+    int nThreads = bUseSpatialIndex ? CPLGetNumThreads(papszOptions, "1") : 1;
 
-    return ((OGRLayer *)pLayerInput)->Clip( (OGRLayer *)pLayerMethod, (OGRLayer *)pLayerResult, papszOptions, pfnProgress, pProgressArg );
+    // check for GEOS
+    if (!OGRGeometryFactory::haveGEOS()) {
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+
+    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
+    if (ret != OGRERR_NONE) goto done;
+    ret = create_field_map(poDefnInput, &mapInput);
+    if (ret != OGRERR_NONE) goto done;
+    ret = set_result_schema(pLayerResult, poDefnInput, NULL, mapInput, NULL, 0, papszOptions);
+    if (ret != OGRERR_NONE) goto done;
+
+    poDefnResult = pLayerResult->GetLayerDefn();
+
+    if (bUseSpatialIndex) {
+        ret = create_overlay_index(pLayerMethod, &poMethodIndex);
+        if (ret != OGRERR_NONE) goto done;
+    }
+
+    sParams.poDefnResult = poDefnResult;
+    sParams.mapInput = mapInput;
+    sParams.mapMethod = NULL;
+    sParams.pGeometryMethodFilter = pGeometryMethodFilter;
+    sParams.bSkipFailures = bSkipFailures;
+    sParams.bPromoteToMulti = bPromoteToMulti;
+    sParams.bUsePreparedGeometries = FALSE;
+    sParams.bPretestContainment = FALSE;
+    sParams.bKeepLowerDimGeom = FALSE;
+    ret = run_overlay_loop(clip_loop, this, pLayerMethod, pLayerResult, &sParams,
+                           poMethodIndex, nThreads, pfnProgress, pProgressArg);
+
+done:
+    // release resources
+    delete poMethodIndex;
+    pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
+    if (pGeometryMethodFilter) delete pGeometryMethodFilter;
+    if (mapInput) VSIFree(mapInput);
+    return ret;
 }
 
 /************************************************************************/
-/*                              Erase()                                 */
+/*                           OGR_L_Clip()                               */
 /************************************************************************/
 
 /**
- * \brief Remove areas that are covered by the method layer.
+ * \brief Clip off areas that are not covered by the method layer.
  *
  * The result layer contains features whose geometries represent areas
- * that are in the input layer but not in the method layer. The
- * features in the result layer have attributes from the input
- * layer. The schema of the result layer can be set by the user or, if
- * it is empty, is initialized to contain all fields in the input
- * layer.
+ * that are in the input layer and in the method layer. The features
+ * in the result layer have the (possibly clipped) areas of features
+ * in the input layer and the attributes from the same features. The
+ * schema of the result layer can be set by the user or, if it is
+ * empty, is initialized to contain all fields in the input layer.
  *
  * \note For best performance use the minimum amount of features in
  * the method layer and copy it into a memory layer.
@@ -4188,9 +5172,21 @@ OGRErr OGR_L_Clip( OGRLayerH pLayerInput,
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to process
+ *     the features of this layer when USE_SPATIAL_INDEX=YES. The result
+ *     features are written in the same order as with a single thread.
+ *     Defaults to the value of the GDAL_NUM_THREADS configuration
+ *     option, or 1. (GDAL >= 2.3)
  * </ul>
  *
- * This method is the same as the C function OGR_L_Erase().
+ * This function is the same as the C++ method OGRLayer::Clip().
+ *
+ * @param pLayerInput the input layer. Should not be NULL.
  *
  * @param pLayerMethod the method layer. Should not be NULL.
  *
@@ -4213,39 +5209,45 @@ OGRErr OGR_L_Clip( OGRLayerH pLayerInput,
  * @since OGR 1.10
  */
 
-OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
-                        OGRLayer *pLayerResult,
-                        char** papszOptions,
-                        GDALProgressFunc pfnProgress,
-                        void * pProgressArg )
+OGRErr OGR_L_Clip( OGRLayerH pLayerInput,
+                   OGRLayerH pLayerMethod,
+                   OGRLayerH pLayerResult,
+                   char** papszOptions,
+                   GDALProgressFunc pfnProgress,
+                   void * pProgressArg )
+
+{
+    VALIDATE_POINTER1( pLayerInput, "OGR_L_Clip", OGRERR_INVALID_HANDLE );
+    VALIDATE_POINTER1( pLayerMethod, "OGR_L_Clip", OGRERR_INVALID_HANDLE );
+    VALIDATE_POINTER1( pLayerResult, "OGR_L_Clip", OGRERR_INVALID_HANDLE );
+
+    return ((OGRLayer *)pLayerInput)->Clip( (OGRLayer *)pLayerMethod, (OGRLayer *)pLayerResult, papszOptions, pfnProgress, pProgressArg );
+}
+
+/************************************************************************/
+/*                              erase_loop()                              */
+/************************************************************************/
+
+static
+OGRErr erase_loop(OGRLayer *pLayerInput,
+                  OGRLayer *pLayerMethod,
+                  OGRLayer *pLayerResult,
+                  const OGROverlayParams *psParams,
+                  GDALProgressFunc pfnProgress,
+                  void * pProgressArg)
 {
     OGRErr ret = OGRERR_NONE;
-    OGRFeatureDefn *poDefnInput = GetLayerDefn();
-    OGRFeatureDefn *poDefnResult = NULL;
-    OGRGeometry *pGeometryMethodFilter = NULL;
-    int *mapInput = NULL;
-    double progress_max = (double) GetFeatureCount(0);
+    OGRFeatureDefn *poDefnResult = psParams->poDefnResult;
+    OGRGeometry *pGeometryMethodFilter = psParams->pGeometryMethodFilter;
+    int *mapInput = psParams->mapInput;
+    double progress_max = (double) pLayerInput->GetFeatureCount(0);
     double progress_counter = 0;
     double progress_ticker = 0;
-    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
-    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
-
-    // check for GEOS
-    if (!OGRGeometryFactory::haveGEOS()) {
-        return OGRERR_UNSUPPORTED_OPERATION;
-    }
-
-    // get resources
-    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
-    if (ret != OGRERR_NONE) goto done;
-    ret = create_field_map(poDefnInput, &mapInput);
-    if (ret != OGRERR_NONE) goto done;
-    ret = set_result_schema(pLayerResult, poDefnInput, NULL, mapInput, NULL, 0, papszOptions);
-    if (ret != OGRERR_NONE) goto done;
-    poDefnResult = pLayerResult->GetLayerDefn();
+    const int bSkipFailures = psParams->bSkipFailures;
+    const int bPromoteToMulti = psParams->bPromoteToMulti;
 
-    ResetReading();
-    while (OGRFeature *x = GetNextFeature()) {
+    pLayerInput->ResetReading();
+    while (OGRFeature *x = pLayerInput->GetNextFeature()) {
 
         if (pfnProgress) {
             double p = progress_counter/progress_max;
@@ -4254,7 +5256,7 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
                     CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
                     ret = OGRERR_FAILURE;
                     delete x;
-                    goto done;
+                    return ret;
                 }
             }
             progress_counter += 1.0;
@@ -4267,7 +5269,7 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
             if (!bSkipFailures) {
                 ret = OGRERR_FAILURE;
                 delete x;
-                goto done;
+                return ret;
             } else {
                 CPLErrorReset();
                 ret = OGRERR_NONE;
@@ -4292,7 +5294,7 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
                     ret = OGRERR_FAILURE;
                     delete x;
                     delete y;
-                    goto done;
+                    return ret;
                 } else {
                     CPLErrorReset();
                     ret = OGRERR_NONE;
@@ -4321,7 +5323,7 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
             if (ret != OGRERR_NONE) {
                 if (!bSkipFailures) {
                     delete x;
-                    goto done;
+                    return ret;
                 } else {
                     CPLErrorReset();
                     ret = OGRERR_NONE;
@@ -4337,10 +5339,128 @@ OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
     if (pfnProgress && !pfnProgress(1.0, "", pProgressArg)) {
       CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
       ret = OGRERR_FAILURE;
-      goto done;
+      return ret;
+    }
+    return ret;
+}
+
+/************************************************************************/
+/*                              Erase()                                 */
+/************************************************************************/
+
+/**
+ * \brief Remove areas that are covered by the method layer.
+ *
+ * The result layer contains features whose geometries represent areas
+ * that are in the input layer but not in the method layer. The
+ * features in the result layer have attributes from the input
+ * layer. The schema of the result layer can be set by the user or, if
+ * it is empty, is initialized to contain all fields in the input
+ * layer.
+ *
+ * \note For best performance use the minimum amount of features in
+ * the method layer and copy it into a memory layer.
+ *
+ * \note This method relies on GEOS support. Do not use unless the
+ * GEOS support is compiled in.
+ *
+ * The recognized list of options is :
+ * <ul>
+ * <li>SKIP_FAILURES=YES/NO. Set it to YES to go on, even when a
+ *     feature could not be inserted or a GEOS call failed.
+ * <li>PROMOTE_TO_MULTI=YES/NO. Set it to YES to convert Polygons
+ *     into MultiPolygons, or LineStrings to MultiLineStrings.
+ * <li>INPUT_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the input layer.
+ * <li>METHOD_PREFIX=string. Set a prefix for the field names that
+ *     will be created from the fields of the method layer.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to process
+ *     the features of this layer when USE_SPATIAL_INDEX=YES. The result
+ *     features are written in the same order as with a single thread.
+ *     Defaults to the value of the GDAL_NUM_THREADS configuration
+ *     option, or 1. (GDAL >= 2.3)
+ * </ul>
+ *
+ * This method is the same as the C function OGR_L_Erase().
+ *
+ * @param pLayerMethod the method layer. Should not be NULL.
+ *
+ * @param pLayerResult the layer where the features resulting from the
+ * operation are inserted. Should not be NULL. See above the note
+ * about the schema.
+ *
+ * @param papszOptions NULL terminated list of options (may be NULL).
+ *
+ * @param pfnProgress a GDALProgressFunc() compatible callback function for
+ * reporting progress or NULL.
+ *
+ * @param pProgressArg argument to be passed to pfnProgress. May be NULL.
+ *
+ * @return an error code if there was an error or the execution was
+ * interrupted, OGRERR_NONE otherwise.
+ *
+ * @note The first geometry field is always used.
+ *
+ * @since OGR 1.10
+ */
+
+OGRErr OGRLayer::Erase( OGRLayer *pLayerMethod,
+                        OGRLayer *pLayerResult,
+                        char** papszOptions,
+                        GDALProgressFunc pfnProgress,
+                        void * pProgressArg )
+{
+    OGRErr ret = OGRERR_NONE;
+    OGRFeatureDefn *poDefnInput = GetLayerDefn();
+    OGRFeatureDefn *poDefnResult = NULL;
+    OGRGeometry *pGeometryMethodFilter = NULL;
+    int *mapInput = NULL;
+    OGROverlayIndex *poMethodIndex = NULL;
+    OGROverlayParams sParams;
+    int bSkipFailures = CPLTestBool(CSLFetchNameValueDef(papszOptions, "SKIP_FAILURES", "NO"));
+    int bPromoteToMulti = CPLTestBool(CSLFetchNameValueDef(papszOptions, "PROMOTE_TO_MULTI", "NO"));
+    int bUseSpatialIndex = CPLTestBool(CSLFetchNameValueDef(papszOptions, "USE_SPATIAL_INDEX", "NO"));
+    int nThreads = bUseSpatialIndex ? CPLGetNumThreads(papszOptions, "1") : 1;
+
+    // check for GEOS
+    if (!OGRGeometryFactory::haveGEOS()) {
+        return OGRERR_UNSUPPORTED_OPERATION;
+    }
+
+    // get resources
+    ret = clone_spatial_filter(pLayerMethod, &pGeometryMethodFilter);
+    if (ret != OGRERR_NONE) goto done;
+    ret = create_field_map(poDefnInput, &mapInput);
+    if (ret != OGRERR_NONE) goto done;
+    ret = set_result_schema(pLayerResult, poDefnInput, NULL, mapInput, NULL, 0, papszOptions);
+    if (ret != OGRERR_NONE) goto done;
+    poDefnResult = pLayerResult->GetLayerDefn();
+
+    if (bUseSpatialIndex) {
+        ret = create_overlay_index(pLayerMethod, &poMethodIndex);
+        if (ret != OGRERR_NONE) goto done;
     }
+
+    sParams.poDefnResult = poDefnResult;
+    sParams.mapInput = mapInput;
+    sParams.mapMethod = NULL;
+    sParams.pGeometryMethodFilter = pGeometryMethodFilter;
+    sParams.bSkipFailures = bSkipFailures;
+    sParams.bPromoteToMulti = bPromoteToMulti;
+    sParams.bUsePreparedGeometries = FALSE;
+    sParams.bPretestContainment = FALSE;
+    sParams.bKeepLowerDimGeom = FALSE;
+    ret = run_overlay_loop(erase_loop, this, pLayerMethod, pLayerResult, &sParams,
+                           poMethodIndex, nThreads, pfnProgress, pProgressArg);
+
 done:
     // release resources
+    delete poMethodIndex;
     pLayerMethod->SetSpatialFilter(pGeometryMethodFilter);
     if (pGeometryMethodFilter) delete pGeometryMethodFilter;
     if (mapInput) VSIFree(mapInput);
@@ -4377,6 +5497,16 @@ done:
  *     will be created from the fields of the input layer.
  * <li>METHOD_PREFIX=string. Set a prefix for the field names that
  *     will be created from the fields of the method layer.
+ * <li>USE_SPATIAL_INDEX=YES/NO. Set to YES to read the method layer
+ *     once into memory, with a spatial index, instead of setting a
+ *     spatial filter on it for each feature of this layer. Useful when
+ *     the method layer has no efficient spatial filtering, at the cost
+ *     of keeping it in memory. (GDAL >= 2.3)
+ * <li>NUM_THREADS=number/ALL_CPUS. Number of threads used to process
+ *     the features of this layer when USE_SPATIAL_INDEX=YES. The result
+ *     features are written in the same order as with a single thread.
+ *     Defaults to the value of the GDAL_NUM_THREADS configuration
+ *     option, or 1. (GDAL >= 2.3)
  * </ul>
  *
  * This function is the same as the C++ method OGRLayer::Erase().
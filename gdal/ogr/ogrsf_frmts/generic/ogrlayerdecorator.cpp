@@ -97,6 +97,14 @@ OGRFeature *OGRLayerDecorator::GetNextFeature()
     return m_poDecoratedLayer->GetNextFeature();
 }
 
+int         OGRLayerDecorator::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                                    int nMaxFeatures )
+{
+    // Not forwarded to the decorated layer, since subclasses generally
+    // override GetNextFeature() to alter the features.
+    return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+}
+
 OGRErr      OGRLayerDecorator::SetNextByIndex( GIntBig nIndex )
 {
     if( !m_poDecoratedLayer ) return OGRERR_FAILURE;
@@ -287,6 +287,17 @@ OGRFeature *OGRProxiedLayer::GetNextFeature()
     return poUnderlyingLayer->GetNextFeature();
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRProxiedLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                          int nMaxFeatures )
+{
+    if( poUnderlyingLayer == NULL && !OpenUnderlyingLayer() ) return 0;
+    return poUnderlyingLayer->GetNextFeatureBatch(poBatch, nMaxFeatures);
+}
+
 /************************************************************************/
 /*                           SetNextByIndex()                           */
 /************************************************************************/
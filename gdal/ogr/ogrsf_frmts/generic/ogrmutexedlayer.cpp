@@ -93,6 +93,14 @@ OGRFeature *OGRMutexedLayer::GetNextFeature()
     return OGRLayerDecorator::GetNextFeature();
 }
 
+int         OGRMutexedLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                                  int nMaxFeatures )
+{
+    CPLMutexHolderOptionalLockD(m_hMutex);
+    if( !m_poDecoratedLayer ) return 0;
+    return m_poDecoratedLayer->GetNextFeatureBatch(poBatch, nMaxFeatures);
+}
+
 OGRErr      OGRMutexedLayer::SetNextByIndex( GIntBig nIndex )
 {
     CPLMutexHolderOptionalLockD(m_hMutex);
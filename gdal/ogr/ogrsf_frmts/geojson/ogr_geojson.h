@@ -41,6 +41,7 @@
 #include "ogrgeojsonwriter.h"
 
 class OGRGeoJSONDataSource;
+class OGRGeoJSONReader;
 
 /************************************************************************/
 /*                           OGRGeoJSONLayer                            */
@@ -66,6 +67,18 @@ class OGRGeoJSONLayer : public OGRMemLayer
     virtual const char* GetFIDColumn() override;
     virtual int         TestCapability( const char * pszCap ) override;
 
+    virtual void        ResetReading() override;
+    virtual OGRFeature* GetNextFeature() override;
+    virtual int         GetNextFeatureBatch( OGRFeatureBatch* poBatch,
+                                             int nMaxFeatures ) override;
+    virtual OGRFeature* GetFeature( GIntBig nFID ) override;
+    virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
+    virtual GIntBig     GetFeatureCount( int bForce ) override;
+    virtual OGRErr      GetExtent( OGREnvelope* psExtent,
+                                   int bForce = TRUE ) override;
+    virtual OGRErr      GetExtent( int iGeomField, OGREnvelope* psExtent,
+                                   int bForce = TRUE ) override;
+
     virtual OGRErr      SyncToDisk() override;
     //
     // OGRGeoJSONLayer Interface
@@ -73,12 +86,21 @@ class OGRGeoJSONLayer : public OGRMemLayer
     void SetFIDColumn( const char* pszFIDColumn );
     void AddFeature( OGRFeature* poFeature );
     void DetectGeometryType();
+    void SetStreamingReader( OGRGeoJSONReader* poReader,
+                             GIntBig nFeatureCount,
+                             const OGREnvelope& sExtent );
 
   private:
     OGRGeoJSONDataSource* poDS_;
     CPLString sFIDColumn_;
     bool bUpdated_;
     bool bOriginalIdModified_;
+
+    // When set, features are read from the file by this reader rather
+    // than stored in the underlying memory layer.
+    OGRGeoJSONReader* poStreamingReader_;
+    GIntBig nStreamingFeatureCount_;
+    OGREnvelope sStreamingExtent_;
 };
 
 /************************************************************************/
@@ -212,8 +234,11 @@ class OGRGeoJSONDataSource : public OGRDataSource
     //
     void Clear();
     int ReadFromFile( GDALOpenInfo* poOpenInfo );
+    int ReadFromFileStreaming( GDALOpenInfo* poOpenInfo );
     int ReadFromService( const char* pszSource );
     void LoadLayers(char** papszOpenOptions);
+    void ConfigureReader( OGRGeoJSONReader* poReader,
+                          char** papszOpenOptions );
 };
 
 #endif  // OGR_GEOJSON_H_INCLUDED
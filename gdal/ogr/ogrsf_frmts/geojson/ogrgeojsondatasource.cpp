@@ -113,6 +113,12 @@ int OGRGeoJSONDataSource::Open( GDALOpenInfo* poOpenInfo,
     }
     else if( eGeoJSONSourceFile == nSrcType )
     {
+        if( poOpenInfo->eAccess == GA_ReadOnly )
+        {
+            SetDescription( poOpenInfo->pszFilename );
+            if( ReadFromFileStreaming( poOpenInfo ) )
+                return TRUE;
+        }
         if( !ReadFromFile( poOpenInfo ) )
             return FALSE;
     }
@@ -561,6 +567,70 @@ int OGRGeoJSONDataSource::ReadFromFile( GDALOpenInfo* poOpenInfo )
     return TRUE;
 }
 
+/************************************************************************/
+/*                       ReadFromFileStreaming()                        */
+/************************************************************************/
+
+// Large FeatureCollection files are not ingested but read feature by
+// feature. Returns FALSE if the file is not a candidate for this, in which
+// case it must be loaded with ReadFromFile().
+
+int OGRGeoJSONDataSource::ReadFromFileStreaming( GDALOpenInfo* poOpenInfo )
+{
+    if( poOpenInfo->fpL == NULL || poOpenInfo->pabyHeader == NULL )
+        return FALSE;
+
+    const double dfThresholdMB = CPLAtof(
+        CPLGetConfigOption("OGR_GEOJSON_STREAMING_THRESHOLD", "100"));
+    VSIStatBufL sStatBuf;
+    if( VSIStatL(poOpenInfo->pszFilename, &sStatBuf) != 0 ||
+        static_cast<double>(sStatBuf.st_size) <
+            dfThresholdMB * 1024 * 1024 )
+    {
+        return FALSE;
+    }
+
+    // JSONP wrapped content, CouchDB answers, ESRI and TopoJSON documents
+    // are left to the in-memory code path.
+    const char* pszHeader =
+        reinterpret_cast<const char*>(poOpenInfo->pabyHeader);
+    const char* pszStart = pszHeader;
+    if( STARTS_WITH(pszStart, "\xEF\xBB\xBF") )
+        pszStart += 3;
+    while( *pszStart != '\0' && isspace( (unsigned char)*pszStart ) )
+        pszStart++;
+    if( !GeoJSONIsObject(pszHeader) ||
+        *pszStart != '{' ||
+        STARTS_WITH(pszStart, "{\"couchdb\":\"Welcome\"") ||
+        STARTS_WITH(pszStart, "{\"db_name\":\"") ||
+        STARTS_WITH(pszStart, "{\"total_rows\":") ||
+        STARTS_WITH(pszStart, "{\"rows\":[") ||
+        strstr(pszHeader, "esriGeometry") ||
+        strstr(pszHeader, "esriFieldType") ||
+        strstr(pszHeader, "\"Topology\"") )
+    {
+        return FALSE;
+    }
+
+    VSILFILE* fp = VSIFOpenL( poOpenInfo->pszFilename, "rb" );
+    if( fp == NULL )
+        return FALSE;
+
+    OGRGeoJSONReader* poReader = new OGRGeoJSONReader();
+    ConfigureReader( poReader, poOpenInfo->papszOpenOptions );
+    if( !poReader->FirstPassReadLayer( this, fp ) )
+    {
+        CPLDebug( "GeoJSON", "Cannot stream %s. Loading it in memory",
+                  poOpenInfo->pszFilename );
+        delete poReader;
+        return FALSE;
+    }
+
+    pszName_ = CPLStrdup( poOpenInfo->pszFilename );
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                           ReadFromService()                          */
 /************************************************************************/
@@ -724,31 +794,7 @@ void OGRGeoJSONDataSource::LoadLayers(char** papszOpenOptionsIn)
 /*      Configure GeoJSON format translator.                            */
 /* -------------------------------------------------------------------- */
     OGRGeoJSONReader reader;
-
-    if( eGeometryAsCollection == flTransGeom_ )
-    {
-        reader.SetPreserveGeometryType( false );
-        CPLDebug( "GeoJSON", "Geometry as OGRGeometryCollection type." );
-    }
-
-    if( eAttributesSkip == flTransAttrs_ )
-    {
-        reader.SetSkipAttributes( true );
-        CPLDebug( "GeoJSON", "Skip all attributes." );
-    }
-
-    reader.SetFlattenNestedAttributes(
-        CPLFetchBool(papszOpenOptionsIn, "FLATTEN_NESTED_ATTRIBUTES", false),
-        CSLFetchNameValueDef(papszOpenOptionsIn,
-                             "NESTED_ATTRIBUTE_SEPARATOR", "_")[0]);
-
-    const bool bDefaultNativeData = bUpdatable_;
-    reader.SetStoreNativeData(
-        CPLFetchBool(papszOpenOptionsIn, "NATIVE_DATA", bDefaultNativeData));
-
-    reader.SetArrayAsString(
-        CPLTestBool(CSLFetchNameValueDef(papszOpenOptionsIn, "ARRAY_AS_STRING",
-                CPLGetConfigOption("OGR_GEOJSON_ARRAY_AS_STRING", "NO"))));
+    ConfigureReader( &reader, papszOpenOptionsIn );
 
 /* -------------------------------------------------------------------- */
 /*      Parse GeoJSON and build valid OGRLayer instance.                */
@@ -783,6 +829,39 @@ void OGRGeoJSONDataSource::LoadLayers(char** papszOpenOptionsIn)
     return;
 }
 
+/************************************************************************/
+/*                          ConfigureReader()                           */
+/************************************************************************/
+
+void OGRGeoJSONDataSource::ConfigureReader( OGRGeoJSONReader* poReader,
+                                            char** papszOpenOptionsIn )
+{
+    if( eGeometryAsCollection == flTransGeom_ )
+    {
+        poReader->SetPreserveGeometryType( false );
+        CPLDebug( "GeoJSON", "Geometry as OGRGeometryCollection type." );
+    }
+
+    if( eAttributesSkip == flTransAttrs_ )
+    {
+        poReader->SetSkipAttributes( true );
+        CPLDebug( "GeoJSON", "Skip all attributes." );
+    }
+
+    poReader->SetFlattenNestedAttributes(
+        CPLFetchBool(papszOpenOptionsIn, "FLATTEN_NESTED_ATTRIBUTES", false),
+        CSLFetchNameValueDef(papszOpenOptionsIn,
+                             "NESTED_ATTRIBUTE_SEPARATOR", "_")[0]);
+
+    const bool bDefaultNativeData = bUpdatable_;
+    poReader->SetStoreNativeData(
+        CPLFetchBool(papszOpenOptionsIn, "NATIVE_DATA", bDefaultNativeData));
+
+    poReader->SetArrayAsString(
+        CPLTestBool(CSLFetchNameValueDef(papszOpenOptionsIn, "ARRAY_AS_STRING",
+                CPLGetConfigOption("OGR_GEOJSON_ARRAY_AS_STRING", "NO"))));
+}
+
 /************************************************************************/
 /*                            AddLayer()                                */
 /************************************************************************/
@@ -46,6 +46,7 @@
 #endif  // !DEBUG_VERBOSE
 
 #include "ogr_geojson.h"
+#include "ogrgeojsonreader.h"
 
 // Remove annoying warnings Microsoft Visual C++:
 //   'class': assignment operator could not be generated.
@@ -75,7 +76,9 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
     OGRMemLayer( pszName, poSRSIn, eGType),
     poDS_(poDS),
     bUpdated_(false),
-    bOriginalIdModified_(false)
+    bOriginalIdModified_(false),
+    poStreamingReader_(NULL),
+    nStreamingFeatureCount_(0)
 {
     SetAdvertizeUTF8(true);
     SetUpdatable( poDS->IsUpdatable() );
@@ -85,7 +88,10 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
 /*                          ~OGRGeoJSONLayer                            */
 /************************************************************************/
 
-OGRGeoJSONLayer::~OGRGeoJSONLayer() {}
+OGRGeoJSONLayer::~OGRGeoJSONLayer()
+{
+    delete poStreamingReader_;
+}
 
 /************************************************************************/
 /*                           GetFIDColumn                               */
@@ -114,9 +120,158 @@ int OGRGeoJSONLayer::TestCapability( const char * pszCap )
 {
     if( EQUAL(pszCap, OLCCurveGeometries) )
         return FALSE;
+    if( poStreamingReader_ != NULL )
+    {
+        if( EQUAL(pszCap, OLCFastFeatureCount) )
+            return m_poFilterGeom == NULL && m_poAttrQuery == NULL;
+        if( EQUAL(pszCap, OLCFastGetExtent) ||
+            EQUAL(pszCap, OLCRandomRead) )
+            return TRUE;
+        if( EQUAL(pszCap, OLCFastSetNextByIndex) )
+            return m_poFilterGeom == NULL && m_poAttrQuery == NULL;
+    }
     return OGRMemLayer::TestCapability(pszCap);
 }
 
+/************************************************************************/
+/*                         SetStreamingReader()                         */
+/************************************************************************/
+
+void OGRGeoJSONLayer::SetStreamingReader( OGRGeoJSONReader* poReader,
+                                          GIntBig nFeatureCount,
+                                          const OGREnvelope& sExtent )
+{
+    delete poStreamingReader_;
+    poStreamingReader_ = poReader;
+    nStreamingFeatureCount_ = nFeatureCount;
+    sStreamingExtent_ = sExtent;
+
+    // Attribute indexes are built from the in-memory features.
+    m_bAutoAttrIndex = false;
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+void OGRGeoJSONLayer::ResetReading()
+{
+    if( poStreamingReader_ == NULL )
+    {
+        OGRMemLayer::ResetReading();
+        return;
+    }
+
+    poStreamingReader_->ResetReading();
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONLayer::GetNextFeature()
+{
+    if( poStreamingReader_ == NULL )
+        return OGRMemLayer::GetNextFeature();
+
+    while( true )
+    {
+        OGRFeature* poFeature = poStreamingReader_->GetNextFeature(this);
+        if( poFeature == NULL )
+            return NULL;
+
+        if( (m_poFilterGeom == NULL ||
+             FilterGeometry(poFeature->GetGeomFieldRef(m_iGeomFieldFilter))) &&
+            (m_poAttrQuery == NULL || m_poAttrQuery->Evaluate(poFeature)) )
+        {
+            m_nFeaturesRead++;
+            return poFeature;
+        }
+
+        delete poFeature;
+    }
+}
+
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRGeoJSONLayer::GetNextFeatureBatch( OGRFeatureBatch* poBatch,
+                                          int nMaxFeatures )
+{
+    // In streaming mode, the memory layer is empty.
+    if( poStreamingReader_ != NULL )
+        return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+    return OGRMemLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONLayer::GetFeature( GIntBig nFID )
+{
+    if( poStreamingReader_ == NULL )
+        return OGRMemLayer::GetFeature(nFID);
+
+    return poStreamingReader_->GetFeature(this, nFID);
+}
+
+/************************************************************************/
+/*                           SetNextByIndex()                           */
+/************************************************************************/
+
+OGRErr OGRGeoJSONLayer::SetNextByIndex( GIntBig nIndex )
+{
+    if( poStreamingReader_ == NULL )
+        return OGRMemLayer::SetNextByIndex(nIndex);
+
+    if( m_poFilterGeom != NULL || m_poAttrQuery != NULL )
+        return OGRLayer::SetNextByIndex(nIndex);
+
+    return poStreamingReader_->SetNextByIndex(nIndex) ? OGRERR_NONE
+                                                      : OGRERR_FAILURE;
+}
+
+/************************************************************************/
+/*                          GetFeatureCount()                           */
+/************************************************************************/
+
+GIntBig OGRGeoJSONLayer::GetFeatureCount( int bForce )
+{
+    if( poStreamingReader_ == NULL )
+        return OGRMemLayer::GetFeatureCount(bForce);
+
+    if( m_poFilterGeom == NULL && m_poAttrQuery == NULL )
+        return nStreamingFeatureCount_;
+
+    return OGRLayer::GetFeatureCount(bForce);
+}
+
+/************************************************************************/
+/*                             GetExtent()                              */
+/************************************************************************/
+
+OGRErr OGRGeoJSONLayer::GetExtent( OGREnvelope* psExtent, int bForce )
+{
+    if( poStreamingReader_ == NULL )
+        return OGRMemLayer::GetExtent(psExtent, bForce);
+
+    // Computed while scanning the file.
+    if( !sStreamingExtent_.IsInit() )
+        return OGRERR_FAILURE;
+    *psExtent = sStreamingExtent_;
+    return OGRERR_NONE;
+}
+
+OGRErr OGRGeoJSONLayer::GetExtent( int iGeomField, OGREnvelope* psExtent,
+                                   int bForce )
+{
+    // OGRLayer::GetExtent(int, ...) redirects the first geometry field
+    // to the above method.
+    return OGRMemLayer::GetExtent(iGeomField, psExtent, bForce);
+}
+
 /************************************************************************/
 /*                           SyncToDisk()                               */
 /************************************************************************/
@@ -188,7 +343,10 @@ void OGRGeoJSONLayer::AddFeature( OGRFeature* poFeature )
 
 void OGRGeoJSONLayer::DetectGeometryType()
 {
-    if( GetLayerDefn()->GetGeomType() != wkbUnknown )
+    // In streaming mode, the type has been established by the first pass
+    // over the file.
+    if( poStreamingReader_ != NULL ||
+        GetLayerDefn()->GetGeomType() != wkbUnknown )
         return;
 
     ResetReading();
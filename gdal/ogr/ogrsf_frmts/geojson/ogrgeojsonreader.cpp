@@ -33,6 +33,8 @@
 #include <json.h> // JSON-C
 #include <ogr_api.h>
 
+#include <algorithm>
+
 CPL_CVSID("$Id$")
 
 /************************************************************************/
@@ -41,6 +43,9 @@ CPL_CVSID("$Id$")
 
 OGRGeoJSONReader::OGRGeoJSONReader() :
     poGJObject_(NULL),
+    poSplitter_(NULL),
+    iNextFeature_(0),
+    iSplitterNextFeature_(-1),
     bGeometryPreserve_(true),
     bAttributesSkip_(false),
     bFlattenNestedAttributes_(false),
@@ -67,6 +72,8 @@ OGRGeoJSONReader::~OGRGeoJSONReader()
     }
 
     poGJObject_ = NULL;
+
+    delete poSplitter_;
 }
 
 /************************************************************************/
@@ -144,47 +151,9 @@ void OGRGeoJSONReader::ReadLayer( OGRGeoJSONDataSource* poDS,
         return;
     }
 
-    OGRSpatialReference* poSRS = OGRGeoJSONReadSpatialReference( poObj );
-    if( poSRS == NULL )
-    {
-        // If there is none defined, we use 4326.
-        poSRS = new OGRSpatialReference();
-        poSRS->SetFromUserInput(SRS_WKT_WGS84);
-    }
-
     CPLErrorReset();
 
-    // Figure out layer name
-    if( pszName == NULL )
-    {
-        if( GeoJSONObject::eFeatureCollection == objType )
-        {
-            json_object* poName = CPL_json_object_object_get(poObj, "name");
-            if( poName != NULL &&
-                json_object_get_type(poName) == json_type_string )
-            {
-                pszName = json_object_get_string(poName);
-            }
-        }
-        if( pszName == NULL )
-        {
-            const char* pszDesc = poDS->GetDescription();
-            if( strchr(pszDesc, '?') == NULL &&
-                strchr(pszDesc, '{') == NULL )
-            {
-                pszName = CPLGetBasename(pszDesc);
-            }
-        }
-        if( pszName == NULL )
-            pszName = OGRGeoJSONLayer::DefaultName;
-    }
-
-    OGRGeoJSONLayer* poLayer =
-      new OGRGeoJSONLayer( pszName, poSRS,
-                           OGRGeoJSONLayer::DefaultGeometryType,
-                           poDS );
-    if( poSRS != NULL )
-        poSRS->Release();
+    OGRGeoJSONLayer* poLayer = CreateLayer( poDS, pszName, poObj );
 
     if( !GenerateLayerDefn(poLayer, poObj) )
     {
@@ -195,18 +164,6 @@ void OGRGeoJSONReader::ReadLayer( OGRGeoJSONDataSource* poDS,
         return;
     }
 
-    if( GeoJSONObject::eFeatureCollection == objType )
-    {
-        json_object* poDescription =
-                        CPL_json_object_object_get(poObj, "description");
-        if( poDescription != NULL &&
-            json_object_get_type(poDescription) == json_type_string )
-        {
-            poLayer->SetMetadataItem("DESCRIPTION",
-                                     json_object_get_string(poDescription));
-        }
-    }
-
 /* -------------------------------------------------------------------- */
 /*      Translate single geometry-only Feature object.                  */
 /* -------------------------------------------------------------------- */
@@ -249,6 +206,70 @@ void OGRGeoJSONReader::ReadLayer( OGRGeoJSONDataSource* poDS,
     poDS->AddLayer(poLayer);
 }
 
+/************************************************************************/
+/*                            CreateLayer()                             */
+/************************************************************************/
+
+OGRGeoJSONLayer* OGRGeoJSONReader::CreateLayer( OGRGeoJSONDataSource* poDS,
+                                                const char* pszName,
+                                                json_object* poObj )
+{
+    const GeoJSONObject::Type objType = OGRGeoJSONGetType( poObj );
+
+    OGRSpatialReference* poSRS = OGRGeoJSONReadSpatialReference( poObj );
+    if( poSRS == NULL )
+    {
+        // If there is none defined, we use 4326.
+        poSRS = new OGRSpatialReference();
+        poSRS->SetFromUserInput(SRS_WKT_WGS84);
+    }
+
+    // Figure out layer name
+    if( pszName == NULL )
+    {
+        if( GeoJSONObject::eFeatureCollection == objType )
+        {
+            json_object* poName = CPL_json_object_object_get(poObj, "name");
+            if( poName != NULL &&
+                json_object_get_type(poName) == json_type_string )
+            {
+                pszName = json_object_get_string(poName);
+            }
+        }
+        if( pszName == NULL )
+        {
+            const char* pszDesc = poDS->GetDescription();
+            if( strchr(pszDesc, '?') == NULL &&
+                strchr(pszDesc, '{') == NULL )
+            {
+                pszName = CPLGetBasename(pszDesc);
+            }
+        }
+        if( pszName == NULL )
+            pszName = OGRGeoJSONLayer::DefaultName;
+    }
+
+    OGRGeoJSONLayer* poLayer =
+      new OGRGeoJSONLayer( pszName, poSRS,
+                           OGRGeoJSONLayer::DefaultGeometryType,
+                           poDS );
+    poSRS->Release();
+
+    if( GeoJSONObject::eFeatureCollection == objType )
+    {
+        json_object* poDescription =
+                        CPL_json_object_object_get(poObj, "description");
+        if( poDescription != NULL &&
+            json_object_get_type(poDescription) == json_type_string )
+        {
+            poLayer->SetMetadataItem("DESCRIPTION",
+                                     json_object_get_string(poDescription));
+        }
+    }
+
+    return poLayer;
+}
+
 /************************************************************************/
 /*                    OGRGeoJSONReadSpatialReference                    */
 /************************************************************************/
@@ -479,6 +500,17 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer,
         }
     }
 
+    FinalizeLayerDefn( poLayer );
+
+    return bSuccess;
+}
+
+/************************************************************************/
+/*                         FinalizeLayerDefn()                          */
+/************************************************************************/
+
+void OGRGeoJSONReader::FinalizeLayerDefn( OGRGeoJSONLayer* poLayer )
+{
 /* -------------------------------------------------------------------- */
 /*      Validate and add FID column if necessary.                       */
 /* -------------------------------------------------------------------- */
@@ -499,8 +531,6 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer,
             }
         }
     }
-
-    return bSuccess;
 }
 
 /************************************************************************/
@@ -1394,47 +1424,799 @@ OGRGeoJSONReader::ReadFeatureCollection( OGRGeoJSONLayer* poLayer,
         }
     }
 
-    // Collect top objects except 'type' and the 'features' array.
     if( bStoreNativeData_ )
+        StoreCollectionNativeData( poLayer, poObj );
+}
+
+/************************************************************************/
+/*                      StoreCollectionNativeData()                     */
+/************************************************************************/
+
+void OGRGeoJSONReader::StoreCollectionNativeData( OGRGeoJSONLayer* poLayer,
+                                                  json_object* poObj )
+{
+    // Collect top objects except 'type' and the 'features' array.
+    json_object_iter it;
+    it.key = NULL;
+    it.val = NULL;
+    it.entry = NULL;
+    CPLString osNativeData;
+    json_object_object_foreachC(poObj, it)
     {
-        json_object_iter it;
-        it.key = NULL;
-        it.val = NULL;
-        it.entry = NULL;
-        CPLString osNativeData;
-        json_object_object_foreachC(poObj, it)
+        if( strcmp(it.key, "type") == 0 ||
+            strcmp(it.key, "features") == 0 )
+        {
+            continue;
+        }
+        if( osNativeData.empty() )
+            osNativeData = "{ ";
+        else
+            osNativeData += ", ";
+        json_object* poKey = json_object_new_string(it.key);
+        osNativeData += json_object_to_json_string(poKey);
+        json_object_put(poKey);
+        osNativeData += ": ";
+        osNativeData += json_object_to_json_string(it.val);
+    }
+    if( osNativeData.empty() )
+    {
+        osNativeData = "{ ";
+    }
+    osNativeData += " }";
+
+    osNativeData = "NATIVE_DATA=" + osNativeData;
+
+    char *apszMetadata[3] = {
+        const_cast<char *>(osNativeData.c_str()),
+        const_cast<char *>("NATIVE_MEDIA_TYPE=application/vnd.geo+json"),
+        NULL
+    };
+
+    poLayer->SetMetadata( apszMetadata, "NATIVE_DATA" );
+}
+
+/************************************************************************/
+/*                      OGRGeoJSONFeatureSplitter()                     */
+/************************************************************************/
+
+// Upper bound for the text of the FeatureCollection members other than
+// "features", which is kept to be parsed once the first pass is over.
+static const size_t MAX_TOP_LEVEL_SIZE = 10 * 1024 * 1024;
+
+OGRGeoJSONFeatureSplitter::OGRGeoJSONFeatureSplitter( VSILFILE* fp ) :
+    fp_(fp),
+    abyBuffer_(65536),
+    nBufferOffset_(0),
+    nBufferSize_(0),
+    iBufferPos_(0),
+    bEOF_(false),
+    bFirstBuffer_(true),
+    eState_(eTopLevel),
+    nDepth_(0),
+    bInString_(false),
+    bEscape_(false),
+    bExpectKey_(false),
+    bInKey_(false),
+    bInFeature_(false),
+    nFeatureOffset_(0),
+    bCollectTopLevel_(false),
+    bFoundFeatures_(false),
+    bError_(false)
+{}
+
+/************************************************************************/
+/*                     ~OGRGeoJSONFeatureSplitter()                     */
+/************************************************************************/
+
+OGRGeoJSONFeatureSplitter::~OGRGeoJSONFeatureSplitter()
+{
+    if( fp_ != NULL )
+        VSIFCloseL(fp_);
+}
+
+/************************************************************************/
+/*                               Rewind()                               */
+/************************************************************************/
+
+void OGRGeoJSONFeatureSplitter::Rewind()
+{
+    VSIFSeekL(fp_, 0, SEEK_SET);
+    nBufferOffset_ = 0;
+    nBufferSize_ = 0;
+    iBufferPos_ = 0;
+    bEOF_ = false;
+    bFirstBuffer_ = true;
+    eState_ = eTopLevel;
+    nDepth_ = 0;
+    bInString_ = false;
+    bEscape_ = false;
+    bExpectKey_ = false;
+    bInKey_ = false;
+    osKey_.clear();
+    bInFeature_ = false;
+    osFeature_.clear();
+    osTopLevel_.clear();
+    bFoundFeatures_ = false;
+    bError_ = false;
+}
+
+/************************************************************************/
+/*                           SeekToFeature()                            */
+/************************************************************************/
+
+// Positions the scanner on a feature whose offset has been returned by
+// GetFeatureOffset(), so that it is returned by the next call to
+// GetNextFeatureText(), followed by the next features of the array.
+
+void OGRGeoJSONFeatureSplitter::SeekToFeature( vsi_l_offset nOffset )
+{
+    Rewind();
+    VSIFSeekL(fp_, nOffset, SEEK_SET);
+    nBufferOffset_ = nOffset;
+    bFirstBuffer_ = false;
+    eState_ = eInFeatures;
+    nDepth_ = 2;
+    bFoundFeatures_ = true;
+}
+
+/************************************************************************/
+/*                             FillBuffer()                             */
+/************************************************************************/
+
+bool OGRGeoJSONFeatureSplitter::FillBuffer()
+{
+    if( bEOF_ )
+        return false;
+
+    nBufferOffset_ = VSIFTellL(fp_);
+    nBufferSize_ = VSIFReadL(&abyBuffer_[0], 1, abyBuffer_.size(), fp_);
+    iBufferPos_ = 0;
+    if( nBufferSize_ < abyBuffer_.size() )
+        bEOF_ = true;
+
+    // Skip UTF-8 BOM (#5630).
+    if( bFirstBuffer_ )
+    {
+        bFirstBuffer_ = false;
+        const GByte* pabyData = reinterpret_cast<GByte*>(&abyBuffer_[0]);
+        if( nBufferSize_ >= 3 &&
+            pabyData[0] == 0xEF && pabyData[1] == 0xBB && pabyData[2] == 0xBF )
+        {
+            CPLDebug("GeoJSON", "Skip UTF-8 BOM");
+            iBufferPos_ = 3;
+        }
+    }
+
+    return iBufferPos_ < nBufferSize_;
+}
+
+/************************************************************************/
+/*                             AppendSpan()                             */
+/************************************************************************/
+
+// Appends the [iStart, iEnd[ range of the buffer to the text currently
+// being accumulated: the current feature, or the top-level object.
+
+void OGRGeoJSONFeatureSplitter::AppendSpan( size_t iStart, size_t iEnd )
+{
+    if( iEnd <= iStart )
+        return;
+    if( bInFeature_ )
+    {
+        osFeature_.append(&abyBuffer_[iStart], iEnd - iStart);
+    }
+    else if( bCollectTopLevel_ && eState_ != eInFeatures )
+    {
+        osTopLevel_.append(&abyBuffer_[iStart], iEnd - iStart);
+        if( osTopLevel_.size() > MAX_TOP_LEVEL_SIZE )
         {
-            if( strcmp(it.key, "type") == 0 ||
-                strcmp(it.key, "features") == 0 )
+            CPLDebug("GeoJSON",
+                     "FeatureCollection members too large to be streamed");
+            bError_ = true;
+        }
+    }
+}
+
+/************************************************************************/
+/*                        GetNextFeatureText()                          */
+/************************************************************************/
+
+// Returns the text of the next object of the "features" array of the
+// top-level object, or NULL once the end of the file has been reached.
+// The returned string is valid until the next call.
+
+const char* OGRGeoJSONFeatureSplitter::GetNextFeatureText()
+{
+    while( !bError_ )
+    {
+        if( iBufferPos_ == nBufferSize_ && !FillBuffer() )
+        {
+            if( nDepth_ != 0 || bInString_ )
             {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "GeoJSON: unexpected end of file");
+                bError_ = true;
+            }
+            return NULL;
+        }
+
+        const char* pachData = &abyBuffer_[0];
+        size_t iSpanStart = iBufferPos_;
+        for( size_t i = iBufferPos_; i < nBufferSize_; i++ )
+        {
+            const char ch = pachData[i];
+            if( bInString_ )
+            {
+                if( bEscape_ )
+                    bEscape_ = false;
+                else if( ch == '\\' )
+                    bEscape_ = true;
+                else if( ch == '"' )
+                    bInString_ = bInKey_ = false;
+                else if( bInKey_ )
+                    osKey_ += ch;
                 continue;
             }
-            if( osNativeData.empty() )
-                osNativeData = "{ ";
-            else
-                osNativeData += ", ";
-            json_object* poKey = json_object_new_string(it.key);
-            osNativeData += json_object_to_json_string(poKey);
-            json_object_put(poKey);
-            osNativeData += ": ";
-            osNativeData += json_object_to_json_string(it.val);
+
+            if( isspace(static_cast<unsigned char>(ch)) )
+                continue;
+
+            if( eState_ == eFeaturesExpected )
+            {
+                if( ch == '[' )
+                {
+                    // Only the brackets of the array are kept in the
+                    // top-level object.
+                    AppendSpan(iSpanStart, i + 1);
+                    iSpanStart = i + 1;
+                    eState_ = eInFeatures;
+                    bFoundFeatures_ = true;
+                    nDepth_++;
+                    continue;
+                }
+                // "features" is not an array: this is not something we
+                // can stream.
+                eState_ = eTopLevel;
+            }
+
+            switch( ch )
+            {
+                case '"':
+                    bInString_ = true;
+                    if( nDepth_ == 1 && bExpectKey_ )
+                    {
+                        bInKey_ = true;
+                        bExpectKey_ = false;
+                        osKey_.clear();
+                    }
+                    break;
+
+                case '{':
+                case '[':
+                    if( eState_ == eInFeatures && nDepth_ == 2 && ch == '{' )
+                    {
+                        AppendSpan(iSpanStart, i);
+                        iSpanStart = i;
+                        bInFeature_ = true;
+                        nFeatureOffset_ = nBufferOffset_ + i;
+                        osFeature_.clear();
+                    }
+                    nDepth_++;
+                    if( nDepth_ == 1 && ch == '{' )
+                        bExpectKey_ = true;
+                    break;
+
+                case '}':
+                case ']':
+                    nDepth_--;
+                    if( nDepth_ < 0 )
+                    {
+                        CPLError(CE_Failure, CPLE_AppDefined,
+                                 "GeoJSON: unbalanced '%c'", ch);
+                        bError_ = true;
+                        return NULL;
+                    }
+                    if( eState_ == eInFeatures )
+                    {
+                        if( nDepth_ == 2 && bInFeature_ )
+                        {
+                            AppendSpan(iSpanStart, i + 1);
+                            bInFeature_ = false;
+                            iBufferPos_ = i + 1;
+                            return osFeature_.c_str();
+                        }
+                        if( nDepth_ == 1 )
+                        {
+                            AppendSpan(iSpanStart, i);
+                            iSpanStart = i;
+                            eState_ = eTopLevel;
+                        }
+                    }
+                    break;
+
+                case ',':
+                    if( nDepth_ == 1 )
+                        bExpectKey_ = true;
+                    break;
+
+                case ':':
+                    if( nDepth_ == 1 && eState_ == eTopLevel &&
+                        !bFoundFeatures_ && osKey_ == "features" )
+                    {
+                        eState_ = eFeaturesExpected;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
         }
-        if( osNativeData.empty() )
+
+        AppendSpan(iSpanStart, nBufferSize_);
+        iBufferPos_ = nBufferSize_;
+    }
+
+    return NULL;
+}
+
+/************************************************************************/
+/*                     OGRGeoJSONGetCandidateFID()                      */
+/************************************************************************/
+
+// Returns the FID that the value of an id member gives, or -1 if it is
+// not a positive integer, in which case OGRGeoJSONLayer::AddFeature() would
+// not keep it.
+static GIntBig OGRGeoJSONGetCandidateFID( json_object* poObjId )
+{
+    if( poObjId == NULL || json_object_get_type(poObjId) != json_type_int )
+        return -1;
+    const GIntBig nFID =
+        static_cast<GIntBig>(json_object_get_int64(poObjId));
+    return nFID < 0 ? -1 : nFID;
+}
+
+/************************************************************************/
+/*                         FirstPassReadLayer()                         */
+/************************************************************************/
+
+// Scans a FeatureCollection file and creates a layer that reads its
+// features lazily from it.
+//
+// The whole file is read once, one feature at a time, to establish the
+// layer schema, geometry type, feature count and extent, and the offset of
+// each feature. Features are then re-read from the file on each
+// GetNextFeature() call, so that memory usage only depends on the number of
+// features, not on their size.
+//
+// The reader takes ownership of fp. On success, the reader is itself owned
+// by the layer that has been added to poDS. On failure, nothing has been
+// added to poDS and the caller should discard the reader.
+
+bool OGRGeoJSONReader::FirstPassReadLayer( OGRGeoJSONDataSource* poDS,
+                                           VSILFILE* fp )
+{
+    poSplitter_ = new OGRGeoJSONFeatureSplitter(fp);
+    poSplitter_->SetCollectTopLevel(true);
+
+    // Fields are collected in a scratch layer, as the name and SRS of the
+    // actual layer may be written after the features.
+    OGRGeoJSONLayer* poTmpLayer =
+        new OGRGeoJSONLayer( "", NULL, wkbUnknown, poDS );
+
+    bool bSuccess = true;
+    GIntBig nFeatures = 0;
+    OGREnvelope sExtent;
+    OGRwkbGeometryType eLayerGeomType = wkbUnknown;
+    bool bFirstGeometry = true;
+    bool bMixedGeometries = false;
+    std::vector<GIntBig> anIds;
+    std::vector<GIntBig> anPropIds;
+
+    const char* pszText = NULL;
+    while( (pszText = poSplitter_->GetNextFeatureText()) != NULL )
+    {
+        json_object* poObj = NULL;
+        if( !OGRJSonParse(pszText, &poObj) )
         {
-            osNativeData = "{ ";
+            bSuccess = false;
+            break;
+        }
+
+        if( !bAttributesSkip_ && !GenerateFeatureDefn( poTmpLayer, poObj ) )
+        {
+            CPLDebug( "GeoJSON", "Create feature schema failure." );
+        }
+
+        anFeatureOffsets_.push_back( poSplitter_->GetFeatureOffset() );
+
+        // Candidate FIDs, from the feature id or from an "id" property,
+        // whichever ends up being used. -1 when not a positive integer.
+        json_object* poObjId = OGRGeoJSONFindMemberByName( poObj, "id" );
+        anIds.push_back( OGRGeoJSONGetCandidateFID(poObjId) );
+        json_object* poObjProps =
+            OGRGeoJSONFindMemberByName( poObj, "properties" );
+        anPropIds.push_back( OGRGeoJSONGetCandidateFID(
+            poObjProps != NULL &&
+            json_object_get_type(poObjProps) == json_type_object ?
+                CPL_json_object_object_get(poObjProps, "id") : NULL) );
+
+        json_object* poObjGeom = OGRGeoJSONFindMemberByName( poObj, "geometry" );
+        if( poObjGeom != NULL )
+        {
+            OGRGeometry* poGeometry = ReadGeometry( poObjGeom );
+            if( poGeometry != NULL )
+            {
+                const OGRwkbGeometryType eGeomType =
+                    poGeometry->getGeometryType();
+                if( bFirstGeometry )
+                {
+                    eLayerGeomType = eGeomType;
+                    bFirstGeometry = false;
+                }
+                else if( eGeomType != eLayerGeomType )
+                {
+                    bMixedGeometries = true;
+                }
+                if( !poGeometry->IsEmpty() )
+                {
+                    OGREnvelope sEnvelope;
+                    poGeometry->getEnvelope(&sEnvelope);
+                    sExtent.Merge(sEnvelope);
+                }
+                delete poGeometry;
+            }
+        }
+
+        json_object_put(poObj);
+        nFeatures++;
+    }
+
+    if( poSplitter_->HasError() || !poSplitter_->HasFoundFeatures() )
+        bSuccess = false;
+
+    if( bSuccess )
+    {
+        bSuccess =
+            OGRJSonParse(poSplitter_->GetTopLevelText(), &poGJObject_,
+                         false) &&
+            OGRGeoJSONGetType( poGJObject_ ) ==
+                GeoJSONObject::eFeatureCollection;
+    }
+    poSplitter_->SetCollectTopLevel(false);
+
+    if( !bSuccess )
+    {
+        delete poTmpLayer;
+        return false;
+    }
+
+    CPLErrorReset();
+
+    OGRGeoJSONLayer* poLayer = CreateLayer( poDS, NULL, poGJObject_ );
+    OGRFeatureDefn* poTmpDefn = poTmpLayer->GetLayerDefn();
+    for( int i = 0; i < poTmpDefn->GetFieldCount(); i++ )
+        poLayer->GetLayerDefn()->AddFieldDefn( poTmpDefn->GetFieldDefn(i) );
+    delete poTmpLayer;
+
+    FinalizeLayerDefn( poLayer );
+
+    if( bStoreNativeData_ )
+        StoreCollectionNativeData( poLayer, poGJObject_ );
+
+    if( !bFirstGeometry && !bMixedGeometries )
+    {
+        poLayer->GetLayerDefn()->SetGeomType( eLayerGeomType );
+    }
+    else if( bMixedGeometries )
+    {
+        CPLDebug( "GeoJSON",
+                  "Detected layer of mixed-geometry type features." );
+    }
+
+    // Without feature ids nor FID column, features are numbered in file
+    // order. Otherwise the ids collected above are used as they are, unless
+    // some are missing or duplicated.
+    if( bFoundFeatureId || poLayer->GetFIDColumn()[0] != '\0' )
+    {
+        if( !SetUniqueFIDs( bFoundFeatureId ? anIds : anPropIds ) &&
+            !AssignFIDs( poLayer ) )
+        {
+            delete poLayer;
+            return false;
+        }
+    }
+    const GIntBig nMaxFID = anFIDOrder_.empty() ?
+        (anFIDs_.empty() ? nFeatures - 1 : anFIDs_.back()) :
+        anFIDs_[anFIDOrder_.back()];
+    if( !CPL_INT64_FITS_ON_INT32(nMaxFID) )
+        poLayer->SetMetadataItem(OLMD_FID64, "YES");
+
+    if( CPLGetLastErrorType() != CE_Warning )
+        CPLErrorReset();
+
+    iNextFeature_ = 0;
+    iSplitterNextFeature_ = -1;
+    poLayer->SetStreamingReader( this, nFeatures, sExtent );
+    poDS->AddLayer( poLayer );
+
+    return true;
+}
+
+/************************************************************************/
+/*                          OGRGeoJSONFIDLess                           */
+/************************************************************************/
+
+// Compares feature indexes by FID.
+struct OGRGeoJSONFIDLess
+{
+    const std::vector<GIntBig>& anFIDs;
+
+    explicit OGRGeoJSONFIDLess( const std::vector<GIntBig>& anFIDsIn ) :
+        anFIDs(anFIDsIn) {}
+
+    bool operator()( GIntBig iFeature1, GIntBig iFeature2 ) const
+        { return anFIDs[iFeature1] < anFIDs[iFeature2]; }
+};
+
+// Compares the FID of a feature index with a FID value.
+struct OGRGeoJSONFIDLessThanValue
+{
+    const std::vector<GIntBig>& anFIDs;
+
+    explicit OGRGeoJSONFIDLessThanValue(
+        const std::vector<GIntBig>& anFIDsIn ) : anFIDs(anFIDsIn) {}
+
+    bool operator()( GIntBig iFeature, GIntBig nFID ) const
+        { return anFIDs[iFeature] < nFID; }
+};
+
+/************************************************************************/
+/*                           SetUniqueFIDs()                            */
+/************************************************************************/
+
+// Uses the ids collected by the first pass as FIDs if they are all set and
+// unique, which is what OGRGeoJSONLayer::AddFeature() would keep.
+
+bool OGRGeoJSONReader::SetUniqueFIDs( std::vector<GIntBig>& anIds )
+{
+    if( anIds.size() != anFeatureOffsets_.size() )
+        return false;
+
+    bool bSorted = true;
+    for( size_t i = 0; i < anIds.size(); i++ )
+    {
+        if( anIds[i] < 0 )
+            return false;
+        if( i > 0 && anIds[i] <= anIds[i-1] )
+            bSorted = false;
+    }
+    if( !bSorted )
+    {
+        std::vector<GIntBig> anSortedIds(anIds);
+        std::sort( anSortedIds.begin(), anSortedIds.end() );
+        if( std::adjacent_find( anSortedIds.begin(), anSortedIds.end() ) !=
+                anSortedIds.end() )
+        {
+            return false;
         }
-        osNativeData += " }";
+    }
+
+    anFIDs_.swap(anIds);
+    FinalizeFIDs( bSorted );
+    return true;
+}
+
+/************************************************************************/
+/*                             AssignFIDs()                             */
+/************************************************************************/
+
+// Reads the features again to compute the FIDs that
+// OGRGeoJSONLayer::AddFeature() assigns when the layer is loaded in memory:
+// the id of a feature is kept, unless it is missing or has already been
+// used, in which case the feature gets the first unused FID from its index.
+
+bool OGRGeoJSONReader::AssignFIDs( OGRGeoJSONLayer* poLayer )
+{
+    // Geometries and native data do not affect the FID.
+    const bool bStoreNativeData = bStoreNativeData_;
+    bStoreNativeData_ = false;
+
+    std::set<GIntBig> oSetUsedFIDs;
+    bool bWarned = false;
+    bool bSorted = true;
+    anFIDs_.clear();
+    anFIDs_.reserve( anFeatureOffsets_.size() );
+
+    poSplitter_->Rewind();
+    const char* pszText = NULL;
+    while( (pszText = poSplitter_->GetNextFeatureText()) != NULL )
+    {
+        json_object* poObj = NULL;
+        if( !OGRJSonParse(pszText, &poObj) )
+            break;
+        json_object_object_add( poObj, "geometry", NULL );
+        OGRFeature* poFeature = ReadFeature( poLayer, poObj );
+        json_object_put(poObj);
+        GIntBig nFID = poFeature->GetFID();
+        delete poFeature;
+
+        const GIntBig nIndex = static_cast<GIntBig>(anFIDs_.size());
+        if( nFID < 0 || oSetUsedFIDs.find(nFID) != oSetUsedFIDs.end() )
+        {
+            if( nFID >= 0 && !bWarned )
+            {
+                CPLError(
+                    CE_Warning, CPLE_AppDefined,
+                    "Several features with id = " CPL_FRMT_GIB " have been "
+                    "found. Altering it to be unique. This warning will not "
+                    "be emitted for this layer",
+                    nFID );
+                bWarned = true;
+            }
+            nFID = nIndex;
+            while( oSetUsedFIDs.find(nFID) != oSetUsedFIDs.end() )
+                nFID++;
+        }
+        oSetUsedFIDs.insert(nFID);
+
+        if( !anFIDs_.empty() && nFID < anFIDs_.back() )
+            bSorted = false;
+        anFIDs_.push_back(nFID);
+    }
+
+    bStoreNativeData_ = bStoreNativeData;
+
+    if( poSplitter_->HasError() ||
+        anFIDs_.size() != anFeatureOffsets_.size() )
+    {
+        return false;
+    }
+
+    FinalizeFIDs( bSorted );
+    return true;
+}
+
+/************************************************************************/
+/*                            FinalizeFIDs()                            */
+/************************************************************************/
+
+// Drops anFIDs_ if the FIDs are the feature indexes, and sorts the features
+// by FID if they are not in FID order in the file.
+
+void OGRGeoJSONReader::FinalizeFIDs( bool bSorted )
+{
+    bool bSequential = true;
+    for( size_t i = 0; bSequential && i < anFIDs_.size(); i++ )
+        bSequential = anFIDs_[i] == static_cast<GIntBig>(i);
+
+    if( bSequential )
+    {
+        std::vector<GIntBig>().swap(anFIDs_);
+    }
+    else if( !bSorted )
+    {
+        // Features are returned in FID order, as by OGRMemLayer.
+        anFIDOrder_.resize( anFIDs_.size() );
+        for( size_t i = 0; i < anFIDOrder_.size(); i++ )
+            anFIDOrder_[i] = static_cast<GIntBig>(i);
+        std::sort( anFIDOrder_.begin(), anFIDOrder_.end(),
+                   OGRGeoJSONFIDLess(anFIDs_) );
+    }
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+void OGRGeoJSONReader::ResetReading()
+{
+    iNextFeature_ = 0;
+}
 
-        osNativeData = "NATIVE_DATA=" + osNativeData;
+/************************************************************************/
+/*                           SetNextByIndex()                           */
+/************************************************************************/
+
+bool OGRGeoJSONReader::SetNextByIndex( GIntBig nIndex )
+{
+    if( nIndex < 0 ||
+        nIndex >= static_cast<GIntBig>(anFeatureOffsets_.size()) )
+    {
+        return false;
+    }
+    iNextFeature_ = nIndex;
+    return true;
+}
 
-        char *apszMetadata[3] = {
-            const_cast<char *>(osNativeData.c_str()),
-            const_cast<char *>("NATIVE_MEDIA_TYPE=application/vnd.geo+json"),
-            NULL
-        };
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
 
-        poLayer->SetMetadata( apszMetadata, "NATIVE_DATA" );
+OGRFeature* OGRGeoJSONReader::GetNextFeature( OGRGeoJSONLayer* poLayer )
+{
+    if( poSplitter_ == NULL ||
+        iNextFeature_ >= static_cast<GIntBig>(anFeatureOffsets_.size()) )
+    {
+        return NULL;
     }
+
+    const GIntBig iFeature =
+        anFIDOrder_.empty() ? iNextFeature_ : anFIDOrder_[iNextFeature_];
+    iNextFeature_++;
+
+    return ReadFeatureAt( poLayer, iFeature );
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONReader::GetFeature( OGRGeoJSONLayer* poLayer,
+                                          GIntBig nFID )
+{
+    if( poSplitter_ == NULL )
+        return NULL;
+
+    const GIntBig nFeatures = static_cast<GIntBig>(anFeatureOffsets_.size());
+    GIntBig iFeature = -1;
+    if( anFIDs_.empty() )
+    {
+        if( nFID >= 0 && nFID < nFeatures )
+            iFeature = nFID;
+    }
+    else if( anFIDOrder_.empty() )
+    {
+        std::vector<GIntBig>::const_iterator oIter =
+            std::lower_bound(anFIDs_.begin(), anFIDs_.end(), nFID);
+        if( oIter != anFIDs_.end() && *oIter == nFID )
+            iFeature = oIter - anFIDs_.begin();
+    }
+    else
+    {
+        std::vector<GIntBig>::const_iterator oIter =
+            std::lower_bound(anFIDOrder_.begin(), anFIDOrder_.end(), nFID,
+                             OGRGeoJSONFIDLessThanValue(anFIDs_));
+        if( oIter != anFIDOrder_.end() && anFIDs_[*oIter] == nFID )
+            iFeature = *oIter;
+    }
+    if( iFeature < 0 )
+        return NULL;
+
+    return ReadFeatureAt( poLayer, iFeature );
+}
+
+/************************************************************************/
+/*                           ReadFeatureAt()                            */
+/************************************************************************/
+
+// Reads the feature of index iFeature in file order. Consecutive features
+// are read without seeking.
+
+OGRFeature* OGRGeoJSONReader::ReadFeatureAt( OGRGeoJSONLayer* poLayer,
+                                             GIntBig iFeature )
+{
+    if( iFeature != iSplitterNextFeature_ )
+        poSplitter_->SeekToFeature( anFeatureOffsets_[iFeature] );
+    iSplitterNextFeature_ = -1;
+
+    const char* pszText = poSplitter_->GetNextFeatureText();
+    if( pszText == NULL )
+        return NULL;
+
+    json_object* poObj = NULL;
+    if( !OGRJSonParse(pszText, &poObj) )
+        return NULL;
+    iSplitterNextFeature_ = iFeature + 1;
+
+    // Geometry errors have already been reported by FirstPassReadLayer().
+    CPLPushErrorHandler(CPLQuietErrorHandler);
+    OGRFeature* poFeature = ReadFeature( poLayer, poObj );
+    CPLPopErrorHandler();
+    json_object_put(poObj);
+
+    poFeature->SetFID( anFIDs_.empty() ? iFeature : anFIDs_[iFeature] );
+
+    return poFeature;
 }
 
 /************************************************************************/
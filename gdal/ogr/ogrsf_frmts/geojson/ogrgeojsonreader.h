@@ -35,8 +35,10 @@
 #include "ogrsf_frmts.h"
 
 #include "ogr_json_header.h"
+#include "cpl_vsi.h"
 
 #include <set>
+#include <vector>
 
 /************************************************************************/
 /*                         FORWARD DECLARATIONS                         */
@@ -83,6 +85,70 @@ struct GeoJSONObject
     };
 };
 
+/************************************************************************/
+/*                      OGRGeoJSONFeatureSplitter                       */
+/************************************************************************/
+
+// Scans a FeatureCollection from a file and returns the text of the
+// elements of its top-level "features" array one at a time, so that
+// they can be parsed individually with a bounded amount of memory.
+
+class OGRGeoJSONFeatureSplitter
+{
+  public:
+    explicit OGRGeoJSONFeatureSplitter( VSILFILE* fp );
+    ~OGRGeoJSONFeatureSplitter();
+
+    void Rewind();
+    void SeekToFeature( vsi_l_offset nOffset );
+    const char* GetNextFeatureText();
+    vsi_l_offset GetFeatureOffset() const { return nFeatureOffset_; }
+
+    void SetCollectTopLevel( bool bCollect ) { bCollectTopLevel_ = bCollect; }
+    const CPLString& GetTopLevelText() const { return osTopLevel_; }
+    bool HasFoundFeatures() const { return bFoundFeatures_; }
+    bool HasError() const { return bError_; }
+
+  private:
+    enum State
+    {
+        eTopLevel,
+        eFeaturesExpected,
+        eInFeatures
+    };
+
+    VSILFILE* fp_;
+    std::vector<char> abyBuffer_;
+    vsi_l_offset nBufferOffset_;
+    size_t nBufferSize_;
+    size_t iBufferPos_;
+    bool bEOF_;
+    bool bFirstBuffer_;
+
+    State eState_;
+    int nDepth_;
+    bool bInString_;
+    bool bEscape_;
+    bool bExpectKey_;
+    bool bInKey_;
+    CPLString osKey_;
+
+    bool bInFeature_;
+    CPLString osFeature_;
+    vsi_l_offset nFeatureOffset_;
+
+    bool bCollectTopLevel_;
+    CPLString osTopLevel_;
+    bool bFoundFeatures_;
+    bool bError_;
+
+    bool FillBuffer();
+    void AppendSpan( size_t iStart, size_t iEnd );
+
+    OGRGeoJSONFeatureSplitter( OGRGeoJSONFeatureSplitter const& );
+    OGRGeoJSONFeatureSplitter& operator=( OGRGeoJSONFeatureSplitter const& );
+};
+
 /************************************************************************/
 /*                           OGRGeoJSONReader                           */
 /************************************************************************/
@@ -109,9 +175,28 @@ class OGRGeoJSONReader
 
     json_object* GetJSonObject() { return poGJObject_; }
 
+    bool FirstPassReadLayer( OGRGeoJSONDataSource* poDS, VSILFILE* fp );
+    void ResetReading();
+    OGRFeature* GetNextFeature( OGRGeoJSONLayer* poLayer );
+    OGRFeature* GetFeature( OGRGeoJSONLayer* poLayer, GIntBig nFID );
+    bool SetNextByIndex( GIntBig nIndex );
+
   private:
     json_object* poGJObject_;
 
+    // Streaming mode state, only set up by FirstPassReadLayer().
+    OGRGeoJSONFeatureSplitter* poSplitter_;
+    // Offset of each feature, in file order.
+    std::vector<vsi_l_offset> anFeatureOffsets_;
+    // FID of each feature in file order. Empty if it is the feature index.
+    std::vector<GIntBig> anFIDs_;
+    // Feature indexes sorted by FID. Empty if that is the file order.
+    std::vector<GIntBig> anFIDOrder_;
+    // Position of the next feature to read in FID order.
+    GIntBig iNextFeature_;
+    // Index of the feature the splitter returns next, or -1.
+    GIntBig iSplitterNextFeature_;
+
     bool bGeometryPreserve_;
     bool bAttributesSkip_;
     bool bFlattenNestedAttributes_;
@@ -140,6 +225,16 @@ class OGRGeoJSONReader
     //
     bool GenerateLayerDefn( OGRGeoJSONLayer* poLayer, json_object* poGJObject );
     bool GenerateFeatureDefn( OGRGeoJSONLayer* poLayer, json_object* poObj );
+    void FinalizeLayerDefn( OGRGeoJSONLayer* poLayer );
+    OGRGeoJSONLayer* CreateLayer( OGRGeoJSONDataSource* poDS,
+                                  const char* pszName,
+                                  json_object* poObj );
+    void StoreCollectionNativeData( OGRGeoJSONLayer* poLayer,
+                                    json_object* poObj );
+    bool SetUniqueFIDs( std::vector<GIntBig>& anIds );
+    bool AssignFIDs( OGRGeoJSONLayer* poLayer );
+    void FinalizeFIDs( bool bSorted );
+    OGRFeature* ReadFeatureAt( OGRGeoJSONLayer* poLayer, GIntBig iFeature );
     static bool AddFeature( OGRGeoJSONLayer* poLayer, OGRGeometry* poGeometry );
     static bool AddFeature( OGRGeoJSONLayer* poLayer, OGRFeature* poFeature );
 
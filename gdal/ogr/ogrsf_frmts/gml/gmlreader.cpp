@@ -166,7 +166,8 @@ CPL_UNUSED
     m_bSetWidthFlag(true),
     m_bReportAllAttributes(false),
     m_bIsWFSJointLayer(false),
-    m_bEmptyAsNull(true)
+    m_bEmptyAsNull(true),
+    m_nNumThreads(1)
 {
 #ifndef HAVE_XERCES
 #else
@@ -1266,6 +1267,149 @@ bool GMLReader::SaveClasses( const char *pszFile )
     return bSuccess;
 }
 
+/************************************************************************/
+/*                          GMLPrescanBatch                             */
+/*                                                                      */
+/*      Features whose geometry is built by a worker thread during      */
+/*      PrescanForSchema().                                             */
+/************************************************************************/
+
+class GMLPrescanBatch : public GMLTranslationBatch
+{
+    const GMLReader    *m_poReader;
+
+  protected:
+    void                TranslateFeature( size_t iFeature,
+                                          void *hCacheSRS ) override
+    {
+        if( apoGeometries.size() < apoFeatures.size() )
+            apoGeometries.resize(apoFeatures.size());
+        apoGeometries[iFeature] = m_poReader->BuildPrescanGeometry(
+            apoFeatures[iFeature]->GetGeometryList(), hCacheSRS);
+    }
+
+  public:
+    explicit            GMLPrescanBatch( const GMLReader *poReader ) :
+                            m_poReader(poReader) {}
+                       ~GMLPrescanBatch()
+    {
+        for( size_t i = 0; i < apoGeometries.size(); i++ )
+            delete apoGeometries[i];
+    }
+
+    // Whether the feature was the first one of its class.
+    std::vector<bool>   abFirstFeature;
+    std::vector<OGRGeometry *> apoGeometries;
+};
+
+/************************************************************************/
+/*                        BuildPrescanGeometry()                        */
+/************************************************************************/
+
+OGRGeometry *GMLReader::BuildPrescanGeometry(
+    const CPLXMLNode* const * papsGeometry, void *hCacheSRS ) const
+{
+    return GML_BuildOGRGeometryFromList(
+        papsGeometry, true, m_bInvertAxisOrderIfLatLong,
+        NULL, m_bConsiderEPSGAsURN,
+        m_eSwapCoordinates,
+        m_bGetSecondaryGeometryOption,
+        hCacheSRS, m_bFaceHoleNegative );
+}
+
+/************************************************************************/
+/*                        MergePrescanGeometry()                        */
+/*                                                                      */
+/*      Merge the geometry type, extent and SRS of a feature into its   */
+/*      class.  Takes ownership of poGeometry.                          */
+/************************************************************************/
+
+void GMLReader::MergePrescanGeometry( GMLFeatureClass *poClass,
+                                      const CPLXMLNode* const * papsGeometry,
+                                      OGRGeometry *poGeometry,
+                                      bool bFirstFeature,
+                                      bool bAnalyzeSRSPerFeature,
+                                      std::string &osWork )
+{
+    if( poGeometry != NULL && poClass->GetGeometryPropertyCount() > 0 )
+    {
+        OGRwkbGeometryType eGType = static_cast<OGRwkbGeometryType>(
+            poClass->GetGeometryProperty(0)->GetType());
+
+        if( bAnalyzeSRSPerFeature )
+        {
+            const char* pszSRSName =
+                GML_ExtractSrsNameFromGeometry(papsGeometry,
+                                               osWork,
+                                               m_bConsiderEPSGAsURN);
+            if (pszSRSName != NULL)
+                m_bCanUseGlobalSRSName = false;
+            poClass->MergeSRSName(pszSRSName);
+        }
+
+        // Merge geometry type into layer.
+        if( bFirstFeature && eGType == wkbUnknown )
+            eGType = wkbNone;
+
+        poClass->GetGeometryProperty(0)->SetType(
+            static_cast<int>(OGRMergeGeometryTypesEx(
+                eGType, poGeometry->getGeometryType(), true)));
+
+        // Merge extents.
+        if (!poGeometry->IsEmpty())
+        {
+            double dfXMin = 0.0;
+            double dfXMax = 0.0;
+            double dfYMin = 0.0;
+            double dfYMax = 0.0;
+
+            OGREnvelope sEnvelope;
+
+            poGeometry->getEnvelope( &sEnvelope );
+            if( poClass->GetExtents(&dfXMin, &dfXMax, &dfYMin, &dfYMax) )
+            {
+                dfXMin = std::min(dfXMin, sEnvelope.MinX);
+                dfXMax = std::max(dfXMax, sEnvelope.MaxX);
+                dfYMin = std::min(dfYMin, sEnvelope.MinY);
+                dfYMax = std::max(dfYMax, sEnvelope.MaxY);
+            }
+            else
+            {
+                dfXMin = sEnvelope.MinX;
+                dfXMax = sEnvelope.MaxX;
+                dfYMin = sEnvelope.MinY;
+                dfYMax = sEnvelope.MaxY;
+            }
+
+            poClass->SetExtents(dfXMin, dfXMax, dfYMin, dfYMax);
+        }
+    }
+    delete poGeometry;
+}
+
+/************************************************************************/
+/*                         MergePrescanBatch()                          */
+/************************************************************************/
+
+void GMLReader::MergePrescanBatch( GMLTranslationBatch *poBatchIn,
+                                   bool bAnalyzeSRSPerFeature,
+                                   std::string &osWork )
+{
+    GMLPrescanBatch *poBatch = static_cast<GMLPrescanBatch *>(poBatchIn);
+    for( size_t i = 0; i < poBatch->apoFeatures.size(); i++ )
+    {
+        poBatch->EmitErrors(i);
+        GMLFeature *poFeature = poBatch->apoFeatures[i];
+        MergePrescanGeometry(poFeature->GetClass(),
+                             poFeature->GetGeometryList(),
+                             poBatch->apoGeometries[i],
+                             poBatch->abFirstFeature[i],
+                             bAnalyzeSRSPerFeature, osWork);
+        poBatch->apoGeometries[i] = NULL;
+    }
+    delete poBatch;
+}
+
 /************************************************************************/
 /*                          PrescanForSchema()                          */
 /*                                                                      */
@@ -1302,6 +1446,21 @@ bool GMLReader::PrescanForSchema( bool bGetExtents,
 
     std::string osWork;
 
+    // Geometries are the costly part of the prescan: with several threads,
+    // they are built by workers while the parsing goes on, and merged into
+    // the classes in document order.
+    GMLThreadedTranslator *poTranslator = NULL;
+    if( bGetExtents && m_nNumThreads > 1 )
+    {
+        poTranslator = new GMLThreadedTranslator(m_nNumThreads);
+        if( !poTranslator->Init() )
+        {
+            delete poTranslator;
+            poTranslator = NULL;
+        }
+    }
+    GMLPrescanBatch *poBatch = NULL;
+
     GMLFeature *poFeature = NULL;
     while( (poFeature = NextFeature()) != NULL )
     {
@@ -1327,73 +1486,44 @@ bool GMLReader::PrescanForSchema( bool bGetExtents,
 
         if( bGetExtents && papsGeometry != NULL )
         {
-            OGRGeometry *poGeometry = GML_BuildOGRGeometryFromList(
-                papsGeometry, true, m_bInvertAxisOrderIfLatLong,
-                NULL, m_bConsiderEPSGAsURN,
-                m_eSwapCoordinates,
-                m_bGetSecondaryGeometryOption,
-                hCacheSRS, m_bFaceHoleNegative );
-
-            if( poGeometry != NULL && poClass->GetGeometryPropertyCount() > 0 )
+            const bool bFirstFeature = poClass->GetFeatureCount() == 1;
+            if( poTranslator != NULL )
             {
-                OGRwkbGeometryType eGType = static_cast<OGRwkbGeometryType>(
-                    poClass->GetGeometryProperty(0)->GetType());
-
-                if( bAnalyzeSRSPerFeature )
+                if( poBatch == NULL )
+                    poBatch = new GMLPrescanBatch(this);
+                poBatch->apoFeatures.push_back(poFeature);
+                poBatch->abFirstFeature.push_back(bFirstFeature);
+                if( poBatch->apoFeatures.size() >=
+                    poTranslator->GetBatchSize() )
                 {
-                    const char* pszSRSName =
-                        GML_ExtractSrsNameFromGeometry(papsGeometry,
-                                                       osWork,
-                                                       m_bConsiderEPSGAsURN);
-                    if (pszSRSName != NULL)
-                        m_bCanUseGlobalSRSName = false;
-                    poClass->MergeSRSName(pszSRSName);
-                }
-
-                // Merge geometry type into layer.
-                if( poClass->GetFeatureCount() == 1 && eGType == wkbUnknown )
-                    eGType = wkbNone;
-
-                poClass->GetGeometryProperty(0)->SetType(
-                    static_cast<int>(OGRMergeGeometryTypesEx(
-                        eGType, poGeometry->getGeometryType(), true)));
-
-                // Merge extents.
-                if (!poGeometry->IsEmpty())
-                {
-                    double dfXMin = 0.0;
-                    double dfXMax = 0.0;
-                    double dfYMin = 0.0;
-                    double dfYMax = 0.0;
-
-                    OGREnvelope sEnvelope;
-
-                    poGeometry->getEnvelope( &sEnvelope );
-                    if( poClass->GetExtents(&dfXMin, &dfXMax,
-                                            &dfYMin, &dfYMax) )
-                    {
-                        dfXMin = std::min(dfXMin, sEnvelope.MinX);
-                        dfXMax = std::max(dfXMax, sEnvelope.MaxX);
-                        dfYMin = std::min(dfYMin, sEnvelope.MinY);
-                        dfYMax = std::max(dfYMax, sEnvelope.MaxY);
-                    }
-                    else
-                    {
-                        dfXMin = sEnvelope.MinX;
-                        dfXMax = sEnvelope.MaxX;
-                        dfYMin = sEnvelope.MinY;
-                        dfYMax = sEnvelope.MaxY;
-                    }
-
-                    poClass->SetExtents(dfXMin, dfXMax, dfYMin, dfYMax);
+                    if( poTranslator->IsFull() )
+                        MergePrescanBatch(poTranslator->WaitNext(),
+                                          bAnalyzeSRSPerFeature, osWork);
+                    poTranslator->Submit(poBatch);
+                    poBatch = NULL;
                 }
-                delete poGeometry;
+                continue;
             }
+
+            OGRGeometry *poGeometry =
+                BuildPrescanGeometry(papsGeometry, hCacheSRS);
+            MergePrescanGeometry(poClass, papsGeometry, poGeometry,
+                                 bFirstFeature, bAnalyzeSRSPerFeature, osWork);
         }
 
         delete poFeature;
     }
 
+    if( poTranslator != NULL )
+    {
+        if( poBatch != NULL )
+            poTranslator->Submit(poBatch);
+        GMLTranslationBatch *poDoneBatch = NULL;
+        while( (poDoneBatch = poTranslator->WaitNext()) != NULL )
+            MergePrescanBatch(poDoneBatch, bAnalyzeSRSPerFeature, osWork);
+        delete poTranslator;
+    }
+
     GML_BuildOGRGeometryFromList_DestroyCache(hCacheSRS);
 
     for( int i = 0; i < m_nClassCount; i++ )
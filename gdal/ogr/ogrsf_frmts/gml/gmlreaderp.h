@@ -44,8 +44,10 @@
 #include "ogr_api.h"
 #include "cpl_vsi.h"
 #include "cpl_multiproc.h"
+#include "cpl_worker_thread_pool.h"
 #include "gmlutils.h"
 
+#include <deque>
 #include <string>
 #include <vector>
 
@@ -82,6 +84,91 @@ void gmlUpdateFeatureClasses ( GFSTemplateList *pCC,
                                GMLReader *pReader,
                                int *pnHasSequentialLayers );
 
+class GMLThreadedTranslator;
+
+/************************************************************************/
+/*                         GMLTranslationBatch                          */
+/*                                                                      */
+/*      A run of consecutive features parsed by the reader thread, to   */
+/*      be translated in a worker thread.  Errors emitted during the    */
+/*      translation are recorded, and re-emitted by the reader thread   */
+/*      with EmitErrors() when it consumes the matching feature.        */
+/************************************************************************/
+
+class GMLTranslationBatch
+{
+    friend class GMLThreadedTranslator;
+
+    typedef struct
+    {
+        size_t      iFeature;
+        CPLErr      eErr;
+        CPLErrorNum nErrorNum;
+        CPLString   osMsg;
+    } GMLTranslationError;
+
+    GMLThreadedTranslator *poTranslator;
+    bool                bDone;
+    size_t              iCurrentFeature;
+    size_t              iNextError;
+    std::vector<GMLTranslationError> aoErrors;
+
+    static void CPL_STDCALL ErrorHandler( CPLErr eErr, CPLErrorNum nErrorNum,
+                                          const char *pszMsg );
+    void                Translate( void *hCacheSRS );
+
+  protected:
+    // Called in a worker thread, for each feature in order.
+    virtual void        TranslateFeature( size_t iFeature,
+                                          void *hCacheSRS ) = 0;
+
+  public:
+                        GMLTranslationBatch();
+    virtual            ~GMLTranslationBatch();
+
+    // Parsed features, owned by the batch.
+    std::vector<GMLFeature *> apoFeatures;
+
+    void                EmitErrors( size_t iFeature );
+};
+
+/************************************************************************/
+/*                        GMLThreadedTranslator                         */
+/*                                                                      */
+/*      Pool of worker threads translating GMLTranslationBatch, while   */
+/*      the calling thread goes on parsing.  Batches are returned in    */
+/*      submission, that is document, order.                            */
+/************************************************************************/
+
+class GMLThreadedTranslator
+{
+    int                 m_nThreads;
+    size_t              m_nBatchSize;
+    CPLWorkerThreadPool m_oPool;
+    CPLMutex           *m_hMutex;
+    CPLCond            *m_hCond;
+    std::deque<GMLTranslationBatch *> m_apoPending;
+    // GML_BuildOGRGeometryFromList() caches not used by a worker.
+    std::vector<void *> m_ahFreeCacheSRS;
+
+    static void         TranslateFunc( void *pData );
+
+    CPL_DISALLOW_COPY_ASSIGN(GMLThreadedTranslator)
+
+  public:
+    explicit            GMLThreadedTranslator( int nThreads );
+                       ~GMLThreadedTranslator();
+
+    bool                Init();
+
+    size_t              GetBatchSize() const { return m_nBatchSize; }
+    bool                IsFull() const
+        { return m_apoPending.size() >= static_cast<size_t>(2 * m_nThreads); }
+
+    void                Submit( GMLTranslationBatch *poBatch );
+    GMLTranslationBatch *WaitNext();
+};
+
 /************************************************************************/
 /*                              GMLHandler                              */
 /************************************************************************/
@@ -400,6 +487,18 @@ class GMLReader : public IGMLReader
 
     bool          m_bEmptyAsNull;
 
+    int           m_nNumThreads;
+
+    void          MergePrescanGeometry( GMLFeatureClass *poClass,
+                                        const CPLXMLNode* const * papsGeometry,
+                                        OGRGeometry *poGeometry,
+                                        bool bFirstFeature,
+                                        bool bAnalyzeSRSPerFeature,
+                                        std::string &osWork );
+    void          MergePrescanBatch( GMLTranslationBatch *poBatch,
+                                     bool bAnalyzeSRSPerFeature,
+                                     std::string &osWork );
+
     bool          ParseXMLHugeFile( const char *pszOutputFilename,
                                     const bool bSqliteIsTempFile,
                                     const int iSqliteCacheMB );
@@ -445,6 +544,9 @@ public:
                                       bool bOnlyDetectSRS = false ) override;
     bool             PrescanForTemplate() override;
     bool             ReArrangeTemplateClasses( GFSTemplateList *pCC );
+    OGRGeometry     *BuildPrescanGeometry(
+                        const CPLXMLNode* const * papsGeometry,
+                        void *hCacheSRS ) const;
     void             ResetReading() override;
 
 // ---
@@ -494,6 +596,8 @@ public:
     void             SetEmptyAsNull( bool bFlag ) { m_bEmptyAsNull = bFlag; }
     bool             IsEmptyAsNull() const { return m_bEmptyAsNull; }
 
+    void             SetNumThreads( int nThreads ) { m_nNumThreads = nThreads; }
+
     static CPLMutex* hMutex;
 };
 
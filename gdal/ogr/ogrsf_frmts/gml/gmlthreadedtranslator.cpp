@@ -0,0 +1,225 @@
+/**********************************************************************
+ *
+ * Project:  GML Reader
+ * Purpose:  Translation of parsed features in worker threads.
+ *
+ **********************************************************************
+ * Copyright (c) 2018, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_port.h"
+#include "gmlreaderp.h"
+
+#include <algorithm>
+
+#include "cpl_conv.h"
+#include "cpl_error.h"
+#include "cpl_string.h"
+
+CPL_CVSID("$Id$")
+
+/************************************************************************/
+/*                        GMLTranslationBatch()                         */
+/************************************************************************/
+
+GMLTranslationBatch::GMLTranslationBatch() :
+    poTranslator(NULL),
+    bDone(false),
+    iCurrentFeature(0),
+    iNextError(0)
+{}
+
+/************************************************************************/
+/*                        ~GMLTranslationBatch()                        */
+/************************************************************************/
+
+GMLTranslationBatch::~GMLTranslationBatch()
+
+{
+    for( size_t i = 0; i < apoFeatures.size(); i++ )
+        delete apoFeatures[i];
+}
+
+/************************************************************************/
+/*                            ErrorHandler()                            */
+/************************************************************************/
+
+void CPL_STDCALL GMLTranslationBatch::ErrorHandler( CPLErr eErr,
+                                                    CPLErrorNum nErrorNum,
+                                                    const char *pszMsg )
+{
+    GMLTranslationBatch *poBatch =
+        static_cast<GMLTranslationBatch *>(CPLGetErrorHandlerUserData());
+    GMLTranslationError sError;
+    sError.iFeature = poBatch->iCurrentFeature;
+    sError.eErr = eErr;
+    sError.nErrorNum = nErrorNum;
+    sError.osMsg = pszMsg;
+    poBatch->aoErrors.push_back(sError);
+}
+
+/************************************************************************/
+/*                             Translate()                              */
+/************************************************************************/
+
+void GMLTranslationBatch::Translate( void *hCacheSRS )
+
+{
+    CPLPushErrorHandlerEx(ErrorHandler, this);
+    for( iCurrentFeature = 0; iCurrentFeature < apoFeatures.size();
+         iCurrentFeature++ )
+    {
+        TranslateFeature(iCurrentFeature, hCacheSRS);
+    }
+    CPLPopErrorHandler();
+}
+
+/************************************************************************/
+/*                             EmitErrors()                             */
+/*                                                                      */
+/*      Emit, in the calling thread, the errors recorded while          */
+/*      translating the features up to iFeature.                        */
+/************************************************************************/
+
+void GMLTranslationBatch::EmitErrors( size_t iFeature )
+
+{
+    while( iNextError < aoErrors.size() &&
+           aoErrors[iNextError].iFeature <= iFeature )
+    {
+        const GMLTranslationError &sError = aoErrors[iNextError++];
+        CPLError(sError.eErr, sError.nErrorNum, "%s", sError.osMsg.c_str());
+    }
+}
+
+/************************************************************************/
+/*                       GMLThreadedTranslator()                        */
+/************************************************************************/
+
+GMLThreadedTranslator::GMLThreadedTranslator( int nThreads ) :
+    m_nThreads(nThreads),
+    m_nBatchSize(static_cast<size_t>(std::max(1, atoi(
+        CPLGetConfigOption("GML_THREADED_BATCH_SIZE", "100"))))),
+    m_hMutex(NULL),
+    m_hCond(NULL)
+{}
+
+/************************************************************************/
+/*                       ~GMLThreadedTranslator()                       */
+/************************************************************************/
+
+GMLThreadedTranslator::~GMLThreadedTranslator()
+
+{
+    m_oPool.WaitCompletion();
+
+    for( size_t i = 0; i < m_apoPending.size(); i++ )
+        delete m_apoPending[i];
+    for( size_t i = 0; i < m_ahFreeCacheSRS.size(); i++ )
+        GML_BuildOGRGeometryFromList_DestroyCache(m_ahFreeCacheSRS[i]);
+
+    if( m_hCond != NULL )
+        CPLDestroyCond(m_hCond);
+    if( m_hMutex != NULL )
+        CPLDestroyMutex(m_hMutex);
+}
+
+/************************************************************************/
+/*                                Init()                                */
+/************************************************************************/
+
+bool GMLThreadedTranslator::Init()
+
+{
+    if( !m_oPool.Setup(m_nThreads, NULL, NULL) )
+        return false;
+    m_hCond = CPLCreateCond();
+    m_hMutex = CPLCreateMutex();
+    if( m_hMutex != NULL )
+        CPLReleaseMutex(m_hMutex);
+    return m_hCond != NULL && m_hMutex != NULL;
+}
+
+/************************************************************************/
+/*                           TranslateFunc()                            */
+/************************************************************************/
+
+void GMLThreadedTranslator::TranslateFunc( void *pData )
+
+{
+    GMLTranslationBatch *poBatch = static_cast<GMLTranslationBatch *>(pData);
+    GMLThreadedTranslator *poThis = poBatch->poTranslator;
+
+    // The SRS caches are not thread-safe: each running job takes one.
+    void *hCacheSRS = NULL;
+    {
+        CPLMutexHolderD(&poThis->m_hMutex);
+        if( !poThis->m_ahFreeCacheSRS.empty() )
+        {
+            hCacheSRS = poThis->m_ahFreeCacheSRS.back();
+            poThis->m_ahFreeCacheSRS.pop_back();
+        }
+    }
+    if( hCacheSRS == NULL )
+        hCacheSRS = GML_BuildOGRGeometryFromList_CreateCache();
+
+    poBatch->Translate(hCacheSRS);
+
+    CPLMutexHolderD(&poThis->m_hMutex);
+    poThis->m_ahFreeCacheSRS.push_back(hCacheSRS);
+    poBatch->bDone = true;
+    CPLCondBroadcast(poThis->m_hCond);
+}
+
+/************************************************************************/
+/*                               Submit()                               */
+/************************************************************************/
+
+void GMLThreadedTranslator::Submit( GMLTranslationBatch *poBatch )
+
+{
+    poBatch->poTranslator = this;
+    poBatch->bDone = false;
+    m_apoPending.push_back(poBatch);
+    m_oPool.SubmitJob(TranslateFunc, poBatch);
+}
+
+/************************************************************************/
+/*                              WaitNext()                              */
+/*                                                                      */
+/*      Return the oldest submitted batch, once translated, or NULL.    */
+/*      The caller takes ownership of it.                               */
+/************************************************************************/
+
+GMLTranslationBatch *GMLThreadedTranslator::WaitNext()
+
+{
+    if( m_apoPending.empty() )
+        return NULL;
+
+    GMLTranslationBatch *poBatch = m_apoPending.front();
+    m_apoPending.pop_front();
+
+    CPLMutexHolderD(&m_hMutex);
+    while( !poBatch->bDone )
+        CPLCondWait(m_hCond, m_hMutex);
+    return poBatch;
+}
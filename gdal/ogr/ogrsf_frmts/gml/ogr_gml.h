@@ -37,6 +37,8 @@
 #include "gmlutils.h"
 
 class OGRGMLDataSource;
+class OGRGMLTranslationBatch;
+class GMLThreadedTranslator;
 
 typedef enum
 {
@@ -70,6 +72,24 @@ class OGRGMLLayer : public OGRLayer
 
     bool                bFaceHoleNegative;
 
+    // Translation of the features in worker threads (NUM_THREADS).
+    GMLThreadedTranslator  *poTranslator;
+    OGRGMLTranslationBatch *poCurrentBatch;
+    bool                bReaderExhausted;
+
+    GIntBig             GetNextFID( const char *pszGML_FID );
+    OGRFeature         *TranslateFeature( GMLFeature *poGMLFeature,
+                                          GIntBig nFID, void *hCacheSRSIn,
+                                          CPLString &osError );
+    bool                ReportGeometryError( GMLFeature *poGMLFeature,
+                                             GIntBig nFID,
+                                             const CPLString &osError );
+    bool                AcceptFeature( OGRFeature *poFeature );
+    OGRFeature         *GetNextFeatureThreaded();
+    void                StopThreadedTranslation();
+
+    friend class OGRGMLTranslationBatch;
+
   public:
                         OGRGMLLayer( const char * pszName,
                                      bool bWriter,
@@ -156,6 +176,8 @@ class OGRGMLDataSource : public OGRDataSource
 
     bool                bEmptyAsNull;
 
+    int                 nNumThreads;
+
     void                FindAndParseTopElements(VSILFILE* fp);
     void                SetExtents(double dfMinX, double dfMinY, double dfMaxX, double dfMaxY);
 
@@ -204,6 +226,7 @@ class OGRGMLDataSource : public OGRDataSource
     bool                GetSecondaryGeometryOption() const { return m_bGetSecondaryGeometryOption; }
 
     ReadMode            GetReadMode() const { return eReadMode; }
+    int                 GetNumThreads() const { return nNumThreads; }
     void                SetStoredGMLFeature(GMLFeature* poStoredGMLFeatureIn) { poStoredGMLFeature = poStoredGMLFeatureIn; }
     GMLFeature*         PeekStoredGMLFeature() const { return  poStoredGMLFeature; }
 
@@ -111,7 +111,8 @@ OGRGMLDataSource::OGRGMLDataSource() :
     eReadMode(STANDARD),
     poStoredGMLFeature(NULL),
     poLastReadLayer(NULL),
-    bEmptyAsNull(true)
+    bEmptyAsNull(true),
+    nNumThreads(1)
 {}
 
 /************************************************************************/
@@ -664,6 +665,8 @@ bool OGRGMLDataSource::Open( GDALOpenInfo *poOpenInfo )
     static_cast<GMLReader *>(poReader)->SetReportAllAttributes(CPLFetchBool(
         poOpenInfo->papszOpenOptions, "GML_ATTRIBUTES_TO_OGR_FIELDS",
         CPLTestBool(CPLGetConfigOption("GML_ATTRIBUTES_TO_OGR_FIELDS", "NO"))));
+    nNumThreads = CPLGetNumThreads(poOpenInfo->papszOpenOptions, "1");
+    static_cast<GMLReader *>(poReader)->SetNumThreads(nNumThreads);
 
     // Find <gml:description>, <gml:name> and <gml:boundedBy>
     FindAndParseTopElements(fp);
@@ -28,6 +28,7 @@
  ****************************************************************************/
 
 #include "ogr_gml.h"
+#include "gmlreaderp.h"
 #include "gmlutils.h"
 #include "cpl_conv.h"
 #include "cpl_port.h"
@@ -62,7 +63,10 @@ OGRGMLLayer::OGRGMLLayer( const char * pszName,
     // Must be in synced in OGR_G_CreateFromGML(), OGRGMLLayer::OGRGMLLayer()
     // and GMLReader::GMLReader().
     bFaceHoleNegative(CPLTestBool(
-        CPLGetConfigOption("GML_FACE_HOLE_NEGATIVE", "NO")))
+        CPLGetConfigOption("GML_FACE_HOLE_NEGATIVE", "NO"))),
+    poTranslator(NULL),
+    poCurrentBatch(NULL),
+    bReaderExhausted(false)
 {
     SetDescription(poFeatureDefn->GetName());
     poFeatureDefn->Reference();
@@ -76,6 +80,8 @@ OGRGMLLayer::OGRGMLLayer( const char * pszName,
 OGRGMLLayer::~OGRGMLLayer()
 
 {
+    StopThreadedTranslation();
+
     CPLFree(pszFIDPrefix);
 
     if( poFeatureDefn )
@@ -107,6 +113,8 @@ void OGRGMLLayer::ResetReading()
         poDS->SetStoredGMLFeature(NULL);
     }
 
+    StopThreadedTranslation();
+
     iNextGMLId = 0;
     poDS->GetReader()->ResetReading();
     CPLDebug("GML", "ResetReading()");
@@ -131,6 +139,393 @@ static GIntBig Increment(GIntBig nVal)
     return nVal;
 }
 
+/************************************************************************/
+/*                             GetNextFID()                             */
+/************************************************************************/
+
+GIntBig OGRGMLLayer::GetNextFID( const char *pszGML_FID )
+
+{
+/* -------------------------------------------------------------------- */
+/*      Extract the fid:                                                */
+/*      -Assumes the fids are non-negative integers with an optional    */
+/*       prefix                                                         */
+/*      -If a prefix differs from the prefix of the first feature from  */
+/*       the poDS then the fids from the poDS are ignored and are       */
+/*       assigned serially thereafter                                   */
+/* -------------------------------------------------------------------- */
+    GIntBig nFID = -1;
+    if( bInvalidFIDFound )
+    {
+        nFID = iNextGMLId;
+        iNextGMLId = Increment(iNextGMLId);
+    }
+    else if( pszGML_FID == NULL )
+    {
+        bInvalidFIDFound = true;
+        nFID = iNextGMLId;
+        iNextGMLId = Increment(iNextGMLId);
+    }
+    else if( iNextGMLId == 0 )
+    {
+        int j = 0;
+        int i = static_cast<int>(strlen(pszGML_FID)) - 1;
+        while( i >= 0 && pszGML_FID[i] >= '0'
+                      && pszGML_FID[i] <= '9' && j < 20)
+        {
+            i--;
+            j++;
+        }
+        // i points the last character of the fid.
+        if( i >= 0 && j < 20 && pszFIDPrefix == NULL)
+        {
+            pszFIDPrefix = static_cast<char *>(CPLMalloc(i + 2));
+            pszFIDPrefix[i + 1] = '\0';
+            strncpy(pszFIDPrefix, pszGML_FID, i + 1);
+        }
+        // pszFIDPrefix now contains the prefix or NULL if no prefix is
+        // found.
+        if( j < 20 && sscanf(pszGML_FID + i + 1, CPL_FRMT_GIB, &nFID) == 1)
+        {
+            if( iNextGMLId <= nFID )
+                iNextGMLId = Increment(nFID);
+        }
+        else
+        {
+            bInvalidFIDFound = true;
+            nFID = iNextGMLId;
+            iNextGMLId = Increment(iNextGMLId);
+        }
+    }
+    else  // if( iNextGMLId != 0 ).
+    {
+        const char *pszFIDPrefix_notnull = pszFIDPrefix;
+        if (pszFIDPrefix_notnull == NULL) pszFIDPrefix_notnull = "";
+        int nLenPrefix = static_cast<int>(strlen(pszFIDPrefix_notnull));
+
+        if( strncmp(pszGML_FID, pszFIDPrefix_notnull, nLenPrefix) == 0 &&
+            strlen(pszGML_FID + nLenPrefix) < 20 &&
+            sscanf(pszGML_FID + nLenPrefix, CPL_FRMT_GIB, &nFID) == 1 )
+        {
+            // fid with the prefix. Using its numerical part.
+            if( iNextGMLId < nFID )
+                iNextGMLId = Increment(nFID);
+        }
+        else
+        {
+            // fid without the aforementioned prefix or a valid numerical
+            // part.
+            bInvalidFIDFound = true;
+            nFID = iNextGMLId;
+            iNextGMLId = Increment(iNextGMLId);
+        }
+    }
+
+    return nFID;
+}
+
+/************************************************************************/
+/*                          TranslateFeature()                          */
+/*                                                                      */
+/*      Build the OGRFeature of a GML feature, with its geometries but  */
+/*      without their SRS.  Returns NULL, with the last error message   */
+/*      in osError, if a geometry cannot be built.  May be called from  */
+/*      a worker thread, with its own hCacheSRSIn.                      */
+/************************************************************************/
+
+OGRFeature *OGRGMLLayer::TranslateFeature( GMLFeature *poGMLFeature,
+                                           GIntBig nFID, void *hCacheSRSIn,
+                                           CPLString &osError )
+{
+    OGRFeature *poOGRFeature = new OGRFeature(poFeatureDefn);
+
+    const CPLXMLNode *const *papsGeometry = poGMLFeature->GetGeometryList();
+    const char *pszSRSName = poDS->GetGlobalSRSName();
+
+    if( poFeatureDefn->GetGeomFieldCount() > 1 )
+    {
+        for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
+        {
+            const CPLXMLNode *psGeom = poGMLFeature->GetGeometryRef(i);
+            if( psGeom != NULL )
+            {
+                const CPLXMLNode *myGeometryList[2] = {psGeom, NULL};
+                OGRGeometry *poGeom = GML_BuildOGRGeometryFromList(
+                    myGeometryList, true,
+                    poDS->GetInvertAxisOrderIfLatLong(), pszSRSName,
+                    poDS->GetConsiderEPSGAsURN(),
+                    poDS->GetSwapCoordinates(),
+                    poDS->GetSecondaryGeometryOption(), hCacheSRSIn,
+                    bFaceHoleNegative);
+
+                // Do geometry type changes if needed to match layer
+                // geometry type.
+                if (poGeom != NULL)
+                {
+                    poOGRFeature->SetGeomFieldDirectly(i,
+                        OGRGeometryFactory::forceTo(
+                            poGeom,
+                            poFeatureDefn->GetGeomFieldDefn(i)->GetType()));
+                }
+                else
+                {
+                    // We assume the createFromGML() function would have
+                    // already reported the error.
+                    osError = CPLGetLastErrorMsg();
+                    delete poOGRFeature;
+                    return NULL;
+                }
+            }
+        }
+    }
+    else if (papsGeometry[0] != NULL)
+    {
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        OGRGeometry *poGeom = GML_BuildOGRGeometryFromList(
+            papsGeometry, true,
+            poDS->GetInvertAxisOrderIfLatLong(),
+            pszSRSName,
+            poDS->GetConsiderEPSGAsURN(),
+            poDS->GetSwapCoordinates(),
+            poDS->GetSecondaryGeometryOption(),
+            hCacheSRSIn,
+            bFaceHoleNegative);
+        CPLPopErrorHandler();
+
+        // Do geometry type changes if needed to match layer geometry type.
+        if (poGeom != NULL)
+        {
+            poOGRFeature->SetGeometryDirectly(
+                OGRGeometryFactory::forceTo(poGeom, GetGeomType()));
+        }
+        else
+        {
+            osError = CPLGetLastErrorMsg();
+            delete poOGRFeature;
+            return NULL;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Convert the attributes.                                         */
+/* -------------------------------------------------------------------- */
+    poOGRFeature->SetFID(nFID);
+
+    int iDstField = 0;
+    const char *pszGML_FID = poGMLFeature->GetFID();
+    if (poDS->ExposeId())
+    {
+        if (pszGML_FID)
+            poOGRFeature->SetField(iDstField, pszGML_FID);
+        iDstField++;
+    }
+
+    const int nPropertyCount = poFClass->GetPropertyCount();
+    for( int iField = 0; iField < nPropertyCount; iField++, iDstField++ )
+    {
+        const GMLProperty *psGMLProperty =
+            poGMLFeature->GetProperty(iField);
+        if( psGMLProperty == NULL || psGMLProperty->nSubProperties == 0 )
+            continue;
+
+        if( EQUAL(psGMLProperty->papszSubProperties[0], OGR_GML_NULL) )
+        {
+            poOGRFeature->SetFieldNull( iDstField );
+            continue;
+        }
+
+        switch( poFClass->GetProperty(iField)->GetType() )
+        {
+          case GMLPT_Real:
+          {
+              poOGRFeature->SetField(
+                  iDstField, CPLAtof(psGMLProperty->papszSubProperties[0]));
+          }
+          break;
+
+          case GMLPT_IntegerList:
+          {
+              const int nCount = psGMLProperty->nSubProperties;
+              int *panIntList =
+                  static_cast<int *>(CPLMalloc(sizeof(int) * nCount));
+
+              for( int i = 0; i < nCount; i++ )
+                  panIntList[i] =
+                      atoi(psGMLProperty->papszSubProperties[i]);
+
+              poOGRFeature->SetField(iDstField, nCount, panIntList);
+              CPLFree(panIntList);
+          }
+          break;
+
+          case GMLPT_Integer64List:
+          {
+              const int nCount = psGMLProperty->nSubProperties;
+              GIntBig *panIntList = static_cast<GIntBig *>(
+                  CPLMalloc(sizeof(GIntBig) * nCount));
+
+              for( int i = 0; i < nCount; i++ )
+                  panIntList[i] =
+                      CPLAtoGIntBig(psGMLProperty->papszSubProperties[i]);
+
+              poOGRFeature->SetField(iDstField, nCount, panIntList);
+              CPLFree(panIntList);
+          }
+          break;
+
+          case GMLPT_RealList:
+          {
+              const int nCount = psGMLProperty->nSubProperties;
+              double *padfList = static_cast<double *>(
+                  CPLMalloc(sizeof(double) * nCount));
+
+              for( int i = 0; i < nCount; i++ )
+                  padfList[i] =
+                      CPLAtof(psGMLProperty->papszSubProperties[i]);
+
+              poOGRFeature->SetField(iDstField, nCount, padfList);
+              CPLFree(padfList);
+          }
+          break;
+
+          case GMLPT_StringList:
+          case GMLPT_FeaturePropertyList:
+          {
+              poOGRFeature->SetField(iDstField,
+                                     psGMLProperty->papszSubProperties);
+          }
+          break;
+
+          case GMLPT_Boolean:
+          {
+              if( strcmp(psGMLProperty->papszSubProperties[0],
+                         "true") == 0 ||
+                  strcmp(psGMLProperty->papszSubProperties[0], "1") == 0 )
+              {
+                  poOGRFeature->SetField(iDstField, 1);
+              }
+              else if( strcmp(psGMLProperty->papszSubProperties[0],
+                              "false") == 0 ||
+                       strcmp(psGMLProperty->papszSubProperties[0],
+                              "0") == 0 )
+              {
+                  poOGRFeature->SetField(iDstField, 0);
+              }
+              else
+              {
+                  poOGRFeature->SetField(
+                      iDstField, psGMLProperty->papszSubProperties[0]);
+              }
+              break;
+          }
+
+          case GMLPT_BooleanList:
+          {
+              const int nCount = psGMLProperty->nSubProperties;
+              int *panIntList =
+                  static_cast<int *>(CPLMalloc(sizeof(int) * nCount));
+
+              for( int i = 0; i < nCount; i++ )
+              {
+                  panIntList[i] = (
+                      strcmp(psGMLProperty->papszSubProperties[i],
+                             "true") == 0 ||
+                      strcmp(psGMLProperty->papszSubProperties[i],
+                             "1") == 0 );
+              }
+
+              poOGRFeature->SetField(iDstField, nCount, panIntList);
+              CPLFree(panIntList);
+              break;
+          }
+
+          default:
+              poOGRFeature->SetField(iDstField,
+                                     psGMLProperty->papszSubProperties[0]);
+              break;
+        }
+    }
+
+
+    return poOGRFeature;
+}
+
+/************************************************************************/
+/*                        ReportGeometryError()                         */
+/*                                                                      */
+/*      Report a geometry that could not be built.  Returns true if     */
+/*      reading should go on with the next feature.                     */
+/************************************************************************/
+
+bool OGRGMLLayer::ReportGeometryError( GMLFeature *poGMLFeature, GIntBig nFID,
+                                       const CPLString &osError )
+{
+    // With several geometry fields, the error was reported by the parser.
+    if( poFeatureDefn->GetGeomFieldCount() > 1 )
+        return false;
+
+    const char *pszGML_FID = poGMLFeature->GetFID();
+    const bool bGoOn = CPLTestBool(
+        CPLGetConfigOption("GML_SKIP_CORRUPTED_FEATURES", "NO"));
+
+    CPLError(bGoOn ? CE_Warning : CE_Failure, CPLE_AppDefined,
+             "Geometry of feature " CPL_FRMT_GIB
+             " %scannot be parsed: %s%s",
+             nFID, pszGML_FID ? CPLSPrintf("%s ", pszGML_FID) : "",
+             osError.c_str(),
+             bGoOn ? ". Skipping to next feature.":
+             ". You may set the GML_SKIP_CORRUPTED_FEATURES "
+             "configuration option to YES to skip to the next "
+             "feature");
+    return bGoOn;
+}
+
+/************************************************************************/
+/*                           AcceptFeature()                            */
+/*                                                                      */
+/*      Apply the spatial and attribute filters to a translated         */
+/*      feature, and assign the SRS of its geometries.                  */
+/************************************************************************/
+
+bool OGRGMLLayer::AcceptFeature( OGRFeature *poOGRFeature )
+
+{
+    if( m_poFilterGeom != NULL )
+    {
+        OGRGeometry *poFilteredGeom = NULL;
+        if( poFeatureDefn->GetGeomFieldCount() > 1 )
+        {
+            if( m_iGeomFieldFilter >= 0 &&
+                m_iGeomFieldFilter < poFeatureDefn->GetGeomFieldCount() )
+                poFilteredGeom =
+                    poOGRFeature->GetGeomFieldRef(m_iGeomFieldFilter);
+        }
+        else
+        {
+            poFilteredGeom = poOGRFeature->GetGeometryRef();
+        }
+        if( poFilteredGeom != NULL &&
+            !FilterGeometry(poFilteredGeom) )
+            return false;
+    }
+
+    // Assign SRS.
+    for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
+    {
+        OGRGeometry *poGeom = poOGRFeature->GetGeomFieldRef(i);
+        if( poGeom != NULL )
+        {
+            OGRSpatialReference *poSRS =
+                poFeatureDefn->GetGeomFieldDefn(i)->GetSpatialRef();
+            if (poSRS != NULL)
+                poGeom->assignSpatialReference(poSRS);
+        }
+    }
+
+    // Test against the attribute query.
+    return m_poAttrQuery == NULL || m_poAttrQuery->Evaluate(poOGRFeature);
+}
+
 /************************************************************************/
 /*                           GetNextFeature()                           */
 /************************************************************************/
@@ -152,6 +547,11 @@ OGRFeature *OGRGMLLayer::GetNextFeature()
         poDS->SetLastReadLayer(this);
     }
 
+    // Features of other layers are kept aside by the interleaved and
+    // sequential modes: only the standard mode can parse ahead.
+    if( poDS->GetNumThreads() > 1 && poDS->GetReadMode() == STANDARD )
+        return GetNextFeatureThreaded();
+
 /* ==================================================================== */
 /*      Loop till we find and translate a feature meeting all our       */
 /*      requirements.                                                   */
@@ -195,386 +595,175 @@ OGRFeature *OGRGMLLayer::GetNextFeature()
             }
         }
 
+        const GIntBig nFID = GetNextFID(poGMLFeature->GetFID());
+
 /* -------------------------------------------------------------------- */
-/*      Extract the fid:                                                */
-/*      -Assumes the fids are non-negative integers with an optional    */
-/*       prefix                                                         */
-/*      -If a prefix differs from the prefix of the first feature from  */
-/*       the poDS then the fids from the poDS are ignored and are       */
-/*       assigned serially thereafter                                   */
+/*      Convert the whole feature into an OGRFeature.                   */
 /* -------------------------------------------------------------------- */
-        GIntBig nFID = -1;
-        const char *pszGML_FID = poGMLFeature->GetFID();
-        if( bInvalidFIDFound )
+        CPLString osError;
+        OGRFeature *poOGRFeature =
+            TranslateFeature(poGMLFeature, nFID, hCacheSRS, osError);
+        if( poOGRFeature == NULL )
         {
-            nFID = iNextGMLId;
-            iNextGMLId = Increment(iNextGMLId);
-        }
-        else if( pszGML_FID == NULL )
-        {
-            bInvalidFIDFound = true;
-            nFID = iNextGMLId;
-            iNextGMLId = Increment(iNextGMLId);
+            const bool bGoOn =
+                ReportGeometryError(poGMLFeature, nFID, osError);
+            delete poGMLFeature;
+            if( bGoOn )
+                continue;
+            return NULL;
         }
-        else if( iNextGMLId == 0 )
+        delete poGMLFeature;
+
+        if( !AcceptFeature(poOGRFeature) )
         {
-            int j = 0;
-            int i = static_cast<int>(strlen(pszGML_FID)) - 1;
-            while( i >= 0 && pszGML_FID[i] >= '0'
-                          && pszGML_FID[i] <= '9' && j < 20)
-            {
-                i--;
-                j++;
-            }
-            // i points the last character of the fid.
-            if( i >= 0 && j < 20 && pszFIDPrefix == NULL)
-            {
-                pszFIDPrefix = static_cast<char *>(CPLMalloc(i + 2));
-                pszFIDPrefix[i + 1] = '\0';
-                strncpy(pszFIDPrefix, pszGML_FID, i + 1);
-            }
-            // pszFIDPrefix now contains the prefix or NULL if no prefix is
-            // found.
-            if( j < 20 && sscanf(pszGML_FID + i + 1, CPL_FRMT_GIB, &nFID) == 1)
-            {
-                if( iNextGMLId <= nFID )
-                    iNextGMLId = Increment(nFID);
-            }
-            else
-            {
-                bInvalidFIDFound = true;
-                nFID = iNextGMLId;
-                iNextGMLId = Increment(iNextGMLId);
-            }
+            delete poOGRFeature;
+            continue;
         }
-        else  // if( iNextGMLId != 0 ).
-        {
-            const char *pszFIDPrefix_notnull = pszFIDPrefix;
-            if (pszFIDPrefix_notnull == NULL) pszFIDPrefix_notnull = "";
-            int nLenPrefix = static_cast<int>(strlen(pszFIDPrefix_notnull));
 
-            if( strncmp(pszGML_FID, pszFIDPrefix_notnull, nLenPrefix) == 0 &&
-                strlen(pszGML_FID + nLenPrefix) < 20 &&
-                sscanf(pszGML_FID + nLenPrefix, CPL_FRMT_GIB, &nFID) == 1 )
-            {
-                // fid with the prefix. Using its numerical part.
-                if( iNextGMLId < nFID )
-                    iNextGMLId = Increment(nFID);
-            }
-            else
-            {
-                // fid without the aforementioned prefix or a valid numerical
-                // part.
-                bInvalidFIDFound = true;
-                nFID = iNextGMLId;
-                iNextGMLId = Increment(iNextGMLId);
-            }
-        }
+        // Got the desired feature.
+        return poOGRFeature;
+    }
 
-/* -------------------------------------------------------------------- */
-/*      Does it satisfy the spatial query, if there is one?             */
-/* -------------------------------------------------------------------- */
+    return NULL;
+}
 
-        OGRGeometry **papoGeometries = NULL;
-        const CPLXMLNode *const *papsGeometry = poGMLFeature->GetGeometryList();
+/************************************************************************/
+/*                        OGRGMLTranslationBatch                        */
+/************************************************************************/
 
-        OGRGeometry *poGeom = NULL;
+class OGRGMLTranslationBatch : public GMLTranslationBatch
+{
+    OGRGMLLayer        *m_poLayer;
 
-        if( poFeatureDefn->GetGeomFieldCount() > 1 )
+  protected:
+    void                TranslateFeature( size_t iFeature,
+                                          void *hCacheSRS ) override
+    {
+        if( apoOGRFeatures.size() < apoFeatures.size() )
         {
-            papoGeometries = static_cast<OGRGeometry **>(CPLCalloc(
-                poFeatureDefn->GetGeomFieldCount(), sizeof(OGRGeometry *)));
-            const char *pszSRSName = poDS->GetGlobalSRSName();
-            for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
-            {
-                const CPLXMLNode *psGeom = poGMLFeature->GetGeometryRef(i);
-                if( psGeom != NULL )
-                {
-                    const CPLXMLNode *myGeometryList[2] = {psGeom, NULL};
-                    poGeom = GML_BuildOGRGeometryFromList(
-                        myGeometryList, true,
-                        poDS->GetInvertAxisOrderIfLatLong(), pszSRSName,
-                        poDS->GetConsiderEPSGAsURN(),
-                        poDS->GetSwapCoordinates(),
-                        poDS->GetSecondaryGeometryOption(), hCacheSRS,
-                        bFaceHoleNegative);
-
-                    // Do geometry type changes if needed to match layer
-                    // geometry type.
-                    if (poGeom != NULL)
-                    {
-                        papoGeometries[i] = OGRGeometryFactory::forceTo(
-                            poGeom,
-                            poFeatureDefn->GetGeomFieldDefn(i)->GetType());
-                        poGeom = NULL;
-                    }
-                    else
-                    {
-                        // We assume the createFromGML() function would have
-                        // already reported the error.
-                        for(int j = 0; j < poFeatureDefn->GetGeomFieldCount();
-                            j++)
-                        {
-                            delete papoGeometries[j];
-                        }
-                        CPLFree(papoGeometries);
-                        delete poGMLFeature;
-                        return NULL;
-                    }
-                }
-            }
-
-            if( m_poFilterGeom != NULL &&
-                m_iGeomFieldFilter >= 0 &&
-                m_iGeomFieldFilter < poFeatureDefn->GetGeomFieldCount() &&
-                papoGeometries[m_iGeomFieldFilter] &&
-                !FilterGeometry( papoGeometries[m_iGeomFieldFilter] ) )
-            {
-                for( int j = 0; j < poFeatureDefn->GetGeomFieldCount(); j++ )
-                {
-                    delete papoGeometries[j];
-                }
-                CPLFree(papoGeometries);
-                delete poGMLFeature;
-                continue;
-            }
+            apoOGRFeatures.resize(apoFeatures.size());
+            aosError.resize(apoFeatures.size());
         }
-        else if (papsGeometry[0] != NULL)
-        {
-            const char *pszSRSName = poDS->GetGlobalSRSName();
-            CPLPushErrorHandler(CPLQuietErrorHandler);
-            poGeom = GML_BuildOGRGeometryFromList(
-                papsGeometry, true,
-                poDS->GetInvertAxisOrderIfLatLong(),
-                pszSRSName,
-                poDS->GetConsiderEPSGAsURN(),
-                poDS->GetSwapCoordinates(),
-                poDS->GetSecondaryGeometryOption(),
-                hCacheSRS,
-                bFaceHoleNegative);
-            CPLPopErrorHandler();
-
-            // Do geometry type changes if needed to match layer geometry type.
-            if (poGeom != NULL)
-            {
-                poGeom = OGRGeometryFactory::forceTo(poGeom, GetGeomType());
-            }
-            else
-            {
-                const CPLString osLastErrorMsg(CPLGetLastErrorMsg());
-
-                const bool bGoOn = CPLTestBool(
-                    CPLGetConfigOption("GML_SKIP_CORRUPTED_FEATURES", "NO"));
-
-                CPLError(bGoOn ? CE_Warning : CE_Failure, CPLE_AppDefined,
-                         "Geometry of feature " CPL_FRMT_GIB
-                         " %scannot be parsed: %s%s",
-                         nFID, pszGML_FID ? CPLSPrintf("%s ", pszGML_FID) : "",
-                         osLastErrorMsg.c_str(),
-                         bGoOn ? ". Skipping to next feature.":
-                         ". You may set the GML_SKIP_CORRUPTED_FEATURES "
-                         "configuration option to YES to skip to the next "
-                         "feature");
-                delete poGMLFeature;
-                if( bGoOn )
-                    continue;
-                return NULL;
-            }
+        apoOGRFeatures[iFeature] = m_poLayer->TranslateFeature(
+            apoFeatures[iFeature], anFID[iFeature], hCacheSRS,
+            aosError[iFeature]);
+    }
 
-            if( m_poFilterGeom != NULL && !FilterGeometry(poGeom) )
-            {
-                delete poGMLFeature;
-                delete poGeom;
-                continue;
-            }
-        }
+  public:
+    explicit            OGRGMLTranslationBatch( OGRGMLLayer *poLayer ) :
+                            m_poLayer(poLayer), iNextFeature(0) {}
+                       ~OGRGMLTranslationBatch()
+    {
+        for( size_t i = 0; i < apoOGRFeatures.size(); i++ )
+            delete apoOGRFeatures[i];
+    }
 
-/* -------------------------------------------------------------------- */
-/*      Convert the whole feature into an OGRFeature.                   */
-/* -------------------------------------------------------------------- */
-        int iDstField = 0;
-        OGRFeature *poOGRFeature = new OGRFeature(poFeatureDefn);
+    std::vector<GIntBig>      anFID;
+    std::vector<OGRFeature *> apoOGRFeatures;
+    std::vector<CPLString>    aosError;
+    size_t                    iNextFeature;
+};
 
-        poOGRFeature->SetFID(nFID);
-        if (poDS->ExposeId())
+/************************************************************************/
+/*                       GetNextFeatureThreaded()                       */
+/*                                                                      */
+/*      The XML is parsed, and the FIDs assigned, in the calling        */
+/*      thread, which hands batches of parsed features to worker        */
+/*      threads for the translation of their attributes and            */
+/*      geometries, and consumes the results in document order.         */
+/************************************************************************/
+
+OGRFeature *OGRGMLLayer::GetNextFeatureThreaded()
+
+{
+    if( poTranslator == NULL )
+    {
+        poTranslator = new GMLThreadedTranslator(poDS->GetNumThreads());
+        if( !poTranslator->Init() )
         {
-            if (pszGML_FID)
-                poOGRFeature->SetField(iDstField, pszGML_FID);
-            iDstField++;
+            delete poTranslator;
+            poTranslator = NULL;
+            return NULL;
         }
+    }
 
-        const int nPropertyCount = poFClass->GetPropertyCount();
-        for( int iField = 0; iField < nPropertyCount; iField++, iDstField++ )
+    while( true )
+    {
+        // Parse ahead to keep the worker threads busy.
+        while( !bReaderExhausted && !poTranslator->IsFull() )
         {
-            const GMLProperty *psGMLProperty =
-                poGMLFeature->GetProperty(iField);
-            if( psGMLProperty == NULL || psGMLProperty->nSubProperties == 0 )
-                continue;
-
-            if( EQUAL(psGMLProperty->papszSubProperties[0], OGR_GML_NULL) )
+            OGRGMLTranslationBatch *poBatch = new OGRGMLTranslationBatch(this);
+            while( poBatch->apoFeatures.size() < poTranslator->GetBatchSize() )
             {
-                poOGRFeature->SetFieldNull( iDstField );
-                continue;
-            }
-
-            switch( poFClass->GetProperty(iField)->GetType() )
-            {
-              case GMLPT_Real:
-              {
-                  poOGRFeature->SetField(
-                      iDstField, CPLAtof(psGMLProperty->papszSubProperties[0]));
-              }
-              break;
-
-              case GMLPT_IntegerList:
-              {
-                  const int nCount = psGMLProperty->nSubProperties;
-                  int *panIntList =
-                      static_cast<int *>(CPLMalloc(sizeof(int) * nCount));
-
-                  for( int i = 0; i < nCount; i++ )
-                      panIntList[i] =
-                          atoi(psGMLProperty->papszSubProperties[i]);
-
-                  poOGRFeature->SetField(iDstField, nCount, panIntList);
-                  CPLFree(panIntList);
-              }
-              break;
-
-              case GMLPT_Integer64List:
-              {
-                  const int nCount = psGMLProperty->nSubProperties;
-                  GIntBig *panIntList = static_cast<GIntBig *>(
-                      CPLMalloc(sizeof(GIntBig) * nCount));
-
-                  for( int i = 0; i < nCount; i++ )
-                      panIntList[i] =
-                          CPLAtoGIntBig(psGMLProperty->papszSubProperties[i]);
-
-                  poOGRFeature->SetField(iDstField, nCount, panIntList);
-                  CPLFree(panIntList);
-              }
-              break;
-
-              case GMLPT_RealList:
-              {
-                  const int nCount = psGMLProperty->nSubProperties;
-                  double *padfList = static_cast<double *>(
-                      CPLMalloc(sizeof(double) * nCount));
-
-                  for( int i = 0; i < nCount; i++ )
-                      padfList[i] =
-                          CPLAtof(psGMLProperty->papszSubProperties[i]);
-
-                  poOGRFeature->SetField(iDstField, nCount, padfList);
-                  CPLFree(padfList);
-              }
-              break;
-
-              case GMLPT_StringList:
-              case GMLPT_FeaturePropertyList:
-              {
-                  poOGRFeature->SetField(iDstField,
-                                         psGMLProperty->papszSubProperties);
-              }
-              break;
-
-              case GMLPT_Boolean:
-              {
-                  if( strcmp(psGMLProperty->papszSubProperties[0],
-                             "true") == 0 ||
-                      strcmp(psGMLProperty->papszSubProperties[0], "1") == 0 )
-                  {
-                      poOGRFeature->SetField(iDstField, 1);
-                  }
-                  else if( strcmp(psGMLProperty->papszSubProperties[0],
-                                  "false") == 0 ||
-                           strcmp(psGMLProperty->papszSubProperties[0],
-                                  "0") == 0 )
-                  {
-                      poOGRFeature->SetField(iDstField, 0);
-                  }
-                  else
-                  {
-                      poOGRFeature->SetField(
-                          iDstField, psGMLProperty->papszSubProperties[0]);
-                  }
-                  break;
-              }
-
-              case GMLPT_BooleanList:
-              {
-                  const int nCount = psGMLProperty->nSubProperties;
-                  int *panIntList =
-                      static_cast<int *>(CPLMalloc(sizeof(int) * nCount));
-
-                  for( int i = 0; i < nCount; i++ )
-                  {
-                      panIntList[i] = (
-                          strcmp(psGMLProperty->papszSubProperties[i],
-                                 "true") == 0 ||
-                          strcmp(psGMLProperty->papszSubProperties[i],
-                                 "1") == 0 );
-                  }
-
-                  poOGRFeature->SetField(iDstField, nCount, panIntList);
-                  CPLFree(panIntList);
-                  break;
-              }
+                GMLFeature *poGMLFeature = poDS->GetReader()->NextFeature();
+                if( poGMLFeature == NULL )
+                {
+                    bReaderExhausted = true;
+                    break;
+                }
+                m_nFeaturesRead++;
 
-              default:
-                  poOGRFeature->SetField(iDstField,
-                                         psGMLProperty->papszSubProperties[0]);
-                  break;
+                if( poGMLFeature->GetClass() != poFClass )
+                {
+                    delete poGMLFeature;
+                    continue;
+                }
+                poBatch->apoFeatures.push_back(poGMLFeature);
+                poBatch->anFID.push_back(GetNextFID(poGMLFeature->GetFID()));
             }
-        }
-
-        delete poGMLFeature;
-        poGMLFeature = NULL;
-
-        // Assign the geometry before the attribute filter because
-        // the attribute filter may use a special field like OGR_GEOMETRY.
-        if( papoGeometries != NULL )
-        {
-            for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
+            if( poBatch->apoFeatures.empty() )
             {
-                poOGRFeature->SetGeomFieldDirectly(i, papoGeometries[i]);
+                delete poBatch;
+                break;
             }
-            CPLFree(papoGeometries);
-            papoGeometries = NULL;
+            poTranslator->Submit(poBatch);
         }
-        else
+
+        if( poCurrentBatch == NULL ||
+            poCurrentBatch->iNextFeature == poCurrentBatch->apoFeatures.size() )
         {
-            poOGRFeature->SetGeometryDirectly(poGeom);
+            delete poCurrentBatch;
+            poCurrentBatch =
+                static_cast<OGRGMLTranslationBatch *>(poTranslator->WaitNext());
+            if( poCurrentBatch == NULL )
+                return NULL;
         }
 
-        // Assign SRS.
-        for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
+        const size_t i = poCurrentBatch->iNextFeature++;
+        poCurrentBatch->EmitErrors(i);
+        OGRFeature *poOGRFeature = poCurrentBatch->apoOGRFeatures[i];
+        poCurrentBatch->apoOGRFeatures[i] = NULL;
+        if( poOGRFeature == NULL )
         {
-            poGeom = poOGRFeature->GetGeomFieldRef(i);
-            if( poGeom != NULL )
-            {
-                OGRSpatialReference *poSRS =
-                    poFeatureDefn->GetGeomFieldDefn(i)->GetSpatialRef();
-                if (poSRS != NULL)
-                    poGeom->assignSpatialReference(poSRS);
-            }
+            if( ReportGeometryError(poCurrentBatch->apoFeatures[i],
+                                    poCurrentBatch->anFID[i],
+                                    poCurrentBatch->aosError[i]) )
+                continue;
+            return NULL;
         }
 
-/* -------------------------------------------------------------------- */
-/*      Test against the attribute query.                               */
-/* -------------------------------------------------------------------- */
-        if( m_poAttrQuery != NULL && !m_poAttrQuery->Evaluate(poOGRFeature) )
+        if( !AcceptFeature(poOGRFeature) )
         {
             delete poOGRFeature;
             continue;
         }
 
-        // Got the desired feature.
         return poOGRFeature;
     }
+}
 
-    return NULL;
+/************************************************************************/
+/*                      StopThreadedTranslation()                       */
+/************************************************************************/
+
+void OGRGMLLayer::StopThreadedTranslation()
+
+{
+    delete poTranslator;
+    poTranslator = NULL;
+    delete poCurrentBatch;
+    poCurrentBatch = NULL;
+    bReaderExhausted = false;
 }
 
 /************************************************************************/
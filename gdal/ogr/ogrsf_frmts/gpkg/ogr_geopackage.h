@@ -64,6 +64,25 @@ static const GUInt32 GPKG_1_2_VERSION = 0x000027D8U; // 10200
 static const size_t knApplicationIdPos = 68;
 static const size_t knUserVersionPos = 60;
 
+/************************************************************************/
+/*                            GPKGRTreeEntry                            */
+/************************************************************************/
+
+// Bounding box of a feature, with the same float32 precision as in the RTree
+typedef struct
+{
+    GIntBig nId;
+    float   fMinX;
+    float   fMaxX;
+    float   fMinY;
+    float   fMaxY;
+} GPKGRTreeEntry;
+
+GPKGRTreeEntry GPKGMakeRTreeEntry( GIntBig nId, double dfMinX, double dfMaxX,
+                                   double dfMinY, double dfMaxY );
+bool GPKGRTreeBulkLoad( sqlite3* hDB, const char* pszRTreeName,
+                        std::vector<GPKGRTreeEntry>& asEntries );
+
 /************************************************************************/
 /*                          GDALGeoPackageDataset                       */
 /************************************************************************/
@@ -310,6 +329,8 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
 
     sqlite3_stmt        *m_poQueryStatement;
     bool                 bDoStep;
+    // Set when a batch has read the last feature: the next batch is empty.
+    bool                 m_bBatchEOF;
 
     char                *m_pszFidColumn;
 
@@ -319,6 +340,8 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
 
     void                ClearStatement();
     virtual OGRErr      ResetStatement() = 0;
+    int                 GetNextFeatureBatchGeneric( OGRFeatureBatch *poBatch,
+                                                    int nMaxFeatures );
 
     void                BuildFeatureDefn( const char *pszLayerName,
                                            sqlite3_stmt *hStmt );
@@ -333,6 +356,8 @@ class OGRGeoPackageLayer : public OGRLayer, public IOGRSQLiteGetSpatialWhere
     /* OGR API methods */
 
     OGRFeature*         GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                         int nMaxFeatures ) override;
     const char*         GetFIDColumn() override;
     void                ResetReading() override;
     int                 TestCapability( const char * ) override;
@@ -370,6 +395,11 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
     bool                        m_bInsertStatementWithFID;
     sqlite3_stmt*               m_poInsertStatement;
     bool                        m_bDeferredSpatialIndexCreation;
+    // Bounding boxes of the features created while the spatial index
+    // creation is deferred, to bulk load the RTree.
+    bool                        m_bCollectRTreeEntries;
+    size_t                      m_nMaxRTreeEntries;
+    std::vector<GPKGRTreeEntry> m_asRTreeEntries;
     // m_bHasSpatialIndex cannot be bool.  -1 is unset.
     int                         m_bHasSpatialIndex;
     bool                        m_bDropRTreeTable;
@@ -389,6 +419,11 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
 
     void                BuildWhere();
     OGRErr              RegisterGeometryColumn();
+    bool                FillRTreeFromTable( const char* pszT,
+                                            const char* pszC,
+                                            const char* pszI,
+                                            bool bCanBulkLoad );
+    void                StopCollectingRTreeEntries();
 
     CPLString           GetColumnsOfCreateTable(const std::vector<OGRFieldDefn*>& apoFields);
     CPLString           BuildSelectFieldList(const std::vector<OGRFieldDefn*>& apoFields);
@@ -425,6 +460,8 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
     OGRErr              SetAttributeFilter( const char *pszQuery ) override;
     OGRErr              SyncToDisk() override;
     OGRFeature*         GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                         int nMaxFeatures ) override;
     OGRFeature*         GetFeature(GIntBig nFID) override;
     OGRErr              StartTransaction() override;
     OGRErr              CommitTransaction() override;
@@ -445,8 +482,7 @@ class OGRGeoPackageTableLayer CPL_FINAL : public OGRGeoPackageLayer
                                                const char* pszFIDColumnName,
                                                const char* pszIdentifier,
                                                const char* pszDescription );
-    void                SetDeferredSpatialIndexCreation( bool bFlag )
-                                { m_bDeferredSpatialIndexCreation = bFlag; }
+    void                SetDeferredSpatialIndexCreation( bool bFlag );
     void                SetASpatialVariant( GPKGASpatialVariant eASPatialVariant )
                                 { m_eASPatialVariant = eASPatialVariant; }
 
@@ -533,6 +569,9 @@ class OGRGeoPackageSelectLayer CPL_FINAL : public OGRGeoPackageLayer, public IOG
     virtual void        ResetReading() override;
 
     virtual OGRFeature *GetNextFeature() override;
+    virtual int         GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                         int nMaxFeatures ) override
+                { return GetNextFeatureBatchGeneric(poBatch, nMaxFeatures); }
     virtual GIntBig     GetFeatureCount( int ) override;
 
     virtual void        SetSpatialFilter( OGRGeometry * poGeom ) override { SetSpatialFilter(0, poGeom); }
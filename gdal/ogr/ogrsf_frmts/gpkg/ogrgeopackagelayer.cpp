@@ -44,6 +44,7 @@ OGRGeoPackageLayer::OGRGeoPackageLayer(GDALGeoPackageDataset *poDS) :
     iNextShapeId(0),
     m_poQueryStatement(NULL),
     bDoStep(true),
+    m_bBatchEOF(false),
     m_pszFidColumn(NULL),
     iFIDCol(-1),
     iGeomCol(-1),
@@ -86,6 +87,7 @@ void OGRGeoPackageLayer::ResetReading()
 void OGRGeoPackageLayer::ClearStatement()
 
 {
+    m_bBatchEOF = false;
     if( m_poQueryStatement != NULL )
     {
         CPLDebug( "GPKG", "finalize %p", m_poQueryStatement );
@@ -192,19 +194,35 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
             int iGpkgSize = sqlite3_column_bytes(hStmt, iGeomCol);
             // coverity[tainted_data_return]
             GByte *pabyGpkg = (GByte *)sqlite3_column_blob(hStmt, iGeomCol);
-            OGRGeometry *poGeom = GPkgGeometryToOGR(pabyGpkg, iGpkgSize, NULL);
-            if ( poGeom == NULL )
+
+            // Defer decoding of regular GeoPackage geometries until they
+            // are requested, so that it is skipped when they are not used,
+            // or copied as they are to another GeoPackage.
+            GPkgHeader oHeader;
+            if( GPkgHeaderFromWKB(pabyGpkg, iGpkgSize, &oHeader) ==
+                                                            OGRERR_NONE &&
+                !oHeader.bExtended &&
+                static_cast<size_t>(iGpkgSize) >= oHeader.nHeaderLen + 5 )
             {
-                // Try also spatialite geometry blobs
-                if( OGRSQLiteLayer::ImportSpatiaLiteGeometry( pabyGpkg, iGpkgSize,
-                                                              &poGeom ) != OGRERR_NONE )
+                poFeature->SetGeomFieldWKB(0, pabyGpkg + oHeader.nHeaderLen,
+                                           iGpkgSize - oHeader.nHeaderLen);
+            }
+            else
+            {
+                OGRGeometry *poGeom = GPkgGeometryToOGR(pabyGpkg, iGpkgSize, NULL);
+                if ( poGeom == NULL )
                 {
-                    CPLError( CE_Failure, CPLE_AppDefined, "Unable to read geometry");
+                    // Try also spatialite geometry blobs
+                    if( OGRSQLiteLayer::ImportSpatiaLiteGeometry( pabyGpkg, iGpkgSize,
+                                                                  &poGeom ) != OGRERR_NONE )
+                    {
+                        CPLError( CE_Failure, CPLE_AppDefined, "Unable to read geometry");
+                    }
                 }
+                if( poGeom != NULL )
+                    poGeom->assignSpatialReference(poSrs);
+                poFeature->SetGeometryDirectly( poGeom );
             }
-            if( poGeom != NULL )
-                poGeom->assignSpatialReference(poSrs);
-            poFeature->SetGeometryDirectly( poGeom );
         }
     }
 
@@ -284,6 +302,248 @@ OGRFeature *OGRGeoPackageLayer::TranslateFeature( sqlite3_stmt* hStmt )
     return poFeature;
 }
 
+/************************************************************************/
+/*                     GetNextFeatureBatchGeneric()                     */
+/*                                                                      */
+/*      OGRLayer::GetNextFeatureBatch(), except that the call after     */
+/*      the one that has reached the end of the layer returns no        */
+/*      feature, instead of restarting from the first one as            */
+/*      GetNextFeature() does.                                          */
+/************************************************************************/
+
+int OGRGeoPackageLayer::GetNextFeatureBatchGeneric( OGRFeatureBatch *poBatch,
+                                                    int nMaxFeatures )
+
+{
+    if( m_bBatchEOF )
+    {
+        poBatch->Reset(m_poFeatureDefn);
+        m_bBatchEOF = false;
+        return 0;
+    }
+
+    const int nCount = OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+    m_bBatchEOF = nCount > 0 && nCount < nMaxFeatures;
+    return nCount;
+}
+
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/*                                                                      */
+/*      Fill the batch straight from the sqlite3 column values, without */
+/*      materializing OGRFeature objects.  When no spatial filter is    */
+/*      set, little-endian WKB is copied as is from the geometry blob.  */
+/************************************************************************/
+
+int OGRGeoPackageLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures )
+
+{
+    if( m_poAttrQuery != NULL )
+        return GetNextFeatureBatchGeneric(poBatch, nMaxFeatures);
+
+    poBatch->Reset(m_poFeatureDefn);
+
+    if( m_bBatchEOF )
+    {
+        m_bBatchEOF = false;
+        return 0;
+    }
+
+    const int nFieldCount = m_poFeatureDefn->GetFieldCount();
+    const bool bReadGeom = iGeomCol >= 0 &&
+        !m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored();
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        if( m_poQueryStatement == NULL )
+        {
+            ResetStatement();
+            if (m_poQueryStatement == NULL)
+                break;
+        }
+
+        if( bDoStep )
+        {
+            int rc = sqlite3_step( m_poQueryStatement );
+            if( rc != SQLITE_ROW )
+            {
+                if ( rc != SQLITE_DONE )
+                {
+                    sqlite3_reset(m_poQueryStatement);
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                            "In GetNextFeatureBatch(): sqlite3_step() : %s",
+                            sqlite3_errmsg(m_poDS->GetDB()) );
+                }
+
+                ClearStatement();
+                // Otherwise the next call would restart from the first
+                // feature.
+                m_bBatchEOF = poBatch->GetFeatureCount() > 0;
+                break;
+            }
+        }
+        else
+        {
+            bDoStep = true;
+        }
+
+        sqlite3_stmt* hStmt = m_poQueryStatement;
+
+        GIntBig nFID = iNextShapeId;
+        if( iFIDCol >= 0 )
+        {
+            nFID = sqlite3_column_int64( hStmt, iFIDCol );
+            if( m_pszFidColumn == NULL && nFID == 0 )
+                nFID = iNextShapeId;
+        }
+        iNextShapeId++;
+        m_nFeaturesRead++;
+
+    /* -------------------------------------------------------------------- */
+    /*      Geometry.  A spatial filter needs the OGRGeometry anyway.       */
+    /* -------------------------------------------------------------------- */
+        const GByte *pabyGpkg = NULL;
+        int nGpkgSize = 0;
+        if( bReadGeom && sqlite3_column_type(hStmt, iGeomCol) != SQLITE_NULL )
+        {
+            nGpkgSize = sqlite3_column_bytes(hStmt, iGeomCol);
+            // coverity[tainted_data_return]
+            pabyGpkg = static_cast<const GByte*>(
+                sqlite3_column_blob(hStmt, iGeomCol));
+        }
+
+        GPkgHeader oHeader;
+        const GByte* pabyWkb = NULL;
+        OGRGeometry *poGeom = NULL;
+        if( pabyGpkg != NULL && m_poFilterGeom == NULL &&
+            GPkgHeaderFromWKB(pabyGpkg, nGpkgSize, &oHeader) == OGRERR_NONE &&
+            oHeader.nHeaderLen + 5 <= static_cast<size_t>(nGpkgSize) &&
+            pabyGpkg[oHeader.nHeaderLen] == wkbNDR )
+        {
+            pabyWkb = pabyGpkg + oHeader.nHeaderLen;
+        }
+        else if( pabyGpkg != NULL )
+        {
+            poGeom = GPkgGeometryToOGR(pabyGpkg, nGpkgSize, NULL);
+            if ( poGeom == NULL )
+            {
+                // Try also spatialite geometry blobs
+                if( OGRSQLiteLayer::ImportSpatiaLiteGeometry( pabyGpkg,
+                                                              nGpkgSize,
+                                                              &poGeom ) !=
+                                                                OGRERR_NONE )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "Unable to read geometry");
+                }
+            }
+        }
+
+        if( m_poFilterGeom != NULL && !FilterGeometry(poGeom) )
+        {
+            delete poGeom;
+            continue;
+        }
+
+        poBatch->AddFeature(nFID);
+        if( pabyWkb != NULL )
+        {
+            poBatch->SetGeomFieldWKB(0, pabyWkb,
+                                     nGpkgSize - oHeader.nHeaderLen);
+        }
+        else if( poGeom != NULL )
+        {
+            poBatch->SetGeomField(0, poGeom);
+            delete poGeom;
+        }
+
+    /* -------------------------------------------------------------------- */
+    /*      Attribute fields.                                               */
+    /* -------------------------------------------------------------------- */
+        for( int iField = 0; iField < nFieldCount; iField++ )
+        {
+            OGRFieldDefn *poFieldDefn = m_poFeatureDefn->GetFieldDefn( iField );
+            if ( poFieldDefn->IsIgnored() )
+                continue;
+
+            const int iRawField = panFieldOrdinals[iField];
+
+            if( sqlite3_column_type( hStmt, iRawField ) == SQLITE_NULL )
+                continue;
+
+            switch( poFieldDefn->GetType() )
+            {
+                case OFTInteger:
+                    poBatch->SetFieldInteger( iField,
+                        sqlite3_column_int( hStmt, iRawField ) );
+                    break;
+
+                case OFTInteger64:
+                    poBatch->SetFieldInteger64( iField,
+                        sqlite3_column_int64( hStmt, iRawField ) );
+                    break;
+
+                case OFTReal:
+                    poBatch->SetFieldDouble( iField,
+                        sqlite3_column_double( hStmt, iRawField ) );
+                    break;
+
+                case OFTBinary:
+                {
+                    const int nBytes = sqlite3_column_bytes( hStmt, iRawField );
+                    // coverity[tainted_data_return]
+                    const char* pabyData = static_cast<const char*>(
+                        sqlite3_column_blob( hStmt, iRawField ) );
+                    poBatch->SetFieldString( iField, pabyData, nBytes );
+                    break;
+                }
+
+                case OFTDate:
+                {
+                    const char* pszTxt = reinterpret_cast<const char*>(
+                        sqlite3_column_text( hStmt, iRawField ) );
+                    int nYear, nMonth, nDay;
+                    if( sscanf(pszTxt, "%d-%d-%d", &nYear, &nMonth, &nDay) == 3 )
+                    {
+                        OGRField sField;
+                        memset(&sField, 0, sizeof(sField));
+                        sField.Date.Year = static_cast<GInt16>(nYear);
+                        sField.Date.Month = static_cast<GByte>(nMonth);
+                        sField.Date.Day = static_cast<GByte>(nDay);
+                        poBatch->SetFieldRaw(iField, &sField);
+                    }
+                    break;
+                }
+
+                case OFTDateTime:
+                {
+                    const char* pszTxt = reinterpret_cast<const char*>(
+                        sqlite3_column_text( hStmt, iRawField ) );
+                    OGRField sField;
+                    if( OGRParseXMLDateTime(pszTxt, &sField) )
+                        poBatch->SetFieldRaw(iField, &sField);
+                    break;
+                }
+
+                case OFTString:
+                {
+                    const int nBytes = sqlite3_column_bytes( hStmt, iRawField );
+                    const char* pszTxt = reinterpret_cast<const char*>(
+                        sqlite3_column_text( hStmt, iRawField ) );
+                    poBatch->SetFieldString( iField, pszTxt, nBytes );
+                    break;
+                }
+
+                default:
+                    break;
+            }
+        }
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                      GetFIDColumn()                                  */
 /************************************************************************/
@@ -0,0 +1,378 @@
+/******************************************************************************
+ *
+ * Project:  GeoPackage Translator
+ * Purpose:  Bulk loading of the RTree spatial index of GeoPackage tables.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogr_geopackage.h"
+#include "cpl_worker_thread_pool.h"
+
+#include <algorithm>
+#include <cmath>
+
+CPL_CVSID("$Id$")
+
+// The SQLite R*Tree module stores its nodes in the <rtree>_node table, as
+// blobs made of a 2-byte big-endian depth (only meaningful for the root node,
+// which is always node 1), a 2-byte big-endian cell count, and then cells of
+// a 8-byte big-endian id followed by minx, maxx, miny, maxy as big-endian
+// float32. The <rtree>_rowid table maps each entry to its leaf node, and the
+// <rtree>_parent table maps each non-root node to its parent. Writing those
+// tables directly from a Sort-Tile-Recursive packing of the entries is much
+// faster than inserting them one at a time, and produces a better balanced
+// tree.
+
+static const int knCellSize = 8 + 4 * 4;
+
+// Below that number of entries, sorting slices in worker threads is not
+// worth the overhead.
+static const size_t knMinEntriesForThreading = 100000;
+
+/************************************************************************/
+/*                          GPKGRTreeValueDown()                        */
+/*                          GPKGRTreeValueUp()                          */
+/************************************************************************/
+
+// Same rounding as rtreeValueDown() / rtreeValueUp() of the R*Tree module,
+// so that the stored float box always contains the double precision one.
+#define RNDTOWARDS  (1.0 - 1.0/8388608.0)
+#define RNDAWAY     (1.0 + 1.0/8388608.0)
+
+static float GPKGRTreeValueDown( double d )
+{
+    float f = static_cast<float>(d);
+    if( f > d )
+        f = static_cast<float>(d * (d < 0 ? RNDAWAY : RNDTOWARDS));
+    return f;
+}
+
+static float GPKGRTreeValueUp( double d )
+{
+    float f = static_cast<float>(d);
+    if( f < d )
+        f = static_cast<float>(d * (d < 0 ? RNDTOWARDS : RNDAWAY));
+    return f;
+}
+
+/************************************************************************/
+/*                          GPKGMakeRTreeEntry()                        */
+/************************************************************************/
+
+GPKGRTreeEntry GPKGMakeRTreeEntry( GIntBig nId, double dfMinX, double dfMaxX,
+                                   double dfMinY, double dfMaxY )
+{
+    GPKGRTreeEntry sEntry;
+    sEntry.nId = nId;
+    sEntry.fMinX = GPKGRTreeValueDown(dfMinX);
+    sEntry.fMaxX = GPKGRTreeValueUp(dfMaxX);
+    sEntry.fMinY = GPKGRTreeValueDown(dfMinY);
+    sEntry.fMaxY = GPKGRTreeValueUp(dfMaxY);
+    return sEntry;
+}
+
+/************************************************************************/
+/*                         Sort-Tile-Recursive                          */
+/************************************************************************/
+
+namespace {
+
+struct GPKGRTreeCompareX
+{
+    bool operator()( const GPKGRTreeEntry& a, const GPKGRTreeEntry& b ) const
+    {
+        return (static_cast<double>(a.fMinX) + a.fMaxX) <
+               (static_cast<double>(b.fMinX) + b.fMaxX);
+    }
+};
+
+struct GPKGRTreeCompareY
+{
+    bool operator()( const GPKGRTreeEntry& a, const GPKGRTreeEntry& b ) const
+    {
+        return (static_cast<double>(a.fMinY) + a.fMaxY) <
+               (static_cast<double>(b.fMinY) + b.fMaxY);
+    }
+};
+
+typedef struct
+{
+    GPKGRTreeEntry* pasBegin;
+    GPKGRTreeEntry* pasEnd;
+} GPKGRTreeSlice;
+
+} // namespace
+
+static void GPKGRTreeSortSliceJob( void* pData )
+{
+    GPKGRTreeSlice* psSlice = static_cast<GPKGRTreeSlice*>(pData);
+    std::sort(psSlice->pasBegin, psSlice->pasEnd, GPKGRTreeCompareY());
+}
+
+// Orders the entries of a level so that each consecutive run of nMaxCells
+// entries, within each vertical slice, is a node.
+static size_t GPKGRTreeSortLevel( std::vector<GPKGRTreeEntry>& asEntries,
+                                  size_t nMaxCells,
+                                  CPLWorkerThreadPool* poPool )
+{
+    const size_t nEntries = asEntries.size();
+    const size_t nNodes = (nEntries + nMaxCells - 1) / nMaxCells;
+    const size_t nSlices = static_cast<size_t>(
+        std::ceil(std::sqrt(static_cast<double>(nNodes))));
+    const size_t nSliceSize = nSlices * nMaxCells;
+
+    std::sort(asEntries.begin(), asEntries.end(), GPKGRTreeCompareX());
+
+    std::vector<GPKGRTreeSlice> asSlices;
+    for( size_t i = 0; i < nEntries; i += nSliceSize )
+    {
+        GPKGRTreeSlice sSlice;
+        sSlice.pasBegin = &asEntries[0] + i;
+        sSlice.pasEnd = &asEntries[0] + std::min(nEntries, i + nSliceSize);
+        asSlices.push_back(sSlice);
+    }
+
+    if( poPool != NULL && nEntries >= knMinEntriesForThreading )
+    {
+        for( size_t i = 0; i < asSlices.size(); ++i )
+            poPool->SubmitJob(GPKGRTreeSortSliceJob, &asSlices[i]);
+        poPool->WaitCompletion();
+    }
+    else
+    {
+        for( size_t i = 0; i < asSlices.size(); ++i )
+            GPKGRTreeSortSliceJob(&asSlices[i]);
+    }
+
+    return nSliceSize;
+}
+
+/************************************************************************/
+/*                         GPKGRTreeNodeWriter                          */
+/************************************************************************/
+
+namespace {
+
+class GPKGRTreeNodeWriter
+{
+    sqlite3*            m_hDB;
+    sqlite3_stmt*       m_hNodeStmt;
+    sqlite3_stmt*       m_hParentStmt;
+    sqlite3_stmt*       m_hRowIdStmt;
+    std::vector<GByte>  m_abyNode;
+
+    bool                Step( sqlite3_stmt* hStmt );
+
+  public:
+    explicit GPKGRTreeNodeWriter( sqlite3* hDB );
+                        ~GPKGRTreeNodeWriter();
+
+    bool                Prepare( const char* pszRTreeName, int nNodeSize );
+    bool                WriteNode( GIntBig nNodeNo, int nDepth,
+                                   const GPKGRTreeEntry* pasCells,
+                                   size_t nCells, bool bLeaf );
+};
+
+} // namespace
+
+GPKGRTreeNodeWriter::GPKGRTreeNodeWriter( sqlite3* hDB ) :
+    m_hDB(hDB),
+    m_hNodeStmt(NULL),
+    m_hParentStmt(NULL),
+    m_hRowIdStmt(NULL)
+{}
+
+GPKGRTreeNodeWriter::~GPKGRTreeNodeWriter()
+{
+    sqlite3_finalize(m_hNodeStmt);
+    sqlite3_finalize(m_hParentStmt);
+    sqlite3_finalize(m_hRowIdStmt);
+}
+
+bool GPKGRTreeNodeWriter::Prepare( const char* pszRTreeName, int nNodeSize )
+{
+    m_abyNode.resize(nNodeSize);
+
+    const char* const apszSQL[] = {
+        "INSERT OR REPLACE INTO \"%w_node\" (nodeno, data) VALUES (?, ?)",
+        "INSERT INTO \"%w_parent\" (nodeno, parentnode) VALUES (?, ?)",
+        "INSERT INTO \"%w_rowid\" (rowid, nodeno) VALUES (?, ?)" };
+    sqlite3_stmt** const aphStmt[] = {
+        &m_hNodeStmt, &m_hParentStmt, &m_hRowIdStmt };
+    for( size_t i = 0; i < CPL_ARRAYSIZE(apszSQL); ++i )
+    {
+        char* pszSQL = sqlite3_mprintf(apszSQL[i], pszRTreeName);
+        if( sqlite3_prepare_v2(m_hDB, pszSQL, -1, aphStmt[i], NULL)
+                                                            != SQLITE_OK )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "failed to prepare SQL: %s", pszSQL);
+            sqlite3_free(pszSQL);
+            return false;
+        }
+        sqlite3_free(pszSQL);
+    }
+    return true;
+}
+
+bool GPKGRTreeNodeWriter::Step( sqlite3_stmt* hStmt )
+{
+    const int nErr = sqlite3_step(hStmt);
+    sqlite3_reset(hStmt);
+    if( nErr != SQLITE_OK && nErr != SQLITE_DONE )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "failed to write RTree node: %s",
+                  sqlite3_errmsg(m_hDB) );
+        return false;
+    }
+    return true;
+}
+
+static void GPKGRTreeWriteFloat( GByte* pabyDest, float fVal )
+{
+    CPL_MSBPTR32(&fVal);
+    memcpy(pabyDest, &fVal, sizeof(fVal));
+}
+
+bool GPKGRTreeNodeWriter::WriteNode( GIntBig nNodeNo, int nDepth,
+                                     const GPKGRTreeEntry* pasCells,
+                                     size_t nCells, bool bLeaf )
+{
+    // Unused trailing bytes are left to zero, as the R*Tree module does.
+    std::fill(m_abyNode.begin(), m_abyNode.end(), static_cast<GByte>(0));
+    m_abyNode[0] = static_cast<GByte>(nDepth >> 8);
+    m_abyNode[1] = static_cast<GByte>(nDepth & 0xff);
+    m_abyNode[2] = static_cast<GByte>(nCells >> 8);
+    m_abyNode[3] = static_cast<GByte>(nCells & 0xff);
+    GByte* pabyCell = &m_abyNode[4];
+    for( size_t i = 0; i < nCells; ++i, pabyCell += knCellSize )
+    {
+        GIntBig nId = pasCells[i].nId;
+        CPL_MSBPTR64(&nId);
+        memcpy(pabyCell, &nId, sizeof(nId));
+        GPKGRTreeWriteFloat(pabyCell + 8, pasCells[i].fMinX);
+        GPKGRTreeWriteFloat(pabyCell + 12, pasCells[i].fMaxX);
+        GPKGRTreeWriteFloat(pabyCell + 16, pasCells[i].fMinY);
+        GPKGRTreeWriteFloat(pabyCell + 20, pasCells[i].fMaxY);
+    }
+
+    sqlite3_bind_int64(m_hNodeStmt, 1, nNodeNo);
+    sqlite3_bind_blob(m_hNodeStmt, 2, &m_abyNode[0],
+                      static_cast<int>(m_abyNode.size()), SQLITE_STATIC);
+    if( !Step(m_hNodeStmt) )
+        return false;
+
+    // Record where the children of this node can be found.
+    sqlite3_stmt* hChildStmt = bLeaf ? m_hRowIdStmt : m_hParentStmt;
+    for( size_t i = 0; i < nCells; ++i )
+    {
+        sqlite3_bind_int64(hChildStmt, 1, pasCells[i].nId);
+        sqlite3_bind_int64(hChildStmt, 2, nNodeNo);
+        if( !Step(hChildStmt) )
+            return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                          GPKGRTreeBulkLoad()                         */
+/************************************************************************/
+
+// Fills an empty RTree with the passed entries, whose content is consumed.
+// Must be called within a transaction.
+bool GPKGRTreeBulkLoad( sqlite3* hDB, const char* pszRTreeName,
+                        std::vector<GPKGRTreeEntry>& asEntries )
+{
+    if( asEntries.empty() )
+        return true;
+
+    // The node size depends on the page size of the database at the time
+    // the RTree was created, so read it from the (empty) root node.
+    char* pszSQL = sqlite3_mprintf(
+        "SELECT length(data) FROM \"%w_node\" WHERE nodeno = 1",
+        pszRTreeName);
+    OGRErr eErr = OGRERR_NONE;
+    const int nNodeSize = SQLGetInteger(hDB, pszSQL, &eErr);
+    sqlite3_free(pszSQL);
+    if( eErr != OGRERR_NONE || nNodeSize < 4 + 2 * knCellSize )
+        return false;
+    const size_t nMaxCells = static_cast<size_t>((nNodeSize - 4) / knCellSize);
+
+    GPKGRTreeNodeWriter oWriter(hDB);
+    if( !oWriter.Prepare(pszRTreeName, nNodeSize) )
+        return false;
+
+    CPLWorkerThreadPool oPool;
+    CPLWorkerThreadPool* poPool = NULL;
+    if( asEntries.size() >= knMinEntriesForThreading )
+    {
+        const int nThreads = CPLGetNumThreads(NULL, "1");
+        if( nThreads > 1 && oPool.Setup(nThreads, NULL, NULL) )
+            poPool = &oPool;
+    }
+
+    // Pack each level into nodes, until the remaining entries fit into the
+    // root node. Non-root nodes are numbered from 2.
+    std::vector<GPKGRTreeEntry> asUpperLevel;
+    GIntBig nNextNodeNo = 2;
+    int nDepth = 0;
+    while( asEntries.size() > nMaxCells )
+    {
+        const size_t nSliceSize =
+            GPKGRTreeSortLevel(asEntries, nMaxCells, poPool);
+        asUpperLevel.clear();
+        asUpperLevel.reserve(asEntries.size() / nMaxCells + nSliceSize);
+        for( size_t iSlice = 0; iSlice < asEntries.size();
+             iSlice += nSliceSize )
+        {
+            const size_t nSliceEnd =
+                std::min(asEntries.size(), iSlice + nSliceSize);
+            for( size_t i = iSlice; i < nSliceEnd; i += nMaxCells )
+            {
+                const size_t nCells = std::min(nMaxCells, nSliceEnd - i);
+                const GPKGRTreeEntry* pasCells = &asEntries[i];
+                GPKGRTreeEntry sNode = pasCells[0];
+                sNode.nId = nNextNodeNo++;
+                for( size_t j = 1; j < nCells; ++j )
+                {
+                    sNode.fMinX = std::min(sNode.fMinX, pasCells[j].fMinX);
+                    sNode.fMaxX = std::max(sNode.fMaxX, pasCells[j].fMaxX);
+                    sNode.fMinY = std::min(sNode.fMinY, pasCells[j].fMinY);
+                    sNode.fMaxY = std::max(sNode.fMaxY, pasCells[j].fMaxY);
+                }
+                if( !oWriter.WriteNode(sNode.nId, 0, pasCells, nCells,
+                                       nDepth == 0) )
+                {
+                    return false;
+                }
+                asUpperLevel.push_back(sNode);
+            }
+        }
+        asEntries.swap(asUpperLevel);
+        nDepth++;
+    }
+
+    return oWriter.WriteNode(1, nDepth, &asEntries[0], asEntries.size(),
+                             nDepth == 0);
+}
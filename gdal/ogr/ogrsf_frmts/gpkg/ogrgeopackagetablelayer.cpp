@@ -176,7 +176,40 @@ bool OGRGeoPackageTableLayer::IsGeomFieldSet( OGRFeature *poFeature )
 {
     return
         poFeature->GetDefnRef()->GetGeomFieldCount() &&
-        poFeature->GetGeomFieldRef(0);
+        (poFeature->GetGeomFieldWKBRef(0, NULL) != NULL ||
+         poFeature->GetGeomFieldRef(0));
+}
+
+//----------------------------------------------------------------------
+// GetGeomFieldEnvelope()
+//
+// Utility function to get the envelope of the geometry of a feature,
+// without decoding it if it is still in WKB form. Returns false if the
+// geometry is empty.
+//
+static bool GetGeomFieldEnvelope( OGRFeature *poFeature,
+                                  OGREnvelope *psEnvelope )
+{
+    size_t nWKBSize = 0;
+    const GByte* pabyWKB = poFeature->GetGeomFieldWKBRef(0, &nWKBSize);
+    OGREnvelope3D oEnv3d;
+    if( pabyWKB != NULL &&
+        OGRWKBGetEnvelope(pabyWKB, nWKBSize, &oEnv3d, NULL) )
+    {
+        if( !oEnv3d.IsInit() )
+            return false;
+        psEnvelope->MinX = oEnv3d.MinX;
+        psEnvelope->MaxX = oEnv3d.MaxX;
+        psEnvelope->MinY = oEnv3d.MinY;
+        psEnvelope->MaxY = oEnv3d.MaxY;
+        return true;
+    }
+
+    OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
+    if( poGeom->IsEmpty() )
+        return false;
+    poGeom->getEnvelope(psEnvelope);
+    return true;
 }
 
 #define MY_CPLAssert CPLAssert
@@ -200,9 +233,28 @@ OGRErr OGRGeoPackageTableLayer::FeatureBindParameters( OGRFeature *poFeature,
     /* Bind data values to the statement, here bind the blob for geometry */
     if ( err == SQLITE_OK && poFeatureDefn->GetGeomFieldCount() )
     {
+        // Geometry still in WKB form that can be reused as it is.
+        size_t nWKBSize = 0;
+        const GByte* pabyFeatureWKB =
+            poFeature->GetGeomFieldWKBRef(0, &nWKBSize);
+        GByte *pabyGpkg = NULL;
+        size_t szGpkg = 0;
+        if( pabyFeatureWKB != NULL )
+        {
+            pabyGpkg = GPkgGeometryFromWKB(pabyFeatureWKB, nWKBSize, m_iSrs,
+                                           &szGpkg);
+        }
+
         // Non-NULL geometry.
-        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
-        if ( poGeom )
+        OGRGeometry* poGeom =
+            pabyGpkg != NULL ? NULL : poFeature->GetGeomFieldRef(0);
+        if ( pabyGpkg )
+        {
+            err = sqlite3_bind_blob(poStmt, nColCount++, pabyGpkg,
+                                    static_cast<int>(szGpkg), CPLFree);
+            MY_CPLAssert( err == SQLITE_OK );
+        }
+        else if ( poGeom )
         {
             GByte *pabyWkb = NULL;
             size_t szWkb = 0;
@@ -983,6 +1035,8 @@ OGRGeoPackageTableLayer::OGRGeoPackageTableLayer(
     m_bInsertStatementWithFID(false),
     m_poInsertStatement(NULL),
     m_bDeferredSpatialIndexCreation(false),
+    m_bCollectRTreeEntries(false),
+    m_nMaxRTreeEntries(0),
     m_bHasSpatialIndex(-1),
     m_bDropRTreeTable(false),
     m_bPreservePrecision(true),
@@ -1571,16 +1625,11 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
     }
 
     /* Update the layer extents with this new object */
-    if( IsGeomFieldSet(poFeature) )
-    {
-        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
-        if( !poGeom->IsEmpty() )
-        {
-            OGREnvelope oEnv;
-            poGeom->getEnvelope(&oEnv);
-            UpdateExtent(&oEnv);
-        }
-    }
+    OGREnvelope oEnv;
+    const bool bHasEnvelope =
+        IsGeomFieldSet(poFeature) && GetGeomFieldEnvelope(poFeature, &oEnv);
+    if( bHasEnvelope )
+        UpdateExtent(&oEnv);
 
     /* Read the latest FID value */
     GIntBig nFID = sqlite3_last_insert_rowid(m_poDS->GetDB());
@@ -1595,6 +1644,22 @@ OGRErr OGRGeoPackageTableLayer::ICreateFeature( OGRFeature *poFeature )
         poFeature->SetFID(OGRNullFID);
     }
 
+    /* Remember the bounding box for the deferred spatial index creation */
+    if( m_bCollectRTreeEntries && bHasEnvelope )
+    {
+        if( poFeature->GetFID() == OGRNullFID ||
+            m_asRTreeEntries.size() == m_nMaxRTreeEntries )
+        {
+            StopCollectingRTreeEntries();
+        }
+        else
+        {
+            m_asRTreeEntries.push_back(
+                GPKGMakeRTreeEntry(poFeature->GetFID(), oEnv.MinX, oEnv.MaxX,
+                                   oEnv.MinY, oEnv.MaxY));
+        }
+    }
+
 #ifdef ENABLE_GPKG_OGR_CONTENTS
     if( m_nTotalFeatureCount >= 0 )
         m_nTotalFeatureCount++;
@@ -1643,6 +1708,9 @@ OGRErr OGRGeoPackageTableLayer::ISetFeature( OGRFeature *poFeature )
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return OGRERR_FAILURE;
 
+    /* The collected bounding boxes would no longer match the table */
+    StopCollectingRTreeEntries();
+
     /* Old version of SQLite have issues with some of the spatial index triggers */
 #if SQLITE_VERSION_NUMBER < 3007008
     if( HasSpatialIndex() )
@@ -1739,13 +1807,9 @@ OGRErr OGRGeoPackageTableLayer::ISetFeature( OGRFeature *poFeature )
         /* Update the layer extents with this new object */
         if( IsGeomFieldSet(poFeature) )
         {
-            OGRGeometry* poGeom = poFeature->GetGeomFieldRef(0);
-            if( !poGeom->IsEmpty() )
-            {
-                OGREnvelope oEnv;
-                poGeom->getEnvelope(&oEnv);
+            OGREnvelope oEnv;
+            if( GetGeomFieldEnvelope(poFeature, &oEnv) )
                 UpdateExtent(&oEnv);
-            }
         }
 
         m_bContentChanged = true;
@@ -1901,6 +1965,28 @@ OGRFeature* OGRGeoPackageTableLayer::GetNextFeature()
     return poFeature;
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRGeoPackageTableLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                                  int nMaxFeatures )
+{
+    if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
+    {
+        poBatch->Reset(m_poFeatureDefn);
+        return 0;
+    }
+
+    CreateSpatialIndexIfNecessary();
+
+    // The FID must be copied into its regular field counterpart.
+    if( m_iFIDAsRegularColumnIndex >= 0 )
+        return GetNextFeatureBatchGeneric(poBatch, nMaxFeatures);
+
+    return OGRGeoPackageLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+}
+
 /************************************************************************/
 /*                        GetFeature()                                  */
 /************************************************************************/
@@ -1976,6 +2062,9 @@ OGRErr OGRGeoPackageTableLayer::DeleteFeature(GIntBig nFID)
     if( m_bDeferredCreation && RunDeferredCreationIfNecessary() != OGRERR_NONE )
         return OGRERR_FAILURE;
 
+    /* The collected bounding boxes would no longer match the table */
+    StopCollectingRTreeEntries();
+
 #ifdef ENABLE_GPKG_OGR_CONTENTS
     if( m_bOGRFeatureCountTriggersEnabled )
     {
@@ -2306,6 +2395,60 @@ int OGRGeoPackageTableLayer::TestCapability ( const char * pszCap )
     }
 }
 
+/************************************************************************/
+/*                         GetMaxRTreeEntries()                         */
+/************************************************************************/
+
+// Maximum number of bounding boxes held in memory to bulk load a RTree.
+static size_t GetMaxRTreeEntries()
+{
+    GIntBig nMaxMemory;
+    const char* pszMaxMemory =
+        CPLGetConfigOption("OGR_GPKG_RTREE_MAX_MEMORY", NULL);
+    if( pszMaxMemory != NULL )
+        nMaxMemory = CPLAtoGIntBig(pszMaxMemory) * 1024 * 1024;
+    else
+        nMaxMemory = CPLGetUsablePhysicalRAM() / 10;
+    // Bulk loading temporarily needs an extra array for the upper levels
+    const GUIntBig nMaxEntries = static_cast<GUIntBig>(
+        std::max(static_cast<GIntBig>(0), nMaxMemory)) /
+                                (sizeof(GPKGRTreeEntry) * 2);
+    return static_cast<size_t>(
+        std::min(nMaxEntries, static_cast<GUIntBig>(
+            std::vector<GPKGRTreeEntry>().max_size())));
+}
+
+/************************************************************************/
+/*                   SetDeferredSpatialIndexCreation()                  */
+/************************************************************************/
+
+void OGRGeoPackageTableLayer::SetDeferredSpatialIndexCreation( bool bFlag )
+{
+    m_bDeferredSpatialIndexCreation = bFlag;
+    if( bFlag )
+    {
+        // The table has just been created, so collecting the bounding boxes
+        // of the features as they are written is enough to bulk load the
+        // RTree afterwards, without reading back the table.
+        m_bCollectRTreeEntries = true;
+        m_nMaxRTreeEntries = GetMaxRTreeEntries();
+    }
+    else
+    {
+        StopCollectingRTreeEntries();
+    }
+}
+
+/************************************************************************/
+/*                     StopCollectingRTreeEntries()                     */
+/************************************************************************/
+
+void OGRGeoPackageTableLayer::StopCollectingRTreeEntries()
+{
+    m_bCollectRTreeEntries = false;
+    std::vector<GPKGRTreeEntry>().swap(m_asRTreeEntries);
+}
+
 /************************************************************************/
 /*                     CreateSpatialIndexIfNecessary()                  */
 /************************************************************************/
@@ -2322,15 +2465,6 @@ void OGRGeoPackageTableLayer::CreateSpatialIndexIfNecessary()
 /*                       CreateSpatialIndex()                           */
 /************************************************************************/
 
-typedef struct
-{
-    GIntBig nId;
-    double  dfMinX;
-    double  dfMinY;
-    double  dfMaxX;
-    double  dfMaxY;
-} GPKGRTreeEntry;
-
 bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
 {
     OGRErr err;
@@ -2383,132 +2517,36 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
         sqlite3_free(pszSQL);
         if( err != OGRERR_NONE )
         {
+            StopCollectingRTreeEntries();
             m_poDS->SoftRollbackTransaction();
             return false;
         }
     }
+    // A RTree emptied by DropSpatialIndex() may still have a non-trivial
+    // node structure, so only a freshly created one can be bulk loaded.
+    const bool bCanBulkLoad = !m_bDropRTreeTable;
     m_bDropRTreeTable = false;
 
     /* Populate the RTree */
-#ifdef NO_PROGRESSIVE_RTREE_INSERTION
-    pszSQL = sqlite3_mprintf(
-        "INSERT INTO \"%w\" "
-        "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
-        "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
-        "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
-        m_osRTreeName.c_str(), pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
-    err = SQLCommand(m_poDS->GetDB(), pszSQL);
-    sqlite3_free(pszSQL);
-    if( err != OGRERR_NONE )
+    bool bOK;
+    if( m_bCollectRTreeEntries && bCanBulkLoad )
     {
-        m_poDS->SoftRollbackTransaction();
-        return false;
+        CPLDebug("GPKG", "Bulk loading %d collected entries into %s",
+                 static_cast<int>(m_asRTreeEntries.size()),
+                 m_osRTreeName.c_str());
+        bOK = GPKGRTreeBulkLoad(m_poDS->GetDB(), m_osRTreeName,
+                                m_asRTreeEntries);
     }
-#else
-    pszSQL = sqlite3_mprintf(
-        "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
-        "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
-        "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
-            pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
-    sqlite3_stmt* hIterStmt = NULL;
-    if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hIterStmt, NULL)
-                                                            != SQLITE_OK )
+    else
     {
-        CPLError( CE_Failure, CPLE_AppDefined,
-                    "failed to prepare SQL: %s", pszSQL);
-        sqlite3_free(pszSQL);
-        m_poDS->SoftRollbackTransaction();
-        return false;
+        bOK = FillRTreeFromTable(pszT, pszC, pszI, bCanBulkLoad);
     }
-    sqlite3_free(pszSQL);
-
-    pszSQL = sqlite3_mprintf(
-        "INSERT INTO \"%w\" VALUES (?,?,?,?,?)",
-        m_osRTreeName.c_str());
-    sqlite3_stmt* hInsertStmt = NULL;
-    if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hInsertStmt, NULL)
-                                                            != SQLITE_OK )
+    StopCollectingRTreeEntries();
+    if( !bOK )
     {
-        CPLError( CE_Failure, CPLE_AppDefined,
-                    "failed to prepare SQL: %s", pszSQL);
-        sqlite3_free(pszSQL);
-        sqlite3_finalize(hIterStmt);
         m_poDS->SoftRollbackTransaction();
         return false;
     }
-    sqlite3_free(pszSQL);
-
-    // Insert entries in RTree by chuncks of 100000
-    std::vector<GPKGRTreeEntry> aoEntries;
-    GUIntBig nEntryCount = 0;
-    const size_t nChunkSize = 100000;
-    while( true )
-    {
-        int sqlite_err = sqlite3_step(hIterStmt);
-        bool bFinished = false;
-        if( sqlite_err == SQLITE_ROW )
-        {
-            GPKGRTreeEntry sEntry;
-            sEntry.nId = sqlite3_column_int64(hIterStmt, 0);
-            sEntry.dfMinX = sqlite3_column_double(hIterStmt, 1);
-            sEntry.dfMaxX = sqlite3_column_double(hIterStmt, 2);
-            sEntry.dfMinY = sqlite3_column_double(hIterStmt, 3);
-            sEntry.dfMaxY = sqlite3_column_double(hIterStmt, 4);
-            aoEntries.push_back(sEntry);
-        }
-        else if( sqlite_err == SQLITE_DONE )
-        {
-            bFinished = true;
-        }
-        else
-        {
-            CPLError( CE_Failure, CPLE_AppDefined,
-                      "failed to iterate over features while inserting in "
-                      "RTree: %s",
-                      sqlite3_errmsg( m_poDS->GetDB() ) );
-            sqlite3_finalize(hIterStmt);
-            sqlite3_finalize(hInsertStmt);
-            m_poDS->SoftRollbackTransaction();
-            return false;
-        }
-
-        if( aoEntries.size() == nChunkSize || bFinished )
-        {
-            for( size_t i = 0; i < aoEntries.size(); ++i )
-            {
-                sqlite3_reset(hInsertStmt);
-
-                sqlite3_bind_int64(hInsertStmt,1,aoEntries[i].nId);
-                sqlite3_bind_double(hInsertStmt,2,aoEntries[i].dfMinX);
-                sqlite3_bind_double(hInsertStmt,3,aoEntries[i].dfMaxX);
-                sqlite3_bind_double(hInsertStmt,4,aoEntries[i].dfMinY);
-                sqlite3_bind_double(hInsertStmt,5,aoEntries[i].dfMaxY);
-                sqlite_err = sqlite3_step(hInsertStmt);
-                if ( sqlite_err != SQLITE_OK && sqlite_err != SQLITE_DONE )
-                {
-                    CPLError( CE_Failure, CPLE_AppDefined,
-                              "failed to execute insertion in RTree : %s",
-                              sqlite3_errmsg( m_poDS->GetDB() ) );
-                    sqlite3_finalize(hIterStmt);
-                    sqlite3_finalize(hInsertStmt);
-                    m_poDS->SoftRollbackTransaction();
-                    return false;
-                }
-            }
-
-            nEntryCount += aoEntries.size();
-            CPLDebug("GPKG", CPL_FRMT_GUIB " rows inserted into %s",
-                     nEntryCount, m_osRTreeName.c_str());
-
-            aoEntries.clear();
-            if( bFinished )
-                break;
-        }
-    }
-
-    sqlite3_finalize(hIterStmt);
-    sqlite3_finalize(hInsertStmt);
-#endif
 
     CPLString osSQL;
 
@@ -2666,6 +2704,153 @@ bool OGRGeoPackageTableLayer::CreateSpatialIndex(const char* pszTableName)
     return true;
 }
 
+/************************************************************************/
+/*                         FillRTreeFromTable()                         */
+/************************************************************************/
+
+bool OGRGeoPackageTableLayer::FillRTreeFromTable( const char* pszT,
+                                                  const char* pszC,
+                                                  const char* pszI,
+                                                  bool bCanBulkLoad )
+{
+    char* pszSQL;
+
+#ifdef NO_PROGRESSIVE_RTREE_INSERTION
+    CPL_IGNORE_RET_VAL(bCanBulkLoad);
+    pszSQL = sqlite3_mprintf(
+        "INSERT INTO \"%w\" "
+        "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
+        "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
+        "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
+        m_osRTreeName.c_str(), pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
+    OGRErr err = SQLCommand(m_poDS->GetDB(), pszSQL);
+    sqlite3_free(pszSQL);
+    if( err != OGRERR_NONE )
+    {
+        return false;
+    }
+#else
+    pszSQL = sqlite3_mprintf(
+        "SELECT \"%w\", ST_MinX(\"%w\"), ST_MaxX(\"%w\"), "
+        "ST_MinY(\"%w\"), ST_MaxY(\"%w\") FROM \"%w\" "
+        "WHERE \"%w\" NOT NULL AND NOT ST_IsEmpty(\"%w\")",
+            pszI, pszC, pszC, pszC, pszC, pszT, pszC, pszC );
+    sqlite3_stmt* hIterStmt = NULL;
+    if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hIterStmt, NULL)
+                                                            != SQLITE_OK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                    "failed to prepare SQL: %s", pszSQL);
+        sqlite3_free(pszSQL);
+        return false;
+    }
+    sqlite3_free(pszSQL);
+
+    pszSQL = sqlite3_mprintf(
+        "INSERT INTO \"%w\" VALUES (?,?,?,?,?)",
+        m_osRTreeName.c_str());
+    sqlite3_stmt* hInsertStmt = NULL;
+    if ( sqlite3_prepare_v2(m_poDS->GetDB(), pszSQL, -1, &hInsertStmt, NULL)
+                                                            != SQLITE_OK )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                    "failed to prepare SQL: %s", pszSQL);
+        sqlite3_free(pszSQL);
+        sqlite3_finalize(hIterStmt);
+        return false;
+    }
+    sqlite3_free(pszSQL);
+
+    // Gather all entries in memory to bulk load them, unless they would
+    // take too much memory, in which case insert them in RTree by chuncks
+    // of 100000
+    std::vector<GPKGRTreeEntry> aoEntries;
+    bool bBulkLoad = bCanBulkLoad;
+    const size_t nMaxEntries = bCanBulkLoad ? GetMaxRTreeEntries() : 0;
+    GUIntBig nEntryCount = 0;
+    const size_t nChunkSize = 100000;
+    while( true )
+    {
+        int sqlite_err = sqlite3_step(hIterStmt);
+        bool bFinished = false;
+        if( sqlite_err == SQLITE_ROW )
+        {
+            aoEntries.push_back(GPKGMakeRTreeEntry(
+                sqlite3_column_int64(hIterStmt, 0),
+                sqlite3_column_double(hIterStmt, 1),
+                sqlite3_column_double(hIterStmt, 2),
+                sqlite3_column_double(hIterStmt, 3),
+                sqlite3_column_double(hIterStmt, 4)));
+            if( bBulkLoad && aoEntries.size() > nMaxEntries )
+            {
+                CPLDebug("GPKG", "Too many entries to bulk load %s",
+                         m_osRTreeName.c_str());
+                bBulkLoad = false;
+            }
+        }
+        else if( sqlite_err == SQLITE_DONE )
+        {
+            bFinished = true;
+        }
+        else
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "failed to iterate over features while inserting in "
+                      "RTree: %s",
+                      sqlite3_errmsg( m_poDS->GetDB() ) );
+            sqlite3_finalize(hIterStmt);
+            sqlite3_finalize(hInsertStmt);
+            return false;
+        }
+
+        if( !bBulkLoad && (aoEntries.size() >= nChunkSize || bFinished) )
+        {
+            for( size_t i = 0; i < aoEntries.size(); ++i )
+            {
+                sqlite3_reset(hInsertStmt);
+
+                sqlite3_bind_int64(hInsertStmt,1,aoEntries[i].nId);
+                sqlite3_bind_double(hInsertStmt,2,aoEntries[i].fMinX);
+                sqlite3_bind_double(hInsertStmt,3,aoEntries[i].fMaxX);
+                sqlite3_bind_double(hInsertStmt,4,aoEntries[i].fMinY);
+                sqlite3_bind_double(hInsertStmt,5,aoEntries[i].fMaxY);
+                sqlite_err = sqlite3_step(hInsertStmt);
+                if ( sqlite_err != SQLITE_OK && sqlite_err != SQLITE_DONE )
+                {
+                    CPLError( CE_Failure, CPLE_AppDefined,
+                              "failed to execute insertion in RTree : %s",
+                              sqlite3_errmsg( m_poDS->GetDB() ) );
+                    sqlite3_finalize(hIterStmt);
+                    sqlite3_finalize(hInsertStmt);
+                    return false;
+                }
+            }
+
+            nEntryCount += aoEntries.size();
+            CPLDebug("GPKG", CPL_FRMT_GUIB " rows inserted into %s",
+                     nEntryCount, m_osRTreeName.c_str());
+
+            aoEntries.clear();
+        }
+        if( bFinished )
+            break;
+    }
+
+    sqlite3_finalize(hIterStmt);
+    sqlite3_finalize(hInsertStmt);
+
+    if( bBulkLoad )
+    {
+        CPLDebug("GPKG", "Bulk loading %d entries into %s",
+                 static_cast<int>(aoEntries.size()), m_osRTreeName.c_str());
+        if( !GPKGRTreeBulkLoad(m_poDS->GetDB(), m_osRTreeName, aoEntries) )
+            return false;
+    }
+#endif
+
+    return true;
+}
+
 /************************************************************************/
 /*                    CheckUnknownExtensions()                          */
 /************************************************************************/
@@ -311,6 +311,79 @@ GByte* GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId,
     return pabyWkb;
 }
 
+/* Same as GPkgGeometryFromOGR(), but from a geometry still in WKB form, */
+/* that is reused as it is. Returns NULL, without error, if the WKB is not */
+/* an ISO encoding of a point, line string, polygon, multi geometry or */
+/* geometry collection of those, in which case the caller must decode it. */
+
+GByte* GPkgGeometryFromWKB(const GByte *pabyWKB, size_t nWKBLen, int iSrsId,
+                           size_t *pnGpkgLen)
+{
+    if ( nWKBLen < 5 || (pabyWKB[0] != wkbNDR && pabyWKB[0] != wkbXDR) )
+        return NULL;
+
+    /* Only accept ISO types, as mandated by the specification */
+    GUInt32 nType = 0;
+    memcpy(&nType, pabyWKB + 1, 4);
+    if ( OGR_SWAP((OGRwkbByteOrder)pabyWKB[0]) )
+        CPL_SWAP32PTR(&nType);
+    if ( nType >= 4000 || nType % 1000 < wkbPoint ||
+         nType % 1000 > wkbGeometryCollection )
+        return NULL;
+    const OGRBoolean bPoint = (nType % 1000 == wkbPoint);
+    /* Z or ZM: 3D envelope, see GPkgGeometryFromOGR() */
+    const int iDims = (nType / 1000 == 1 || nType / 1000 == 3) ? 3 : 2;
+
+    OGREnvelope3D oEnv3d;
+    if ( !OGRWKBGetEnvelope(pabyWKB, nWKBLen, &oEnv3d, NULL) )
+        return NULL;
+    const OGRBoolean bEmpty = !oEnv3d.IsInit();
+
+    GByte byFlags = 0;
+    GByte byEnv = 0;
+    OGRwkbByteOrder eByteOrder = (OGRwkbByteOrder)CPL_IS_LSB;
+
+    size_t nHeaderLen = 2+1+1+4;
+    if ( ! bPoint && ! bEmpty )
+    {
+        nHeaderLen += 8*2*iDims;
+        byEnv = (iDims == 3) ? 2 : 1;
+    }
+    if ( bEmpty )
+        byFlags |= (1 << 4);
+    byFlags |= (byEnv << 1);
+    byFlags |= eByteOrder;
+
+    const size_t nGpkgLen = nHeaderLen + nWKBLen;
+    GByte *pabyGpkg = (GByte *)CPLMalloc(nGpkgLen);
+    if (pnGpkgLen)
+        *pnGpkgLen = nGpkgLen;
+
+    pabyGpkg[0] = 0x47;
+    pabyGpkg[1] = 0x50;
+    pabyGpkg[2] = 0;
+    pabyGpkg[3] = byFlags;
+    memcpy(pabyGpkg+4, &iSrsId, 4);
+
+    if ( byEnv != 0 )
+    {
+        double *padPtr = (double*)(pabyGpkg+8);
+        padPtr[0] = oEnv3d.MinX;
+        padPtr[1] = oEnv3d.MaxX;
+        padPtr[2] = oEnv3d.MinY;
+        padPtr[3] = oEnv3d.MaxY;
+        if ( iDims == 3 )
+        {
+            padPtr[4] = oEnv3d.MinZ;
+            padPtr[5] = oEnv3d.MaxZ;
+        }
+    }
+
+    memcpy(pabyGpkg + nHeaderLen, pabyWKB, nWKBLen);
+
+    return pabyGpkg;
+}
+
 OGRErr GPkgHeaderFromWKB(const GByte *pabyGpkg, size_t nGpkgLen, GPkgHeader *poHeader)
 {
     CPLAssert( pabyGpkg != NULL );
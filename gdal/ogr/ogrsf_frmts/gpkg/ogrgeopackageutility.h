@@ -55,6 +55,7 @@ const char*         GPkgFieldFromOGR(OGRFieldType eType, OGRFieldSubType eSubTyp
 OGRwkbGeometryType  GPkgGeometryTypeToWKB(const char *pszGpkgType, bool bHasZ, bool bHasM);
 
 GByte*              GPkgGeometryFromOGR(const OGRGeometry *poGeometry, int iSrsId, size_t *pnWkbLen);
+GByte*              GPkgGeometryFromWKB(const GByte *pabyWKB, size_t nWKBLen, int iSrsId, size_t *pnGpkgLen);
 OGRGeometry*        GPkgGeometryToOGR(const GByte *pabyGpkg, size_t nGpkgLen, OGRSpatialReference *poSrs);
 
 OGRErr              GPkgHeaderFromWKB(const GByte *pabyGpkg, size_t nGpkgLen, GPkgHeader *poHeader);
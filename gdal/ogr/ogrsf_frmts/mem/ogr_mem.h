@@ -66,10 +66,19 @@ class OGRMemLayer : public OGRLayer
 
     bool                m_bUpdated;
 
+    // FIDs of the features matching the attribute filter, when it can be
+    // resolved with attribute indexes.
+    GIntBig            *m_panMatchingFIDs;
+    GIntBig             m_iNextMatchingFID;
+    bool                m_bMatchingFIDsScanned;
+
     // Only use it in the lifetime of a function where the list of features
     // doesn't change.
     IOGRMemLayerFeatureIterator* GetIterator();
 
+    OGRFeature         *GetNextFeatureRef();
+    OGRFeature         *GetFeatureRef( GIntBig nFeatureId );
+
   public:
                         OGRMemLayer( const char * pszName,
                                      OGRSpatialReference *poSRS,
@@ -78,6 +87,8 @@ class OGRMemLayer : public OGRLayer
 
     void                ResetReading() override;
     OGRFeature *        GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures ) override;
     virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
 
     OGRFeature         *GetFeature( GIntBig nFeatureId ) override;
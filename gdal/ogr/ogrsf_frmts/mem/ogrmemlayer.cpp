@@ -62,9 +62,13 @@ OGRMemLayer::OGRMemLayer( const char *pszName, OGRSpatialReference *poSRSIn,
     m_iNextCreateFID(0),
     m_bUpdatable(true),
     m_bAdvertizeUTF8(false),
-    m_bUpdated(false)
+    m_bUpdated(false),
+    m_panMatchingFIDs(NULL),
+    m_iNextMatchingFID(0),
+    m_bMatchingFIDsScanned(false)
 {
     m_poFeatureDefn->Reference();
+    m_bAutoAttrIndex = true;
 
     SetDescription(m_poFeatureDefn->GetName());
     m_poFeatureDefn->SetGeomType(eReqType);
@@ -111,6 +115,8 @@ OGRMemLayer::~OGRMemLayer()
         }
     }
 
+    CPLFree(m_panMatchingFIDs);
+
     if( m_poFeatureDefn )
         m_poFeatureDefn->Release();
 }
@@ -124,19 +130,45 @@ void OGRMemLayer::ResetReading()
 {
     m_iNextReadFID = 0;
     m_oMapFeaturesIter = m_oMapFeatures.begin();
+
+    CPLFree(m_panMatchingFIDs);
+    m_panMatchingFIDs = NULL;
+    m_iNextMatchingFID = 0;
+    m_bMatchingFIDsScanned = false;
 }
 
 /************************************************************************/
-/*                           GetNextFeature()                           */
+/*                         GetNextFeatureRef()                          */
+/*                                                                      */
+/*      Return the next stored feature matching the filters, without    */
+/*      cloning it.                                                     */
 /************************************************************************/
 
-OGRFeature *OGRMemLayer::GetNextFeature()
+OGRFeature *OGRMemLayer::GetNextFeatureRef()
 
 {
+    // On the first request of a pass, try to resolve the attribute
+    // filter with indexes, to only visit the matching features.
+    if( m_poAttrQuery != NULL && !m_bMatchingFIDsScanned )
+    {
+        m_bMatchingFIDsScanned = true;
+        m_iNextMatchingFID = 0;
+        m_panMatchingFIDs =
+            m_poAttrQuery->EvaluateAgainstIndices( this, NULL );
+    }
+
     while( true )
     {
         OGRFeature *poFeature = NULL;
-        if( m_papoFeatures )
+        if( m_panMatchingFIDs != NULL )
+        {
+            if( m_panMatchingFIDs[m_iNextMatchingFID] == OGRNullFID )
+                return NULL;
+            poFeature = GetFeatureRef(m_panMatchingFIDs[m_iNextMatchingFID++]);
+            if( poFeature == NULL )
+                continue;
+        }
+        else if( m_papoFeatures )
         {
             if( m_iNextReadFID >= m_nMaxFeatureCount )
                 return NULL;
@@ -160,13 +192,45 @@ OGRFeature *OGRMemLayer::GetNextFeature()
                 m_poAttrQuery->Evaluate(poFeature)) )
         {
             m_nFeaturesRead++;
-            return poFeature->Clone();
+            return poFeature;
         }
     }
 
     return NULL;
 }
 
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature *OGRMemLayer::GetNextFeature()
+
+{
+    OGRFeature *poFeature = GetNextFeatureRef();
+    return poFeature != NULL ? poFeature->Clone() : NULL;
+}
+
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRMemLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                      int nMaxFeatures )
+
+{
+    // Copy directly from the stored features, instead of going through
+    // the clones returned by GetNextFeature().
+    poBatch->Reset(m_poFeatureDefn);
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+        OGRFeature *poFeature = GetNextFeatureRef();
+        if( poFeature == NULL )
+            break;
+        poBatch->AddFeatureFrom(poFeature);
+    }
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                           SetNextByIndex()                           */
 /************************************************************************/
@@ -192,6 +256,17 @@ OGRErr OGRMemLayer::SetNextByIndex( GIntBig nIndex )
 
 OGRFeature *OGRMemLayer::GetFeature( GIntBig nFeatureId )
 
+{
+    OGRFeature *poFeature = GetFeatureRef(nFeatureId);
+    return poFeature != NULL ? poFeature->Clone() : NULL;
+}
+
+/************************************************************************/
+/*                           GetFeatureRef()                            */
+/************************************************************************/
+
+OGRFeature *OGRMemLayer::GetFeatureRef( GIntBig nFeatureId )
+
 {
     if( nFeatureId < 0 )
         return NULL;
@@ -209,10 +284,7 @@ OGRFeature *OGRMemLayer::GetFeature( GIntBig nFeatureId )
         if( oIter != m_oMapFeatures.end() )
             poFeature = oIter->second;
     }
-    if( poFeature == NULL )
-        return NULL;
-
-    return poFeature->Clone();
+    return poFeature;
 }
 
 /************************************************************************/
@@ -415,7 +487,9 @@ OGRErr OGRMemLayer::ICreateFeature( OGRFeature *poFeature )
         }
     }
 
-    return SetFeature(poFeature);
+    // Geometries have already been converted by CreateFeature(), and going
+    // through SetFeature() would drop the attribute indexes.
+    return ISetFeature(poFeature);
 }
 
 /************************************************************************/
@@ -72,6 +72,10 @@ class OGRODSLayer : public OGRMemLayer
     /* For external usage. Mess with FID */
     virtual OGRFeature *        GetNextFeature() override;
     virtual OGRFeature         *GetFeature( GIntBig nFeatureId ) override;
+    // Not the OGRMemLayer one, that would bypass the above GetNextFeature()
+    virtual int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                                     int nMaxFeatures ) override
+    { return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures); }
     virtual OGRErr              ISetFeature( OGRFeature *poFeature ) override;
     virtual OGRErr              DeleteFeature( GIntBig nFID ) override;
 
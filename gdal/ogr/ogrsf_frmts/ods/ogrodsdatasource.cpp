@@ -69,7 +69,11 @@ OGRODSLayer::OGRODSLayer( OGRODSDataSource* poDSIn,
     bUpdated(CPL_TO_BOOL(bUpdatedIn)),
     bHasHeaderLine(false),
     m_poAttrQueryODS(NULL)
-{}
+{
+    // The FIDs exposed are shifted from the ones of OGRMemLayer, which
+    // in-memory attribute indexes would mix up.
+    m_bAutoAttrIndex = false;
+}
 
 /************************************************************************/
 /*                            ~OGRODSLayer()                            */
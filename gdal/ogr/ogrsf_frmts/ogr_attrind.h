@@ -32,6 +32,10 @@
 
 #include "ogrsf_frmts.h"
 
+#include <map>
+#include <utility>
+#include <vector>
+
 //! @cond Doxygen_Suppress
 
 /************************************************************************/
@@ -52,6 +56,10 @@ public:
     virtual GIntBig  *GetAllMatches( OGRField *psKey ) = 0;
     virtual GIntBig  *GetAllMatches( OGRField *psKey, GIntBig* panFIDList, int* nFIDCount, int* nLength ) = 0;
 
+    virtual GIntBig  *GetRangeMatches( OGRField *psMin, bool bMinIncluded,
+                                       OGRField *psMax, bool bMaxIncluded,
+                                       int *pnFIDCount );
+
     virtual OGRErr AddEntry( OGRField *psKey, GIntBig nFID ) = 0;
     virtual OGRErr RemoveEntry( OGRField *psKey, GIntBig nFID ) = 0;
 
@@ -90,6 +98,88 @@ public:
 
 OGRLayerAttrIndex CPL_DLL *OGRCreateDefaultLayerIndex();
 
+/************************************************************************/
+/*                           OGRMemAttrIndex                            */
+/*                                                                      */
+/*      In-memory index of the values of one field, as an array of      */
+/*      (key, FID) pairs sorted on demand.  It serves equality, IN      */
+/*      and range lookups.                                              */
+/************************************************************************/
+
+class CPL_DLL OGRMemAttrIndex : public OGRAttrIndex
+{
+    CPLString           osFieldName;
+    OGRFieldType        eType;
+
+    bool                bSorted;
+    std::vector< std::pair<GIntBig, GIntBig> >   aoIntegerEntries;
+    std::vector< std::pair<double, GIntBig> >    aoRealEntries;
+    std::vector< std::pair<CPLString, GIntBig> > aoStringEntries;
+    GIntBig             nStringBytes;
+
+    void                Sort();
+    static CPLString    GetStringKey( const char *pszValue );
+
+public:
+    explicit    OGRMemAttrIndex( OGRFieldDefn *poFieldDefn );
+    virtual     ~OGRMemAttrIndex();
+
+    GIntBig     GetFirstMatch( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey ) override;
+    GIntBig    *GetAllMatches( OGRField *psKey, GIntBig* panFIDList,
+                               int* nFIDCount, int* nLength ) override;
+
+    // For OFTInteger and OFTInteger64 fields, the bounds are read from
+    // the Integer64 member.
+    GIntBig    *GetRangeMatches( OGRField *psMin, bool bMinIncluded,
+                                 OGRField *psMax, bool bMaxIncluded,
+                                 int *pnFIDCount ) override;
+
+    OGRErr      AddEntry( OGRField *psKey, GIntBig nFID ) override;
+    OGRErr      RemoveEntry( OGRField *psKey, GIntBig nFID ) override;
+
+    OGRErr      Clear() override;
+
+    const char *GetFieldName() const { return osFieldName; }
+    OGRFieldType GetFieldType() const { return eType; }
+    GIntBig     GetMemoryUsage() const;
+
+    static bool IsSupportedType( OGRFieldType eFieldType );
+};
+
+/************************************************************************/
+/*                         OGRMemLayerAttrIndex                         */
+/*                                                                      */
+/*      In-memory indexes for the fields of a layer, that OGRLayer      */
+/*      builds on demand for repeated attribute filters.                */
+/************************************************************************/
+
+class CPL_DLL OGRMemLayerAttrIndex : public OGRLayerAttrIndex
+{
+    std::map<int, OGRMemAttrIndex*> oMapIndex;
+    std::map<CPLString, int> oMapUseCount;
+    GIntBig             nMaxMemoryUsage;
+
+public:
+                OGRMemLayerAttrIndex();
+    virtual     ~OGRMemLayerAttrIndex();
+
+    OGRErr      Initialize( const char *pszIndexPath, OGRLayer * ) override;
+
+    OGRErr      CreateIndex( int iField ) override;
+    OGRErr      DropIndex( int iField ) override;
+    OGRErr      IndexAllFeatures( int iField = -1 ) override;
+
+    OGRErr      AddToIndex( OGRFeature *poFeature, int iField = -1 ) override;
+    OGRErr      RemoveFromIndex( OGRFeature *poFeature ) override;
+
+    OGRAttrIndex *GetFieldIndex( int iField ) override;
+
+    GIntBig     GetMemoryUsage() const;
+    int         IncrementUse( int iField );
+    void        Invalidate();
+};
+
 //! @endcond
 
 #endif /* ndef OGR_ATTRIND_H_INCLUDED */
@@ -69,6 +69,7 @@ class CPL_DLL OGRLayer : public GDALMajorObject
 {
   private:
     void         ConvertGeomsIfNecessary( OGRFeature *poFeature );
+    void         BuildAutoAttrIndex();
 
   protected:
 //! @cond Doxygen_Suppress
@@ -84,6 +85,8 @@ class CPL_DLL OGRLayer : public GDALMajorObject
     int          InstallFilter( OGRGeometry * );
 
     OGRErr       GetExtentInternal(int iGeomField, OGREnvelope *psExtent, int bForce );
+
+    void         InvalidateAutoAttrIndex();
 //! @endcond
 
     virtual OGRErr      ISetFeature( OGRFeature *poFeature ) CPL_WARN_UNUSED_RESULT;
@@ -107,6 +110,8 @@ class CPL_DLL OGRLayer : public GDALMajorObject
 
     virtual void        ResetReading() = 0;
     virtual OGRFeature *GetNextFeature() CPL_WARN_UNUSED_RESULT = 0;
+    virtual int         GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures );
     virtual OGRErr      SetNextByIndex( GIntBig nIndex );
     virtual OGRFeature *GetFeature( GIntBig nFID )  CPL_WARN_UNUSED_RESULT;
 
@@ -206,6 +211,7 @@ class CPL_DLL OGRLayer : public GDALMajorObject
     /* consider these private */
     OGRErr               InitializeIndexSupport( const char * );
     OGRLayerAttrIndex   *GetIndex() { return m_poAttrIndex; }
+    OGRLayerAttrIndex   *GetAutoIndex() { return m_poAutoAttrIndex; }
 //! @endcond
 
  protected:
@@ -215,6 +221,12 @@ class CPL_DLL OGRLayer : public GDALMajorObject
     char                *m_pszAttrQueryString;
     OGRLayerAttrIndex   *m_poAttrIndex;
 
+    // Set by drivers whose attribute filtering goes through
+    // OGRFeatureQuery::EvaluateAgainstIndices(), so that OGRLayer
+    // can build in-memory indexes for repeated filters.
+    bool                 m_bAutoAttrIndex;
+    OGRLayerAttrIndex   *m_poAutoAttrIndex;
+
     int                  m_nRefCount;
 
     GIntBig              m_nFeaturesRead;
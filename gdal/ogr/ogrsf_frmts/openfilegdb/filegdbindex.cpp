@@ -30,6 +30,7 @@
 #include "cpl_string.h"
 #include "cpl_time.h"
 #include <algorithm>
+#include <climits>
 
 CPL_CVSID("$Id$")
 
@@ -1838,4 +1839,270 @@ int FileGDBIndexIterator::GetMinMaxSumCount(double& dfMin, double& dfMax,
     return TRUE;
 }
 
+/************************************************************************/
+/*                              GetUInt64()                             */
+/************************************************************************/
+
+static GUInt64 GetUInt64(const GByte* pBaseAddr, int iOffset)
+{
+    GUInt64 nVal;
+    memcpy(&nVal, pBaseAddr + sizeof(nVal) * iOffset, sizeof(nVal));
+    CPL_LSBPTR64(&nVal);
+    return nVal;
+}
+
+/************************************************************************/
+/*                      FileGDBSpatialIndexIterator                     */
+/************************************************************************/
+
+/* The .spx file has the same B-tree structure as the .atx files, with */
+/* 64-bit keys. Each key encodes the level of the grid in its 2 upper */
+/* bits, and then the column (x / cell_size + 2^29) on 30 bits and the */
+/* line (y / cell_size + 2^29) on 31 bits of a cell. A feature has one */
+/* key for each cell that its bounding box covers, in one of the levels */
+/* of the grid. The iterator returns the rows that have a cell within */
+/* the filter envelope, which is a superset of the rows that intersect it. */
+
+static const int SPX_CELL_SHIFT = 1 << 29;
+static const GUInt32 SPX_MAX_CELL = (1U << 30) - 1;
+
+class FileGDBSpatialIndexIterator CPL_FINAL : public FileGDBIterator
+{
+        FileGDBTable        *poParent;
+        VSILFILE            *fpSpx;
+        GUInt32              nMaxPerPages;
+        GUInt32              nOffsetFirstValInPage;
+        GUInt32              nIndexDepth;
+        GUInt32              nPageCount;
+        std::vector<int>     anRows;
+        size_t               iCurRow;
+
+        explicit             FileGDBSpatialIndexIterator(FileGDBTable* poParent);
+        int                  Init(const OGREnvelope& sFilterEnvelope);
+        int                  CollectRows(GUInt32 nPage, GUInt32 iLevel,
+                                         GUInt64 nMinKey, GUInt64 nMaxKey,
+                                         GUInt32 nMinLine, GUInt32 nMaxLine);
+
+    public:
+        virtual             ~FileGDBSpatialIndexIterator();
+
+        static FileGDBIterator*      Build(FileGDBTable* poParent,
+                                           const OGREnvelope& sFilterEnvelope);
+
+        virtual FileGDBTable        *GetTable() override { return poParent; }
+        virtual void                 Reset() override { iCurRow = 0; }
+        virtual int                  GetNextRowSortedByFID() override;
+        virtual int                  GetRowCount() override
+                { return static_cast<int>(anRows.size()); }
+};
+
+/************************************************************************/
+/*                         BuildSpatialIndex()                          */
+/************************************************************************/
+
+FileGDBIterator* FileGDBIterator::BuildSpatialIndex(
+                                        FileGDBTable* poParent,
+                                        const OGREnvelope& sFilterEnvelope)
+{
+    return FileGDBSpatialIndexIterator::Build(poParent, sFilterEnvelope);
+}
+
+/************************************************************************/
+/*                     FileGDBSpatialIndexIterator()                    */
+/************************************************************************/
+
+FileGDBSpatialIndexIterator::FileGDBSpatialIndexIterator(
+                                            FileGDBTable* poParentIn ) :
+    poParent(poParentIn),
+    fpSpx(NULL),
+    nMaxPerPages(0),
+    nOffsetFirstValInPage(0),
+    nIndexDepth(0),
+    nPageCount(0),
+    iCurRow(0)
+{}
+
+/************************************************************************/
+/*                    ~FileGDBSpatialIndexIterator()                    */
+/************************************************************************/
+
+FileGDBSpatialIndexIterator::~FileGDBSpatialIndexIterator()
+{
+    if( fpSpx )
+        VSIFCloseL(fpSpx);
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+FileGDBIterator* FileGDBSpatialIndexIterator::Build(
+                                        FileGDBTable* poParent,
+                                        const OGREnvelope& sFilterEnvelope)
+{
+    FileGDBSpatialIndexIterator* poIterator =
+                new FileGDBSpatialIndexIterator(poParent);
+    if( poIterator->Init(sFilterEnvelope) )
+    {
+        return poIterator;
+    }
+    delete poIterator;
+    return NULL;
+}
+
+/************************************************************************/
+/*                            SpxCellIndex()                            */
+/************************************************************************/
+
+static GUInt32 SpxCellIndex(double dfCoord, double dfCellSize)
+{
+    const double dfIdx = floor(dfCoord / dfCellSize) + SPX_CELL_SHIFT;
+    if( !(dfIdx >= 0) )
+        return 0;
+    if( dfIdx >= SPX_MAX_CELL )
+        return SPX_MAX_CELL;
+    return static_cast<GUInt32>(dfIdx);
+}
+
+/************************************************************************/
+/*                                Init()                                */
+/************************************************************************/
+
+int FileGDBSpatialIndexIterator::Init(const OGREnvelope& sFilterEnvelope)
+{
+    const int errorRetValue = FALSE;
+
+    const FileGDBGeomField* poGeomField = poParent->GetGeomField();
+    if( poGeomField == NULL )
+        return FALSE;
+    const std::vector<double>& adfGridResolution =
+                            poGeomField->GetSpatialIndexGridResolution();
+    if( adfGridResolution.empty() || adfGridResolution.size() > 3 )
+        return FALSE;
+
+    const char* pszSpxName = CPLFormFilename(
+                    CPLGetPath(poParent->GetFilename().c_str()),
+                    CPLGetBasename(poParent->GetFilename().c_str()), "spx");
+    fpSpx = VSIFOpenL( pszSpxName, "rb" );
+    if( fpSpx == NULL )
+        return FALSE;
+
+    VSIFSeekL(fpSpx, 0, SEEK_END);
+    vsi_l_offset nFileSize = VSIFTellL(fpSpx);
+    returnErrorIf(nFileSize < FGDB_PAGE_SIZE + 22 );
+    nPageCount = static_cast<GUInt32>(
+        std::min(nFileSize / FGDB_PAGE_SIZE,
+                 static_cast<vsi_l_offset>(UINT_MAX)));
+
+    VSIFSeekL(fpSpx, nFileSize - 22, SEEK_SET);
+    GByte abyTrailer[22];
+    returnErrorIf(VSIFReadL( abyTrailer, 22, 1, fpSpx ) != 1 );
+
+    returnErrorIf(abyTrailer[0] != sizeof(GUInt64));
+    nMaxPerPages = (FGDB_PAGE_SIZE - 12) / (4 + abyTrailer[0]);
+    nOffsetFirstValInPage = 12 + nMaxPerPages * 4;
+
+    GUInt32 nMagic1 = GetUInt32(abyTrailer + 2, 0);
+    returnErrorIf(nMagic1 != 1 );
+
+    nIndexDepth = GetUInt32(abyTrailer + 6, 0);
+    returnErrorIf(!(nIndexDepth >= 1 && nIndexDepth <= MAX_DEPTH + 1) );
+
+    for( size_t iGrid = 0; iGrid < adfGridResolution.size(); iGrid++ )
+    {
+        const double dfCellSize = adfGridResolution[iGrid];
+        if( !(dfCellSize > 0) )
+            continue;
+        const GUInt32 nMinCol = SpxCellIndex(sFilterEnvelope.MinX, dfCellSize);
+        const GUInt32 nMaxCol = SpxCellIndex(sFilterEnvelope.MaxX, dfCellSize);
+        const GUInt32 nMinLine = SpxCellIndex(sFilterEnvelope.MinY, dfCellSize);
+        const GUInt32 nMaxLine = SpxCellIndex(sFilterEnvelope.MaxY, dfCellSize);
+        const GUInt64 nGridKey = static_cast<GUInt64>(iGrid) << 62;
+        const GUInt64 nMinKey = nGridKey |
+            (static_cast<GUInt64>(nMinCol) << 31) | nMinLine;
+        const GUInt64 nMaxKey = nGridKey |
+            (static_cast<GUInt64>(nMaxCol) << 31) | nMaxLine;
+        if( !CollectRows(1, 0, nMinKey, nMaxKey, nMinLine, nMaxLine) )
+            return FALSE;
+    }
+
+    /* A feature has several cells, and may appear in several levels */
+    std::sort(anRows.begin(), anRows.end());
+    anRows.erase(std::unique(anRows.begin(), anRows.end()), anRows.end());
+
+    CPLDebug("OpenFileGDB", "Using spatial index: %d candidate rows",
+             static_cast<int>(anRows.size()));
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                            CollectRows()                             */
+/************************************************************************/
+
+int FileGDBSpatialIndexIterator::CollectRows(GUInt32 nPage, GUInt32 iLevel,
+                                             GUInt64 nMinKey, GUInt64 nMaxKey,
+                                             GUInt32 nMinLine,
+                                             GUInt32 nMaxLine)
+{
+    const int errorRetValue = FALSE;
+    returnErrorIf(nPage < 1 || nPage > nPageCount);
+
+    GByte abyPage[FGDB_PAGE_SIZE];
+    VSIFSeekL(fpSpx, static_cast<vsi_l_offset>(nPage - 1) * FGDB_PAGE_SIZE,
+              SEEK_SET);
+    returnErrorIf(VSIFReadL( abyPage, FGDB_PAGE_SIZE, 1, fpSpx ) != 1 );
+
+    const GUInt32 nCount = GetUInt32(abyPage + 4, 0);
+    const GByte* pabyKeys = abyPage + nOffsetFirstValInPage;
+
+    if( iLevel + 1 < nIndexDepth )
+    {
+        /* Page i contains the keys lower or equal to the i-th key, and */
+        /* the last page the keys greater than the last one. */
+        returnErrorIf(nCount == 0 || nCount > nMaxPerPages);
+        for( GUInt32 i = 0; i <= nCount; i++ )
+        {
+            if( i > 0 && GetUInt64(pabyKeys, i - 1) > nMaxKey )
+                break;
+            if( i < nCount && GetUInt64(pabyKeys, i) < nMinKey )
+                continue;
+            const GUInt32 nSubPage = GetUInt32(abyPage + 8, i);
+            returnErrorIf(nSubPage < 2);
+            if( !CollectRows(nSubPage, iLevel + 1, nMinKey, nMaxKey,
+                             nMinLine, nMaxLine) )
+                return FALSE;
+        }
+        return TRUE;
+    }
+
+    returnErrorIf(nCount > nMaxPerPages);
+    const int nTotalRecordCount = poParent->GetTotalRecordCount();
+    for( GUInt32 i = 0; i < nCount; i++ )
+    {
+        const GUInt64 nKey = GetUInt64(pabyKeys, i);
+        if( nKey < nMinKey || nKey > nMaxKey )
+            continue;
+        const GUInt32 nLine = static_cast<GUInt32>(nKey & 0x7FFFFFFF);
+        if( nLine < nMinLine || nLine > nMaxLine )
+            continue;
+        const GUInt32 nFID = GetUInt32(abyPage + 12, i);
+        returnErrorIf(nFID < 1 ||
+                      nFID > static_cast<GUInt32>(nTotalRecordCount));
+        anRows.push_back(static_cast<int>(nFID - 1));
+    }
+    return TRUE;
+}
+
+/************************************************************************/
+/*                        GetNextRowSortedByFID()                       */
+/************************************************************************/
+
+int FileGDBSpatialIndexIterator::GetNextRowSortedByFID()
+{
+    if( iCurRow == anRows.size() )
+        return -1;
+    return anRows[iCurRow++];
+}
+
 } /* namespace OpenFileGDB */
@@ -1040,6 +1040,13 @@ int FileGDBTable::Open(const char* pszFilename,
                         nRemaining -= 5;
                         returnErrorIf(nRemaining < (GUInt32)(nToSkip * 8) );
                         nCountDoubles += nToSkip;
+                        /* Those are the cell sizes of the levels of the */
+                        /* grid of the spatial index (.spx) */
+                        for( int iGrid = 0; iGrid < nToSkip; iGrid++ )
+                        {
+                            poField->adfSpatialIndexGridResolution.push_back(
+                                GetFloat64(pabyIter, iGrid));
+                        }
                         pabyIter += nToSkip * 8;
                         nRemaining -= nToSkip * 8;
                         break;
@@ -144,6 +144,7 @@ class FileGDBGeomField: public FileGDBField
         double            dfXMax;
         double            dfYMax;
         int               bHas3D;
+        std::vector<double> adfSpatialIndexGridResolution;
 
     public:
         explicit          FileGDBGeomField(FileGDBTable* poParent);
@@ -173,6 +174,9 @@ class FileGDBGeomField: public FileGDBField
         double             GetMTolerance() const { return dfMTolerance; }
 
         int                Has3D() const { return bHas3D; }
+
+        const std::vector<double>& GetSpatialIndexGridResolution() const
+                                { return adfSpatialIndexGridResolution; }
 };
 
 /************************************************************************/
@@ -371,6 +375,8 @@ class FileGDBIterator
         static FileGDBIterator*      BuildOr(FileGDBIterator* poIter1,
                                              FileGDBIterator* poIter2,
                                              int bIteratorAreExclusive = FALSE);
+        static FileGDBIterator*      BuildSpatialIndex(FileGDBTable* poParent,
+                                                       const OGREnvelope& sFilterEnvelope);
 };
 
 /************************************************************************/
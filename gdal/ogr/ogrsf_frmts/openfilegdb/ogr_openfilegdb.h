@@ -75,6 +75,8 @@ class OGROpenFileGDBLayer : public OGRLayer
     int               BuildLayerDefinition();
     int               BuildGeometryColumnGDBv10();
     OGRFeature       *GetCurrentFeature();
+    void              AddToSpatialIndex(int iRow, const OGRField* psField);
+    OGRGeometry      *GetAsPromotedGeometry(const OGRField* psField);
 
     FileGDBOGRGeometryConverter* m_poGeomConverter;
 
@@ -90,10 +92,13 @@ class OGROpenFileGDBLayer : public OGRLayer
     CPLQuadTree        *m_pQuadTree;
     void              **m_pahFilteredFeatures;
     int                 m_nFilteredFeatureCount;
+    bool                m_bFilteredFeaturesAreCandidates;
+    int                 m_nHasSpatialIndex;
     static void         GetBoundsFuncEx(const void* hFeature,
                                         CPLRectObj* pBounds,
                                         void* pQTUserData);
     void                TryToDetectMultiPatchKind();
+    bool                HasSpatialIndex();
 
 public:
 
@@ -128,6 +133,8 @@ public:
 
   virtual void        ResetReading() override;
   virtual OGRFeature* GetNextFeature() override;
+  virtual int         GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                           int nMaxFeatures ) override;
   virtual OGRFeature* GetFeature( GIntBig nFeatureId ) override;
   virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
 
@@ -155,7 +155,9 @@ OGROpenFileGDBLayer::OGROpenFileGDBLayer( const char* pszGDBFilename,
     m_eSpatialIndexState(SPI_IN_BUILDING),
     m_pQuadTree(NULL),
     m_pahFilteredFeatures(NULL),
-    m_nFilteredFeatureCount(-1)
+    m_nFilteredFeatureCount(-1),
+    m_bFilteredFeaturesAreCandidates(false),
+    m_nHasSpatialIndex(-1)
 {
     // TODO(rouault): What error on compiler versions?  r33032 does not say.
 
@@ -798,6 +800,38 @@ void OGROpenFileGDBLayer::ResetReading()
         m_poIterator->Reset();
 }
 
+/***********************************************************************/
+/*                         HasSpatialIndex()                           */
+/*                                                                     */
+/*      Whether a .spx spatial index file can be used for the geometry */
+/*      field of the layer.                                            */
+/***********************************************************************/
+
+bool OGROpenFileGDBLayer::HasSpatialIndex()
+{
+    if( m_nHasSpatialIndex < 0 )
+    {
+        m_nHasSpatialIndex = FALSE;
+        if( m_iGeomFieldIdx >= 0 &&
+            CPLTestBool(CPLGetConfigOption("OPENFILEGDB_USE_SPATIAL_INDEX",
+                                           "YES")) )
+        {
+            FileGDBGeomField* poGDBGeomField = reinterpret_cast<
+                FileGDBGeomField*>(m_poLyrTable->GetField(m_iGeomFieldIdx));
+            if( !poGDBGeomField->GetSpatialIndexGridResolution().empty() )
+            {
+                CPLString osSpxName = CPLFormFilename(
+                    CPLGetPath(m_osGDBFilename.c_str()),
+                    CPLGetBasename(m_osGDBFilename.c_str()), "spx");
+                VSIStatBufL sStat;
+                m_nHasSpatialIndex =
+                    VSIStatExL(osSpxName, &sStat, VSI_STAT_EXISTS_FLAG) == 0;
+            }
+        }
+    }
+    return m_nHasSpatialIndex == TRUE;
+}
+
 /***********************************************************************/
 /*                         SetSpatialFilter()                          */
 /***********************************************************************/
@@ -827,6 +861,7 @@ void OGROpenFileGDBLayer::SetSpatialFilter( OGRGeometry *poGeom )
         }
     }
 
+    m_bFilteredFeaturesAreCandidates = false;
     if( poGeom != NULL )
     {
         if( m_eSpatialIndexState == SPI_COMPLETED )
@@ -847,6 +882,46 @@ void OGROpenFileGDBLayer::SetSpatialFilter( OGRGeometry *poGeom )
                 std::sort(panStart, panStart + m_nFilteredFeatureCount);
             }
         }
+        else if( HasSpatialIndex() &&
+                 !CPLIsNan(m_sFilterEnvelope.MinX) &&
+                 !CPLIsNan(m_sFilterEnvelope.MinY) &&
+                 !CPLIsNan(m_sFilterEnvelope.MaxX) &&
+                 !CPLIsNan(m_sFilterEnvelope.MaxY) )
+        {
+            // The .spx index returns the rows whose bounding box intersects
+            // grid cells touched by the filter: those are only candidates
+            // that GetCurrentFeature() and FilterGeometry() refine.
+            FileGDBIterator* poSpxIterator =
+                FileGDBIterator::BuildSpatialIndex(m_poLyrTable,
+                                                   m_sFilterEnvelope);
+            CPLFree(m_pahFilteredFeatures);
+            m_pahFilteredFeatures = NULL;
+            m_nFilteredFeatureCount = -1;
+            if( poSpxIterator != NULL )
+            {
+                const int nRows = poSpxIterator->GetRowCount();
+                m_pahFilteredFeatures = static_cast<void**>(
+                    VSI_MALLOC2_VERBOSE(sizeof(void*), std::max(1, nRows)));
+                if( m_pahFilteredFeatures != NULL )
+                {
+                    m_nFilteredFeatureCount = 0;
+                    int iRow;
+                    while( (iRow = poSpxIterator->GetNextRowSortedByFID()) >= 0 )
+                    {
+                        m_pahFilteredFeatures[m_nFilteredFeatureCount++] =
+                            (void*)(size_t)iRow;
+                    }
+                    m_bFilteredFeaturesAreCandidates = true;
+                    if( m_eSpatialIndexState == SPI_IN_BUILDING )
+                        m_eSpatialIndexState = SPI_INVALID;
+                }
+                delete poSpxIterator;
+            }
+            else
+            {
+                m_nHasSpatialIndex = FALSE;
+            }
+        }
         m_poLyrTable->InstallFilterEnvelope(&m_sFilterEnvelope);
     }
     else
@@ -1397,6 +1472,59 @@ OGRErr OGROpenFileGDBLayer::SetAttributeFilter( const char* pszFilter )
     return eErr;
 }
 
+/***********************************************************************/
+/*                         AddToSpatialIndex()                         */
+/***********************************************************************/
+
+void OGROpenFileGDBLayer::AddToSpatialIndex(int iRow, const OGRField* psField)
+{
+    OGREnvelope sFeatureEnvelope;
+    if( m_poLyrTable->GetFeatureExtent(psField, &sFeatureEnvelope) )
+    {
+        CPLRectObj sBounds;
+        sBounds.minx = sFeatureEnvelope.MinX;
+        sBounds.miny = sFeatureEnvelope.MinY;
+        sBounds.maxx = sFeatureEnvelope.MaxX;
+        sBounds.maxy = sFeatureEnvelope.MaxY;
+        CPLQuadTreeInsertWithBounds(m_pQuadTree,
+                                    (void*)(size_t)iRow,
+                                    &sBounds);
+    }
+}
+
+/***********************************************************************/
+/*                       GetAsPromotedGeometry()                       */
+/*                                                                     */
+/*      Polygons and lines are reported as multi geometries, to be     */
+/*      consistent with the advertized layer geometry type.            */
+/***********************************************************************/
+
+OGRGeometry* OGROpenFileGDBLayer::GetAsPromotedGeometry(const OGRField* psField)
+{
+    OGRGeometry* poGeom = m_poGeomConverter->GetAsGeometry(psField);
+    if( poGeom != NULL )
+    {
+        OGRwkbGeometryType eFlattenType = wkbFlatten(poGeom->getGeometryType());
+        if( eFlattenType == wkbPolygon )
+            poGeom = OGRGeometryFactory::forceToMultiPolygon(poGeom);
+        else if( eFlattenType == wkbCurvePolygon)
+        {
+            OGRMultiSurface* poMS = new OGRMultiSurface();
+            poMS->addGeometryDirectly( poGeom );
+            poGeom = poMS;
+        }
+        else if( eFlattenType == wkbLineString )
+            poGeom = OGRGeometryFactory::forceToMultiLineString(poGeom);
+        else if (eFlattenType == wkbCompoundCurve)
+        {
+            OGRMultiCurve* poMC = new OGRMultiCurve();
+            poMC->addGeometryDirectly( poGeom );
+            poGeom = poMC;
+        }
+    }
+    return poGeom;
+}
+
 /***********************************************************************/
 /*                         GetCurrentFeature()                         */
 /***********************************************************************/
@@ -1421,21 +1549,7 @@ OGRFeature* OGROpenFileGDBLayer::GetCurrentFeature()
             if( psField != NULL )
             {
                 if( m_eSpatialIndexState == SPI_IN_BUILDING )
-                {
-                    OGREnvelope sFeatureEnvelope;
-                    if( m_poLyrTable->GetFeatureExtent(psField,
-                                                       &sFeatureEnvelope) )
-                    {
-                        CPLRectObj sBounds;
-                        sBounds.minx = sFeatureEnvelope.MinX;
-                        sBounds.miny = sFeatureEnvelope.MinY;
-                        sBounds.maxx = sFeatureEnvelope.MaxX;
-                        sBounds.maxy = sFeatureEnvelope.MaxY;
-                        CPLQuadTreeInsertWithBounds(m_pQuadTree,
-                                                    (void*)(size_t)iRow,
-                                                    &sBounds);
-                    }
-                }
+                    AddToSpatialIndex(iRow, psField);
 
                 if( m_poFilterGeom != NULL &&
                     m_eSpatialIndexState != SPI_COMPLETED &&
@@ -1445,27 +1559,9 @@ OGRFeature* OGROpenFileGDBLayer::GetCurrentFeature()
                     return NULL;
                 }
 
-                OGRGeometry* poGeom = m_poGeomConverter->GetAsGeometry(psField);
+                OGRGeometry* poGeom = GetAsPromotedGeometry(psField);
                 if( poGeom != NULL )
                 {
-                    OGRwkbGeometryType eFlattenType = wkbFlatten(poGeom->getGeometryType());
-                    if( eFlattenType == wkbPolygon )
-                        poGeom = OGRGeometryFactory::forceToMultiPolygon(poGeom);
-                    else if( eFlattenType == wkbCurvePolygon)
-                    {
-                        OGRMultiSurface* poMS = new OGRMultiSurface();
-                        poMS->addGeometryDirectly( poGeom );
-                        poGeom = poMS;
-                    }
-                    else if( eFlattenType == wkbLineString )
-                        poGeom = OGRGeometryFactory::forceToMultiLineString(poGeom);
-                    else if (eFlattenType == wkbCompoundCurve)
-                    {
-                        OGRMultiCurve* poMC = new OGRMultiCurve();
-                        poMC->addGeometryDirectly( poGeom );
-                        poGeom = poMC;
-                    }
-
                     poGeom->assignSpatialReference(
                         m_poFeatureDefn->GetGeomFieldDefn(0)->GetSpatialRef() );
 
@@ -1600,7 +1696,8 @@ OGRFeature* OGROpenFileGDBLayer::GetNextFeature()
         if( (m_poFilterGeom == NULL
              || FilterGeometry( poFeature->GetGeometryRef() ) )
             && (m_poAttrQuery == NULL ||
-                (m_poIterator != NULL && m_bIteratorSufficientToEvaluateFilter) ||
+                (m_poIterator != NULL && m_bIteratorSufficientToEvaluateFilter &&
+                 m_nFilteredFeatureCount < 0) ||
                 m_poAttrQuery->Evaluate( poFeature ) ) )
         {
             return poFeature;
@@ -1610,6 +1707,101 @@ OGRFeature* OGROpenFileGDBLayer::GetNextFeature()
     }
 }
 
+/***********************************************************************/
+/*                        GetNextFeatureBatch()                        */
+/*                                                                     */
+/*      Sequential reads without filters fill the batch directly from  */
+/*      the raw field values of the table, without creating features.  */
+/***********************************************************************/
+
+int OGROpenFileGDBLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                              int nMaxFeatures )
+{
+    if( !BuildLayerDefinition() || m_poAttrQuery != NULL ||
+        m_poFilterGeom != NULL || m_poIterator != NULL ||
+        m_nFilteredFeatureCount >= 0 )
+    {
+        return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+    }
+
+    poBatch->Reset(m_poFeatureDefn);
+
+    const bool bGeomIgnored = m_iGeomFieldIdx >= 0 &&
+        m_poFeatureDefn->GetGeomFieldDefn(0)->IsIgnored();
+    if( bGeomIgnored && m_eSpatialIndexState == SPI_IN_BUILDING )
+        m_eSpatialIndexState = SPI_INVALID;
+
+    while( !m_bEOF && poBatch->GetFeatureCount() < nMaxFeatures &&
+           m_iCurFeat < m_poLyrTable->GetTotalRecordCount() )
+    {
+        m_iCurFeat = m_poLyrTable->GetAndSelectNextNonEmptyRow(m_iCurFeat);
+        if( m_iCurFeat < 0 )
+        {
+            m_bEOF = TRUE;
+            break;
+        }
+        const int iRow = m_iCurFeat;
+        m_iCurFeat ++;
+
+        poBatch->AddFeature(iRow + 1);
+
+        int iOGRIdx = 0;
+        for(int iGDBIdx=0;iGDBIdx<m_poLyrTable->GetFieldCount();iGDBIdx++)
+        {
+            if( iGDBIdx == m_iGeomFieldIdx )
+            {
+                if( bGeomIgnored )
+                    continue;
+                const OGRField* psField = m_poLyrTable->GetFieldValue(iGDBIdx);
+                if( psField != NULL )
+                {
+                    if( m_eSpatialIndexState == SPI_IN_BUILDING )
+                        AddToSpatialIndex(iRow, psField);
+                    OGRGeometry* poGeom = GetAsPromotedGeometry(psField);
+                    if( poGeom != NULL )
+                    {
+                        poBatch->SetGeomField(0, poGeom);
+                        delete poGeom;
+                    }
+                }
+            }
+            else
+            {
+                if( !m_poFeatureDefn->GetFieldDefn(iOGRIdx)->IsIgnored() )
+                {
+                    const OGRField* psField =
+                        m_poLyrTable->GetFieldValue(iGDBIdx);
+                    if( psField != NULL )
+                    {
+                        if( iGDBIdx == m_iFieldToReadAsBinary )
+                            poBatch->SetFieldString(iOGRIdx,
+                                reinterpret_cast<const char*>(
+                                    psField->Binary.paData));
+                        else
+                            poBatch->SetFieldRaw(iOGRIdx, psField);
+                    }
+                }
+                iOGRIdx ++;
+            }
+        }
+
+        if( m_poLyrTable->HasDeletedFeaturesListed() )
+        {
+            poBatch->SetFieldInteger(m_poFeatureDefn->GetFieldCount() - 1,
+                                     m_poLyrTable->IsCurRowDeleted());
+        }
+
+        if( m_eSpatialIndexState == SPI_IN_BUILDING &&
+            m_iCurFeat == m_poLyrTable->GetTotalRecordCount() )
+        {
+            CPLDebug("OpenFileGDB", "SPI_COMPLETED");
+            m_eSpatialIndexState = SPI_COMPLETED;
+        }
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /***********************************************************************/
 /*                          GetFeature()                               */
 /***********************************************************************/
@@ -1647,7 +1839,7 @@ OGRFeature* OGROpenFileGDBLayer::GetFeature( GIntBig nFeatureId )
 
 OGRErr OGROpenFileGDBLayer::SetNextByIndex( GIntBig nIndex )
 {
-    if( m_poIterator != NULL )
+    if( m_poIterator != NULL || m_bFilteredFeaturesAreCandidates )
         return OGRLayer::SetNextByIndex(nIndex);
 
     if( !BuildLayerDefinition() )
@@ -1712,10 +1904,15 @@ GIntBig OGROpenFileGDBLayer::GetFeatureCount( int bForce )
     {
         return m_poLyrTable->GetValidRecordCount();
     }
-    else if( m_nFilteredFeatureCount >= 0 && m_poAttrQuery == NULL )
+    else if( m_nFilteredFeatureCount >= 0 && m_poAttrQuery == NULL &&
+             !m_bFilteredFeaturesAreCandidates )
     {
         return m_nFilteredFeatureCount;
     }
+    else if( m_bFilteredFeaturesAreCandidates )
+    {
+        return OGRLayer::GetFeatureCount(bForce);
+    }
 
     /* Only geometry filter ? */
     if( m_poAttrQuery == NULL && m_bFilterIsEnvelope )
@@ -1823,7 +2020,11 @@ int OGROpenFileGDBLayer::TestCapability( const char * pszCap )
     {
         return ( m_poLyrTable->GetValidRecordCount() ==
                  m_poLyrTable->GetTotalRecordCount() &&
-                 m_poIterator == NULL );
+                 m_poIterator == NULL && !m_bFilteredFeaturesAreCandidates );
+    }
+    else if( EQUAL(pszCap,OLCFastSpatialFilter) )
+    {
+        return m_eSpatialIndexState == SPI_COMPLETED || HasSpatialIndex();
     }
     else if( EQUAL(pszCap,OLCRandomRead) )
     {
@@ -34,7 +34,9 @@
 #define ENABLE_NODE_LOOKUP_BY_HASHING 1
 
 #include "ogrsf_frmts.h"
+#include "cpl_multiproc.h"
 #include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
 
 #include <set>
 #if HAVE_CXX11
@@ -276,6 +278,86 @@ typedef struct
     EMULATED_BOOL       bAttrFilterAlreadyEvaluated : 1;
 } WayFeaturePair;
 
+class OGROSMDataSource;
+
+/* Error or debug message emitted by a worker thread, to be re-emitted */
+/* by the calling thread */
+struct OSMDeferredError
+{
+    CPLErr              eErr;
+    CPLErrorNum         nErrorNum;
+    CPLString           osMsg;
+};
+
+/* Node lookup of the panReqIds[iFirst:iLast] range */
+struct OSMNodesLookupJob
+{
+    OGROSMDataSource   *poDS;
+    unsigned int        iFirst;
+    unsigned int        iLast;
+    unsigned int        nFound; /* found nodes, compacted at iFirst */
+    std::vector<OSMDeferredError> aoErrors;
+};
+
+/* Coordinate resolution of the pasWayFeaturePairs[iFirst:iLast] ways */
+struct OSMWaysJob
+{
+    OGROSMDataSource   *poDS;
+    int                 iFirst;
+    int                 iLast;
+    std::vector<LonLat> asLonLatCache;
+    std::vector<unsigned int> anFound;  /* resolved nodes, per way */
+    std::vector<GByte>  abyCompressedWays;
+    std::vector<size_t> anCompressedWayOffsets; /* iLast - iFirst + 1 values */
+};
+
+/* Multipolygon relation whose ways have been fetched, and whose */
+/* geometry remains to be built */
+struct OSMMultiPolygonJob
+{
+    OGROSMDataSource   *poDS;
+    GIntBig             nRelationID;
+    OGRFeature         *poFeature;
+    bool                bAttrFilterAlreadyEvaluated;
+    std::vector<GIntBig> anWayIDs;  /* way members, in relation order */
+    std::vector<bool>   abIsOuter;
+    bool                bWaysFetched;
+    bool                bMissingWays;
+    std::map< GIntBig, std::pair<int,void*> > aoMapWays; /* compressed ways */
+    OGRGeometry        *poGeom;
+    std::vector<GIntBig> anStandalonePolygonsToDelete;
+    std::vector<OSMDeferredError> aoErrors;
+
+    OSMMultiPolygonJob() : poDS(NULL), nRelationID(0), poFeature(NULL),
+                           bAttrFilterAlreadyEvaluated(false),
+                           bWaysFetched(false), bMissingWays(false),
+                           poGeom(NULL) {}
+    ~OSMMultiPolygonJob()
+    {
+        delete poFeature;
+        delete poGeom;
+        ClearWays();
+    }
+    void ClearWays()
+    {
+        std::map< GIntBig, std::pair<int,void*> >::iterator oIter;
+        for( oIter = aoMapWays.begin(); oIter != aoMapWays.end(); ++oIter )
+            CPLFree(oIter->second.second);
+        aoMapWays.clear();
+    }
+};
+
+/* Read-only handles on the temporary nodes file and database, used by */
+/* one worker thread at a time */
+struct OSMTmpFilesReader
+{
+    VSILFILE           *fpNodes;
+    sqlite3            *hDB;
+    sqlite3_stmt      **pahSelectWayStmt; /* prepared on first use */
+
+    OSMTmpFilesReader() : fpNodes(NULL), hDB(NULL), pahSelectWayStmt(NULL) {}
+};
+
 #ifdef ENABLE_NODE_LOOKUP_BY_HASHING
 typedef struct
 {
@@ -410,6 +492,13 @@ class OGROSMDataSource : public OGRDataSource
 
     bool                bNeedsToSaveWayInfo;
 
+    int                 nNumThreads;
+    CPLWorkerThreadPool *poWTP;
+    std::vector<OSMTmpFilesReader*> apoReaders; /* one per worker thread */
+    std::vector<OSMTmpFilesReader*> apoFreeReaders;
+    CPLMutex           *hReadersMutex;
+    std::vector<OSMMultiPolygonJob*> apoPendingMultiPolygons;
+
     static const GIntBig FILESIZE_NOT_INIT = -2;
     static const GIntBig FILESIZE_INVALID = -1;
     GIntBig             m_nFileSize;
@@ -430,6 +519,14 @@ class OGROSMDataSource : public OGRDataSource
     bool                CreatePreparedStatements();
     void                CloseDB();
 
+    bool                OpenNodesFileReaders();
+    void                CloseNodesFileReaders();
+    bool                OpenDBReaders(const char* pszFilename,
+                                      const char* pszVFSName);
+    void                CloseDBReaders();
+    OSMTmpFilesReader*  AcquireReader();
+    void                ReleaseReader(OSMTmpFilesReader* psReader);
+
     bool                IndexPoint( OSMNode* psNode );
     bool                IndexPointSQLite( OSMNode* psNode );
     bool                FlushCurrentSector();
@@ -437,31 +534,49 @@ class OGROSMDataSource : public OGRDataSource
     bool                FlushCurrentSectorNonCompressedCase();
     bool                IndexPointCustom( OSMNode* psNode );
 
-    void                IndexWay(GIntBig nWayID, bool bIsArea,
-                                 unsigned int nTags, IndexedKVP* pasTags,
-                                 LonLat* pasLonLatPairs, int nPairs,
-                                 OSMInfo* psInfo);
+    void                IndexWay(GIntBig nWayID,
+                                 const GByte* pabyCompressedWay,
+                                 int nCompressedWaySize);
 
     bool                StartTransactionCacheDB();
     bool                CommitTransactionCacheDB();
 
     int                 FindNode(GIntBig nID);
     void                ProcessWaysBatch();
+    void                ResolveWays(OSMWaysJob* psJob);
+    static void         ResolveWaysFunc(void* pData);
 
     void                ProcessPolygonsStandalone();
 
     void                LookupNodes();
     void                LookupNodesSQLite();
     void                LookupNodesCustom();
-    void                LookupNodesCustomCompressedCase();
-    void                LookupNodesCustomNonCompressedCase();
-
-    unsigned int        LookupWays( std::map< GIntBig, std::pair<int,void*> >& aoMapWays,
-                                    OSMRelation* psRelation );
-
-    OGRGeometry*        BuildMultiPolygon(OSMRelation* psRelation,
-                                          unsigned int* pnTags,
-                                          OSMTag* pasTags);
+    unsigned int        LookupNodesCustomCompressedCase(VSILFILE* fp,
+                                                        unsigned int iFirst,
+                                                        unsigned int iLast);
+    unsigned int        LookupNodesCustomNonCompressedCase(VSILFILE* fp,
+                                                           unsigned int iFirst,
+                                                           unsigned int iLast);
+    static void         LookupNodesCustomFunc(void* pData);
+    static size_t       ReadNodesFile(VSILFILE* fp, GIntBig nOffset,
+                                      void* pBuffer, size_t nSize);
+
+    void                RunJobs(CPLThreadFunc pfnFunc,
+                                std::vector<void*>& apJobs);
+
+    static unsigned int LookupWays( sqlite3_stmt** pahStmt,
+                                    std::map< GIntBig, std::pair<int,void*> >& aoMapWays,
+                                    const std::vector<GIntBig>& anWayIDs );
+
+    OSMMultiPolygonJob* PrepareMultiPolygon(OSMRelation* psRelation,
+                                            unsigned int* pnTags,
+                                            OSMTag* pasTags);
+    void                FetchMultiPolygonWays(OSMMultiPolygonJob* psJob,
+                                              sqlite3_stmt** pahStmt);
+    void                BuildMultiPolygon(OSMMultiPolygonJob* psJob);
+    static void         BuildMultiPolygonFunc(void* pData);
+    void                ProcessMultiPolygonsBatch();
+    void                ClearPendingMultiPolygons();
     OGRGeometry*        BuildGeometryCollection(OSMRelation* psRelation, int bMultiLineString);
 
     bool                TransferToDiskIfNecesserary();
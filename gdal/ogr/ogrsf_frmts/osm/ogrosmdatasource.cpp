@@ -124,6 +124,14 @@ static const int MAX_NON_REDUNDANT_VALUES = MAX_DELAYED_FEATURES * 10;
 // Max number of features that are accumulated in panUnsortedReqIds
 static const int MAX_ACCUMULATED_NODES = 1000000;
 
+// Minimum amount of work given to each worker thread.
+static const unsigned int MIN_NODES_PER_LOOKUP_JOB = 4096;
+static const int MIN_WAYS_PER_JOB = 256;
+
+// Multipolygon relations are accumulated until that limit is reached, so
+// that their ways can be fetched and their geometries built in parallel.
+static const int MAX_PENDING_MULTIPOLYGONS = 1000;
+
 #ifdef ENABLE_NODE_LOOKUP_BY_HASHING
 // Size of panHashedIndexes array. Must be in the list at
 // http://planetmath.org/goodhashtableprimes , and greater than
@@ -276,6 +284,9 @@ OGROSMDataSource::OGROSMDataSource() :
     nOffInBucketReducedOld(-1),
     pabySector(NULL),
     bNeedsToSaveWayInfo(false),
+    nNumThreads(1),
+    poWTP(NULL),
+    hReadersMutex(NULL),
     m_nFileSize(FILESIZE_NOT_INIT)
 {}
 
@@ -298,6 +309,10 @@ OGROSMDataSource::~OGROSMDataSource()
                   OSM_GetBytesRead(psParser) );
     OSM_Close(psParser);
 
+    ClearPendingMultiPolygons();
+    delete poWTP;
+    CloseNodesFileReaders();
+
     CPLFree(pasLonLatCache);
     CPLFree(pabyWayBuffer);
 
@@ -368,6 +383,11 @@ OGROSMDataSource::~OGROSMDataSource()
             VSIUnlink(osNodesFilename);
     }
 
+    for( size_t i = 0; i < apoReaders.size(); i++ )
+        delete apoReaders[i];
+    if( hReadersMutex != NULL )
+        CPLDestroyMutex(hReadersMutex);
+
     CPLFree(pabySector);
     std::map<int, Bucket>::iterator oIter = oMapBuckets.begin();
     for( ; oIter != oMapBuckets.end(); ++oIter )
@@ -387,6 +407,62 @@ OGROSMDataSource::~OGROSMDataSource()
     }
 }
 
+/************************************************************************/
+/*                       OGROSMFinalizeStatements()                     */
+/************************************************************************/
+
+static void OGROSMFinalizeStatements( sqlite3_stmt** pahStmt )
+{
+    if( pahStmt == NULL )
+        return;
+    for( int i = 0; i < LIMIT_IDS_PER_REQUEST; i++ )
+    {
+        if( pahStmt[i] != NULL )
+            sqlite3_finalize( pahStmt[i] );
+    }
+    CPLFree(pahStmt);
+}
+
+/************************************************************************/
+/*                     OGROSMPrepareSelectWayStmts()                    */
+/*                                                                      */
+/*      Prepare the statements that select 1 to LIMIT_IDS_PER_REQUEST   */
+/*      ways by id.                                                     */
+/************************************************************************/
+
+static sqlite3_stmt** OGROSMPrepareSelectWayStmts( sqlite3* hDBIn )
+{
+    sqlite3_stmt** pahStmt = static_cast<sqlite3_stmt**>(
+        CPLCalloc(sizeof(sqlite3_stmt*), LIMIT_IDS_PER_REQUEST) );
+
+    char szTmp[LIMIT_IDS_PER_REQUEST*2 + 128];
+    strcpy(szTmp, "SELECT id, data FROM ways WHERE id IN (");
+    int nLen = static_cast<int>(strlen(szTmp));
+    for(int i=0;i<LIMIT_IDS_PER_REQUEST;i++)
+    {
+        if(i == 0)
+        {
+            strcpy(szTmp + nLen, "?)");
+            nLen += 2;
+        }
+        else
+        {
+            strcpy(szTmp + nLen -1, ",?)");
+            nLen += 2;
+        }
+        const int rc =
+            sqlite3_prepare_v2( hDBIn, szTmp, -1, &pahStmt[i], NULL );
+        if( rc != SQLITE_OK )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                    "sqlite3_prepare_v2() failed :  %s", sqlite3_errmsg(hDBIn) );
+            OGROSMFinalizeStatements(pahStmt);
+            return NULL;
+        }
+    }
+    return pahStmt;
+}
+
 /************************************************************************/
 /*                             CloseDB()                               */
 /************************************************************************/
@@ -413,33 +489,134 @@ void OGROSMDataSource::CloseDB()
         sqlite3_finalize( hSelectPolygonsStandaloneStmt );
     hSelectPolygonsStandaloneStmt = NULL;
 
-    if( pahSelectNodeStmt != NULL )
+    OGROSMFinalizeStatements(pahSelectNodeStmt);
+    pahSelectNodeStmt = NULL;
+
+    OGROSMFinalizeStatements(pahSelectWayStmt);
+    pahSelectWayStmt = NULL;
+
+    if( bInTransaction )
+        CommitTransactionCacheDB();
+
+    CloseDBReaders();
+
+    sqlite3_close(hDB);
+    hDB = NULL;
+}
+
+/************************************************************************/
+/*                        OpenNodesFileReaders()                        */
+/*                                                                      */
+/*      Open one read-only handle on the nodes file per worker thread,  */
+/*      so that they can seek and read independently. Must be called    */
+/*      before the file is unlinked.                                    */
+/************************************************************************/
+
+bool OGROSMDataSource::OpenNodesFileReaders()
+{
+    CloseNodesFileReaders();
+    for( size_t i = 0; i < apoReaders.size(); i++ )
     {
-        for( int i = 0; i < LIMIT_IDS_PER_REQUEST; i++ )
+        apoReaders[i]->fpNodes = VSIFOpenL(osNodesFilename, "rb");
+        if( apoReaders[i]->fpNodes == NULL )
         {
-            if( pahSelectNodeStmt[i] != NULL )
-                sqlite3_finalize( pahSelectNodeStmt[i] );
+            CPLError(CE_Failure, CPLE_FileIO, "Cannot open %s",
+                     osNodesFilename.c_str());
+            return false;
         }
-        CPLFree(pahSelectNodeStmt);
-        pahSelectNodeStmt = NULL;
     }
+    return true;
+}
+
+/************************************************************************/
+/*                        CloseNodesFileReaders()                       */
+/************************************************************************/
+
+void OGROSMDataSource::CloseNodesFileReaders()
+{
+    for( size_t i = 0; i < apoReaders.size(); i++ )
+    {
+        if( apoReaders[i]->fpNodes != NULL )
+            VSIFCloseL(apoReaders[i]->fpNodes);
+        apoReaders[i]->fpNodes = NULL;
+    }
+}
 
-    if( pahSelectWayStmt != NULL )
+/************************************************************************/
+/*                            OpenDBReaders()                           */
+/*                                                                      */
+/*      Open one read-only connection on the temporary database per     */
+/*      worker thread. Must be called before the file is unlinked.      */
+/************************************************************************/
+
+bool OGROSMDataSource::OpenDBReaders( const char* pszFilename,
+                                      const char* pszVFSName )
+{
+    CloseDBReaders();
+    for( size_t i = 0; i < apoReaders.size(); i++ )
     {
-        for( int i = 0; i < LIMIT_IDS_PER_REQUEST; i++ )
+        const int rc =
+            sqlite3_open_v2( pszFilename, &(apoReaders[i]->hDB),
+                             SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX,
+                             pszVFSName );
+        if( rc != SQLITE_OK )
         {
-            if( pahSelectWayStmt[i] != NULL )
-                sqlite3_finalize( pahSelectWayStmt[i] );
+            CPLError( CE_Failure, CPLE_OpenFailed,
+                      "sqlite3_open(%s) failed: %s",
+                      pszFilename, sqlite3_errmsg( apoReaders[i]->hDB ) );
+            return false;
         }
-        CPLFree(pahSelectWayStmt);
-        pahSelectWayStmt = NULL;
     }
+    return true;
+}
 
-    if( bInTransaction )
-        CommitTransactionCacheDB();
+/************************************************************************/
+/*                            CloseDBReaders()                          */
+/************************************************************************/
 
-    sqlite3_close(hDB);
-    hDB = NULL;
+void OGROSMDataSource::CloseDBReaders()
+{
+    for( size_t i = 0; i < apoReaders.size(); i++ )
+    {
+        OGROSMFinalizeStatements(apoReaders[i]->pahSelectWayStmt);
+        apoReaders[i]->pahSelectWayStmt = NULL;
+        if( apoReaders[i]->hDB != NULL )
+            sqlite3_close(apoReaders[i]->hDB);
+        apoReaders[i]->hDB = NULL;
+    }
+}
+
+/************************************************************************/
+/*                            AcquireReader()                           */
+/*                                                                      */
+/*      Return the reader of the calling worker thread, or NULL if      */
+/*      there is a single thread, in which case fpNodes and hDB are     */
+/*      used directly.                                                  */
+/************************************************************************/
+
+OSMTmpFilesReader* OGROSMDataSource::AcquireReader()
+{
+    CPLMutexHolderD(&hReadersMutex);
+    if( apoFreeReaders.empty() )
+    {
+        CPLAssert( apoReaders.empty() );
+        return NULL;
+    }
+    OSMTmpFilesReader* psReader = apoFreeReaders.back();
+    apoFreeReaders.pop_back();
+    return psReader;
+}
+
+/************************************************************************/
+/*                            ReleaseReader()                           */
+/************************************************************************/
+
+void OGROSMDataSource::ReleaseReader( OSMTmpFilesReader* psReader )
+{
+    if( psReader == NULL )
+        return;
+    CPLMutexHolderD(&hReadersMutex);
+    apoFreeReaders.push_back(psReader);
 }
 
 /************************************************************************/
@@ -780,6 +957,9 @@ bool OGROSMDataSource::IndexPointCustom(OSMNode* psNode)
 
 void OGROSMDataSource::NotifyNodes( unsigned int nNodes, OSMNode* pasNodes )
 {
+    if( !apoPendingMultiPolygons.empty() )
+        ProcessMultiPolygonsBatch();
+
     const OGREnvelope* psEnvelope =
         papoLayers[IDX_LYR_POINTS]->GetSpatialFilterEnvelope();
 
@@ -850,6 +1030,63 @@ static void OGROSMNotifyNodes ( unsigned int nNodes,
     static_cast<OGROSMDataSource *>(user_data)->NotifyNodes(nNodes, pasNodes);
 }
 
+/************************************************************************/
+/*                        OGROSMDeferErrorHandler()                     */
+/*                                                                      */
+/*      Error handler of worker threads, that records the messages so  */
+/*      that they can be emitted by the calling thread.                 */
+/************************************************************************/
+
+static void CPL_STDCALL OGROSMDeferErrorHandler( CPLErr eErr,
+                                                 CPLErrorNum nErrorNum,
+                                                 const char* pszMsg )
+{
+    std::vector<OSMDeferredError>* paoErrors =
+        static_cast<std::vector<OSMDeferredError>*>(
+            CPLGetErrorHandlerUserData());
+    OSMDeferredError sError;
+    sError.eErr = eErr;
+    sError.nErrorNum = nErrorNum;
+    sError.osMsg = pszMsg;
+    paoErrors->push_back(sError);
+}
+
+/************************************************************************/
+/*                       OGROSMEmitDeferredErrors()                     */
+/************************************************************************/
+
+static void OGROSMEmitDeferredErrors(
+                            const std::vector<OSMDeferredError>& aoErrors )
+{
+    for( size_t i = 0; i < aoErrors.size(); i++ )
+    {
+        CPLError( aoErrors[i].eErr, aoErrors[i].nErrorNum, "%s",
+                  aoErrors[i].osMsg.c_str() );
+    }
+}
+
+/************************************************************************/
+/*                               RunJobs()                              */
+/*                                                                      */
+/*      Run jobs in the worker threads if there are several of them,    */
+/*      or in the calling thread otherwise.                             */
+/************************************************************************/
+
+void OGROSMDataSource::RunJobs( CPLThreadFunc pfnFunc,
+                                std::vector<void*>& apJobs )
+{
+    if( poWTP != NULL && apJobs.size() > 1 )
+    {
+        poWTP->SubmitJobs(pfnFunc, apJobs);
+        poWTP->WaitCompletion();
+    }
+    else
+    {
+        for( size_t i = 0; i < apJobs.size(); i++ )
+            pfnFunc(apJobs[i]);
+    }
+}
+
 /************************************************************************/
 /*                            LookupNodes()                             */
 /************************************************************************/
@@ -1128,30 +1365,119 @@ void OGROSMDataSource::LookupNodesCustom( )
         pasLonLatArray[i].nLat = 0;
     }
 #else
-    if( bCompressNodes )
-        LookupNodesCustomCompressedCase();
-    else
-        LookupNodesCustomNonCompressedCase();
+    // Split the sorted ids into ranges that are looked up in parallel.
+    // Sectors shared by two consecutive ranges are just read twice.
+    unsigned int nJobs = 1;
+    if( poWTP != NULL )
+    {
+        nJobs = std::min(static_cast<unsigned int>(nNumThreads) * 4,
+                         nReqIds / MIN_NODES_PER_LOOKUP_JOB);
+        nJobs = std::max(1U, nJobs);
+    }
+    std::vector<OSMNodesLookupJob> asJobs(nJobs);
+    std::vector<void*> apJobs;
+    for( unsigned int i = 0; i < nJobs; i++ )
+    {
+        asJobs[i].poDS = this;
+        asJobs[i].iFirst = static_cast<unsigned int>(
+            static_cast<GUIntBig>(nReqIds) * i / nJobs);
+        asJobs[i].iLast = static_cast<unsigned int>(
+            static_cast<GUIntBig>(nReqIds) * (i + 1) / nJobs);
+        asJobs[i].nFound = 0;
+        apJobs.push_back(&asJobs[i]);
+    }
+
+    // The readers of the worker threads must see what has been written
+    // through fpNodes, and not stale buffered data.
+    if( !apoReaders.empty() )
+    {
+        VSIFFlushL(fpNodes);
+        for( size_t i = 0; i < apoReaders.size(); i++ )
+            VSIFSeekL(apoReaders[i]->fpNodes, 0, SEEK_END);
+    }
+
+    RunJobs(LookupNodesCustomFunc, apJobs);
+
+    // Gather the found nodes of all ranges at the start of the arrays.
+    j = 0;
+    for( unsigned int i = 0; i < nJobs; i++ )
+    {
+        OGROSMEmitDeferredErrors(asJobs[i].aoErrors);
+        if( j != asJobs[i].iFirst )
+        {
+            memmove(panReqIds + j, panReqIds + asJobs[i].iFirst,
+                    asJobs[i].nFound * sizeof(GIntBig));
+            memmove(pasLonLatArray + j, pasLonLatArray + asJobs[i].iFirst,
+                    asJobs[i].nFound * sizeof(LonLat));
+        }
+        j += asJobs[i].nFound;
+    }
+    nReqIds = j;
 #endif
 }
 
+/************************************************************************/
+/*                        LookupNodesCustomFunc()                       */
+/************************************************************************/
+
+void OGROSMDataSource::LookupNodesCustomFunc( void* pData )
+{
+    OSMNodesLookupJob* psJob = static_cast<OSMNodesLookupJob*>(pData);
+    OGROSMDataSource* poDS = psJob->poDS;
+
+    CPLPushErrorHandlerEx(OGROSMDeferErrorHandler, &psJob->aoErrors);
+    OSMTmpFilesReader* psReader = poDS->AcquireReader();
+    VSILFILE* fp = psReader ? psReader->fpNodes : poDS->fpNodes;
+    if( poDS->bCompressNodes )
+        psJob->nFound = poDS->LookupNodesCustomCompressedCase(fp,
+                                                              psJob->iFirst,
+                                                              psJob->iLast);
+    else
+        psJob->nFound = poDS->LookupNodesCustomNonCompressedCase(fp,
+                                                                 psJob->iFirst,
+                                                                 psJob->iLast);
+    poDS->ReleaseReader(psReader);
+    CPLPopErrorHandler();
+}
+
+/************************************************************************/
+/*                            ReadNodesFile()                           */
+/*                                                                      */
+/*      Positioned read in the nodes file, through fpNodes or the      */
+/*      reader of the calling worker thread.                            */
+/************************************************************************/
+
+size_t OGROSMDataSource::ReadNodesFile( VSILFILE* fp, GIntBig nOffset,
+                                        void* pBuffer, size_t nSize )
+{
+    VSIFSeekL(fp, static_cast<vsi_l_offset>(nOffset), SEEK_SET);
+    return VSIFReadL(pBuffer, 1, nSize, fp);
+}
+
 /************************************************************************/
 /*                      LookupNodesCustomCompressedCase()               */
+/*                                                                      */
+/*      Look up the nodes of panReqIds[iFirst:iLast]. The found ones    */
+/*      are compacted at iFirst, and their count is returned.           */
 /************************************************************************/
 
-void OGROSMDataSource::LookupNodesCustomCompressedCase()
+unsigned int
+OGROSMDataSource::LookupNodesCustomCompressedCase( VSILFILE* fp,
+                                                   unsigned int iFirst,
+                                                   unsigned int iLast )
 {
     static const int SECURITY_MARGIN = 8 + 8 + 2 * NODE_PER_SECTOR;
     GByte abyRawSector[SECTOR_SIZE + SECURITY_MARGIN];
     memset(abyRawSector + SECTOR_SIZE, 0, SECURITY_MARGIN);
+    GByte abySector[SECTOR_SIZE];
 
     int l_nBucketOld = -1;
     int l_nOffInBucketReducedOld = -1;
     int k = 0;
     int nOffFromBucketStart = 0;
 
-    unsigned int j = 0;  // Used after for.
-    for( unsigned int i = 0; i < nReqIds; i++ )
+    unsigned int j = iFirst;  // Used after for.
+    for( unsigned int i = iFirst; i < iLast; i++ )
     {
         const GIntBig id = panReqIds[i];
         const int nBucket = static_cast<int>(id / NODE_PER_BUCKET);
@@ -1198,12 +1524,12 @@ void OGROSMDataSource::LookupNodesCustomCompressedCase()
                         COMPRESS_SIZE_FROM_BYTE(psBucket->u.panSectorSize[k]);
             }
 
-            VSIFSeekL(fpNodes, psBucket->nOff + nOffFromBucketStart, SEEK_SET);
+            const GIntBig nOffset = psBucket->nOff + nOffFromBucketStart;
             if( nSectorSize == SECTOR_SIZE )
             {
-                if( VSIFReadL(pabySector, 1,
-                              static_cast<size_t>(SECTOR_SIZE),
-                              fpNodes) != static_cast<size_t>(SECTOR_SIZE) )
+                if( ReadNodesFile(fp, nOffset, abySector,
+                                  static_cast<size_t>(SECTOR_SIZE)) !=
+                                        static_cast<size_t>(SECTOR_SIZE) )
                 {
                     CPLError(CE_Failure,  CPLE_AppDefined,
                             "Cannot read node " CPL_FRMT_GIB, id);
@@ -1213,8 +1539,9 @@ void OGROSMDataSource::LookupNodesCustomCompressedCase()
             }
             else
             {
-                if( static_cast<int>(VSIFReadL(abyRawSector, 1, nSectorSize,
-                                               fpNodes)) != nSectorSize )
+                if( static_cast<int>(ReadNodesFile(fp, nOffset, abyRawSector,
+                                                   nSectorSize)) !=
+                                                                nSectorSize )
                 {
                     CPLError(CE_Failure,  CPLE_AppDefined,
                             "Cannot read sector for node " CPL_FRMT_GIB, id);
@@ -1223,7 +1550,7 @@ void OGROSMDataSource::LookupNodesCustomCompressedCase()
                 }
                 abyRawSector[nSectorSize] = 0;
 
-                if( !DecompressSector(abyRawSector, nSectorSize, pabySector) )
+                if( !DecompressSector(abyRawSector, nSectorSize, abySector) )
                 {
                     CPLError( CE_Failure,  CPLE_AppDefined,
                               "Error while uncompressing sector for node "
@@ -1239,22 +1566,28 @@ void OGROSMDataSource::LookupNodesCustomCompressedCase()
 
         panReqIds[j] = id;
         memcpy(pasLonLatArray + j,
-               pabySector + nOffInBucketReducedRemainer * sizeof(LonLat),
+               abySector + nOffInBucketReducedRemainer * sizeof(LonLat),
                sizeof(LonLat));
 
         if( pasLonLatArray[j].nLon || pasLonLatArray[j].nLat )
             j++;
     }
-    nReqIds = j;
+    return j - iFirst;
 }
 
 /************************************************************************/
 /*                    LookupNodesCustomNonCompressedCase()              */
+/*                                                                      */
+/*      Same as LookupNodesCustomCompressedCase() for uncompressed      */
+/*      sectors.                                                        */
 /************************************************************************/
 
-void OGROSMDataSource::LookupNodesCustomNonCompressedCase()
+unsigned int
+OGROSMDataSource::LookupNodesCustomNonCompressedCase( VSILFILE* fp,
+                                                      unsigned int iFirst,
+                                                      unsigned int iLast )
 {
-    unsigned int j = 0;  // Used after for.
+    unsigned int j = iFirst;  // Used after for.
 
     int l_nBucketOld = -1;
     const Bucket* psBucket = NULL;
@@ -1268,7 +1601,7 @@ void OGROSMDataSource::LookupNodesCustomNonCompressedCase()
     size_t nValidBytes = 0;
     int k = 0;
     int nSectorBase = 0;
-    for( unsigned int i = 0; i < nReqIds; i++ )
+    for( unsigned int i = iFirst; i < iLast; i++ )
     {
         const GIntBig id = panReqIds[i];
         const int nBucket = static_cast<int>(id / NODE_PER_BUCKET);
@@ -1320,9 +1653,8 @@ void OGROSMDataSource::LookupNodesCustomNonCompressedCase()
             // Align on 4096 boundary to be glibc caching friendly
             const GIntBig nAlignedNewPos = nNewOffset &
                         ~(static_cast<GIntBig>(knDISK_SECTOR_SIZE)-1);
-            VSIFSeekL(fpNodes, nAlignedNewPos, SEEK_SET);
-            nValidBytes =
-                    VSIFReadL(abyDiskSector, 1, knDISK_SECTOR_SIZE, fpNodes);
+            nValidBytes = ReadNodesFile(fp, nAlignedNewPos, abyDiskSector,
+                                        knDISK_SECTOR_SIZE);
             nOldOffset = nAlignedNewPos;
         }
 
@@ -1344,7 +1676,7 @@ void OGROSMDataSource::LookupNodesCustomNonCompressedCase()
         if( pasLonLatArray[j].nLon || pasLonLatArray[j].nLat )
             j++;
     }
-    nReqIds = j;
+    return j - iFirst;
 }
 
 /************************************************************************/
@@ -1599,20 +1931,17 @@ int OGROSMDataSource::UncompressWay( int nBytes, GByte* pabyCompressedWay,
 /*                              IndexWay()                              */
 /************************************************************************/
 
-void OGROSMDataSource::IndexWay(GIntBig nWayID, bool bIsArea,
-                                unsigned int nTags, IndexedKVP* pasTags,
-                                LonLat* pasLonLatPairs, int nPairs,
-                                OSMInfo* psInfo)
+void OGROSMDataSource::IndexWay(GIntBig nWayID,
+                                const GByte* pabyCompressedWay,
+                                int nCompressedWaySize)
 {
     if( !bIndexWays )
         return;
 
     sqlite3_bind_int64( hInsertWayStmt, 1, nWayID );
 
-    int nBufferSize = CompressWay (bIsArea, nTags, pasTags, nPairs, pasLonLatPairs, psInfo, pabyWayBuffer);
-    CPLAssert(nBufferSize <= WAY_BUFFER_SIZE);
-    sqlite3_bind_blob( hInsertWayStmt, 2, pabyWayBuffer,
-                       nBufferSize, SQLITE_STATIC );
+    sqlite3_bind_blob( hInsertWayStmt, 2, pabyCompressedWay,
+                       nCompressedWaySize, SQLITE_STATIC );
 
     int rc = sqlite3_step( hInsertWayStmt );
     sqlite3_reset( hInsertWayStmt );
@@ -1648,17 +1977,22 @@ int OGROSMDataSource::FindNode(GIntBig nID)
 }
 
 /************************************************************************/
-/*                         ProcessWaysBatch()                           */
+/*                            ResolveWays()                             */
+/*                                                                      */
+/*      Find the coordinates of the nodes of a range of ways, and       */
+/*      build their compressed form and the geometry of their feature.  */
+/*      Can be called from several threads once LookupNodes() has been  */
+/*      run.                                                            */
 /************************************************************************/
 
-void OGROSMDataSource::ProcessWaysBatch()
+void OGROSMDataSource::ResolveWays( OSMWaysJob* psJob )
 {
-    if( nWayFeaturePairs == 0 ) return;
-
-    //printf("nodes = %d, features = %d\n", nUnsortedReqIds, nWayFeaturePairs);
-    LookupNodes();
+    LonLat* pasCoords = &psJob->asLonLatCache[0];
+    const bool bMultiPolygonsInterested =
+        papoLayers[IDX_LYR_MULTIPOLYGONS]->IsUserInterested();
 
-    for( int iPair = 0; iPair < nWayFeaturePairs; iPair ++)
+    psJob->anCompressedWayOffsets.push_back(0);
+    for( int iPair = psJob->iFirst; iPair < psJob->iLast; iPair ++)
     {
         WayFeaturePair* psWayFeaturePairs = &pasWayFeaturePairs[iPair];
 
@@ -1698,8 +2032,8 @@ void OGROSMDataSource::ProcessWaysBatch()
 
                 if( nIdx >= 0 )
                 {
-                    pasLonLatCache[nFound].nLon = pasLonLatArray[nIdx].nLon;
-                    pasLonLatCache[nFound].nLat = pasLonLatArray[nIdx].nLat;
+                    pasCoords[nFound].nLon = pasLonLatArray[nIdx].nLon;
+                    pasCoords[nFound].nLat = pasLonLatArray[nIdx].nLat;
                     nFound ++;
                 }
             }
@@ -1723,8 +2057,8 @@ void OGROSMDataSource::ProcessWaysBatch()
                     nIdx = FindNode( psWayFeaturePairs->panNodeRefs[i] );
                 if( nIdx >= 0 )
                 {
-                    pasLonLatCache[nFound].nLon = pasLonLatArray[nIdx].nLon;
-                    pasLonLatCache[nFound].nLat = pasLonLatArray[nIdx].nLat;
+                    pasCoords[nFound].nLon = pasLonLatArray[nIdx].nLon;
+                    pasCoords[nFound].nLat = pasLonLatArray[nIdx].nLat;
                     nFound ++;
                 }
             }
@@ -1732,33 +2066,47 @@ void OGROSMDataSource::ProcessWaysBatch()
 
         if( nFound > 0 && bIsArea )
         {
-            pasLonLatCache[nFound].nLon = pasLonLatCache[0].nLon;
-            pasLonLatCache[nFound].nLat = pasLonLatCache[0].nLat;
+            pasCoords[nFound].nLon = pasCoords[0].nLon;
+            pasCoords[nFound].nLat = pasCoords[0].nLat;
             nFound ++;
         }
 
+        psJob->anFound.push_back(nFound);
         if( nFound < 2 )
         {
-            CPLDebug("OSM", "Way " CPL_FRMT_GIB " with %d nodes that could be found. Discarding it",
-                    psWayFeaturePairs->nWayID, nFound);
-            delete psWayFeaturePairs->poFeature;
-            psWayFeaturePairs->poFeature = NULL;
-            psWayFeaturePairs->bIsArea = false;
+            psJob->anCompressedWayOffsets.push_back(
+                psJob->abyCompressedWays.size());
             continue;
         }
 
-        if( bIsArea && papoLayers[IDX_LYR_MULTIPOLYGONS]->IsUserInterested() )
+        if( bIndexWays )
         {
-            IndexWay(psWayFeaturePairs->nWayID,
-                     bIsArea != 0,
-                     psWayFeaturePairs->nTags,
-                     psWayFeaturePairs->pasTags,
-                     pasLonLatCache, (int)nFound,
-                     &psWayFeaturePairs->sInfo);
+            const size_t nOffset = psJob->abyCompressedWays.size();
+            psJob->abyCompressedWays.resize(nOffset + WAY_BUFFER_SIZE);
+            GByte* pabyCompressedWay = &psJob->abyCompressedWays[nOffset];
+            int nBufferSize = 0;
+            if( bIsArea && bMultiPolygonsInterested )
+            {
+                nBufferSize = CompressWay(bIsArea != 0,
+                                          psWayFeaturePairs->nTags,
+                                          psWayFeaturePairs->pasTags,
+                                          static_cast<int>(nFound),
+                                          pasCoords,
+                                          &psWayFeaturePairs->sInfo,
+                                          pabyCompressedWay);
+            }
+            else
+            {
+                nBufferSize = CompressWay(bIsArea != 0, 0, NULL,
+                                          static_cast<int>(nFound),
+                                          pasCoords, NULL,
+                                          pabyCompressedWay);
+            }
+            CPLAssert(nBufferSize <= WAY_BUFFER_SIZE);
+            psJob->abyCompressedWays.resize(nOffset + nBufferSize);
         }
-        else
-            IndexWay(psWayFeaturePairs->nWayID, bIsArea != 0, 0, NULL,
-                     pasLonLatCache, (int)nFound, NULL);
+        psJob->anCompressedWayOffsets.push_back(
+            psJob->abyCompressedWays.size());
 
         if( psWayFeaturePairs->poFeature == NULL )
         {
@@ -1772,25 +2120,111 @@ void OGROSMDataSource::ProcessWaysBatch()
         for( unsigned int i=0;i<nFound;i++)
         {
             poLS->setPoint(i,
-                        INT_TO_DBL(pasLonLatCache[i].nLon),
-                        INT_TO_DBL(pasLonLatCache[i].nLat));
+                        INT_TO_DBL(pasCoords[i].nLon),
+                        INT_TO_DBL(pasCoords[i].nLat));
         }
 
         psWayFeaturePairs->poFeature->SetGeometryDirectly(poGeom);
+    }
+}
+
+/************************************************************************/
+/*                          ResolveWaysFunc()                           */
+/************************************************************************/
 
-        if( nFound != psWayFeaturePairs->nRefs )
-            CPLDebug("OSM", "For way " CPL_FRMT_GIB ", got only %d nodes instead of %d",
-                   psWayFeaturePairs->nWayID, nFound,
-                   psWayFeaturePairs->nRefs);
+void OGROSMDataSource::ResolveWaysFunc( void* pData )
+{
+    OSMWaysJob* psJob = static_cast<OSMWaysJob*>(pData);
+    psJob->poDS->ResolveWays(psJob);
+}
 
-        int bFilteredOut = FALSE;
-        if( !papoLayers[IDX_LYR_LINES]->AddFeature(psWayFeaturePairs->poFeature,
-                                                   psWayFeaturePairs->bAttrFilterAlreadyEvaluated,
-                                                   &bFilteredOut,
-                                                   !bFeatureAdded) )
-            bStopParsing = true;
-        else if( !bFilteredOut )
-            bFeatureAdded = true;
+/************************************************************************/
+/*                         ProcessWaysBatch()                           */
+/************************************************************************/
+
+void OGROSMDataSource::ProcessWaysBatch()
+{
+    if( nWayFeaturePairs == 0 ) return;
+
+    //printf("nodes = %d, features = %d\n", nUnsortedReqIds, nWayFeaturePairs);
+    LookupNodes();
+
+/* -------------------------------------------------------------------- */
+/*      Resolve the ways, possibly in several threads.                  */
+/* -------------------------------------------------------------------- */
+    int nJobs = 1;
+    if( poWTP != NULL )
+    {
+        nJobs = std::max(1, std::min(nNumThreads * 4,
+                                     nWayFeaturePairs / MIN_WAYS_PER_JOB));
+    }
+    std::vector<OSMWaysJob> asJobs(nJobs);
+    std::vector<void*> apJobs;
+    for( int i = 0; i < nJobs; i++ )
+    {
+        asJobs[i].poDS = this;
+        asJobs[i].iFirst = static_cast<int>(
+            static_cast<GIntBig>(nWayFeaturePairs) * i / nJobs);
+        asJobs[i].iLast = static_cast<int>(
+            static_cast<GIntBig>(nWayFeaturePairs) * (i + 1) / nJobs);
+        asJobs[i].asLonLatCache.resize(MAX_NODES_PER_WAY);
+        apJobs.push_back(&asJobs[i]);
+    }
+
+    RunJobs(ResolveWaysFunc, apJobs);
+
+/* -------------------------------------------------------------------- */
+/*      Index the ways and add their features, in their original       */
+/*      order.                                                          */
+/* -------------------------------------------------------------------- */
+    for( int iJob = 0; iJob < nJobs; iJob++ )
+    {
+        const OSMWaysJob* psJob = &asJobs[iJob];
+        for( int iPair = psJob->iFirst; iPair < psJob->iLast; iPair ++)
+        {
+            WayFeaturePair* psWayFeaturePairs = &pasWayFeaturePairs[iPair];
+            const int iInJob = iPair - psJob->iFirst;
+            const unsigned int nFound = psJob->anFound[iInJob];
+
+            if( nFound < 2 )
+            {
+                CPLDebug("OSM", "Way " CPL_FRMT_GIB " with %d nodes that could be found. Discarding it",
+                        psWayFeaturePairs->nWayID, nFound);
+                delete psWayFeaturePairs->poFeature;
+                psWayFeaturePairs->poFeature = NULL;
+                psWayFeaturePairs->bIsArea = false;
+                continue;
+            }
+
+            const size_t nOffset = psJob->anCompressedWayOffsets[iInJob];
+            const size_t nSize =
+                psJob->anCompressedWayOffsets[iInJob + 1] - nOffset;
+            if( nSize > 0 )
+            {
+                IndexWay(psWayFeaturePairs->nWayID,
+                         &psJob->abyCompressedWays[nOffset],
+                         static_cast<int>(nSize));
+            }
+
+            if( psWayFeaturePairs->poFeature == NULL )
+            {
+                continue;
+            }
+
+            if( nFound != psWayFeaturePairs->nRefs )
+                CPLDebug("OSM", "For way " CPL_FRMT_GIB ", got only %d nodes instead of %d",
+                       psWayFeaturePairs->nWayID, nFound,
+                       psWayFeaturePairs->nRefs);
+
+            int bFilteredOut = FALSE;
+            if( !papoLayers[IDX_LYR_LINES]->AddFeature(psWayFeaturePairs->poFeature,
+                                                       psWayFeaturePairs->bAttrFilterAlreadyEvaluated,
+                                                       &bFilteredOut,
+                                                       !bFeatureAdded) )
+                bStopParsing = true;
+            else if( !bFilteredOut )
+                bFeatureAdded = true;
+        }
     }
 
     if( papoLayers[IDX_LYR_MULTIPOLYGONS]->IsUserInterested() )
@@ -1896,6 +2330,9 @@ bool OGROSMDataSource::IsClosedWayTaggedAsPolygon( unsigned int nTags, const OSM
 
 void OGROSMDataSource::NotifyWay( OSMWay* psWay )
 {
+    if( !apoPendingMultiPolygons.empty() )
+        ProcessMultiPolygonsBatch();
+
     nWaysProcessed++;
     if( nWaysProcessed % 10000 == 0 )
     {
@@ -2169,52 +2606,55 @@ static void OGROSMNotifyWay ( OSMWay *psWay,
 }
 
 /************************************************************************/
-/*                            LookupWays()                              */
+/*                          OGROSMGetWayMembers()                       */
 /************************************************************************/
 
-unsigned int OGROSMDataSource::LookupWays( std::map< GIntBig,
-                                           std::pair<int,void*> >& aoMapWays,
-                                           OSMRelation* psRelation )
+static void OGROSMGetWayMembers( const OSMRelation* psRelation,
+                                 std::vector<GIntBig>& anWayIDs,
+                                 std::vector<bool>* pabIsOuter )
 {
-    unsigned int nFound = 0;
-    unsigned int iCur = 0;
-
-    while( iCur < psRelation->nMembers )
+    for( unsigned int i = 0; i < psRelation->nMembers; i++ )
     {
-        unsigned int nToQuery = 0;
-        unsigned int i = iCur;  // Used after for.
-        for( ; i < psRelation->nMembers; i++ )
+        if( psRelation->pasMembers[i].eType == MEMBER_WAY &&
+            strcmp(psRelation->pasMembers[i].pszRole, "subarea") != 0 )
         {
-            if( psRelation->pasMembers[i].eType == MEMBER_WAY &&
-                strcmp(psRelation->pasMembers[i].pszRole, "subarea") != 0 )
-            {
-                nToQuery ++;
-                if( nToQuery ==
-                    static_cast<unsigned int>(LIMIT_IDS_PER_REQUEST) )
-                {
-                    break;
-                }
-            }
+            anWayIDs.push_back(psRelation->pasMembers[i].nID);
+            if( pabIsOuter != NULL )
+                pabIsOuter->push_back(
+                    strcmp(psRelation->pasMembers[i].pszRole, "outer") == 0);
         }
+    }
+}
 
-        if( nToQuery == 0)
-            break;
+/************************************************************************/
+/*                            LookupWays()                              */
+/*                                                                      */
+/*      Fetch the compressed ways of anWayIDs with the statements of    */
+/*      OGROSMPrepareSelectWayStmts(), on hDB or on the connection of a */
+/*      worker thread.                                                  */
+/************************************************************************/
+
+unsigned int OGROSMDataSource::LookupWays( sqlite3_stmt** pahStmt,
+                                           std::map< GIntBig,
+                                           std::pair<int,void*> >& aoMapWays,
+                                           const std::vector<GIntBig>& anWayIDs )
+{
+    unsigned int nFound = 0;
+    size_t iCur = 0;
 
-        unsigned int iLastI = (i == psRelation->nMembers) ? i : i + 1;
+    while( iCur < anWayIDs.size() )
+    {
+        const size_t nToQuery =
+            std::min(anWayIDs.size() - iCur,
+                     static_cast<size_t>(LIMIT_IDS_PER_REQUEST));
 
-        sqlite3_stmt* hStmt = pahSelectWayStmt[nToQuery-1];
-        unsigned int nBindIndex = 1;
-        for(i=iCur;i<iLastI;i++)
+        sqlite3_stmt* hStmt = pahStmt[nToQuery-1];
+        for( size_t i = 0; i < nToQuery; i++ )
         {
-            if( psRelation->pasMembers[i].eType == MEMBER_WAY &&
-                strcmp(psRelation->pasMembers[i].pszRole, "subarea") != 0 )
-            {
-                sqlite3_bind_int64( hStmt, nBindIndex,
-                                    psRelation->pasMembers[i].nID );
-                nBindIndex ++;
-            }
+            sqlite3_bind_int64( hStmt, static_cast<int>(i + 1),
+                                anWayIDs[iCur + i] );
         }
-        iCur = iLastI;
+        iCur += nToQuery;
 
         while( sqlite3_step(hStmt) == SQLITE_ROW )
         {
@@ -2237,112 +2677,136 @@ unsigned int OGROSMDataSource::LookupWays( std::map< GIntBig,
 }
 
 /************************************************************************/
-/*                          BuildMultiPolygon()                         */
+/*                         PrepareMultiPolygon()                        */
+/*                                                                      */
+/*      Collect the ways of a multipolygon relation, and fetch the tags */
+/*      of its first outer way if pnTags != NULL. The other ways are    */
+/*      fetched and the geometry is built by the worker threads.        */
 /************************************************************************/
 
-OGRGeometry* OGROSMDataSource::BuildMultiPolygon(OSMRelation* psRelation,
-                                                 unsigned int* pnTags,
-                                                 OSMTag* pasTags)
+OSMMultiPolygonJob* OGROSMDataSource::PrepareMultiPolygon(
+                                                OSMRelation* psRelation,
+                                                unsigned int* pnTags,
+                                                OSMTag* pasTags)
 {
-    std::map< GIntBig, std::pair<int,void*> > aoMapWays;
-    LookupWays( aoMapWays, psRelation );
+    OSMMultiPolygonJob* psJob = new OSMMultiPolygonJob();
+    psJob->poDS = this;
+    psJob->nRelationID = psRelation->nID;
+    OGROSMGetWayMembers(psRelation, psJob->anWayIDs, &psJob->abIsOuter);
 
-    bool bMissing = false;
+    if( pnTags == NULL )
+        return psJob;
 
-    for( unsigned int i = 0; i < psRelation->nMembers; i++ )
+    *pnTags = 0;
+    for( size_t i = 0; i < psJob->anWayIDs.size(); i++ )
     {
-        if( psRelation->pasMembers[i].eType == MEMBER_WAY &&
-            strcmp(psRelation->pasMembers[i].pszRole, "subarea") != 0 )
+        if( !psJob->abIsOuter[i] )
+            continue;
+
+        std::map< GIntBig, std::pair<int,void*> > aoMapWays;
+        LookupWays( pahSelectWayStmt, aoMapWays,
+                    std::vector<GIntBig>(1, psJob->anWayIDs[i]) );
+        if( aoMapWays.empty() )
         {
-            if( aoMapWays.find( psRelation->pasMembers[i].nID ) == aoMapWays.end() )
-            {
-                CPLDebug("OSM", "Relation " CPL_FRMT_GIB " has missing ways. Ignoring it",
-                        psRelation->nID);
-                bMissing = true;
-                break;
-            }
+            CPLDebug("OSM", "Relation " CPL_FRMT_GIB " has missing ways. Ignoring it",
+                    psRelation->nID);
+            delete psJob;
+            return NULL;
         }
-    }
 
-    if( bMissing )
-    {
-        std::map< GIntBig, std::pair<int,void*> >::iterator oIter;
-        for( oIter = aoMapWays.begin(); oIter != aoMapWays.end(); ++oIter )
-            CPLFree(oIter->second.second);
+        const std::pair<int, void*>& oGeom = aoMapWays.begin()->second;
+        memcpy(pabyWayBuffer, oGeom.second, oGeom.first);
+        CPLFree(oGeom.second);
 
-        return NULL;
+        UncompressWay (oGeom.first, pabyWayBuffer,
+                       NULL, pasLonLatCache,
+                       pnTags, pasTags, NULL );
+        break;
     }
 
-    OGRMultiLineString* poMLS = new OGRMultiLineString();
-    OGRGeometry** papoPolygons = static_cast<OGRGeometry**>( CPLMalloc(
-        sizeof(OGRGeometry*) * psRelation->nMembers) );
-    int nPolys = 0;
+    return psJob;
+}
 
-    if( pnTags != NULL )
-        *pnTags = 0;
+/************************************************************************/
+/*                        FetchMultiPolygonWays()                       */
+/************************************************************************/
 
-    for( unsigned int i = 0; i < psRelation->nMembers; i++ )
+void OGROSMDataSource::FetchMultiPolygonWays( OSMMultiPolygonJob* psJob,
+                                              sqlite3_stmt** pahStmt )
+{
+    psJob->bWaysFetched = true;
+    LookupWays( pahStmt, psJob->aoMapWays, psJob->anWayIDs );
+
+    for( size_t i = 0; i < psJob->anWayIDs.size(); i++ )
     {
-        if( psRelation->pasMembers[i].eType == MEMBER_WAY &&
-            strcmp(psRelation->pasMembers[i].pszRole, "subarea") != 0  )
+        if( psJob->aoMapWays.find( psJob->anWayIDs[i] ) ==
+                                                psJob->aoMapWays.end() )
         {
-            const std::pair<int, void*>& oGeom = aoMapWays[ psRelation->pasMembers[i].nID ];
+            CPLDebug("OSM", "Relation " CPL_FRMT_GIB " has missing ways. Ignoring it",
+                    psJob->nRelationID);
+            psJob->bMissingWays = true;
+            return;
+        }
+    }
+}
 
-            LonLat* pasCoords = (LonLat*) pasLonLatCache;
-            int nPoints = 0;
+/************************************************************************/
+/*                          BuildMultiPolygon()                         */
+/*                                                                      */
+/*      Build the geometry of a multipolygon relation from its fetched  */
+/*      ways. This can be run from several threads.                     */
+/************************************************************************/
 
-            if( pnTags != NULL && *pnTags == 0 &&
-                strcmp(psRelation->pasMembers[i].pszRole, "outer") == 0 )
-            {
-                int nCompressedWaySize = oGeom.first;
-                GByte* pabyCompressedWay = (GByte*) oGeom.second;
+void OGROSMDataSource::BuildMultiPolygon(OSMMultiPolygonJob* psJob)
+{
+    OGRMultiLineString* poMLS = new OGRMultiLineString();
+    OGRGeometry** papoPolygons = static_cast<OGRGeometry**>( CPLMalloc(
+        sizeof(OGRGeometry*) * psJob->anWayIDs.size()) );
+    int nPolys = 0;
 
-                memcpy(pabyWayBuffer, pabyCompressedWay, nCompressedWaySize);
+    std::vector<LonLat> asCoords(MAX_NODES_PER_WAY);
+    LonLat* pasCoords = &asCoords[0];
 
-                nPoints = UncompressWay (nCompressedWaySize, pabyWayBuffer,
-                                         NULL, pasCoords,
-                                         pnTags, pasTags, NULL );
-            }
-            else
-            {
-                nPoints = UncompressWay (oGeom.first, (GByte*) oGeom.second, NULL, pasCoords,
-                                         NULL, NULL, NULL);
-            }
+    for( size_t i = 0; i < psJob->anWayIDs.size(); i++ )
+    {
+        const std::pair<int, void*>& oGeom =
+            psJob->aoMapWays[ psJob->anWayIDs[i] ];
 
-            OGRLineString* poLS = NULL;
+        const int nPoints =
+            UncompressWay (oGeom.first, (GByte*) oGeom.second, NULL,
+                           pasCoords, NULL, NULL, NULL);
 
-            if( pasCoords[0].nLon == pasCoords[nPoints - 1].nLon &&
-                pasCoords[0].nLat == pasCoords[nPoints - 1].nLat )
-            {
-                OGRPolygon* poPoly = new OGRPolygon();
-                OGRLinearRing* poRing = new OGRLinearRing();
-                poPoly->addRingDirectly(poRing);
-                papoPolygons[nPolys ++] = poPoly;
-                poLS = poRing;
+        OGRLineString* poLS = NULL;
 
-                if( strcmp(psRelation->pasMembers[i].pszRole, "outer") == 0 )
-                {
-                    sqlite3_bind_int64( hDeletePolygonsStandaloneStmt, 1, psRelation->pasMembers[i].nID );
-                    CPL_IGNORE_RET_VAL(sqlite3_step( hDeletePolygonsStandaloneStmt ));
-                    sqlite3_reset( hDeletePolygonsStandaloneStmt );
-                }
-            }
-            else
-            {
-                poLS = new OGRLineString();
-                poMLS->addGeometryDirectly(poLS);
-            }
+        if( pasCoords[0].nLon == pasCoords[nPoints - 1].nLon &&
+            pasCoords[0].nLat == pasCoords[nPoints - 1].nLat )
+        {
+            OGRPolygon* poPoly = new OGRPolygon();
+            OGRLinearRing* poRing = new OGRLinearRing();
+            poPoly->addRingDirectly(poRing);
+            papoPolygons[nPolys ++] = poPoly;
+            poLS = poRing;
 
-            poLS->setNumPoints(nPoints);
-            for(int j=0;j<nPoints;j++)
+            if( psJob->abIsOuter[i] )
             {
-                poLS->setPoint( j,
-                                INT_TO_DBL(pasCoords[j].nLon),
-                                INT_TO_DBL(pasCoords[j].nLat) );
+                psJob->anStandalonePolygonsToDelete.push_back(
+                    psJob->anWayIDs[i]);
             }
         }
-    }
+        else
+        {
+            poLS = new OGRLineString();
+            poMLS->addGeometryDirectly(poLS);
+        }
 
+        poLS->setNumPoints(nPoints);
+        for(int j=0;j<nPoints;j++)
+        {
+            poLS->setPoint( j,
+                            INT_TO_DBL(pasCoords[j].nLon),
+                            INT_TO_DBL(pasCoords[j].nLat) );
+        }
+    }
     if( poMLS->getNumGeometries() > 0 )
     {
         OGRGeometryH hPoly = OGRBuildPolygonFromEdges( (OGRGeometryH) poMLS,
@@ -2399,7 +2863,7 @@ OGRGeometry* OGROSMDataSource::BuildMultiPolygon(OSMRelation* psRelation,
             CPLDebug( "OSM",
                       "Relation " CPL_FRMT_GIB
                       ": Geometry has incompatible type : %s",
-                      psRelation->nID,
+                      psJob->nRelationID,
                       poGeom != NULL ?
                       OGR_G_GetGeometryName(
                           reinterpret_cast<OGRGeometryH>(poGeom)) : "null" );
@@ -2409,13 +2873,115 @@ OGRGeometry* OGROSMDataSource::BuildMultiPolygon(OSMRelation* psRelation,
 
     CPLFree(papoPolygons);
 
-    std::map< GIntBig, std::pair<int,void*> >::iterator oIter;
-    for( oIter = aoMapWays.begin(); oIter != aoMapWays.end(); ++oIter )
-        CPLFree(oIter->second.second);
+    psJob->poGeom = poRet;
+}
+
+/************************************************************************/
+/*                        BuildMultiPolygonFunc()                       */
+/************************************************************************/
 
-    return poRet;
+void OGROSMDataSource::BuildMultiPolygonFunc( void* pData )
+{
+    OSMMultiPolygonJob* psJob = static_cast<OSMMultiPolygonJob*>(pData);
+    OGROSMDataSource* poDS = psJob->poDS;
+
+    CPLPushErrorHandlerEx(OGROSMDeferErrorHandler, &psJob->aoErrors);
+    if( !psJob->bWaysFetched )
+    {
+        OSMTmpFilesReader* psReader = poDS->AcquireReader();
+        if( psReader != NULL && psReader->pahSelectWayStmt == NULL )
+        {
+            psReader->pahSelectWayStmt =
+                OGROSMPrepareSelectWayStmts(psReader->hDB);
+        }
+        if( psReader == NULL )
+            poDS->FetchMultiPolygonWays(psJob, poDS->pahSelectWayStmt);
+        else if( psReader->pahSelectWayStmt != NULL )
+            poDS->FetchMultiPolygonWays(psJob, psReader->pahSelectWayStmt);
+        else
+            psJob->bMissingWays = true;
+        poDS->ReleaseReader(psReader);
+    }
+    if( !psJob->bMissingWays )
+        poDS->BuildMultiPolygon(psJob);
+    psJob->ClearWays();
+    CPLPopErrorHandler();
 }
 
+/************************************************************************/
+/*                      ProcessMultiPolygonsBatch()                     */
+/*                                                                      */
+/*      Build the geometries of the pending multipolygon relations,     */
+/*      possibly in several threads, and add their features in their    */
+/*      original order.                                                 */
+/************************************************************************/
+
+void OGROSMDataSource::ProcessMultiPolygonsBatch()
+{
+    if( apoPendingMultiPolygons.empty() )
+        return;
+
+    // The worker threads fetch the ways through their own read-only
+    // connections, which only see committed data.
+    if( !apoReaders.empty() && bInTransaction )
+    {
+        CommitTransactionCacheDB();
+        StartTransactionCacheDB();
+    }
+
+    std::vector<void*> apJobs( apoPendingMultiPolygons.begin(),
+                               apoPendingMultiPolygons.end() );
+    RunJobs(BuildMultiPolygonFunc, apJobs);
+
+    for( size_t iJob = 0; iJob < apoPendingMultiPolygons.size(); iJob++ )
+    {
+        OSMMultiPolygonJob* psJob = apoPendingMultiPolygons[iJob];
+
+        OGROSMEmitDeferredErrors(psJob->aoErrors);
+
+        for( size_t i = 0; i < psJob->anStandalonePolygonsToDelete.size();
+             i++ )
+        {
+            sqlite3_bind_int64( hDeletePolygonsStandaloneStmt, 1,
+                                psJob->anStandalonePolygonsToDelete[i] );
+            CPL_IGNORE_RET_VAL(sqlite3_step( hDeletePolygonsStandaloneStmt ));
+            sqlite3_reset( hDeletePolygonsStandaloneStmt );
+        }
+
+        if( psJob->poGeom != NULL )
+        {
+            OGRFeature* poFeature = psJob->poFeature;
+            psJob->poFeature = NULL;
+            poFeature->SetGeometryDirectly(psJob->poGeom);
+            psJob->poGeom = NULL;
+
+            int bFilteredOut = FALSE;
+            if( !papoLayers[IDX_LYR_MULTIPOLYGONS]->AddFeature(
+                                        poFeature,
+                                        psJob->bAttrFilterAlreadyEvaluated,
+                                        &bFilteredOut,
+                                        !bFeatureAdded ) )
+                bStopParsing = true;
+            else if( !bFilteredOut )
+                bFeatureAdded = true;
+        }
+    }
+
+    ClearPendingMultiPolygons();
+}
+
+/************************************************************************/
+/*                      ClearPendingMultiPolygons()                     */
+/************************************************************************/
+
+void OGROSMDataSource::ClearPendingMultiPolygons()
+{
+    for( size_t i = 0; i < apoPendingMultiPolygons.size(); i++ )
+        delete apoPendingMultiPolygons[i];
+    apoPendingMultiPolygons.clear();
+}
+
+
 /************************************************************************/
 /*                          BuildGeometryCollection()                   */
 /************************************************************************/
@@ -2423,8 +2989,10 @@ OGRGeometry* OGROSMDataSource::BuildMultiPolygon(OSMRelation* psRelation,
 OGRGeometry* OGROSMDataSource::BuildGeometryCollection(OSMRelation* psRelation,
                                                        int bMultiLineString)
 {
+    std::vector<GIntBig> anWayIDs;
+    OGROSMGetWayMembers(psRelation, anWayIDs, NULL);
     std::map< GIntBig, std::pair<int,void*> > aoMapWays;
-    LookupWays( aoMapWays, psRelation );
+    LookupWays( pahSelectWayStmt, aoMapWays, anWayIDs );
 
     OGRGeometryCollection* poColl = ( bMultiLineString ) ?
         new OGRMultiLineString() : new OGRGeometryCollection();
@@ -2577,16 +3145,15 @@ void OGROSMDataSource::NotifyRelation (OSMRelation* psRelation)
         }
     }
 
-    OGRGeometry* poGeom = NULL;
-
-    unsigned int nExtraTags = 0;
-    OSMTag pasExtraTags[1 + MAX_COUNT_FOR_TAGS_IN_WAY];
-
     if( bMultiPolygon )
     {
+        unsigned int nExtraTags = 0;
+        OSMTag pasExtraTags[1 + MAX_COUNT_FOR_TAGS_IN_WAY];
+
+        OSMMultiPolygonJob* psJob = NULL;
         if( !bInterestingTagFound )
         {
-            poGeom = BuildMultiPolygon(psRelation, &nExtraTags, pasExtraTags);
+            psJob = PrepareMultiPolygon(psRelation, &nExtraTags, pasExtraTags);
             CPLAssert(nExtraTags <=
                       static_cast<unsigned int>(MAX_COUNT_FOR_TAGS_IN_WAY));
             pasExtraTags[nExtraTags].pszK = "type";
@@ -2594,10 +3161,46 @@ void OGROSMDataSource::NotifyRelation (OSMRelation* psRelation)
             nExtraTags ++;
         }
         else
-            poGeom = BuildMultiPolygon(psRelation, NULL, NULL);
+            psJob = PrepareMultiPolygon(psRelation, NULL, NULL);
+
+        if( psJob == NULL )
+        {
+            delete poFeature;
+            return;
+        }
+
+        // The geometry is built later, with the ones of the next
+        // multipolygons, but the fields must be set now, while the
+        // tags are still valid.
+        psJob->bAttrFilterAlreadyEvaluated = true;
+        if( poFeature == NULL )
+        {
+            poFeature = new OGRFeature(papoLayers[iCurLayer]->GetLayerDefn());
+
+            papoLayers[iCurLayer]->SetFieldsFromTags(
+                poFeature,
+                psRelation->nID,
+                false,
+                nExtraTags ? nExtraTags : psRelation->nTags,
+                nExtraTags ? pasExtraTags : psRelation->pasTags,
+                &psRelation->sInfo);
+
+            psJob->bAttrFilterAlreadyEvaluated = false;
+        }
+        psJob->poFeature = poFeature;
+        apoPendingMultiPolygons.push_back(psJob);
+
+        if( poWTP == NULL ||
+            static_cast<int>(apoPendingMultiPolygons.size()) >=
+                                                MAX_PENDING_MULTIPOLYGONS )
+        {
+            ProcessMultiPolygonsBatch();
+        }
+        return;
     }
-    else
-        poGeom = BuildGeometryCollection(psRelation, bMultiLineString);
+
+    OGRGeometry* poGeom =
+        BuildGeometryCollection(psRelation, bMultiLineString);
 
     if( poGeom != NULL )
     {
@@ -2610,8 +3213,8 @@ void OGROSMDataSource::NotifyRelation (OSMRelation* psRelation)
                 poFeature,
                 psRelation->nID,
                 false,
-                nExtraTags ? nExtraTags : psRelation->nTags,
-                nExtraTags ? pasExtraTags : psRelation->pasTags,
+                psRelation->nTags,
+                psRelation->pasTags,
                 &psRelation->sInfo);
 
             bAttrFilterAlreadyEvaluated = false;
@@ -2886,6 +3489,26 @@ int OGROSMDataSource::Open( const char * pszFilename,
         return FALSE;
     }
 
+    // Same default as for the decompression of PBF blocks by the parser.
+    nNumThreads = CPLGetNumThreads(NULL, "ALL_CPUS");
+    if( nNumThreads > 1 )
+    {
+        poWTP = new CPLWorkerThreadPool();
+        if( !poWTP->Setup(nNumThreads, NULL, NULL) )
+        {
+            delete poWTP;
+            poWTP = NULL;
+        }
+        else
+        {
+            for( int i = 0; i < nNumThreads; i++ )
+                apoReaders.push_back(new OSMTmpFilesReader());
+            apoFreeReaders = apoReaders;
+        }
+    }
+    if( poWTP == NULL )
+        nNumThreads = 1;
+
     nMaxSizeForInMemoryDBInMB = atoi(CSLFetchNameValueDef(papszOpenOptionsIn,
         "MAX_TMPFILE_SIZE", CPLGetConfigOption("OSM_MAX_TMPFILE_SIZE", "100")));
     GIntBig nSize =
@@ -2924,6 +3547,8 @@ int OGROSMDataSource::Open( const char * pszFilename,
         {
             VSIFSeekL(fpNodes, 0, SEEK_SET);
             VSIFTruncateL(fpNodes, 0);
+            if( !OpenNodesFileReaders() )
+                return FALSE;
         }
         else
         {
@@ -2939,7 +3564,7 @@ int OGROSMDataSource::Open( const char * pszFilename,
             osNodesFilename = CPLGenerateTempFilename("osm_tmp_nodes");
 
             fpNodes = VSIFOpenL(osNodesFilename, "wb+");
-            if( fpNodes == NULL )
+            if( fpNodes == NULL || !OpenNodesFileReaders() )
             {
                 return FALSE;
             }
@@ -2990,6 +3615,8 @@ bool OGROSMDataSource::CreateTempDB()
         rc = sqlite3_open_v2( pszExistingTmpFile, &hDB,
                               SQLITE_OPEN_READWRITE | SQLITE_OPEN_NOMUTEX,
                               NULL );
+        if( rc == SQLITE_OK && !OpenDBReaders( pszExistingTmpFile, NULL ) )
+            return false;
     }
     else
     {
@@ -3034,6 +3661,9 @@ bool OGROSMDataSource::CreateTempDB()
                 SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE |
                 SQLITE_OPEN_NOMUTEX,
                 pMyVFS->zName );
+            if( rc == SQLITE_OK &&
+                !OpenDBReaders( osTmpDBName, pMyVFS->zName ) )
+                return false;
         }
     }
 
@@ -3046,6 +3676,9 @@ bool OGROSMDataSource::CreateTempDB()
         /* opened */
         if( rc == SQLITE_OK )
         {
+            if( !OpenDBReaders( osTmpDBName, NULL ) )
+                return false;
+
             const char* pszVal =
                 CPLGetConfigOption("OSM_UNLINK_TMPFILE", "YES");
             if( EQUAL(pszVal, "YES") )
@@ -3277,31 +3910,9 @@ bool OGROSMDataSource::CreatePreparedStatements()
         return false;
     }
 
-    pahSelectWayStmt = static_cast<sqlite3_stmt**>(
-        CPLCalloc(sizeof(sqlite3_stmt*), LIMIT_IDS_PER_REQUEST) );
-
-    strcpy(szTmp, "SELECT id, data FROM ways WHERE id IN (");
-    nLen = static_cast<int>(strlen(szTmp));
-    for(int i=0;i<LIMIT_IDS_PER_REQUEST;i++)
-    {
-        if(i == 0)
-        {
-            strcpy(szTmp + nLen, "?)");
-            nLen += 2;
-        }
-        else
-        {
-            strcpy(szTmp + nLen -1, ",?)");
-            nLen += 2;
-        }
-        rc = sqlite3_prepare_v2( hDB, szTmp, -1, &pahSelectWayStmt[i], NULL );
-        if( rc != SQLITE_OK )
-        {
-            CPLError( CE_Failure, CPLE_AppDefined,
-                    "sqlite3_prepare_v2() failed :  %s", sqlite3_errmsg(hDB) );
-            return false;
-        }
-    }
+    pahSelectWayStmt = OGROSMPrepareSelectWayStmts(hDB);
+    if( pahSelectWayStmt == NULL )
+        return false;
 
     rc = sqlite3_prepare_v2(
         hDB, "INSERT INTO polygons_standalone (id) VALUES (?)", -1,
@@ -3802,6 +4413,8 @@ int OGROSMDataSource::MyResetReading()
         sqlite3_reset( hSelectPolygonsStandaloneStmt );
 
     {
+        ClearPendingMultiPolygons();
+
         for( int i = 0; i < nWayFeaturePairs; i++)
         {
             delete pasWayFeaturePairs[i].poFeature;
@@ -3989,6 +4602,8 @@ bool OGROSMDataSource::ParseNextChunk( int nIdxLayer,
         {
             if( eRet == OSM_EOF )
             {
+                ProcessMultiPolygonsBatch();
+
                 if( nWayFeaturePairs != 0 )
                     ProcessWaysBatch();
 
@@ -4045,6 +4660,7 @@ bool OGROSMDataSource::TransferToDiskIfNecesserary()
         {
             bInMemoryNodesFile = false;
 
+            CloseNodesFileReaders();
             VSIFCloseL(fpNodes);
             fpNodes = NULL;
 
@@ -4101,6 +4717,12 @@ bool OGROSMDataSource::TransferToDiskIfNecesserary()
 
             VSIFSeekL(fpNodes, 0, SEEK_END);
 
+            if( !OpenNodesFileReaders() )
+            {
+                bStopParsing = true;
+                return false;
+            }
+
             /* On Unix filesystems, you can remove a file even if it */
             /* opened */
             const char* pszVal = CPLGetConfigOption("OSM_UNLINK_TMPFILE", "YES");
@@ -4163,6 +4785,13 @@ bool OGROSMDataSource::TransferToDiskIfNecesserary()
                 return false;
             }
 
+            if( !OpenDBReaders( osTmpDBName, NULL ) )
+            {
+                bStopParsing = true;
+                CloseDB();
+                return false;
+            }
+
             /* On Unix filesystems, you can remove a file even if it */
             /* opened */
             const char* pszVal =
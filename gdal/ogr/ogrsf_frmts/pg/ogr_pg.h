@@ -38,6 +38,9 @@
 #include "ogrpgutility.h"
 #include "ogr_pgdump.h"
 
+#include <map>
+#include <vector>
+
 /* These are the OIDs for some builtin types, as returned by PQftype(). */
 /* They were copied from pg_type.h in src/include/catalog/pg_type.h */
 
@@ -207,6 +210,8 @@ class OGRPGLayer : public OGRLayer
                                                       int*& panMapFieldNameToGeomIndex);
 
     int                 ReadResultDefinition(PGresult *hInitialResultIn);
+    bool                CanDecodeBinary( OGRFieldType eType,
+                                         Oid nTypeOID ) const;
 
     OGRFeature         *RecordToFeature( PGresult* hResult,
                                          const int* panMapFieldNameToIndex,
@@ -279,9 +284,23 @@ class OGRPGTableLayer : public OGRPGLayer
     int                 bFIDColumnInCopyFields;
     int                 bFirstInsertion;
 
+    int                 bCopyBinary;
+    int                 bCopyBinaryFailed;
+    std::vector<Oid>    anCopyColumnOIDs;
+
     OGRErr              CreateFeatureViaCopy( OGRFeature *poFeature );
     OGRErr              CreateFeatureViaInsert( OGRFeature *poFeature );
     CPLString           BuildCopyFields();
+    int                 CanUseCopyBinary();
+    int                 AppendCopyBinaryRecord( OGRFeature *poFeature,
+                                                CPLString& osBuffer );
+    OGRErr              PutCopyData( const CPLString& osData );
+    int                 AppendCopyBinaryGeometry( OGRFeature *poFeature,
+                                                  int iGeomField,
+                                                  CPLString& osBuffer );
+
+    std::map<CPLString, std::vector<Oid> > oMapColumnTypeOIDs;
+    const std::vector<Oid>& GetColumnTypeOIDs( const CPLString& osColumns );
 
     int                 bHasWarnedIncompatibleGeom;
     void                CheckGeomTypeCompatibility(int iGeomField, OGRGeometry* poGeom);
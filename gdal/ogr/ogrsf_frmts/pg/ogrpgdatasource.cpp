@@ -350,10 +350,8 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 /* -------------------------------------------------------------------- */
     if( STARTS_WITH_CI(pszNewName, "PGB:") )
     {
-#if defined(BINARY_CURSOR_ENABLED)
         bUseBinaryCursor = TRUE;
         CPLDebug("PG","BINARY cursor is used for geometry fetching");
-#endif
     }
     else
     if( !STARTS_WITH_CI(pszNewName, "PG:") )
@@ -364,6 +362,13 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
                       " PG:*\n", pszNewName );
         return FALSE;
     }
+    else
+    {
+        // Binary cursors are opt-in until the binary decoders have been
+        // validated against a server for all the column types.
+        bUseBinaryCursor =
+            CPLTestBool(CPLGetConfigOption("PG_USE_BINARY_CURSOR", "NO"));
+    }
 
     pszName = CPLStrdup( pszNewName );
 
@@ -608,7 +613,6 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
         if( pszSpace != NULL && isdigit(pszSpace[1]) )
         {
             OGRPGDecodeVersionString(&sPostgreSQLVersion, pszSpace + 1);
-#if defined(BINARY_CURSOR_ENABLED)
             if (sPostgreSQLVersion.nMajor == 7 && sPostgreSQLVersion.nMinor < 4)
             {
                 /* We don't support BINARY CURSOR for PostgreSQL < 7.4. */
@@ -616,7 +620,6 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
                 CPLDebug("PG","BINARY cursor will finally NOT be used because version < 7.4");
                 bUseBinaryCursor = FALSE;
             }
-#endif
         }
     }
     OGRPGClearResult(hResult);
@@ -638,9 +641,14 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 
 /* -------------------------------------------------------------------- */
 /*      Test if time binary format is int8 or float8                    */
+/*      (integer datetimes are the only option since PostgreSQL 10)     */
 /* -------------------------------------------------------------------- */
-#if defined(BINARY_CURSOR_ENABLED)
-    if (bUseBinaryCursor)
+    if( sPostgreSQLVersion.nMajor >= 10 )
+    {
+        bBinaryTimeFormatIsInt8 = TRUE;
+    }
+    else if( bUseBinaryCursor ||
+             CPLTestBool(CPLGetConfigOption("PG_USE_COPY_BINARY", "NO")) )
     {
         SoftStartTransaction();
 
@@ -690,7 +698,6 @@ int OGRPGDataSource::Open( const char * pszNewName, int bUpdate,
 
         SoftCommitTransaction();
     }
-#endif
 
 #ifdef notdef
     /* This would be the quickest fix... instead, ogrpglayer has been updated to support */
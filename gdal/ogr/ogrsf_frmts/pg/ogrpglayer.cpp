@@ -179,7 +179,6 @@ void OGRPGLayer::ResetReading()
     bInvalidated = FALSE;
 }
 
-#if defined(BINARY_CURSOR_ENABLED)
 /************************************************************************/
 /*                    OGRPGGetStrFromBinaryNumeric()                    */
 /************************************************************************/
@@ -433,12 +432,110 @@ int OGRPGTimeStamp2DMYHMS(GIntBig dt, int *year, int *month, int *day,
 
     OGRPGj2date((int) date, year, month, day);
     OGRPGdt2timeInt8(time, hour, min, &nSec, &dfSec);
-    *pdfSec += nSec + dfSec;
+    *pdfSec += nSec + dfSec / USECS_PER_SEC;
 
     return 0;
 }
 
-#endif // defined(BINARY_CURSOR_ENABLED)
+/************************************************************************/
+/*                    OGRPGGetBinaryArrayElements()                     */
+/*                                                                      */
+/*      Parse the header of an array in its binary representation      */
+/*      and return a pointer to its first element. Multidimensional    */
+/*      arrays are flattened, as in the text case.                     */
+/************************************************************************/
+
+static const char* OGRPGGetBinaryArrayElements( const char* pData,
+                                                int nLength, int* pnCount )
+{
+    *pnCount = 0;
+    if( nLength < 3 * 4 )
+        return NULL;
+
+    int nDims;
+    memcpy( &nDims, pData, 4 );
+    CPL_MSBPTR32( &nDims );
+    /* 6 is MAXDIM in PostgreSQL */
+    if( nDims < 0 || nDims > 6 || nLength < (3 + 2 * nDims) * 4 )
+        return NULL;
+
+    int nCount = (nDims > 0) ? 1 : 0;
+    for( int iDim = 0; iDim < nDims; iDim++ )
+    {
+        int nDimSize;
+        memcpy( &nDimSize, pData + (3 + 2 * iDim) * 4, 4 );
+        CPL_MSBPTR32( &nDimSize );
+        /* Each element takes at least 4 bytes for its size */
+        if( nDimSize < 0 || nDimSize > nLength / 4 )
+            return NULL;
+        nCount *= nDimSize;
+        if( nCount > nLength / 4 )
+            return NULL;
+    }
+
+    *pnCount = nCount;
+    return pData + (3 + 2 * nDims) * 4;
+}
+
+/************************************************************************/
+/*                    OGRPGGetNextBinaryArrayElement()                  */
+/*                                                                      */
+/*      Return the next element of an array in its binary              */
+/*      representation, or NULL for a NULL or truncated element.       */
+/************************************************************************/
+
+static const char* OGRPGGetNextBinaryArrayElement( const char*& pData,
+                                                   const char* pDataEnd,
+                                                   int* pnSize )
+{
+    *pnSize = -1;
+    if( pData == NULL || pDataEnd - pData < 4 )
+    {
+        pData = pDataEnd;
+        return NULL;
+    }
+
+    int nSize;
+    memcpy( &nSize, pData, 4 );
+    CPL_MSBPTR32( &nSize );
+    pData += 4;
+    if( nSize < 0 )
+        return NULL;
+    if( nSize > pDataEnd - pData )
+    {
+        pData = pDataEnd;
+        return NULL;
+    }
+
+    const char* pElement = pData;
+    pData += nSize;
+    *pnSize = nSize;
+    return pElement;
+}
+
+/************************************************************************/
+/*                        OGRPGRemoveEWKBSRID()                         */
+/*                                                                      */
+/*      Turn PostGIS EWKB into WKB that OGR can ingest, by removing     */
+/*      the SRID that may follow the geometry type. Returns the new     */
+/*      size.                                                           */
+/************************************************************************/
+
+static int OGRPGRemoveEWKBSRID( GByte* pabyWKB, int nLength )
+{
+    if( nLength > 9 &&
+        ((pabyWKB[0] == 0 /* big endian */ && (pabyWKB[1] & 0x20) )
+        || (pabyWKB[0] != 0 /* little endian */ && (pabyWKB[4] & 0x20))) )
+    {
+        memmove( pabyWKB+5, pabyWKB+9, nLength-9 );
+        nLength -= 4;
+        if( pabyWKB[0] == 0 )
+            pabyWKB[1] &= (~0x20);
+        else
+            pabyWKB[4] &= (~0x20);
+    }
+    return nLength;
+}
 
 /************************************************************************/
 /*                   TokenizeStringListFromText()                       */
@@ -594,9 +691,10 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
     {
         int     iOGRField;
 
-#if defined(BINARY_CURSOR_ENABLED)
         int nTypeOID = PQftype(hResult, iField);
-#endif
+        /* Text values have the same binary and text representations */
+        const bool bBinaryValue = PQfformat( hResult, iField ) == 1 &&
+                                  nTypeOID != TEXTOID;
         const char* pszFieldName = PQfname(hResult,iField);
 
 /* -------------------------------------------------------------------- */
@@ -604,8 +702,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
 /* -------------------------------------------------------------------- */
         if( pszFIDColumn != NULL && EQUAL(pszFieldName,pszFIDColumn) )
         {
-#if defined(BINARY_CURSOR_ENABLED)
-            if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
+            if ( bBinaryValue )
             {
                 if ( nTypeOID == INT4OID)
                 {
@@ -630,7 +727,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif /* defined(BINARY_CURSOR_ENABLED) */
             {
                 char* pabyData = PQgetvalue(hResult,iRecord,iField);
                 /* ogr_pg_20 may crash if PostGIS is unavailable and we don't test pabyData */
@@ -666,7 +762,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                     continue;
 
                 OGRGeometry * poGeom = NULL;
-                if( !poDS->bUseBinaryCursor && nLength >= 4 &&
+                if( !bBinaryValue && nLength >= 4 &&
                     /* escaped byea data */
                     (STARTS_WITH(pszVal, "\\000") || STARTS_WITH(pszVal, "\\001") ||
                     /* hex bytea data (PostgreSQL >= 9.0) */
@@ -686,7 +782,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
 
                 continue;
             }
-            else if ( !poDS->bUseBinaryCursor &&
+            else if ( !bBinaryValue &&
                       STARTS_WITH_CI(pszFieldName, "EWKBBase64") )
             {
                 GByte* pabyData = (GByte*)PQgetvalue( hResult,
@@ -710,7 +806,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
 
                 continue;
             }
-            else if ( poDS->bUseBinaryCursor ||
+            else if ( bBinaryValue ||
                       EQUAL(pszFieldName,"ST_AsEWKB") ||
                       EQUAL(pszFieldName,"AsEWKB") )
             {
@@ -724,9 +820,21 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 if (nLength == 0)
                     continue;
 
+                if( bBinaryValue && poDS->sPostGISVersion.nMajor >= 2 )
+                {
+                    /* Pass the WKB to the feature, that will only decode */
+                    /* it if the geometry is actually requested */
+                    GByte* pabyWKB = static_cast<GByte*>(CPLMalloc(nLength));
+                    memcpy( pabyWKB, pabyData, nLength );
+                    nLength = OGRPGRemoveEWKBSRID( pabyWKB, nLength );
+                    poFeature->SetGeomFieldWKBDirectly( iOGRGeomField,
+                                                        pabyWKB, nLength );
+                    continue;
+                }
+
                 OGRGeometry * poGeom = NULL;
 
-                if( !poDS->bUseBinaryCursor &&
+                if( !bBinaryValue &&
                     (STARTS_WITH(pabyData, "\\x00") || STARTS_WITH(pabyData, "\\x01") ||
                      STARTS_WITH(pabyData, "\\000") || STARTS_WITH(pabyData, "\\001")) )
                 {
@@ -803,21 +911,26 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
 
             if( bWkbAsOid )
             {
-                poGeometry =
-                    OIDToGeometry( (Oid) atoi((const char*)pabyData) );
+                if( bBinaryValue &&
+                    PQgetlength(hResult, iRecord, iField) == 4 )
+                {
+                    GUInt32 nOid;
+                    memcpy( &nOid, pabyData, 4 );
+                    CPL_MSBPTR32( &nOid );
+                    poGeometry = OIDToGeometry( static_cast<Oid>(nOid) );
+                }
+                else
+                    poGeometry =
+                        OIDToGeometry( (Oid) atoi((const char*)pabyData) );
             }
             else
             {
-#if defined(BINARY_CURSOR_ENABLED)
-                if (poDS->bUseBinaryCursor
-                    && PQfformat( hResult, iField ) == 1
-                   )
+                if( bBinaryValue )
                 {
                     int nLength = PQgetlength(hResult, iRecord, iField);
                     poGeometry = OGRGeometryFromEWKB(pabyData, nLength, NULL,
                                                      poDS->sPostGISVersion.nMajor < 2 );
                 }
-#endif
                 if (poGeometry == NULL)
                 {
                     poGeometry = BYTEAToGeometry( (const char*)pabyData,
@@ -855,46 +968,42 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
         {
             int *panList, nCount, i;
 
-#if defined(BINARY_CURSOR_ENABLED)
-            if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
+            if ( bBinaryValue )
             {
-                if (nTypeOID == INT2ARRAYOID || nTypeOID == INT4ARRAYOID)
+                if (nTypeOID == INT2ARRAYOID || nTypeOID == INT4ARRAYOID ||
+                    nTypeOID == BOOLARRAYOID)
                 {
-                    char * pData = PQgetvalue( hResult, iRecord, iField );
+                    const int nLength = PQgetlength(hResult, iRecord, iField);
+                    const char* pData = PQgetvalue( hResult, iRecord, iField );
+                    const char* pDataEnd = pData + nLength;
 
-                    // goto number of array elements
-                    pData += 3 * sizeof(int);
-                    memcpy( &nCount, pData, sizeof(int) );
-                    CPL_MSBPTR32( &nCount );
+                    pData = OGRPGGetBinaryArrayElements( pData, nLength,
+                                                         &nCount );
 
                     panList = (int *) CPLCalloc(sizeof(int),nCount);
 
-                    // goto first array element
-                    pData += 2 * sizeof(int);
-
                     for( i = 0; i < nCount; i++ )
                     {
-                        // get element size
-                        int nSize = *(int *)(pData);
-                        CPL_MSBPTR32( &nSize );
-                        pData += sizeof(int);
+                        int nSize;
+                        const char* pElement = OGRPGGetNextBinaryArrayElement(
+                            pData, pDataEnd, &nSize );
 
-                        if (nTypeOID == INT4ARRAYOID  )
+                        if( nTypeOID == INT4ARRAYOID && nSize == 4 )
                         {
-                            CPLAssert( nSize == sizeof(int) );
-                            memcpy( &panList[i], pData, nSize );
+                            memcpy( &panList[i], pElement, nSize );
                             CPL_MSBPTR32(&panList[i]);
                         }
-                        else
+                        else if( nTypeOID == INT2ARRAYOID && nSize == 2 )
                         {
-                            CPLAssert( nSize == sizeof(GInt16) );
                             GInt16 nVal;
-                            memcpy( &nVal, pData, nSize );
+                            memcpy( &nVal, pElement, nSize );
                             CPL_MSBPTR16(&nVal);
                             panList[i] = nVal;
                         }
-
-                        pData += nSize;
+                        else if( nTypeOID == BOOLARRAYOID && nSize == 1 )
+                        {
+                            panList[i] = (*pElement != 0);
+                        }
                     }
                 }
                 else
@@ -904,7 +1013,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif
             {
                 char **papszTokens = CSLTokenizeStringComplex(
                     PQgetvalue( hResult, iRecord, iField ),
@@ -934,37 +1042,30 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
             int nCount = 0;
             GIntBig *panList = NULL;
 
-#if defined(BINARY_CURSOR_ENABLED)
-            if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
+            if ( bBinaryValue )
             {
                 if (nTypeOID == INT8ARRAYOID)
                 {
-                    char * pData = PQgetvalue( hResult, iRecord, iField );
+                    const int nLength = PQgetlength(hResult, iRecord, iField);
+                    const char* pData = PQgetvalue( hResult, iRecord, iField );
+                    const char* pDataEnd = pData + nLength;
 
-                    // goto number of array elements
-                    pData += 3 * sizeof(int);
-                    memcpy( &nCount, pData, sizeof(int) );
-                    CPL_MSBPTR32( &nCount );
+                    pData = OGRPGGetBinaryArrayElements( pData, nLength,
+                                                         &nCount );
 
                     panList = (GIntBig *) CPLCalloc(sizeof(GIntBig),nCount);
 
-                    // goto first array element
-                    pData += 2 * sizeof(int);
-
                     for( int i = 0; i < nCount; i++ )
                     {
-                        // get element size
-                        int nSize = *(int *)(pData);
-                        CPL_MSBPTR32( &nSize );
+                        int nSize;
+                        const char* pElement = OGRPGGetNextBinaryArrayElement(
+                            pData, pDataEnd, &nSize );
 
-                        CPLAssert( nSize == sizeof(GIntBig) );
-
-                        pData += sizeof(int);
-
-                        memcpy( &panList[i], pData, nSize );
-                        CPL_MSBPTR64(&panList[i]);
-
-                        pData += nSize;
+                        if( nSize == 8 )
+                        {
+                            memcpy( &panList[i], pElement, nSize );
+                            CPL_MSBPTR64(&panList[i]);
+                        }
                     }
                 }
                 else
@@ -974,7 +1075,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif
             {
                 char **papszTokens = CSLTokenizeStringComplex(
                     PQgetvalue( hResult, iRecord, iField ),
@@ -1004,50 +1104,38 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
             int nCount, i;
             double *padfList = NULL;
 
-#if defined(BINARY_CURSOR_ENABLED)
-            if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
+            if ( bBinaryValue )
             {
                 if (nTypeOID == FLOAT8ARRAYOID || nTypeOID == FLOAT4ARRAYOID)
                 {
-                    char * pData = PQgetvalue( hResult, iRecord, iField );
+                    const int nLength = PQgetlength(hResult, iRecord, iField);
+                    const char* pData = PQgetvalue( hResult, iRecord, iField );
+                    const char* pDataEnd = pData + nLength;
 
-                    // goto number of array elements
-                    pData += 3 * sizeof(int);
-                    memcpy( &nCount, pData, sizeof(int) );
-                    CPL_MSBPTR32( &nCount );
+                    pData = OGRPGGetBinaryArrayElements( pData, nLength,
+                                                         &nCount );
 
                     padfList = (double *) CPLCalloc(sizeof(double),nCount);
 
-                    // goto first array element
-                    pData += 2 * sizeof(int);
-
                     for( i = 0; i < nCount; i++ )
                     {
-                        // get element size
-                        int nSize = *(int *)(pData);
-                        CPL_MSBPTR32( &nSize );
+                        int nSize;
+                        const char* pElement = OGRPGGetNextBinaryArrayElement(
+                            pData, pDataEnd, &nSize );
 
-                        pData += sizeof(int);
-
-                        if (nTypeOID == FLOAT8ARRAYOID)
+                        if( nTypeOID == FLOAT8ARRAYOID && nSize == 8 )
                         {
-                            CPLAssert( nSize == sizeof(double) );
-
-                            memcpy( &padfList[i], pData, nSize );
+                            memcpy( &padfList[i], pElement, nSize );
                             CPL_MSBPTR64(&padfList[i]);
                         }
-                        else
+                        else if( nTypeOID == FLOAT4ARRAYOID && nSize == 4 )
                         {
                             float fVal;
-                            CPLAssert( nSize == sizeof(float) );
-
-                            memcpy( &fVal, pData, nSize );
+                            memcpy( &fVal, pElement, nSize );
                             CPL_MSBPTR32(&fVal);
 
                             padfList[i] = fVal;
                         }
-
-                        pData += nSize;
                     }
                 }
                 else
@@ -1057,7 +1145,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif
             {
                 char **papszTokens = CSLTokenizeStringComplex(
                     PQgetvalue( hResult, iRecord, iField ),
@@ -1079,49 +1166,34 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
         {
             char **papszTokens = NULL;
 
-#if defined(BINARY_CURSOR_ENABLED)
-            if ( PQfformat( hResult, iField ) == 1 ) // Binary data representation
+            if ( bBinaryValue )
             {
-                char * pData = PQgetvalue( hResult, iRecord, iField );
+                const int nLength = PQgetlength(hResult, iRecord, iField);
+                const char* pData = PQgetvalue( hResult, iRecord, iField );
+                const char* pDataEnd = pData + nLength;
                 int nCount, i;
 
-                // goto number of array elements
-                pData += 3 * sizeof(int);
-                memcpy( &nCount, pData, sizeof(int) );
-                CPL_MSBPTR32( &nCount );
-
-                // goto first array element
-                pData += 2 * sizeof(int);
+                pData = OGRPGGetBinaryArrayElements( pData, nLength, &nCount );
 
                 for( i = 0; i < nCount; i++ )
                 {
-                    // get element size
-                    int nSize = *(int *)(pData);
-                    CPL_MSBPTR32( &nSize );
-
-                    pData += sizeof(int);
+                    int nSize;
+                    const char* pElement = OGRPGGetNextBinaryArrayElement(
+                        pData, pDataEnd, &nSize );
 
                     if (nSize <= 0)
                         papszTokens = CSLAddString(papszTokens, "");
                     else
                     {
-                        if (pData[nSize] == '\0')
-                            papszTokens = CSLAddString(papszTokens, pData);
-                        else
-                        {
-                            char* pszToken = (char*) CPLMalloc(nSize + 1);
-                            memcpy(pszToken, pData, nSize);
-                            pszToken[nSize] = '\0';
-                            papszTokens = CSLAddString(papszTokens, pszToken);
-                            CPLFree(pszToken);
-                        }
-
-                        pData += nSize;
+                        char* pszToken = (char*) CPLMalloc(nSize + 1);
+                        memcpy(pszToken, pElement, nSize);
+                        pszToken[nSize] = '\0';
+                        papszTokens = CSLAddString(papszTokens, pszToken);
+                        CPLFree(pszToken);
                     }
                 }
             }
             else
-#endif
             {
                 papszTokens =
                         OGRPGTokenizeStringListFromText(PQgetvalue(hResult, iRecord, iField ));
@@ -1138,8 +1210,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                  || eOGRType == OFTTime
                  || eOGRType == OFTDateTime )
         {
-#if defined(BINARY_CURSOR_ENABLED)
-            if ( PQfformat( hResult, iField ) == 1 ) // Binary data
+            if ( bBinaryValue )
             {
                 if ( nTypeOID == DATEOID )
                 {
@@ -1153,7 +1224,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 else if ( nTypeOID == TIMEOID )
                 {
                     int nHour, nMinute, nSecond;
-                    char szTime[32];
                     double dfsec;
                     CPLAssert(PQgetlength(hResult, iRecord, iField) == 8);
                     if (poDS->bBinaryTimeFormatIsInt8)
@@ -1165,6 +1235,8 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                         CPL_MSBPTR32(&nVal[1]);
                         llVal = (GIntBig) ((((GUIntBig)nVal[0]) << 32) | nVal[1]);
                         OGRPGdt2timeInt8(llVal, &nHour, &nMinute, &nSecond, &dfsec);
+                        /* fractional part in microseconds */
+                        dfsec /= USECS_PER_SEC;
                     }
                     else
                     {
@@ -1173,8 +1245,9 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                         CPL_MSBPTR64(&dfVal);
                         OGRPGdt2timeFloat8(dfVal, &nHour, &nMinute, &nSecond, &dfsec);
                     }
-                    snprintf(szTime, sizeof(szTime), "%02d:%02d:%02d", nHour, nMinute, nSecond);
-                    poFeature->SetField( iOGRField, szTime);
+                    poFeature->SetField( iOGRField, 0, 0, 0, nHour, nMinute,
+                                         static_cast<float>(nSecond + dfsec),
+                                         0 );
                 }
                 else if ( nTypeOID == TIMESTAMPOID || nTypeOID == TIMESTAMPTZOID )
                 {
@@ -1187,18 +1260,11 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                     CPL_MSBPTR32(&nVal[0]);
                     CPL_MSBPTR32(&nVal[1]);
                     llVal = (GIntBig) ((((GUIntBig)nVal[0]) << 32) | nVal[1]);
+                    /* timestamp without time zone values have no time */
+                    /* zone, as in the text case */
                     if (OGRPGTimeStamp2DMYHMS(llVal, &nYear, &nMonth, &nDay, &nHour, &nMinute, &dfSecond) == 0)
-                        poFeature->SetField( iOGRField, nYear, nMonth, nDay, nHour, nMinute, (float)dfSecond, 100);
-                }
-                else if ( nTypeOID == TEXTOID )
-                {
-                    OGRField  sFieldValue;
-
-                    if( OGRParseDate( PQgetvalue( hResult, iRecord, iField ),
-                                    &sFieldValue, 0 ) )
-                    {
-                        poFeature->SetField( iOGRField, &sFieldValue );
-                    }
+                        poFeature->SetField( iOGRField, nYear, nMonth, nDay, nHour, nMinute, (float)dfSecond,
+                                             (nTypeOID == TIMESTAMPTZOID) ? 100 : 0 );
                 }
                 else
                 {
@@ -1206,7 +1272,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif
             {
                 OGRField  sFieldValue;
 
@@ -1219,15 +1284,13 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
         }
         else if( eOGRType == OFTBinary )
         {
-#if defined(BINARY_CURSOR_ENABLED)
-            if ( PQfformat( hResult, iField ) == 1)
+            if ( bBinaryValue )
             {
                 int nLength = PQgetlength(hResult, iRecord, iField);
                 GByte* pabyData = (GByte*) PQgetvalue( hResult, iRecord, iField );
                 poFeature->SetField( iOGRField, nLength, pabyData );
             }
             else
-#endif  /* defined(BINARY_CURSOR_ENABLED) */
             {
                 int nLength = PQgetlength(hResult, iRecord, iField);
                 const char* pszBytea = (const char*) PQgetvalue( hResult, iRecord, iField );
@@ -1238,8 +1301,7 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
         }
         else
         {
-#if defined(BINARY_CURSOR_ENABLED)
-            if ( PQfformat( hResult, iField ) == 1 &&
+            if ( bBinaryValue &&
                  eOGRType != OFTString ) // Binary data
             {
                 if ( nTypeOID == BOOLOID )
@@ -1266,7 +1328,15 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                     memcpy( &sDscale, pabyData, sizeof(short));
                     pabyData += sizeof(short);
                     CPL_MSBPTR16(&sDscale);
-                    CPLAssert(PQgetlength(hResult, iRecord, iField) == (int)((4 + sLen) * sizeof(short)));
+                    if( PQgetlength(hResult, iRecord, iField) <
+                            (int)((4 + sLen) * sizeof(short)) )
+                        continue;
+
+                    if( sSign == NUMERIC_NAN )
+                    {
+                        poFeature->SetField( iOGRField, "NaN" );
+                        continue;
+                    }
 
                     NumericVar var;
                     var.ndigits = sLen;
@@ -1275,7 +1345,12 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                     var.dscale = sDscale;
                     var.digits = (NumericDigit*)pabyData;
                     char* str = OGRPGGetStrFromBinaryNumeric(&var);
-                    poFeature->SetField( iOGRField, CPLAtof(str));
+                    /* Go through the string for integer values so that */
+                    /* more than 15 significant digits are preserved */
+                    if( eOGRType != OFTReal && sDscale == 0 )
+                        poFeature->SetField( iOGRField, str );
+                    else
+                        poFeature->SetField( iOGRField, CPLAtof(str) );
                     CPLFree(str);
                 }
                 else if ( nTypeOID == INT2OID )
@@ -1331,7 +1406,6 @@ OGRFeature *OGRPGLayer::RecordToFeature( PGresult* hResult,
                 }
             }
             else
-#endif /* defined(BINARY_CURSOR_ENABLED) */
             {
                 if ( eOGRType == OFTInteger &&
                      poFeatureDefn->GetFieldDefn(iOGRField)->GetWidth() == 1)
@@ -1431,6 +1505,67 @@ void OGRPGLayer::CreateMapFromFieldNameToIndex(PGresult* hResult,
     }
 }
 
+/************************************************************************/
+/*                          CanDecodeBinary()                           */
+/*                                                                      */
+/*      Returns whether RecordToFeature() can decode the binary         */
+/*      representation of a column of the given type into a field of  */
+/*      the given OGR type. Other columns must be fetched as text to   */
+/*      be able to use a binary cursor.                                 */
+/************************************************************************/
+
+bool OGRPGLayer::CanDecodeBinary( OGRFieldType eType, Oid nTypeOID ) const
+{
+    if( nTypeOID == TEXTOID )
+        return true;
+
+    switch( eType )
+    {
+        case OFTInteger:
+        case OFTInteger64:
+        case OFTReal:
+            return nTypeOID == BOOLOID || nTypeOID == INT2OID ||
+                   nTypeOID == INT4OID || nTypeOID == INT8OID ||
+                   nTypeOID == FLOAT4OID || nTypeOID == FLOAT8OID ||
+                   nTypeOID == NUMERICOID;
+
+        case OFTString:
+            return nTypeOID == CHAROID || nTypeOID == NAMEOID ||
+                   nTypeOID == BPCHAROID || nTypeOID == VARCHAROID;
+
+        case OFTIntegerList:
+            return nTypeOID == BOOLARRAYOID || nTypeOID == INT2ARRAYOID ||
+                   nTypeOID == INT4ARRAYOID;
+
+        case OFTInteger64List:
+            return nTypeOID == INT8ARRAYOID;
+
+        case OFTRealList:
+            return nTypeOID == FLOAT4ARRAYOID || nTypeOID == FLOAT8ARRAYOID;
+
+        case OFTStringList:
+            return nTypeOID == TEXTARRAYOID || nTypeOID == BPCHARARRAYOID ||
+                   nTypeOID == VARCHARARRAYOID;
+
+        case OFTDate:
+            return nTypeOID == DATEOID;
+
+        case OFTTime:
+            return nTypeOID == TIMEOID;
+
+        case OFTDateTime:
+            /* The time zone of timestamp with time zone values is lost */
+            /* in their binary representation */
+            return nTypeOID == TIMESTAMPOID && poDS->bBinaryTimeFormatIsInt8;
+
+        case OFTBinary:
+            return nTypeOID == BYTEAOID;
+
+        default:
+            return false;
+    }
+}
+
 /************************************************************************/
 /*                     SetInitialQueryCursor()                          */
 /************************************************************************/
@@ -1444,12 +1579,10 @@ void OGRPGLayer::SetInitialQueryCursor()
 
     poDS->SoftStartTransaction();
 
-#if defined(BINARY_CURSOR_ENABLED)
     if ( poDS->bUseBinaryCursor && bCanUseBinaryCursor )
         osCommand.Printf( "DECLARE %s BINARY CURSOR for %s",
                             pszCursorName, pszQueryStatement );
     else
-#endif
         osCommand.Printf( "DECLARE %s CURSOR for %s",
                             pszCursorName, pszQueryStatement );
 
@@ -2041,6 +2174,9 @@ int OGRPGLayer::ReadResultDefinition(PGresult *hInitialResultIn)
             }
             CPLFree(pszFIDColumn);
             pszFIDColumn = CPLStrdup(oField.GetNameRef());
+            if( nTypeOID != INT4OID && nTypeOID != INT8OID &&
+                nTypeOID != TEXTOID )
+                bCanUseBinaryCursor = FALSE;
             continue;
         }
         else if( (iGeomFuncPrefix =
@@ -2198,13 +2334,6 @@ int OGRPGLayer::ReadResultDefinition(PGresult *hInitialResultIn)
         else if ( nTypeOID == TIMESTAMPOID ||
                   nTypeOID == TIMESTAMPTZOID )
         {
-#if defined(BINARY_CURSOR_ENABLED)
-            /* We can't deserialize properly timestamp with time zone */
-            /* with binary cursors */
-            if (nTypeOID == TIMESTAMPTZOID)
-                bCanUseBinaryCursor = FALSE;
-#endif
-
             oField.SetType( OFTDateTime );
         }
         else /* unknown type */
@@ -2214,6 +2343,11 @@ int OGRPGLayer::ReadResultDefinition(PGresult *hInitialResultIn)
             oField.SetType( OFTString );
         }
 
+        /* A single column that cannot be decoded from its binary */
+        /* representation forces the use of a text cursor */
+        if( !CanDecodeBinary( oField.GetType(), nTypeOID ) )
+            bCanUseBinaryCursor = FALSE;
+
         poFeatureDefn->AddFieldDefn( &oField );
     }
 
@@ -34,6 +34,9 @@
 #include "cpl_error.h"
 #include "ogr_p.h"
 
+#include <algorithm>
+#include <climits>
+
 #define PQexec this_is_an_error
 
 CPL_CVSID("$Id$")
@@ -142,6 +145,8 @@ OGRPGTableLayer::OGRPGTableLayer( OGRPGDataSource *poDSIn,
     bCopyActive(FALSE),
     bFIDColumnInCopyFields(FALSE),
     bFirstInsertion(TRUE),
+    bCopyBinary(FALSE),
+    bCopyBinaryFailed(FALSE),
     bHasWarnedIncompatibleGeom(FALSE),
     // Just in provision for people yelling about broken backward compatibility.
     bRetrieveFID(CPLTestBool(
@@ -958,9 +963,47 @@ CPLString OGRPGTableLayer::BuildFields()
 
     poFeatureDefn->GetFieldCount();
 
-    if( pszFIDColumn != NULL && poFeatureDefn->GetFieldIndex( pszFIDColumn ) == -1 )
+/* -------------------------------------------------------------------- */
+/*      With a binary cursor, the columns whose binary representation   */
+/*      we cannot decode are fetched as text, so find their types.     */
+/* -------------------------------------------------------------------- */
+    const bool bFIDInFieldList =
+        pszFIDColumn != NULL && poFeatureDefn->GetFieldIndex( pszFIDColumn ) == -1;
+    const std::vector<Oid>* panColumnOIDs = NULL;
+    if( poDS->bUseBinaryCursor && !bDeferredCreation )
     {
-        osFieldList += OGRPGEscapeColumnName(pszFIDColumn);
+        CPLString osColumns;
+        if( bFIDInFieldList )
+            osColumns += OGRPGEscapeColumnName(pszFIDColumn);
+        for( i = 0; i < poFeatureDefn->GetFieldCount(); i++ )
+        {
+            if( !osColumns.empty() )
+                osColumns += ", ";
+            osColumns += OGRPGEscapeColumnName(
+                poFeatureDefn->GetFieldDefn(i)->GetNameRef());
+        }
+        if( !osColumns.empty() )
+        {
+            panColumnOIDs = &GetColumnTypeOIDs(osColumns);
+            if( panColumnOIDs->size() !=
+                    static_cast<size_t>(poFeatureDefn->GetFieldCount() +
+                                        (bFIDInFieldList ? 1 : 0)) )
+                panColumnOIDs = NULL;
+        }
+    }
+
+    if( bFIDInFieldList )
+    {
+        if( poDS->bUseBinaryCursor &&
+            (panColumnOIDs == NULL ||
+             ((*panColumnOIDs)[0] != INT4OID && (*panColumnOIDs)[0] != INT8OID)) )
+        {
+            osFieldList += "CAST (";
+            osFieldList += OGRPGEscapeColumnName(pszFIDColumn);
+            osFieldList += " AS text)";
+        }
+        else
+            osFieldList += OGRPGEscapeColumnName(pszFIDColumn);
     }
 
     for( i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
@@ -1020,7 +1063,6 @@ CPLString OGRPGTableLayer::BuildFields()
         }
         else if ( poGeomFieldDefn->ePostgisType == GEOM_TYPE_GEOGRAPHY )
         {
-#if defined(BINARY_CURSOR_ENABLED)
             if ( poDS->bUseBinaryCursor )
             {
                 osFieldList += "ST_AsBinary(";
@@ -1030,7 +1072,6 @@ CPLString OGRPGTableLayer::BuildFields()
                     CPLSPrintf("AsBinary_%s", poGeomFieldDefn->GetNameRef()));
             }
             else
-#endif
             if (CPLTestBool(CPLGetConfigOption("PG_USE_BASE64", "NO")))
             {
                 osFieldList += "encode(ST_AsEWKB(";
@@ -1065,18 +1106,19 @@ CPLString OGRPGTableLayer::BuildFields()
         if( !osFieldList.empty() )
             osFieldList += ", ";
 
-#if defined(BINARY_CURSOR_ENABLED)
-        /* With a binary cursor, it is not possible to get the time zone */
-        /* of a timestamptz column. So we fallback to asking it in text mode */
+        /* With a binary cursor, it is for example not possible to get */
+        /* the time zone of a timestamptz column. So we fallback to asking */
+        /* such columns in text mode */
         if ( poDS->bUseBinaryCursor &&
-             poFeatureDefn->GetFieldDefn(i)->GetType() == OFTDateTime)
+             (panColumnOIDs == NULL ||
+              !CanDecodeBinary( poFeatureDefn->GetFieldDefn(i)->GetType(),
+                                (*panColumnOIDs)[i + (bFIDInFieldList ? 1 : 0)] )) )
         {
             osFieldList += "CAST (";
             osFieldList += OGRPGEscapeColumnName(pszName);
             osFieldList += " AS text)";
         }
         else
-#endif
         {
             osFieldList += OGRPGEscapeColumnName(pszName);
         }
@@ -1901,6 +1943,757 @@ OGRErr OGRPGTableLayer::CreateFeatureViaInsert( OGRFeature *poFeature )
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                         GetColumnTypeOIDs()                          */
+/*                                                                      */
+/*      Return the type OIDs of a list of columns of the table, as      */
+/*      reported by the server for a query returning no row. Results    */
+/*      are cached per column list. The result is empty on failure.     */
+/************************************************************************/
+
+const std::vector<Oid>& OGRPGTableLayer::GetColumnTypeOIDs(
+                                                const CPLString& osColumns )
+{
+    std::map<CPLString, std::vector<Oid> >::iterator oIter =
+        oMapColumnTypeOIDs.find(osColumns);
+    if( oIter != oMapColumnTypeOIDs.end() )
+        return oIter->second;
+
+    std::vector<Oid>& anOIDs = oMapColumnTypeOIDs[osColumns];
+
+    CPLString osCommand;
+    osCommand.Printf("SELECT %s FROM %s LIMIT 0",
+                     osColumns.c_str(), pszSqlTableName);
+    PGresult *hResult = OGRPG_PQexec( poDS->GetPGConn(), osCommand.c_str() );
+    if( hResult && PQresultStatus(hResult) == PGRES_TUPLES_OK )
+    {
+        for( int i = 0; i < PQnfields(hResult); i++ )
+            anOIDs.push_back( PQftype(hResult, i) );
+    }
+    OGRPGClearResult( hResult );
+
+    return anOIDs;
+}
+
+/************************************************************************/
+/*                  Binary COPY encoding helpers.                       */
+/*                                                                      */
+/*      See the "Binary Format" section of the COPY documentation and   */
+/*      the *send() functions of the PostgreSQL backend. All values     */
+/*      are in network byte order.                                      */
+/************************************************************************/
+
+static void OGRPGAppendInt16( CPLString& osBuffer, GInt16 nVal )
+{
+    CPL_MSBPTR16( &nVal );
+    osBuffer.append( reinterpret_cast<const char*>(&nVal), sizeof(nVal) );
+}
+
+static void OGRPGAppendInt32( CPLString& osBuffer, GInt32 nVal )
+{
+    CPL_MSBPTR32( &nVal );
+    osBuffer.append( reinterpret_cast<const char*>(&nVal), sizeof(nVal) );
+}
+
+static void OGRPGAppendInt64( CPLString& osBuffer, GIntBig nVal )
+{
+    CPL_MSBPTR64( &nVal );
+    osBuffer.append( reinterpret_cast<const char*>(&nVal), sizeof(nVal) );
+}
+
+/* Append a value preceded by its size */
+static void OGRPGAppendCopyValue( CPLString& osBuffer, const void* pData,
+                                  int nSize )
+{
+    OGRPGAppendInt32( osBuffer, nSize );
+    osBuffer.append( static_cast<const char*>(pData), nSize );
+}
+
+/* Start a value whose size is not known in advance */
+static size_t OGRPGBeginCopyValue( CPLString& osBuffer )
+{
+    const size_t nOffset = osBuffer.size();
+    OGRPGAppendInt32( osBuffer, 0 );
+    return nOffset;
+}
+
+static void OGRPGEndCopyValue( CPLString& osBuffer, size_t nOffset )
+{
+    GInt32 nSize = static_cast<GInt32>(osBuffer.size() - nOffset - 4);
+    CPL_MSBPTR32( &nSize );
+    memcpy( &osBuffer[nOffset], &nSize, 4 );
+}
+
+/* Coming from date2j() in pgsql/src/backend/utils/adt/datetime.c */
+static int OGRPGDate2J( int y, int m, int d )
+{
+    if (m > 2)
+    {
+        m += 1;
+        y += 4800;
+    }
+    else
+    {
+        m += 13;
+        y += 4799;
+    }
+
+    const int century = y / 100;
+    int julian = y * 365 - 32167;
+    julian += y / 4 - century + century / 4;
+    julian += 7834 * m / 256 + d;
+
+    return julian;
+}
+
+#define POSTGRES_EPOCH_JDATE 2451545 /* == date2j(2000, 1, 1) */
+#define USECS_PER_DAY   ((GIntBig) 3600 * 24 * 1000000)
+
+/* Number of microseconds since midnight */
+static GIntBig OGRPGTimeToUSecs( int nHour, int nMinute, float fSecond )
+{
+    return (static_cast<GIntBig>(nHour) * 60 + nMinute) * 60 * 1000000 +
+           static_cast<GIntBig>(floor(static_cast<double>(fSecond) * 1e6 + 0.5));
+}
+
+/************************************************************************/
+/*                     OGRPGAppendBinaryNumeric()                       */
+/*                                                                      */
+/*      Append the binary representation of a numeric from its          */
+/*      decimal string representation, possibly with an exponent.      */
+/************************************************************************/
+
+static bool OGRPGAppendBinaryNumeric( CPLString& osBuffer,
+                                      const char* pszValue )
+{
+    GInt16 nSign = 0x0000; /* NUMERIC_POS */
+    if( *pszValue == '-' )
+    {
+        nSign = 0x4000; /* NUMERIC_NEG */
+        pszValue++;
+    }
+    else if( *pszValue == '+' )
+        pszValue++;
+
+    if( EQUAL(pszValue, "NaN") )
+    {
+        OGRPGAppendInt32( osBuffer, 4 * 2 );
+        OGRPGAppendInt16( osBuffer, 0 );
+        OGRPGAppendInt16( osBuffer, 0 );
+        OGRPGAppendInt16( osBuffer, static_cast<GInt16>(0xC000) );
+        OGRPGAppendInt16( osBuffer, 0 );
+        return true;
+    }
+
+    /* Collect the decimal digits and the position of the decimal point */
+    CPLString osDigits;
+    int nIntDigits = -1;
+    int nExponent = 0;
+    for( ; *pszValue != '\0'; pszValue++ )
+    {
+        if( *pszValue >= '0' && *pszValue <= '9' )
+            osDigits += *pszValue;
+        else if( *pszValue == '.' && nIntDigits < 0 )
+            nIntDigits = static_cast<int>(osDigits.size());
+        else if( (*pszValue == 'e' || *pszValue == 'E') && !osDigits.empty() )
+        {
+            nExponent = atoi(pszValue + 1);
+            break;
+        }
+        else
+            return false;
+    }
+    if( osDigits.empty() || nExponent < -1000 || nExponent > 1000 )
+        return false;
+    const int nDigits = static_cast<int>(osDigits.size());
+    if( nIntDigits < 0 )
+        nIntDigits = nDigits;
+    nIntDigits += nExponent;
+
+    /* Group the digits by 4 (base 10000), aligned on the decimal point. */
+    /* Power of ten p goes to the group of weight floor(p / 4). */
+    const int nFirstPow = nIntDigits - 1;
+    const int nLastPow = nIntDigits - nDigits;
+    const int nWeight = (nFirstPow >= 0) ? nFirstPow / 4 : -((-nFirstPow + 3) / 4);
+    const int nLastWeight = (nLastPow >= 0) ? nLastPow / 4 : -((-nLastPow + 3) / 4);
+    const int nGroups = nWeight - nLastWeight + 1;
+    std::vector<GInt16> anGroups(nGroups, 0);
+    static const GInt16 anPow10[4] = { 1, 10, 100, 1000 };
+    for( int i = 0; i < nDigits; i++ )
+    {
+        const int nPow = nFirstPow - i;
+        const int nGroupWeight = (nPow >= 0) ? nPow / 4 : -((-nPow + 3) / 4);
+        anGroups[nWeight - nGroupWeight] = static_cast<GInt16>(
+            anGroups[nWeight - nGroupWeight] +
+            (osDigits[i] - '0') * anPow10[nPow - nGroupWeight * 4]);
+    }
+    const int nDScale = std::max(0, nDigits - nIntDigits);
+
+    OGRPGAppendInt32( osBuffer, (4 + nGroups) * 2 );
+    OGRPGAppendInt16( osBuffer, static_cast<GInt16>(nGroups) );
+    OGRPGAppendInt16( osBuffer, static_cast<GInt16>(nWeight) );
+    OGRPGAppendInt16( osBuffer, nSign );
+    OGRPGAppendInt16( osBuffer, static_cast<GInt16>(nDScale) );
+    for( int i = 0; i < nGroups; i++ )
+        OGRPGAppendInt16( osBuffer, anGroups[i] );
+
+    return true;
+}
+
+/************************************************************************/
+/*                      OGRPGGetCopyArrayElementOID()                   */
+/************************************************************************/
+
+static Oid OGRPGGetCopyArrayElementOID( Oid nArrayOID )
+{
+    switch( nArrayOID )
+    {
+        case BOOLARRAYOID: return BOOLOID;
+        case INT2ARRAYOID: return INT2OID;
+        case INT4ARRAYOID: return INT4OID;
+        case INT8ARRAYOID: return INT8OID;
+        case FLOAT4ARRAYOID: return FLOAT4OID;
+        case FLOAT8ARRAYOID: return FLOAT8OID;
+        case TEXTARRAYOID: return TEXTOID;
+        case BPCHARARRAYOID: return BPCHAROID;
+        case VARCHARARRAYOID: return VARCHAROID;
+        default: return 0;
+    }
+}
+
+/************************************************************************/
+/*                        OGRPGIsCopyTextOID()                          */
+/************************************************************************/
+
+static bool OGRPGIsCopyTextOID( Oid nTypeOID )
+{
+    return nTypeOID == TEXTOID || nTypeOID == VARCHAROID ||
+           nTypeOID == BPCHAROID;
+}
+
+/************************************************************************/
+/*                          CanUseCopyBinary()                          */
+/*                                                                      */
+/*      Check that we know how to encode the values of the features    */
+/*      for the types of the columns of the COPY statement, in the      */
+/*      order of BuildCopyFields().                                     */
+/************************************************************************/
+
+int OGRPGTableLayer::CanUseCopyBinary()
+{
+    const bool bInt8Time = CPL_TO_BOOL(poDS->bBinaryTimeFormatIsInt8);
+    size_t iCol = 0;
+
+    for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++, iCol++ )
+    {
+        if( iCol >= anCopyColumnOIDs.size() )
+            return FALSE;
+        OGRPGGeomFieldDefn* poGeomFieldDefn =
+            poFeatureDefn->myGetGeomFieldDefn(i);
+        const Oid nOID = anCopyColumnOIDs[iCol];
+        if( !((poGeomFieldDefn->ePostgisType == GEOM_TYPE_GEOMETRY &&
+               nOID == poDS->GetGeometryOID()) ||
+              (poGeomFieldDefn->ePostgisType == GEOM_TYPE_GEOGRAPHY &&
+               nOID == poDS->GetGeographyOID()) ||
+              (poGeomFieldDefn->ePostgisType == GEOM_TYPE_WKB &&
+               nOID == BYTEAOID)) )
+            return FALSE;
+    }
+
+    int nFIDIndex = -1;
+    if( bFIDColumnInCopyFields )
+    {
+        if( iCol >= anCopyColumnOIDs.size() ||
+            (anCopyColumnOIDs[iCol] != INT4OID &&
+             anCopyColumnOIDs[iCol] != INT8OID) )
+            return FALSE;
+        iCol++;
+        nFIDIndex = poFeatureDefn->GetFieldIndex( pszFIDColumn );
+    }
+
+    for( int i = 0; i < poFeatureDefn->GetFieldCount(); i++ )
+    {
+        if( i == nFIDIndex )
+            continue;
+        if( iCol >= anCopyColumnOIDs.size() )
+            return FALSE;
+        const Oid nOID = anCopyColumnOIDs[iCol++];
+        bool bOK = false;
+        switch( poFeatureDefn->GetFieldDefn(i)->GetType() )
+        {
+            case OFTInteger:
+                bOK = nOID == BOOLOID || nOID == INT2OID || nOID == INT4OID ||
+                      nOID == INT8OID || nOID == FLOAT4OID ||
+                      nOID == FLOAT8OID || nOID == NUMERICOID ||
+                      OGRPGIsCopyTextOID(nOID);
+                break;
+            case OFTInteger64:
+                bOK = nOID == INT8OID || nOID == FLOAT8OID ||
+                      nOID == NUMERICOID || OGRPGIsCopyTextOID(nOID);
+                break;
+            case OFTReal:
+                bOK = nOID == FLOAT4OID || nOID == FLOAT8OID ||
+                      nOID == NUMERICOID || OGRPGIsCopyTextOID(nOID);
+                break;
+            case OFTString:
+                bOK = OGRPGIsCopyTextOID(nOID);
+                break;
+            case OFTDate:
+                bOK = nOID == DATEOID || OGRPGIsCopyTextOID(nOID) ||
+                      (nOID == TIMESTAMPOID && bInt8Time);
+                break;
+            case OFTTime:
+                bOK = OGRPGIsCopyTextOID(nOID) || (nOID == TIMEOID && bInt8Time);
+                break;
+            case OFTDateTime:
+                bOK = OGRPGIsCopyTextOID(nOID) ||
+                      ((nOID == TIMESTAMPOID || nOID == TIMESTAMPTZOID) &&
+                       bInt8Time);
+                break;
+            case OFTBinary:
+                bOK = nOID == BYTEAOID;
+                break;
+            case OFTIntegerList:
+                bOK = nOID == BOOLARRAYOID || nOID == INT2ARRAYOID ||
+                      nOID == INT4ARRAYOID || nOID == INT8ARRAYOID;
+                break;
+            case OFTInteger64List:
+                bOK = nOID == INT8ARRAYOID;
+                break;
+            case OFTRealList:
+                bOK = nOID == FLOAT4ARRAYOID || nOID == FLOAT8ARRAYOID;
+                break;
+            case OFTStringList:
+                bOK = nOID == TEXTARRAYOID || nOID == BPCHARARRAYOID ||
+                      nOID == VARCHARARRAYOID;
+                break;
+            default:
+                break;
+        }
+        if( !bOK )
+        {
+            CPLDebug("PG", "Cannot use binary COPY for column %s of type %u",
+                     poFeatureDefn->GetFieldDefn(i)->GetNameRef(), nOID);
+            return FALSE;
+        }
+    }
+
+    return iCol == anCopyColumnOIDs.size();
+}
+
+/************************************************************************/
+/*                      AppendCopyBinaryGeometry()                      */
+/*                                                                      */
+/*      Append a geometry as EWKB, which is what geometry_recv() and    */
+/*      geography_recv() expect. Features whose geometry is still in   */
+/*      WKB form get it passed through when it already has the right   */
+/*      type and dimension.                                             */
+/************************************************************************/
+
+int OGRPGTableLayer::AppendCopyBinaryGeometry( OGRFeature *poFeature,
+                                               int iGeomField,
+                                               CPLString& osBuffer )
+{
+    OGRPGGeomFieldDefn* poGeomFieldDefn =
+        poFeatureDefn->myGetGeomFieldDefn(iGeomField);
+
+    size_t nWKBSize = 0;
+    const GByte* pabyWKB = poFeature->GetGeomFieldWKBRef(iGeomField, &nWKBSize);
+    GByte* pabyWKBToFree = NULL;
+    if( pabyWKB != NULL )
+    {
+        OGRwkbGeometryType eType = wkbUnknown;
+        const OGRwkbGeometryType eFieldType = poGeomFieldDefn->GetType();
+        const bool bPassThrough =
+            poGeomFieldDefn->ePostgisType != GEOM_TYPE_WKB &&
+            (poDS->sPostGISVersion.nMajor > 2 ||
+             (poDS->sPostGISVersion.nMajor == 2 &&
+              poDS->sPostGISVersion.nMinor >= 2)) &&
+            nWKBSize > 5 &&
+            OGRReadWKBGeometryType( pabyWKB, wkbVariantIso,
+                                    &eType ) == OGRERR_NONE &&
+            CPL_TO_BOOL(wkbHasZ(eType)) ==
+                ((poGeomFieldDefn->GeometryTypeFlags &
+                  OGRGeometry::OGR_G_3D) != 0) &&
+            CPL_TO_BOOL(wkbHasM(eType)) ==
+                ((poGeomFieldDefn->GeometryTypeFlags &
+                  OGRGeometry::OGR_G_MEASURED) != 0) &&
+            (wkbFlatten(eFieldType) == wkbUnknown ||
+             wkbFlatten(eFieldType) == wkbFlatten(eType));
+        if( !bPassThrough )
+            pabyWKB = NULL;
+    }
+
+    if( pabyWKB == NULL )
+    {
+        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(iGeomField);
+        if( poGeom == NULL )
+        {
+            OGRPGAppendInt32( osBuffer, -1 );
+            return TRUE;
+        }
+
+        CheckGeomTypeCompatibility(iGeomField, poGeom);
+
+        poGeom->closeRings();
+        poGeom->set3D(poGeomFieldDefn->GeometryTypeFlags & OGRGeometry::OGR_G_3D);
+        poGeom->setMeasured(poGeomFieldDefn->GeometryTypeFlags & OGRGeometry::OGR_G_MEASURED);
+
+        /* Same variants as GeometryToBYTEA() and OGRGeometryToHexEWKB() */
+        OGRwkbVariant eWkbVariant = (poDS->sPostGISVersion.nMajor < 2) ?
+                                    wkbVariantPostGIS1 : wkbVariantOldOgc;
+        if( poGeomFieldDefn->ePostgisType != GEOM_TYPE_WKB &&
+            (poDS->sPostGISVersion.nMajor > 2 ||
+             (poDS->sPostGISVersion.nMajor == 2 &&
+              poDS->sPostGISVersion.nMinor >= 2)) &&
+            wkbFlatten(poGeom->getGeometryType()) == wkbPoint &&
+            poGeom->IsEmpty() )
+        {
+            eWkbVariant = wkbVariantIso;
+        }
+        nWKBSize = poGeom->WkbSize();
+        pabyWKBToFree = static_cast<GByte*>(VSI_MALLOC_VERBOSE(nWKBSize));
+        if( pabyWKBToFree == NULL ||
+            poGeom->exportToWkb( wkbNDR, pabyWKBToFree,
+                                 eWkbVariant ) != OGRERR_NONE )
+        {
+            CPLFree( pabyWKBToFree );
+            OGRPGAppendInt32( osBuffer, -1 );
+            return TRUE;
+        }
+        pabyWKB = pabyWKBToFree;
+    }
+
+    if( poGeomFieldDefn->ePostgisType == GEOM_TYPE_WKB ||
+        poGeomFieldDefn->nSRSId <= 0 )
+    {
+        OGRPGAppendCopyValue( osBuffer, pabyWKB, static_cast<int>(nWKBSize) );
+    }
+    else
+    {
+        /* Insert the SRID after the geometry type, in the byte order */
+        /* of the WKB */
+        const OGRwkbByteOrder eByteOrder =
+            (pabyWKB[0] == 0) ? wkbXDR : wkbNDR;
+        const bool bSwap = OGR_SWAP( eByteOrder );
+        GUInt32 nGeomType;
+        memcpy( &nGeomType, pabyWKB + 1, 4 );
+        GUInt32 nSRID = static_cast<GUInt32>(poGeomFieldDefn->nSRSId);
+        if( bSwap )
+        {
+            nGeomType = CPL_SWAP32(nGeomType) | 0x20000000;
+            nGeomType = CPL_SWAP32(nGeomType);
+            nSRID = CPL_SWAP32(nSRID);
+        }
+        else
+            nGeomType |= 0x20000000;
+
+        OGRPGAppendInt32( osBuffer, static_cast<GInt32>(nWKBSize + 4) );
+        osBuffer.append( reinterpret_cast<const char*>(pabyWKB), 1 );
+        osBuffer.append( reinterpret_cast<const char*>(&nGeomType), 4 );
+        osBuffer.append( reinterpret_cast<const char*>(&nSRID), 4 );
+        osBuffer.append( reinterpret_cast<const char*>(pabyWKB) + 5,
+                         nWKBSize - 5 );
+    }
+
+    CPLFree( pabyWKBToFree );
+    return TRUE;
+}
+
+/************************************************************************/
+/*                       AppendCopyBinaryRecord()                       */
+/*                                                                      */
+/*      Append a feature in the binary COPY format. Returns FALSE if    */
+/*      one of its values cannot be encoded, in which case the text     */
+/*      format must be used.                                            */
+/************************************************************************/
+
+int OGRPGTableLayer::AppendCopyBinaryRecord( OGRFeature *poFeature,
+                                             CPLString& osBuffer )
+{
+    OGRPGAppendInt16( osBuffer,
+                      static_cast<GInt16>(anCopyColumnOIDs.size()) );
+
+    size_t iCol = 0;
+    for( int i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++, iCol++ )
+    {
+        if( !AppendCopyBinaryGeometry( poFeature, i, osBuffer ) )
+            return FALSE;
+    }
+
+    int nFIDIndex = -1;
+    if( bFIDColumnInCopyFields )
+    {
+        nFIDIndex = poFeatureDefn->GetFieldIndex( pszFIDColumn );
+        const GIntBig nFID = poFeature->GetFID();
+        if( nFID == OGRNullFID )
+            OGRPGAppendInt32( osBuffer, -1 );
+        else if( anCopyColumnOIDs[iCol] == INT8OID )
+        {
+            OGRPGAppendInt32( osBuffer, 8 );
+            OGRPGAppendInt64( osBuffer, nFID );
+        }
+        else if( nFID >= INT_MIN && nFID <= INT_MAX )
+        {
+            OGRPGAppendInt32( osBuffer, 4 );
+            OGRPGAppendInt32( osBuffer, static_cast<GInt32>(nFID) );
+        }
+        else
+            return FALSE;
+        iCol++;
+    }
+
+    const int nFieldCount = poFeatureDefn->GetFieldCount();
+    for( int i = 0; i < nFieldCount; i++ )
+    {
+        if( i == nFIDIndex )
+            continue;
+
+        const Oid nOID = anCopyColumnOIDs[iCol++];
+        if( !poFeature->IsFieldSetAndNotNull( i ) )
+        {
+            OGRPGAppendInt32( osBuffer, -1 );
+            continue;
+        }
+
+        OGRFieldDefn* poFieldDefn = poFeatureDefn->GetFieldDefn(i);
+        const OGRFieldType eType = poFieldDefn->GetType();
+
+        if( OGRPGIsCopyTextOID(nOID) )
+        {
+            const char* pszStrValue = poFeature->GetFieldAsString(i);
+            size_t nLen = strlen(pszStrValue);
+            /* Truncate to the field width in characters, as in the text */
+            /* format */
+            const int nMaxWidth = poFieldDefn->GetWidth();
+            if( nMaxWidth > 0 && eType != OFTInteger &&
+                eType != OFTInteger64 && eType != OFTReal )
+            {
+                int iUTFChar = 0;
+                for( size_t iChar = 0; iChar < nLen; iChar++ )
+                {
+                    if( (pszStrValue[iChar] & 0xc0) != 0x80 )
+                    {
+                        if( iUTFChar == nMaxWidth )
+                        {
+                            CPLDebug( "PG",
+                                      "Truncated %s field value, it was too long.",
+                                      poFieldDefn->GetNameRef() );
+                            nLen = iChar;
+                            break;
+                        }
+                        iUTFChar++;
+                    }
+                }
+            }
+            OGRPGAppendCopyValue( osBuffer, pszStrValue,
+                                  static_cast<int>(nLen) );
+            continue;
+        }
+
+        switch( nOID )
+        {
+            case BOOLOID:
+            {
+                const char chVal = poFeature->GetFieldAsInteger(i) != 0;
+                OGRPGAppendCopyValue( osBuffer, &chVal, 1 );
+                break;
+            }
+
+            case INT2OID:
+            {
+                const int nVal = poFeature->GetFieldAsInteger(i);
+                if( nVal < -32768 || nVal > 32767 )
+                    return FALSE;
+                OGRPGAppendInt32( osBuffer, 2 );
+                OGRPGAppendInt16( osBuffer, static_cast<GInt16>(nVal) );
+                break;
+            }
+
+            case INT4OID:
+                OGRPGAppendInt32( osBuffer, 4 );
+                OGRPGAppendInt32( osBuffer, poFeature->GetFieldAsInteger(i) );
+                break;
+
+            case INT8OID:
+                OGRPGAppendInt32( osBuffer, 8 );
+                OGRPGAppendInt64( osBuffer,
+                                  poFeature->GetFieldAsInteger64(i) );
+                break;
+
+            case FLOAT4OID:
+            {
+                float fVal = static_cast<float>(poFeature->GetFieldAsDouble(i));
+                CPL_MSBPTR32( &fVal );
+                OGRPGAppendCopyValue( osBuffer, &fVal, 4 );
+                break;
+            }
+
+            case FLOAT8OID:
+            {
+                double dfVal = poFeature->GetFieldAsDouble(i);
+                CPL_MSBPTR64( &dfVal );
+                OGRPGAppendCopyValue( osBuffer, &dfVal, 8 );
+                break;
+            }
+
+            case NUMERICOID:
+            {
+                if( eType == OFTReal &&
+                    CPLIsInf(poFeature->GetFieldAsDouble(i)) )
+                    return FALSE;
+                if( !OGRPGAppendBinaryNumeric( osBuffer,
+                                        poFeature->GetFieldAsString(i)) )
+                    return FALSE;
+                break;
+            }
+
+            case BYTEAOID:
+            {
+                int nLen = 0;
+                const GByte* pabyData = poFeature->GetFieldAsBinary(i, &nLen);
+                OGRPGAppendCopyValue( osBuffer, pabyData, nLen );
+                break;
+            }
+
+            case DATEOID:
+            case TIMEOID:
+            case TIMESTAMPOID:
+            case TIMESTAMPTZOID:
+            {
+                int nYear = 0, nMonth = 0, nDay = 0, nHour = 0, nMinute = 0;
+                int nTZFlag = 0;
+                float fSecond = 0.0f;
+                poFeature->GetFieldAsDateTime( i, &nYear, &nMonth, &nDay,
+                                               &nHour, &nMinute, &fSecond,
+                                               &nTZFlag );
+                if( nOID == TIMEOID )
+                {
+                    OGRPGAppendInt32( osBuffer, 8 );
+                    OGRPGAppendInt64( osBuffer,
+                        OGRPGTimeToUSecs(nHour, nMinute, fSecond) );
+                    break;
+                }
+
+                const int nDays = OGRPGDate2J(nYear, nMonth, nDay) -
+                                  POSTGRES_EPOCH_JDATE;
+                if( nOID == DATEOID )
+                {
+                    OGRPGAppendInt32( osBuffer, 4 );
+                    OGRPGAppendInt32( osBuffer, nDays );
+                    break;
+                }
+
+                GIntBig nUSecs = nDays * USECS_PER_DAY;
+                if( eType == OFTDateTime )
+                    nUSecs += OGRPGTimeToUSecs(nHour, nMinute, fSecond);
+                if( nOID == TIMESTAMPTZOID )
+                {
+                    /* Values without time zone, or in local time, are */
+                    /* interpreted by the server in the session time zone */
+                    if( nTZFlag < 100 )
+                        return FALSE;
+                    nUSecs -= static_cast<GIntBig>(nTZFlag - 100) * 15 * 60 *
+                              1000000;
+                }
+                OGRPGAppendInt32( osBuffer, 8 );
+                OGRPGAppendInt64( osBuffer, nUSecs );
+                break;
+            }
+
+            case BOOLARRAYOID:
+            case INT2ARRAYOID:
+            case INT4ARRAYOID:
+            case INT8ARRAYOID:
+            case FLOAT4ARRAYOID:
+            case FLOAT8ARRAYOID:
+            case TEXTARRAYOID:
+            case BPCHARARRAYOID:
+            case VARCHARARRAYOID:
+            {
+                int nCount = 0;
+                const int* panInt = NULL;
+                const GIntBig* panInt64 = NULL;
+                const double* padfReal = NULL;
+                char** papszStr = NULL;
+                if( eType == OFTIntegerList )
+                    panInt = poFeature->GetFieldAsIntegerList(i, &nCount);
+                else if( eType == OFTInteger64List )
+                    panInt64 = poFeature->GetFieldAsInteger64List(i, &nCount);
+                else if( eType == OFTRealList )
+                    padfReal = poFeature->GetFieldAsDoubleList(i, &nCount);
+                else
+                {
+                    papszStr = poFeature->GetFieldAsStringList(i);
+                    nCount = CSLCount(papszStr);
+                }
+
+                const size_t nOffset = OGRPGBeginCopyValue( osBuffer );
+                OGRPGAppendInt32( osBuffer, nCount > 0 ? 1 : 0 ); /* ndim */
+                OGRPGAppendInt32( osBuffer, 0 ); /* no NULL */
+                OGRPGAppendInt32( osBuffer,
+                    static_cast<GInt32>(OGRPGGetCopyArrayElementOID(nOID)) );
+                if( nCount > 0 )
+                {
+                    OGRPGAppendInt32( osBuffer, nCount );
+                    OGRPGAppendInt32( osBuffer, 1 ); /* lower bound */
+                }
+                for( int j = 0; j < nCount; j++ )
+                {
+                    if( nOID == BOOLARRAYOID )
+                    {
+                        const char chVal = panInt[j] != 0;
+                        OGRPGAppendCopyValue( osBuffer, &chVal, 1 );
+                    }
+                    else if( nOID == INT2ARRAYOID )
+                    {
+                        if( panInt[j] < -32768 || panInt[j] > 32767 )
+                            return FALSE;
+                        OGRPGAppendInt32( osBuffer, 2 );
+                        OGRPGAppendInt16( osBuffer,
+                                          static_cast<GInt16>(panInt[j]) );
+                    }
+                    else if( nOID == INT4ARRAYOID )
+                    {
+                        OGRPGAppendInt32( osBuffer, 4 );
+                        OGRPGAppendInt32( osBuffer, panInt[j] );
+                    }
+                    else if( nOID == INT8ARRAYOID )
+                    {
+                        OGRPGAppendInt32( osBuffer, 8 );
+                        OGRPGAppendInt64( osBuffer, panInt64 ? panInt64[j] :
+                                                                panInt[j] );
+                    }
+                    else if( nOID == FLOAT4ARRAYOID )
+                    {
+                        float fVal = static_cast<float>(padfReal[j]);
+                        CPL_MSBPTR32( &fVal );
+                        OGRPGAppendCopyValue( osBuffer, &fVal, 4 );
+                    }
+                    else if( nOID == FLOAT8ARRAYOID )
+                    {
+                        double dfVal = padfReal[j];
+                        CPL_MSBPTR64( &dfVal );
+                        OGRPGAppendCopyValue( osBuffer, &dfVal, 8 );
+                    }
+                    else
+                    {
+                        OGRPGAppendCopyValue( osBuffer, papszStr[j],
+                            static_cast<int>(strlen(papszStr[j])) );
+                    }
+                }
+                OGRPGEndCopyValue( osBuffer, nOffset );
+                break;
+            }
+
+            default:
+                return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                        CreateFeatureViaCopy()                        */
 /************************************************************************/
@@ -1914,6 +2707,19 @@ OGRErr OGRPGTableLayer::CreateFeatureViaCopy( OGRFeature *poFeature )
     /* Tell the datasource we are now planning to copy data */
     poDS->StartCopy( this );
 
+    if( bCopyBinary )
+    {
+        if( AppendCopyBinaryRecord( poFeature, osCommand ) )
+            return PutCopyData( osCommand );
+
+        /* Carry on in text format with the values that we cannot encode */
+        CPLDebug("PG", "Switching to text COPY for table %s", pszSqlTableName);
+        bCopyBinaryFailed = TRUE;
+        poDS->EndCopy();
+        poDS->StartCopy( this );
+        osCommand.clear();
+    }
+
     /* First process geometry */
     for( i = 0; i < poFeatureDefn->GetGeomFieldCount(); i++ )
     {
@@ -1964,16 +2770,23 @@ OGRErr OGRPGTableLayer::CreateFeatureViaCopy( OGRFeature *poFeature )
     /* Add end of line marker */
     osCommand += "\n";
 
-    /* ------------------------------------------------------------ */
-    /*      Execute the copy.                                       */
-    /* ------------------------------------------------------------ */
+    return PutCopyData( osCommand );
+}
+
+/************************************************************************/
+/*                            PutCopyData()                             */
+/************************************************************************/
 
+OGRErr OGRPGTableLayer::PutCopyData( const CPLString& osData )
+{
+    PGconn *hPGConn = poDS->GetPGConn();
     OGRErr result = OGRERR_NONE;
 
-    int copyResult = PQputCopyData(hPGConn, osCommand.c_str(),
-                                   static_cast<int>(osCommand.size()));
+    int copyResult = PQputCopyData(hPGConn, osData.c_str(),
+                                   static_cast<int>(osData.size()));
 #ifdef DEBUG_VERBOSE
-    CPLDebug("PG", "PQputCopyData(%s)", osCommand.c_str());
+    if( !bCopyBinary )
+        CPLDebug("PG", "PQputCopyData(%s)", osData.c_str());
 #endif
 
     switch (copyResult)
@@ -2473,6 +3286,9 @@ OGRErr OGRPGTableLayer::AlterFieldDefn( int iField, OGRFieldDefn* poNewFieldDefn
     OGRFieldDefn       *poFieldDefn = poFeatureDefn->GetFieldDefn(iField);
     OGRFieldDefn        oField( poNewFieldDefn );
 
+    /* Column types may change without the column list changing */
+    oMapColumnTypeOIDs.clear();
+
     poDS->SoftStartTransaction();
 
     if (!(nFlagsIn & ALTER_TYPE_FLAG))
@@ -2670,10 +3486,10 @@ OGRFeature *OGRPGTableLayer::GetFeature( GIntBig nFeatureId )
     OGRFeature  *poFeature = NULL;
     PGresult    *hResult = NULL;
     PGconn      *hPGConn = poDS->GetPGConn();
+    poDS->EndCopy();
     CPLString    osFieldList = BuildFields();
     CPLString    osCommand;
 
-    poDS->EndCopy();
     poDS->SoftStartTransaction();
 
     osCommand.Printf(
@@ -2867,11 +3683,22 @@ OGRErr OGRPGTableLayer::StartCopy()
 
     CPLString osFields = BuildCopyFields();
 
+    /* Use the binary format when we know how to encode values for all */
+    /* the column types */
+    bCopyBinary = FALSE;
+    if( !bCopyBinaryFailed &&
+        CPLTestBool(CPLGetConfigOption("PG_USE_COPY_BINARY", "NO")) )
+    {
+        anCopyColumnOIDs = GetColumnTypeOIDs(osFields);
+        bCopyBinary = CanUseCopyBinary();
+    }
+
     size_t size = osFields.size() +  strlen(pszSqlTableName) + 100;
     char *pszCommand = (char *) CPLMalloc(size);
 
     snprintf( pszCommand, size,
-             "COPY %s (%s) FROM STDIN;",
+             bCopyBinary ? "COPY %s (%s) FROM STDIN WITH BINARY;" :
+                           "COPY %s (%s) FROM STDIN;",
              pszSqlTableName, osFields.c_str() );
 
     PGconn *hPGConn = poDS->GetPGConn();
@@ -2883,8 +3710,20 @@ OGRErr OGRPGTableLayer::StartCopy()
                   "%s", PQerrorMessage(hPGConn) );
     }
     else
+    {
         bCopyActive = TRUE;
 
+        if( bCopyBinary )
+        {
+            /* Signature, flags and header extension length */
+            CPLString osHeader;
+            osHeader.append("PGCOPY\n\377\r\n\0", 11);
+            osHeader.append(8, '\0');
+            PQputCopyData(hPGConn, osHeader.c_str(),
+                          static_cast<int>(osHeader.size()));
+        }
+    }
+
     OGRPGClearResult( hResult );
     CPLFree( pszCommand );
 
@@ -2907,6 +3746,14 @@ OGRErr OGRPGTableLayer::EndCopy()
     OGRErr result = OGRERR_NONE;
 
     PGconn *hPGConn = poDS->GetPGConn();
+
+    if( bCopyBinary )
+    {
+        /* File trailer */
+        const char achTrailer[2] = { '\377', '\377' };
+        PQputCopyData(hPGConn, achTrailer, 2);
+    }
+
     CPLDebug( "PG", "PQputCopyEnd()" );
 
     bCopyActive = FALSE;
@@ -36,6 +36,7 @@
 #include "shapefil.h"
 #include "shp_vsi.h"
 #include "ogrlayerpool.h"
+#include "cpl_virtualmem.h"
 #include <vector>
 
 /* Was limited to 255 until OGR 1.10, but 254 seems to be a more */
@@ -44,13 +45,94 @@
 /* #5052 ) */
 #define OGR_DBF_MAX_FIELD_WIDTH 254
 
+/************************************************************************/
+/*                          OGRShapeMappedSHP                           */
+/*                                                                      */
+/*      Read-only memory mapping of a .shp file.  Geometries are built  */
+/*      directly from the bytes of the mapped records, without going    */
+/*      through an intermediate SHPObject.                              */
+/************************************************************************/
+
+class OGRShapeMappedSHP
+{
+    CPLVirtualMem      *m_psMapping;
+    const GByte        *m_pabyData;
+    size_t              m_nSize;
+
+    // Scratch list of the parts of the record being read, kept across
+    // calls to avoid an allocation per record.
+    mutable std::vector<OGRGeometry *> m_apoParts;
+
+    explicit            OGRShapeMappedSHP( CPLVirtualMem *psMapping );
+
+    const GByte        *GetRecord( SHPHandle hSHP, int iShape,
+                                   int *pnContentSize ) const;
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRShapeMappedSHP)
+
+  public:
+                        ~OGRShapeMappedSHP();
+
+    static OGRShapeMappedSHP *Create( SHPHandle hSHP );
+
+    bool                GetBounds( SHPHandle hSHP, int iShape,
+                                   int *pnSHPType,
+                                   OGREnvelope *psEnvelope ) const;
+    bool                ReadGeometry( SHPHandle hSHP, int iShape,
+                                      OGRGeometry **ppoGeom ) const;
+};
+
+/************************************************************************/
+/*                         OGRShapeHilbertRTree                         */
+/*                                                                      */
+/*      Packed R-tree (.hrt file) whose leaves are the shapes sorted    */
+/*      along a Hilbert curve.  See ogrshapertree.cpp for the format.   */
+/************************************************************************/
+
+class OGRShapeHilbertRTree
+{
+    VSILFILE           *m_fp;
+    CPLVirtualMem      *m_psMapping;
+    const GByte        *m_pabyItems;
+    int                 m_nNodeSize;
+    int                 m_nItemCount;
+    int                 m_nShapeCount;
+    std::vector<int>    m_anLevelStart;
+    std::vector<int>    m_anLevelCount;
+    std::vector<GByte>  m_abyBuffer;
+
+                        OGRShapeHilbertRTree();
+
+    const GByte        *GetItems( int iFirst, int nCount );
+
+    CPL_DISALLOW_COPY_ASSIGN(OGRShapeHilbertRTree)
+
+  public:
+                        ~OGRShapeHilbertRTree();
+
+    static OGRShapeHilbertRTree *Open( const char *pszFilename );
+    static bool         Create( SHPHandle hSHP, const char *pszFilename,
+                                int nNodeSize );
+
+    int                 GetShapeCount() const { return m_nShapeCount; }
+    int                *Search( const OGREnvelope& sEnvelope, int *pnCount );
+};
+
 /* ==================================================================== */
 /*      Functions from Shape2ogr.cpp.                                   */
 /* ==================================================================== */
 OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                                OGRFeatureDefn * poDefn, int iShape,
-                               SHPObject *psShape, const char *pszSHPEncoding );
+                               SHPObject *psShape, const char *pszSHPEncoding,
+                               const OGRShapeMappedSHP *poMappedSHP = NULL );
 OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape );
+OGRGeometry *SHPReadOGRFeatureGeometry( SHPHandle hSHP,
+                                        OGRFeatureDefn * poDefn, int iShape,
+                                        SHPObject *psShape,
+                                        const OGRShapeMappedSHP *poMappedSHP = NULL );
+void DBFReadOGRFieldsToBatch( DBFHandle hDBF, OGRFeatureDefn * poDefn,
+                              int iShape, const char *pszSHPEncoding,
+                              OGRFeatureBatch *poBatch );
 OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
                                        SHPHandle hSHP, DBFHandle hDBF,
                                        const char *pszSHPEncoding,
@@ -136,6 +218,15 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
 
     bool                bSbnSbxDeleted;
 
+    bool                bCheckedForHRT;
+    OGRShapeHilbertRTree *poHRT;
+    bool                CheckForHRT();
+    bool                m_bAutoSpatialIndex;
+
+    bool                m_bCheckedMappedSHP;
+    OGRShapeMappedSHP  *m_poMappedSHP;
+    const OGRShapeMappedSHP *GetMappedSHP();
+
     CPLString           ConvertCodePage( const char * );
     CPLString           osEncoding;
 
@@ -182,6 +273,7 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
 
   public:
     OGRErr              CreateSpatialIndex( int nMaxDepth );
+    OGRErr              CreateHilbertRTree( int nNodeSize );
     OGRErr              DropSpatialIndex();
     OGRErr              Repack();
     OGRErr              RecomputeExtent();
@@ -207,6 +299,8 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
 
     void                ResetReading() override;
     OGRFeature *        GetNextFeature() override;
+    int                 GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                             int nMaxFeatures ) override;
     virtual OGRErr      SetNextByIndex( GIntBig nIndex ) override;
 
     OGRFeature         *GetFeature( GIntBig nFeatureId ) override;
@@ -243,6 +337,8 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
         { bCreateSpatialIndexAtClose = CPL_TO_BOOL(bFlag); }
     void                SetModificationDate( const char* pszStr );
     void                SetAutoRepack(bool b) { m_bAutoRepack = b; }
+    void                SetAutoSpatialIndex(bool b)
+        { m_bAutoSpatialIndex = b; }
     void                SetWriteDBFEOFChar(bool b);
 };
 
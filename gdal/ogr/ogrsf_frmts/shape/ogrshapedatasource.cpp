@@ -407,6 +407,8 @@ bool OGRShapeDataSource::OpenFile( const char *pszNewName, bool bUpdate )
         CSLFetchNameValue( papszOpenOptions, "DBF_DATE_LAST_UPDATE" ) );
     poLayer->SetAutoRepack(
         CPLFetchBool( papszOpenOptions, "AUTO_REPACK", true ) );
+    poLayer->SetAutoSpatialIndex(
+        CPLFetchBool( papszOpenOptions, "AUTO_SPATIAL_INDEX", false ) );
     poLayer->SetWriteDBFEOFChar(
         CPLFetchBool( papszOpenOptions, "DBF_EOF_CHAR", true ) );
 
@@ -949,6 +951,7 @@ OGRLayer *OGRShapeDataSource::GetLayerByName( const char * pszLayerNameIn )
 /*      SPATIAL INDEX commands.  Support forms are:                     */
 /*                                                                      */
 /*        CREATE SPATIAL INDEX ON layer_name [DEPTH n]                  */
+/*        CREATE SPATIAL INDEX ON layer_name USING HRT [NODE_SIZE n]    */
 /*        DROP SPATIAL INDEX ON layer_name                              */
 /*        REPACK layer_name                                             */
 /*        RECOMPUTE EXTENT ON layer_name                                */
@@ -1080,24 +1083,37 @@ OGRLayer * OGRShapeDataSource::ExecuteSQL( const char *pszStatement,
         || !EQUAL(papszTokens[1],"SPATIAL")
         || !EQUAL(papszTokens[2],"INDEX")
         || !EQUAL(papszTokens[3],"ON")
-        || CSLCount(papszTokens) > 7
-        || (CSLCount(papszTokens) == 7 && !EQUAL(papszTokens[5],"DEPTH")) )
+        || CSLCount(papszTokens) > 9
+        || CSLCount(papszTokens) == 6
+        || (CSLCount(papszTokens) == 7 && !EQUAL(papszTokens[5],"DEPTH")
+            && !(EQUAL(papszTokens[5],"USING")
+                 && EQUAL(papszTokens[6],"HRT")))
+        || (CSLCount(papszTokens) == 8)
+        || (CSLCount(papszTokens) == 9
+            && !(EQUAL(papszTokens[5],"USING")
+                 && EQUAL(papszTokens[6],"HRT")
+                 && EQUAL(papszTokens[7],"NODE_SIZE"))) )
     {
         CSLDestroy( papszTokens );
         CPLError( CE_Failure, CPLE_AppDefined,
                   "Syntax error in CREATE SPATIAL INDEX command.\n"
                   "Was '%s'\n"
                   "Should be of form 'CREATE SPATIAL INDEX ON <table> "
-                  "[DEPTH <n>]'",
+                  "[DEPTH <n>]' or 'CREATE SPATIAL INDEX ON <table> "
+                  "USING HRT [NODE_SIZE <n>]'",
                   pszStatement );
         return NULL;
     }
 
 /* -------------------------------------------------------------------- */
-/*      Get depth if provided.                                          */
+/*      Get depth or node size if provided.                             */
 /* -------------------------------------------------------------------- */
+    const bool bHRT =
+        CSLCount(papszTokens) >= 7 && EQUAL(papszTokens[5],"USING");
     const int nDepth =
-        CSLCount(papszTokens) == 7 ? atoi(papszTokens[6]) : 0;
+        CSLCount(papszTokens) == 7 && !bHRT ? atoi(papszTokens[6]) : 0;
+    const int nNodeSize =
+        CSLCount(papszTokens) == 9 ? atoi(papszTokens[8]) : 0;
 
 /* -------------------------------------------------------------------- */
 /*      What layer are we operating on.                                 */
@@ -1116,7 +1132,10 @@ OGRLayer * OGRShapeDataSource::ExecuteSQL( const char *pszStatement,
 
     CSLDestroy( papszTokens );
 
-    poLayer->CreateSpatialIndex( nDepth );
+    if( bHRT )
+        poLayer->CreateHilbertRTree( nNodeSize );
+    else
+        poLayer->CreateSpatialIndex( nDepth );
     return NULL;
 }
 
@@ -1167,6 +1186,7 @@ OGRErr OGRShapeDataSource::DeleteLayer( int iLayer )
     VSIUnlink( CPLResetExtension(pszFilename, "dbf") );
     VSIUnlink( CPLResetExtension(pszFilename, "prj") );
     VSIUnlink( CPLResetExtension(pszFilename, "qix") );
+    VSIUnlink( CPLResetExtension(pszFilename, "hrt") );
 
     CPLFree( pszFilename );
 
@@ -211,7 +211,7 @@ static CPLErr OGRShapeDriverDelete( const char *pszDataSource )
 
     static const char * const apszExtensions[] =
         { "shp", "shx", "dbf", "sbn", "sbx", "prj", "idm", "ind",
-          "qix", "cpg", NULL };
+          "qix", "hrt", "cpg", NULL };
 
     if( VSI_ISREG(sStatBuf.st_mode)
         && (EQUAL(CPLGetExtension(pszDataSource), "shp")
@@ -282,6 +282,7 @@ void RegisterOGRShape()
 "  </Option>"
 "  <Option name='AUTO_REPACK' type='boolean' description='Whether the shapefile should be automatically repacked when needed' default='YES'/>"
 "  <Option name='DBF_EOF_CHAR' type='boolean' description='Whether to write the 0x1A end-of-file character in DBF files' default='YES'/>"
+"  <Option name='AUTO_SPATIAL_INDEX' type='boolean' description='Whether to create a .hrt spatial index on the first spatial query of a layer opened read-only without spatial index' default='NO'/>"
 "</OpenOptionList>");
 
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST,
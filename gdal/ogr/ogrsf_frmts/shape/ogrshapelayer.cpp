@@ -73,6 +73,11 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
     bCheckedForSBN(false),
     hSBN(NULL),
     bSbnSbxDeleted(false),
+    bCheckedForHRT(false),
+    poHRT(NULL),
+    m_bAutoSpatialIndex(false),
+    m_bCheckedMappedSHP(false),
+    m_poMappedSHP(NULL),
     bTruncationWarningEmitted(false),
     bHSHPWasNonNULL(hSHPIn != NULL),
     bHDBFWasNonNULL(hDBFIn != NULL),
@@ -83,6 +88,8 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
     m_bAutoRepack(false),
     m_eNeedRepack(MAYBE)
 {
+    m_bAutoAttrIndex = true;
+
     if( hSHP != NULL )
     {
         nTotalShapeCount = hSHP->nRecords;
@@ -269,6 +276,8 @@ OGRShapeLayer::~OGRShapeLayer()
     if( hDBF != NULL )
         DBFClose( hDBF );
 
+    delete m_poMappedSHP;
+
     if( hSHP != NULL )
         SHPClose( hSHP );
 
@@ -277,6 +286,8 @@ OGRShapeLayer::~OGRShapeLayer()
 
     if( hSBN != NULL )
         SBNCloseDiskTree( hSBN );
+
+    delete poHRT;
 }
 
 /************************************************************************/
@@ -466,6 +477,40 @@ bool OGRShapeLayer::CheckForSBN()
     return hSBN != NULL;
 }
 
+/************************************************************************/
+/*                            CheckForHRT()                             */
+/************************************************************************/
+
+bool OGRShapeLayer::CheckForHRT()
+
+{
+    if( bCheckedForHRT )
+        return poHRT != NULL;
+
+    bCheckedForHRT = true;
+
+    if( hSHP == NULL )
+        return false;
+
+    const char *pszHRTFilename = CPLResetExtension( pszFullName, "hrt" );
+    VSIStatBufL sStat;
+    if( VSIStatExL( pszHRTFilename, &sStat, VSI_STAT_EXISTS_FLAG ) != 0 )
+        return false;
+
+    poHRT = OGRShapeHilbertRTree::Open( pszHRTFilename );
+
+    // An index built before shapes were appended would miss them.
+    if( poHRT != NULL && poHRT->GetShapeCount() != hSHP->nRecords )
+    {
+        CPLDebug( "SHAPE", "Ignoring %s: built for %d shapes, but layer has %d",
+                  pszHRTFilename, poHRT->GetShapeCount(), hSHP->nRecords );
+        delete poHRT;
+        poHRT = NULL;
+    }
+
+    return poHRT != NULL;
+}
+
 /************************************************************************/
 /*                            ScanIndices()                             */
 /*                                                                      */
@@ -529,16 +574,33 @@ bool OGRShapeLayer::ScanIndices()
 
     if( bTryQIXorSBN )
     {
-        if( !bCheckedForQIX )
+        if( !bCheckedForHRT )
+            CPL_IGNORE_RET_VAL(CheckForHRT());
+        if( poHRT == NULL && !bCheckedForQIX )
             CPL_IGNORE_RET_VAL(CheckForQIX());
-        if( hQIX == NULL && !bCheckedForSBN )
+        if( poHRT == NULL && hQIX == NULL && !bCheckedForSBN )
             CPL_IGNORE_RET_VAL(CheckForSBN());
+
+/* -------------------------------------------------------------------- */
+/*      Build a .hrt index on the first spatial query if asked to.      */
+/* -------------------------------------------------------------------- */
+        if( m_bAutoSpatialIndex && !bUpdateAccess && poHRT == NULL &&
+            hQIX == NULL && hSBN == NULL )
+        {
+            m_bAutoSpatialIndex = false;
+            CPLPushErrorHandler( CPLQuietErrorHandler );
+            if( CreateHilbertRTree( 0 ) != OGRERR_NONE )
+                CPLDebug( "SHAPE", "Cannot create .hrt index for %s: %s",
+                          pszFullName, CPLGetLastErrorMsg() );
+            CPLPopErrorHandler();
+            CPLErrorReset();
+        }
     }
 
 /* -------------------------------------------------------------------- */
 /*      Compute spatial index if appropriate.                           */
 /* -------------------------------------------------------------------- */
-    if( bTryQIXorSBN && (hQIX != NULL || hSBN != NULL) &&
+    if( bTryQIXorSBN && (poHRT != NULL || hQIX != NULL || hSBN != NULL) &&
         panSpatialFIDs == NULL )
     {
         double adfBoundsMin[4] = {
@@ -552,7 +614,10 @@ bool OGRShapeLayer::ScanIndices()
             0.0,
             0.0 };
 
-        if( hQIX != NULL )
+        if( poHRT != NULL )
+            panSpatialFIDs = poHRT->Search( oSpatialFilterEnvelope,
+                                            &nSpatialFIDCount );
+        else if( hQIX != NULL )
             panSpatialFIDs = SHPSearchDiskTreeEx( hQIX,
                                                   adfBoundsMin, adfBoundsMax,
                                                   &nSpatialFIDCount );
@@ -732,6 +797,30 @@ OGRErr OGRShapeLayer::SetNextByIndex( GIntBig nIndex )
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                            GetMappedSHP()                            */
+/*                                                                      */
+/*      Memory map the .shp file on first use if SHAPE_USE_MMAP=YES     */
+/*      and the layer is read-only, so that geometries are built        */
+/*      straight from the mapped records.                               */
+/************************************************************************/
+
+const OGRShapeMappedSHP *OGRShapeLayer::GetMappedSHP()
+{
+    if( !m_bCheckedMappedSHP )
+    {
+        m_bCheckedMappedSHP = true;
+        if( hSHP != NULL && !bUpdateAccess &&
+            CPLTestBool(CPLGetConfigOption("SHAPE_USE_MMAP", "NO")) )
+        {
+            m_poMappedSHP = OGRShapeMappedSHP::Create( hSHP );
+            CPLDebug( "Shape", "%s memory mapping of %s",
+                      m_poMappedSHP ? "Using" : "Cannot use", pszFullName );
+        }
+    }
+    return m_poMappedSHP;
+}
+
 /************************************************************************/
 /*                             FetchShape()                             */
 /*                                                                      */
@@ -743,8 +832,31 @@ OGRFeature *OGRShapeLayer::FetchShape( int iShapeId )
 
 {
     OGRFeature *poFeature = NULL;
-
-    if( m_poFilterGeom != NULL && hSHP != NULL )
+    const OGRShapeMappedSHP *poMappedSHP = GetMappedSHP();
+
+    int nSHPType = SHPT_NULL;
+    OGREnvelope sShapeEnv;
+    if( m_poFilterGeom != NULL && hSHP != NULL && poMappedSHP != NULL &&
+        poMappedSHP->GetBounds( hSHP, iShapeId, &nSHPType, &sShapeEnv ) )
+    {
+        // Same test as below, without reading the vertices.
+        if( nSHPType != SHPT_NULL
+            && (nSHPType == SHPT_POINT || nSHPType == SHPT_POINTZ
+                || nSHPType == SHPT_POINTM
+                || (sShapeEnv.MinX != sShapeEnv.MaxX
+                    && sShapeEnv.MinY != sShapeEnv.MaxY))
+            && (m_sFilterEnvelope.MaxX < sShapeEnv.MinX
+                || m_sFilterEnvelope.MaxY < sShapeEnv.MinY
+                || sShapeEnv.MaxX < m_sFilterEnvelope.MinX
+                || sShapeEnv.MaxY < m_sFilterEnvelope.MinY) )
+        {
+            return NULL;
+        }
+        poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
+                                       iShapeId, NULL, osEncoding,
+                                       poMappedSHP );
+    }
+    else if( m_poFilterGeom != NULL && hSHP != NULL )
     {
         SHPObject *psShape = SHPReadObject( hSHP, iShapeId );
 
@@ -778,7 +890,8 @@ OGRFeature *OGRShapeLayer::FetchShape( int iShapeId )
     else
     {
         poFeature = SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
-                                       iShapeId, NULL, osEncoding );
+                                       iShapeId, NULL, osEncoding,
+                                       poMappedSHP );
     }
 
     return poFeature;
@@ -820,9 +933,14 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
             }
 
             // Check the shape object's geometry, and if it matches
-            // any spatial filter, return it.
-            poFeature =
-                FetchShape(static_cast<int>(panMatchingFIDs[iMatchingFID]));
+            // any spatial filter, return it.  Attribute indexes built in
+            // memory may still reference deleted records.
+            const int iShape = static_cast<int>(panMatchingFIDs[iMatchingFID]);
+            if( hDBF != NULL && iShape >= 0 && iShape < hDBF->nRecords &&
+                DBFIsRecordDeleted( hDBF, iShape ) )
+                poFeature = NULL;
+            else
+                poFeature = FetchShape(iShape);
 
             iMatchingFID++;
         }
@@ -870,6 +988,143 @@ OGRFeature *OGRShapeLayer::GetNextFeature()
     }
 }
 
+/************************************************************************/
+/*                        GetNextFeatureBatch()                         */
+/************************************************************************/
+
+int OGRShapeLayer::GetNextFeatureBatch( OGRFeatureBatch *poBatch,
+                                        int nMaxFeatures )
+
+{
+    // Attribute filters need OGRFeature objects to be evaluated.
+    if( m_poAttrQuery != NULL )
+        return OGRLayer::GetNextFeatureBatch(poBatch, nMaxFeatures);
+
+    poBatch->Reset(poFeatureDefn);
+
+    if( !TouchLayer() )
+        return 0;
+
+    if( m_poFilterGeom != NULL && iNextShapeId == 0 &&
+        panMatchingFIDs == NULL )
+    {
+        ScanIndices();
+    }
+
+    const bool bGeometryIgnored =
+        CPL_TO_BOOL(poFeatureDefn->IsGeometryIgnored());
+
+    while( poBatch->GetFeatureCount() < nMaxFeatures )
+    {
+/* -------------------------------------------------------------------- */
+/*      Select the next shape, as in GetNextFeature().                  */
+/* -------------------------------------------------------------------- */
+        int iShape = 0;
+        if( panMatchingFIDs != NULL )
+        {
+            if( panMatchingFIDs[iMatchingFID] == OGRNullFID )
+                break;
+            iShape = static_cast<int>(panMatchingFIDs[iMatchingFID]);
+            iMatchingFID++;
+            if( iShape < 0
+                || (hSHP != NULL && iShape >= hSHP->nRecords)
+                || (hDBF != NULL && iShape >= hDBF->nRecords)
+                || (hDBF != NULL && DBFIsRecordDeleted(hDBF, iShape)) )
+            {
+                continue;
+            }
+        }
+        else
+        {
+            if( iNextShapeId >= nTotalShapeCount )
+                break;
+            if( hDBF )
+            {
+                if( DBFIsRecordDeleted( hDBF, iNextShapeId ) )
+                {
+                    iNextShapeId++;
+                    continue;
+                }
+                if( VSIFEofL(VSI_SHP_GetVSIL(hDBF->fp)) )
+                    break;  // I/O error.
+            }
+            iShape = iNextShapeId++;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Read the geometry if needed, and apply the spatial filter,      */
+/*      first on the bounding box of the shape, as in FetchShape().     */
+/* -------------------------------------------------------------------- */
+        OGRGeometry *poGeom = NULL;
+        const OGRShapeMappedSHP *poMappedSHP = GetMappedSHP();
+        int nSHPType = SHPT_NULL;
+        OGREnvelope sShapeEnv;
+        if( hSHP != NULL && (!bGeometryIgnored || m_poFilterGeom != NULL) )
+        {
+            SHPObject *psShape = NULL;
+            if( m_poFilterGeom != NULL && poMappedSHP != NULL &&
+                poMappedSHP->GetBounds( hSHP, iShape, &nSHPType,
+                                        &sShapeEnv ) )
+            {
+                if( nSHPType != SHPT_NULL
+                    && (nSHPType == SHPT_POINT || nSHPType == SHPT_POINTZ
+                        || nSHPType == SHPT_POINTM
+                        || (sShapeEnv.MinX != sShapeEnv.MaxX
+                            && sShapeEnv.MinY != sShapeEnv.MaxY))
+                    && (m_sFilterEnvelope.MaxX < sShapeEnv.MinX
+                        || m_sFilterEnvelope.MaxY < sShapeEnv.MinY
+                        || sShapeEnv.MaxX < m_sFilterEnvelope.MinX
+                        || sShapeEnv.MaxY < m_sFilterEnvelope.MinY) )
+                {
+                    continue;
+                }
+            }
+            else if( m_poFilterGeom != NULL )
+            {
+                psShape = SHPReadObject( hSHP, iShape );
+                if( psShape != NULL
+                    && (psShape->nSHPType == SHPT_POINT
+                        || psShape->nSHPType == SHPT_POINTZ
+                        || psShape->nSHPType == SHPT_POINTM
+                        || (psShape->dfXMin != psShape->dfXMax
+                            && psShape->dfYMin != psShape->dfYMax))
+                    && psShape->nSHPType != SHPT_NULL
+                    && (m_sFilterEnvelope.MaxX < psShape->dfXMin
+                        || m_sFilterEnvelope.MaxY < psShape->dfYMin
+                        || psShape->dfXMax < m_sFilterEnvelope.MinX
+                        || psShape->dfYMax < m_sFilterEnvelope.MinY) )
+                {
+                    SHPDestroyObject(psShape);
+                    continue;
+                }
+            }
+            poGeom = SHPReadOGRFeatureGeometry( hSHP, poFeatureDefn, iShape,
+                                                psShape, poMappedSHP );
+        }
+
+        m_nFeaturesRead++;
+
+        if( m_poFilterGeom != NULL && !FilterGeometry( poGeom ) )
+        {
+            delete poGeom;
+            continue;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Add the feature.                                                */
+/* -------------------------------------------------------------------- */
+        poBatch->AddFeature( iShape );
+        if( !bGeometryIgnored )
+            CPL_IGNORE_RET_VAL(poBatch->SetGeomField( 0, poGeom ));
+        delete poGeom;
+
+        DBFReadOGRFieldsToBatch( hDBF, poFeatureDefn, iShape, osEncoding,
+                                 poBatch );
+    }
+
+    return poBatch->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                             GetFeature()                             */
 /************************************************************************/
@@ -883,7 +1138,7 @@ OGRFeature *OGRShapeLayer::GetFeature( GIntBig nFeatureId )
     OGRFeature *poFeature =
         SHPReadOGRFeature( hSHP, hDBF, poFeatureDefn,
                            static_cast<int>(nFeatureId), NULL,
-                           osEncoding );
+                           osEncoding, GetMappedSHP() );
 
     if( poFeature == NULL ) {
         // Reading shape feature failed.
@@ -927,7 +1182,7 @@ OGRErr OGRShapeLayer::ISetFeature( OGRFeature *poFeature )
     }
 
     bHeaderDirty = true;
-    if( CheckForQIX() || CheckForSBN() )
+    if( CheckForHRT() || CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
 
     unsigned int nOffset = 0;
@@ -998,7 +1253,7 @@ OGRErr OGRShapeLayer::DeleteFeature( GIntBig nFID )
         return OGRERR_FAILURE;
 
     bHeaderDirty = true;
-    if( CheckForQIX() || CheckForSBN() )
+    if( CheckForHRT() || CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
     m_eNeedRepack = YES;
 
@@ -1030,7 +1285,7 @@ OGRErr OGRShapeLayer::ICreateFeature( OGRFeature *poFeature )
     }
 
     bHeaderDirty = true;
-    if( CheckForQIX() || CheckForSBN() )
+    if( CheckForHRT() || CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
 
     poFeature->SetFID( OGRNullFID );
@@ -1554,7 +1809,8 @@ int OGRShapeLayer::TestCapability( const char * pszCap )
 
     if( EQUAL(pszCap,OLCFastFeatureCount) )
     {
-        if( !(m_poFilterGeom == NULL || CheckForQIX() || CheckForSBN()) )
+        if( !(m_poFilterGeom == NULL || CheckForHRT() || CheckForQIX() ||
+              CheckForSBN()) )
             return FALSE;
 
         if( m_poAttrQuery != NULL )
@@ -1569,7 +1825,7 @@ int OGRShapeLayer::TestCapability( const char * pszCap )
         return bUpdateAccess;
 
     if( EQUAL(pszCap,OLCFastSpatialFilter) )
-        return CheckForQIX() || CheckForSBN();
+        return CheckForHRT() || CheckForQIX() || CheckForSBN();
 
     if( EQUAL(pszCap,OLCFastGetExtent) )
         return TRUE;
@@ -2245,7 +2501,14 @@ OGRErr OGRShapeLayer::DropSpatialIndex()
     if( !TouchLayer() )
         return OGRERR_FAILURE;
 
-    if( !CheckForQIX() && !CheckForSBN() )
+    // A stale .hrt is not opened, but is removed all the same.
+    const char *pszHRTFilename = CPLResetExtension( pszFullName, "hrt" );
+    VSIStatBufL sStat;
+    const bool bHadHRT =
+        CheckForHRT() ||
+        VSIStatExL( pszHRTFilename, &sStat, VSI_STAT_EXISTS_FLAG ) == 0;
+
+    if( !bHadHRT && !CheckForQIX() && !CheckForSBN() )
     {
         CPLError( CE_Warning, CPLE_AppDefined,
                   "Layer %s has no spatial index, DROP SPATIAL INDEX failed.",
@@ -2253,7 +2516,25 @@ OGRErr OGRShapeLayer::DropSpatialIndex()
         return OGRERR_FAILURE;
     }
 
-    const bool bHadQIX = hQIX != NULL;
+    const bool bHadQIX = CheckForQIX();
+
+    delete poHRT;
+    poHRT = NULL;
+    bCheckedForHRT = false;
+
+    if( bHadHRT )
+    {
+        pszHRTFilename = CPLResetExtension( pszFullName, "hrt" );
+        CPLDebug( "SHAPE", "Unlinking index file %s", pszHRTFilename );
+
+        if( VSIUnlink( pszHRTFilename ) != 0 )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Failed to delete file %s.\n%s",
+                      pszHRTFilename, VSIStrerror( errno ) );
+            return OGRERR_FAILURE;
+        }
+    }
 
     SHPCloseDiskTree( hQIX );
     hQIX = NULL;
@@ -2316,7 +2597,7 @@ OGRErr OGRShapeLayer::CreateSpatialIndex( int nMaxDepth )
 /* -------------------------------------------------------------------- */
 /*      If we have an existing spatial index, blow it away first.       */
 /* -------------------------------------------------------------------- */
-    if( CheckForQIX() )
+    if( CheckForQIX() || CheckForHRT() )
         DropSpatialIndex();
 
     bCheckedForQIX = false;
@@ -2361,6 +2642,69 @@ OGRErr OGRShapeLayer::CreateSpatialIndex( int nMaxDepth )
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                         CreateHilbertRTree()                         */
+/*                                                                      */
+/*      Write a .hrt packed R-tree with nodes of nNodeSize entries      */
+/*      (0 for the default).  It replaces an existing .hrt, but .qix    */
+/*      and .sbn files are kept for other software.                     */
+/************************************************************************/
+
+OGRErr OGRShapeLayer::CreateHilbertRTree( int nNodeSize )
+
+{
+    if( !TouchLayer() )
+        return OGRERR_FAILURE;
+
+    if( hSHP == NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Layer %s has no geometry, cannot create spatial index.",
+                  poFeatureDefn->GetName() );
+        return OGRERR_FAILURE;
+    }
+
+    if( nNodeSize == 0 )
+        nNodeSize = 16;
+    if( nNodeSize < 2 || nNodeSize > 65535 )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Invalid node size: %d", nNodeSize );
+        return OGRERR_FAILURE;
+    }
+
+    // A stale .hrt is not opened, but is overwritten all the same.
+    delete poHRT;
+    poHRT = NULL;
+    bCheckedForHRT = false;
+
+    SyncToDisk();
+
+    const char *pszHRTFilename = CPLResetExtension( pszFullName, "hrt" );
+    VSIStatBufL sStat;
+    if( VSIStatExL( pszHRTFilename, &sStat, VSI_STAT_EXISTS_FLAG ) == 0 )
+    {
+        CPLDebug( "SHAPE", "Unlinking index file %s", pszHRTFilename );
+        if( VSIUnlink( pszHRTFilename ) != 0 )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Failed to delete file %s.\n%s",
+                      pszHRTFilename, VSIStrerror( errno ) );
+            return OGRERR_FAILURE;
+        }
+    }
+
+    CPLDebug( "SHAPE", "Creating index file %s", pszHRTFilename );
+
+    if( !OGRShapeHilbertRTree::Create( hSHP, pszHRTFilename, nNodeSize ) )
+        return OGRERR_FAILURE;
+
+    bCheckedForHRT = false;
+    ClearSpatialFIDs();
+
+    return CheckForHRT() ? OGRERR_NONE : OGRERR_FAILURE;
+}
+
 /************************************************************************/
 /*                            CopyInPlace()                             */
 /************************************************************************/
@@ -2536,6 +2880,9 @@ OGRErr OGRShapeLayer::Repack()
     }
     panRecordsToDelete[nDeleteCount] = -1;
 
+    // The remaining features are renumbered.
+    InvalidateAutoAttrIndex();
+
 /* -------------------------------------------------------------------- */
 /*      Find existing filenames with exact case (see #3293).            */
 /* -------------------------------------------------------------------- */
@@ -2615,7 +2962,7 @@ OGRErr OGRShapeLayer::Repack()
 /*      Cleanup any existing spatial index.  It will become             */
 /*      meaningless when the fids change.                               */
 /* -------------------------------------------------------------------- */
-    if( CheckForQIX() || CheckForSBN() )
+    if( CheckForHRT() || CheckForQIX() || CheckForSBN() )
         DropSpatialIndex();
 
 /* -------------------------------------------------------------------- */
@@ -3348,6 +3695,10 @@ void OGRShapeLayer::CloseUnderlyingLayer()
         DBFClose( hDBF );
     hDBF = NULL;
 
+    delete m_poMappedSHP;
+    m_poMappedSHP = NULL;
+    m_bCheckedMappedSHP = false;
+
     if( hSHP != NULL )
         SHPClose( hSHP );
     hSHP = NULL;
@@ -3364,6 +3715,10 @@ void OGRShapeLayer::CloseUnderlyingLayer()
     hSBN = NULL;
     bCheckedForSBN = false;
 
+    delete poHRT;
+    poHRT = NULL;
+    bCheckedForHRT = false;
+
     eFileDescriptorsState = FD_CLOSED;
 }
 
@@ -3409,6 +3764,12 @@ void OGRShapeLayer::AddToFileList( CPLStringList& oFileList )
                 (OGRShapeGeomFieldDefn*)GetLayerDefn()->GetGeomFieldDefn(0);
             oFileList.AddString(poGeomFieldDefn->GetPrjFilename());
         }
+        if( CheckForHRT() )
+        {
+            const char* pszHRTFilename =
+                CPLResetExtension( pszFullName, "hrt" );
+            oFileList.AddString(pszHRTFilename);
+        }
         if( CheckForQIX() )
         {
             const char* pszQIXFilename =
@@ -0,0 +1,600 @@
+/******************************************************************************
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Packed Hilbert R-tree spatial index (.hrt) for shapefiles.
+ *
+ ******************************************************************************
+ * Copyright (c) 2018, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * File layout of a .hrt file, all values being little-endian:
+ *
+ *   0  char[8]   "GDALHRT1"
+ *   8  uint32    node size: maximum number of children of a node
+ *  12  uint32    number of indexed shapes (shapes that are not null)
+ *  16  uint32    number of records of the .shp when the index was built
+ *  20  uint32    reserved, 0
+ *  24  double[4] extent of the indexed shapes: minx, miny, maxx, maxy
+ *  56  items, of 20 bytes each: float32 minx, miny, maxx, maxy (rounded
+ *      outwards) and uint32 value.
+ *
+ * The leaf items are the indexed shapes sorted by the Hilbert code of the
+ * center of their bounding box, and their value is the shape id.  Each
+ * level above has one item for each group of node size items of the level
+ * below, whose value is the index of its first child item.  Levels are
+ * stored from the root to the leaves, so the structure is fully determined
+ * by the node size and the number of indexed shapes, and can be read in
+ * place from a memory mapping of the file.
+ */
+
+#include "ogrshape.h"
+#include "cpl_conv.h"
+#include "cpl_error.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+CPL_CVSID("$Id$")
+
+static const char HRT_SIGNATURE[] = "GDALHRT1";
+static const int HRT_HEADER_SIZE = 56;
+static const int HRT_ITEM_SIZE = 20;
+
+/************************************************************************/
+/*                            HilbertCode()                             */
+/*                                                                      */
+/*      Position of (x, y), both in [0, 65535], along the Hilbert       */
+/*      curve filling a 65536 x 65536 grid.                             */
+/************************************************************************/
+
+static GUInt32 HilbertCode( GUInt32 x, GUInt32 y )
+{
+    GUInt32 nCode = 0;
+    for( GUInt32 s = 1U << 15; s > 0; s >>= 1 )
+    {
+        const GUInt32 rx = (x & s) ? 1 : 0;
+        const GUInt32 ry = (y & s) ? 1 : 0;
+        nCode += s * s * ((3 * rx) ^ ry);
+        if( ry == 0 )
+        {
+            if( rx == 1 )
+            {
+                x = s - 1 - (x & (s - 1)) + (x & ~(s - 1));
+                y = s - 1 - (y & (s - 1)) + (y & ~(s - 1));
+            }
+            std::swap(x, y);
+        }
+    }
+    return nCode;
+}
+
+/************************************************************************/
+/*                         RoundDown() / RoundUp()                      */
+/*                                                                      */
+/*      Convert to float so that the stored box contains the original   */
+/*      one.                                                            */
+/************************************************************************/
+
+static float RoundDown( double dfVal )
+{
+    float fVal = static_cast<float>(dfVal);
+    if( static_cast<double>(fVal) > dfVal )
+        fVal = std::nextafter(fVal, -std::numeric_limits<float>::infinity());
+    return fVal;
+}
+
+static float RoundUp( double dfVal )
+{
+    float fVal = static_cast<float>(dfVal);
+    if( static_cast<double>(fVal) < dfVal )
+        fVal = std::nextafter(fVal, std::numeric_limits<float>::infinity());
+    return fVal;
+}
+
+/************************************************************************/
+/*                         OGRShapeHilbertRTree()                       */
+/************************************************************************/
+
+OGRShapeHilbertRTree::OGRShapeHilbertRTree() :
+    m_fp(NULL),
+    m_psMapping(NULL),
+    m_pabyItems(NULL),
+    m_nNodeSize(0),
+    m_nItemCount(0),
+    m_nShapeCount(0)
+{}
+
+/************************************************************************/
+/*                        ~OGRShapeHilbertRTree()                       */
+/************************************************************************/
+
+OGRShapeHilbertRTree::~OGRShapeHilbertRTree()
+{
+    if( m_psMapping != NULL )
+        CPLVirtualMemFree( m_psMapping );
+    if( m_fp != NULL )
+        VSIFCloseL( m_fp );
+}
+
+/************************************************************************/
+/*                          ComputeLevels()                             */
+/*                                                                      */
+/*      Compute the index of the first item and the number of items     */
+/*      of each level, the leaves being level 0.                        */
+/************************************************************************/
+
+static void ComputeLevels( int nItemCount, int nNodeSize,
+                           std::vector<int>& anLevelStart,
+                           std::vector<int>& anLevelCount )
+{
+    anLevelCount.clear();
+    int nCount = nItemCount;
+    anLevelCount.push_back( nCount );
+    while( nCount > 1 )
+    {
+        nCount = (nCount + nNodeSize - 1) / nNodeSize;
+        anLevelCount.push_back( nCount );
+    }
+
+    anLevelStart.resize( anLevelCount.size() );
+    int nStart = 0;
+    for( int iLevel = static_cast<int>(anLevelCount.size()) - 1;
+         iLevel >= 0; iLevel-- )
+    {
+        anLevelStart[iLevel] = nStart;
+        nStart += anLevelCount[iLevel];
+    }
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/************************************************************************/
+
+OGRShapeHilbertRTree *OGRShapeHilbertRTree::Open( const char *pszFilename )
+{
+    VSILFILE *fp = VSIFOpenL( pszFilename, "rb" );
+    if( fp == NULL )
+        return NULL;
+
+    GByte abyHeader[HRT_HEADER_SIZE];
+    if( VSIFReadL( abyHeader, HRT_HEADER_SIZE, 1, fp ) != 1 ||
+        memcmp( abyHeader, HRT_SIGNATURE, 8 ) != 0 )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "%s is not a valid .hrt file", pszFilename );
+        VSIFCloseL( fp );
+        return NULL;
+    }
+
+    GUInt32 nNodeSize = 0;
+    GUInt32 nItemCount = 0;
+    GUInt32 nShapeCount = 0;
+    memcpy( &nNodeSize, abyHeader + 8, 4 );
+    memcpy( &nItemCount, abyHeader + 12, 4 );
+    memcpy( &nShapeCount, abyHeader + 16, 4 );
+    CPL_LSBPTR32( &nNodeSize );
+    CPL_LSBPTR32( &nItemCount );
+    CPL_LSBPTR32( &nShapeCount );
+    if( nNodeSize < 2 || nNodeSize > 65535 ||
+        nItemCount > static_cast<GUInt32>(INT_MAX) / 2 ||
+        nShapeCount > static_cast<GUInt32>(INT_MAX) ||
+        nItemCount > nShapeCount )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "%s has an invalid header", pszFilename );
+        VSIFCloseL( fp );
+        return NULL;
+    }
+
+    OGRShapeHilbertRTree *poTree = new OGRShapeHilbertRTree();
+    poTree->m_fp = fp;
+    poTree->m_nNodeSize = static_cast<int>(nNodeSize);
+    poTree->m_nItemCount = static_cast<int>(nItemCount);
+    poTree->m_nShapeCount = static_cast<int>(nShapeCount);
+    ComputeLevels( poTree->m_nItemCount, poTree->m_nNodeSize,
+                   poTree->m_anLevelStart, poTree->m_anLevelCount );
+
+    // The leaves are the last level of the file.
+    const int nTotalItems = poTree->m_anLevelStart[0] +
+                            poTree->m_anLevelCount[0];
+    const vsi_l_offset nExpectedSize = HRT_HEADER_SIZE +
+        static_cast<vsi_l_offset>(nTotalItems) * HRT_ITEM_SIZE;
+    if( VSIFSeekL( fp, 0, SEEK_END ) != 0 ||
+        VSIFTellL( fp ) < nExpectedSize )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "%s is truncated", pszFilename );
+        delete poTree;
+        return NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Read the items in place from a memory mapping if possible,      */
+/*      otherwise node by node.                                         */
+/* -------------------------------------------------------------------- */
+#ifndef CPL_MSB
+    if( nTotalItems > 0 && CPLIsVirtualMemFileMapAvailable() &&
+        VSIFGetNativeFileDescriptorL(fp) != NULL &&
+        static_cast<size_t>(nExpectedSize) == nExpectedSize )
+    {
+        poTree->m_psMapping = CPLVirtualMemFileMapNew(
+            fp, 0, nExpectedSize, VIRTUALMEM_READONLY, NULL, NULL );
+        if( poTree->m_psMapping != NULL )
+        {
+            poTree->m_pabyItems = static_cast<const GByte *>(
+                CPLVirtualMemGetAddr(poTree->m_psMapping)) + HRT_HEADER_SIZE;
+        }
+    }
+#endif
+
+    return poTree;
+}
+
+/************************************************************************/
+/*                              GetItems()                              */
+/*                                                                      */
+/*      Return a pointer to nCount consecutive items.                   */
+/************************************************************************/
+
+const GByte *OGRShapeHilbertRTree::GetItems( int iFirst, int nCount )
+{
+    if( m_pabyItems != NULL )
+        return m_pabyItems + static_cast<size_t>(iFirst) * HRT_ITEM_SIZE;
+
+    m_abyBuffer.resize( static_cast<size_t>(nCount) * HRT_ITEM_SIZE );
+    if( VSIFSeekL( m_fp, HRT_HEADER_SIZE +
+                   static_cast<vsi_l_offset>(iFirst) * HRT_ITEM_SIZE,
+                   SEEK_SET ) != 0 ||
+        VSIFReadL( &m_abyBuffer[0], HRT_ITEM_SIZE, nCount, m_fp ) !=
+            static_cast<size_t>(nCount) )
+    {
+        return NULL;
+    }
+    return &m_abyBuffer[0];
+}
+
+/************************************************************************/
+/*                               Search()                               */
+/*                                                                      */
+/*      Return the sorted list of the shape ids whose bounding box      */
+/*      intersects the passed envelope, to be freed with free().        */
+/************************************************************************/
+
+int *OGRShapeHilbertRTree::Search( const OGREnvelope& sEnvelope,
+                                   int *pnCount )
+{
+    *pnCount = 0;
+    std::vector<int> anResults;
+
+    if( m_nItemCount > 0 )
+    {
+        const int nTopLevel = static_cast<int>(m_anLevelCount.size()) - 1;
+
+        // Stack of (level, first item, item count) of the nodes to visit.
+        struct NodeToVisit { int iLevel; int iFirst; int nCount; };
+        std::vector<NodeToVisit> aoStack;
+        NodeToVisit sRoot = { nTopLevel, 0, m_anLevelCount[nTopLevel] };
+        aoStack.push_back( sRoot );
+
+        while( !aoStack.empty() )
+        {
+            const NodeToVisit sNode = aoStack.back();
+            aoStack.pop_back();
+
+            const GByte *pabyItems = GetItems( sNode.iFirst, sNode.nCount );
+            if( pabyItems == NULL )
+            {
+                CPLError( CE_Failure, CPLE_FileIO,
+                          "Cannot read .hrt spatial index" );
+                return NULL;
+            }
+
+            const int nLevelEnd = sNode.iLevel > 0 ?
+                m_anLevelStart[sNode.iLevel - 1] +
+                m_anLevelCount[sNode.iLevel - 1] : 0;
+            for( int i = 0; i < sNode.nCount; i++ )
+            {
+                const GByte *pabyItem = pabyItems + i * HRT_ITEM_SIZE;
+                float afBox[4];
+                GUInt32 nValue = 0;
+                memcpy( afBox, pabyItem, 16 );
+                memcpy( &nValue, pabyItem + 16, 4 );
+#ifdef CPL_MSB
+                for( int j = 0; j < 4; j++ )
+                    CPL_LSBPTR32( &afBox[j] );
+                CPL_LSBPTR32( &nValue );
+#endif
+                if( afBox[0] > sEnvelope.MaxX || afBox[1] > sEnvelope.MaxY ||
+                    afBox[2] < sEnvelope.MinX || afBox[3] < sEnvelope.MinY )
+                    continue;
+
+                if( sNode.iLevel == 0 )
+                {
+                    if( nValue < static_cast<GUInt32>(m_nShapeCount) )
+                        anResults.push_back( static_cast<int>(nValue) );
+                }
+                else
+                {
+                    const int iChild = static_cast<int>(nValue);
+                    if( nValue > static_cast<GUInt32>(INT_MAX) ||
+                        iChild < m_anLevelStart[sNode.iLevel - 1] ||
+                        iChild >= nLevelEnd )
+                    {
+                        CPLError( CE_Failure, CPLE_AppDefined,
+                                  "Corrupted .hrt spatial index" );
+                        return NULL;
+                    }
+                    NodeToVisit sChild = {
+                        sNode.iLevel - 1, iChild,
+                        std::min(m_nNodeSize, nLevelEnd - iChild) };
+                    aoStack.push_back( sChild );
+                }
+            }
+        }
+    }
+
+    std::sort( anResults.begin(), anResults.end() );
+
+    int *panResults = static_cast<int *>(
+        malloc( sizeof(int) * std::max(static_cast<size_t>(1),
+                                       anResults.size()) ) );
+    if( panResults == NULL )
+        return NULL;
+    if( !anResults.empty() )
+        memcpy( panResults, &anResults[0], sizeof(int) * anResults.size() );
+    *pnCount = static_cast<int>(anResults.size());
+    return panResults;
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/*                                                                      */
+/*      Bulk build the index of all the shapes of a .shp file: the      */
+/*      bounding boxes are read from the record headers, sorted by      */
+/*      the Hilbert code of their center, and packed bottom-up into     */
+/*      full nodes.                                                     */
+/************************************************************************/
+
+bool OGRShapeHilbertRTree::Create( SHPHandle hSHP, const char *pszFilename,
+                                   int nNodeSize )
+{
+    struct HRTEntry
+    {
+        GUInt32 nCode;
+        int     nShapeId;
+        double  adfBox[4];
+    };
+
+    std::vector<HRTEntry> asEntries;
+    OGREnvelope sExtent;
+
+/* -------------------------------------------------------------------- */
+/*      Collect the bounding boxes of the non null shapes.              */
+/* -------------------------------------------------------------------- */
+    for( int iShape = 0; iShape < hSHP->nRecords; iShape++ )
+    {
+        HRTEntry sEntry;
+        sEntry.nCode = 0;
+        sEntry.nShapeId = iShape;
+
+        if( hSHP->panRecOffset[iShape] == 0 )
+        {
+            // Lazy .shx loading: go through the regular reader.
+            SHPObject *psShape = SHPReadObject( hSHP, iShape );
+            if( psShape == NULL )
+                continue;
+            const bool bNull = psShape->nSHPType == SHPT_NULL;
+            sEntry.adfBox[0] = psShape->dfXMin;
+            sEntry.adfBox[1] = psShape->dfYMin;
+            sEntry.adfBox[2] = psShape->dfXMax;
+            sEntry.adfBox[3] = psShape->dfYMax;
+            SHPDestroyObject( psShape );
+            if( bNull )
+                continue;
+        }
+        else
+        {
+            if( hSHP->panRecSize[iShape] < 20 )
+                continue;
+            GByte abyBuf[4 + 8 * 4] = {};
+            const size_t nToRead =
+                std::min(sizeof(abyBuf),
+                         static_cast<size_t>(hSHP->panRecSize[iShape]));
+            if( hSHP->sHooks.FSeek( hSHP->fpSHP,
+                                    hSHP->panRecOffset[iShape] + 8, 0 ) != 0 ||
+                hSHP->sHooks.FRead( abyBuf, nToRead, 1, hSHP->fpSHP ) != 1 )
+            {
+                CPLError( CE_Failure, CPLE_FileIO,
+                          "Cannot read shape %d", iShape );
+                return false;
+            }
+            GInt32 nSHPType = 0;
+            memcpy( &nSHPType, abyBuf, 4 );
+            CPL_LSBPTR32( &nSHPType );
+            if( nSHPType == SHPT_NULL )
+                continue;
+            if( nSHPType == SHPT_POINT || nSHPType == SHPT_POINTZ ||
+                nSHPType == SHPT_POINTM )
+            {
+                memcpy( &sEntry.adfBox[0], abyBuf + 4, 8 );
+                memcpy( &sEntry.adfBox[1], abyBuf + 12, 8 );
+                CPL_LSBPTR64( &sEntry.adfBox[0] );
+                CPL_LSBPTR64( &sEntry.adfBox[1] );
+                sEntry.adfBox[2] = sEntry.adfBox[0];
+                sEntry.adfBox[3] = sEntry.adfBox[1];
+            }
+            else
+            {
+                if( nToRead < sizeof(abyBuf) )
+                    continue;
+                for( int j = 0; j < 4; j++ )
+                {
+                    memcpy( &sEntry.adfBox[j], abyBuf + 4 + 8 * j, 8 );
+                    CPL_LSBPTR64( &sEntry.adfBox[j] );
+                }
+            }
+        }
+
+        // Skip shapes whose box cannot be compared (NaN).
+        if( !(sEntry.adfBox[0] <= sEntry.adfBox[2]) ||
+            !(sEntry.adfBox[1] <= sEntry.adfBox[3]) )
+            continue;
+
+        sExtent.Merge( sEntry.adfBox[0], sEntry.adfBox[1] );
+        sExtent.Merge( sEntry.adfBox[2], sEntry.adfBox[3] );
+        asEntries.push_back( sEntry );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Sort them along the Hilbert curve.                              */
+/* -------------------------------------------------------------------- */
+    const double dfWidth = sExtent.MaxX - sExtent.MinX;
+    const double dfHeight = sExtent.MaxY - sExtent.MinY;
+    for( size_t i = 0; i < asEntries.size(); i++ )
+    {
+        HRTEntry& sEntry = asEntries[i];
+        const double dfX = (sEntry.adfBox[0] + sEntry.adfBox[2]) / 2;
+        const double dfY = (sEntry.adfBox[1] + sEntry.adfBox[3]) / 2;
+        const GUInt32 nX = dfWidth > 0 ? static_cast<GUInt32>(
+            std::min(65535.0, std::max(0.0,
+                65535.0 * (dfX - sExtent.MinX) / dfWidth))) : 0;
+        const GUInt32 nY = dfHeight > 0 ? static_cast<GUInt32>(
+            std::min(65535.0, std::max(0.0,
+                65535.0 * (dfY - sExtent.MinY) / dfHeight))) : 0;
+        sEntry.nCode = HilbertCode( nX, nY );
+    }
+    std::sort( asEntries.begin(), asEntries.end(),
+               [](const HRTEntry& a, const HRTEntry& b)
+               { return a.nCode < b.nCode ||
+                        (a.nCode == b.nCode && a.nShapeId < b.nShapeId); } );
+
+/* -------------------------------------------------------------------- */
+/*      Pack the levels, from the leaves up to the root.                */
+/* -------------------------------------------------------------------- */
+    const int nItemCount = static_cast<int>(asEntries.size());
+    std::vector<int> anLevelStart;
+    std::vector<int> anLevelCount;
+    ComputeLevels( nItemCount, nNodeSize, anLevelStart, anLevelCount );
+    const int nTotalItems = anLevelStart[0] + anLevelCount[0];
+
+    std::vector<GByte> abyItems;
+    try
+    {
+        abyItems.resize( static_cast<size_t>(nTotalItems) * HRT_ITEM_SIZE );
+    }
+    catch( const std::exception& )
+    {
+        CPLError( CE_Failure, CPLE_OutOfMemory,
+                  "Cannot allocate .hrt spatial index" );
+        return false;
+    }
+
+    std::vector<double> adfBoxes;   // Boxes of the level just written.
+    adfBoxes.resize( 4 * static_cast<size_t>(nItemCount) );
+    for( int i = 0; i < nItemCount; i++ )
+    {
+        memcpy( &adfBoxes[4 * i], asEntries[i].adfBox, 4 * sizeof(double) );
+    }
+
+    for( size_t iLevel = 0; iLevel < anLevelCount.size(); iLevel++ )
+    {
+        const int nCount = anLevelCount[iLevel];
+        std::vector<double> adfParentBoxes;
+        for( int i = 0; i < nCount; i++ )
+        {
+            GByte *pabyItem = &abyItems[0] + static_cast<size_t>(
+                anLevelStart[iLevel] + i) * HRT_ITEM_SIZE;
+            const double *padfBox = &adfBoxes[4 * static_cast<size_t>(i)];
+            float afBox[4] = { RoundDown(padfBox[0]), RoundDown(padfBox[1]),
+                               RoundUp(padfBox[2]), RoundUp(padfBox[3]) };
+            GUInt32 nValue = iLevel == 0 ?
+                static_cast<GUInt32>(asEntries[i].nShapeId) :
+                static_cast<GUInt32>(anLevelStart[iLevel - 1] +
+                                     i * nNodeSize);
+            for( int j = 0; j < 4; j++ )
+                CPL_LSBPTR32( &afBox[j] );
+            CPL_LSBPTR32( &nValue );
+            memcpy( pabyItem, afBox, 16 );
+            memcpy( pabyItem + 16, &nValue, 4 );
+
+            if( (i % nNodeSize) == 0 )
+            {
+                adfParentBoxes.push_back( padfBox[0] );
+                adfParentBoxes.push_back( padfBox[1] );
+                adfParentBoxes.push_back( padfBox[2] );
+                adfParentBoxes.push_back( padfBox[3] );
+            }
+            else
+            {
+                double *padfParent = &adfParentBoxes[adfParentBoxes.size() - 4];
+                padfParent[0] = std::min(padfParent[0], padfBox[0]);
+                padfParent[1] = std::min(padfParent[1], padfBox[1]);
+                padfParent[2] = std::max(padfParent[2], padfBox[2]);
+                padfParent[3] = std::max(padfParent[3], padfBox[3]);
+            }
+        }
+        adfBoxes.swap( adfParentBoxes );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the file.                                                 */
+/* -------------------------------------------------------------------- */
+    GByte abyHeader[HRT_HEADER_SIZE] = {};
+    memcpy( abyHeader, HRT_SIGNATURE, 8 );
+    GUInt32 anValues[3] = { static_cast<GUInt32>(nNodeSize),
+                            static_cast<GUInt32>(nItemCount),
+                            static_cast<GUInt32>(hSHP->nRecords) };
+    for( int j = 0; j < 3; j++ )
+        CPL_LSBPTR32( &anValues[j] );
+    memcpy( abyHeader + 8, anValues, 12 );
+    double adfExtent[4] = { 0.0, 0.0, 0.0, 0.0 };
+    if( nItemCount > 0 )
+    {
+        adfExtent[0] = sExtent.MinX;
+        adfExtent[1] = sExtent.MinY;
+        adfExtent[2] = sExtent.MaxX;
+        adfExtent[3] = sExtent.MaxY;
+    }
+    for( int j = 0; j < 4; j++ )
+        CPL_LSBPTR64( &adfExtent[j] );
+    memcpy( abyHeader + 24, adfExtent, 32 );
+
+    VSILFILE *fp = VSIFOpenL( pszFilename, "wb" );
+    if( fp == NULL )
+    {
+        CPLError( CE_Failure, CPLE_OpenFailed,
+                  "Cannot create %s", pszFilename );
+        return false;
+    }
+    bool bOK = VSIFWriteL( abyHeader, HRT_HEADER_SIZE, 1, fp ) == 1;
+    if( bOK && !abyItems.empty() )
+        bOK = VSIFWriteL( &abyItems[0], abyItems.size(), 1, fp ) == 1;
+    if( VSIFCloseL( fp ) != 0 )
+        bOK = false;
+    if( !bOK )
+    {
+        CPLError( CE_Failure, CPLE_FileIO, "Cannot write %s", pszFilename );
+        VSIUnlink( pszFilename );
+    }
+    return bOK;
+}
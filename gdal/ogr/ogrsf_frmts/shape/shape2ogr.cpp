@@ -34,7 +34,9 @@
 #include "ogrpgeogeometry.h"
 
 #include <algorithm>
+#include <climits>
 #include <limits>
+#include <vector>
 
 CPL_CVSID("$Id$")
 
@@ -378,6 +380,438 @@ OGRGeometry *SHPReadOGRObject( SHPHandle hSHP, int iShape, SHPObject *psShape )
     return poOGR;
 }
 
+/************************************************************************/
+/*                         OGRShapeMappedSHP()                          */
+/************************************************************************/
+
+OGRShapeMappedSHP::OGRShapeMappedSHP( CPLVirtualMem *psMapping ) :
+    m_psMapping(psMapping),
+    m_pabyData(static_cast<const GByte *>(CPLVirtualMemGetAddr(psMapping))),
+    m_nSize(CPLVirtualMemGetSize(psMapping))
+{}
+
+/************************************************************************/
+/*                        ~OGRShapeMappedSHP()                          */
+/************************************************************************/
+
+OGRShapeMappedSHP::~OGRShapeMappedSHP()
+{
+    CPLVirtualMemFree( m_psMapping );
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/*                                                                      */
+/*      Map the .shp file of a shapefile opened in read-only mode.      */
+/*      Returns NULL if the file cannot be mapped, in which case        */
+/*      records are read through SHPReadObject() as usual.              */
+/************************************************************************/
+
+OGRShapeMappedSHP *OGRShapeMappedSHP::Create( SHPHandle hSHP )
+{
+    if( hSHP == NULL || hSHP->fpSHP == NULL ||
+        !CPLIsVirtualMemFileMapAvailable() )
+        return NULL;
+
+    VSILFILE *fp = VSI_SHP_GetVSIL( hSHP->fpSHP );
+    if( VSIFGetNativeFileDescriptorL(fp) == NULL )
+        return NULL;
+
+    const vsi_l_offset nCurOffset = VSIFTellL(fp);
+    if( VSIFSeekL(fp, 0, SEEK_END) != 0 )
+        return NULL;
+    const vsi_l_offset nLength = VSIFTellL(fp);
+    CPL_IGNORE_RET_VAL(VSIFSeekL(fp, nCurOffset, SEEK_SET));
+    if( nLength <= 100 || static_cast<size_t>(nLength) != nLength )
+        return NULL;
+
+    CPLVirtualMem *psMapping = CPLVirtualMemFileMapNew(
+        fp, 0, nLength, VIRTUALMEM_READONLY, NULL, NULL );
+    if( psMapping == NULL )
+        return NULL;
+
+    return new OGRShapeMappedSHP( psMapping );
+}
+
+/************************************************************************/
+/*                             GetRecord()                              */
+/*                                                                      */
+/*      Return a pointer to the content of a record (after its 8 byte   */
+/*      header), or NULL if its location is not known or is outside     */
+/*      of the file.                                                    */
+/************************************************************************/
+
+const GByte *OGRShapeMappedSHP::GetRecord( SHPHandle hSHP, int iShape,
+                                           int *pnContentSize ) const
+{
+    if( iShape < 0 || iShape >= hSHP->nRecords )
+        return NULL;
+
+    // An offset of 0 means that the .shx entry has not been loaded yet.
+    const unsigned int nOffset = hSHP->panRecOffset[iShape];
+    const unsigned int nSize = hSHP->panRecSize[iShape];
+    if( nOffset == 0 || nOffset > m_nSize || m_nSize - nOffset < 8 ||
+        nSize > m_nSize - nOffset - 8 || nSize < 4 )
+        return NULL;
+
+    *pnContentSize = static_cast<int>(nSize);
+    return m_pabyData + nOffset + 8;
+}
+
+/************************************************************************/
+/*                             GetBounds()                              */
+/*                                                                      */
+/*      Fetch the shape type and the bounding box of a record, without  */
+/*      reading its vertices.                                           */
+/************************************************************************/
+
+bool OGRShapeMappedSHP::GetBounds( SHPHandle hSHP, int iShape,
+                                   int *pnSHPType,
+                                   OGREnvelope *psEnvelope ) const
+{
+    int nContentSize = 0;
+    const GByte *pabyRec = GetRecord( hSHP, iShape, &nContentSize );
+    if( pabyRec == NULL )
+        return false;
+
+    GInt32 nSHPType = 0;
+    memcpy( &nSHPType, pabyRec, 4 );
+    CPL_LSBPTR32( &nSHPType );
+    *pnSHPType = nSHPType;
+
+    if( nSHPType == SHPT_POINT || nSHPType == SHPT_POINTZ ||
+        nSHPType == SHPT_POINTM )
+    {
+        if( nContentSize < 20 )
+            return false;
+        memcpy( &(psEnvelope->MinX), pabyRec + 4, 8 );
+        memcpy( &(psEnvelope->MinY), pabyRec + 12, 8 );
+        CPL_LSBPTR64( &(psEnvelope->MinX) );
+        CPL_LSBPTR64( &(psEnvelope->MinY) );
+        psEnvelope->MaxX = psEnvelope->MinX;
+        psEnvelope->MaxY = psEnvelope->MinY;
+    }
+    else if( nSHPType != SHPT_NULL )
+    {
+        if( nContentSize < 36 )
+            return false;
+        memcpy( &(psEnvelope->MinX), pabyRec + 4, 8 );
+        memcpy( &(psEnvelope->MinY), pabyRec + 12, 8 );
+        memcpy( &(psEnvelope->MaxX), pabyRec + 20, 8 );
+        memcpy( &(psEnvelope->MaxY), pabyRec + 28, 8 );
+        CPL_LSBPTR64( &(psEnvelope->MinX) );
+        CPL_LSBPTR64( &(psEnvelope->MinY) );
+        CPL_LSBPTR64( &(psEnvelope->MaxX) );
+        CPL_LSBPTR64( &(psEnvelope->MaxY) );
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                  OGRShapeReadInt32() / OGRShapeReadDouble()          */
+/*                                                                      */
+/*      Read a little-endian value from a possibly unaligned address    */
+/*      (records are only 2-byte aligned in the file).                  */
+/************************************************************************/
+
+static GInt32 OGRShapeReadInt32( const GByte *pabySrc )
+{
+    GInt32 nVal = 0;
+    memcpy( &nVal, pabySrc, 4 );
+    CPL_LSBPTR32( &nVal );
+    return nVal;
+}
+
+static double OGRShapeReadDouble( const GByte *pabySrc )
+{
+    double dfVal = 0.0;
+    memcpy( &dfVal, pabySrc, 8 );
+    CPL_LSBPTR64( &dfVal );
+    return dfVal;
+}
+
+/************************************************************************/
+/*                            ReadGeometry()                            */
+/*                                                                      */
+/*      Translate a mapped record to OGR geometry, with the same        */
+/*      result as SHPReadOGRObject().  The XY, Z and M arrays of the    */
+/*      record are read without going through a SHPObject.              */
+/*      Returns false if the record is of a type not handled here, or   */
+/*      looks corrupted: the caller should then use SHPReadOGRObject(), */
+/*      that will report the appropriate error.                         */
+/************************************************************************/
+
+bool OGRShapeMappedSHP::ReadGeometry( SHPHandle hSHP, int iShape,
+                                      OGRGeometry **ppoGeom ) const
+{
+    *ppoGeom = NULL;
+
+    int nContentSize = 0;
+    const GByte *pabyRec = GetRecord( hSHP, iShape, &nContentSize );
+    if( pabyRec == NULL )
+        return false;
+
+    GInt32 nSHPType = 0;
+    memcpy( &nSHPType, pabyRec, 4 );
+    CPL_LSBPTR32( &nSHPType );
+
+    if( nSHPType == SHPT_NULL )
+        return true;
+
+/* -------------------------------------------------------------------- */
+/*      Point.                                                          */
+/* -------------------------------------------------------------------- */
+    if( nSHPType == SHPT_POINT || nSHPType == SHPT_POINTZ ||
+        nSHPType == SHPT_POINTM )
+    {
+        int nOffset = (nSHPType == SHPT_POINTZ) ? 28 : 20;
+        if( nContentSize < nOffset )
+            return false;
+
+        double dfX = 0.0;
+        double dfY = 0.0;
+        double dfZ = 0.0;
+        double dfM = 0.0;
+        memcpy( &dfX, pabyRec + 4, 8 );
+        memcpy( &dfY, pabyRec + 12, 8 );
+        if( nSHPType == SHPT_POINTZ )
+            memcpy( &dfZ, pabyRec + 20, 8 );
+        const bool bHasM = nContentSize >= nOffset + 8;
+        if( bHasM )
+            memcpy( &dfM, pabyRec + nOffset, 8 );
+        CPL_LSBPTR64( &dfX );
+        CPL_LSBPTR64( &dfY );
+        CPL_LSBPTR64( &dfZ );
+        CPL_LSBPTR64( &dfM );
+
+        if( nSHPType == SHPT_POINT )
+        {
+            *ppoGeom = new OGRPoint( dfX, dfY );
+        }
+        else if( nSHPType == SHPT_POINTZ )
+        {
+            *ppoGeom = bHasM ? new OGRPoint( dfX, dfY, dfZ, dfM ) :
+                               new OGRPoint( dfX, dfY, dfZ );
+        }
+        else
+        {
+            *ppoGeom = new OGRPoint( dfX, dfY, 0.0, dfM );
+            (*ppoGeom)->set3D(FALSE);
+        }
+        return true;
+    }
+
+    const bool bIsZ = nSHPType == SHPT_MULTIPOINTZ ||
+                      nSHPType == SHPT_ARCZ || nSHPType == SHPT_POLYGONZ;
+    const bool bIsM = nSHPType == SHPT_MULTIPOINTM ||
+                      nSHPType == SHPT_ARCM || nSHPType == SHPT_POLYGONM;
+
+/* -------------------------------------------------------------------- */
+/*      Multipoint.                                                     */
+/* -------------------------------------------------------------------- */
+    if( nSHPType == SHPT_MULTIPOINT || nSHPType == SHPT_MULTIPOINTZ ||
+        nSHPType == SHPT_MULTIPOINTM )
+    {
+        if( nContentSize < 40 )
+            return false;
+        GUInt32 nPoints = 0;
+        memcpy( &nPoints, pabyRec + 36, 4 );
+        CPL_LSBPTR32( &nPoints );
+        if( nPoints > 50 * 1000 * 1000 )
+            return false;
+
+        int nOffset = 40 + 16 * static_cast<int>(nPoints);
+        if( nContentSize < nOffset + (bIsZ ? 16 + 8 * static_cast<int>(nPoints) : 0) )
+            return false;
+
+        const GByte *pabyXY = pabyRec + 40;
+        const GByte *pabyZ = NULL;
+        if( bIsZ )
+        {
+            pabyZ = pabyRec + nOffset + 16;
+            nOffset += 16 + 8 * static_cast<int>(nPoints);
+        }
+        const GByte *pabyM = NULL;
+        if( (bIsZ || bIsM) &&
+            nContentSize >= nOffset + 16 + 8 * static_cast<int>(nPoints) )
+            pabyM = pabyRec + nOffset + 16;
+
+        if( nPoints == 0 )
+            return true;
+
+        OGRMultiPoint *poMP = new OGRMultiPoint();
+        for( int i = 0; i < static_cast<int>(nPoints); i++ )
+        {
+            double adfXY[2] = { 0.0, 0.0 };
+            memcpy( adfXY, pabyXY + 16 * i, 16 );
+            CPL_LSBPTR64( &adfXY[0] );
+            CPL_LSBPTR64( &adfXY[1] );
+            OGRPoint *poPoint = new OGRPoint( adfXY[0], adfXY[1] );
+            if( pabyZ != NULL )
+            {
+                double dfZ = 0.0;
+                memcpy( &dfZ, pabyZ + 8 * i, 8 );
+                CPL_LSBPTR64( &dfZ );
+                poPoint->setZ( dfZ );
+            }
+            if( pabyM != NULL )
+            {
+                double dfM = 0.0;
+                memcpy( &dfM, pabyM + 8 * i, 8 );
+                CPL_LSBPTR64( &dfM );
+                poPoint->setM( dfM );
+            }
+            poMP->addGeometryDirectly( poPoint );
+        }
+        *ppoGeom = poMP;
+        return true;
+    }
+
+    if( nSHPType != SHPT_ARC && nSHPType != SHPT_ARCZ &&
+        nSHPType != SHPT_ARCM && nSHPType != SHPT_POLYGON &&
+        nSHPType != SHPT_POLYGONZ && nSHPType != SHPT_POLYGONM )
+    {
+        // Multipatch and unknown types.
+        return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Arc and polygon: validate the part and point counts the same    */
+/*      way as SHPReadObject().                                         */
+/* -------------------------------------------------------------------- */
+    if( nContentSize < 44 )
+        return false;
+    GUInt32 nParts = 0;
+    GUInt32 nPoints = 0;
+    memcpy( &nParts, pabyRec + 36, 4 );
+    memcpy( &nPoints, pabyRec + 40, 4 );
+    CPL_LSBPTR32( &nParts );
+    CPL_LSBPTR32( &nPoints );
+    if( nPoints > 50 * 1000 * 1000 || nParts > 10 * 1000 * 1000 )
+        return false;
+
+    const int nPartCount = static_cast<int>(nParts);
+    const int nPointCount = static_cast<int>(nPoints);
+    int nOffset = 44 + 4 * nPartCount + 16 * nPointCount;
+    if( nContentSize < nOffset + (bIsZ ? 16 + 8 * nPointCount : 0) )
+        return false;
+
+    const GByte *pabyPartStart = pabyRec + 44;
+    GInt32 nLastStart = -1;
+    for( int i = 0; i < nPartCount; i++ )
+    {
+        const GInt32 nStart = OGRShapeReadInt32( pabyPartStart + 4 * i );
+        if( nStart < 0 ||
+            (nStart >= nPointCount && nPointCount > 0) ||
+            (nStart > 0 && nPointCount == 0) ||
+            (i > 0 && nStart <= nLastStart) )
+            return false;
+        nLastStart = nStart;
+    }
+
+    if( nPartCount == 0 )
+        return true;
+
+    const GByte *pabyXY = pabyPartStart + 4 * nPartCount;
+    const GByte *pabyZ = NULL;
+    if( bIsZ )
+    {
+        pabyZ = pabyRec + nOffset + 16;
+        nOffset += 16 + 8 * nPointCount;
+    }
+    const GByte *pabyM = NULL;
+    if( (bIsZ || bIsM) && nContentSize >= nOffset + 16 + 8 * nPointCount )
+        pabyM = pabyRec + nOffset + 16;
+
+    const bool bIsPolygon = nSHPType == SHPT_POLYGON ||
+                            nSHPType == SHPT_POLYGONZ ||
+                            nSHPType == SHPT_POLYGONM;
+    std::vector<OGRGeometry *> &apoParts = m_apoParts;
+    apoParts.resize( 0 );
+    for( int i = 0; i < nPartCount; i++ )
+    {
+        GInt32 nStart = 0;
+        GInt32 nEnd = nPointCount;
+        // Like SHPReadOGRObject(), a single part line takes all vertices.
+        if( bIsPolygon || nPartCount > 1 )
+            nStart = OGRShapeReadInt32( pabyPartStart + 4 * i );
+        if( i + 1 < nPartCount )
+            nEnd = OGRShapeReadInt32( pabyPartStart + 4 * (i + 1) );
+        const int nPartPoints = std::max(0, nEnd - nStart);
+
+        OGRSimpleCurve *poCurve = NULL;
+        if( bIsPolygon )
+            poCurve = new OGRLinearRing();
+        else
+            poCurve = new OGRLineString();
+
+        // Vertices are written straight into the curve, which is what
+        // setPoints() would end up with from intermediate arrays.
+        if( nPartPoints > 0 || !bIsPolygon )
+        {
+            poCurve->setNumPoints( nPartPoints, FALSE );
+            if( pabyZ != NULL && nPointCount > 0 )
+                poCurve->set3D( TRUE );
+            if( pabyM != NULL && nPointCount > 0 )
+                poCurve->setMeasured( TRUE );
+        }
+        for( int j = 0; j < nPartPoints; j++ )
+        {
+            const int iPoint = nStart + j;
+            poCurve->setPoint( j,
+                               OGRShapeReadDouble( pabyXY + 16 * iPoint ),
+                               OGRShapeReadDouble( pabyXY + 16 * iPoint + 8 ) );
+            if( pabyZ != NULL )
+                poCurve->setZ( j, OGRShapeReadDouble( pabyZ + 8 * iPoint ) );
+            if( pabyM != NULL )
+                poCurve->setM( j, OGRShapeReadDouble( pabyM + 8 * iPoint ) );
+        }
+
+        if( bIsPolygon )
+        {
+            OGRPolygon *poPoly = new OGRPolygon();
+            poPoly->addRingDirectly( static_cast<OGRLinearRing *>(poCurve) );
+            apoParts.push_back( poPoly );
+        }
+        else
+        {
+            apoParts.push_back( poCurve );
+        }
+    }
+
+    if( nPartCount == 1 )
+    {
+        *ppoGeom = apoParts[0];
+    }
+    else if( !bIsPolygon )
+    {
+        OGRMultiLineString *poMLS = new OGRMultiLineString();
+        for( int i = 0; i < nPartCount; i++ )
+            poMLS->addGeometryDirectly( apoParts[i] );
+        *ppoGeom = poMLS;
+    }
+    else
+    {
+        int isValidGeometry = FALSE;
+        const char* papszOptions[] = { "METHOD=ONLY_CCW", NULL };
+        *ppoGeom = OGRGeometryFactory::organizePolygons(
+            &apoParts[0], nPartCount, &isValidGeometry, papszOptions );
+
+        if( !isValidGeometry )
+        {
+            CPLError(
+                CE_Warning, CPLE_AppDefined,
+                "Geometry of polygon of fid %d cannot be translated to "
+                "Simple Geometry. "
+                "All polygons will be contained in a multipolygon.",
+                iShape);
+        }
+    }
+
+    return true;
+}
+
 /************************************************************************/
 /*                         SHPWriteOGRObject()                          */
 /************************************************************************/
@@ -1175,13 +1609,98 @@ OGRFeatureDefn *SHPReadOGRFeatureDefn( const char * pszName,
     return poDefn;
 }
 
+/************************************************************************/
+/*                     SHPReadOGRFeatureGeometry()                      */
+/*                                                                      */
+/*      Read the geometry of a shape, with the dimension advertized     */
+/*      by the layer definition.  psShape is consumed if not NULL.      */
+/************************************************************************/
+
+OGRGeometry *SHPReadOGRFeatureGeometry( SHPHandle hSHP,
+                                        OGRFeatureDefn * poDefn, int iShape,
+                                        SHPObject *psShape,
+                                        const OGRShapeMappedSHP *poMappedSHP )
+
+{
+    OGRGeometry* poGeometry = NULL;
+    if( psShape != NULL || poMappedSHP == NULL ||
+        !poMappedSHP->ReadGeometry( hSHP, iShape, &poGeometry ) )
+    {
+        poGeometry = SHPReadOGRObject( hSHP, iShape, psShape );
+    }
+
+    // Two possibilities are expected here (both are tested by
+    // GDAL Autotests):
+    //   1. Read valid geometry and assign it directly.
+    //   2. Read and assign null geometry if it can not be read
+    //      correctly from a shapefile.
+    //
+    // It is NOT required here to test poGeometry == NULL.
+
+    if( poGeometry )
+    {
+        // Set/unset flags.
+        const OGRwkbGeometryType eMyGeomType =
+            poDefn->GetGeomFieldDefn(0)->GetType();
+
+        if( eMyGeomType != wkbUnknown )
+        {
+            OGRwkbGeometryType eGeomInType =
+                poGeometry->getGeometryType();
+            if( wkbHasZ(eMyGeomType) && !wkbHasZ(eGeomInType) )
+            {
+                poGeometry->set3D(TRUE);
+            }
+            else if( !wkbHasZ(eMyGeomType) && wkbHasZ(eGeomInType) )
+            {
+                poGeometry->set3D(FALSE);
+            }
+            if( wkbHasM(eMyGeomType) && !wkbHasM(eGeomInType) )
+            {
+                poGeometry->setMeasured(TRUE);
+            }
+            else if( !wkbHasM(eMyGeomType) && wkbHasM(eGeomInType) )
+            {
+                poGeometry->setMeasured(FALSE);
+            }
+        }
+    }
+
+    return poGeometry;
+}
+
+/************************************************************************/
+/*                            DBFParseDate()                            */
+/************************************************************************/
+
+static void DBFParseDate( const char* pszDateValue, OGRField* psField )
+{
+    memset( psField, 0, sizeof(OGRField) );
+
+    if( strlen(pszDateValue) >= 10 &&
+        pszDateValue[2] == '/' && pszDateValue[5] == '/' )
+    {
+        psField->Date.Month = static_cast<GByte>(atoi(pszDateValue + 0));
+        psField->Date.Day   = static_cast<GByte>(atoi(pszDateValue + 3));
+        psField->Date.Year  = static_cast<GInt16>(atoi(pszDateValue + 6));
+    }
+    else
+    {
+        const int nFullDate = atoi(pszDateValue);
+        psField->Date.Year = static_cast<GInt16>(nFullDate / 10000);
+        psField->Date.Month = static_cast<GByte>((nFullDate / 100) % 100);
+        psField->Date.Day = static_cast<GByte>(nFullDate % 100);
+    }
+}
+
 /************************************************************************/
 /*                         SHPReadOGRFeature()                          */
 /************************************************************************/
 
 OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                                OGRFeatureDefn * poDefn, int iShape,
-                               SHPObject *psShape, const char *pszSHPEncoding )
+                               SHPObject *psShape, const char *pszSHPEncoding,
+                               const OGRShapeMappedSHP *poMappedSHP )
 
 {
     if( iShape < 0
@@ -1214,47 +1733,9 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
     {
         if( !poDefn->IsGeometryIgnored() )
         {
-            OGRGeometry* poGeometry = NULL;
-            poGeometry = SHPReadOGRObject( hSHP, iShape, psShape );
-
-            // Two possibilities are expected here (both are tested by
-            // GDAL Autotests):
-            //   1. Read valid geometry and assign it directly.
-            //   2. Read and assign null geometry if it can not be read
-            //      correctly from a shapefile.
-            //
-            // It is NOT required here to test poGeometry == NULL.
-
-            if( poGeometry )
-            {
-                // Set/unset flags.
-                const OGRwkbGeometryType eMyGeomType =
-                    poFeature->GetDefnRef()->GetGeomFieldDefn(0)->GetType();
-
-                if( eMyGeomType != wkbUnknown )
-                {
-                    OGRwkbGeometryType eGeomInType =
-                        poGeometry->getGeometryType();
-                    if( wkbHasZ(eMyGeomType) && !wkbHasZ(eGeomInType) )
-                    {
-                        poGeometry->set3D(TRUE);
-                    }
-                    else if( !wkbHasZ(eMyGeomType) && wkbHasZ(eGeomInType) )
-                    {
-                        poGeometry->set3D(FALSE);
-                    }
-                    if( wkbHasM(eMyGeomType) && !wkbHasM(eGeomInType) )
-                    {
-                        poGeometry->setMeasured(TRUE);
-                    }
-                    else if( !wkbHasM(eMyGeomType) && wkbHasM(eGeomInType) )
-                    {
-                        poGeometry->setMeasured(FALSE);
-                    }
-                }
-            }
-
-            poFeature->SetGeometryDirectly( poGeometry );
+            poFeature->SetGeometryDirectly(
+                SHPReadOGRFeatureGeometry( hSHP, poDefn, iShape, psShape,
+                                           poMappedSHP ) );
         }
         else if( psShape != NULL )
         {
@@ -1332,22 +1813,7 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
                   continue;
 
               OGRField sFld;
-              memset( &sFld, 0, sizeof(sFld) );
-
-              if( strlen(pszDateValue) >= 10 &&
-                  pszDateValue[2] == '/' && pszDateValue[5] == '/' )
-              {
-                  sFld.Date.Month = static_cast<GByte>(atoi(pszDateValue + 0));
-                  sFld.Date.Day   = static_cast<GByte>(atoi(pszDateValue + 3));
-                  sFld.Date.Year  = static_cast<GInt16>(atoi(pszDateValue + 6));
-              }
-              else
-              {
-                  const int nFullDate = atoi(pszDateValue);
-                  sFld.Date.Year = static_cast<GInt16>(nFullDate / 10000);
-                  sFld.Date.Month = static_cast<GByte>((nFullDate / 100) % 100);
-                  sFld.Date.Day = static_cast<GByte>(nFullDate % 100);
-              }
+              DBFParseDate( pszDateValue, &sFld );
 
               poFeature->SetField( iField, &sFld );
           }
@@ -1364,6 +1830,94 @@ OGRFeature *SHPReadOGRFeature( SHPHandle hSHP, DBFHandle hDBF,
     return poFeature;
 }
 
+/************************************************************************/
+/*                      DBFReadOGRFieldsToBatch()                       */
+/*                                                                      */
+/*      Set the attributes of the last feature of a batch from a DBF    */
+/*      record, the same way as SHPReadOGRFeature() does, but without   */
+/*      going through an OGRFeature.                                    */
+/************************************************************************/
+
+void DBFReadOGRFieldsToBatch( DBFHandle hDBF, OGRFeatureDefn * poDefn,
+                              int iShape, const char *pszSHPEncoding,
+                              OGRFeatureBatch *poBatch )
+
+{
+    for( int iField = 0;
+         hDBF != NULL && iField < poDefn->GetFieldCount();
+         iField++ )
+    {
+        const OGRFieldDefn * const poFieldDefn = poDefn->GetFieldDefn(iField);
+        if( poFieldDefn->IsIgnored() )
+            continue;
+
+        switch( poFieldDefn->GetType() )
+        {
+          case OFTString:
+          {
+              const char * const pszFieldVal =
+                  DBFReadStringAttribute( hDBF, iShape, iField );
+              if( pszFieldVal == NULL || pszFieldVal[0] == '\0' )
+                  break;
+              if( pszSHPEncoding[0] != '\0' )
+              {
+                  char * const pszUTF8Field =
+                      CPLRecode( pszFieldVal, pszSHPEncoding, CPL_ENC_UTF8);
+                  poBatch->SetFieldString( iField, pszUTF8Field );
+                  CPLFree( pszUTF8Field );
+              }
+              else
+                  poBatch->SetFieldString( iField, pszFieldVal );
+              break;
+          }
+          case OFTInteger:
+          case OFTInteger64:
+          {
+              if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
+                  break;
+              const GIntBig nVal = CPLAtoGIntBig(
+                  DBFReadStringAttribute( hDBF, iShape, iField ) );
+              if( poFieldDefn->GetType() == OFTInteger )
+              {
+                  poBatch->SetFieldInteger( iField,
+                      nVal > INT_MAX ? INT_MAX :
+                      nVal < INT_MIN ? INT_MIN : static_cast<int>(nVal) );
+              }
+              else
+              {
+                  poBatch->SetFieldInteger64( iField, nVal );
+              }
+              break;
+          }
+          case OFTReal:
+          {
+              if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
+                  break;
+              poBatch->SetFieldDouble( iField,
+                  CPLAtof( DBFReadStringAttribute( hDBF, iShape, iField ) ) );
+              break;
+          }
+          case OFTDate:
+          {
+              if( DBFIsAttributeNULL( hDBF, iShape, iField ) )
+                  break;
+              const char* const pszDateValue =
+                  DBFReadStringAttribute(hDBF,iShape,iField);
+              if( pszDateValue[0] == '\0' )
+                  break;
+
+              OGRField sFld;
+              DBFParseDate( pszDateValue, &sFld );
+              poBatch->SetFieldRaw( iField, &sFld );
+              break;
+          }
+
+          default:
+            CPLAssert( false );
+        }
+    }
+}
+
 /************************************************************************/
 /*                             GrowField()                              */
 /************************************************************************/
@@ -55,6 +55,8 @@ class OGRSQLiteExtensionData
 
     OGRGeocodingSessionH hGeocodingSession;
 
+    bool bMinimalSpatialFunctions;
+
   public:
     explicit                     OGRSQLiteExtensionData(sqlite3* hDB);
                                 ~OGRSQLiteExtensionData();
@@ -65,6 +67,9 @@ class OGRSQLiteExtensionData
     void                         SetGeocodingSession(OGRGeocodingSessionH hGeocodingSessionIn) { hGeocodingSession = hGeocodingSessionIn; }
 
     void                         SetRegExpCache(void* hRegExpCacheIn) { hRegExpCache = hRegExpCacheIn; }
+
+    bool                         HasMinimalSpatialFunctions() const { return bMinimalSpatialFunctions; }
+    void                         SetMinimalSpatialFunctions() { bMinimalSpatialFunctions = true; }
 };
 
 /************************************************************************/
@@ -76,7 +81,8 @@ OGRSQLiteExtensionData::OGRSQLiteExtensionData(CPL_UNUSED sqlite3* hDB) :
     pDummy(CPLMalloc(1)),
 #endif
     hRegExpCache(NULL),
-    hGeocodingSession(NULL)
+    hGeocodingSession(NULL),
+    bMinimalSpatialFunctions(false)
 {}
 
 /************************************************************************/
@@ -1190,6 +1196,8 @@ void* OGRSQLiteRegisterSQLFunctions(sqlite3* hDB)
         REGISTER_ST_op(2, Buffer);
         REGISTER_ST_op(2, MakePoint);
         REGISTER_ST_op(3, MakePoint);
+
+        pData->SetMinimalSpatialFunctions();
     }
 #endif // #ifdef MINIMAL_SPATIAL_FUNCTIONS
 
@@ -31,6 +31,7 @@
 #include "swq.h"
 #include "ogr_p.h"
 #include "ogrsqliteutility.h"
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -113,6 +114,10 @@ class OGR2SQLITEModule
     OGRLayer*                    GetLayerForVTable(const char* pszVTableName);
 
     void                         SetHandleSQLFunctions(void* hHandleSQLFunctionsIn);
+    bool                         HasMinimalSpatialFunctions() const
+        { return hHandleSQLFunctions != NULL &&
+                 static_cast<OGRSQLiteExtensionData*>(hHandleSQLFunctions)->
+                                            HasMinimalSpatialFunctions(); }
 };
 
 /************************************************************************/
@@ -293,6 +298,7 @@ typedef struct
     int                   bCloseDS;
     OGRLayer             *poLayer;
     int                   nMyRef;
+    int                   bInternalUse;
 } OGR2SQLITE_vtab;
 
 /************************************************************************/
@@ -317,8 +323,27 @@ typedef struct
     GIntBig        nNextWishedIndex;
     GIntBig        nCurFeatureIndex;
 
-    GByte         *pabyGeomBLOB;
-    int            nGeomBLOBLen;
+    /* SpatiaLite blobs of the geometry fields of the current feature. */
+    /* A length of -1 means that the blob has not been computed yet. */
+    GByte        **papabyGeomBLOB;
+    int           *panGeomBLOBLen;
+
+    /* When the statement only uses plain attribute fields, features are */
+    /* read with GetNextFeatureBatch() and values are taken from poBatch */
+    /* instead of poFeature. */
+    OGRFeatureBatch *poBatch;
+    int            iBatchFeature;
+    int            nBatchSize;
+
+    /* Ignored fields of the layer when the cursor was opened, and the */
+    /* ones we have set (NULL if untouched). */
+    char         **papszSavedIgnoredFields;
+    char         **papszIgnoredFields;
+
+    /* Whether we can install our own spatial filter, and on which */
+    /* geometry field it is currently installed (-1 if none). */
+    int            bCanSetSpatialFilter;
+    int            iSpatialFilterGeomField;
 } OGR2SQLITE_vtab_cursor;
 
 /************************************************************************/
@@ -567,6 +592,7 @@ int OGR2SQLITE_ConnectCreate(sqlite3* hDB, void *pAux,
     vtab->bCloseDS = bCloseDS;
     vtab->poLayer = poLayer;
     vtab->nMyRef = 0;
+    vtab->bInternalUse = bInternalUse;
 
     poModule->RegisterVTable(vtab->pszVTableName, poLayer);
 
@@ -666,10 +692,60 @@ int OGR2SQLITE_ConnectCreate(sqlite3* hDB, void *pAux,
     return SQLITE_OK;
 }
 
+/************************************************************************/
+/*                    OGR2SQLITE_HasRangeConstraints()                  */
+/************************************************************************/
+
+static bool OGR2SQLITE_HasRangeConstraints(const sqlite3_index_info* pIndex,
+                                           int iCol)
+{
+    bool bHasGE = false;
+    bool bHasLT = false;
+    for( int i = 0; i < pIndex->nConstraint; i++ )
+    {
+        if( pIndex->aConstraint[i].usable &&
+            pIndex->aConstraint[i].iColumn == iCol )
+        {
+            if( pIndex->aConstraint[i].op == SQLITE_INDEX_CONSTRAINT_GE )
+                bHasGE = true;
+            else if( pIndex->aConstraint[i].op == SQLITE_INDEX_CONSTRAINT_LT )
+                bHasLT = true;
+        }
+    }
+    return bHasGE && bHasLT;
+}
+
 /************************************************************************/
 /*                        OGR2SQLITE_BestIndex()                        */
 /************************************************************************/
 
+/* Constraint operators that older SQLite headers do not define. Their */
+/* values are part of the SQLite ABI. */
+#ifndef SQLITE_INDEX_CONSTRAINT_LIKE
+#define SQLITE_INDEX_CONSTRAINT_LIKE       65
+#endif
+#ifndef SQLITE_INDEX_CONSTRAINT_NE
+#define SQLITE_INDEX_CONSTRAINT_NE         68
+#define SQLITE_INDEX_CONSTRAINT_ISNOTNULL  70
+#define SQLITE_INDEX_CONSTRAINT_ISNULL     71
+#endif
+#ifndef SQLITE_INDEX_CONSTRAINT_FUNCTION
+#define SQLITE_INDEX_CONSTRAINT_FUNCTION  150
+#endif
+
+/* Operator stored in idxStr for a "col IN (...)" constraint whose values */
+/* are passed all at once to xFilter(). */
+#define OGR2SQLITE_INDEX_CONSTRAINT_IN      1
+
+/* Flag of idxNum set when idxStr holds the mask of the used columns. */
+#define OGR2SQLITE_IDXNUM_COLUSED           1
+
+/* idxStr is an array of int with the following layout :
+   0           : number N of constraints passed to xFilter()
+   1+2*i, 2+2*i: column and operator of the i-th constraint
+   1+2*N, 2+2*N: low and high 32 bits of the colUsed mask
+*/
+
 static
 int OGR2SQLITE_BestIndex(sqlite3_vtab *pVTab, sqlite3_index_info* pIndex)
 {
@@ -698,6 +774,11 @@ int OGR2SQLITE_BestIndex(sqlite3_vtab *pVTab, sqlite3_index_info* pIndex)
             case SQLITE_INDEX_CONSTRAINT_LT: pszOp = " < "; break;
             case SQLITE_INDEX_CONSTRAINT_GE: pszOp = " >= "; break;
             case SQLITE_INDEX_CONSTRAINT_MATCH: pszOp = " MATCH "; break;
+            case SQLITE_INDEX_CONSTRAINT_LIKE: pszOp = " LIKE "; break;
+            case SQLITE_INDEX_CONSTRAINT_NE: pszOp = " <> "; break;
+            case SQLITE_INDEX_CONSTRAINT_ISNULL: pszOp = " IS NULL "; break;
+            case SQLITE_INDEX_CONSTRAINT_ISNOTNULL: pszOp = " IS NOT NULL "; break;
+            case SQLITE_INDEX_CONSTRAINT_FUNCTION: pszOp = " FUNCTION "; break;
             default: pszOp = " (unknown op) "; break;
         }
 
@@ -720,17 +801,116 @@ int OGR2SQLITE_BestIndex(sqlite3_vtab *pVTab, sqlite3_index_info* pIndex)
              osQueryPatternUsable.c_str(), osQueryPatternNotUsable.c_str());
 #endif
 
+    const int nFieldCount = poFDefn->GetFieldCount();
+    const int nGeomFieldCount = poFDefn->GetGeomFieldCount();
+    std::vector<int> anOps(pIndex->nConstraint, 0);
+    bool bHasSpatialConstraint = false;
+    double dfCost = 1e6;
+
     int nConstraints = 0;
     for( int i = 0; i < pIndex->nConstraint; i++ )
     {
-        int iCol = pIndex->aConstraint[i].iColumn;
-        if (pIndex->aConstraint[i].usable &&
-            pIndex->aConstraint[i].op != SQLITE_INDEX_CONSTRAINT_MATCH &&
-            iCol < poFDefn->GetFieldCount() &&
-            (iCol < 0 || poFDefn->GetFieldDefn(iCol)->GetType() != OFTBinary))
+        const int iCol = pIndex->aConstraint[i].iColumn;
+        const int nOp = pIndex->aConstraint[i].op;
+        int nUsedOp = 0;
+        int bOmit = TRUE;
+
+        if( !pIndex->aConstraint[i].usable )
+        {
+            /* not usable */
+        }
+        else if( nOp >= SQLITE_INDEX_CONSTRAINT_FUNCTION )
+        {
+            /* Spatial predicate overloaded by OGR2SQLITE_FindFunction(). */
+            /* The extent of its second argument becomes a spatial filter, */
+            /* and SQLite still evaluates the predicate on each row. */
+            if( !bHasSpatialConstraint && iCol > nFieldCount &&
+                iCol - (nFieldCount + 1) < nGeomFieldCount )
+            {
+                nUsedOp = nOp;
+                bOmit = FALSE;
+                bHasSpatialConstraint = true;
+                dfCost /= 10;
+            }
+        }
+        else if( iCol >= nFieldCount ||
+                 (iCol >= 0 &&
+                  poFDefn->GetFieldDefn(iCol)->GetType() == OFTBinary) )
+        {
+            /* OGR_STYLE, geometry and native data columns */
+        }
+        else
+        {
+            /* OGR SQL compares strings case-insensitively, so the layer */
+            /* may return more rows than SQLite would for such constraints. */
+            const bool bIsString = iCol >= 0 &&
+                poFDefn->GetFieldDefn(iCol)->GetType() == OFTString;
+
+            switch( nOp )
+            {
+                case SQLITE_INDEX_CONSTRAINT_EQ:
+                    nUsedOp = nOp;
+                    dfCost /= (iCol < 0) ? 1e6 : 10;
+                    /* Superset of the rows for strings: let SQLite */
+                    /* check them */
+                    if( bIsString )
+                        bOmit = FALSE;
+#if SQLITE_VERSION_NUMBER >= 3038000L
+                    /* Ask for all the values of "col IN (...)" at once, */
+                    /* instead of one xFilter() call per value. */
+                    /* sqlite3_vtab_in() is not in the extension API */
+                    /* routines we use, so only call it on our own */
+                    /* database handles. */
+                    if( pMyVTab->bInternalUse &&
+                        sqlite3_libversion_number() >= 3038000 &&
+                        sqlite3_vtab_in(pIndex, i, 1) )
+                    {
+                        nUsedOp = OGR2SQLITE_INDEX_CONSTRAINT_IN;
+                    }
+#endif
+                    break;
+
+                case SQLITE_INDEX_CONSTRAINT_GT:
+                case SQLITE_INDEX_CONSTRAINT_LE:
+                case SQLITE_INDEX_CONSTRAINT_LT:
+                case SQLITE_INDEX_CONSTRAINT_GE:
+                case SQLITE_INDEX_CONSTRAINT_ISNULL:
+                case SQLITE_INDEX_CONSTRAINT_ISNOTNULL:
+                    nUsedOp = nOp;
+                    dfCost /= 2;
+                    break;
+
+                case SQLITE_INDEX_CONSTRAINT_NE:
+                    /* 'abc' <> 'ABC' is false for OGR SQL */
+                    if( !bIsString )
+                        nUsedOp = nOp;
+                    break;
+
+                case SQLITE_INDEX_CONSTRAINT_LIKE:
+                    /* Not passed as a LIKE, whose case sensitivity and */
+                    /* escape character depend on the driver, but as a */
+                    /* range on the literal prefix of the pattern. SQLite */
+                    /* already gives that range as >= and < constraints */
+                    /* when its LIKE optimization applies. */
+                    if( bIsString &&
+                        !OGR2SQLITE_HasRangeConstraints(pIndex, iCol) )
+                    {
+                        nUsedOp = nOp;
+                        bOmit = FALSE;
+                        dfCost /= 5;
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+
+        if( nUsedOp != 0 )
         {
+            anOps[i] = nUsedOp;
             pIndex->aConstraintUsage[i].argvIndex = nConstraints + 1;
-            pIndex->aConstraintUsage[i].omit = TRUE;
+            pIndex->aConstraintUsage[i].omit = bOmit;
 
             nConstraints ++;
         }
@@ -741,43 +921,50 @@ int OGR2SQLITE_BestIndex(sqlite3_vtab *pVTab, sqlite3_index_info* pIndex)
         }
     }
 
-    int* panConstraints = NULL;
-
-    if( nConstraints )
+    /* colUsed is only present in the structure passed by SQLite >= 3.10 */
+    sqlite3_uint64 nColUsed = 0;
+    bool bHasColUsed = false;
+#if SQLITE_VERSION_NUMBER >= 3010000L
+    if( sqlite3_libversion_number() >= 3010000 )
     {
-        panConstraints = (int*)
-                    sqlite3_malloc( (int)sizeof(int) * (1 + 2 * nConstraints) );
-        panConstraints[0] = nConstraints;
+        nColUsed = pIndex->colUsed;
+        bHasColUsed = true;
+    }
+#endif
 
-        nConstraints = 0;
+    int* panConstraints = (int*)
+                sqlite3_malloc( (int)sizeof(int) * (3 + 2 * nConstraints) );
+    if( panConstraints == NULL )
+        return SQLITE_NOMEM;
+    panConstraints[0] = nConstraints;
 
-        for( int i = 0; i < pIndex->nConstraint; i++ )
+    nConstraints = 0;
+
+    for( int i = 0; i < pIndex->nConstraint; i++ )
+    {
+        if( pIndex->aConstraintUsage[i].argvIndex > 0 )
         {
-            if (pIndex->aConstraintUsage[i].omit)
-            {
-                panConstraints[2 * nConstraints + 1] =
-                                            pIndex->aConstraint[i].iColumn;
-                panConstraints[2 * nConstraints + 2] =
-                                            pIndex->aConstraint[i].op;
+            panConstraints[2 * nConstraints + 1] =
+                                        pIndex->aConstraint[i].iColumn;
+            panConstraints[2 * nConstraints + 2] = anOps[i];
 
-                nConstraints++;
-            }
+            nConstraints++;
         }
     }
+    panConstraints[2 * nConstraints + 1] =
+                    static_cast<int>(static_cast<GUInt32>(nColUsed));
+    panConstraints[2 * nConstraints + 2] =
+                    static_cast<int>(static_cast<GUInt32>(nColUsed >> 32));
 
     pIndex->orderByConsumed = FALSE;
-    pIndex->idxNum = 0;
+    pIndex->idxNum = bHasColUsed ? OGR2SQLITE_IDXNUM_COLUSED : 0;
+    pIndex->idxStr = (char *) panConstraints;
+    pIndex->needToFreeIdxStr = TRUE;
 
-    if (nConstraints != 0)
-    {
-        pIndex->idxStr = (char *) panConstraints;
-        pIndex->needToFreeIdxStr = TRUE;
-    }
-    else
-    {
-        pIndex->idxStr = NULL;
-        pIndex->needToFreeIdxStr = FALSE;
-    }
+    /* Make plans that push constraints down cheaper than a full scan, */
+    /* whose cost is left to the SQLite default. */
+    if( nConstraints != 0 )
+        pIndex->estimatedCost = std::max(dfCost, 1.0);
 
     return SQLITE_OK;
 }
@@ -805,6 +992,36 @@ int OGR2SQLITE_DisconnectDestroy(sqlite3_vtab *pVTab)
     return SQLITE_OK;
 }
 
+/************************************************************************/
+/*                     OGR2SQLITE_GetIgnoredFields()                    */
+/************************************************************************/
+
+/* Return the list of the currently ignored fields of a layer, in the */
+/* form expected by SetIgnoredFields(). */
+
+static char** OGR2SQLITE_GetIgnoredFields(OGRLayer* poLayer)
+{
+    OGRFeatureDefn* poFDefn = poLayer->GetLayerDefn();
+    char** papszIgnored = NULL;
+    for( int i = 0; i < poFDefn->GetFieldCount(); i++ )
+    {
+        OGRFieldDefn* poFieldDefn = poFDefn->GetFieldDefn(i);
+        if( poFieldDefn->IsIgnored() )
+            papszIgnored = CSLAddString(papszIgnored,
+                                        poFieldDefn->GetNameRef());
+    }
+    for( int i = 0; i < poFDefn->GetGeomFieldCount(); i++ )
+    {
+        OGRGeomFieldDefn* poGeomFieldDefn = poFDefn->GetGeomFieldDefn(i);
+        if( poGeomFieldDefn->IsIgnored() )
+            papszIgnored = CSLAddString(papszIgnored,
+                i == 0 ? "OGR_GEOMETRY" : poGeomFieldDefn->GetNameRef());
+    }
+    if( poFDefn->IsStyleIgnored() )
+        papszIgnored = CSLAddString(papszIgnored, "OGR_STYLE");
+    return papszIgnored;
+}
+
 /************************************************************************/
 /*                           OGR2SQLITE_Open()                          */
 /************************************************************************/
@@ -815,7 +1032,7 @@ int OGR2SQLITE_Open(sqlite3_vtab *pVTab, sqlite3_vtab_cursor **ppCursor)
     OGR2SQLITE_vtab* pMyVTab = (OGR2SQLITE_vtab*) pVTab;
 #ifdef DEBUG_OGR2SQLITE
     CPLDebug("OGR2SQLITE", "Open(%s, %s)",
-             pMyVTab->poDS->GetName(), pMyVTab->poLayer->GetName());
+             pMyVTab->poDS->GetDescription(), pMyVTab->poLayer->GetName());
 #endif
 
     OGRDataSource* poDupDataSource = NULL;
@@ -860,12 +1077,47 @@ int OGR2SQLITE_Open(sqlite3_vtab *pVTab, sqlite3_vtab_cursor **ppCursor)
     pCursor->nCurFeatureIndex = -1;
     pCursor->nFeatureCount = -1;
 
-    pCursor->pabyGeomBLOB = NULL;
-    pCursor->nGeomBLOBLen = -1;
+    const int nGeomFieldCount =
+        std::max(1, poLayer->GetLayerDefn()->GetGeomFieldCount());
+    pCursor->papabyGeomBLOB = (GByte**)
+                            CPLCalloc(nGeomFieldCount, sizeof(GByte*));
+    pCursor->panGeomBLOBLen = (int*) CPLMalloc(nGeomFieldCount * sizeof(int));
+    for( int i = 0; i < nGeomFieldCount; i++ )
+        pCursor->panGeomBLOBLen[i] = -1;
+
+    pCursor->poBatch = NULL;
+    pCursor->iBatchFeature = 0;
+    pCursor->nBatchSize = 0;
+
+    pCursor->papszSavedIgnoredFields = OGR2SQLITE_GetIgnoredFields(poLayer);
+    pCursor->papszIgnoredFields = NULL;
+
+    /* Do not override a spatial filter set by the user on the layer. */
+    pCursor->bCanSetSpatialFilter = poLayer->GetSpatialFilter() == NULL;
+    pCursor->iSpatialFilterGeomField = -1;
 
     return SQLITE_OK;
 }
 
+/************************************************************************/
+/*                     OGR2SQLITE_ClearGeomBLOBs()                      */
+/************************************************************************/
+
+static void OGR2SQLITE_ClearGeomBLOBs(OGR2SQLITE_vtab_cursor* pMyCursor)
+{
+    const int nGeomFieldCount =
+        std::max(1, pMyCursor->poLayer->GetLayerDefn()->GetGeomFieldCount());
+    for( int i = 0; i < nGeomFieldCount; i++ )
+    {
+        if( pMyCursor->panGeomBLOBLen[i] >= 0 )
+        {
+            CPLFree(pMyCursor->papabyGeomBLOB[i]);
+            pMyCursor->papabyGeomBLOB[i] = NULL;
+            pMyCursor->panGeomBLOBLen[i] = -1;
+        }
+    }
+}
+
 /************************************************************************/
 /*                           OGR2SQLITE_Close()                         */
 /************************************************************************/
@@ -877,27 +1129,218 @@ int OGR2SQLITE_Close(sqlite3_vtab_cursor* pCursor)
     OGR2SQLITE_vtab* pMyVTab = pMyCursor->pVTab;
 #ifdef DEBUG_OGR2SQLITE
     CPLDebug("OGR2SQLITE", "Close(%s, %s)",
-             pMyVTab->poDS->GetName(), pMyVTab->poLayer->GetName());
+             pMyVTab->poDS->GetDescription(), pMyVTab->poLayer->GetName());
 #endif
     pMyVTab->nMyRef --;
 
     delete pMyCursor->poFeature;
-    delete pMyCursor->poDupDataSource;
+    delete pMyCursor->poBatch;
 
-    CPLFree(pMyCursor->pabyGeomBLOB);
+    /* Restore the state of the layer, which may be the user's one. */
+    if( pMyCursor->papszIgnoredFields != NULL )
+    {
+        pMyCursor->poLayer->SetIgnoredFields(
+                    (const char**) pMyCursor->papszSavedIgnoredFields);
+    }
+    if( pMyCursor->iSpatialFilterGeomField >= 0 )
+    {
+        pMyCursor->poLayer->SetSpatialFilter(
+                    pMyCursor->iSpatialFilterGeomField, NULL);
+    }
+
+    OGR2SQLITE_ClearGeomBLOBs(pMyCursor);
+    CPLFree(pMyCursor->papabyGeomBLOB);
+    CPLFree(pMyCursor->panGeomBLOBLen);
+    CSLDestroy(pMyCursor->papszSavedIgnoredFields);
+    CSLDestroy(pMyCursor->papszIgnoredFields);
+
+    delete pMyCursor->poDupDataSource;
 
     CPLFree(pCursor);
 
     return SQLITE_OK;
 }
 
+/************************************************************************/
+/*                    OGR2SQLITE_FetchNextFeature()                     */
+/************************************************************************/
+
+/* Smallest and largest number of features read by GetNextFeatureBatch(). */
+/* Batches start small and grow, so that statements that only read a few */
+/* rows do not read much more from the layer. */
+#define OGR2SQLITE_MIN_BATCH_SIZE   32
+#define OGR2SQLITE_MAX_BATCH_SIZE   1024
+
+static void OGR2SQLITE_FetchNextFeature(OGR2SQLITE_vtab_cursor* pMyCursor)
+{
+    if( pMyCursor->poBatch != NULL )
+    {
+        pMyCursor->iBatchFeature ++;
+        if( pMyCursor->iBatchFeature >= pMyCursor->poBatch->GetFeatureCount() )
+        {
+            pMyCursor->poLayer->GetNextFeatureBatch(pMyCursor->poBatch,
+                                                    pMyCursor->nBatchSize);
+            pMyCursor->iBatchFeature = 0;
+            pMyCursor->nBatchSize = std::min(2 * pMyCursor->nBatchSize,
+                                             OGR2SQLITE_MAX_BATCH_SIZE);
+#ifdef DEBUG_OGR2SQLITE
+            CPLDebug("OGR2SQLITE", "GetNextFeatureBatch() --> %d",
+                     pMyCursor->poBatch->GetFeatureCount());
+#endif
+        }
+    }
+    else
+    {
+        delete pMyCursor->poFeature;
+        pMyCursor->poFeature = pMyCursor->poLayer->GetNextFeature();
+#ifdef DEBUG_OGR2SQLITE
+        CPLDebug("OGR2SQLITE", "GetNextFeature() --> " CPL_FRMT_GIB,
+            pMyCursor->poFeature ? pMyCursor->poFeature->GetFID() : -1);
+#endif
+    }
+
+    OGR2SQLITE_ClearGeomBLOBs(pMyCursor);
+}
+
+/************************************************************************/
+/*                       OGR2SQLITE_HasFeature()                        */
+/************************************************************************/
+
+static bool OGR2SQLITE_HasFeature(OGR2SQLITE_vtab_cursor* pMyCursor)
+{
+    if( pMyCursor->poBatch != NULL )
+        return pMyCursor->iBatchFeature <
+                                    pMyCursor->poBatch->GetFeatureCount();
+    return pMyCursor->poFeature != NULL;
+}
+
+/************************************************************************/
+/*                     OGR2SQLITE_IsColumnUsed()                        */
+/************************************************************************/
+
+/* Bit 63 of the colUsed mask stands for all the columns after the 63rd. */
+
+static bool OGR2SQLITE_IsColumnUsed(bool bHasColUsed,
+                                    sqlite3_uint64 nColUsed, int iCol)
+{
+    if( !bHasColUsed )
+        return true;
+    return (nColUsed & ((sqlite3_uint64)1 << std::min(iCol, 63))) != 0;
+}
+
+/************************************************************************/
+/*                    OGR2SQLITE_GetFilterFieldName()                   */
+/************************************************************************/
+
+static CPLString OGR2SQLITE_GetFilterFieldName(OGRFieldDefn* poFieldDefn)
+{
+    if( poFieldDefn == NULL )
+        return "FID";
+
+    const char* pszFieldName = poFieldDefn->GetNameRef();
+    char ch = '\0';
+    int bNeedsQuoting = swq_is_reserved_keyword(pszFieldName);
+    for(int j = 0; !bNeedsQuoting &&
+                   (ch = pszFieldName[j]) != '\0'; j++ )
+    {
+        if (!(isalnum((int)ch) || ch == '_'))
+            bNeedsQuoting = TRUE;
+    }
+
+    if( bNeedsQuoting )
+    {
+        CPLString osName("\"");
+        osName += SQLEscapeName(pszFieldName);
+        osName += '"';
+        return osName;
+    }
+    return pszFieldName;
+}
+
+/************************************************************************/
+/*                    OGR2SQLITE_AppendFilterValue()                    */
+/************************************************************************/
+
+static bool OGR2SQLITE_AppendFilterValue(OGR2SQLITE_vtab_cursor* pMyCursor,
+                                         CPLString& osAttributeFilter,
+                                         sqlite3_value* poValue)
+{
+    if (sqlite3_value_type (poValue) == SQLITE_INTEGER)
+    {
+        osAttributeFilter +=
+            CPLSPrintf(CPL_FRMT_GIB, sqlite3_value_int64 (poValue));
+    }
+    else if (sqlite3_value_type (poValue) == SQLITE_FLOAT)
+    { // Insure that only Decimal.Points are used, never local settings such as Decimal.Comma.
+        osAttributeFilter +=
+            CPLSPrintf("%.18g", sqlite3_value_double (poValue));
+    }
+    else if (sqlite3_value_type (poValue) == SQLITE_TEXT)
+    {
+        osAttributeFilter += "'";
+        osAttributeFilter += SQLEscapeLiteral((const char*) sqlite3_value_text (poValue));
+        osAttributeFilter += "'";
+    }
+    else
+    {
+        sqlite3_free(pMyCursor->pVTab->zErrMsg);
+        pMyCursor->pVTab->zErrMsg = sqlite3_mprintf(
+                                "Unhandled constraint data type : %d",
+                                sqlite3_value_type (poValue));
+        return false;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                    OGR2SQLITE_GetLikePrefixRange()                   */
+/*                                                                      */
+/*      Compute the bounds osLow <= x < osHigh of the strings that      */
+/*      start with the literal prefix of a LIKE pattern in any case,    */
+/*      whether the layer compares strings case-sensitively or not.     */
+/*      osHigh is left empty when there is no upper bound.              */
+/************************************************************************/
+
+static bool OGR2SQLITE_GetLikePrefixRange(const char* pszPattern,
+                                          CPLString& osLow,
+                                          CPLString& osHigh)
+{
+    const size_t nPrefixLen = strcspn(pszPattern, "%_");
+    if( nPrefixLen == 0 )
+        return false;
+
+    /* In byte order, upper case letters sort before lower case ones */
+    osLow.assign(pszPattern, nPrefixLen);
+    osHigh = osLow;
+    for( size_t i = 0; i < nPrefixLen; i++ )
+    {
+        const char ch = osLow[i];
+        if( ch >= 'a' && ch <= 'z' )
+            osLow[i] = static_cast<char>(ch - 'a' + 'A');
+        else if( ch >= 'A' && ch <= 'Z' )
+            osHigh[i] = static_cast<char>(ch - 'A' + 'a');
+    }
+
+    /* Increment the last ASCII character, after dropping the trailing */
+    /* non-ASCII ones, so that the bound remains valid UTF-8. */
+    while( !osHigh.empty() &&
+           static_cast<unsigned char>(osHigh[osHigh.size() - 1]) >= 0x7F )
+    {
+        osHigh.resize(osHigh.size() - 1);
+    }
+    if( !osHigh.empty() )
+        osHigh[osHigh.size() - 1] ++;
+
+    return true;
+}
+
 /************************************************************************/
 /*                          OGR2SQLITE_Filter()                         */
 /************************************************************************/
 
 static
 int OGR2SQLITE_Filter(sqlite3_vtab_cursor* pCursor,
-                      CPL_UNUSED int idxNum,
+                      int idxNum,
                       const char *idxStr,
                       int argc,
                       sqlite3_value **argv)
@@ -913,99 +1356,237 @@ int OGR2SQLITE_Filter(sqlite3_vtab_cursor* pCursor,
     if( nConstraints != argc )
         return SQLITE_ERROR;
 
+    const bool bHasColUsed = panConstraints != NULL &&
+                            (idxNum & OGR2SQLITE_IDXNUM_COLUSED) != 0;
+    sqlite3_uint64 nColUsed = 0;
+    if( bHasColUsed )
+    {
+        nColUsed = static_cast<GUInt32>(panConstraints[2 * argc + 1]) |
+            (static_cast<sqlite3_uint64>(
+                    static_cast<GUInt32>(panConstraints[2 * argc + 2])) << 32);
+    }
+
     CPLString osAttributeFilter;
+    int iSpatialFilterGeomField = -1;
+    OGREnvelope sSpatialFilterEnvelope;
+    bool bNoMatch = false;
 
     OGRFeatureDefn* poFDefn = pMyCursor->poLayer->GetLayerDefn();
+    const int nFieldCount = poFDefn->GetFieldCount();
+    const int nGeomFieldCount = poFDefn->GetGeomFieldCount();
+    std::vector<bool> abFieldUsed(nFieldCount);
+    for( int i = 0; i < nFieldCount; i++ )
+        abFieldUsed[i] = OGR2SQLITE_IsColumnUsed(bHasColUsed, nColUsed, i);
+    std::vector<bool> abGeomFieldUsed(nGeomFieldCount);
+    for( int i = 0; i < nGeomFieldCount; i++ )
+        abGeomFieldUsed[i] = OGR2SQLITE_IsColumnUsed(bHasColUsed, nColUsed,
+                                                     nFieldCount + 1 + i);
 
     for( int i = 0; i < argc; i++ )
     {
         int nCol = panConstraints[2 * i + 1];
+        int nOp = panConstraints[2 * i + 2];
+
+/* -------------------------------------------------------------------- */
+/*      Spatial predicate: use the extent of its second argument as     */
+/*      a spatial filter.                                               */
+/* -------------------------------------------------------------------- */
+        if( nOp >= SQLITE_INDEX_CONSTRAINT_FUNCTION )
+        {
+            const int iGeomField = nCol - (nFieldCount + 1);
+            bool bIsEmpty = false;
+            if( pMyCursor->bCanSetSpatialFilter &&
+                iSpatialFilterGeomField < 0 &&
+                iGeomField >= 0 && iGeomField < nGeomFieldCount &&
+                sqlite3_value_type (argv[i]) == SQLITE_BLOB &&
+                OGRSQLiteLayer::GetSpatialiteGeometryHeader(
+                    (const GByte*) sqlite3_value_blob (argv[i]),
+                    sqlite3_value_bytes (argv[i]),
+                    NULL, NULL, &bIsEmpty,
+                    &sSpatialFilterEnvelope.MinX,
+                    &sSpatialFilterEnvelope.MinY,
+                    &sSpatialFilterEnvelope.MaxX,
+                    &sSpatialFilterEnvelope.MaxY) == OGRERR_NONE &&
+                !bIsEmpty )
+            {
+                iSpatialFilterGeomField = iGeomField;
+                abGeomFieldUsed[iGeomField] = true;
+            }
+            continue;
+        }
+
         OGRFieldDefn* poFieldDefn = NULL;
         if( nCol >= 0 )
         {
             poFieldDefn = poFDefn->GetFieldDefn(nCol);
             if( poFieldDefn == NULL )
                 return SQLITE_ERROR;
+            abFieldUsed[nCol] = true;
         }
 
-        if( i != 0 )
-            osAttributeFilter += " AND ";
+        CPLString osTerm(OGR2SQLITE_GetFilterFieldName(poFieldDefn));
 
-        if( poFieldDefn != NULL )
+        switch(nOp)
         {
-            const char* pszFieldName = poFieldDefn->GetNameRef();
-            char ch = '\0';
-            int bNeedsQuoting = swq_is_reserved_keyword(pszFieldName);
-            for(int j = 0; !bNeedsQuoting &&
-                           (ch = pszFieldName[j]) != '\0'; j++ )
+            case SQLITE_INDEX_CONSTRAINT_EQ: osTerm += " = "; break;
+            case SQLITE_INDEX_CONSTRAINT_GT: osTerm += " > "; break;
+            case SQLITE_INDEX_CONSTRAINT_LE: osTerm += " <= "; break;
+            case SQLITE_INDEX_CONSTRAINT_LT: osTerm += " < "; break;
+            case SQLITE_INDEX_CONSTRAINT_GE: osTerm += " >= "; break;
+            case SQLITE_INDEX_CONSTRAINT_NE: osTerm += " <> "; break;
+            case SQLITE_INDEX_CONSTRAINT_ISNULL: osTerm += " IS NULL"; break;
+            case SQLITE_INDEX_CONSTRAINT_ISNOTNULL: osTerm += " IS NOT NULL"; break;
+
+            case SQLITE_INDEX_CONSTRAINT_LIKE:
             {
-                if (!(isalnum((int)ch) || ch == '_'))
-                    bNeedsQuoting = TRUE;
+                /* SQLite checks the whole pattern afterwards */
+                CPLString osLow;
+                CPLString osHigh;
+                if( sqlite3_value_type (argv[i]) != SQLITE_TEXT ||
+                    !OGR2SQLITE_GetLikePrefixRange(
+                        (const char*) sqlite3_value_text (argv[i]),
+                        osLow, osHigh) )
+                    continue;
+                osTerm += " >= '";
+                osTerm += SQLEscapeLiteral(osLow);
+                osTerm += "'";
+                if( !osHigh.empty() )
+                {
+                    osTerm += " AND ";
+                    osTerm += OGR2SQLITE_GetFilterFieldName(poFieldDefn);
+                    osTerm += " < '";
+                    osTerm += SQLEscapeLiteral(osHigh);
+                    osTerm += "'";
+                }
+                break;
             }
 
-            if( bNeedsQuoting )
+#if SQLITE_VERSION_NUMBER >= 3038000L
+            case OGR2SQLITE_INDEX_CONSTRAINT_IN:
             {
-                osAttributeFilter += '"';
-                osAttributeFilter += SQLEscapeName(pszFieldName);
-                osAttributeFilter += '"';
-            }
-            else
-            {
-                osAttributeFilter += pszFieldName;
+                osTerm += " IN (";
+                int nValues = 0;
+                sqlite3_value* poValue = NULL;
+                int rc = sqlite3_vtab_in_first(argv[i], &poValue);
+                for( ; rc == SQLITE_OK && poValue != NULL;
+                     rc = sqlite3_vtab_in_next(argv[i], &poValue) )
+                {
+                    /* NULL never compares equal */
+                    if( sqlite3_value_type (poValue) == SQLITE_NULL )
+                        continue;
+                    if( nValues > 0 )
+                        osTerm += ", ";
+                    if( !OGR2SQLITE_AppendFilterValue(pMyCursor, osTerm,
+                                                      poValue) )
+                        return SQLITE_ERROR;
+                    nValues ++;
+                }
+                if( rc != SQLITE_OK && rc != SQLITE_DONE )
+                    return rc;
+                osTerm += ")";
+                if( nValues == 0 )
+                    bNoMatch = true;
+                break;
             }
-        }
-        else
-        {
-            osAttributeFilter += "FID";
-        }
+#endif
 
-        switch(panConstraints[2 * i + 2])
-        {
-            case SQLITE_INDEX_CONSTRAINT_EQ: osAttributeFilter += " = "; break;
-            case SQLITE_INDEX_CONSTRAINT_GT: osAttributeFilter += " > "; break;
-            case SQLITE_INDEX_CONSTRAINT_LE: osAttributeFilter += " <= "; break;
-            case SQLITE_INDEX_CONSTRAINT_LT: osAttributeFilter += " < "; break;
-            case SQLITE_INDEX_CONSTRAINT_GE: osAttributeFilter += " >= "; break;
             default:
             {
                 sqlite3_free(pMyCursor->pVTab->zErrMsg);
                 pMyCursor->pVTab->zErrMsg = sqlite3_mprintf(
                                         "Unhandled constraint operator : %d",
-                                        panConstraints[2 * i + 2]);
+                                        nOp);
                 return SQLITE_ERROR;
             }
         }
 
-        if (sqlite3_value_type (argv[i]) == SQLITE_INTEGER)
+        if( nOp != SQLITE_INDEX_CONSTRAINT_ISNULL &&
+            nOp != SQLITE_INDEX_CONSTRAINT_ISNOTNULL &&
+            nOp != SQLITE_INDEX_CONSTRAINT_LIKE &&
+            nOp != OGR2SQLITE_INDEX_CONSTRAINT_IN &&
+            !OGR2SQLITE_AppendFilterValue(pMyCursor, osTerm, argv[i]) )
         {
-            osAttributeFilter +=
-                CPLSPrintf(CPL_FRMT_GIB, sqlite3_value_int64 (argv[i]));
+            return SQLITE_ERROR;
         }
-        else if (sqlite3_value_type (argv[i]) == SQLITE_FLOAT)
-        { // Insure that only Decimal.Points are used, never local settings such as Decimal.Comma.
-            osAttributeFilter +=
-                CPLSPrintf("%.18g", sqlite3_value_double (argv[i]));
+
+        if( !osAttributeFilter.empty() )
+            osAttributeFilter += " AND ";
+        osAttributeFilter += osTerm;
+    }
+
+#ifdef DEBUG_OGR2SQLITE
+    CPLDebug("OGR2SQLITE", "Attribute filter : %s",
+             osAttributeFilter.c_str());
+#endif
+
+/* -------------------------------------------------------------------- */
+/*      Do not read the fields that the statement does not use.         */
+/* -------------------------------------------------------------------- */
+    const bool bStyleUsed =
+        OGR2SQLITE_IsColumnUsed(bHasColUsed, nColUsed, nFieldCount);
+    if( bHasColUsed &&
+        pMyCursor->poLayer->TestCapability(OLCIgnoreFields) )
+    {
+        char** papszIgnored = CSLDuplicate(pMyCursor->papszSavedIgnoredFields);
+        for( int i = 0; i < nFieldCount; i++ )
+        {
+            const char* pszName = poFDefn->GetFieldDefn(i)->GetNameRef();
+            if( !abFieldUsed[i] && CSLFindString(papszIgnored, pszName) < 0 )
+                papszIgnored = CSLAddString(papszIgnored, pszName);
+        }
+        for( int i = 0; i < nGeomFieldCount; i++ )
+        {
+            const char* pszName = (i == 0) ? "OGR_GEOMETRY" :
+                            poFDefn->GetGeomFieldDefn(i)->GetNameRef();
+            if( !abGeomFieldUsed[i] &&
+                CSLFindString(papszIgnored, pszName) < 0 )
+                papszIgnored = CSLAddString(papszIgnored, pszName);
+        }
+        if( !bStyleUsed && CSLFindString(papszIgnored, "OGR_STYLE") < 0 )
+            papszIgnored = CSLAddString(papszIgnored, "OGR_STYLE");
+
+        char** papszCurIgnored = pMyCursor->papszIgnoredFields != NULL ?
+            pMyCursor->papszIgnoredFields :
+            pMyCursor->papszSavedIgnoredFields;
+        bool bSame = CSLCount(papszIgnored) == CSLCount(papszCurIgnored);
+        for( int i = 0; bSame && papszIgnored != NULL &&
+                        papszIgnored[i] != NULL; i++ )
+        {
+            bSame = strcmp(papszIgnored[i], papszCurIgnored[i]) == 0;
         }
-        else if (sqlite3_value_type (argv[i]) == SQLITE_TEXT)
+        if( !bSame )
         {
-            osAttributeFilter += "'";
-            osAttributeFilter += SQLEscapeLiteral((const char*) sqlite3_value_text (argv[i]));
-            osAttributeFilter += "'";
+            pMyCursor->poLayer->SetIgnoredFields((const char**)papszIgnored);
+            CSLDestroy(pMyCursor->papszIgnoredFields);
+            pMyCursor->papszIgnoredFields = papszIgnored;
         }
         else
         {
-            sqlite3_free(pMyCursor->pVTab->zErrMsg);
-            pMyCursor->pVTab->zErrMsg = sqlite3_mprintf(
-                                    "Unhandled constraint data type : %d",
-                                    sqlite3_value_type (argv[i]));
-            return SQLITE_ERROR;
+            CSLDestroy(papszIgnored);
         }
     }
 
-#ifdef DEBUG_OGR2SQLITE
-    CPLDebug("OGR2SQLITE", "Attribute filter : %s",
-             osAttributeFilter.c_str());
-#endif
+    if( iSpatialFilterGeomField >= 0 )
+    {
+        if( pMyCursor->iSpatialFilterGeomField >= 0 &&
+            pMyCursor->iSpatialFilterGeomField != iSpatialFilterGeomField )
+        {
+            pMyCursor->poLayer->SetSpatialFilter(
+                pMyCursor->iSpatialFilterGeomField, NULL);
+        }
+        pMyCursor->poLayer->SetSpatialFilterRect(iSpatialFilterGeomField,
+                                                 sSpatialFilterEnvelope.MinX,
+                                                 sSpatialFilterEnvelope.MinY,
+                                                 sSpatialFilterEnvelope.MaxX,
+                                                 sSpatialFilterEnvelope.MaxY);
+        pMyCursor->iSpatialFilterGeomField = iSpatialFilterGeomField;
+    }
+    else if( pMyCursor->iSpatialFilterGeomField >= 0 )
+    {
+        pMyCursor->poLayer->SetSpatialFilter(
+            pMyCursor->iSpatialFilterGeomField, NULL);
+        pMyCursor->iSpatialFilterGeomField = -1;
+    }
 
     if( pMyCursor->poLayer->SetAttributeFilter( !osAttributeFilter.empty() ?
                             osAttributeFilter.c_str() : NULL) != OGRERR_NONE )
@@ -1017,7 +1598,61 @@ int OGR2SQLITE_Filter(sqlite3_vtab_cursor* pCursor,
         return SQLITE_ERROR;
     }
 
-    if( pMyCursor->poLayer->TestCapability(OLCFastFeatureCount) )
+/* -------------------------------------------------------------------- */
+/*      When only plain attribute fields are used, read the features    */
+/*      by batches.                                                     */
+/* -------------------------------------------------------------------- */
+    bool bUseBatch = bHasColUsed && !bStyleUsed &&
+        !OGR2SQLITE_IsColumnUsed(bHasColUsed, nColUsed,
+                                 nFieldCount + 1 + nGeomFieldCount) &&
+        !OGR2SQLITE_IsColumnUsed(bHasColUsed, nColUsed,
+                                 nFieldCount + 1 + nGeomFieldCount + 1);
+    for( int i = 0; bUseBatch && i < nGeomFieldCount; i++ )
+        bUseBatch = !abGeomFieldUsed[i];
+    for( int i = 0; bUseBatch && i < nFieldCount; i++ )
+    {
+        if( !abFieldUsed[i] )
+            continue;
+        switch( poFDefn->GetFieldDefn(i)->GetType() )
+        {
+            case OFTInteger:
+            case OFTInteger64:
+            case OFTReal:
+            case OFTString:
+            case OFTBinary:
+            case OFTDate:
+            case OFTTime:
+            case OFTDateTime:
+                break;
+            default:
+                bUseBatch = false;
+                break;
+        }
+    }
+
+    delete pMyCursor->poFeature;
+    pMyCursor->poFeature = NULL;
+    OGR2SQLITE_ClearGeomBLOBs(pMyCursor);
+
+    if( bUseBatch )
+    {
+        if( pMyCursor->poBatch == NULL )
+            pMyCursor->poBatch = new OGRFeatureBatch();
+        pMyCursor->poBatch->Reset(poFDefn);
+        pMyCursor->iBatchFeature = 0;
+        pMyCursor->nBatchSize = OGR2SQLITE_MIN_BATCH_SIZE;
+    }
+    else
+    {
+        delete pMyCursor->poBatch;
+        pMyCursor->poBatch = NULL;
+    }
+
+    if( bNoMatch )
+    {
+        pMyCursor->nFeatureCount = 0;
+    }
+    else if( pMyCursor->poLayer->TestCapability(OLCFastFeatureCount) )
     {
         pMyCursor->nFeatureCount = pMyCursor->poLayer->GetFeatureCount();
         pMyCursor->poLayer->ResetReading();
@@ -1027,11 +1662,7 @@ int OGR2SQLITE_Filter(sqlite3_vtab_cursor* pCursor,
 
     if( pMyCursor->nFeatureCount < 0 )
     {
-        pMyCursor->poFeature = pMyCursor->poLayer->GetNextFeature();
-#ifdef DEBUG_OGR2SQLITE
-        CPLDebug("OGR2SQLITE", "GetNextFeature() --> " CPL_FRMT_GIB,
-            pMyCursor->poFeature ? pMyCursor->poFeature->GetFID() : -1);
-#endif
+        OGR2SQLITE_FetchNextFeature(pMyCursor);
     }
 
     pMyCursor->nNextWishedIndex = 0;
@@ -1055,17 +1686,7 @@ int OGR2SQLITE_Next(sqlite3_vtab_cursor* pCursor)
     pMyCursor->nNextWishedIndex ++;
     if( pMyCursor->nFeatureCount < 0 )
     {
-        delete pMyCursor->poFeature;
-        pMyCursor->poFeature = pMyCursor->poLayer->GetNextFeature();
-
-        CPLFree(pMyCursor->pabyGeomBLOB);
-        pMyCursor->pabyGeomBLOB = NULL;
-        pMyCursor->nGeomBLOBLen = -1;
-
-#ifdef DEBUG_OGR2SQLITE
-        CPLDebug("OGR2SQLITE", "GetNextFeature() --> " CPL_FRMT_GIB,
-            pMyCursor->poFeature ? pMyCursor->poFeature->GetFID() : -1);
-#endif
+        OGR2SQLITE_FetchNextFeature(pMyCursor);
     }
     return SQLITE_OK;
 }
@@ -1084,7 +1705,7 @@ int OGR2SQLITE_Eof(sqlite3_vtab_cursor* pCursor)
 
     if( pMyCursor->nFeatureCount < 0 )
     {
-        return pMyCursor->poFeature == NULL;
+        return !OGR2SQLITE_HasFeature(pMyCursor);
     }
     else
     {
@@ -1100,24 +1721,10 @@ static void OGR2SQLITE_GoToWishedIndex(OGR2SQLITE_vtab_cursor* pMyCursor)
 {
     if( pMyCursor->nFeatureCount >= 0 )
     {
-        if( pMyCursor->nCurFeatureIndex < pMyCursor->nNextWishedIndex )
+        while( pMyCursor->nCurFeatureIndex < pMyCursor->nNextWishedIndex )
         {
-            do
-            {
-                pMyCursor->nCurFeatureIndex ++;
-
-                delete pMyCursor->poFeature;
-                pMyCursor->poFeature = pMyCursor->poLayer->GetNextFeature();
-#ifdef DEBUG_OGR2SQLITE
-                CPLDebug("OGR2SQLITE", "GetNextFeature() --> " CPL_FRMT_GIB,
-                    pMyCursor->poFeature ? pMyCursor->poFeature->GetFID() : -1);
-#endif
-            }
-            while( pMyCursor->nCurFeatureIndex < pMyCursor->nNextWishedIndex );
-
-            CPLFree(pMyCursor->pabyGeomBLOB);
-            pMyCursor->pabyGeomBLOB = NULL;
-            pMyCursor->nGeomBLOBLen = -1;
+            pMyCursor->nCurFeatureIndex ++;
+            OGR2SQLITE_FetchNextFeature(pMyCursor);
         }
     }
 }
@@ -1152,6 +1759,132 @@ static void OGR2SQLITE_ExportGeometry(OGRGeometry* poGeom, int nSRSId,
     }
 }
 
+/************************************************************************/
+/*                      OGR2SQLITE_ResultDateTime()                     */
+/************************************************************************/
+
+static void OGR2SQLITE_ResultDateTime(sqlite3_context* pContext,
+                                      OGRFieldType eType,
+                                      const OGRField* psField)
+{
+    switch( eType )
+    {
+        case OFTDateTime:
+        {
+            char* pszStr = OGRGetXMLDateTime(psField);
+            sqlite3_result_text(pContext, pszStr, -1, SQLITE_TRANSIENT);
+            CPLFree(pszStr);
+            break;
+        }
+
+        case OFTDate:
+        {
+            char szBuffer[64];
+            snprintf(szBuffer, sizeof(szBuffer), "%04d-%02d-%02d",
+                     psField->Date.Year, psField->Date.Month,
+                     psField->Date.Day);
+            sqlite3_result_text(pContext,
+                                szBuffer,
+                                -1, SQLITE_TRANSIENT);
+            break;
+        }
+
+        default:
+        {
+            CPLAssert( eType == OFTTime );
+            const float fSecond = psField->Date.Second;
+            char szBuffer[64];
+            if( OGR_GET_MS(fSecond) != 0 )
+                snprintf(szBuffer, sizeof(szBuffer), "%02d:%02d:%06.3f",
+                         psField->Date.Hour, psField->Date.Minute, fSecond);
+            else
+                snprintf(szBuffer, sizeof(szBuffer), "%02d:%02d:%02d",
+                         psField->Date.Hour, psField->Date.Minute,
+                         (int)fSecond);
+            sqlite3_result_text(pContext,
+                                szBuffer,
+                                -1, SQLITE_TRANSIENT);
+            break;
+        }
+    }
+}
+
+/************************************************************************/
+/*                       OGR2SQLITE_BatchColumn()                       */
+/************************************************************************/
+
+/* Column() for a cursor reading its features by batches. Only attribute */
+/* fields are available. */
+
+static
+int OGR2SQLITE_BatchColumn(OGR2SQLITE_vtab_cursor* pMyCursor,
+                           sqlite3_context* pContext, int nCol)
+{
+    OGRFeatureBatch* poBatch = pMyCursor->poBatch;
+    const int iFeature = pMyCursor->iBatchFeature;
+    if( iFeature >= poBatch->GetFeatureCount() )
+        return SQLITE_ERROR;
+
+    OGRFeatureDefn* poFDefn = pMyCursor->poLayer->GetLayerDefn();
+    if( nCol < 0 || nCol >= poFDefn->GetFieldCount() )
+    {
+        sqlite3_free(pMyCursor->pVTab->zErrMsg);
+        pMyCursor->pVTab->zErrMsg = sqlite3_mprintf(
+                                "Unexpected access to column %d", nCol);
+        return SQLITE_ERROR;
+    }
+
+    if( !poBatch->IsFieldValid(nCol, iFeature) )
+    {
+        sqlite3_result_null(pContext);
+        return SQLITE_OK;
+    }
+
+    const void* pData = poBatch->GetFieldData(nCol);
+    const OGRFieldType eType = poFDefn->GetFieldDefn(nCol)->GetType();
+    switch( eType )
+    {
+        case OFTInteger:
+            sqlite3_result_int(pContext,
+                               static_cast<const int*>(pData)[iFeature]);
+            break;
+
+        case OFTInteger64:
+            sqlite3_result_int64(pContext,
+                                 static_cast<const GIntBig*>(pData)[iFeature]);
+            break;
+
+        case OFTReal:
+            sqlite3_result_double(pContext,
+                                  static_cast<const double*>(pData)[iFeature]);
+            break;
+
+        case OFTString:
+        case OFTBinary:
+        {
+            const GIntBig* panOffsets = poBatch->GetFieldOffsets(nCol);
+            const int nSize =
+                static_cast<int>(panOffsets[iFeature + 1] - panOffsets[iFeature]);
+            const char* pszValue = nSize == 0 ? "" :
+                static_cast<const char*>(pData) + panOffsets[iFeature];
+            if( eType == OFTString )
+                sqlite3_result_text(pContext, pszValue, nSize,
+                                    SQLITE_TRANSIENT);
+            else
+                sqlite3_result_blob(pContext, pszValue, nSize,
+                                    SQLITE_TRANSIENT);
+            break;
+        }
+
+        default:
+            OGR2SQLITE_ResultDateTime(pContext, eType,
+                                static_cast<const OGRField*>(pData) + iFeature);
+            break;
+    }
+
+    return SQLITE_OK;
+}
+
 /************************************************************************/
 /*                         OGR2SQLITE_Column()                          */
 /************************************************************************/
@@ -1168,6 +1901,9 @@ int OGR2SQLITE_Column(sqlite3_vtab_cursor* pCursor,
 
     OGR2SQLITE_GoToWishedIndex(pMyCursor);
 
+    if( pMyCursor->poBatch != NULL )
+        return OGR2SQLITE_BatchColumn(pMyCursor, pContext, nCol);
+
     OGRFeature* poFeature = pMyCursor->poFeature;
     if( poFeature == NULL)
         return SQLITE_ERROR;
@@ -1182,74 +1918,46 @@ int OGR2SQLITE_Column(sqlite3_vtab_cursor* pCursor,
                             -1, SQLITE_TRANSIENT);
         return SQLITE_OK;
     }
-    else if( nCol == (nFieldCount + 1) &&
-             poFDefn->GetGeomType() != wkbNone )
+    else if( nCol > nFieldCount &&
+             nCol - (nFieldCount + 1) < poFDefn->GetGeomFieldCount() )
     {
-        if( pMyCursor->nGeomBLOBLen < 0 )
+        /* The blob is kept until the next feature, since the geometry */
+        /* column is often accessed several times for the same row. */
+        const int iGeomField = nCol - (nFieldCount + 1);
+        if( pMyCursor->panGeomBLOBLen[iGeomField] < 0 )
         {
-            OGRGeometry* poGeom = poFeature->GetGeometryRef();
+            OGRGeometry* poGeom = poFeature->GetGeomFieldRef(iGeomField);
             if( poGeom == NULL )
             {
-                pMyCursor->nGeomBLOBLen = 0;
+                pMyCursor->panGeomBLOBLen[iGeomField] = 0;
             }
             else
             {
-                CPLAssert(pMyCursor->pabyGeomBLOB == NULL);
+                CPLAssert(pMyCursor->papabyGeomBLOB[iGeomField] == NULL);
 
                 OGRSpatialReference* poSRS = poGeom->getSpatialReference();
                 int nSRSId = pMyCursor->pVTab->poModule->FetchSRSId(poSRS);
 
                 OGR2SQLITE_ExportGeometry(poGeom, nSRSId,
-                                          pMyCursor->pabyGeomBLOB,
-                                          pMyCursor->nGeomBLOBLen);
+                                    pMyCursor->papabyGeomBLOB[iGeomField],
+                                    pMyCursor->panGeomBLOBLen[iGeomField]);
             }
         }
 
-        if( pMyCursor->nGeomBLOBLen == 0 )
+        if( pMyCursor->panGeomBLOBLen[iGeomField] == 0 )
         {
             sqlite3_result_null(pContext);
         }
         else
         {
-            GByte *pabyGeomBLOBDup = (GByte*)
-                                CPLMalloc(pMyCursor->nGeomBLOBLen);
-            memcpy(pabyGeomBLOBDup,
-                   pMyCursor->pabyGeomBLOB, pMyCursor->nGeomBLOBLen);
-            sqlite3_result_blob(pContext, pabyGeomBLOBDup,
-                                pMyCursor->nGeomBLOBLen, CPLFree);
+            sqlite3_result_blob(pContext,
+                                pMyCursor->papabyGeomBLOB[iGeomField],
+                                pMyCursor->panGeomBLOBLen[iGeomField],
+                                SQLITE_TRANSIENT);
         }
 
         return SQLITE_OK;
     }
-    else if( nCol > (nFieldCount + 1) &&
-             nCol - (nFieldCount + 1) < poFDefn->GetGeomFieldCount() )
-    {
-        OGRGeometry* poGeom = poFeature->GetGeomFieldRef(nCol - (nFieldCount + 1));
-        if( poGeom == NULL )
-        {
-            sqlite3_result_null(pContext);
-        }
-        else
-        {
-            OGRSpatialReference* poSRS = poGeom->getSpatialReference();
-            int nSRSId = pMyCursor->pVTab->poModule->FetchSRSId(poSRS);
-
-            GByte* pabyGeomBLOB = NULL;
-            int nGeomBLOBLen = 0;
-            OGR2SQLITE_ExportGeometry(poGeom, nSRSId, pabyGeomBLOB, nGeomBLOBLen);
-
-            if( nGeomBLOBLen == 0 )
-            {
-                sqlite3_result_null(pContext);
-            }
-            else
-            {
-                sqlite3_result_blob(pContext, pabyGeomBLOB,
-                                    nGeomBLOBLen, CPLFree);
-            }
-        }
-        return SQLITE_OK;
-    }
     else if( nCol == nFieldCount + 1 + poFDefn->GetGeomFieldCount() )
     {
         sqlite3_result_text(pContext,
@@ -1300,47 +2008,12 @@ int OGR2SQLITE_Column(sqlite3_vtab_cursor* pCursor,
         }
 
         case OFTDateTime:
-        {
-            char* pszStr = OGRGetXMLDateTime(poFeature->GetRawFieldRef(nCol));
-            sqlite3_result_text(pContext, pszStr, -1, SQLITE_TRANSIENT);
-            CPLFree(pszStr);
-            break;
-        }
-
         case OFTDate:
-        {
-            int nYear, nMonth, nDay, nHour, nMinute, nSecond, nTZ;
-            poFeature->GetFieldAsDateTime(nCol, &nYear, &nMonth, &nDay,
-                                          &nHour, &nMinute, &nSecond, &nTZ);
-            char szBuffer[64];
-            snprintf(szBuffer, sizeof(szBuffer), "%04d-%02d-%02d", nYear, nMonth, nDay);
-            sqlite3_result_text(pContext,
-                                szBuffer,
-                                -1, SQLITE_TRANSIENT);
-            break;
-        }
-
         case OFTTime:
-        {
-            int nYear = 0;
-            int nMonth = 0;
-            int nDay = 0;
-            int nHour = 0;
-            int nMinute = 0;
-            int nTZ = 0;
-            float fSecond = 0.0f;
-            poFeature->GetFieldAsDateTime(nCol, &nYear, &nMonth, &nDay,
-                                        &nHour, &nMinute, &fSecond, &nTZ );
-            char szBuffer[64];
-            if( OGR_GET_MS(fSecond) != 0 )
-                snprintf(szBuffer, sizeof(szBuffer), "%02d:%02d:%06.3f", nHour, nMinute, fSecond);
-            else
-                snprintf(szBuffer, sizeof(szBuffer), "%02d:%02d:%02d", nHour, nMinute, (int)fSecond);
-            sqlite3_result_text(pContext,
-                                szBuffer,
-                                -1, SQLITE_TRANSIENT);
+            OGR2SQLITE_ResultDateTime(pContext,
+                                      poFDefn->GetFieldDefn(nCol)->GetType(),
+                                      poFeature->GetRawFieldRef(nCol));
             break;
-        }
 
         default:
             sqlite3_result_text(pContext,
@@ -1366,6 +2039,14 @@ int OGR2SQLITE_Rowid(sqlite3_vtab_cursor* pCursor, sqlite3_int64 *pRowid)
 
     OGR2SQLITE_GoToWishedIndex(pMyCursor);
 
+    if( pMyCursor->poBatch != NULL )
+    {
+        if( !OGR2SQLITE_HasFeature(pMyCursor) )
+            return SQLITE_ERROR;
+        *pRowid = pMyCursor->poBatch->GetFIDs()[pMyCursor->iBatchFeature];
+        return SQLITE_OK;
+    }
+
     if( pMyCursor->poFeature == NULL)
         return SQLITE_ERROR;
 
@@ -1385,11 +2066,14 @@ int OGR2SQLITE_Rename(CPL_UNUSED sqlite3_vtab *pVtab, CPL_UNUSED const char *zNe
     return SQLITE_ERROR;
 }
 
-#if 0
 /************************************************************************/
 /*                        OGR2SQLITE_FindFunction()                     */
 /************************************************************************/
 
+/* Overload the spatial predicates when they are implemented by */
+/* ogrsqlitesqlfunctions.cpp, so that SQLite passes them as constraints */
+/* to OGR2SQLITE_BestIndex(), which turns them into spatial filters. */
+
 static
 int OGR2SQLITE_FindFunction(sqlite3_vtab *pVtab,
                             int nArg,
@@ -1397,11 +2081,37 @@ int OGR2SQLITE_FindFunction(sqlite3_vtab *pVtab,
                             void (**pxFunc)(sqlite3_context*,int,sqlite3_value**),
                             void **ppArg)
 {
+#ifdef DEBUG_OGR2SQLITE
     CPLDebug("OGR2SQLITE", "FindFunction %s", zName);
+#endif
 
-    return 0;
+    OGR2SQLITE_vtab* pMyVTab = (OGR2SQLITE_vtab*) pVtab;
+    if( nArg != 2 || !pMyVTab->poModule->HasMinimalSpatialFunctions() )
+        return 0;
+
+    if( STARTS_WITH_CI(zName, "ST_") )
+        zName += 3;
+
+    if( EQUAL(zName, "Intersects") )
+        *pxFunc = OGR2SQLITE_ST_Intersects;
+    else if( EQUAL(zName, "Equals") )
+        *pxFunc = OGR2SQLITE_ST_Equals;
+    else if( EQUAL(zName, "Touches") )
+        *pxFunc = OGR2SQLITE_ST_Touches;
+    else if( EQUAL(zName, "Crosses") )
+        *pxFunc = OGR2SQLITE_ST_Crosses;
+    else if( EQUAL(zName, "Within") )
+        *pxFunc = OGR2SQLITE_ST_Within;
+    else if( EQUAL(zName, "Contains") )
+        *pxFunc = OGR2SQLITE_ST_Contains;
+    else if( EQUAL(zName, "Overlaps") )
+        *pxFunc = OGR2SQLITE_ST_Overlaps;
+    else
+        return 0;
+
+    *ppArg = NULL;
+    return SQLITE_INDEX_CONSTRAINT_FUNCTION;
 }
-#endif
 
 /************************************************************************/
 /*                     OGR2SQLITE_FeatureFromArgs()                     */
@@ -1598,7 +2308,7 @@ static const struct sqlite3_module sOGR2SQLITEModule =
     NULL, /* xSync */
     NULL, /* xCommit */
     NULL, /* xFindFunctionRollback */
-    NULL, /* xFindFunction */  // OGR2SQLITE_FindFunction;
+    OGR2SQLITE_FindFunction, /* xFindFunction */
     OGR2SQLITE_Rename,
 #if SQLITE_VERSION_NUMBER >= 3007007L /* should be the first version with the below symbols */
     NULL,  // xSavepoint
@@ -2075,7 +2785,7 @@ int OGR2SQLITESpatialIndex_Open(sqlite3_vtab *pVTab, sqlite3_vtab_cursor **ppCur
     OGR2SQLITESpatialIndex_vtab* pMyVTab = (OGR2SQLITESpatialIndex_vtab*) pVTab;
 #ifdef DEBUG_OGR2SQLITE
     CPLDebug("OGR2SQLITE", "Open(%s, %s)",
-             pMyVTab->poDS->GetName(), pMyVTab->poLayer->GetName());
+             pMyVTab->poDS->GetDescription(), pMyVTab->poLayer->GetName());
 #endif
 
     OGRDataSource* poDupDataSource = NULL;
@@ -2131,7 +2841,7 @@ int OGR2SQLITESpatialIndex_Close(sqlite3_vtab_cursor* pCursor)
     OGR2SQLITESpatialIndex_vtab* pMyVTab = pMyCursor->pVTab;
 #ifdef DEBUG_OGR2SQLITE
     CPLDebug("OGR2SQLITE", "Close(%s, %s)",
-             pMyVTab->poDS->GetName(), pMyVTab->poLayer->GetName());
+             pMyVTab->poDS->GetDescription(), pMyVTab->poLayer->GetName());
 #endif
     pMyVTab->nMyRef --;
 
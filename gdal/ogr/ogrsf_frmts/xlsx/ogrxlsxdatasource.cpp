@@ -53,7 +53,11 @@ OGRXLSXLayer::OGRXLSXLayer( OGRXLSXDataSource* poDSIn,
     osFilename(pszFilename),
     bUpdated(CPL_TO_BOOL(bUpdatedIn)),
     bHasHeaderLine(false)
-{}
+{
+    // The FIDs exposed are shifted from the ones of OGRMemLayer, which
+    // in-memory attribute indexes would mix up.
+    m_bAutoAttrIndex = false;
+}
 
 /************************************************************************/
 /*                              Init()                                  */
@@ -195,6 +195,7 @@ OGRErr OGRTriangle::importFromWkb( const unsigned char *pabyData,
                                    OGRwkbVariant eWkbVariant,
                                    int& nBytesConsumedOut )
 {
+    invalidateGEOSCache();
     OGRErr eErr = OGRPolygon::importFromWkb( pabyData, nSize, eWkbVariant,
                                              nBytesConsumedOut );
     if( eErr != OGRERR_NONE )
@@ -224,6 +225,7 @@ OGRErr OGRTriangle::importFromWKTListOnly( char ** ppszInput,
                                           double*& padfZ )
 
 {
+    invalidateGEOSCache();
     OGRErr eErr = OGRPolygon::importFromWKTListOnly(ppszInput,
                                                     bHasZ, bHasM,
                                                     paoPoints,
@@ -250,6 +252,7 @@ OGRErr OGRTriangle::importFromWKTListOnly( char ** ppszInput,
 
 OGRErr OGRTriangle::addRingDirectly( OGRCurve * poNewRing )
 {
+    invalidateGEOSCache();
     if (oCC.nCurveCount == 0)
         return addRingDirectlyInternal( poNewRing, TRUE );
     else
@@ -1852,3 +1852,161 @@ OGRErr OGRReadWKBGeometryType( const unsigned char * pabyData,
 
     return OGRERR_NONE;
 }
+
+/************************************************************************/
+/*                         OGRWKBGetEnvelope()                          */
+/************************************************************************/
+
+static bool OGRWKBGetEnvelopeInternal( const GByte*& pabyData,
+                                       size_t& nRemaining,
+                                       OGREnvelope3D& sEnvelope,
+                                       bool& bHasZ, int nRecLevel )
+{
+    // Arbitrary value, but certainly large enough for reasonable usages.
+    if( nRecLevel == 32 || nRemaining < 5 )
+        return false;
+
+    const int nByteOrder = DB2_V72_FIX_BYTE_ORDER(*pabyData);
+    if( !( nByteOrder == wkbXDR || nByteOrder == wkbNDR ) )
+        return false;
+    const bool bSwap = OGR_SWAP(static_cast<OGRwkbByteOrder>(nByteOrder));
+
+    GUInt32 nRawType = 0;
+    memcpy(&nRawType, pabyData + 1, 4);
+    if( bSwap )
+        CPL_SWAP32PTR(&nRawType);
+    pabyData += 5;
+    nRemaining -= 5;
+
+    // Only the ISO and the old-style OGC 2.5D encodings of the simple
+    // types are handled. For curves, the extent depends on the arcs.
+    bool bZ = false;
+    bool bM = false;
+    if( nRawType & wkb25DBitInternalUse )
+    {
+        nRawType &= ~wkb25DBitInternalUse;
+        bZ = true;
+    }
+    else if( nRawType > 1000 && nRawType < 4000 )
+    {
+        const GUInt32 nDimFlag = nRawType / 1000;
+        nRawType %= 1000;
+        bZ = ( nDimFlag == 1 || nDimFlag == 3 );
+        bM = ( nDimFlag == 2 || nDimFlag == 3 );
+    }
+    if( nRawType < wkbPoint || nRawType > wkbGeometryCollection )
+        return false;
+    if( bZ )
+        bHasZ = true;
+
+    // Only X, Y and optionally Z are read, M is skipped.
+    const size_t nPointSize = 8 * (2 + (bZ ? 1 : 0) + (bM ? 1 : 0));
+    const size_t nReadSize = bZ ? 24 : 16;
+
+    if( nRawType == wkbPoint )
+    {
+        if( nRemaining < nPointSize )
+            return false;
+        double adfXYZ[3] = { 0.0, 0.0, 0.0 };
+        memcpy(adfXYZ, pabyData, nReadSize);
+        if( bSwap )
+        {
+            for( int i = 0; i < 3; i++ )
+                CPL_SWAPDOUBLE(&adfXYZ[i]);
+        }
+        pabyData += nPointSize;
+        nRemaining -= nPointSize;
+        // Empty points are encoded with NaN coordinates.
+        if( !CPLIsNan(adfXYZ[0]) )
+            sEnvelope.Merge(adfXYZ[0], adfXYZ[1], adfXYZ[2]);
+        return true;
+    }
+
+    if( nRemaining < 4 )
+        return false;
+    GUInt32 nCount = 0;
+    memcpy(&nCount, pabyData, 4);
+    if( bSwap )
+        CPL_SWAP32PTR(&nCount);
+    pabyData += 4;
+    nRemaining -= 4;
+
+    if( nRawType == wkbLineString || nRawType == wkbPolygon )
+    {
+        const GUInt32 nRings = ( nRawType == wkbPolygon ) ? nCount : 1;
+        for( GUInt32 iRing = 0; iRing < nRings; iRing++ )
+        {
+            GUInt32 nPoints = nCount;
+            if( nRawType == wkbPolygon )
+            {
+                if( nRemaining < 4 )
+                    return false;
+                memcpy(&nPoints, pabyData, 4);
+                if( bSwap )
+                    CPL_SWAP32PTR(&nPoints);
+                pabyData += 4;
+                nRemaining -= 4;
+            }
+            if( nPoints > nRemaining / nPointSize )
+                return false;
+            for( GUInt32 i = 0; i < nPoints; i++ )
+            {
+                double adfXYZ[3] = { 0.0, 0.0, 0.0 };
+                memcpy(adfXYZ, pabyData, nReadSize);
+                if( bSwap )
+                {
+                    for( int j = 0; j < 3; j++ )
+                        CPL_SWAPDOUBLE(&adfXYZ[j]);
+                }
+                sEnvelope.Merge(adfXYZ[0], adfXYZ[1], adfXYZ[2]);
+                pabyData += nPointSize;
+            }
+            nRemaining -= nPoints * nPointSize;
+        }
+        return true;
+    }
+
+    // Multi geometries and collections: sub-geometries have their own
+    // header, and take at least 9 bytes each.
+    if( nCount > nRemaining / 9 )
+        return false;
+    for( GUInt32 i = 0; i < nCount; i++ )
+    {
+        if( !OGRWKBGetEnvelopeInternal(pabyData, nRemaining, sEnvelope,
+                                       bHasZ, nRecLevel + 1) )
+            return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Compute the envelope of a WKB geometry without decoding it.
+ *
+ * Only points, line strings, polygons, their multi variants and geometry
+ * collections of those, in the ISO or the extended OGC WKB encodings, are
+ * handled.
+ *
+ * @param pabyWKB WKB blob.
+ * @param nWKBSize size in bytes of pabyWKB.
+ * @param psEnvelope envelope, that is not initialized if the geometry is
+ * empty. Its Z extent is only meaningful if *pbHasZ is true.
+ * @param pbHasZ set to whether the geometry has a Z dimension. Can be NULL.
+ *
+ * @return false if the geometry type is not handled, or the blob is
+ * corrupted.
+ */
+
+bool OGRWKBGetEnvelope( const GByte* pabyWKB, size_t nWKBSize,
+                        OGREnvelope3D* psEnvelope, bool* pbHasZ )
+{
+    *psEnvelope = OGREnvelope3D();
+    bool bHasZ = false;
+    if( !OGRWKBGetEnvelopeInternal(pabyWKB, nWKBSize, *psEnvelope, bHasZ,
+                                   0) )
+    {
+        return false;
+    }
+    if( pbHasZ )
+        *pbHasZ = bHasZ;
+    return true;
+}
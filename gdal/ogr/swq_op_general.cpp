@@ -52,8 +52,8 @@ CPL_CVSID("$Id$")
 /*      Does input match pattern?                                       */
 /************************************************************************/
 
-static int swq_test_like( const char *input, const char *pattern,
-                          char chEscape )
+int swq_test_like( const char *input, const char *pattern,
+                   char chEscape )
 
 {
     if( input == NULL || pattern == NULL )
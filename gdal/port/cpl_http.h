@@ -86,10 +86,39 @@ typedef struct {
 
 } CPLHTTPResult;
 
+/**
+ * Callback function to process the content of a CPLHTTPMultiFetchEx()
+ * request as it is received.
+ *
+ * @param pBuffer received data.
+ * @param nSize size of a member.
+ * @param nMemb number of members.
+ * @param iRequest index of the request in the URL list.
+ * @param pWriteArg user data passed to CPLHTTPMultiFetchEx().
+ * @return nSize * nMemb to continue the request, any other value to abort it.
+ * @since GDAL 2.3
+ */
+typedef size_t (*CPLHTTPMultiFetchWriteFunc)( void *pBuffer, size_t nSize,
+                                              size_t nMemb, int iRequest,
+                                              void *pWriteArg );
+
 int CPL_DLL   CPLHTTPEnabled( void );
 CPLHTTPResult CPL_DLL *CPLHTTPFetch( const char *pszURL, char **papszOptions);
+CPLHTTPResult CPL_DLL **CPLHTTPMultiFetch( const char * const *papszURL,
+                                           int nURLCount,
+                                           int nMaxSimultaneous,
+                                           char **papszOptions );
+CPLHTTPResult CPL_DLL **CPLHTTPMultiFetchEx(
+                                    const char * const *papszURL,
+                                    int nURLCount,
+                                    int nMaxSimultaneous,
+                                    char **papszOptions,
+                                    CPLHTTPMultiFetchWriteFunc pfnWrite,
+                                    void *pWriteArg );
 void CPL_DLL  CPLHTTPCleanup( void );
 void CPL_DLL  CPLHTTPDestroyResult( CPLHTTPResult *psResult );
+void CPL_DLL  CPLHTTPDestroyMultiResult( CPLHTTPResult **papsResults,
+                                         int nCount );
 int  CPL_DLL  CPLHTTPParseMultipartMime( CPLHTTPResult *psResult );
 
 /* -------------------------------------------------------------------- */
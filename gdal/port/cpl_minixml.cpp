@@ -47,6 +47,7 @@
 #include <cstring>
 
 #include <algorithm>
+#include <vector>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
@@ -90,11 +91,33 @@ typedef struct {
 
     CPLXMLNode *psFirstNode;
     CPLXMLNode *psLastNode;
+
+    CPLXMLArena *psArena;
 } ParseContext;
 
+/* Blocks are chained from the most recently allocated one backwards, */
+/* and their payload immediately follows the header. */
+typedef struct _CPLXMLArenaBlock CPLXMLArenaBlock;
+struct _CPLXMLArenaBlock
+{
+    CPLXMLArenaBlock *psPrev;
+    size_t            nSize;
+    size_t            nUsed;
+};
+
+struct _CPLXMLArena
+{
+    CPLXMLArenaBlock *psCurrent;
+};
+
+static const size_t knArenaMinBlockSize = 64 * 1024;
+static const size_t knArenaMaxBlockSize = 16 * 1024 * 1024;
+
 static CPLXMLNode *_CPLCreateXMLNode( CPLXMLNode *poParent,
                                       CPLXMLNodeType eType,
                                       const char *pszText );
+static CPLXMLNode *CPLParseXMLStringInternal( const char *pszString,
+                                              CPLXMLArena *psArena );
 
 /************************************************************************/
 /*                              ReadChar()                              */
@@ -186,6 +209,77 @@ static CPL_INLINE bool _AddToToken( ParseContext *psContext, char chNewChar )
 #define AddToToken(psContext, chNewChar) \
     if( !_AddToToken(psContext, chNewChar)) goto fail;
 
+/************************************************************************/
+/*                          AddInputToToken()                           */
+/*                                                                      */
+/*      Append the next nLen characters of the input to the token in    */
+/*      one go, and consume them.  This is the bulk equivalent of a     */
+/*      ReadChar() / AddToToken() loop, used for text content, quoted   */
+/*      strings, comments and CDATA sections.                           */
+/************************************************************************/
+
+static bool AddInputToToken( ParseContext *psContext, size_t nLen )
+
+{
+    while( psContext->nTokenSize + nLen + 2 > psContext->nTokenMaxSize )
+    {
+        if( !ReallocToken(psContext) )
+            return false;
+    }
+
+    const char *pszSrc = psContext->pszInput + psContext->nInputOffset;
+    memcpy( psContext->pszToken + psContext->nTokenSize, pszSrc, nLen );
+    psContext->nTokenSize += nLen;
+    psContext->pszToken[psContext->nTokenSize] = '\0';
+
+    const char *pszEnd = pszSrc + nLen;
+    while( (pszSrc = static_cast<const char *>(
+                memchr(pszSrc, 10, pszEnd - pszSrc))) != NULL )
+    {
+        psContext->nInputLine++;
+        pszSrc++;
+    }
+    psContext->nInputOffset += static_cast<int>(nLen);
+
+    return true;
+}
+
+/************************************************************************/
+/*                         InputLengthUntil()                           */
+/*                                                                      */
+/*      Return the number of characters before the next occurrence     */
+/*      of pszDelimiter in the remaining input, or up to the end of     */
+/*      the input if it is not found.                                   */
+/************************************************************************/
+
+static size_t InputLengthUntil( const ParseContext *psContext,
+                                const char *pszDelimiter )
+{
+    const char *pszStart = psContext->pszInput + psContext->nInputOffset;
+    const char *pszEnd = pszDelimiter[1] == '\0' ?
+        strchr( pszStart, pszDelimiter[0] ) : strstr( pszStart, pszDelimiter );
+    return pszEnd != NULL ? static_cast<size_t>(pszEnd - pszStart)
+                          : strlen( pszStart );
+}
+
+/************************************************************************/
+/*                          UnescapeToken()                             */
+/************************************************************************/
+
+static void UnescapeToken( ParseContext *psContext )
+{
+    // Do we need to unescape it?
+    if( memchr(psContext->pszToken, '&', psContext->nTokenSize) != NULL )
+    {
+        int nLength = 0;
+        char *pszUnescaped = CPLUnescapeString( psContext->pszToken,
+                                                &nLength, CPLES_XML );
+        strcpy( psContext->pszToken, pszUnescaped );
+        CPLFree( pszUnescaped );
+        psContext->nTokenSize = strlen(psContext->pszToken );
+    }
+}
+
 /************************************************************************/
 /*                             ReadToken()                              */
 /************************************************************************/
@@ -200,10 +294,14 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
     while( isspace(static_cast<unsigned char>(chNext)) )
         chNext = ReadChar( psContext );
 
+    // Only check for comments, DOCTYPE and CDATA after "<!".
+    const bool bMarkupDeclaration =
+        chNext == '<' && psContext->pszInput[psContext->nInputOffset] == '!';
+
 /* -------------------------------------------------------------------- */
 /*      Handle comments.                                                */
 /* -------------------------------------------------------------------- */
-    if( chNext == '<'
+    if( bMarkupDeclaration
         && STARTS_WITH_CI(psContext->pszInput+psContext->nInputOffset, "!--") )
     {
         psContext->eTokenType = TComment;
@@ -213,10 +311,9 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
         ReadChar(psContext);
         ReadChar(psContext);
 
-        while( !STARTS_WITH_CI(psContext->pszInput+psContext->nInputOffset,
-                               "-->")
-               && (chNext = ReadChar(psContext)) != '\0' )
-            AddToToken( psContext, chNext );
+        if( !AddInputToToken( psContext,
+                              InputLengthUntil(psContext, "-->") ) )
+            goto fail;
 
         // Skip "-->" characters.
         ReadChar(psContext);
@@ -226,7 +323,7 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
 /* -------------------------------------------------------------------- */
 /*      Handle DOCTYPE.                                                 */
 /* -------------------------------------------------------------------- */
-    else if( chNext == '<' &&
+    else if( bMarkupDeclaration &&
              STARTS_WITH_CI(psContext->pszInput+psContext->nInputOffset,
                             "!DOCTYPE") )
     {
@@ -304,7 +401,7 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
 /* -------------------------------------------------------------------- */
 /*      Handle CDATA.                                                   */
 /* -------------------------------------------------------------------- */
-    else if( chNext == '<' &&
+    else if( bMarkupDeclaration &&
              STARTS_WITH_CI(
                  psContext->pszInput+psContext->nInputOffset, "![CDATA[") )
     {
@@ -320,10 +417,9 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
         ReadChar( psContext );
         ReadChar( psContext );
 
-        while( !STARTS_WITH_CI(psContext->pszInput+psContext->nInputOffset,
-                               "]]>")
-               && (chNext = ReadChar(psContext)) != '\0' )
-            AddToToken( psContext, chNext );
+        if( !AddInputToToken( psContext,
+                              InputLengthUntil(psContext, "]]>") ) )
+            goto fail;
 
         // Skip "]]>" characters.
         ReadChar(psContext);
@@ -379,43 +475,16 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
 /* -------------------------------------------------------------------- */
 /*      Collect a quoted string.                                        */
 /* -------------------------------------------------------------------- */
-    else if( psContext->bInElement && chNext == '"' )
-    {
-        psContext->eTokenType = TString;
-
-        while( (chNext = ReadChar(psContext)) != '"'
-               && chNext != '\0' )
-            AddToToken( psContext, chNext );
-
-        if( chNext != '"' )
-        {
-            psContext->eTokenType = TNone;
-            eLastErrorType = CE_Failure;
-            CPLError( eLastErrorType, CPLE_AppDefined,
-                "Parse error on line %d, reached EOF before closing quote.",
-                psContext->nInputLine);
-        }
-
-        // Do we need to unescape it?
-        if( strchr(psContext->pszToken, '&') != NULL )
-        {
-            int nLength = 0;
-            char *pszUnescaped = CPLUnescapeString( psContext->pszToken,
-                                                    &nLength, CPLES_XML );
-            strcpy( psContext->pszToken, pszUnescaped );
-            CPLFree( pszUnescaped );
-            psContext->nTokenSize = strlen(psContext->pszToken );
-        }
-    }
-    else if( psContext->bInElement && chNext == '\'' )
+    else if( psContext->bInElement && (chNext == '"' || chNext == '\'') )
     {
         psContext->eTokenType = TString;
 
-        while( (chNext = ReadChar(psContext)) != '\''
-               && chNext != '\0' )
-            AddToToken( psContext, chNext );
+        const char szQuote[2] = { chNext, '\0' };
+        if( !AddInputToToken( psContext,
+                              InputLengthUntil(psContext, szQuote) ) )
+            goto fail;
 
-        if( chNext != '\'' )
+        if( ReadChar(psContext) != chNext )
         {
             psContext->eTokenType = TNone;
             eLastErrorType = CE_Failure;
@@ -424,16 +493,7 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
                 psContext->nInputLine);
         }
 
-        // Do we need to unescape it?
-        if( strchr(psContext->pszToken, '&') != NULL )
-        {
-            int nLength = 0;
-            char *pszUnescaped = CPLUnescapeString( psContext->pszToken,
-                                                    &nLength, CPLES_XML );
-            strcpy( psContext->pszToken, pszUnescaped );
-            CPLFree( pszUnescaped );
-            psContext->nTokenSize = strlen(psContext->pszToken );
-        }
+        UnescapeToken( psContext );
     }
 /* -------------------------------------------------------------------- */
 /*      Collect an unquoted string, terminated by a open angle          */
@@ -444,21 +504,10 @@ static XMLTokenType ReadToken( ParseContext *psContext, CPLErr& eLastErrorType )
         psContext->eTokenType = TString;
 
         AddToToken( psContext, chNext );
-        while( (chNext = ReadChar(psContext)) != '<'
-               && chNext != '\0' )
-            AddToToken( psContext, chNext );
-        UnreadChar( psContext, chNext );
+        if( !AddInputToToken( psContext, InputLengthUntil(psContext, "<") ) )
+            goto fail;
 
-        // Do we need to unescape it?
-        if( strchr(psContext->pszToken, '&') != NULL )
-        {
-            int nLength = 0;
-            char *pszUnescaped = CPLUnescapeString( psContext->pszToken,
-                                                    &nLength, CPLES_XML );
-            strcpy( psContext->pszToken, pszUnescaped );
-            CPLFree( pszUnescaped );
-            psContext->nTokenSize = strlen(psContext->pszToken );
-        }
+        UnescapeToken( psContext );
     }
 
 /* -------------------------------------------------------------------- */
@@ -584,6 +633,119 @@ static void AttachNode( ParseContext *psContext, CPLXMLNode *psNode )
     }
 }
 
+/************************************************************************/
+/*                          InitParseContext()                          */
+/************************************************************************/
+
+static bool InitParseContext( ParseContext *psContext, const char *pszString )
+
+{
+/* -------------------------------------------------------------------- */
+/*      Check for a UTF-8 BOM and skip if found                         */
+/*                                                                      */
+/*      TODO: BOM is variable-length parameter and depends on encoding. */
+/*            Add BOM detection for other encodings.                    */
+/* -------------------------------------------------------------------- */
+
+    // Used to skip to actual beginning of XML data.
+    if( ( static_cast<unsigned char>(pszString[0]) == 0xEF )
+        && ( static_cast<unsigned char>(pszString[1]) == 0xBB )
+        && ( static_cast<unsigned char>(pszString[2]) == 0xBF) )
+    {
+        pszString += 3;
+    }
+
+    psContext->pszInput = pszString;
+    psContext->nInputOffset = 0;
+    psContext->nInputLine = 0;
+    psContext->bInElement = false;
+    psContext->nTokenMaxSize = 10;
+    psContext->pszToken =
+        static_cast<char *>(VSIMalloc(psContext->nTokenMaxSize));
+    if( psContext->pszToken == NULL )
+        return false;
+    psContext->nTokenSize = 0;
+    psContext->eTokenType = TNone;
+    psContext->nStackMaxSize = 0;
+    psContext->nStackSize = 0;
+    psContext->papsStack = NULL;
+    psContext->psFirstNode = NULL;
+    psContext->psLastNode = NULL;
+    psContext->psArena = NULL;
+
+    return true;
+}
+
+/************************************************************************/
+/*                          CPLXMLArenaAlloc()                          */
+/************************************************************************/
+
+static void *CPLXMLArenaAlloc( CPLXMLArena *psArena, size_t nSize )
+
+{
+    // Keep every allocation suitably aligned for a CPLXMLNode.
+    const size_t nAlign = sizeof(void *);
+    nSize = (nSize + nAlign - 1) / nAlign * nAlign;
+
+    CPLXMLArenaBlock *psBlock = psArena->psCurrent;
+    if( psBlock == NULL || psBlock->nSize - psBlock->nUsed < nSize )
+    {
+        size_t nBlockSize = psBlock == NULL ? knArenaMinBlockSize :
+            std::min(psBlock->nSize * 2, knArenaMaxBlockSize);
+        if( nBlockSize < nSize )
+            nBlockSize = nSize;
+        CPLXMLArenaBlock *psNewBlock = static_cast<CPLXMLArenaBlock *>(
+            VSIMalloc(sizeof(CPLXMLArenaBlock) + nBlockSize));
+        if( psNewBlock == NULL )
+        {
+            CPLError(CE_Failure, CPLE_OutOfMemory,
+                     "Cannot allocate %lu bytes for XML arena",
+                     static_cast<unsigned long>(nBlockSize));
+            return NULL;
+        }
+        psNewBlock->psPrev = psBlock;
+        psNewBlock->nSize = nBlockSize;
+        psNewBlock->nUsed = 0;
+        psArena->psCurrent = psNewBlock;
+        psBlock = psNewBlock;
+    }
+
+    void *pRet = reinterpret_cast<GByte *>(psBlock + 1) + psBlock->nUsed;
+    psBlock->nUsed += nSize;
+    return pRet;
+}
+
+/************************************************************************/
+/*                          CreateParsedNode()                          */
+/*                                                                      */
+/*      Create a node for the parser.  Without an arena this is a      */
+/*      regular heap node.  Within an arena, the node and its value    */
+/*      are carved out of a single chunk of the arena.                  */
+/************************************************************************/
+
+static CPLXMLNode *CreateParsedNode( ParseContext *psContext,
+                                     CPLXMLNodeType eType,
+                                     const char *pszText )
+
+{
+    if( psContext->psArena == NULL )
+        return _CPLCreateXMLNode( NULL, eType, pszText );
+
+    const size_t nLen = strlen(pszText);
+    CPLXMLNode *psNode = static_cast<CPLXMLNode *>(
+        CPLXMLArenaAlloc(psContext->psArena, sizeof(CPLXMLNode) + nLen + 1));
+    if( psNode == NULL )
+        return NULL;
+
+    psNode->eType = eType;
+    psNode->pszValue = reinterpret_cast<char *>(psNode + 1);
+    memcpy( psNode->pszValue, pszText, nLen + 1 );
+    psNode->psNext = NULL;
+    psNode->psChild = NULL;
+
+    return psNode;
+}
+
 /************************************************************************/
 /*                         CPLParseXMLString()                          */
 /************************************************************************/
@@ -613,6 +775,17 @@ static void AttachNode( ParseContext *psContext, CPLXMLNode *psNode )
 
 CPLXMLNode *CPLParseXMLString( const char *pszString )
 
+{
+    return CPLParseXMLStringInternal( pszString, NULL );
+}
+
+/************************************************************************/
+/*                      CPLParseXMLStringInternal()                     */
+/************************************************************************/
+
+static CPLXMLNode *CPLParseXMLStringInternal( const char *pszString,
+                                              CPLXMLArena *psArena )
+
 {
     if( pszString == NULL )
     {
@@ -629,40 +802,13 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
     // Reset it now.
     CPLErrorReset();
 
-/* -------------------------------------------------------------------- */
-/*      Check for a UTF-8 BOM and skip if found                         */
-/*                                                                      */
-/*      TODO: BOM is variable-length parameter and depends on encoding. */
-/*            Add BOM detection for other encodings.                    */
-/* -------------------------------------------------------------------- */
-
-    // Used to skip to actual beginning of XML data.
-    if( ( static_cast<unsigned char>(pszString[0]) == 0xEF )
-        && ( static_cast<unsigned char>(pszString[1]) == 0xBB )
-        && ( static_cast<unsigned char>(pszString[2]) == 0xBF) )
-    {
-        pszString += 3;
-    }
-
 /* -------------------------------------------------------------------- */
 /*      Initialize parse context.                                       */
 /* -------------------------------------------------------------------- */
     ParseContext sContext;
-    sContext.pszInput = pszString;
-    sContext.nInputOffset = 0;
-    sContext.nInputLine = 0;
-    sContext.bInElement = false;
-    sContext.nTokenMaxSize = 10;
-    sContext.pszToken = static_cast<char *>(VSIMalloc(sContext.nTokenMaxSize));
-    if( sContext.pszToken == NULL )
+    if( !InitParseContext( &sContext, pszString ) )
         return NULL;
-    sContext.nTokenSize = 0;
-    sContext.eTokenType = TNone;
-    sContext.nStackMaxSize = 0;
-    sContext.nStackSize = 0;
-    sContext.papsStack = NULL;
-    sContext.psFirstNode = NULL;
-    sContext.psLastNode = NULL;
+    sContext.psArena = psArena;
 
 #ifdef DEBUG
     bool bRecoverableError = true;
@@ -692,7 +838,7 @@ CPLXMLNode *CPLParseXMLString( const char *pszString )
             CPLXMLNode *psElement = NULL;
             if( sContext.pszToken[0] != '/' )
             {
-                psElement = _CPLCreateXMLNode( NULL, CXT_Element,
+                psElement = CreateParsedNode( &sContext, CXT_Element,
                                               sContext.pszToken );
                 if( !psElement ) break;
                 AttachNode( &sContext, psElement );
@@ -779,7 +925,7 @@ end_processing_close:
         else if( sContext.eTokenType == TToken )
         {
             CPLXMLNode *psAttr =
-                _CPLCreateXMLNode(NULL, CXT_Attribute, sContext.pszToken);
+                CreateParsedNode(&sContext, CXT_Attribute, sContext.pszToken);
             if( !psAttr ) break;
             AttachNode( &sContext, psAttr );
 
@@ -793,25 +939,32 @@ end_processing_close:
                       sContext.papsStack[sContext.nStackSize - 1]
                               .psFirstNode->psChild == psAttr )
                 {
-                    CPLDestroyXMLNode(psAttr);
-                    sContext.papsStack[sContext.nStackSize - 1]
-                        .psFirstNode->psChild = NULL;
+                    CPLXMLNode *psPI =
+                        sContext.papsStack[sContext.nStackSize - 1].psFirstNode;
+                    if( psArena == NULL )
+                        CPLDestroyXMLNode(psAttr);
+                    psPI->psChild = NULL;
                     sContext.papsStack[sContext.nStackSize - 1].psLastChild =
                         NULL;
 
-                    sContext.papsStack[sContext.nStackSize - 1]
-                        .psFirstNode->pszValue = static_cast<char *>(CPLRealloc(
-                        sContext.papsStack[sContext.nStackSize - 1]
-                            .psFirstNode->pszValue,
-                        strlen(sContext.papsStack[sContext.nStackSize - 1]
-                                   .psFirstNode->pszValue) +
-                            1 + strlen(sContext.pszToken) + 1));
-                    strcat(sContext.papsStack[sContext.nStackSize - 1]
-                               .psFirstNode->pszValue,
-                           " ");
-                    strcat(sContext.papsStack[sContext.nStackSize - 1]
-                               .psFirstNode->pszValue,
-                           sContext.pszToken);
+                    const size_t nNewSize = strlen(psPI->pszValue) +
+                                            1 + strlen(sContext.pszToken) + 1;
+                    if( psArena == NULL )
+                    {
+                        psPI->pszValue = static_cast<char *>(
+                            CPLRealloc(psPI->pszValue, nNewSize));
+                    }
+                    else
+                    {
+                        char *pszNewValue = static_cast<char *>(
+                            CPLXMLArenaAlloc(psArena, nNewSize));
+                        if( pszNewValue == NULL )
+                            break;
+                        strcpy(pszNewValue, psPI->pszValue);
+                        psPI->pszValue = pszNewValue;
+                    }
+                    strcat(psPI->pszValue, " ");
+                    strcat(psPI->pszValue, sContext.pszToken);
                     continue;
                 }
 
@@ -853,7 +1006,9 @@ end_processing_close:
                 break;
             }
 
-            if( !_CPLCreateXMLNode( psAttr, CXT_Text, sContext.pszToken ) )
+            psAttr->psChild =
+                CreateParsedNode( &sContext, CXT_Text, sContext.pszToken );
+            if( psAttr->psChild == NULL )
                 break;
         }
 
@@ -923,7 +1078,7 @@ end_processing_close:
         else if( sContext.eTokenType == TComment )
         {
             CPLXMLNode *psValue =
-                _CPLCreateXMLNode(NULL, CXT_Comment, sContext.pszToken);
+                CreateParsedNode(&sContext, CXT_Comment, sContext.pszToken);
             if( !psValue ) break;
             AttachNode( &sContext, psValue );
         }
@@ -933,7 +1088,7 @@ end_processing_close:
         else if( sContext.eTokenType == TLiteral )
         {
             CPLXMLNode *psValue =
-                _CPLCreateXMLNode(NULL, CXT_Literal, sContext.pszToken);
+                CreateParsedNode(&sContext, CXT_Literal, sContext.pszToken);
             if( !psValue ) break;
             AttachNode( &sContext, psValue );
         }
@@ -943,7 +1098,7 @@ end_processing_close:
         else if( sContext.eTokenType == TString && !sContext.bInElement )
         {
             CPLXMLNode *psValue =
-                _CPLCreateXMLNode(NULL, CXT_Text, sContext.pszToken);
+                CreateParsedNode(&sContext, CXT_Text, sContext.pszToken);
             if( !psValue ) break;
             AttachNode( &sContext, psValue );
         }
@@ -997,7 +1152,9 @@ end_processing_close:
     // has been set we would never get failures
     if( eLastErrorType == CE_Failure )
     {
-        CPLDestroyXMLNode( sContext.psFirstNode );
+        // Nodes allocated in an arena are released with the arena.
+        if( psArena == NULL )
+            CPLDestroyXMLNode( sContext.psFirstNode );
         sContext.psFirstNode = NULL;
         sContext.psLastNode = NULL;
     }
@@ -1011,6 +1168,374 @@ end_processing_close:
     return sContext.psFirstNode;
 }
 
+/************************************************************************/
+/*                         CPLXMLArenaCreate()                          */
+/************************************************************************/
+
+/**
+ * \brief Create an arena for read-only XML trees.
+ *
+ * An arena serves all the nodes and values of the trees parsed into it with
+ * CPLParseXMLStringInArena() from a few large memory blocks, instead of two
+ * heap allocations per node.  All those trees are freed at once by
+ * CPLXMLArenaDestroy().
+ *
+ * @return a new arena, to be freed with CPLXMLArenaDestroy().
+ *
+ * @since GDAL 2.3
+ */
+
+CPLXMLArena *CPLXMLArenaCreate()
+
+{
+    return static_cast<CPLXMLArena *>(CPLCalloc(sizeof(CPLXMLArena), 1));
+}
+
+/************************************************************************/
+/*                         CPLXMLArenaDestroy()                         */
+/************************************************************************/
+
+/**
+ * \brief Destroy an arena and all the trees it holds.
+ *
+ * @param psArena the arena to free, or NULL.
+ *
+ * @since GDAL 2.3
+ */
+
+void CPLXMLArenaDestroy( CPLXMLArena *psArena )
+
+{
+    if( psArena == NULL )
+        return;
+
+    CPLXMLArenaBlock *psBlock = psArena->psCurrent;
+    while( psBlock != NULL )
+    {
+        CPLXMLArenaBlock *psPrev = psBlock->psPrev;
+        VSIFree( psBlock );
+        psBlock = psPrev;
+    }
+    CPLFree( psArena );
+}
+
+/************************************************************************/
+/*                      CPLParseXMLStringInArena()                      */
+/************************************************************************/
+
+/**
+ * \brief Parse an XML string into a read-only tree held by an arena.
+ *
+ * This is the same as CPLParseXMLString(), except that the nodes of the
+ * returned tree and their values are allocated in psArena.  This is
+ * significantly faster for large documents that are only inspected, such
+ * as VRT files or GetCapabilities responses.
+ *
+ * The returned tree is owned by the arena and remains valid until
+ * CPLXMLArenaDestroy() is called.  It must not be passed to
+ * CPLDestroyXMLNode(), and must not be modified with functions that free or
+ * reallocate nodes or values, such as CPLSetXMLValue(), CPLRemoveXMLChild()
+ * or CPLAddXMLChild().  CPLCloneXMLTree() can be used to get a regular,
+ * modifiable, copy of a part of it.
+ *
+ * @param pszString the document to parse.
+ * @param psArena the arena, created with CPLXMLArenaCreate(), that will hold
+ * the tree.
+ *
+ * @return parsed tree or NULL on error.
+ *
+ * @since GDAL 2.3
+ */
+
+CPLXMLNode *CPLParseXMLStringInArena( const char *pszString,
+                                      CPLXMLArena *psArena )
+
+{
+    VALIDATE_POINTER1( psArena, "CPLParseXMLStringInArena", NULL );
+
+    return CPLParseXMLStringInternal( pszString, psArena );
+}
+
+/************************************************************************/
+/*                     CPLParseXMLStringStreaming()                     */
+/************************************************************************/
+
+/**
+ * \brief Parse an XML string, reporting its content through callbacks.
+ *
+ * Unlike CPLParseXMLString(), no tree is built.  The document is scanned
+ * once and each piece of it is reported, in document order, to the
+ * provided callbacks :
+ * <ul>
+ * <li>pfnStartElement is called once the start tag of an element has been
+ * read, with the element name and a NULL terminated list of alternating
+ * attribute names and (unescaped) values.  Processing instructions such as
+ * &lt;?xml ... ?&gt; are reported as elements whose name starts with '?'.
+ * </li>
+ * <li>pfnEndElement is called with the element name when the element is
+ * closed, including for empty elements.</li>
+ * <li>pfnText is called with CXT_Text for (unescaped) text content and
+ * CDATA sections, CXT_Comment for comments and CXT_Literal for DOCTYPE
+ * declarations.</li>
+ * </ul>
+ *
+ * The strings passed to the callbacks are only valid during the call.
+ * Any of the callbacks may be NULL.  A callback may return FALSE to stop
+ * parsing, in which case this function returns FALSE without emitting an
+ * error.
+ *
+ * The accepted syntax is the same as CPLParseXMLString(), and the same errors
+ * are reported via CPLError().
+ *
+ * @param pszString the document to parse.
+ * @param pfnStartElement callback for start tags, or NULL.
+ * @param pfnEndElement callback for end tags, or NULL.
+ * @param pfnText callback for text, comments and literals, or NULL.
+ * @param pUserData user data passed to the callbacks.
+ *
+ * @return TRUE if the whole document was successfully parsed, FALSE if a
+ * parsing error occurred or a callback requested to stop.
+ *
+ * @since GDAL 2.3
+ */
+
+int CPLParseXMLStringStreaming( const char *pszString,
+                                CPLXMLStartElementCallback pfnStartElement,
+                                CPLXMLEndElementCallback pfnEndElement,
+                                CPLXMLTextCallback pfnText,
+                                void *pUserData )
+
+{
+    if( pszString == NULL )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "CPLParseXMLStringStreaming() called with NULL pointer." );
+        return FALSE;
+    }
+
+    // Save back error context.
+    const CPLErr eErrClass = CPLGetLastErrorType();
+    const CPLErrorNum nErrNum = CPLGetLastErrorNo();
+    const CPLString osErrMsg = CPLGetLastErrorMsg();
+
+    // Reset it now.
+    CPLErrorReset();
+
+    ParseContext sContext;
+    if( !InitParseContext( &sContext, pszString ) )
+        return FALSE;
+
+    // Names of the currently open elements.
+    std::vector<CPLString> aosStack;
+    // Start tag being read, and its attributes as name/value pairs.
+    bool bInStartTag = false;
+    CPLString osStartTag;
+    std::vector<CPLString> aosAttributes;
+    std::vector<const char *> apszAttributes;
+
+    CPLErr eLastErrorType = CE_None;
+    bool bStopped = false;
+
+    while( !bStopped && ReadToken( &sContext, eLastErrorType ) != TNone )
+    {
+/* -------------------------------------------------------------------- */
+/*      Start or end of an element.                                     */
+/* -------------------------------------------------------------------- */
+        if( sContext.eTokenType == TOpen )
+        {
+            if( ReadToken(&sContext, eLastErrorType) != TToken )
+            {
+                eLastErrorType = CE_Failure;
+                CPLError( eLastErrorType, CPLE_AppDefined,
+                          "Line %d: Didn't find element token after "
+                          "open angle bracket.",
+                          sContext.nInputLine );
+                break;
+            }
+
+            if( sContext.pszToken[0] != '/' )
+            {
+                bInStartTag = true;
+                osStartTag = sContext.pszToken;
+                aosAttributes.clear();
+                continue;
+            }
+
+            if( aosStack.empty() ||
+                !EQUAL(sContext.pszToken + 1, aosStack.back()) )
+            {
+                eLastErrorType = CE_Failure;
+                CPLError( eLastErrorType, CPLE_AppDefined,
+                          "Line %d: <%.500s> doesn't have matching <%.500s>.",
+                          sContext.nInputLine,
+                          sContext.pszToken, sContext.pszToken + 1 );
+                break;
+            }
+
+            if( strcmp(sContext.pszToken + 1, aosStack.back()) != 0 )
+            {
+                eLastErrorType = CE_Warning;
+                CPLError( eLastErrorType, CPLE_AppDefined,
+                          "Line %d: <%.500s> matches <%.500s>, but the case "
+                          "isn't the same.  Going on, but this is invalid "
+                          "XML that might be rejected in future versions.",
+                          sContext.nInputLine,
+                          aosStack.back().c_str(), sContext.pszToken );
+            }
+
+            if( ReadToken(&sContext, eLastErrorType) != TClose )
+            {
+                eLastErrorType = CE_Failure;
+                CPLError( eLastErrorType, CPLE_AppDefined,
+                          "Line %d: Missing close angle bracket "
+                          "after <%.500s.",
+                          sContext.nInputLine,
+                          sContext.pszToken );
+                break;
+            }
+
+            if( pfnEndElement != NULL &&
+                !pfnEndElement(pUserData, aosStack.back()) )
+                bStopped = true;
+            aosStack.pop_back();
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Attribute of the start tag being read.                          */
+/* -------------------------------------------------------------------- */
+        else if( sContext.eTokenType == TToken && bInStartTag )
+        {
+            const CPLString osName(sContext.pszToken);
+
+            if( ReadToken(&sContext, eLastErrorType) != TEqual )
+            {
+                // Parse stuff like <?valbuddy_schematron
+                // ../wmtsSimpleGetCapabilities.sch?>
+                if( osStartTag[0] == '?' && aosAttributes.empty() )
+                {
+                    osStartTag += " ";
+                    osStartTag += sContext.pszToken;
+                    continue;
+                }
+
+                eLastErrorType = CE_Failure;
+                CPLError( eLastErrorType, CPLE_AppDefined,
+                          "Line %d: Didn't find expected '=' for value of "
+                          "attribute '%.500s'.",
+                          sContext.nInputLine, osName.c_str() );
+                break;
+            }
+
+            if( ReadToken(&sContext, eLastErrorType) == TToken )
+            {
+                eLastErrorType = CE_Warning;
+                CPLError( eLastErrorType, CPLE_AppDefined,
+                          "Line %d: Attribute value should be single or double "
+                          "quoted.  Going on, but this is invalid XML that "
+                          "might be rejected in future versions.",
+                          sContext.nInputLine );
+            }
+            else if( sContext.eTokenType != TString )
+            {
+                eLastErrorType = CE_Failure;
+                CPLError( eLastErrorType, CPLE_AppDefined,
+                          "Line %d: Didn't find expected attribute value.",
+                          sContext.nInputLine );
+                break;
+            }
+
+            aosAttributes.push_back(osName);
+            aosAttributes.push_back(sContext.pszToken);
+        }
+
+/* -------------------------------------------------------------------- */
+/*      End of a start tag: >, /> or ?>                                 */
+/* -------------------------------------------------------------------- */
+        else if( (sContext.eTokenType == TClose ||
+                  sContext.eTokenType == TSlashClose ||
+                  sContext.eTokenType == TQuestionClose) && bInStartTag )
+        {
+            if( sContext.eTokenType == TQuestionClose &&
+                osStartTag[0] != '?' )
+            {
+                eLastErrorType = CE_Failure;
+                CPLError( eLastErrorType, CPLE_AppDefined,
+                          "Line %d: Found '?>' without matching '<?'.",
+                          sContext.nInputLine );
+                break;
+            }
+
+            bInStartTag = false;
+            apszAttributes.resize(aosAttributes.size() + 1);
+            for( size_t i = 0; i < aosAttributes.size(); i++ )
+                apszAttributes[i] = aosAttributes[i].c_str();
+            apszAttributes.back() = NULL;
+
+            if( pfnStartElement != NULL &&
+                !pfnStartElement(pUserData, osStartTag, &apszAttributes[0]) )
+            {
+                bStopped = true;
+            }
+            else if( sContext.eTokenType == TClose )
+            {
+                aosStack.push_back(osStartTag);
+            }
+            else if( pfnEndElement != NULL &&
+                     !pfnEndElement(pUserData, osStartTag) )
+            {
+                bStopped = true;
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Comments, literals and text content.                            */
+/* -------------------------------------------------------------------- */
+        else if( sContext.eTokenType == TComment ||
+                 sContext.eTokenType == TLiteral ||
+                 (sContext.eTokenType == TString && !sContext.bInElement) )
+        {
+            const CPLXMLNodeType eType =
+                sContext.eTokenType == TComment ? CXT_Comment :
+                sContext.eTokenType == TLiteral ? CXT_Literal : CXT_Text;
+            if( pfnText != NULL &&
+                !pfnText(pUserData, eType, sContext.pszToken) )
+                bStopped = true;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Anything else is an error.                                      */
+/* -------------------------------------------------------------------- */
+        else
+        {
+            eLastErrorType = CE_Failure;
+            CPLError( eLastErrorType, CPLE_AppDefined,
+                      "Parse error at line %d, unexpected token:%.500s",
+                      sContext.nInputLine, sContext.pszToken );
+            break;
+        }
+    }
+
+    if( !bStopped && eLastErrorType != CE_Failure &&
+        (bInStartTag || !aosStack.empty()) )
+    {
+        eLastErrorType = CE_Failure;
+        CPLError( eLastErrorType, CPLE_AppDefined,
+                  "Parse error at EOF, not all elements have been closed, "
+                  "starting with %.500s",
+                  bInStartTag ? osStartTag.c_str() : aosStack.back().c_str() );
+    }
+
+    CPLFree( sContext.pszToken );
+
+    if( eLastErrorType == CE_None )
+    {
+        // Restore initial error state.
+        CPLErrorSetState(eErrClass, nErrNum, osErrMsg);
+    }
+
+    return !bStopped && eLastErrorType != CE_Failure;
+}
+
 /************************************************************************/
 /*                            _GrowBuffer()                             */
 /************************************************************************/
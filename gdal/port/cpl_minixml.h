@@ -151,6 +151,37 @@ void       CPL_DLL CPLStripXMLNamespace( CPLXMLNode *psRoot,
                                          int bRecurse );
 void       CPL_DLL CPLCleanXMLElementName( char * );
 
+/** Opaque type for a memory arena holding read-only XML trees.
+ * @since GDAL 2.3 */
+typedef struct _CPLXMLArena CPLXMLArena;
+
+CPLXMLArena CPL_DLL *CPLXMLArenaCreate( void );
+void       CPL_DLL CPLXMLArenaDestroy( CPLXMLArena *psArena );
+CPLXMLNode CPL_DLL *CPLParseXMLStringInArena( const char *pszString,
+                                              CPLXMLArena *psArena );
+
+/** Callback of CPLParseXMLStringStreaming() for start tags.
+ * @since GDAL 2.3 */
+typedef int (*CPLXMLStartElementCallback)( void *pUserData,
+                                           const char *pszName,
+                                           const char * const *papszAttributes );
+/** Callback of CPLParseXMLStringStreaming() for end tags.
+ * @since GDAL 2.3 */
+typedef int (*CPLXMLEndElementCallback)( void *pUserData,
+                                         const char *pszName );
+/** Callback of CPLParseXMLStringStreaming() for text, comments and literals.
+ * @since GDAL 2.3 */
+typedef int (*CPLXMLTextCallback)( void *pUserData,
+                                   CPLXMLNodeType eType,
+                                   const char *pszText );
+
+int        CPL_DLL CPLParseXMLStringStreaming(
+                                   const char *pszString,
+                                   CPLXMLStartElementCallback pfnStartElement,
+                                   CPLXMLEndElementCallback pfnEndElement,
+                                   CPLXMLTextCallback pfnText,
+                                   void *pUserData );
+
 CPLXMLNode CPL_DLL *CPLParseXMLFile( const char *pszFilename );
 int        CPL_DLL CPLSerializeXMLTreeToFile( const CPLXMLNode *psTree,
                                               const char *pszFilename );
@@ -42,13 +42,16 @@
 #  include <sys/stat.h>
 #endif
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "cpl_atomic_ops.h"
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_hash_set.h"
 #include "cpl_multiproc.h"
 #include "cpl_string.h"
 
@@ -59,11 +62,14 @@ CPL_CVSID("$Id$")
 /*
 ** Notes on Multithreading:
 **
-** VSIMemFilesystemHandler: This class maintains a mutex to protect
-** access and update of the oFileList array which has all the "files" in
-** the memory filesystem area.  It is expected that multiple threads would
-** want to create and read different files at the same time and so might
-** collide access oFileList without the mutex.
+** VSIMemFilesystemHandler: This class maintains the list of all the "files"
+** in the memory filesystem area.  It is expected that multiple threads would
+** want to create and read different files at the same time, so the list is
+** split in a fixed number of shards, selected by a hash of the filename, each
+** one with its own mutex.  Operations on a single file (Open, Stat, Unlink,
+** Mkdir) only lock the shard of that file.  Operations that need a consistent
+** view of the whole filesystem (ReadDirEx, Rename) lock all shards, always in
+** increasing index order to avoid dead-locks.
 **
 ** VSIMemFile: In theory we could allow different threads to update the
 ** the same memory file, but for simplicity we restrict to single writer,
@@ -154,8 +160,18 @@ class VSIMemHandle CPL_FINAL : public VSIVirtualHandle
 class VSIMemFilesystemHandler CPL_FINAL : public VSIFilesystemHandler
 {
   public:
-    std::map<CPLString, VSIMemFile*> oFileList;
-    CPLMutex        *hMutex;
+    // Number of independently locked partitions of the file list.
+    static const int knShardCount = 16;
+
+    struct Shard
+    {
+        std::map<CPLString, VSIMemFile*> oFileList;
+        CPLMutex        *hMutex;
+
+        Shard() : hMutex(NULL) {}
+    };
+
+    Shard            aoShards[knShardCount];
 
                      VSIMemFilesystemHandler();
     virtual          ~VSIMemFilesystemHandler();
@@ -179,9 +195,45 @@ class VSIMemFilesystemHandler CPL_FINAL : public VSIFilesystemHandler
 
     static  void     NormalizePath( CPLString & );
 
+    Shard&           GetShard( const CPLString& osFilename );
+    VSIMemFile      *GetFile_unlocked( const CPLString& osFilename );
+    void             AddFile_unlocked( VSIMemFile *poFile );
     int              Unlink_unlocked( const char *pszFilename );
 };
 
+/************************************************************************/
+/* ==================================================================== */
+/*                        VSIMemAllShardsHolder                         */
+/* ==================================================================== */
+/************************************************************************/
+
+// Scoped lock of all the shards of a VSIMemFilesystemHandler.
+class VSIMemAllShardsHolder
+{
+    VSIMemFilesystemHandler *m_poHandler;
+
+    CPL_DISALLOW_COPY_ASSIGN(VSIMemAllShardsHolder)
+
+  public:
+    explicit VSIMemAllShardsHolder( VSIMemFilesystemHandler *poHandler ) :
+        m_poHandler(poHandler)
+    {
+        for( int i = 0; i < VSIMemFilesystemHandler::knShardCount; ++i )
+        {
+            CPLCreateOrAcquireMutex( &(m_poHandler->aoShards[i].hMutex),
+                                     1000.0 );
+        }
+    }
+
+    ~VSIMemAllShardsHolder()
+    {
+        for( int i = VSIMemFilesystemHandler::knShardCount - 1; i >= 0; --i )
+        {
+            CPLReleaseMutex( m_poHandler->aoShards[i].hMutex );
+        }
+    }
+};
+
 /************************************************************************/
 /* ==================================================================== */
 /*                              VSIMemFile                              */
@@ -477,9 +529,7 @@ int VSIMemHandle::Truncate( vsi_l_offset nNewSize )
 /*                      VSIMemFilesystemHandler()                       */
 /************************************************************************/
 
-VSIMemFilesystemHandler::VSIMemFilesystemHandler() :
-    hMutex(NULL)
-{}
+VSIMemFilesystemHandler::VSIMemFilesystemHandler() {}
 
 /************************************************************************/
 /*                      ~VSIMemFilesystemHandler()                      */
@@ -488,18 +538,64 @@ VSIMemFilesystemHandler::VSIMemFilesystemHandler() :
 VSIMemFilesystemHandler::~VSIMemFilesystemHandler()
 
 {
-    for( std::map<CPLString, VSIMemFile*>::const_iterator iter =
-             oFileList.begin();
-         iter != oFileList.end();
-         ++iter )
+    for( int i = 0; i < knShardCount; ++i )
     {
-        CPLAtomicDec(&(iter->second->nRefCount));
-        delete iter->second;
+        Shard& oShard = aoShards[i];
+        for( std::map<CPLString, VSIMemFile*>::const_iterator iter =
+                 oShard.oFileList.begin();
+             iter != oShard.oFileList.end();
+             ++iter )
+        {
+            CPLAtomicDec(&(iter->second->nRefCount));
+            delete iter->second;
+        }
+
+        if( oShard.hMutex != NULL )
+            CPLDestroyMutex( oShard.hMutex );
+        oShard.hMutex = NULL;
     }
+}
+
+/************************************************************************/
+/*                              GetShard()                              */
+/************************************************************************/
+
+VSIMemFilesystemHandler::Shard&
+VSIMemFilesystemHandler::GetShard( const CPLString& osFilename )
 
-    if( hMutex != NULL )
-        CPLDestroyMutex( hMutex );
-    hMutex = NULL;
+{
+    return aoShards[CPLHashSetHashStr(osFilename.c_str()) % knShardCount];
+}
+
+/************************************************************************/
+/*                          GetFile_unlocked()                          */
+/*                                                                      */
+/*      The shard of the file must be locked by the caller.             */
+/************************************************************************/
+
+VSIMemFile *
+VSIMemFilesystemHandler::GetFile_unlocked( const CPLString& osFilename )
+
+{
+    Shard& oShard = GetShard(osFilename);
+    std::map<CPLString, VSIMemFile*>::const_iterator oIter =
+        oShard.oFileList.find(osFilename);
+    if( oIter == oShard.oFileList.end() )
+        return NULL;
+    return oIter->second;
+}
+
+/************************************************************************/
+/*                          AddFile_unlocked()                          */
+/*                                                                      */
+/*      The shard of the file must be locked by the caller.             */
+/************************************************************************/
+
+void VSIMemFilesystemHandler::AddFile_unlocked( VSIMemFile *poFile )
+
+{
+    GetShard(poFile->osFilename).oFileList[poFile->osFilename] = poFile;
+    CPLAtomicInc(&(poFile->nRefCount));  // Referenced by file list.
 }
 
 /************************************************************************/
@@ -512,7 +608,6 @@ VSIMemFilesystemHandler::Open( const char *pszFilename,
                                bool bSetError )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
     CPLString osFilename = pszFilename;
     NormalizePath( osFilename );
 
@@ -524,12 +619,12 @@ VSIMemFilesystemHandler::Open( const char *pszFilename,
                     osFilename.substr(iPos + strlen("||maxlength=")).c_str()));
     }
 
+    CPLMutexHolder oHolder( &(GetShard(osFilename).hMutex) );
+
 /* -------------------------------------------------------------------- */
 /*      Get the filename we are opening, create if needed.              */
 /* -------------------------------------------------------------------- */
-    VSIMemFile *poFile = NULL;
-    if( oFileList.find(osFilename) != oFileList.end() )
-        poFile = oFileList[osFilename];
+    VSIMemFile *poFile = GetFile_unlocked(osFilename);
 
     // If no file and opening in read, error out.
     if( strstr(pszAccess, "w") == NULL
@@ -549,9 +644,8 @@ VSIMemFilesystemHandler::Open( const char *pszFilename,
     {
         poFile = new VSIMemFile;
         poFile->osFilename = osFilename;
-        oFileList[poFile->osFilename] = poFile;
-        CPLAtomicInc(&(poFile->nRefCount));  // For file list.
         poFile->nMaxLength = nMaxLength;
+        AddFile_unlocked(poFile);
     }
     // Overwrite
     else if( strstr(pszAccess, "w") )
@@ -596,8 +690,6 @@ int VSIMemFilesystemHandler::Stat( const char * pszFilename,
                                    int /* nFlags */ )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     CPLString osFilename = pszFilename;
     NormalizePath( osFilename );
 
@@ -610,16 +702,15 @@ int VSIMemFilesystemHandler::Stat( const char * pszFilename,
         return 0;
     }
 
-    if( oFileList.find(osFilename) == oFileList.end() )
+    CPLMutexHolder oHolder( &(GetShard(osFilename).hMutex) );
+
+    VSIMemFile *poFile = GetFile_unlocked(osFilename);
+    if( poFile == NULL )
     {
         errno = ENOENT;
         return -1;
     }
 
-    VSIMemFile *poFile = oFileList[osFilename];
-
-    memset( pStatBuf, 0, sizeof(VSIStatBufL) );
-
     if( poFile->bIsDirectory )
     {
         pStatBuf->st_size = 0;
@@ -642,12 +733,17 @@ int VSIMemFilesystemHandler::Stat( const char * pszFilename,
 int VSIMemFilesystemHandler::Unlink( const char * pszFilename )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-    return Unlink_unlocked(pszFilename);
+    CPLString osFilename = pszFilename;
+    NormalizePath( osFilename );
+
+    CPLMutexHolder oHolder( &(GetShard(osFilename).hMutex) );
+    return Unlink_unlocked(osFilename);
 }
 
 /************************************************************************/
 /*                           Unlink_unlocked()                          */
+/*                                                                      */
+/*      The shard of the file must be locked by the caller.             */
 /************************************************************************/
 
 int VSIMemFilesystemHandler::Unlink_unlocked( const char * pszFilename )
@@ -656,19 +752,22 @@ int VSIMemFilesystemHandler::Unlink_unlocked( const char * pszFilename )
     CPLString osFilename = pszFilename;
     NormalizePath( osFilename );
 
-    if( oFileList.find(osFilename) == oFileList.end() )
+    std::map<CPLString, VSIMemFile*>& oFileList =
+        GetShard(osFilename).oFileList;
+    std::map<CPLString, VSIMemFile*>::iterator oIter =
+        oFileList.find(osFilename);
+    if( oIter == oFileList.end() )
     {
         errno = ENOENT;
         return -1;
     }
 
-    VSIMemFile *poFile = oFileList[osFilename];
+    VSIMemFile *poFile = oIter->second;
+    oFileList.erase( oIter );
 
     if( CPLAtomicDec(&(poFile->nRefCount)) == 0 )
         delete poFile;
 
-    oFileList.erase( oFileList.find(osFilename) );
-
     return 0;
 }
 
@@ -680,13 +779,13 @@ int VSIMemFilesystemHandler::Mkdir( const char * pszPathname,
                                     long /* nMode */ )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     CPLString osPathname = pszPathname;
 
     NormalizePath( osPathname );
 
-    if( oFileList.find(osPathname) != oFileList.end() )
+    CPLMutexHolder oHolder( &(GetShard(osPathname).hMutex) );
+
+    if( GetFile_unlocked(osPathname) != NULL )
     {
         errno = EEXIST;
         return -1;
@@ -696,8 +795,7 @@ int VSIMemFilesystemHandler::Mkdir( const char * pszPathname,
 
     poFile->osFilename = osPathname;
     poFile->bIsDirectory = true;
-    oFileList[osPathname] = poFile;
-    CPLAtomicInc(&(poFile->nRefCount));  // Referenced by file list.
+    AddFile_unlocked(poFile);
 
     return 0;
 }
@@ -720,54 +818,57 @@ char **VSIMemFilesystemHandler::ReadDirEx( const char *pszPath,
                                            int nMaxFiles )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     CPLString osPath = pszPath;
 
     NormalizePath( osPath );
 
-    char **papszDir = NULL;
     size_t nPathLen = osPath.size();
 
     if( nPathLen > 0 && osPath.back() == '/' )
         nPathLen--;
 
-    // In case of really big number of files in the directory, CSLAddString
-    // can be slow (see #2158). We then directly build the list.
-    int nItems = 0;
-    int nAllocatedItems = 0;
-
-    for( std::map<CPLString, VSIMemFile*>::const_iterator iter =
-             oFileList.begin();
-         iter != oFileList.end();
-         ++iter )
+    // Collect the matching entries of all shards, and sort them so that the
+    // result is in the same order as if there was a single file list.
+    std::vector<CPLString> aosNames;
     {
-        const char *pszFilePath = iter->second->osFilename.c_str();
-        if( EQUALN(osPath, pszFilePath, nPathLen)
-            && pszFilePath[nPathLen] == '/'
-            && strstr(pszFilePath+nPathLen+1, "/") == NULL )
+        VSIMemAllShardsHolder oHolder( this );
+
+        for( int i = 0; i < knShardCount; ++i )
         {
-            if( nItems == 0 )
+            const std::map<CPLString, VSIMemFile*>& oFileList =
+                aoShards[i].oFileList;
+            for( std::map<CPLString, VSIMemFile*>::const_iterator iter =
+                     oFileList.begin();
+                 iter != oFileList.end();
+                 ++iter )
             {
-                papszDir = static_cast<char**>(CPLCalloc(2, sizeof(char*)));
-                nAllocatedItems = 1;
+                const char *pszFilePath = iter->second->osFilename.c_str();
+                if( EQUALN(osPath, pszFilePath, nPathLen)
+                    && pszFilePath[nPathLen] == '/'
+                    && strstr(pszFilePath+nPathLen+1, "/") == NULL )
+                {
+                    aosNames.push_back(iter->first);
+                }
             }
-            else if( nItems >= nAllocatedItems )
-            {
-                nAllocatedItems = nAllocatedItems * 2;
-                papszDir = static_cast<char**>(
-                    CPLRealloc(papszDir, (nAllocatedItems + 2)*sizeof(char*)) );
-            }
-
-            papszDir[nItems] = CPLStrdup(pszFilePath+nPathLen+1);
-            papszDir[nItems+1] = NULL;
-
-            nItems++;
-            if( nMaxFiles > 0 && nItems > nMaxFiles )
-                break;
         }
     }
 
+    if( aosNames.empty() )
+        return NULL;
+
+    std::sort(aosNames.begin(), aosNames.end());
+
+    // In case of really big number of files in the directory, CSLAddString
+    // can be slow (see #2158). We then directly build the list.
+    size_t nItems = aosNames.size();
+    if( nMaxFiles > 0 && nItems > static_cast<size_t>(nMaxFiles) + 1 )
+        nItems = static_cast<size_t>(nMaxFiles) + 1;
+
+    char **papszDir =
+        static_cast<char**>(CPLCalloc(nItems + 1, sizeof(char*)));
+    for( size_t i = 0; i < nItems; ++i )
+        papszDir[i] = CPLStrdup(aosNames[i].c_str() + nPathLen + 1);
+
     return papszDir;
 }
 
@@ -779,8 +880,6 @@ int VSIMemFilesystemHandler::Rename( const char *pszOldPath,
                                      const char *pszNewPath )
 
 {
-    CPLMutexHolder oHolder( &hMutex );
-
     CPLString osOldPath = pszOldPath;
     CPLString osNewPath = pszNewPath;
 
@@ -790,30 +889,47 @@ int VSIMemFilesystemHandler::Rename( const char *pszOldPath,
     if( osOldPath.compare(osNewPath) == 0 )
         return 0;
 
-    if( oFileList.find(osOldPath) == oFileList.end() )
+    VSIMemAllShardsHolder oHolder( this );
+
+    if( GetFile_unlocked(osOldPath) == NULL )
     {
         errno = ENOENT;
         return -1;
     }
 
-    std::map<CPLString, VSIMemFile*>::iterator it = oFileList.find(osOldPath);
-    while( it != oFileList.end() && it->first.ifind(osOldPath) == 0 )
+    // Collect the file and all its children first, since they are spread
+    // over several shards that are modified while renaming.
+    std::vector<VSIMemFile*> apoFiles;
+    for( int i = 0; i < knShardCount; ++i )
     {
-        const CPLString osRemainder = it->first.substr(osOldPath.size());
-        if( osRemainder.empty() || osRemainder[0] == '/' )
-        {
-            const CPLString osNewFullPath = osNewPath + osRemainder;
-            Unlink_unlocked(osNewFullPath);
-            oFileList[osNewFullPath] = it->second;
-            it->second->osFilename = osNewFullPath;
-            oFileList.erase(it++);
-        }
-        else
+        std::map<CPLString, VSIMemFile*>& oFileList = aoShards[i].oFileList;
+        std::map<CPLString, VSIMemFile*>::iterator it = oFileList.begin();
+        while( it != oFileList.end() )
         {
-            ++it;
+            if( it->first.ifind(osOldPath) == 0 &&
+                (it->first.size() == osOldPath.size() ||
+                 it->first[osOldPath.size()] == '/') )
+            {
+                apoFiles.push_back(it->second);
+                oFileList.erase(it++);
+            }
+            else
+            {
+                ++it;
+            }
         }
     }
 
+    for( size_t i = 0; i < apoFiles.size(); ++i )
+    {
+        VSIMemFile *poFile = apoFiles[i];
+        const CPLString osNewFullPath =
+            osNewPath + poFile->osFilename.substr(osOldPath.size());
+        Unlink_unlocked(osNewFullPath);
+        poFile->osFilename = osNewFullPath;
+        GetShard(osNewFullPath).oFileList[osNewFullPath] = poFile;
+    }
+
     return 0;
 }
 
@@ -962,10 +1078,9 @@ VSILFILE *VSIFileFromMemBuffer( const char *pszFilename,
     poFile->nAllocLength = nDataLength;
 
     {
-        CPLMutexHolder oHolder( &poHandler->hMutex );
+        CPLMutexHolder oHolder( &(poHandler->GetShard(osFilename).hMutex) );
         poHandler->Unlink_unlocked(osFilename);
-        poHandler->oFileList[poFile->osFilename] = poFile;
-        CPLAtomicInc(&(poFile->nRefCount));
+        poHandler->AddFile_unlocked(poFile);
     }
 
     // TODO(schwehr): Fix this so that the using statement is not needed.
@@ -1007,12 +1122,15 @@ GByte *VSIGetMemFileBuffer( const char *pszFilename,
     CPLString osFilename = pszFilename;
     VSIMemFilesystemHandler::NormalizePath( osFilename );
 
-    CPLMutexHolder oHolder( &poHandler->hMutex );
+    VSIMemFilesystemHandler::Shard& oShard = poHandler->GetShard(osFilename);
+    CPLMutexHolder oHolder( &(oShard.hMutex) );
 
-    if( poHandler->oFileList.find(osFilename) == poHandler->oFileList.end() )
+    std::map<CPLString, VSIMemFile*>::iterator oIter =
+        oShard.oFileList.find(osFilename);
+    if( oIter == oShard.oFileList.end() )
         return NULL;
 
-    VSIMemFile *poFile = poHandler->oFileList[osFilename];
+    VSIMemFile *poFile = oIter->second;
     GByte *pabyData = poFile->pabyData;
     if( pnDataLength != NULL )
         *pnDataLength = poFile->nLength;
@@ -1025,7 +1143,7 @@ GByte *VSIGetMemFileBuffer( const char *pszFilename,
         else
             poFile->bOwnData = false;
 
-        poHandler->oFileList.erase( poHandler->oFileList.find(osFilename) );
+        oShard.oFileList.erase( oIter );
         CPLAtomicDec(&(poFile->nRefCount));
         delete poFile;
     }
@@ -169,7 +169,18 @@ public:
     int nEntries;
     VSIArchiveEntry* entries;
 
-    VSIArchiveContent() : mTime(0), nFileSize(0), nEntries(0), entries(NULL) {}
+    /* Index in entries[] of each entry, by file name. Rebuilt with */
+    /* entries[] from a scan of the archive, or from the index file saved */
+    /* in CPL_VSIL_ARCHIVE_INDEX_DIR by a previous scan. */
+    std::map<CPLString, int> oMapEntryIndex;
+
+    /* Indices in entries[] of the children of each directory ("" for the */
+    /* root), built on the first ReadDirEx() call on the archive */
+    bool bDirContentBuilt;
+    std::map<CPLString, std::vector<int> > oMapDirContent;
+
+    VSIArchiveContent() : mTime(0), nFileSize(0), nEntries(0), entries(NULL),
+                          bDirContentBuilt(false) {}
     ~VSIArchiveContent();
 };
 
@@ -200,6 +211,19 @@ protected:
     virtual std::vector<CPLString> GetExtensions() = 0;
     virtual VSIArchiveReader* CreateReader(const char* pszArchiveFileName) = 0;
 
+    /* Conversion of the location of a member to and from the two values */
+    /* saved in the index file. The default implementations return false */
+    /* and NULL, which disables the index file. */
+    virtual bool GetFileOffsetValues(const VSIArchiveEntryFileOffset* poOffset,
+                                     GUIntBig anValues[2]);
+    virtual VSIArchiveEntryFileOffset* CreateFileOffset(const GUIntBig anValues[2]);
+
+    CPLString GetIndexFilename(const char* archiveFilename, CPLString& osKey);
+    VSIArchiveContent* LoadIndex(const char* archiveFilename, time_t mTime,
+                                 vsi_l_offset nFileSize);
+    void SaveIndex(const char* archiveFilename,
+                   const VSIArchiveContent* content);
+
 public:
     VSIArchiveFilesystemHandler();
     virtual ~VSIArchiveFilesystemHandler();
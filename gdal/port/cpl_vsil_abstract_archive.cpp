@@ -35,7 +35,6 @@
 #endif
 #include <ctime>
 #include <map>
-#include <set>
 #include <string>
 #include <utility>
 #include <vector>
@@ -43,6 +42,7 @@
 #include "cpl_conv.h"
 #include "cpl_error.h"
 #include "cpl_multiproc.h"
+#include "cpl_sha256.h"
 #include "cpl_string.h"
 #include "cpl_vsi.h"
 
@@ -149,6 +149,330 @@ static CPLString GetStrippedFilename(const CPLString& osFileName,
     return osRet;
 }
 
+/************************************************************************/
+/*                              AddEntry()                              */
+/************************************************************************/
+
+static void AddEntry( VSIArchiveContent* content, int& nAllocEntries,
+                      const CPLString& osFileName, GIntBig nModifiedTime,
+                      vsi_l_offset nUncompressedSize, int bIsDir,
+                      VSIArchiveEntryFileOffset* file_pos )
+{
+    // Grow geometrically, as archives may contain a huge number of entries.
+    if( content->nEntries == nAllocEntries )
+    {
+        nAllocEntries = nAllocEntries + nAllocEntries / 3 + 16;
+        content->entries = static_cast<VSIArchiveEntry *>(
+            CPLRealloc(content->entries,
+                       sizeof(VSIArchiveEntry) * nAllocEntries));
+    }
+
+    VSIArchiveEntry* entry = &content->entries[content->nEntries];
+    entry->fileName = CPLStrdup(osFileName);
+    entry->nModifiedTime = nModifiedTime;
+    entry->uncompressed_size = nUncompressedSize;
+    entry->bIsDir = bIsDir;
+    entry->file_pos = file_pos;
+#ifdef DEBUG_VERBOSE
+    CPLDebug("VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes",
+             content->nEntries + 1, entry->fileName,
+             entry->uncompressed_size);
+#endif
+    content->oMapEntryIndex[osFileName] = content->nEntries;
+    content->nEntries++;
+}
+
+/************************************************************************/
+/*                        GetFileOffsetValues()                         */
+/************************************************************************/
+
+bool VSIArchiveFilesystemHandler::GetFileOffsetValues(
+    const VSIArchiveEntryFileOffset* /* poOffset */,
+    GUIntBig /* anValues */[2] )
+{
+    return false;
+}
+
+/************************************************************************/
+/*                          CreateFileOffset()                          */
+/************************************************************************/
+
+VSIArchiveEntryFileOffset* VSIArchiveFilesystemHandler::CreateFileOffset(
+    const GUIntBig /* anValues */[2] )
+{
+    return NULL;
+}
+
+/************************************************************************/
+/*                          GetIndexFilename()                          */
+/*                                                                      */
+/*      Return the name of the file in CPL_VSIL_ARCHIVE_INDEX_DIR where */
+/*      the member list of an archive is saved, or an empty string if   */
+/*      that configuration option is not set. osKey is set to the       */
+/*      handler prefix and absolute archive name the file is for.       */
+/************************************************************************/
+
+CPLString VSIArchiveFilesystemHandler::GetIndexFilename(
+    const char* archiveFilename, CPLString& osKey )
+{
+    const char* pszIndexDir =
+        CPLGetConfigOption("CPL_VSIL_ARCHIVE_INDEX_DIR", NULL);
+    if( pszIndexDir == NULL || pszIndexDir[0] == '\0' )
+        return CPLString();
+
+    osKey = GetPrefix();
+    osKey += "/";
+    char* pszCurDir = NULL;
+    if( CPLIsFilenameRelative(archiveFilename) &&
+        (pszCurDir = CPLGetCurrentDir()) != NULL )
+    {
+        osKey += CPLFormFilename(pszCurDir, archiveFilename, NULL);
+        CPLFree(pszCurDir);
+    }
+    else
+    {
+        osKey += archiveFilename;
+    }
+
+    GByte abyHash[CPL_SHA256_HASH_SIZE];
+    CPL_SHA256(osKey.c_str(), osKey.size(), abyHash);
+    char* pszHash = CPLBinaryToHex(CPL_SHA256_HASH_SIZE, abyHash);
+    const CPLString osIndexFilename(
+        CPLFormFilename(pszIndexDir, pszHash, "idx"));
+    CPLFree(pszHash);
+    return osIndexFilename;
+}
+
+/************************************************************************/
+/*                      Index file encoding helpers.                    */
+/*                                                                      */
+/*      The index file starts with ARCHIVE_INDEX_MAGIC, the key         */
+/*      returned by GetIndexFilename(), and the size and modification   */
+/*      time of the archive, followed by the number of entries and the  */
+/*      entries themselves. Integers are little-endian, and strings are */
+/*      prefixed with their length as a 32 bit integer.                 */
+/************************************************************************/
+
+static const char ARCHIVE_INDEX_MAGIC[] = "GDALAIX1";
+static const size_t ARCHIVE_INDEX_MAGIC_SIZE = 8;
+
+static const int ARCHIVE_INDEX_FLAG_DIR = 1;
+static const int ARCHIVE_INDEX_FLAG_OFFSET = 2;
+
+static void AppendUInt32( std::string& osBuffer, GUInt32 nVal )
+{
+    CPL_LSBPTR32(&nVal);
+    osBuffer.append(reinterpret_cast<const char*>(&nVal), sizeof(nVal));
+}
+
+static void AppendUInt64( std::string& osBuffer, GUIntBig nVal )
+{
+    CPL_LSBPTR64(&nVal);
+    osBuffer.append(reinterpret_cast<const char*>(&nVal), sizeof(nVal));
+}
+
+static void AppendString( std::string& osBuffer, const char* pszStr )
+{
+    const size_t nLen = strlen(pszStr);
+    AppendUInt32(osBuffer, static_cast<GUInt32>(nLen));
+    osBuffer.append(pszStr, nLen);
+}
+
+static bool ReadUInt32( const GByte*& pabyIter, const GByte* pabyEnd,
+                        GUInt32& nVal )
+{
+    if( static_cast<size_t>(pabyEnd - pabyIter) < sizeof(nVal) )
+        return false;
+    memcpy(&nVal, pabyIter, sizeof(nVal));
+    CPL_LSBPTR32(&nVal);
+    pabyIter += sizeof(nVal);
+    return true;
+}
+
+static bool ReadUInt64( const GByte*& pabyIter, const GByte* pabyEnd,
+                        GUIntBig& nVal )
+{
+    if( static_cast<size_t>(pabyEnd - pabyIter) < sizeof(nVal) )
+        return false;
+    memcpy(&nVal, pabyIter, sizeof(nVal));
+    CPL_LSBPTR64(&nVal);
+    pabyIter += sizeof(nVal);
+    return true;
+}
+
+static bool ReadString( const GByte*& pabyIter, const GByte* pabyEnd,
+                        CPLString& osStr )
+{
+    GUInt32 nLen = 0;
+    if( !ReadUInt32(pabyIter, pabyEnd, nLen) ||
+        static_cast<size_t>(pabyEnd - pabyIter) < nLen )
+        return false;
+    osStr.assign(reinterpret_cast<const char*>(pabyIter), nLen);
+    pabyIter += nLen;
+    return true;
+}
+
+/************************************************************************/
+/*                             LoadIndex()                              */
+/*                                                                      */
+/*      Build the content of an archive from its index file, if there   */
+/*      is one that was saved for the same size and modification time  */
+/*      of the archive. Returns NULL otherwise.                         */
+/************************************************************************/
+
+VSIArchiveContent* VSIArchiveFilesystemHandler::LoadIndex(
+    const char* archiveFilename, time_t mTime, vsi_l_offset nFileSize )
+{
+    CPLString osKey;
+    const CPLString osIndexFilename = GetIndexFilename(archiveFilename, osKey);
+    if( osIndexFilename.empty() )
+        return NULL;
+
+    VSILFILE* fp = VSIFOpenL(osIndexFilename, "rb");
+    if( fp == NULL )
+        return NULL;
+    GByte* pabyData = NULL;
+    vsi_l_offset nDataSize = 0;
+    const int bIngested =
+        VSIIngestFile(fp, NULL, &pabyData, &nDataSize, -1);
+    CPL_IGNORE_RET_VAL(VSIFCloseL(fp));
+    if( !bIngested )
+        return NULL;
+
+    const GByte* pabyIter = pabyData;
+    const GByte* pabyEnd = pabyData + static_cast<size_t>(nDataSize);
+    const bool bHasMagic =
+        nDataSize >= ARCHIVE_INDEX_MAGIC_SIZE &&
+        memcmp(pabyData, ARCHIVE_INDEX_MAGIC, ARCHIVE_INDEX_MAGIC_SIZE) == 0;
+    if( bHasMagic )
+        pabyIter += ARCHIVE_INDEX_MAGIC_SIZE;
+    CPLString osStoredKey;
+    GUIntBig nStoredFileSize = 0;
+    GUIntBig nStoredMTime = 0;
+    GUInt32 nEntries = 0;
+    if( !bHasMagic ||
+        !ReadString(pabyIter, pabyEnd, osStoredKey) ||
+        osStoredKey != osKey ||
+        !ReadUInt64(pabyIter, pabyEnd, nStoredFileSize) ||
+        !ReadUInt64(pabyIter, pabyEnd, nStoredMTime) ||
+        nStoredFileSize != static_cast<GUIntBig>(nFileSize) ||
+        static_cast<GIntBig>(nStoredMTime) != static_cast<GIntBig>(mTime) ||
+        !ReadUInt32(pabyIter, pabyEnd, nEntries) )
+    {
+        CPLDebug("VSIArchive", "%s is not an up to date index of %s",
+                 osIndexFilename.c_str(), archiveFilename);
+        CPLFree(pabyData);
+        return NULL;
+    }
+
+    VSIArchiveContent* content = new VSIArchiveContent;
+    content->mTime = mTime;
+    content->nFileSize = nFileSize;
+    int nAllocEntries = 0;
+    bool bOK = true;
+    for( GUInt32 i = 0; bOK && i < nEntries; i++ )
+    {
+        CPLString osFileName;
+        GUIntBig nUncompressedSize = 0;
+        GUIntBig nModifiedTime = 0;
+        GUInt32 nFlags = 0;
+        GUIntBig anValues[2] = { 0, 0 };
+        bOK = ReadString(pabyIter, pabyEnd, osFileName) &&
+              ReadUInt64(pabyIter, pabyEnd, nUncompressedSize) &&
+              ReadUInt64(pabyIter, pabyEnd, nModifiedTime) &&
+              ReadUInt32(pabyIter, pabyEnd, nFlags) &&
+              ReadUInt64(pabyIter, pabyEnd, anValues[0]) &&
+              ReadUInt64(pabyIter, pabyEnd, anValues[1]);
+        if( !bOK )
+            break;
+
+        VSIArchiveEntryFileOffset* poOffset = NULL;
+        if( nFlags & ARCHIVE_INDEX_FLAG_OFFSET )
+        {
+            poOffset = CreateFileOffset(anValues);
+            if( poOffset == NULL )
+            {
+                bOK = false;
+                break;
+            }
+        }
+        AddEntry(content, nAllocEntries, osFileName,
+                 static_cast<GIntBig>(nModifiedTime), nUncompressedSize,
+                 (nFlags & ARCHIVE_INDEX_FLAG_DIR) != 0, poOffset);
+    }
+    CPLFree(pabyData);
+
+    if( !bOK || pabyIter != pabyEnd )
+    {
+        CPLDebug("VSIArchive", "%s is corrupted", osIndexFilename.c_str());
+        delete content;
+        return NULL;
+    }
+
+    CPLDebug("VSIArchive", "Member list of %s read from %s",
+             archiveFilename, osIndexFilename.c_str());
+    return content;
+}
+
+/************************************************************************/
+/*                             SaveIndex()                              */
+/*                                                                      */
+/*      Write the content of an archive to its index file, if           */
+/*      CPL_VSIL_ARCHIVE_INDEX_DIR is set. The file is written under a  */
+/*      temporary name and then renamed, so that processes reading the  */
+/*      index concurrently never see a partial file.                    */
+/************************************************************************/
+
+void VSIArchiveFilesystemHandler::SaveIndex( const char* archiveFilename,
+                                             const VSIArchiveContent* content )
+{
+    CPLString osKey;
+    const CPLString osIndexFilename = GetIndexFilename(archiveFilename, osKey);
+    if( osIndexFilename.empty() )
+        return;
+
+    std::string osBuffer(ARCHIVE_INDEX_MAGIC, ARCHIVE_INDEX_MAGIC_SIZE);
+    AppendString(osBuffer, osKey);
+    AppendUInt64(osBuffer, static_cast<GUIntBig>(content->nFileSize));
+    AppendUInt64(osBuffer, static_cast<GUIntBig>(content->mTime));
+    AppendUInt32(osBuffer, static_cast<GUInt32>(content->nEntries));
+    for( int i = 0; i < content->nEntries; i++ )
+    {
+        const VSIArchiveEntry* entry = &content->entries[i];
+        GUInt32 nFlags = entry->bIsDir ? ARCHIVE_INDEX_FLAG_DIR : 0;
+        GUIntBig anValues[2] = { 0, 0 };
+        if( entry->file_pos != NULL )
+        {
+            if( !GetFileOffsetValues(entry->file_pos, anValues) )
+                return;
+            nFlags |= ARCHIVE_INDEX_FLAG_OFFSET;
+        }
+        AppendString(osBuffer, entry->fileName);
+        AppendUInt64(osBuffer, static_cast<GUIntBig>(entry->uncompressed_size));
+        AppendUInt64(osBuffer, static_cast<GUIntBig>(entry->nModifiedTime));
+        AppendUInt32(osBuffer, nFlags);
+        AppendUInt64(osBuffer, anValues[0]);
+        AppendUInt64(osBuffer, anValues[1]);
+    }
+
+    const CPLString osTmpFilename(
+        osIndexFilename + CPLSPrintf("." CPL_FRMT_GIB ".tmp", CPLGetPID()));
+    VSILFILE* fp = VSIFOpenL(osTmpFilename, "wb");
+    if( fp == NULL )
+    {
+        CPLDebug("VSIArchive", "Cannot create %s", osTmpFilename.c_str());
+        return;
+    }
+    bool bOK = VSIFWriteL(osBuffer.data(), 1, osBuffer.size(), fp) ==
+                                                            osBuffer.size();
+    bOK = VSIFCloseL(fp) == 0 && bOK;
+    if( !bOK || VSIRename(osTmpFilename, osIndexFilename) != 0 )
+    {
+        CPLDebug("VSIArchive", "Cannot write %s", osIndexFilename.c_str());
+        VSIUnlink(osTmpFilename);
+    }
+}
+
 /************************************************************************/
 /*                       GetContentOfArchive()                          */
 /************************************************************************/
@@ -180,6 +504,15 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
         }
     }
 
+    VSIArchiveContent* content =
+        LoadIndex(archiveFilename, sStat.st_mtime,
+                  static_cast<vsi_l_offset>(sStat.st_size));
+    if( content != NULL )
+    {
+        oFileList[archiveFilename] = content;
+        return content;
+    }
+
     bool bMustClose = poReader == NULL;
     if( poReader == NULL )
     {
@@ -195,14 +528,14 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
         return NULL;
     }
 
-    VSIArchiveContent* content = new VSIArchiveContent;
+    content = new VSIArchiveContent;
     content->mTime = sStat.st_mtime;
     content->nFileSize = (vsi_l_offset)sStat.st_size;
     content->nEntries = 0;
     content->entries = NULL;
     oFileList[archiveFilename] = content;
 
-    std::set<CPLString> oSet;
+    int nAllocEntries = 0;
 
     do
     {
@@ -213,71 +546,29 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
         if( osStrippedFilename.empty() )
             continue;
 
-        if( oSet.find(osStrippedFilename) == oSet.end() )
+        if( content->oMapEntryIndex.find(osStrippedFilename) ==
+                                            content->oMapEntryIndex.end() )
         {
-            oSet.insert(osStrippedFilename);
-
             // Add intermediate directory structure.
             const char* pszBegin = osStrippedFilename.c_str();
             for( const char* pszIter = pszBegin; *pszIter; pszIter++ )
             {
                 if( *pszIter == '/' )
                 {
-                    char* pszStrippedFileName2 = CPLStrdup(osStrippedFilename);
-                    pszStrippedFileName2[pszIter - pszBegin] = 0;
-                    if( oSet.find(pszStrippedFileName2) == oSet.end() )
-                    {
-                        oSet.insert(pszStrippedFileName2);
-
-                        content->entries = static_cast<VSIArchiveEntry *>(
-                            CPLRealloc(
-                                content->entries,
-                                sizeof(VSIArchiveEntry) *
-                                (content->nEntries + 1)));
-                        content->entries[content->nEntries].fileName =
-                            pszStrippedFileName2;
-                        content->entries[content->nEntries].nModifiedTime =
-                            poReader->GetModifiedTime();
-                        content->entries[content->nEntries].uncompressed_size =
-                            0;
-                        content->entries[content->nEntries].bIsDir = TRUE;
-                        content->entries[content->nEntries].file_pos = NULL;
-#ifdef DEBUG_VERBOSE
-                        const int nEntries = content->nEntries;
-                        CPLDebug(
-                            "VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes",
-                            content->nEntries + 1,
-                            content->entries[nEntries].fileName,
-                            content->entries[nEntries].uncompressed_size);
-#endif
-                        content->nEntries++;
-                    }
-                    else
+                    const CPLString osDirName(
+                        osStrippedFilename.substr(0, pszIter - pszBegin));
+                    if( content->oMapEntryIndex.find(osDirName) ==
+                                            content->oMapEntryIndex.end() )
                     {
-                        CPLFree(pszStrippedFileName2);
+                        AddEntry(content, nAllocEntries, osDirName,
+                                 poReader->GetModifiedTime(), 0, TRUE, NULL);
                     }
                 }
             }
 
-            content->entries = static_cast<VSIArchiveEntry *>(
-                CPLRealloc(content->entries,
-                           sizeof(VSIArchiveEntry) * (content->nEntries + 1)));
-            content->entries[content->nEntries].fileName =
-                CPLStrdup(osStrippedFilename);
-            content->entries[content->nEntries].nModifiedTime =
-                poReader->GetModifiedTime();
-            content->entries[content->nEntries].uncompressed_size =
-                poReader->GetFileSize();
-            content->entries[content->nEntries].bIsDir = bIsDir;
-            content->entries[content->nEntries].file_pos =
-                poReader->GetFileOffset();
-#ifdef DEBUG_VERBOSE
-            CPLDebug("VSIArchive", "[%d] %s : " CPL_FRMT_GUIB " bytes",
-                     content->nEntries+1,
-                     content->entries[content->nEntries].fileName,
-                     content->entries[content->nEntries].uncompressed_size);
-#endif
-            content->nEntries++;
+            AddEntry(content, nAllocEntries, osStrippedFilename,
+                     poReader->GetModifiedTime(), poReader->GetFileSize(),
+                     bIsDir, poReader->GetFileOffset());
         }
 
     } while( poReader->GotoNextFile() );
@@ -285,6 +576,8 @@ const VSIArchiveContent* VSIArchiveFilesystemHandler::GetContentOfArchive(
     if( bMustClose )
         delete(poReader);
 
+    SaveIndex(archiveFilename, content);
+
     return content;
 }
 
@@ -304,14 +597,13 @@ VSIArchiveFilesystemHandler::FindFileInArchive(
     const VSIArchiveContent* content = GetContentOfArchive(archiveFilename);
     if( content )
     {
-        for( int i = 0; i < content->nEntries; i++ )
+        std::map<CPLString, int>::const_iterator oIter =
+            content->oMapEntryIndex.find(fileInArchiveName);
+        if( oIter != content->oMapEntryIndex.end() )
         {
-            if( strcmp(fileInArchiveName, content->entries[i].fileName) == 0)
-            {
-                if( archiveEntry )
-                    *archiveEntry = &content->entries[i];
-                return TRUE;
-            }
+            if( archiveEntry )
+                *archiveEntry = &content->entries[oIter->second];
+            return TRUE;
         }
     }
     return FALSE;
@@ -823,11 +1115,12 @@ char** VSIArchiveFilesystemHandler::ReadDirEx( const char *pszDirname,
     if( archiveFilename == NULL )
         return NULL;
 
-    const int lenInArchiveSubDir = static_cast<int>(osInArchiveSubDir.size());
-
     CPLStringList oDir;
 
-    const VSIArchiveContent* content = GetContentOfArchive(archiveFilename);
+    CPLMutexHolder oHolder( &hMutex );
+
+    VSIArchiveContent* content = const_cast<VSIArchiveContent*>(
+        GetContentOfArchive(archiveFilename));
     if( !content )
     {
         CPLFree(archiveFilename);
@@ -837,47 +1130,41 @@ char** VSIArchiveFilesystemHandler::ReadDirEx( const char *pszDirname,
 #ifdef DEBUG_VERBOSE
     CPLDebug("VSIArchive", "Read dir %s", pszDirname);
 #endif
-    for( int i = 0; i < content->nEntries; i++ )
+
+    // Group entries by parent directory the first time a directory of this
+    // archive is listed, instead of scanning all entries at each call.
+    if( !content->bDirContentBuilt )
     {
-        const char* fileName = content->entries[i].fileName;
-        /* Only list entries at the same level of inArchiveSubDir */
-        if( lenInArchiveSubDir != 0 &&
-            strncmp(fileName, osInArchiveSubDir, lenInArchiveSubDir) == 0 &&
-            IsEitherSlash(fileName[lenInArchiveSubDir]) &&
-            fileName[lenInArchiveSubDir + 1] != 0 )
+        for( int i = 0; i < content->nEntries; i++ )
         {
-            const char* slash = strchr(fileName + lenInArchiveSubDir + 1, '/');
-            if( slash == NULL )
-                slash = strchr(fileName + lenInArchiveSubDir + 1, '\\');
-            if( slash == NULL || slash[1] == 0 )
-            {
-                char* tmpFileName = CPLStrdup(fileName);
-                if( slash != NULL )
-                {
-                    tmpFileName[strlen(tmpFileName)-1] = 0;
-                }
-#ifdef DEBUG_VERBOSE
-                CPLDebug("VSIArchive", "Add %s as in directory %s",
-                         tmpFileName + lenInArchiveSubDir + 1, pszDirname);
-#endif
-                oDir.AddString(tmpFileName + lenInArchiveSubDir + 1);
-                CPLFree(tmpFileName);
-            }
+            const char* fileName = content->entries[i].fileName;
+            const char* slash = strrchr(fileName, '/');
+            const CPLString osParent(
+                slash ? CPLString(fileName, slash - fileName) : CPLString());
+            content->oMapDirContent[osParent].push_back(i);
         }
-        else if( lenInArchiveSubDir == 0 &&
-                 strchr(fileName, '/') == NULL &&
-                 strchr(fileName, '\\') == NULL )
+        content->bDirContentBuilt = true;
+    }
+
+    std::map<CPLString, std::vector<int> >::const_iterator oIter =
+        content->oMapDirContent.find(osInArchiveSubDir);
+    if( oIter != content->oMapDirContent.end() )
+    {
+        const std::vector<int>& anEntries = oIter->second;
+        const size_t nPrefixLen =
+            osInArchiveSubDir.empty() ? 0 : osInArchiveSubDir.size() + 1;
+        for( size_t i = 0; i < anEntries.size(); i++ )
         {
-            // Only list toplevel files and directories.
+            const char* fileName = content->entries[anEntries[i]].fileName;
 #ifdef DEBUG_VERBOSE
             CPLDebug("VSIArchive", "Add %s as in directory %s",
-                     fileName, pszDirname);
+                     fileName + nPrefixLen, pszDirname);
 #endif
-            oDir.AddString(fileName);
-        }
+            oDir.AddString(fileName + nPrefixLen);
 
-        if( nMaxFiles > 0 && oDir.Count() > nMaxFiles )
-            break;
+            if( nMaxFiles > 0 && oDir.Count() > nMaxFiles )
+                break;
+        }
     }
 
     CPLFree(archiveFilename);
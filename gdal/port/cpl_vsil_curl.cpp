@@ -100,6 +100,7 @@ struct curl_slist* VSICurlMergeHeaders( struct curl_slist* poDest,
                                         struct curl_slist* poSrcToDestroy );
 
 #include <map>
+#include <vector>
 
 #define ENABLE_DEBUG 1
 
@@ -253,11 +254,22 @@ static int VSICurlIsFileInList( char ** papszList, const char * pszTarget )
 /*                     VSICurlFilesystemHandler                         */
 /************************************************************************/
 
-typedef struct
+class CachedConnection
 {
+  public:
     CPLString       osURL;
     CURL           *hCurlHandle;
-} CachedConnection;
+
+    // Additional handles, and the multi handle driving them, used for
+    // parallel range downloads.
+    CURLM             *hCurlMultiHandle;
+    std::vector<CURL*> ahParallelHandles;
+
+                    CachedConnection() :
+                        hCurlHandle(NULL),
+                        hCurlMultiHandle(NULL)
+                        {}
+};
 
 class VSICurlHandle;
 
@@ -335,6 +347,9 @@ public:
                                                 vsi_l_offset nFileOffsetStart );
 
     CURL               *GetCurlHandleFor( CPLString osURL );
+    CURLM              *GetCurlMultiHandleFor( const CPLString& osURL,
+                                               int nHandles,
+                                               std::vector<CURL*>& ahHandles );
 
     virtual void        ClearCache();
 };
@@ -370,6 +385,17 @@ class VSICurlHandle : public VSIVirtualHandle
     bool            bEOF;
 
     bool            DownloadRegion(vsi_l_offset startOffset, int nBlocks);
+    bool            DownloadRegionParallel(vsi_l_offset startOffset,
+                                           int nBlocks);
+    bool            DownloadRangesParallel(
+                                    const std::vector<vsi_l_offset>& anStart,
+                                    const std::vector<vsi_l_offset>& anEnd,
+                                    std::vector<char*>& apBuffers );
+    void            AddRangeToCache( vsi_l_offset nStartOffset,
+                                     const char* pBuffer, size_t nSize );
+    int             ReadMultiRangeParallel( int nRanges, void ** ppData,
+                                            const vsi_l_offset* panOffsets,
+                                            const size_t* panSizes );
 
     VSICurlReadCbkFunc  pfnReadCbk;
     void               *pReadCbkUserData;
@@ -1530,6 +1556,375 @@ retry:
     return true;
 }
 
+/************************************************************************/
+/*                   VSICurlGetMaxParallelDownloads()                   */
+/************************************************************************/
+
+/* Maximum number of concurrent range requests for a single read, as set */
+/* by the CPL_VSIL_CURL_PARALLEL_DOWNLOADS configuration option. 1 means */
+/* that parallel downloading is disabled. */
+
+static int VSICurlGetMaxParallelDownloads()
+{
+    const int nMaxParallel =
+        atoi(CPLGetConfigOption("CPL_VSIL_CURL_PARALLEL_DOWNLOADS", "1"));
+    return std::max(1, std::min(nMaxParallel, 64));
+}
+
+/************************************************************************/
+/*                     VSICurlGetParallelMinSize()                      */
+/************************************************************************/
+
+/* Minimum size of each range request of a parallel download. */
+
+static vsi_l_offset VSICurlGetParallelMinSize()
+{
+    const GIntBig nMinSize = CPLAtoGIntBig(
+        CPLGetConfigOption("CPL_VSIL_CURL_PARALLEL_MIN_SIZE", "1048576"));
+    return static_cast<vsi_l_offset>(
+        std::max(nMinSize, static_cast<GIntBig>(DOWNLOAD_CHUNK_SIZE)));
+}
+
+/************************************************************************/
+/*                       DownloadRangesParallel()                       */
+/*                                                                      */
+/*      Download the [anStart[i], anEnd[i]] ranges with concurrent      */
+/*      requests over the per-thread pool of curl handles.  On return,  */
+/*      apBuffers[i] is the content of the i-th range (to be freed      */
+/*      with CPLFree()), or NULL if its request failed.  Errors are     */
+/*      not reported, so that the caller can fall back to sequential    */
+/*      requests, which do.  Returns true if all requests succeeded.    */
+/************************************************************************/
+
+bool VSICurlHandle::DownloadRangesParallel(
+                                    const std::vector<vsi_l_offset>& anStart,
+                                    const std::vector<vsi_l_offset>& anEnd,
+                                    std::vector<char*>& apBuffers )
+{
+    const int nRanges = static_cast<int>(anStart.size());
+    apBuffers.assign(nRanges, static_cast<char*>(NULL));
+
+    if( bInterrupted && bStopOnInterruptUntilUninstall )
+        return false;
+
+    CachedFileProp* cachedFileProp = poFS->GetCachedFileProp(m_pszURL);
+    if( cachedFileProp->eExists == EXIST_NO )
+        return false;
+
+    // Use the redirect URL if it is known to be still valid. Its discovery
+    // and expiration are left to DownloadRegion().
+    CPLString osURL(m_pszURL);
+    if( cachedFileProp->bS3Redirect &&
+        time(NULL) + 1 < cachedFileProp->nExpireTimestampLocal )
+    {
+        osURL = cachedFileProp->osRedirectURL;
+    }
+
+    const int nHandles = std::min(nRanges, VSICurlGetMaxParallelDownloads());
+    std::vector<CURL*> ahHandles;
+    CURLM* hMultiHandle =
+        poFS->GetCurlMultiHandleFor(m_pszURL, nHandles, ahHandles);
+
+    std::vector<WriteFuncStruct> asWriteFuncData(nRanges);
+    std::vector<WriteFuncStruct> asWriteFuncHeaderData(nRanges);
+    std::vector<CPLString> aosRange(nRanges);
+    std::vector<struct curl_slist*> apsHeaders(nRanges,
+                                    static_cast<struct curl_slist*>(NULL));
+    std::vector<int> anRangeOfHandle(nHandles, -1);
+    std::vector<char> achCurlErrBuf(nHandles * (CURL_ERROR_SIZE + 1));
+
+    bool bOK = true;
+    int iNextRange = 0;
+    int nRunning = 0;
+    while( true )
+    {
+/* -------------------------------------------------------------------- */
+/*      Start the next requests on idle handles.                        */
+/* -------------------------------------------------------------------- */
+        for( int iHandle = 0;
+             iHandle < nHandles && iNextRange < nRanges && !bInterrupted;
+             iHandle++ )
+        {
+            if( anRangeOfHandle[iHandle] >= 0 )
+                continue;
+            const int i = iNextRange++;
+            CURL* hCurlHandle = ahHandles[iHandle];
+
+            apsHeaders[i] =
+                VSICurlSetOptions(hCurlHandle, osURL, m_papszHTTPOptions);
+
+            VSICURLInitWriteFuncStruct(&asWriteFuncData[i],
+                                       reinterpret_cast<VSILFILE *>(this),
+                                       pfnReadCbk, pReadCbkUserData);
+            curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA,
+                             &asWriteFuncData[i]);
+            curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION,
+                             VSICurlHandleWriteFunc);
+
+            VSICURLInitWriteFuncStruct(&asWriteFuncHeaderData[i],
+                                       NULL, NULL, NULL);
+            curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA,
+                             &asWriteFuncHeaderData[i]);
+            curl_easy_setopt(hCurlHandle, CURLOPT_HEADERFUNCTION,
+                             VSICurlHandleWriteFunc);
+            asWriteFuncHeaderData[i].bIsHTTP = STARTS_WITH(m_pszURL, "http");
+            asWriteFuncHeaderData[i].nStartOffset = anStart[i];
+            asWriteFuncHeaderData[i].nEndOffset = anEnd[i];
+
+            aosRange[i].Printf(CPL_FRMT_GUIB "-" CPL_FRMT_GUIB,
+                               anStart[i], anEnd[i]);
+            if( ENABLE_DEBUG )
+                CPLDebug("VSICURL", "Downloading %s (%s) in parallel...",
+                         aosRange[i].c_str(), osURL.c_str());
+            curl_easy_setopt(hCurlHandle, CURLOPT_RANGE, aosRange[i].c_str());
+
+            char* pszCurlErrBuf = &achCurlErrBuf[iHandle * (CURL_ERROR_SIZE+1)];
+            pszCurlErrBuf[0] = '\0';
+            curl_easy_setopt(hCurlHandle, CURLOPT_ERRORBUFFER, pszCurlErrBuf);
+
+            apsHeaders[i] =
+                VSICurlMergeHeaders(apsHeaders[i], GetCurlHeaders("GET"));
+            if( apsHeaders[i] != NULL )
+                curl_easy_setopt(hCurlHandle, CURLOPT_HTTPHEADER,
+                                 apsHeaders[i]);
+
+            curl_multi_add_handle(hMultiHandle, hCurlHandle);
+            anRangeOfHandle[iHandle] = i;
+            nRunning++;
+        }
+
+        if( nRunning == 0 )
+            break;
+
+/* -------------------------------------------------------------------- */
+/*      Make progress on the running requests.                          */
+/* -------------------------------------------------------------------- */
+        int nStillRunning = 0;
+        while( curl_multi_perform(hMultiHandle, &nStillRunning) ==
+                                                    CURLM_CALL_MULTI_PERFORM )
+        {
+            // loop
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Collect completed requests.                                     */
+/* -------------------------------------------------------------------- */
+        CURLMsg *psMsg = NULL;
+        int nMsgsInQueue = 0;
+        while( (psMsg = curl_multi_info_read(hMultiHandle,
+                                             &nMsgsInQueue)) != NULL )
+        {
+            if( psMsg->msg != CURLMSG_DONE )
+                continue;
+
+            int iHandle = 0;
+            while( iHandle < nHandles &&
+                   ahHandles[iHandle] != psMsg->easy_handle )
+                iHandle++;
+            if( iHandle == nHandles )
+                continue;
+
+            CURL* hCurlHandle = ahHandles[iHandle];
+            const int i = anRangeOfHandle[iHandle];
+            curl_multi_remove_handle(hMultiHandle, hCurlHandle);
+            anRangeOfHandle[iHandle] = -1;
+            nRunning--;
+
+            long response_code = 0;
+            curl_easy_getinfo(hCurlHandle, CURLINFO_HTTP_CODE, &response_code);
+
+            if( asWriteFuncData[i].bInterrupted )
+                bInterrupted = true;
+
+            const size_t nExpectedSize =
+                static_cast<size_t>(anEnd[i] - anStart[i] + 1);
+            if( psMsg->data.result == CURLE_OK &&
+                !asWriteFuncData[i].bInterrupted &&
+                !asWriteFuncHeaderData[i].bError &&
+                (response_code == 200 || response_code == 206 ||
+                 response_code == 225 || response_code == 226 ||
+                 response_code == 426) &&
+                asWriteFuncData[i].nSize == nExpectedSize )
+            {
+                apBuffers[i] = asWriteFuncData[i].pBuffer;
+            }
+            else
+            {
+                if( ENABLE_DEBUG )
+                    CPLDebug("VSICURL", "Parallel download of %s failed "
+                             "(response_code=%d)",
+                             aosRange[i].c_str(),
+                             static_cast<int>(response_code));
+                CPLFree(asWriteFuncData[i].pBuffer);
+                bOK = false;
+            }
+            asWriteFuncData[i].pBuffer = NULL;
+            CPLFree(asWriteFuncHeaderData[i].pBuffer);
+            asWriteFuncHeaderData[i].pBuffer = NULL;
+            if( apsHeaders[i] != NULL )
+                curl_slist_free_all(apsHeaders[i]);
+            apsHeaders[i] = NULL;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Wait for activity on the running requests.                      */
+/* -------------------------------------------------------------------- */
+        if( nRunning > 0 )
+        {
+            fd_set fdread;
+            fd_set fdwrite;
+            fd_set fdexcep;
+            FD_ZERO(&fdread);
+            FD_ZERO(&fdwrite);
+            FD_ZERO(&fdexcep);
+            int nMaxFD = -1;
+            curl_multi_fdset(hMultiHandle, &fdread, &fdwrite, &fdexcep,
+                             &nMaxFD);
+            if( nMaxFD >= 0 )
+            {
+                struct timeval timeout;
+                timeout.tv_sec = 0;
+                timeout.tv_usec = 100000;
+                if( select(nMaxFD + 1, &fdread, &fdwrite, &fdexcep,
+                           &timeout) < 0 )
+                {
+                    CPLError(CE_Failure, CPLE_AppDefined, "select() failed");
+                    break;
+                }
+            }
+            else
+            {
+                // No socket yet (e.g. name resolution in progress).
+                CPLSleep(0.01);
+            }
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Cleanup. Requests still running after a failure of select()     */
+/*      are considered as failed.                                       */
+/* -------------------------------------------------------------------- */
+    for( int iHandle = 0; iHandle < nHandles; iHandle++ )
+    {
+        CURL* hCurlHandle = ahHandles[iHandle];
+        const int i = anRangeOfHandle[iHandle];
+        if( i >= 0 )
+        {
+            curl_multi_remove_handle(hMultiHandle, hCurlHandle);
+            CPLFree(asWriteFuncData[i].pBuffer);
+            CPLFree(asWriteFuncHeaderData[i].pBuffer);
+            if( apsHeaders[i] != NULL )
+                curl_slist_free_all(apsHeaders[i]);
+            bOK = false;
+        }
+        curl_easy_setopt(hCurlHandle, CURLOPT_WRITEDATA, NULL);
+        curl_easy_setopt(hCurlHandle, CURLOPT_WRITEFUNCTION, NULL);
+        curl_easy_setopt(hCurlHandle, CURLOPT_HEADERDATA, NULL);
+        curl_easy_setopt(hCurlHandle, CURLOPT_HEADERFUNCTION, NULL);
+        curl_easy_setopt(hCurlHandle, CURLOPT_ERRORBUFFER, NULL);
+    }
+
+    return bOK && iNextRange == nRanges;
+}
+
+/************************************************************************/
+/*                          AddRangeToCache()                           */
+/************************************************************************/
+
+/* Add downloaded content, starting at a DOWNLOAD_CHUNK_SIZE boundary, to */
+/* the region cache. */
+
+void VSICurlHandle::AddRangeToCache( vsi_l_offset nStartOffset,
+                                     const char* pBuffer, size_t nSize )
+{
+    while( nSize > 0 )
+    {
+        const size_t nChunkSize =
+            std::min(static_cast<size_t>(DOWNLOAD_CHUNK_SIZE), nSize);
+        poFS->AddRegion(m_pszURL, nStartOffset, nChunkSize, pBuffer);
+        nStartOffset += nChunkSize;
+        pBuffer += nChunkSize;
+        nSize -= nChunkSize;
+    }
+}
+
+/************************************************************************/
+/*                       DownloadRegionParallel()                       */
+/*                                                                      */
+/*      Same as DownloadRegion(), but split into concurrent range       */
+/*      requests.  Only used when the file size is known.               */
+/************************************************************************/
+
+bool VSICurlHandle::DownloadRegionParallel( const vsi_l_offset startOffset,
+                                            const int nBlocks )
+{
+    CachedFileProp* cachedFileProp = poFS->GetCachedFileProp(m_pszURL);
+    if( !cachedFileProp->bHasComputedFileSize ||
+        startOffset >= cachedFileProp->fileSize )
+    {
+        return DownloadRegion(startOffset, nBlocks);
+    }
+
+    const vsi_l_offset nEndOffset =
+        std::min(startOffset + nBlocks * DOWNLOAD_CHUNK_SIZE,
+                 cachedFileProp->fileSize) - 1;
+    const int nParts = static_cast<int>(std::min(
+        static_cast<vsi_l_offset>(VSICurlGetMaxParallelDownloads()),
+        (nEndOffset - startOffset + 1) / VSICurlGetParallelMinSize()));
+    if( nParts <= 1 )
+        return DownloadRegion(startOffset, nBlocks);
+
+    // Split into parts of a whole number of blocks.
+    const int nBlocksPerPart = (nBlocks + nParts - 1) / nParts;
+    std::vector<vsi_l_offset> anStart;
+    std::vector<vsi_l_offset> anEnd;
+    std::vector<int> anBlocks;
+    for( int iBlock = 0; iBlock < nBlocks; iBlock += nBlocksPerPart )
+    {
+        const vsi_l_offset nPartStart =
+            startOffset + static_cast<vsi_l_offset>(iBlock) *
+                                                        DOWNLOAD_CHUNK_SIZE;
+        if( nPartStart > nEndOffset )
+            break;
+        const int nPartBlocks = std::min(nBlocksPerPart, nBlocks - iBlock);
+        anStart.push_back(nPartStart);
+        anEnd.push_back(std::min(
+            nPartStart + nPartBlocks * DOWNLOAD_CHUNK_SIZE - 1, nEndOffset));
+        anBlocks.push_back(nPartBlocks);
+    }
+
+    std::vector<char*> apBuffers;
+    DownloadRangesParallel(anStart, anEnd, apBuffers);
+    if( bInterrupted )
+    {
+        for( size_t i = 0; i < apBuffers.size(); i++ )
+            CPLFree(apBuffers[i]);
+        return false;
+    }
+
+    bool bRet = true;
+    for( size_t i = 0; i < anStart.size(); i++ )
+    {
+        if( apBuffers[i] != NULL )
+        {
+            AddRangeToCache(anStart[i], apBuffers[i],
+                            static_cast<size_t>(anEnd[i] - anStart[i] + 1));
+            CPLFree(apBuffers[i]);
+        }
+        // Failed parts are retried sequentially, which reports errors. Only
+        // a failure of the first part, that contains the requested offset,
+        // is fatal; the others will be downloaded again when needed.
+        else if( !DownloadRegion(anStart[i], anBlocks[i]) && i == 0 )
+        {
+            bRet = false;
+        }
+    }
+
+    lastDownloadedOffset = startOffset + nBlocks * DOWNLOAD_CHUNK_SIZE;
+
+    return bRet;
+}
+
 /************************************************************************/
 /*                                Read()                                */
 /************************************************************************/
@@ -1613,7 +2008,12 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
             if( nBlocksToDownload > N_MAX_REGIONS )
                 nBlocksToDownload = N_MAX_REGIONS;
 
-            if( DownloadRegion(nOffsetToDownload, nBlocksToDownload) == false )
+            const bool bDownloaded =
+                VSICurlGetMaxParallelDownloads() > 1 ?
+                    DownloadRegionParallel(nOffsetToDownload,
+                                           nBlocksToDownload) :
+                    DownloadRegion(nOffsetToDownload, nBlocksToDownload);
+            if( !bDownloaded )
             {
                 if( !bInterrupted )
                     bEOF = true;
@@ -1652,6 +2052,57 @@ size_t VSICurlHandle::Read( void * const pBufferIn, size_t const nSize,
     return ret;
 }
 
+/************************************************************************/
+/*                       ReadMultiRangeParallel()                       */
+/*                                                                      */
+/*      Fetch each group of contiguous ranges with its own single       */
+/*      range request, issued concurrently, instead of a multi-range    */
+/*      request whose parts are sent sequentially by the server.        */
+/*      Returns 0 on success, -1 otherwise.                             */
+/************************************************************************/
+
+int VSICurlHandle::ReadMultiRangeParallel( int const nRanges,
+                                           void ** const ppData,
+                                           const vsi_l_offset* const panOffsets,
+                                           const size_t* const panSizes )
+{
+    std::vector<vsi_l_offset> anStart;
+    std::vector<vsi_l_offset> anEnd;
+    std::vector<int> anFirstRange;
+    for( int i = 0; i < nRanges; i++ )
+    {
+        anFirstRange.push_back(i);
+        anStart.push_back(panOffsets[i]);
+        while( i + 1 < nRanges &&
+               panOffsets[i] + panSizes[i] == panOffsets[i+1] )
+        {
+            i++;
+        }
+        anEnd.push_back(panOffsets[i] + panSizes[i] - 1);
+    }
+
+    std::vector<char*> apBuffers;
+    const bool bOK = DownloadRangesParallel(anStart, anEnd, apBuffers);
+
+    for( size_t iMerged = 0; iMerged < anStart.size(); iMerged++ )
+    {
+        if( bOK )
+        {
+            const int iLastRange = iMerged + 1 < anStart.size() ?
+                                   anFirstRange[iMerged + 1] : nRanges;
+            for( int i = anFirstRange[iMerged]; i < iLastRange; i++ )
+            {
+                memcpy(ppData[i],
+                       apBuffers[iMerged] + (panOffsets[i] - anStart[iMerged]),
+                       panSizes[i]);
+            }
+        }
+        CPLFree(apBuffers[iMerged]);
+    }
+
+    return bOK ? 0 : -1;
+}
+
 /************************************************************************/
 /*                           ReadMultiRange()                           */
 /************************************************************************/
@@ -1711,6 +2162,15 @@ int VSICurlHandle::ReadMultiRange( int const nRanges, void ** const ppData,
                               panOffsets + nHalf, panSizes + nHalf);
     }
 
+    if( nMergedRanges > 1 && VSICurlGetMaxParallelDownloads() > 1 )
+    {
+        const int nRet = ReadMultiRangeParallel(nRanges, ppData,
+                                                panOffsets, panSizes);
+        if( nRet == 0 || bInterrupted )
+            return nRet;
+        // Otherwise fall back to a single multi-range request.
+    }
+
     CURL* hCurlHandle = poFS->GetCurlHandleFor(m_pszURL);
     struct curl_slist* headers =
         VSICurlSetOptions(hCurlHandle, m_pszURL, m_papszHTTPOptions);
@@ -2158,12 +2618,53 @@ CURL* VSICurlFilesystemHandler::GetCurlHandleFor(CPLString osURL)
         if( psCachedConnection->hCurlHandle )
             curl_easy_cleanup(psCachedConnection->hCurlHandle);
         psCachedConnection->hCurlHandle = curl_easy_init();
+        for( size_t i = 0; i < psCachedConnection->ahParallelHandles.size();
+             i++ )
+        {
+            curl_easy_cleanup(psCachedConnection->ahParallelHandles[i]);
+        }
+        psCachedConnection->ahParallelHandles.clear();
     }
     psCachedConnection->osURL = osURL;
 
     return psCachedConnection->hCurlHandle;
 }
 
+/************************************************************************/
+/*                      GetCurlMultiHandleFor()                         */
+/************************************************************************/
+
+/* Returns the multi handle of the current thread, and in ahHandles */
+/* nHandles easy handles for osURL: the one of GetCurlHandleFor() followed */
+/* by handles of a per-thread pool, so that their connections can be */
+/* reused from one parallel download to the next. */
+
+CURLM* VSICurlFilesystemHandler::GetCurlMultiHandleFor(
+                                        const CPLString& osURL,
+                                        int nHandles,
+                                        std::vector<CURL*>& ahHandles )
+{
+    CURL* hCurlHandle = GetCurlHandleFor(osURL);
+
+    CPLMutexHolder oHolder( &hMutex );
+
+    CachedConnection* psCachedConnection = mapConnections[CPLGetPID()];
+    if( psCachedConnection->hCurlMultiHandle == NULL )
+        psCachedConnection->hCurlMultiHandle = curl_multi_init();
+    while( static_cast<int>(psCachedConnection->ahParallelHandles.size()) <
+                                                                nHandles - 1 )
+    {
+        psCachedConnection->ahParallelHandles.push_back(curl_easy_init());
+    }
+
+    ahHandles.resize(nHandles);
+    ahHandles[0] = hCurlHandle;
+    for( int i = 1; i < nHandles; i++ )
+        ahHandles[i] = psCachedConnection->ahParallelHandles[i - 1];
+
+    return psCachedConnection->hCurlMultiHandle;
+}
+
 /************************************************************************/
 /*                   GetRegionFromCacheDisk()                           */
 /************************************************************************/
@@ -2463,8 +2964,16 @@ void VSICurlFilesystemHandler::ClearCache()
          iterConnections != mapConnections.end();
          ++iterConnections )
     {
-        curl_easy_cleanup(iterConnections->second->hCurlHandle);
-        delete iterConnections->second;
+        CachedConnection* psCachedConnection = iterConnections->second;
+        curl_easy_cleanup(psCachedConnection->hCurlHandle);
+        for( size_t i = 0; i < psCachedConnection->ahParallelHandles.size();
+             i++ )
+        {
+            curl_easy_cleanup(psCachedConnection->ahParallelHandles[i]);
+        }
+        if( psCachedConnection->hCurlMultiHandle )
+            curl_multi_cleanup(psCachedConnection->hCurlMultiHandle);
+        delete psCachedConnection;
     }
     mapConnections.clear();
 }
@@ -5197,6 +5706,15 @@ struct curl_slist* VSICurlMergeHeaders( struct curl_slist* poDest,
  * reading it will progressively increase the chunk size up to 2 MB to improve
  * download performance.
  *
+ * Starting with GDAL 2.3, the CPL_VSIL_CURL_PARALLEL_DOWNLOADS configuration
+ * option can be set to a number greater than 1 (and up to 64) so that, when
+ * the file size is known, large reads are split into at most that number of
+ * range requests issued concurrently, each of them being at least
+ * CPL_VSIL_CURL_PARALLEL_MIN_SIZE bytes large (default to 1 MB).
+ * VSIFReadMultiRangeL() then also issues one concurrent request per group of
+ * contiguous ranges instead of a single multi-range request. This helps
+ * reaching the available bandwidth on high latency links.
+ *
  * The GDAL_HTTP_PROXY, GDAL_HTTP_PROXYUSERPWD and GDAL_PROXY_AUTH configuration
  * options can be used to define a proxy server. The syntax to use is the one of
  * Curl CURLOPT_PROXY, CURLOPT_PROXYUSERPWD and CURLOPT_PROXYAUTH options.
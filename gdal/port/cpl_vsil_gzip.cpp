@@ -2002,6 +2002,10 @@ public:
     virtual std::vector<CPLString> GetExtensions() override;
     virtual VSIArchiveReader* CreateReader( const char* pszZipFileName )
         override;
+    virtual bool GetFileOffsetValues( const VSIArchiveEntryFileOffset* poOffset,
+                                      GUIntBig anValues[2] ) override;
+    virtual VSIArchiveEntryFileOffset* CreateFileOffset(
+        const GUIntBig anValues[2] ) override;
 
     virtual VSIVirtualHandle *Open( const char *pszFilename,
                                     const char *pszAccess,
@@ -2130,6 +2134,33 @@ VSIArchiveReader* VSIZipFilesystemHandler::CreateReader(
     return poReader;
 }
 
+/************************************************************************/
+/*                        GetFileOffsetValues()                         */
+/************************************************************************/
+
+bool VSIZipFilesystemHandler::GetFileOffsetValues(
+    const VSIArchiveEntryFileOffset* poOffset, GUIntBig anValues[2] )
+{
+    const VSIZipEntryFileOffset* poZipOffset =
+        static_cast<const VSIZipEntryFileOffset*>(poOffset);
+    anValues[0] = poZipOffset->m_file_pos.pos_in_zip_directory;
+    anValues[1] = poZipOffset->m_file_pos.num_of_file;
+    return true;
+}
+
+/************************************************************************/
+/*                          CreateFileOffset()                          */
+/************************************************************************/
+
+VSIArchiveEntryFileOffset* VSIZipFilesystemHandler::CreateFileOffset(
+    const GUIntBig anValues[2] )
+{
+    unz_file_pos file_pos;
+    file_pos.pos_in_zip_directory = anValues[0];
+    file_pos.num_of_file = anValues[1];
+    return new VSIZipEntryFileOffset(file_pos);
+}
+
 /************************************************************************/
 /*                                 Open()                               */
 /************************************************************************/
@@ -2643,6 +2674,17 @@ void VSIZipWriteHandle::StartNewFile( VSIZipWriteHandle* poSubFile )
  *
  * Directory listing is available through VSIReadDir().
  *
+ * The list of the members of the archive is read from its central directory
+ * the first time the archive is accessed, and kept in memory by the process
+ * until the archive is modified. Opening members, VSIStatL() and VSIReadDir()
+ * then do not scan the archive again.
+ *
+ * Since GDAL 2.3, if the CPL_VSIL_ARCHIVE_INDEX_DIR configuration option is
+ * set to an existing directory, the list is also saved there in an index
+ * file, named after the SHA256 hash of the archive name. Other processes then
+ * read that index file instead of the central directory of the archive, as
+ * long as the size and modification time of the archive are unchanged.
+ *
  * Since GDAL 1.8.0, write capabilities are available. They allow creating
  * a new zip file and adding new files to an already existing (or just created)
  * zip file. Read and write operations cannot be interleaved : the new zip must
@@ -389,6 +389,10 @@ public:
     virtual const char* GetPrefix() override { return "/vsitar"; }
     virtual std::vector<CPLString> GetExtensions() override;
     virtual VSIArchiveReader* CreateReader(const char* pszTarFileName) override;
+    virtual bool GetFileOffsetValues( const VSIArchiveEntryFileOffset* poOffset,
+                                      GUIntBig anValues[2] ) override;
+    virtual VSIArchiveEntryFileOffset* CreateFileOffset(
+        const GUIntBig anValues[2] ) override;
 
     virtual VSIVirtualHandle *Open( const char *pszFilename,
                                     const char *pszAccess,
@@ -441,6 +445,35 @@ VSIArchiveReader* VSITarFilesystemHandler::CreateReader(const char* pszTarFileNa
     return poReader;
 }
 
+/************************************************************************/
+/*                        GetFileOffsetValues()                         */
+/************************************************************************/
+
+bool VSITarFilesystemHandler::GetFileOffsetValues(
+    const VSIArchiveEntryFileOffset* poOffset, GUIntBig anValues[2] )
+{
+    const VSITarEntryFileOffset* poTarOffset =
+        static_cast<const VSITarEntryFileOffset*>(poOffset);
+#ifdef HAVE_FUZZER_FRIENDLY_ARCHIVE
+    // The members of fuzzer friendly archives are located by name.
+    if( !poTarOffset->m_osFileName.empty() )
+        return false;
+#endif
+    anValues[0] = poTarOffset->m_nOffset;
+    anValues[1] = 0;
+    return true;
+}
+
+/************************************************************************/
+/*                          CreateFileOffset()                          */
+/************************************************************************/
+
+VSIArchiveEntryFileOffset* VSITarFilesystemHandler::CreateFileOffset(
+    const GUIntBig anValues[2] )
+{
+    return new VSITarEntryFileOffset(anValues[0]);
+}
+
 /************************************************************************/
 /*                                 Open()                               */
 /************************************************************************/
@@ -532,6 +565,17 @@ VSIVirtualHandle* VSITarFilesystemHandler::Open( const char *pszFilename,
  *
  * Directory listing is available through VSIReadDir().
  *
+ * The list of the members of the archive is read from its headers the first
+ * time the archive is accessed, and kept in memory by the process until the
+ * archive is modified. Opening members, VSIStatL() and VSIReadDir() then do
+ * not scan the archive again.
+ *
+ * Since GDAL 2.3, if the CPL_VSIL_ARCHIVE_INDEX_DIR configuration option is
+ * set to an existing directory, the list is also saved there in an index
+ * file, named after the SHA256 hash of the archive name. Other processes then
+ * read that index file instead of the headers of the archive, as long as the
+ * size and modification time of the archive are unchanged.
+ *
  * @since GDAL 1.8.0
  */
 
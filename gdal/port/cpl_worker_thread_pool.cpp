@@ -29,11 +29,13 @@
 #include "cpl_port.h"
 #include "cpl_worker_thread_pool.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <memory>
 
 #include "cpl_conv.h"
 #include "cpl_error.h"
+#include "cpl_string.h"
 #include "cpl_vsi.h"
 
 
@@ -506,3 +508,45 @@ CPLWorkerThreadPool::GetNextJob( CPLWorkerThread* psWorkerThread )
         //    return psJob;
     }
 }
+
+/************************************************************************/
+/*                          CPLGetNumThreads()                          */
+/************************************************************************/
+
+/** Return the number of worker threads asked for by the user.
+ *
+ * The value is taken from the NUM_THREADS option of papszOptions, or else
+ * from the GDAL_NUM_THREADS configuration option, or else from pszDefault.
+ * It is either a number of threads or ALL_CPUS. A value that is neither
+ * triggers a warning, and a single thread is used.
+ *
+ * @param papszOptions Options that may contain NUM_THREADS. May be NULL.
+ * @param pszDefault Value used if no option is set, such as "1" or "ALL_CPUS".
+ * @return the number of threads, between 1 and 128.
+ * @since GDAL 2.3
+ */
+int CPLGetNumThreads( char** papszOptions, const char* pszDefault )
+{
+    const char* pszValue = CSLFetchNameValue(papszOptions, "NUM_THREADS");
+    if( pszValue == NULL )
+        pszValue = CPLGetConfigOption("GDAL_NUM_THREADS", pszDefault);
+    if( pszValue == NULL )
+        return 1;
+
+    GIntBig nThreads = 0;
+    if( EQUAL(pszValue, "ALL_CPUS") )
+        nThreads = CPLGetNumCPUs();
+    else if( CPLGetValueType(pszValue) == CPL_VALUE_INTEGER )
+        nThreads = CPLAtoGIntBig(pszValue);
+    else
+        nThreads = -1;
+    if( nThreads < 0 )
+    {
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "Invalid value for NUM_THREADS: %s", pszValue);
+        return 1;
+    }
+    return static_cast<int>(
+        std::max(static_cast<GIntBig>(1),
+                 std::min(static_cast<GIntBig>(128), nThreads)));
+}
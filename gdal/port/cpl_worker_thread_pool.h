@@ -104,4 +104,6 @@ class CPL_DLL CPLWorkerThreadPool
         int GetThreadCount() const { return (int)aWT.size(); }
 };
 
+int CPL_DLL CPLGetNumThreads( char** papszOptions, const char* pszDefault );
+
 #endif // CPL_WORKER_THREAD_POOL_H_INCLUDED_